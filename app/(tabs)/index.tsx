@@ -6,6 +6,7 @@ import { useColorScheme } from '@/hooks/useColorScheme';
 import { useLanguage } from '@/hooks/useLanguage';
 import { useSmartSafeArea } from '@/hooks/useSafeArea';
 import { AccountService } from '@/services/accountService';
+import { CodeScheduler } from '@/services/codeScheduler';
 import type { Account, AccountCategory } from '@/types/auth';
 import { useFocusEffect } from '@react-navigation/native';
 import { Shield } from 'lucide-react-native';
@@ -181,6 +182,13 @@ export default function HomeScreen() {
     loadAccounts();
   }, [loadAccounts]);
 
+  // Codes are regenerated per period group and pushed to the cards
+  useEffect(() => {
+    CodeScheduler.setAccounts(accounts);
+  }, [accounts]);
+
+  useEffect(() => () => CodeScheduler.stop(), []);
+
   // Listen for focus events to refresh accounts when returning from other screens
   useFocusEffect(
     useCallback(() => {
@@ -225,12 +233,21 @@ export default function HomeScreen() {
 
     // Filter by search query
     if (query.trim()) {
-      const lowercaseQuery = query.toLowerCase().trim();
-      filtered = filtered.filter(account =>
-        account.name.toLowerCase().includes(lowercaseQuery) ||
-        account.email.toLowerCase().includes(lowercaseQuery) ||
-        (account.issuer && account.issuer.toLowerCase().includes(lowercaseQuery))
-      );
+      const rankedIds = AccountService.rankAccountIds(query);
+      if (rankedIds) {
+        // Native index: ranked, typo-tolerant
+        const rank = new Map(rankedIds.map((id, index) => [id, index]));
+        filtered = filtered
+          .filter(account => rank.has(account.id))
+          .sort((a, b) => rank.get(a.id)! - rank.get(b.id)!);
+      } else {
+        const lowercaseQuery = query.toLowerCase().trim();
+        filtered = filtered.filter(account =>
+          account.name.toLowerCase().includes(lowercaseQuery) ||
+          account.email.toLowerCase().includes(lowercaseQuery) ||
+          (account.issuer && account.issuer.toLowerCase().includes(lowercaseQuery))
+        );
+      }
     }
 
     return filtered;
@@ -39,7 +39,56 @@ export default function QRScannerScreen() {
     setScanned(true);
     await Haptics.notificationAsync(Haptics.NotificationFeedbackType.Success);
     
-    if (data.startsWith('otpauth://')) {
+    if (data.startsWith('otpauth-migration://')) {
+      try {
+        const parsedAccounts = OTPService.parseOTPUris([data]);
+        if (parsedAccounts.length === 0) {
+          Alert.alert(
+            t('add.alerts.scanFailed'),
+            t('add.alerts.scanFailedMessage'),
+            [
+              { text: t('add.alerts.rescan'), onPress: () => setScanned(false) },
+              { text: t('add.alerts.cancel'), onPress: handleClose }
+            ]
+          );
+          return;
+        }
+
+        const savedAccounts = await AccountService.addAccounts(parsedAccounts.map(parsedData => ({
+          name: parsedData.name || '',
+          email: parsedData.email || '',
+          secret: parsedData.secret || '',
+          type: parsedData.type || 'TOTP' as const,
+          category: determineCategory(parsedData.name || ''),
+          issuer: parsedData.issuer,
+          algorithm: parsedData.algorithm || 'SHA1' as const,
+          digits: parsedData.digits || 6,
+          period: parsedData.period || 30,
+          counter: parsedData.counter || 0,
+        })));
+
+        Alert.alert(
+          t('add.alerts.importSuccess'),
+          t('add.alerts.importSuccessMessage', { count: savedAccounts.length }),
+          [{
+            text: t('add.alerts.ok'),
+            onPress: () => {
+              router.back();
+              setTimeout(() => {
+                router.push('/(tabs)');
+              }, 100);
+            }
+          }]
+        );
+      } catch (error) {
+        console.error('Error processing migration QR code:', error);
+        Alert.alert(
+          t('add.alerts.error'),
+          error instanceof Error ? error.message : t('add.alerts.unknownError'),
+          [{ text: t('add.alerts.ok'), onPress: () => setScanned(false) }]
+        );
+      }
+    } else if (data.startsWith('otpauth://')) {
       try {
         const parsedData = OTPService.parseOTPUri(data);
         if (parsedData) {
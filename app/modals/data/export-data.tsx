@@ -1,7 +1,10 @@
 import { SmartScreen } from '@/components/layout/SmartScreen';
 import { Colors } from '@/constants/Colors';
 import { useColorScheme } from '@/hooks/useColorScheme';
+import { useSettings } from '@/contexts/SettingsContext';
 import { useLanguage } from '@/hooks/useLanguage';
+import { AccountService } from '@/services/accountService';
+import { CryptoService } from '@/services/cryptoService';
 import { router } from 'expo-router';
 import {
     AlertCircle,
@@ -11,10 +14,11 @@ import {
     Settings,
     Upload
 } from 'lucide-react-native';
-import React, { useState } from 'react';
+import React, { useEffect, useState } from 'react';
 import {
     Alert,
     ScrollView,
+    Share,
     StyleSheet,
     Switch,
     Text,
@@ -27,12 +31,41 @@ export default function ExportDataModal() {
   const colorScheme = useColorScheme();
   const colors = Colors[colorScheme ?? 'dark'];
   const { t } = useLanguage();
+  const settings = useSettings();
 
   const [exportFormat, setExportFormat] = useState<'json' | 'encrypted'>('encrypted');
   const [includeSettings, setIncludeSettings] = useState(true);
   const [encryptionPassword, setEncryptionPassword] = useState('');
   const [confirmPassword, setConfirmPassword] = useState('');
   const [isExporting, setIsExporting] = useState(false);
+  const [accountCount, setAccountCount] = useState(0);
+
+  useEffect(() => {
+    AccountService.getAccounts()
+      .then(accounts => setAccountCount(accounts.length))
+      .catch(() => setAccountCount(0));
+  }, []);
+
+  const buildExportPayload = async (): Promise<string> => {
+    const accounts = await AccountService.getAccounts();
+    const payload: Record<string, unknown> = {
+      version: 1,
+      exportedAt: new Date().toISOString(),
+      accounts,
+    };
+    if (includeSettings) {
+      payload.settings = {
+        biometric: settings.biometric,
+        notifications: settings.notifications,
+        emailAutoSync: settings.emailAutoSync,
+        emailNotifications: settings.emailNotifications,
+        autoDeleteEmails: settings.autoDeleteEmails,
+        emailSyncFrequency: settings.emailSyncFrequency,
+        themeMode: settings.themeMode,
+      };
+    }
+    return JSON.stringify(payload);
+  };
 
   const handleExport = async () => {
     if (exportFormat === 'encrypted') {
@@ -56,9 +89,18 @@ export default function ExportDataModal() {
     setIsExporting(true);
     
     try {
-      // Simulate export process
-      await new Promise(resolve => setTimeout(resolve, 2000));
-      
+      const payload = await buildExportPayload();
+      let output = payload;
+
+      if (exportFormat === 'encrypted') {
+        // JSON vault data compresses several times over, so seal it as a
+        // compressed stream rather than encrypting the raw bytes
+        const sealed = await CryptoService.sealWithPassword(payload, encryptionPassword);
+        output = JSON.stringify({ format: 'secauth-sealed', version: 1, ...sealed });
+      }
+
+      await Share.share({ message: output });
+
       Alert.alert(
         t('dataManagement.exportData.exportSuccess'),
         t('dataManagement.exportData.exportSuccessMessage'),
@@ -75,8 +117,6 @@ export default function ExportDataModal() {
     }
   };
 
-  const mockAccountCount = 12;
-
   const renderHeader = () => (
     <View style={[styles.header, { borderBottomColor: colors.border }]}>
       <TouchableOpacity style={styles.backButton} onPress={() => router.back()}>
@@ -120,7 +160,7 @@ export default function ExportDataModal() {
               </Text>
             </View>
             <Text style={[styles.summaryText, { color: colors.textSecondary }]}>
-              {mockAccountCount} accounts will be exported
+              {accountCount} accounts will be exported
             </Text>
           </View>
         </View>
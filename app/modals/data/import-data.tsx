@@ -2,6 +2,10 @@ import { SmartScreen } from '@/components/layout/SmartScreen';
 import { Colors } from '@/constants/Colors';
 import { useColorScheme } from '@/hooks/useColorScheme';
 import { useLanguage } from '@/hooks/useLanguage';
+import { AccountService } from '@/services/accountService';
+import { CryptoService, SealedStreamResult } from '@/services/cryptoService';
+import { Account } from '@/types/auth';
+import * as Clipboard from 'expo-clipboard';
 import { router } from 'expo-router';
 import {
     AlertTriangle,
@@ -18,36 +22,85 @@ import {
     StyleSheet,
     Switch,
     Text,
+    TextInput,
     TouchableOpacity,
     View,
 } from 'react-native';
 
-interface MockFile {
+// Envelope written by export-data for password-protected exports
+interface SealedExport extends SealedStreamResult {
+  format: 'secauth-sealed';
+  version: number;
+}
+
+interface BackupSource {
   name: string;
   size: number;
-  type: string;
+  contents: string;
+  sealed: SealedExport | null;
 }
 
+type ImportedAccount = Omit<Account, 'id' | 'createdAt' | 'updatedAt'>;
+
+const isSealedExport = (value: any): value is SealedExport =>
+  value?.format === 'secauth-sealed' &&
+  value.version === 1 &&
+  typeof value.sealed === 'string' &&
+  typeof value.salt === 'string' &&
+  typeof value.iterations === 'number';
+
+// Accounts from a plain export payload; entries without a secret are dropped
+const accountsFromPayload = (payload: any): ImportedAccount[] => {
+  if (!Array.isArray(payload?.accounts)) {
+    return [];
+  }
+  return payload.accounts
+    .filter((account: any) => typeof account?.name === 'string' && typeof account.secret === 'string' && account.secret)
+    .map(({ id, createdAt, updatedAt, ...account }: Account) => ({
+      ...account,
+      expiresAt: account.expiresAt ? new Date(account.expiresAt) : undefined,
+    }));
+};
+
 export default function ImportDataModal() {
   const colorScheme = useColorScheme();
   const colors = Colors[colorScheme ?? 'dark'];
   const { t } = useLanguage();
 
-  const [selectedFile, setSelectedFile] = useState<MockFile | null>(null);
+  const [selectedFile, setSelectedFile] = useState<BackupSource | null>(null);
+  const [decryptionPassword, setDecryptionPassword] = useState('');
   const [mergeWithExisting, setMergeWithExisting] = useState(true);
   const [isImporting, setIsImporting] = useState(false);
 
+  // Exports leave the app through the share sheet as text, so they come
+  // back the same way: pasted from the clipboard
   const handleSelectFile = async () => {
     try {
-      // Simulate file picker - in a real implementation, this would use expo-document-picker
-      const mockFiles = [
-        { name: 'secauth_backup_2024.json', size: 15420, type: 'application/json' },
-        { name: 'authenticator_export.json', size: 8932, type: 'application/json' },
-        { name: 'backup_encrypted.json', size: 12045, type: 'application/json' },
-      ];
-      
-      const randomFile = mockFiles[Math.floor(Math.random() * mockFiles.length)];
-      setSelectedFile(randomFile);
+      const contents = (await Clipboard.getStringAsync()).trim();
+      let parsed: any = null;
+      try {
+        parsed = JSON.parse(contents);
+      } catch {
+        parsed = null;
+      }
+
+      const sealed = isSealedExport(parsed) ? parsed : null;
+      if (!sealed && !Array.isArray(parsed?.accounts)) {
+        setSelectedFile(null);
+        Alert.alert(
+          t('dataManagement.importData.invalidFile'),
+          t('dataManagement.importData.invalidFileMessage')
+        );
+        return;
+      }
+
+      setDecryptionPassword('');
+      setSelectedFile({
+        name: t(sealed ? 'dataManagement.importData.encryptedBackup' : 'dataManagement.importData.plainBackup'),
+        size: contents.length,
+        contents,
+        sealed,
+      });
     } catch (error) {
       console.error('File selection error:', error);
       Alert.alert(
@@ -66,6 +119,14 @@ export default function ImportDataModal() {
       return;
     }
 
+    if (selectedFile.sealed && !decryptionPassword) {
+      Alert.alert(
+        t('dataManagement.importData.importError'),
+        t('dataManagement.importData.passwordRequired')
+      );
+      return;
+    }
+
     if (!mergeWithExisting) {
       Alert.alert(
         t('dataManagement.importData.overwriteWarning'),
@@ -81,18 +142,47 @@ export default function ImportDataModal() {
   };
 
   const performImport = async () => {
+    if (!selectedFile) {
+      return;
+    }
     setIsImporting(true);
     
     try {
-      // Simulate import process
-      await new Promise(resolve => setTimeout(resolve, 2000));
-      
-      // Mock successful import
-      const importedCount = Math.floor(Math.random() * 10) + 1;
+      let payload = selectedFile.contents;
+      if (selectedFile.sealed) {
+        try {
+          payload = await CryptoService.openWithPassword(selectedFile.sealed, decryptionPassword);
+        } catch {
+          // A wrong password and a damaged export fail the same authentication check
+          Alert.alert(
+            t('dataManagement.importData.importError'),
+            t('dataManagement.importData.wrongPassword')
+          );
+          return;
+        }
+      }
+
+      const accounts = accountsFromPayload(JSON.parse(payload));
+      if (accounts.length === 0) {
+        Alert.alert(
+          t('dataManagement.importData.noAccountsFound'),
+          t('dataManagement.importData.noAccountsFoundMessage')
+        );
+        return;
+      }
+
+      // Only clear existing accounts once the backup has opened and parsed
+      if (!mergeWithExisting) {
+        const existing = await AccountService.getAccounts();
+        for (const account of existing) {
+          await AccountService.deleteAccount(account.id);
+        }
+      }
+      const imported = await AccountService.addAccounts(accounts);
       
       Alert.alert(
         t('dataManagement.importData.importSuccess'),
-        t('dataManagement.importData.importSuccessMessage', { count: importedCount }),
+        t('dataManagement.importData.importSuccessMessage', { count: imported.length }),
         [{ text: t('common.done'), onPress: () => router.back() }]
       );
     } catch (error) {
@@ -173,12 +263,28 @@ export default function ImportDataModal() {
                 </>
               ) : (
                 <Text style={[styles.filePlaceholder, { color: colors.textSecondary }]}>
-                  Tap to select a backup file
+                  {t('dataManagement.importData.pasteFromClipboard')}
                 </Text>
               )}
             </View>
             <Upload size={20} color={colors.textSecondary} />
           </TouchableOpacity>
+
+          {selectedFile?.sealed && (
+            <View style={[styles.inputCard, { backgroundColor: colors.surface }]}>
+              <Text style={[styles.inputLabel, { color: colors.text }]}>
+                {t('dataManagement.importData.decryptionPassword')}
+              </Text>
+              <TextInput
+                style={[styles.textInput, { backgroundColor: colors.background, color: colors.text, borderColor: colors.border }]}
+                value={decryptionPassword}
+                onChangeText={setDecryptionPassword}
+                placeholder="Enter password"
+                placeholderTextColor={colors.textSecondary}
+                secureTextEntry
+              />
+            </View>
+          )}
         </View>
 
         {/* Supported Formats */}
@@ -345,6 +451,23 @@ const styles = StyleSheet.create({
   filePlaceholder: {
     fontSize: 14,
   },
+  inputCard: {
+    borderRadius: 10,
+    padding: 14,
+    marginTop: 12,
+  },
+  inputLabel: {
+    fontSize: 16,
+    fontWeight: '500',
+    marginBottom: 6,
+  },
+  textInput: {
+    borderWidth: 1,
+    borderRadius: 8,
+    paddingHorizontal: 12,
+    paddingVertical: 10,
+    fontSize: 16,
+  },
   optionCard: {
     borderRadius: 10,
     padding: 14,
@@ -3,6 +3,7 @@ import { Colors } from '@/constants/Colors';
 import { useColorScheme } from '@/hooks/useColorScheme';
 import { useLanguage } from '@/hooks/useLanguage';
 import { BrandIconService } from '@/services/brandIconService';
+import { CodeScheduler, type ScheduledCode } from '@/services/codeScheduler';
 import { OTPService } from '@/services/otpService';
 import type { Account, GeneratedCode } from '@/types/auth';
 import * as Clipboard from 'expo-clipboard';
@@ -122,6 +123,18 @@ export const AccountCard: React.FC<AccountCardProps> = ({
     return Math.max(0, generatedCode.period - codeAge);
   }, [currentAccount.isTemporary, generatedCode, codeGeneratedAt, getRemainingTime]);
 
+  // Apply a code pushed by the scheduler at a period boundary
+  const applyScheduledCode = useCallback((scheduled: ScheduledCode) => {
+    const timeRemaining = Math.max(0, Math.ceil((scheduled.validUntil - Date.now()) / 1000));
+    setGeneratedCode({
+      code: scheduled.code,
+      timeRemaining,
+      period: scheduled.period,
+    });
+    setCodeGeneratedAt(scheduled.validUntil - scheduled.period * 1000);
+    progressValue.value = withTiming(timeRemaining / scheduled.period, { duration: 300 });
+  }, [progressValue]);
+
   const generateNewCode = useCallback(async () => {
     try {
       // If account is expired, show expired message
@@ -158,6 +171,13 @@ export const AccountCard: React.FC<AccountCardProps> = ({
         return;
       }
 
+      // Scheduled accounts only generate here until the first push arrives
+      const scheduled = CodeScheduler.getCode(currentAccount.id);
+      if (scheduled) {
+        applyScheduledCode(scheduled);
+        return;
+      }
+
       // For non-temporary accounts, generate new code
       const code = await OTPService.generateCode(currentAccount);
       setGeneratedCode(code);
@@ -178,7 +198,7 @@ export const AccountCard: React.FC<AccountCardProps> = ({
       setCodeGeneratedAt(Date.now());
       progressValue.value = withTiming(1, { duration: 300 });
     }
-  }, [currentAccount, progressValue, isExpired, getRemainingTime, t, hasGeneratedTempCode]);
+  }, [currentAccount, progressValue, isExpired, getRemainingTime, t, hasGeneratedTempCode, applyScheduledCode]);
 
   const updateProgress = useCallback(() => {
     if (!generatedCode) return;
@@ -199,6 +219,12 @@ export const AccountCard: React.FC<AccountCardProps> = ({
     generateNewCode();
   }, [generateNewCode, currentAccount.id]); // Only regenerate when account changes
 
+  // Time-based codes are pushed by the scheduler when their period rolls over
+  useEffect(() => {
+    if (!CodeScheduler.isScheduled(currentAccount)) return;
+    return CodeScheduler.subscribe(currentAccount.id, applyScheduledCode);
+  }, [currentAccount, applyScheduledCode]);
+
   // Setup timers for code updates and progress updates
   useEffect(() => {
     if (!generatedCode) return;
@@ -213,15 +239,18 @@ export const AccountCard: React.FC<AccountCardProps> = ({
       // For non-temporary accounts, update progress every second
       progressInterval = setInterval(updateProgress, 1000);
       
-      // Set timeout to regenerate code when it expires
-      const timeRemaining = getCurrentTimeRemaining();
-      if (timeRemaining > 0) {
-        codeTimeout = setTimeout(() => {
+      // Scheduled accounts get their next code pushed by CodeScheduler
+      if (!CodeScheduler.isScheduled(currentAccount)) {
+        // Set timeout to regenerate code when it expires
+        const timeRemaining = getCurrentTimeRemaining();
+        if (timeRemaining > 0) {
+          codeTimeout = setTimeout(() => {
+            generateNewCode();
+          }, timeRemaining * 1000);
+        } else if (isCodeExpired()) {
+          // If code is already expired, generate immediately
           generateNewCode();
-        }, timeRemaining * 1000);
-      } else if (isCodeExpired()) {
-        // If code is already expired, generate immediately
-        generateNewCode();
+        }
       }
     }
 
@@ -229,7 +258,7 @@ export const AccountCard: React.FC<AccountCardProps> = ({
       if (progressInterval) clearInterval(progressInterval);
       if (codeTimeout) clearTimeout(codeTimeout);
     };
-  }, [generatedCode, currentAccount.isTemporary, updateProgress, generateNewCode, getCurrentTimeRemaining, isCodeExpired]);
+  }, [generatedCode, currentAccount, updateProgress, generateNewCode, getCurrentTimeRemaining, isCodeExpired]);
 
   const handleCopyCode = useCallback(async () => {
     if (generatedCode && generatedCode.code !== t('account.expired')) {
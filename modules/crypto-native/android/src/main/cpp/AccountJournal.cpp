@@ -0,0 +1,633 @@
+#include "AccountJournal.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace crypto_native {
+
+namespace {
+
+constexpr char JOURNAL_MAGIC[8] = {'S', 'A', 'J', 'R', 'N', 'L', '\0', '\0'};
+constexpr uint32_t JOURNAL_VERSION = 1;
+
+class ByteWriter {
+public:
+    void u8(uint8_t value) { out.push_back(value); }
+    void u16(uint16_t value) { put(&value, sizeof(value)); }
+    void u32(uint32_t value) { put(&value, sizeof(value)); }
+    void i32(int32_t value) { put(&value, sizeof(value)); }
+
+    void str(const std::string& value) {
+        if (value.size() > UINT16_MAX) {
+            throw InvalidParameterException("Journal field too long");
+        }
+        u16(static_cast<uint16_t>(value.size()));
+        put(value.data(), value.size());
+    }
+
+    void bytes(const std::vector<uint8_t>& value) { put(value.data(), value.size()); }
+
+    std::vector<uint8_t> out;
+
+private:
+    void put(const void* data, size_t length) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + length);
+    }
+};
+
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t length) : data_(data), remaining_(length) {}
+
+    uint8_t u8() { uint8_t value; get(&value, sizeof(value)); return value; }
+    uint16_t u16() { uint16_t value; get(&value, sizeof(value)); return value; }
+    uint32_t u32() { uint32_t value; get(&value, sizeof(value)); return value; }
+    int32_t i32() { int32_t value; get(&value, sizeof(value)); return value; }
+
+    std::string str() {
+        const uint16_t length = u16();
+        need(length);
+        std::string value(reinterpret_cast<const char*>(data_), length);
+        data_ += length;
+        remaining_ -= length;
+        return value;
+    }
+
+    std::vector<uint8_t> rest() {
+        std::vector<uint8_t> value(data_, data_ + remaining_);
+        data_ += remaining_;
+        remaining_ = 0;
+        return value;
+    }
+
+private:
+    void need(size_t length) const {
+        if (length > remaining_) {
+            throw CryptoOperationException("Corrupt journal entry");
+        }
+    }
+
+    void get(void* out, size_t length) {
+        need(length);
+        std::memcpy(out, data_, length);
+        data_ += length;
+        remaining_ -= length;
+    }
+
+    const uint8_t* data_;
+    size_t remaining_;
+};
+
+void encodeState(ByteWriter& writer, const AccountState& state) {
+    writer.i32(state.order);
+    writer.str(state.name);
+    writer.bytes(state.payload);
+}
+
+AccountState decodeState(ByteReader& reader) {
+    AccountState state;
+    state.order = reader.i32();
+    state.name = reader.str();
+    state.payload = reader.rest();
+    return state;
+}
+
+std::vector<uint8_t> sequenceAad(uint64_t sequence) {
+    std::vector<uint8_t> aad(sizeof(sequence));
+    std::memcpy(aad.data(), &sequence, sizeof(sequence));
+    return aad;
+}
+
+void writeFully(int fd, const void* data, size_t length, uint64_t offset) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    size_t written = 0;
+    while (written < length) {
+        ssize_t result = pwrite(fd, bytes + written, length - written, static_cast<off_t>(offset + written));
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            throw CryptoOperationException("Failed to write journal: " + std::string(strerror(errno)));
+        }
+        written += static_cast<size_t>(result);
+    }
+}
+
+void readFully(int fd, void* data, size_t length, uint64_t offset) {
+    uint8_t* bytes = static_cast<uint8_t*>(data);
+    size_t done = 0;
+    while (done < length) {
+        ssize_t result = pread(fd, bytes + done, length - done, static_cast<off_t>(offset + done));
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) {
+            throw CryptoOperationException("Failed to read journal");
+        }
+        done += static_cast<size_t>(result);
+    }
+}
+
+} // anonymous namespace
+
+AccountJournal::AccountJournal(CryptoEngine& engine, SecureBytes key, CipherAlgorithm algorithm)
+    : engine_(engine), key_(std::move(key)), algorithm_(algorithm), vault_(engine, key_, algorithm) {}
+
+AccountJournal::~AccountJournal() {
+    close();
+}
+
+AccountJournal::RecoveryStats AccountJournal::open(const std::string& directory) {
+    const auto start = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (fd_ >= 0) {
+        throw CryptoOperationException("Journal already open");
+    }
+
+    directory_ = directory;
+    journalPath_ = directory + "/accounts.journal";
+    vault_.open(directory + "/accounts.vault");
+
+    RecoveryStats stats;
+    try {
+        openJournalFile();
+        replay(stats);
+    } catch (...) {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        overlay_.clear();
+        vault_.close();
+        throw;
+    }
+
+    stopping_ = false;
+    syncFailed_ = false;
+    worker_ = std::thread(&AccountJournal::workerLoop, this);
+
+    stats.journalBytes = journalSize_;
+    stats.elapsedMillis = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+void AccountJournal::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fd_ < 0) {
+            return;
+        }
+        stopping_ = true;
+    }
+    workCv_.notify_all();
+    durableCv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ::close(fd_);
+    fd_ = -1;
+    journalSize_ = 0;
+    overlay_.clear();
+    vault_.close();
+}
+
+void AccountJournal::put(const std::string& id, const AccountState& state) {
+    ByteWriter writer;
+    writer.u8(static_cast<uint8_t>(Op::PUT));
+    writer.str(id);
+    encodeState(writer, state);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    append(writer.out);
+    waitDurable(lock, writtenSequence_);
+}
+
+void AccountJournal::rename(const std::string& id, const std::string& name) {
+    ByteWriter writer;
+    writer.u8(static_cast<uint8_t>(Op::RENAME));
+    writer.str(id);
+    writer.str(name);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    AccountState existing;
+    if (!current(id, existing)) {
+        throw InvalidParameterException("Unknown account: " + id);
+    }
+    append(writer.out);
+    waitDurable(lock, writtenSequence_);
+}
+
+void AccountJournal::reorder(const std::vector<std::pair<std::string, int32_t>>& orders) {
+    if (orders.empty()) {
+        return;
+    }
+
+    ByteWriter writer;
+    writer.u8(static_cast<uint8_t>(Op::REORDER));
+    writer.u32(static_cast<uint32_t>(orders.size()));
+    for (const auto& entry : orders) {
+        writer.str(entry.first);
+        writer.i32(entry.second);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    append(writer.out);
+    waitDurable(lock, writtenSequence_);
+}
+
+bool AccountJournal::remove(const std::string& id) {
+    ByteWriter writer;
+    writer.u8(static_cast<uint8_t>(Op::REMOVE));
+    writer.str(id);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    AccountState existing;
+    if (!current(id, existing)) {
+        return false;
+    }
+    append(writer.out);
+    waitDurable(lock, writtenSequence_);
+    return true;
+}
+
+bool AccountJournal::get(const std::string& id, AccountState& state) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
+        throw CryptoOperationException("Journal not open");
+    }
+    return current(id, state);
+}
+
+std::vector<std::string> AccountJournal::ids() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
+        throw CryptoOperationException("Journal not open");
+    }
+
+    std::vector<std::string> result;
+    for (auto& id : vault_.ids()) {
+        auto it = overlay_.find(id);
+        if (it == overlay_.end() || !it->second.removed) {
+            result.push_back(std::move(id));
+        }
+    }
+    for (const auto& entry : overlay_) {
+        if (!entry.second.removed && !vault_.contains(entry.first)) {
+            result.push_back(entry.first);
+        }
+    }
+    return result;
+}
+
+void AccountJournal::compact() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
+        throw CryptoOperationException("Journal not open");
+    }
+
+    const uint64_t target = compactions_ + 1;
+    compactRequested_ = true;
+    compactFailed_ = false;
+    workCv_.notify_one();
+    durableCv_.wait(lock, [&] { return compactions_ >= target || compactFailed_ || stopping_ || syncFailed_; });
+    if (syncFailed_) {
+        throw CryptoOperationException("Journal sync failed");
+    }
+    if (compactFailed_) {
+        throw CryptoOperationException("Journal compaction failed");
+    }
+    if (compactions_ < target) {
+        throw CryptoOperationException("Journal closed before compaction");
+    }
+}
+
+uint64_t AccountJournal::journalBytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return journalSize_;
+}
+
+// Internal helpers (mutex_ held)
+
+void AccountJournal::openJournalFile() {
+    fd_ = ::open(journalPath_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd_ < 0) {
+        throw CryptoOperationException("Failed to open journal: " + std::string(strerror(errno)));
+    }
+
+    struct stat st{};
+    if (fstat(fd_, &st) != 0) {
+        throw CryptoOperationException("Failed to stat journal");
+    }
+
+    if (static_cast<size_t>(st.st_size) < sizeof(JournalHeader)) {
+        // New (or never completed) journal
+        JournalHeader header{};
+        std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        header.version = JOURNAL_VERSION;
+        if (ftruncate(fd_, 0) != 0) {
+            throw CryptoOperationException("Failed to reset journal");
+        }
+        writeFully(fd_, &header, sizeof(header), 0);
+        journalSize_ = sizeof(header);
+        return;
+    }
+
+    JournalHeader header{};
+    readFully(fd_, &header, sizeof(header), 0);
+    if (std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 ||
+        header.version != JOURNAL_VERSION) {
+        throw CryptoOperationException("Not a journal file");
+    }
+    journalSize_ = static_cast<uint64_t>(st.st_size);
+}
+
+void AccountJournal::replay(RecoveryStats& stats) {
+    const uint64_t folded = vault_.journalSequence();
+    uint64_t lastSequence = folded;
+
+    std::vector<uint8_t> buffer(journalSize_ - sizeof(JournalHeader));
+    if (!buffer.empty()) {
+        readFully(fd_, buffer.data(), buffer.size(), sizeof(JournalHeader));
+    }
+
+    size_t position = 0;
+    uint64_t previous = 0;
+    while (position + sizeof(FrameHeader) <= buffer.size()) {
+        FrameHeader frame;
+        std::memcpy(&frame, buffer.data() + position, sizeof(frame));
+        const size_t frameEnd = position + sizeof(FrameHeader) + frame.bodyLength;
+        if (frame.ivLength > sizeof(frame.iv) || frame.tagLength > sizeof(frame.tag) ||
+            frameEnd > buffer.size() || frame.sequence <= previous) {
+            break;
+        }
+
+        std::vector<uint8_t> plaintext;
+        try {
+            const uint8_t* body = buffer.data() + position + sizeof(FrameHeader);
+            plaintext = engine_.decrypt(
+                std::vector<uint8_t>(body, body + frame.bodyLength), key_, algorithm_,
+                std::vector<uint8_t>(frame.iv, frame.iv + frame.ivLength), PaddingMode::NONE,
+                sequenceAad(frame.sequence),
+                std::vector<uint8_t>(frame.tag, frame.tag + frame.tagLength));
+        } catch (const CryptoException&) {
+            // Torn or tampered tail: everything from here on is discarded
+            break;
+        }
+
+        if (frame.sequence > folded) {
+            apply(plaintext.data(), plaintext.size(), frame.sequence);
+            stats.replayedEntries++;
+        }
+        CryptoEngine::secureZero(plaintext);
+
+        previous = frame.sequence;
+        lastSequence = std::max(lastSequence, frame.sequence);
+        position = frameEnd;
+    }
+
+    const uint64_t validEnd = sizeof(JournalHeader) + position;
+    if (validEnd < journalSize_) {
+        if (ftruncate(fd_, static_cast<off_t>(validEnd)) != 0) {
+            throw CryptoOperationException("Failed to truncate journal tail");
+        }
+        journalSize_ = validEnd;
+    }
+
+    nextSequence_ = lastSequence + 1;
+    writtenSequence_ = lastSequence;
+    durableSequence_ = lastSequence;
+}
+
+void AccountJournal::append(const std::vector<uint8_t>& body) {
+    if (fd_ < 0) {
+        throw CryptoOperationException("Journal not open");
+    }
+    if (syncFailed_) {
+        throw CryptoOperationException("Journal sync failed");
+    }
+
+    const uint64_t sequence = nextSequence_;
+    EncryptionResult sealed = engine_.encrypt(body, key_, algorithm_, PaddingMode::NONE, {}, sequenceAad(sequence));
+
+    FrameHeader frame{};
+    frame.bodyLength = static_cast<uint32_t>(sealed.ciphertext.size());
+    frame.ivLength = static_cast<uint8_t>(sealed.iv.size());
+    frame.tagLength = static_cast<uint8_t>(sealed.tag.size());
+    frame.sequence = sequence;
+    std::memcpy(frame.iv, sealed.iv.data(), std::min(sealed.iv.size(), sizeof(frame.iv)));
+    std::memcpy(frame.tag, sealed.tag.data(), std::min(sealed.tag.size(), sizeof(frame.tag)));
+
+    std::vector<uint8_t> bytes(sizeof(FrameHeader) + sealed.ciphertext.size());
+    std::memcpy(bytes.data(), &frame, sizeof(frame));
+    std::memcpy(bytes.data() + sizeof(frame), sealed.ciphertext.data(), sealed.ciphertext.size());
+    writeFully(fd_, bytes.data(), bytes.size(), journalSize_);
+
+    nextSequence_++;
+    journalSize_ += bytes.size();
+    writtenSequence_ = sequence;
+    apply(body.data(), body.size(), sequence);
+    workCv_.notify_one();
+}
+
+void AccountJournal::apply(const uint8_t* body, size_t length, uint64_t sequence) {
+    ByteReader reader(body, length);
+    const Op op = static_cast<Op>(reader.u8());
+
+    switch (op) {
+        case Op::PUT: {
+            std::string id = reader.str();
+            Pending& pending = overlay_[id];
+            pending.removed = false;
+            pending.state = decodeState(reader);
+            pending.sequence = sequence;
+            break;
+        }
+        case Op::RENAME: {
+            std::string id = reader.str();
+            std::string name = reader.str();
+            AccountState state;
+            if (current(id, state)) {
+                state.name = std::move(name);
+                overlay_[id] = Pending{false, std::move(state), sequence};
+            }
+            break;
+        }
+        case Op::REORDER: {
+            const uint32_t count = reader.u32();
+            for (uint32_t i = 0; i < count; ++i) {
+                std::string id = reader.str();
+                const int32_t order = reader.i32();
+                AccountState state;
+                if (current(id, state) && state.order != order) {
+                    state.order = order;
+                    overlay_[id] = Pending{false, std::move(state), sequence};
+                }
+            }
+            break;
+        }
+        case Op::REMOVE: {
+            std::string id = reader.str();
+            overlay_[id] = Pending{true, AccountState{}, sequence};
+            break;
+        }
+        default:
+            throw CryptoOperationException("Unknown journal operation");
+    }
+}
+
+bool AccountJournal::current(const std::string& id, AccountState& state) {
+    auto it = overlay_.find(id);
+    if (it != overlay_.end()) {
+        if (it->second.removed) {
+            return false;
+        }
+        state = it->second.state;
+        return true;
+    }
+
+    if (!vault_.contains(id)) {
+        return false;
+    }
+    std::vector<uint8_t> record = vault_.get(id);
+    ByteReader reader(record.data(), record.size());
+    state = decodeState(reader);
+    CryptoEngine::secureZero(record);
+    return true;
+}
+
+void AccountJournal::waitDurable(std::unique_lock<std::mutex>& lock, uint64_t sequence) {
+    durableCv_.wait(lock, [&] { return durableSequence_ >= sequence || syncFailed_ || stopping_; });
+    if (durableSequence_ < sequence) {
+        throw CryptoOperationException("Journal sync failed");
+    }
+}
+
+bool AccountJournal::compactLocked(std::unique_lock<std::mutex>& lock) {
+    // Snapshot the overlay; appends may continue while the vault is written
+    std::vector<std::pair<std::string, Pending>> snapshot(overlay_.begin(), overlay_.end());
+    const uint64_t folded = writtenSequence_;
+    const uint64_t tailOffset = journalSize_;
+
+    lock.unlock();
+    bool foldSucceeded = true;
+    try {
+        for (const auto& entry : snapshot) {
+            if (entry.second.removed) {
+                vault_.remove(entry.first);
+            } else {
+                ByteWriter writer;
+                encodeState(writer, entry.second.state);
+                vault_.put(entry.first, writer.out);
+                CryptoEngine::secureZero(writer.out);
+            }
+        }
+        vault_.setJournalSequence(folded);
+        vault_.sync();
+    } catch (const std::exception&) {
+        // The journal still holds every mutation; retry on the next pass
+        foldSucceeded = false;
+    }
+    lock.lock();
+
+    if (!foldSucceeded) {
+        return false;
+    }
+
+    for (auto it = overlay_.begin(); it != overlay_.end();) {
+        if (it->second.sequence <= folded) {
+            it = overlay_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Carry frames written during the fold over to a fresh journal file. If
+    // that fails the old journal stays; its folded frames are skipped on replay
+    std::vector<uint8_t> tail(journalSize_ - tailOffset);
+    const std::string tempPath = journalPath_ + ".tmp";
+    int tempFd = ::open(tempPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (tempFd < 0) {
+        return false;
+    }
+
+    JournalHeader header{};
+    std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    header.version = JOURNAL_VERSION;
+    try {
+        if (!tail.empty()) {
+            readFully(fd_, tail.data(), tail.size(), tailOffset);
+        }
+        writeFully(tempFd, &header, sizeof(header), 0);
+        if (!tail.empty()) {
+            writeFully(tempFd, tail.data(), tail.size(), sizeof(header));
+        }
+        if (fsync(tempFd) != 0 || ::rename(tempPath.c_str(), journalPath_.c_str()) != 0) {
+            throw CryptoOperationException("Failed to replace journal");
+        }
+    } catch (const std::exception&) {
+        ::close(tempFd);
+        ::unlink(tempPath.c_str());
+        return false;
+    }
+
+    int dirFd = ::open(directory_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        ::close(dirFd);
+    }
+
+    ::close(fd_);
+    fd_ = tempFd;
+    journalSize_ = sizeof(header) + tail.size();
+    durableSequence_ = writtenSequence_;
+    return true;
+}
+
+void AccountJournal::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        workCv_.wait(lock, [&] {
+            return stopping_ || compactRequested_ ||
+                   (!syncFailed_ && writtenSequence_ > durableSequence_);
+        });
+
+        // Group commit: one fsync covers every frame written so far
+        if (!syncFailed_ && writtenSequence_ > durableSequence_) {
+            const uint64_t target = writtenSequence_;
+            const int fd = fd_;
+            lock.unlock();
+            const bool synced = fdatasync(fd) == 0;
+            lock.lock();
+            if (synced) {
+                durableSequence_ = std::max(durableSequence_, target);
+            } else {
+                syncFailed_ = true;
+            }
+            durableCv_.notify_all();
+        }
+
+        if (compactRequested_ || journalSize_ > kCompactionThreshold) {
+            compactRequested_ = false;
+            // A failed pass is retried on the next write; compact() reports it
+            if (!syncFailed_) {
+                if (compactLocked(lock)) {
+                    compactions_++;
+                } else {
+                    compactFailed_ = true;
+                }
+            }
+            durableCv_.notify_all();
+        }
+
+        if (stopping_ && (syncFailed_ || writtenSequence_ <= durableSequence_)) {
+            break;
+        }
+    }
+}
+
+} // namespace crypto_native
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "CryptoEngine.h"
+#include "VaultStore.h"
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace crypto_native {
+
+// Mutable part of an account as seen by the journal. The payload is the
+// opaque serialized account; name and order are kept apart so that renames
+// and reorders do not have to rewrite it.
+struct AccountState {
+    std::string name;
+    int32_t order = 0;
+    std::vector<uint8_t> payload;
+};
+
+// Append-only write-ahead journal over a VaultStore snapshot.
+//
+// Every mutation (put, rename, reorder, remove) is sealed with the vault key
+// and appended to `accounts.journal` with its sequence number as AAD, then
+// applied to an in-memory overlay. Appends are made durable by group commit:
+// a worker thread fsyncs once for every batch of writers waiting on it. When
+// the journal passes kCompactionThreshold the same worker folds the overlay
+// into `accounts.vault` (only the touched records), records the last folded
+// sequence in the vault header and truncates the journal to the unfolded tail.
+//
+// On open the journal is replayed from the last folded sequence; a torn or
+// unauthenticated tail is cut off at the last good frame.
+class AccountJournal {
+public:
+    static constexpr uint64_t kCompactionThreshold = 256 * 1024;
+
+    struct RecoveryStats {
+        uint64_t replayedEntries = 0;
+        uint64_t journalBytes = 0;
+        double elapsedMillis = 0;
+    };
+
+    AccountJournal(CryptoEngine& engine, SecureBytes key,
+                   CipherAlgorithm algorithm = CipherAlgorithm::AES_256_GCM);
+    ~AccountJournal();
+
+    AccountJournal(const AccountJournal&) = delete;
+    AccountJournal& operator=(const AccountJournal&) = delete;
+
+    // Opens or creates accounts.vault and accounts.journal in `directory`
+    RecoveryStats open(const std::string& directory);
+    void close();
+
+    void put(const std::string& id, const AccountState& state);
+    void rename(const std::string& id, const std::string& name);
+    void reorder(const std::vector<std::pair<std::string, int32_t>>& orders);
+    bool remove(const std::string& id);
+
+    bool get(const std::string& id, AccountState& state);
+    std::vector<std::string> ids();
+
+    // Folds the journal into the vault now and waits for it to finish;
+    // throws if the fold or the journal truncation fails
+    void compact();
+
+    uint64_t journalBytes();
+
+private:
+    enum class Op : uint8_t {
+        PUT = 1,
+        RENAME = 2,
+        REORDER = 3,
+        REMOVE = 4
+    };
+
+    struct FrameHeader {
+        uint32_t bodyLength;
+        uint8_t ivLength;
+        uint8_t tagLength;
+        uint16_t reserved;
+        uint64_t sequence;
+        uint8_t iv[16];
+        uint8_t tag[16];
+    };
+
+    struct JournalHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+    };
+
+    struct Pending {
+        bool removed = false;
+        AccountState state;
+        uint64_t sequence = 0;
+    };
+
+    static_assert(sizeof(FrameHeader) == 48, "FrameHeader must be 48 bytes");
+    static_assert(sizeof(JournalHeader) == 16, "JournalHeader must be 16 bytes");
+
+    // All helpers below expect mutex_ to be held
+    void openJournalFile();
+    void replay(RecoveryStats& stats);
+    void append(const std::vector<uint8_t>& body);
+    void apply(const uint8_t* body, size_t length, uint64_t sequence);
+    bool current(const std::string& id, AccountState& state);
+    void waitDurable(std::unique_lock<std::mutex>& lock, uint64_t sequence);
+    bool compactLocked(std::unique_lock<std::mutex>& lock);
+    void workerLoop();
+
+    CryptoEngine& engine_;
+    SecureBytes key_;
+    CipherAlgorithm algorithm_;
+    VaultStore vault_;
+
+    std::string journalPath_;
+    std::string directory_;
+    int fd_ = -1;
+    uint64_t journalSize_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable durableCv_;
+    std::thread worker_;
+    bool stopping_ = false;
+    bool syncFailed_ = false;
+    bool compactRequested_ = false;
+    bool compactFailed_ = false;
+    uint64_t compactions_ = 0;
+
+    uint64_t nextSequence_ = 1;
+    uint64_t writtenSequence_ = 0;
+    uint64_t durableSequence_ = 0;
+
+    std::unordered_map<std::string, Pending> overlay_;
+};
+
+} // namespace crypto_native
@@ -0,0 +1,299 @@
+#include "BlockCodec.h"
+#include "CryptoEngine.h"
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+
+namespace crypto_native {
+
+namespace {
+
+// LZ4 block format limits: a match is at least 4 bytes, the last match
+// starts at least 12 bytes before the end, and the last 5 bytes are literals
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MATCH_START_LIMIT = 12;
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 14;
+
+// After this many misses in a row the matcher starts skipping ahead, so
+// incompressible input costs little more than a copy
+constexpr unsigned SKIP_TRIGGER = 6;
+
+uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Writes the 255-run continuation of a length field whose nibble is full
+size_t writeLength(uint8_t* out, size_t remainder) {
+    size_t written = 0;
+    while (remainder >= 255) {
+        out[written++] = 255;
+        remainder -= 255;
+    }
+    out[written++] = static_cast<uint8_t>(remainder);
+    return written;
+}
+
+size_t readLength(const uint8_t* in, size_t length, size_t& ip, size_t limit) {
+    size_t total = 0;
+    uint8_t byte;
+    do {
+        if (ip >= length) {
+            throw CryptoOperationException("Truncated compressed block");
+        }
+        byte = in[ip++];
+        total += byte;
+        if (total > limit) {
+            throw CryptoOperationException("Compressed block overruns its length");
+        }
+    } while (byte == 255);
+    return total;
+}
+
+} // anonymous namespace
+
+struct BlockCodec::Deflate {
+    z_stream deflater{};
+    z_stream inflater{};
+    bool deflaterReady = false;
+    bool inflaterReady = false;
+
+    ~Deflate() {
+        if (deflaterReady) {
+            deflateEnd(&deflater);
+        }
+        if (inflaterReady) {
+            inflateEnd(&inflater);
+        }
+    }
+};
+
+BlockCodec::BlockCodec(CompressionMode mode)
+    : mode_(mode), deflate_(std::make_unique<Deflate>()) {
+    if (mode_ == CompressionMode::FAST) {
+        matchTable_.resize(size_t(1) << HASH_BITS);
+    }
+}
+
+BlockCodec::~BlockCodec() = default;
+
+size_t BlockCodec::compress(const uint8_t* in, size_t length, uint8_t* out) {
+    if (length < 2) {
+        return 0;
+    }
+    // Anything not strictly smaller is worthless; capping the output there
+    // also bounds `out` to `length` bytes
+    size_t capacity = length - 1;
+
+    switch (mode_) {
+        case CompressionMode::NONE:
+            return 0;
+        case CompressionMode::FAST:
+            return compressFast(in, length, out, capacity);
+        case CompressionMode::HIGH: {
+            z_stream& strm = deflate_->deflater;
+            if (!deflate_->deflaterReady) {
+                // Negative window bits: raw deflate, no zlib header or adler32
+                if (deflateInit2(&strm, 9, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                    throw CryptoOperationException("Failed to initialise deflate");
+                }
+                deflate_->deflaterReady = true;
+            } else if (deflateReset(&strm) != Z_OK) {
+                throw CryptoOperationException("Failed to reset deflate");
+            }
+            strm.next_in = const_cast<Bytef*>(in);
+            strm.avail_in = static_cast<uInt>(length);
+            strm.next_out = out;
+            strm.avail_out = static_cast<uInt>(capacity);
+            if (::deflate(&strm, Z_FINISH) != Z_STREAM_END) {
+                return 0;
+            }
+            return capacity - strm.avail_out;
+        }
+    }
+    return 0;
+}
+
+size_t BlockCodec::compressFast(const uint8_t* in, size_t length, uint8_t* out, size_t capacity) {
+    if (length <= MATCH_START_LIMIT) {
+        return 0;
+    }
+    std::fill(matchTable_.begin(), matchTable_.end(), 0);
+
+    size_t ip = 0;
+    size_t anchor = 0;
+    size_t op = 0;
+    unsigned misses = 0;
+    const size_t matchStartEnd = length - MATCH_START_LIMIT;
+    const size_t matchEnd = length - LAST_LITERALS;
+
+    while (ip <= matchStartEnd) {
+        uint32_t sequence = read32(in + ip);
+        uint32_t& slot = matchTable_[hashSequence(sequence)];
+        size_t ref = slot;
+        slot = static_cast<uint32_t>(ip);
+
+        if (ref >= ip || ip - ref > MAX_OFFSET || read32(in + ref) != sequence) {
+            ip += 1 + (misses++ >> SKIP_TRIGGER);
+            continue;
+        }
+        misses = 0;
+
+        while (ip > anchor && ref > 0 && in[ip - 1] == in[ref - 1]) {
+            --ip;
+            --ref;
+        }
+        size_t matchLength = MIN_MATCH;
+        while (ip + matchLength < matchEnd && in[ip + matchLength] == in[ref + matchLength]) {
+            ++matchLength;
+        }
+
+        size_t literals = ip - anchor;
+        size_t extra = matchLength - MIN_MATCH;
+        size_t needed = 1 + literals / 255 + 1 + literals + 2 + extra / 255 + 1;
+        if (op + needed > capacity) {
+            return 0;
+        }
+
+        uint8_t& token = out[op++];
+        token = static_cast<uint8_t>((literals >= 15 ? 15 : literals) << 4);
+        if (literals >= 15) {
+            op += writeLength(out + op, literals - 15);
+        }
+        std::memcpy(out + op, in + anchor, literals);
+        op += literals;
+
+        size_t offset = ip - ref;
+        out[op++] = static_cast<uint8_t>(offset);
+        out[op++] = static_cast<uint8_t>(offset >> 8);
+
+        token |= static_cast<uint8_t>(extra >= 15 ? 15 : extra);
+        if (extra >= 15) {
+            op += writeLength(out + op, extra - 15);
+        }
+
+        ip += matchLength;
+        anchor = ip;
+        // Seed the table just behind the new position so back-to-back
+        // matches are found without waiting for another miss
+        if (ip - 2 <= matchStartEnd) {
+            matchTable_[hashSequence(read32(in + ip - 2))] = static_cast<uint32_t>(ip - 2);
+        }
+    }
+
+    size_t literals = length - anchor;
+    if (op + 1 + literals / 255 + 1 + literals > capacity) {
+        return 0;
+    }
+    out[op++] = static_cast<uint8_t>((literals >= 15 ? 15 : literals) << 4);
+    if (literals >= 15) {
+        op += writeLength(out + op, literals - 15);
+    }
+    std::memcpy(out + op, in + anchor, literals);
+    return op + literals;
+}
+
+void BlockCodec::decompress(CompressionMode mode, const uint8_t* in, size_t length,
+                            uint8_t* out, size_t rawLength) {
+    switch (mode) {
+        case CompressionMode::NONE:
+            if (length != rawLength) {
+                throw CryptoOperationException("Stored block length mismatch");
+            }
+            std::memcpy(out, in, length);
+            return;
+        case CompressionMode::FAST:
+            decompressFast(in, length, out, rawLength);
+            return;
+        case CompressionMode::HIGH: {
+            z_stream& strm = deflate_->inflater;
+            if (!deflate_->inflaterReady) {
+                if (inflateInit2(&strm, -15) != Z_OK) {
+                    throw CryptoOperationException("Failed to initialise inflate");
+                }
+                deflate_->inflaterReady = true;
+            } else if (inflateReset(&strm) != Z_OK) {
+                throw CryptoOperationException("Failed to reset inflate");
+            }
+            strm.next_in = const_cast<Bytef*>(in);
+            strm.avail_in = static_cast<uInt>(length);
+            strm.next_out = out;
+            strm.avail_out = static_cast<uInt>(rawLength);
+            if (inflate(&strm, Z_FINISH) != Z_STREAM_END || strm.avail_out != 0 || strm.avail_in != 0) {
+                throw CryptoOperationException("Corrupt deflate block");
+            }
+            return;
+        }
+    }
+    throw CryptoOperationException("Unknown block encoding");
+}
+
+void BlockCodec::decompressFast(const uint8_t* in, size_t length, uint8_t* out, size_t rawLength) {
+    size_t ip = 0;
+    size_t op = 0;
+
+    for (;;) {
+        if (ip >= length) {
+            throw CryptoOperationException("Truncated compressed block");
+        }
+        uint8_t token = in[ip++];
+
+        size_t literals = token >> 4;
+        if (literals == 15) {
+            literals += readLength(in, length, ip, rawLength);
+        }
+        if (literals > length - ip || literals > rawLength - op) {
+            throw CryptoOperationException("Compressed block overruns its length");
+        }
+        std::memcpy(out + op, in + ip, literals);
+        ip += literals;
+        op += literals;
+
+        // The final sequence carries literals only
+        if (ip == length) {
+            break;
+        }
+
+        if (length - ip < 2) {
+            throw CryptoOperationException("Truncated compressed block");
+        }
+        size_t offset = in[ip] | (static_cast<size_t>(in[ip + 1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) {
+            throw CryptoOperationException("Invalid match offset");
+        }
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15) {
+            matchLength += readLength(in, length, ip, rawLength);
+        }
+        matchLength += MIN_MATCH;
+        if (matchLength > rawLength - op) {
+            throw CryptoOperationException("Compressed block overruns its length");
+        }
+
+        // Overlapping copies replicate the last `offset` bytes
+        const uint8_t* match = out + op - offset;
+        if (offset >= matchLength) {
+            std::memcpy(out + op, match, matchLength);
+        } else {
+            for (size_t i = 0; i < matchLength; ++i) {
+                out[op + i] = match[i];
+            }
+        }
+        op += matchLength;
+    }
+
+    if (op != rawLength) {
+        throw CryptoOperationException("Compressed block length mismatch");
+    }
+}
+
+} // namespace crypto_native
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace crypto_native {
+
+enum class CompressionMode : uint8_t {
+    NONE,
+    FAST,  // LZ4 block format, greedy single-probe matcher
+    HIGH   // Raw deflate (zlib), level 9
+};
+
+// Compresses independent blocks of at most a few MiB. Each block decodes on
+// its own, so a stream built from them never needs more than one block of
+// history in memory. A codec keeps its match table and zlib state between
+// blocks; use one per thread.
+class BlockCodec {
+public:
+    explicit BlockCodec(CompressionMode mode);
+    ~BlockCodec();
+
+    BlockCodec(const BlockCodec&) = delete;
+    BlockCodec& operator=(const BlockCodec&) = delete;
+
+    CompressionMode mode() const { return mode_; }
+
+    // Writes the compressed block to `out` and returns its length, or 0 when
+    // it would not come out smaller than `length` (store the block raw then)
+    size_t compress(const uint8_t* in, size_t length, uint8_t* out);
+
+    // Decodes a block that must expand to exactly `rawLength` bytes; throws
+    // CryptoOperationException on malformed input
+    void decompress(CompressionMode mode, const uint8_t* in, size_t length, uint8_t* out, size_t rawLength);
+
+private:
+    struct Deflate;
+
+    size_t compressFast(const uint8_t* in, size_t length, uint8_t* out, size_t capacity);
+    static void decompressFast(const uint8_t* in, size_t length, uint8_t* out, size_t rawLength);
+
+    CompressionMode mode_;
+    std::vector<uint32_t> matchTable_;
+    std::unique_ptr<Deflate> deflate_;
+};
+
+} // namespace crypto_native
@@ -1,5 +1,9 @@
 #include "CryptoEngine.h"
+#include "ParallelCipher.h"
 #include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
 #include <random>
 #include <cstring>
 #include <iomanip>
@@ -7,11 +11,16 @@
 #include <cstdlib>
 
 #ifdef NO_OPENSSL
-// Simple implementations without OpenSSL
+// Portable primitives stand in for OpenSSL
+#include "PortableCrypto.h"
+#ifdef __ANDROID__
 #include <android/log.h>
 #define LOG_TAG "CryptoEngine"
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 #else
+#define LOGE(...) ((void)0)
+#endif
+#else
 #include <openssl/evp.h>
 #include <openssl/aes.h>
 #include <openssl/rand.h>
@@ -61,6 +70,182 @@ CryptoEngine::CryptoEngine() : pImpl(std::make_unique<Impl>()) {}
 
 CryptoEngine::~CryptoEngine() = default;
 
+#ifndef NO_OPENSSL
+static const EVP_MD* digestFor(HashAlgorithm algorithm) {
+    switch (algorithm) {
+        case HashAlgorithm::SHA1:
+            return EVP_sha1();
+        case HashAlgorithm::SHA256:
+            return EVP_sha256();
+        case HashAlgorithm::SHA384:
+            return EVP_sha384();
+        case HashAlgorithm::SHA512:
+            return EVP_sha512();
+        case HashAlgorithm::MD5:
+            return EVP_md5();
+        default:
+            throw InvalidParameterException("Unsupported hash algorithm");
+    }
+}
+
+static const EVP_CIPHER* aesCipherFor(CipherAlgorithm algorithm) {
+    switch (algorithm) {
+        case CipherAlgorithm::AES_128_CBC:
+            return EVP_aes_128_cbc();
+        case CipherAlgorithm::AES_192_CBC:
+            return EVP_aes_192_cbc();
+        case CipherAlgorithm::AES_256_CBC:
+            return EVP_aes_256_cbc();
+        case CipherAlgorithm::AES_128_GCM:
+            return EVP_aes_128_gcm();
+        case CipherAlgorithm::AES_192_GCM:
+            return EVP_aes_192_gcm();
+        case CipherAlgorithm::AES_256_GCM:
+            return EVP_aes_256_gcm();
+        case CipherAlgorithm::AES_128_CTR:
+            return EVP_aes_128_ctr();
+        case CipherAlgorithm::AES_192_CTR:
+            return EVP_aes_192_ctr();
+        case CipherAlgorithm::AES_256_CTR:
+            return EVP_aes_256_ctr();
+        default:
+            throw InvalidParameterException("Invalid AES algorithm");
+    }
+}
+
+static const EVP_CIPHER* aeadCipherFor(CipherAlgorithm algorithm) {
+    if (algorithm == CipherAlgorithm::CHACHA20_POLY1305) {
+        return EVP_chacha20_poly1305();
+    }
+    return aesCipherFor(algorithm);
+}
+
+// HKDF-Expand from a context already keyed with the PRK
+static void hkdfExpandInto(HMAC_CTX* ctx, const uint8_t* info, size_t infoLength,
+                           uint8_t* out, size_t length, size_t hashLength) {
+    uint8_t block[EVP_MAX_MD_SIZE];
+    unsigned int blockLength = 0;
+    size_t written = 0;
+
+    for (uint8_t counter = 1; written < length; ++counter) {
+        if (HMAC_Init_ex(ctx, nullptr, 0, nullptr, nullptr) != 1 ||
+            (counter > 1 && HMAC_Update(ctx, block, blockLength) != 1) ||
+            HMAC_Update(ctx, info, infoLength) != 1 ||
+            HMAC_Update(ctx, &counter, 1) != 1 ||
+            HMAC_Final(ctx, block, &blockLength) != 1 ||
+            blockLength != hashLength) {
+            OPENSSL_cleanse(block, sizeof(block));
+            throw CryptoOperationException("HKDF expansion failed");
+        }
+        size_t take = std::min(length - written, hashLength);
+        std::memcpy(out + written, block, take);
+        written += take;
+    }
+    OPENSSL_cleanse(block, sizeof(block));
+}
+
+#else
+// HKDF-Expand from an HMAC keyed with the PRK
+static void hkdfExpandInto(portable::Hmac& mac, const uint8_t* info, size_t infoLength,
+                           uint8_t* out, size_t length, size_t hashLength) {
+    uint8_t block[portable::kMaxDigestSize];
+    size_t written = 0;
+
+    for (uint8_t counter = 1; written < length; ++counter) {
+        mac.reset();
+        if (counter > 1) {
+            mac.update(block, hashLength);
+        }
+        mac.update(info, infoLength);
+        mac.update(&counter, 1);
+        mac.finish(block);
+        size_t take = std::min(length - written, hashLength);
+        std::memcpy(out + written, block, take);
+        written += take;
+    }
+    secureWipe(block, sizeof(block));
+}
+#endif
+
+#ifndef NO_OPENSSL
+// Contexts keyed once per handle. Keying a cipher context expands the AES
+// round keys (and for GCM the GHASH table); keying an HMAC context hashes the
+// inner and outer pads. Freeing a context cleanses both.
+struct KeyHandle::Schedules {
+    static constexpr size_t kCipherCount = static_cast<size_t>(CipherAlgorithm::CHACHA20_POLY1305) + 1;
+    static constexpr size_t kHashCount = static_cast<size_t>(HashAlgorithm::MD5) + 1;
+
+    EVP_CIPHER_CTX* encrypt[kCipherCount] = {};
+    EVP_CIPHER_CTX* decrypt[kCipherCount] = {};
+    HMAC_CTX* hmac[kHashCount] = {};
+
+    Schedules() = default;
+    Schedules(const Schedules&) = delete;
+    Schedules& operator=(const Schedules&) = delete;
+
+    ~Schedules() {
+        for (size_t i = 0; i < kCipherCount; ++i) {
+            EVP_CIPHER_CTX_free(encrypt[i]);
+            EVP_CIPHER_CTX_free(decrypt[i]);
+        }
+        for (size_t i = 0; i < kHashCount; ++i) {
+            HMAC_CTX_free(hmac[i]);
+        }
+    }
+
+    EVP_CIPHER_CTX* cipherContext(CipherAlgorithm algorithm, const EVP_CIPHER* cipher,
+                                  const SecureBytes& key, bool forEncryption) {
+        EVP_CIPHER_CTX*& slot = (forEncryption ? encrypt : decrypt)[static_cast<size_t>(algorithm)];
+        if (slot) {
+            return slot;
+        }
+
+        EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+        if (!ctx) {
+            throw CryptoOperationException("Failed to create cipher context");
+        }
+        int keyed = forEncryption
+            ? EVP_EncryptInit_ex(ctx, cipher, nullptr, key.data(), nullptr)
+            : EVP_DecryptInit_ex(ctx, cipher, nullptr, key.data(), nullptr);
+        if (keyed != 1) {
+            EVP_CIPHER_CTX_free(ctx);
+            throw CryptoOperationException("Failed to key cipher context");
+        }
+        slot = ctx;
+        return slot;
+    }
+
+    HMAC_CTX* hmacContext(HashAlgorithm algorithm, const SecureBytes& key) {
+        HMAC_CTX*& slot = hmac[static_cast<size_t>(algorithm)];
+        if (slot) {
+            return slot;
+        }
+
+        HMAC_CTX* ctx = HMAC_CTX_new();
+        if (!ctx) {
+            throw CryptoOperationException("Failed to create HMAC context");
+        }
+        if (HMAC_Init_ex(ctx, key.data(), static_cast<int>(key.size()), digestFor(algorithm), nullptr) != 1) {
+            HMAC_CTX_free(ctx);
+            throw CryptoOperationException("Failed to key HMAC context");
+        }
+        slot = ctx;
+        return slot;
+    }
+};
+#else
+struct KeyHandle::Schedules {};
+#endif
+
+KeyHandle::KeyHandle(SecureBytes key)
+    : key_(std::move(key)), schedules_(std::make_unique<Schedules>()) {
+    if (key_.empty()) {
+        throw InvalidKeyException("Key must not be empty");
+    }
+}
+
+KeyHandle::~KeyHandle() = default;
+
 // Utility functions
 size_t CryptoEngine::getKeySize(CipherAlgorithm algorithm) {
     switch (algorithm) {
@@ -253,19 +438,20 @@ void CryptoEngine::secureZero(void* ptr, size_t size) {
 }
 
 // Random number generation
-std::vector<uint8_t> CryptoEngine::randomBytes(size_t length) {
-    std::vector<uint8_t> buffer(length);
+void CryptoEngine::fillRandom(uint8_t* buffer, size_t length) {
 #ifdef NO_OPENSSL
-    // Use C++ random number generator
-    std::uniform_int_distribution<uint8_t> dist(0, 255);
-    for (size_t i = 0; i < length; ++i) {
-        buffer[i] = dist(pImpl->rng);
-    }
+    // Keys, salts and nonces come from here, so never from a seeded PRNG
+    portable::randomBytes(buffer, length);
 #else
-    if (RAND_bytes(buffer.data(), static_cast<int>(length)) != 1) {
+    if (RAND_bytes(buffer, static_cast<int>(length)) != 1) {
         throw CryptoOperationException("Failed to generate random bytes");
     }
 #endif
+}
+
+std::vector<uint8_t> CryptoEngine::randomBytes(size_t length) {
+    std::vector<uint8_t> buffer(length);
+    fillRandom(buffer.data(), length);
     return buffer;
 }
 
@@ -278,8 +464,10 @@ uint32_t CryptoEngine::randomInt(uint32_t min, uint32_t max) {
     return dist(pImpl->rng);
 }
 
-std::vector<uint8_t> CryptoEngine::generateKey(size_t length) {
-    return randomBytes(length);
+SecureBytes CryptoEngine::generateKey(size_t length) {
+    SecureBytes key(length);
+    fillRandom(key.data(), length);
+    return key;
 }
 
 // Padding implementations
@@ -381,32 +569,17 @@ std::vector<uint8_t> CryptoEngine::hash(
     HashAlgorithm algorithm
 ) {
 #ifdef NO_OPENSSL
-    // Simplified hash implementation - just return a simple checksum for now
-    // In a real implementation, you would use a proper hash library
-    LOGE("Hash function not implemented without OpenSSL");
-    throw CryptoOperationException("Hash function not available in simplified mode");
-#else
-    const EVP_MD* md = nullptr;
-    
-    switch (algorithm) {
-        case HashAlgorithm::SHA1:
-            md = EVP_sha1();
-            break;
-        case HashAlgorithm::SHA256:
-            md = EVP_sha256();
-            break;
-        case HashAlgorithm::SHA384:
-            md = EVP_sha384();
-            break;
-        case HashAlgorithm::SHA512:
-            md = EVP_sha512();
-            break;
-        case HashAlgorithm::MD5:
-            md = EVP_md5();
-            break;
-        default:
-            throw InvalidParameterException("Unsupported hash algorithm");
+    if (algorithm == HashAlgorithm::MD5) {
+        LOGE("MD5 not implemented without OpenSSL");
+        throw CryptoOperationException("MD5 not available in simplified mode");
     }
+    portable::Digest digest(algorithm);
+    std::vector<uint8_t> result(digest.size());
+    digest.update(data.data(), data.size());
+    digest.finish(result.data());
+    return result;
+#else
+    const EVP_MD* md = digestFor(algorithm);
 
     EVP_MD_CTX* ctx = EVP_MD_CTX_new();
     if (!ctx) {
@@ -432,35 +605,21 @@ std::vector<uint8_t> CryptoEngine::hash(
 // HMAC implementation
 std::vector<uint8_t> CryptoEngine::hmac(
     const std::vector<uint8_t>& data,
-    const std::vector<uint8_t>& key,
+    const SecureBytes& key,
     HashAlgorithm algorithm
 ) {
 #ifdef NO_OPENSSL
-    // Simplified HMAC implementation - not cryptographically secure
-    LOGE("HMAC function not implemented without OpenSSL");
-    throw CryptoOperationException("HMAC function not available in simplified mode");
-#else
-    const EVP_MD* md = nullptr;
-    
-    switch (algorithm) {
-        case HashAlgorithm::SHA1:
-            md = EVP_sha1();
-            break;
-        case HashAlgorithm::SHA256:
-            md = EVP_sha256();
-            break;
-        case HashAlgorithm::SHA384:
-            md = EVP_sha384();
-            break;
-        case HashAlgorithm::SHA512:
-            md = EVP_sha512();
-            break;
-        case HashAlgorithm::MD5:
-            md = EVP_md5();
-            break;
-        default:
-            throw InvalidParameterException("Unsupported hash algorithm");
+    if (algorithm == HashAlgorithm::MD5) {
+        LOGE("HMAC-MD5 not implemented without OpenSSL");
+        throw CryptoOperationException("HMAC-MD5 not available in simplified mode");
     }
+    portable::Hmac mac(algorithm, key.data(), key.size());
+    std::vector<uint8_t> result(mac.size());
+    mac.update(data.data(), data.size());
+    mac.finish(result.data());
+    return result;
+#else
+    const EVP_MD* md = digestFor(algorithm);
 
     std::vector<uint8_t> result(EVP_MD_size(md));
     unsigned int resultLength = 0;
@@ -475,10 +634,180 @@ std::vector<uint8_t> CryptoEngine::hmac(
 #endif
 }
 
+std::vector<uint8_t> CryptoEngine::hmac(
+    const std::vector<uint8_t>& data,
+    KeyHandle& key,
+    HashAlgorithm algorithm
+) {
+    std::lock_guard<std::mutex> lock(key.mutex_);
+#ifdef NO_OPENSSL
+    return hmac(data, key.key_, algorithm);
+#else
+    HMAC_CTX* ctx = key.schedules_->hmacContext(algorithm, key.key_);
+
+    std::vector<uint8_t> result(EVP_MD_size(digestFor(algorithm)));
+    unsigned int resultLength = 0;
+
+    // A null key reloads the inner/outer midstates computed when the context was keyed
+    if (HMAC_Init_ex(ctx, nullptr, 0, nullptr, nullptr) != 1 ||
+        HMAC_Update(ctx, data.data(), data.size()) != 1 ||
+        HMAC_Final(ctx, result.data(), &resultLength) != 1) {
+        throw CryptoOperationException("HMAC operation failed");
+    }
+
+    result.resize(resultLength);
+    return result;
+#endif
+}
+
+// HKDF
+static size_t hkdfHashLength(HashAlgorithm algorithm, size_t length) {
+    size_t hashLength;
+    switch (algorithm) {
+        case HashAlgorithm::SHA256:
+            hashLength = 32;
+            break;
+        case HashAlgorithm::SHA512:
+            hashLength = 64;
+            break;
+        default:
+            throw InvalidParameterException("HKDF supports SHA256 and SHA512 only");
+    }
+    if (length == 0 || length > 255 * hashLength) {
+        throw InvalidParameterException("Invalid HKDF output length");
+    }
+    return hashLength;
+}
+
+SecureBytes CryptoEngine::hkdfExtract(
+    const std::vector<uint8_t>& salt,
+    const SecureBytes& ikm,
+    HashAlgorithm algorithm
+) {
+#ifdef NO_OPENSSL
+    size_t hashLength = hkdfHashLength(algorithm, 1);
+    std::vector<uint8_t> actualSalt = salt.empty() ? std::vector<uint8_t>(hashLength) : salt;
+
+    portable::Hmac mac(algorithm, actualSalt.data(), actualSalt.size());
+    SecureBytes prk(hashLength);
+    mac.update(ikm.data(), ikm.size());
+    mac.finish(prk.data());
+    return prk;
+#else
+    size_t hashLength = hkdfHashLength(algorithm, 1);
+    std::vector<uint8_t> actualSalt = salt.empty() ? std::vector<uint8_t>(hashLength) : salt;
+
+    SecureBytes prk(hashLength);
+    unsigned int prkLength = 0;
+    if (HMAC(digestFor(algorithm), actualSalt.data(), static_cast<int>(actualSalt.size()),
+             ikm.data(), ikm.size(), prk.data(), &prkLength) == nullptr || prkLength != hashLength) {
+        throw CryptoOperationException("HKDF extraction failed");
+    }
+    return prk;
+#endif
+}
+
+SecureBytes CryptoEngine::hkdfExtract(
+    const std::vector<uint8_t>& salt,
+    KeyHandle& ikm,
+    HashAlgorithm algorithm
+) {
+    std::lock_guard<std::mutex> lock(ikm.mutex_);
+    return hkdfExtract(salt, ikm.key_, algorithm);
+}
+
+SecureBytes CryptoEngine::hkdfExpand(
+    const SecureBytes& prk,
+    const std::vector<uint8_t>& info,
+    size_t length,
+    HashAlgorithm algorithm
+) {
+#ifdef NO_OPENSSL
+    size_t hashLength = hkdfHashLength(algorithm, length);
+    portable::Hmac mac(algorithm, prk.data(), prk.size());
+    SecureBytes okm(length);
+    hkdfExpandInto(mac, info.data(), info.size(), okm.data(), length, hashLength);
+    return okm;
+#else
+    size_t hashLength = hkdfHashLength(algorithm, length);
+    HMAC_CTX* ctx = HMAC_CTX_new();
+    if (!ctx) {
+        throw CryptoOperationException("Failed to create HMAC context");
+    }
+
+    SecureBytes okm(length);
+    try {
+        if (HMAC_Init_ex(ctx, prk.data(), static_cast<int>(prk.size()), digestFor(algorithm), nullptr) != 1) {
+            throw CryptoOperationException("Failed to key HMAC context");
+        }
+        hkdfExpandInto(ctx, info.data(), info.size(), okm.data(), length, hashLength);
+    } catch (...) {
+        HMAC_CTX_free(ctx);
+        throw;
+    }
+
+    HMAC_CTX_free(ctx);
+    return okm;
+#endif
+}
+
+SecureBytes CryptoEngine::hkdfExpandBatch(
+    KeyHandle& prk,
+    const std::vector<std::vector<uint8_t>>& infos,
+    size_t length,
+    HashAlgorithm algorithm
+) {
+#ifdef NO_OPENSSL
+    size_t hashLength = hkdfHashLength(algorithm, length);
+    std::lock_guard<std::mutex> lock(prk.mutex_);
+    portable::Hmac mac(algorithm, prk.key_.data(), prk.key_.size());
+
+    SecureBytes okm(infos.size() * length);
+    for (size_t i = 0; i < infos.size(); ++i) {
+        hkdfExpandInto(mac, infos[i].data(), infos[i].size(), okm.data() + i * length, length, hashLength);
+    }
+    return okm;
+#else
+    size_t hashLength = hkdfHashLength(algorithm, length);
+    std::lock_guard<std::mutex> lock(prk.mutex_);
+    HMAC_CTX* ctx = prk.schedules_->hmacContext(algorithm, prk.key_);
+
+    SecureBytes okm(infos.size() * length);
+    for (size_t i = 0; i < infos.size(); ++i) {
+        hkdfExpandInto(ctx, infos[i].data(), infos[i].size(), okm.data() + i * length, length, hashLength);
+    }
+    return okm;
+#endif
+}
+
 // Main encryption function
 EncryptionResult CryptoEngine::encrypt(
     const std::vector<uint8_t>& data,
-    const std::vector<uint8_t>& key,
+    const SecureBytes& key,
+    CipherAlgorithm algorithm,
+    PaddingMode padding,
+    const std::vector<uint8_t>& iv,
+    const std::vector<uint8_t>& aad
+) {
+    return encryptWith(data, key, nullptr, algorithm, padding, iv, aad);
+}
+
+EncryptionResult CryptoEngine::encrypt(
+    const std::vector<uint8_t>& data,
+    KeyHandle& key,
+    CipherAlgorithm algorithm,
+    PaddingMode padding,
+    const std::vector<uint8_t>& iv,
+    const std::vector<uint8_t>& aad
+) {
+    std::lock_guard<std::mutex> lock(key.mutex_);
+    return encryptWith(data, key.key_, &key, algorithm, padding, iv, aad);
+}
+
+EncryptionResult CryptoEngine::encryptWith(
+    const std::vector<uint8_t>& data,
+    const SecureBytes& key,
+    KeyHandle* handle,
     CipherAlgorithm algorithm,
     PaddingMode padding,
     const std::vector<uint8_t>& iv,
@@ -508,7 +837,7 @@ EncryptionResult CryptoEngine::encrypt(
         case CipherAlgorithm::AES_128_CTR:
         case CipherAlgorithm::AES_192_CTR:
         case CipherAlgorithm::AES_256_CTR:
-            return encryptAES(data, key, algorithm, padding, actualIv, aad);
+            return encryptAES(data, key, handle, algorithm, padding, actualIv, aad);
         case CipherAlgorithm::CHACHA20:
         case CipherAlgorithm::CHACHA20_POLY1305:
             return encryptChaCha20(data, key, algorithm, actualIv, aad);
@@ -520,53 +849,80 @@ EncryptionResult CryptoEngine::encrypt(
 // AES encryption implementation
 EncryptionResult CryptoEngine::encryptAES(
     const std::vector<uint8_t>& data,
-    const std::vector<uint8_t>& key,
+    const SecureBytes& key,
+    KeyHandle* handle,
     CipherAlgorithm algorithm,
     PaddingMode padding,
     const std::vector<uint8_t>& iv,
     const std::vector<uint8_t>& aad
 ) {
 #ifdef NO_OPENSSL
-    // Simplified encryption - just return the data XORed with key (NOT SECURE!)
-    LOGE("AES encryption not implemented without OpenSSL");
-    throw CryptoOperationException("AES encryption not available in simplified mode");
+    // Portable AES is keyed per call; the expansion is small next to the data
+    (void)handle;
+
+    // Large CTR and GCM buffers are split across cores; the output is identical
+    if ((isStreamCipher(algorithm) || isAeadMode(algorithm)) && ParallelCipher::segmentsFor(data.size()) > 1) {
+        std::vector<uint8_t> ciphertext(data.size());
+        std::vector<uint8_t> tag;
+        if (isAeadMode(algorithm)) {
+            tag.resize(portable::kGcmTagSize);
+            ParallelCipher::gcmEncrypt(key, iv.data(), aad.data(), aad.size(),
+                                       data.data(), data.size(), ciphertext.data(), tag.data());
+        } else {
+            ParallelCipher::ctr(key, iv.data(), data.data(), data.size(), ciphertext.data());
+        }
+        return EncryptionResult(std::move(ciphertext), iv, std::move(tag));
+    }
+
+    if (isAeadMode(algorithm)) {
+        portable::AesGcm gcm(key.data(), key.size());
+        std::vector<uint8_t> ciphertext(data.size());
+        std::vector<uint8_t> tag(portable::kGcmTagSize);
+        gcm.seal(iv.data(), iv.size(), aad.data(), aad.size(), data.data(), data.size(),
+                 ciphertext.data(), tag.data());
+        return EncryptionResult(std::move(ciphertext), iv, std::move(tag));
+    }
+
+    portable::Aes aes(key.data(), key.size());
+    if (isStreamCipher(algorithm)) {
+        std::vector<uint8_t> ciphertext(data.size());
+        uint8_t counter[portable::kAesBlockSize];
+        std::memcpy(counter, iv.data(), sizeof(counter));
+        portable::aesCtr(aes, counter, data.data(), data.size(), ciphertext.data());
+        return EncryptionResult(std::move(ciphertext), iv);
+    }
+
+    // EVP leaves its own PKCS#7 padding on in CBC mode, so OpenSSL builds
+    // append a pad block after the caller's padding; do the same so either
+    // build reads the other's ciphertext
+    std::vector<uint8_t> padded = addPadding(data, padding, portable::kAesBlockSize);
+    size_t finalPad = portable::kAesBlockSize - padded.size() % portable::kAesBlockSize;
+    padded.insert(padded.end(), finalPad, static_cast<uint8_t>(finalPad));
+    std::vector<uint8_t> ciphertext(padded.size());
+    portable::aesCbcEncrypt(aes, iv.data(), padded.data(), padded.size(), ciphertext.data());
+    secureZero(padded);
+    return EncryptionResult(std::move(ciphertext), iv);
 #else
-    const EVP_CIPHER* cipher = nullptr;
-    
-    // Select cipher
-    switch (algorithm) {
-        case CipherAlgorithm::AES_128_CBC:
-            cipher = EVP_aes_128_cbc();
-            break;
-        case CipherAlgorithm::AES_192_CBC:
-            cipher = EVP_aes_192_cbc();
-            break;
-        case CipherAlgorithm::AES_256_CBC:
-            cipher = EVP_aes_256_cbc();
-            break;
-        case CipherAlgorithm::AES_128_GCM:
-            cipher = EVP_aes_128_gcm();
-            break;
-        case CipherAlgorithm::AES_192_GCM:
-            cipher = EVP_aes_192_gcm();
-            break;
-        case CipherAlgorithm::AES_256_GCM:
-            cipher = EVP_aes_256_gcm();
-            break;
-        case CipherAlgorithm::AES_128_CTR:
-            cipher = EVP_aes_128_ctr();
-            break;
-        case CipherAlgorithm::AES_192_CTR:
-            cipher = EVP_aes_192_ctr();
-            break;
-        case CipherAlgorithm::AES_256_CTR:
-            cipher = EVP_aes_256_ctr();
-            break;
-        default:
-            throw InvalidParameterException("Invalid AES algorithm");
+    const EVP_CIPHER* cipher = aesCipherFor(algorithm);
+
+    // Large CTR and GCM buffers are split across cores; the output is identical
+    if ((isStreamCipher(algorithm) || isAeadMode(algorithm)) && ParallelCipher::segmentsFor(data.size()) > 1) {
+        std::vector<uint8_t> ciphertext(data.size());
+        std::vector<uint8_t> tag;
+        if (isAeadMode(algorithm)) {
+            tag.resize(16);
+            ParallelCipher::gcmEncrypt(key, iv.data(), aad.data(), aad.size(),
+                                       data.data(), data.size(), ciphertext.data(), tag.data());
+        } else {
+            ParallelCipher::ctr(key, iv.data(), data.data(), data.size(), ciphertext.data());
+        }
+        return EncryptionResult(std::move(ciphertext), iv, std::move(tag));
     }
 
-    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    // A handle's context is already keyed and stays alive with the handle
+    EVP_CIPHER_CTX* ctx = handle
+        ? handle->schedules_->cipherContext(algorithm, cipher, key, true)
+        : EVP_CIPHER_CTX_new();
     if (!ctx) {
         throw CryptoOperationException("Failed to create cipher context");
     }
@@ -583,8 +939,11 @@ EncryptionResult CryptoEngine::encryptAES(
     int ciphertextLen = 0;
 
     try {
-        // Initialize encryption
-        if (EVP_EncryptInit_ex(ctx, cipher, nullptr, key.data(), iv.data()) != 1) {
+        // Initialize encryption; a keyed context only takes the new IV
+        int initialized = handle
+            ? EVP_EncryptInit_ex(ctx, nullptr, nullptr, nullptr, iv.data())
+            : EVP_EncryptInit_ex(ctx, cipher, nullptr, key.data(), iv.data());
+        if (initialized != 1) {
             throw CryptoOperationException("Failed to initialize encryption");
         }
 
@@ -616,13 +975,17 @@ EncryptionResult CryptoEngine::encryptAES(
         }
 
         ciphertext.resize(ciphertextLen);
-        
+
     } catch (...) {
-        EVP_CIPHER_CTX_free(ctx);
+        if (!handle) {
+            EVP_CIPHER_CTX_free(ctx);
+        }
         throw;
     }
 
-    EVP_CIPHER_CTX_free(ctx);
+    if (!handle) {
+        EVP_CIPHER_CTX_free(ctx);
+    }
     return EncryptionResult(std::move(ciphertext), iv, std::move(tag));
 #endif
 }
@@ -630,7 +993,33 @@ EncryptionResult CryptoEngine::encryptAES(
 // Main decryption function
 std::vector<uint8_t> CryptoEngine::decrypt(
     const std::vector<uint8_t>& ciphertext,
-    const std::vector<uint8_t>& key,
+    const SecureBytes& key,
+    CipherAlgorithm algorithm,
+    const std::vector<uint8_t>& iv,
+    PaddingMode padding,
+    const std::vector<uint8_t>& aad,
+    const std::vector<uint8_t>& tag
+) {
+    return decryptWith(ciphertext, key, nullptr, algorithm, iv, padding, aad, tag);
+}
+
+std::vector<uint8_t> CryptoEngine::decrypt(
+    const std::vector<uint8_t>& ciphertext,
+    KeyHandle& key,
+    CipherAlgorithm algorithm,
+    const std::vector<uint8_t>& iv,
+    PaddingMode padding,
+    const std::vector<uint8_t>& aad,
+    const std::vector<uint8_t>& tag
+) {
+    std::lock_guard<std::mutex> lock(key.mutex_);
+    return decryptWith(ciphertext, key.key_, &key, algorithm, iv, padding, aad, tag);
+}
+
+std::vector<uint8_t> CryptoEngine::decryptWith(
+    const std::vector<uint8_t>& ciphertext,
+    const SecureBytes& key,
+    KeyHandle* handle,
     CipherAlgorithm algorithm,
     const std::vector<uint8_t>& iv,
     PaddingMode padding,
@@ -641,7 +1030,7 @@ std::vector<uint8_t> CryptoEngine::decrypt(
     if (key.size() != getKeySize(algorithm)) {
         throw InvalidKeyException("Invalid key size for algorithm");
     }
-    
+
     if (iv.size() != getIvSize(algorithm)) {
         throw InvalidParameterException("Invalid IV size for algorithm");
     }
@@ -661,7 +1050,7 @@ std::vector<uint8_t> CryptoEngine::decrypt(
         case CipherAlgorithm::AES_128_CTR:
         case CipherAlgorithm::AES_192_CTR:
         case CipherAlgorithm::AES_256_CTR:
-            return decryptAES(ciphertext, key, algorithm, iv, padding, aad, tag);
+            return decryptAES(ciphertext, key, handle, algorithm, iv, padding, aad, tag);
         case CipherAlgorithm::CHACHA20:
         case CipherAlgorithm::CHACHA20_POLY1305:
             return decryptChaCha20(ciphertext, key, algorithm, iv, aad, tag);
@@ -673,7 +1062,8 @@ std::vector<uint8_t> CryptoEngine::decrypt(
 // AES decryption implementation
 std::vector<uint8_t> CryptoEngine::decryptAES(
     const std::vector<uint8_t>& ciphertext,
-    const std::vector<uint8_t>& key,
+    const SecureBytes& key,
+    KeyHandle* handle,
     CipherAlgorithm algorithm,
     const std::vector<uint8_t>& iv,
     PaddingMode padding,
@@ -681,46 +1071,72 @@ std::vector<uint8_t> CryptoEngine::decryptAES(
     const std::vector<uint8_t>& tag
 ) {
 #ifdef NO_OPENSSL
-    // Simplified decryption - not implemented
-    LOGE("AES decryption not implemented without OpenSSL");
-    throw CryptoOperationException("AES decryption not available in simplified mode");
+    (void)handle;
+    if ((isStreamCipher(algorithm) || (isAeadMode(algorithm) && tag.size() == portable::kGcmTagSize)) &&
+        ParallelCipher::segmentsFor(ciphertext.size()) > 1) {
+        std::vector<uint8_t> plaintext(ciphertext.size());
+        if (!isAeadMode(algorithm)) {
+            ParallelCipher::ctr(key, iv.data(), ciphertext.data(), ciphertext.size(), plaintext.data());
+        } else if (!ParallelCipher::gcmDecrypt(key, iv.data(), aad.data(), aad.size(), ciphertext.data(),
+                                               ciphertext.size(), plaintext.data(), tag.data(), tag.size())) {
+            throw AuthenticationFailedException("Decryption finalization failed");
+        }
+        return plaintext;
+    }
+
+    if (isAeadMode(algorithm)) {
+        portable::AesGcm gcm(key.data(), key.size());
+        std::vector<uint8_t> plaintext(ciphertext.size());
+        if (!gcm.open(iv.data(), iv.size(), aad.data(), aad.size(), ciphertext.data(), ciphertext.size(),
+                      plaintext.data(), tag.data(), tag.size())) {
+            throw AuthenticationFailedException("Decryption finalization failed");
+        }
+        return plaintext;
+    }
+
+    portable::Aes aes(key.data(), key.size());
+    std::vector<uint8_t> plaintext(ciphertext.size());
+    if (isStreamCipher(algorithm)) {
+        uint8_t counter[portable::kAesBlockSize];
+        std::memcpy(counter, iv.data(), sizeof(counter));
+        portable::aesCtr(aes, counter, ciphertext.data(), ciphertext.size(), plaintext.data());
+        return plaintext;
+    }
+
+    // CBC: strip the EVP-style PKCS#7 block first, then the caller's padding
+    if (ciphertext.empty() || ciphertext.size() % portable::kAesBlockSize != 0) {
+        throw CryptoOperationException("Decryption finalization failed");
+    }
+    portable::aesCbcDecrypt(aes, iv.data(), ciphertext.data(), ciphertext.size(), plaintext.data());
+    uint8_t finalPad = plaintext.back();
+    bool padValid = finalPad >= 1 && finalPad <= portable::kAesBlockSize;
+    for (size_t i = 0; padValid && i < finalPad; ++i) {
+        padValid = plaintext[plaintext.size() - 1 - i] == finalPad;
+    }
+    if (!padValid) {
+        secureZero(plaintext);
+        throw CryptoOperationException("Decryption finalization failed");
+    }
+    plaintext.resize(plaintext.size() - finalPad);
+    return removePadding(plaintext, padding, getBlockSize(algorithm));
 #else
-    const EVP_CIPHER* cipher = nullptr;
-    
-    // Select cipher (same as encryption)
-    switch (algorithm) {
-        case CipherAlgorithm::AES_128_CBC:
-            cipher = EVP_aes_128_cbc();
-            break;
-        case CipherAlgorithm::AES_192_CBC:
-            cipher = EVP_aes_192_cbc();
-            break;
-        case CipherAlgorithm::AES_256_CBC:
-            cipher = EVP_aes_256_cbc();
-            break;
-        case CipherAlgorithm::AES_128_GCM:
-            cipher = EVP_aes_128_gcm();
-            break;
-        case CipherAlgorithm::AES_192_GCM:
-            cipher = EVP_aes_192_gcm();
-            break;
-        case CipherAlgorithm::AES_256_GCM:
-            cipher = EVP_aes_256_gcm();
-            break;
-        case CipherAlgorithm::AES_128_CTR:
-            cipher = EVP_aes_128_ctr();
-            break;
-        case CipherAlgorithm::AES_192_CTR:
-            cipher = EVP_aes_192_ctr();
-            break;
-        case CipherAlgorithm::AES_256_CTR:
-            cipher = EVP_aes_256_ctr();
-            break;
-        default:
-            throw InvalidParameterException("Invalid AES algorithm");
+    const EVP_CIPHER* cipher = aesCipherFor(algorithm);
+
+    if ((isStreamCipher(algorithm) || (isAeadMode(algorithm) && tag.size() == 16)) &&
+        ParallelCipher::segmentsFor(ciphertext.size()) > 1) {
+        std::vector<uint8_t> plaintext(ciphertext.size());
+        if (!isAeadMode(algorithm)) {
+            ParallelCipher::ctr(key, iv.data(), ciphertext.data(), ciphertext.size(), plaintext.data());
+        } else if (!ParallelCipher::gcmDecrypt(key, iv.data(), aad.data(), aad.size(), ciphertext.data(),
+                                               ciphertext.size(), plaintext.data(), tag.data(), tag.size())) {
+            throw AuthenticationFailedException("Decryption finalization failed");
+        }
+        return plaintext;
     }
 
-    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    EVP_CIPHER_CTX* ctx = handle
+        ? handle->schedules_->cipherContext(algorithm, cipher, key, false)
+        : EVP_CIPHER_CTX_new();
     if (!ctx) {
         throw CryptoOperationException("Failed to create cipher context");
     }
@@ -730,14 +1146,17 @@ std::vector<uint8_t> CryptoEngine::decryptAES(
     int plaintextLen = 0;
 
     try {
-        // Initialize decryption
-        if (EVP_DecryptInit_ex(ctx, cipher, nullptr, key.data(), iv.data()) != 1) {
+        // Initialize decryption; a keyed context only takes the new IV
+        int initialized = handle
+            ? EVP_DecryptInit_ex(ctx, nullptr, nullptr, nullptr, iv.data())
+            : EVP_DecryptInit_ex(ctx, cipher, nullptr, key.data(), iv.data());
+        if (initialized != 1) {
             throw CryptoOperationException("Failed to initialize decryption");
         }
 
         // Set authentication tag for AEAD modes
         if (isAeadMode(algorithm)) {
-            if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, static_cast<int>(tag.size()), 
+            if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, static_cast<int>(tag.size()),
                                    const_cast<uint8_t*>(tag.data())) != 1) {
                 throw CryptoOperationException("Failed to set authentication tag");
             }
@@ -758,6 +1177,9 @@ std::vector<uint8_t> CryptoEngine::decryptAES(
 
         // Finalize decryption
         if (EVP_DecryptFinal_ex(ctx, plaintext.data() + len, &len) != 1) {
+            if (isAeadMode(algorithm)) {
+                throw AuthenticationFailedException("Decryption finalization failed");
+            }
             throw CryptoOperationException("Decryption finalization failed");
         }
         plaintextLen += len;
@@ -770,11 +1192,177 @@ std::vector<uint8_t> CryptoEngine::decryptAES(
         }
 
     } catch (...) {
-        EVP_CIPHER_CTX_free(ctx);
+        if (!handle) {
+            EVP_CIPHER_CTX_free(ctx);
+        }
         throw;
     }
 
-    EVP_CIPHER_CTX_free(ctx);
+    if (!handle) {
+        EVP_CIPHER_CTX_free(ctx);
+    }
+    return plaintext;
+#endif
+}
+
+// Batch AEAD
+void CryptoEngine::nextBatchNonce(KeyHandle& key, uint8_t* nonce) {
+    if (!key.nonceReady_ || key.nonceCounter_ == UINT32_MAX) {
+        fillRandom(key.noncePrefix_, sizeof(key.noncePrefix_));
+        key.nonceCounter_ = 0;
+        key.nonceReady_ = true;
+    }
+    std::memcpy(nonce, key.noncePrefix_, sizeof(key.noncePrefix_));
+    uint32_t counter = key.nonceCounter_++;
+    nonce[8] = static_cast<uint8_t>(counter >> 24);
+    nonce[9] = static_cast<uint8_t>(counter >> 16);
+    nonce[10] = static_cast<uint8_t>(counter >> 8);
+    nonce[11] = static_cast<uint8_t>(counter);
+}
+
+std::vector<uint8_t> CryptoEngine::sealBatch(
+    KeyHandle& key,
+    CipherAlgorithm algorithm,
+    const std::vector<BatchRecord>& records
+) {
+    if (!isAeadMode(algorithm)) {
+        throw InvalidParameterException("Batch sealing requires an AEAD cipher");
+    }
+
+    std::lock_guard<std::mutex> lock(key.mutex_);
+    if (key.key_.size() != getKeySize(algorithm)) {
+        throw InvalidKeyException("Invalid key size for algorithm");
+    }
+
+    size_t total = 0;
+    for (const auto& record : records) {
+        if ((!record.data && record.length > 0) || (!record.aad && record.aadLength > 0) ||
+            record.length > INT_MAX || record.aadLength > INT_MAX) {
+            throw InvalidParameterException("Invalid batch record");
+        }
+        total += record.length + kBatchOverhead;
+    }
+
+#ifdef NO_OPENSSL
+    if (algorithm == CipherAlgorithm::CHACHA20_POLY1305) {
+        LOGE("ChaCha20-Poly1305 not implemented without OpenSSL");
+        throw CryptoOperationException("ChaCha20-Poly1305 not available in simplified mode");
+    }
+    portable::AesGcm gcm(key.key_.data(), key.key_.size());
+    std::vector<uint8_t> sealed(total);
+    uint8_t* cursor = sealed.data();
+
+    for (const auto& record : records) {
+        uint8_t* nonce = cursor;
+        uint8_t* body = nonce + kBatchNonceSize;
+        nextBatchNonce(key, nonce);
+        gcm.seal(nonce, kBatchNonceSize, record.aad, record.aadLength, record.data, record.length,
+                 body, body + record.length);
+        cursor = body + record.length + kBatchTagSize;
+    }
+
+    return sealed;
+#else
+    // One keyed context serves the whole batch; each record only resets the
+    // nonce and is written in place, so no per-record buffers are allocated
+    EVP_CIPHER_CTX* ctx = key.schedules_->cipherContext(algorithm, aeadCipherFor(algorithm), key.key_, true);
+    std::vector<uint8_t> sealed(total);
+    uint8_t* cursor = sealed.data();
+
+    for (const auto& record : records) {
+        uint8_t* nonce = cursor;
+        uint8_t* body = nonce + kBatchNonceSize;
+        nextBatchNonce(key, nonce);
+
+        int len = 0;
+        int finalLen = 0;
+        if (EVP_EncryptInit_ex(ctx, nullptr, nullptr, nullptr, nonce) != 1 ||
+            (record.aadLength > 0 &&
+             EVP_EncryptUpdate(ctx, nullptr, &len, record.aad, static_cast<int>(record.aadLength)) != 1) ||
+            EVP_EncryptUpdate(ctx, body, &len, record.data, static_cast<int>(record.length)) != 1 ||
+            EVP_EncryptFinal_ex(ctx, body + len, &finalLen) != 1 ||
+            EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, static_cast<int>(kBatchTagSize),
+                                body + record.length) != 1) {
+            secureZero(sealed);
+            throw CryptoOperationException("Batch sealing failed");
+        }
+        cursor = body + record.length + kBatchTagSize;
+    }
+
+    return sealed;
+#endif
+}
+
+std::vector<uint8_t> CryptoEngine::openBatch(
+    KeyHandle& key,
+    CipherAlgorithm algorithm,
+    const std::vector<BatchRecord>& sealed
+) {
+    if (!isAeadMode(algorithm)) {
+        throw InvalidParameterException("Batch opening requires an AEAD cipher");
+    }
+
+    std::lock_guard<std::mutex> lock(key.mutex_);
+    if (key.key_.size() != getKeySize(algorithm)) {
+        throw InvalidKeyException("Invalid key size for algorithm");
+    }
+
+    size_t total = 0;
+    for (const auto& record : sealed) {
+        if (!record.data || record.length < kBatchOverhead || (!record.aad && record.aadLength > 0) ||
+            record.length > INT_MAX || record.aadLength > INT_MAX) {
+            throw InvalidParameterException("Invalid sealed batch record");
+        }
+        total += record.length - kBatchOverhead;
+    }
+
+#ifdef NO_OPENSSL
+    if (algorithm == CipherAlgorithm::CHACHA20_POLY1305) {
+        LOGE("ChaCha20-Poly1305 not implemented without OpenSSL");
+        throw CryptoOperationException("ChaCha20-Poly1305 not available in simplified mode");
+    }
+    portable::AesGcm gcm(key.key_.data(), key.key_.size());
+    std::vector<uint8_t> plaintext(total);
+    uint8_t* cursor = plaintext.data();
+
+    for (size_t i = 0; i < sealed.size(); ++i) {
+        const BatchRecord& record = sealed[i];
+        const uint8_t* body = record.data + kBatchNonceSize;
+        size_t bodyLength = record.length - kBatchOverhead;
+        if (!gcm.open(record.data, kBatchNonceSize, record.aad, record.aadLength, body, bodyLength,
+                      cursor, body + bodyLength, kBatchTagSize)) {
+            secureZero(plaintext);
+            throw AuthenticationFailedException("Batch record " + std::to_string(i) + " failed authentication");
+        }
+        cursor += bodyLength;
+    }
+
+    return plaintext;
+#else
+    EVP_CIPHER_CTX* ctx = key.schedules_->cipherContext(algorithm, aeadCipherFor(algorithm), key.key_, false);
+    std::vector<uint8_t> plaintext(total);
+    uint8_t* cursor = plaintext.data();
+
+    for (size_t i = 0; i < sealed.size(); ++i) {
+        const BatchRecord& record = sealed[i];
+        const uint8_t* body = record.data + kBatchNonceSize;
+        size_t bodyLength = record.length - kBatchOverhead;
+        uint8_t* tag = const_cast<uint8_t*>(body + bodyLength);
+
+        int len = 0;
+        int finalLen = 0;
+        if (EVP_DecryptInit_ex(ctx, nullptr, nullptr, nullptr, record.data) != 1 ||
+            EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, static_cast<int>(kBatchTagSize), tag) != 1 ||
+            (record.aadLength > 0 &&
+             EVP_DecryptUpdate(ctx, nullptr, &len, record.aad, static_cast<int>(record.aadLength)) != 1) ||
+            EVP_DecryptUpdate(ctx, cursor, &len, body, static_cast<int>(bodyLength)) != 1 ||
+            EVP_DecryptFinal_ex(ctx, cursor + len, &finalLen) != 1) {
+            secureZero(plaintext);
+            throw AuthenticationFailedException("Batch record " + std::to_string(i) + " failed authentication");
+        }
+        cursor += bodyLength;
+    }
+
     return plaintext;
 #endif
 }
@@ -782,7 +1370,7 @@ std::vector<uint8_t> CryptoEngine::decryptAES(
 // ChaCha20 encryption (simplified implementation)
 EncryptionResult CryptoEngine::encryptChaCha20(
     const std::vector<uint8_t>& data,
-    const std::vector<uint8_t>& key,
+    const SecureBytes& key,
     CipherAlgorithm algorithm,
     const std::vector<uint8_t>& iv,
     const std::vector<uint8_t>& aad
@@ -795,7 +1383,7 @@ EncryptionResult CryptoEngine::encryptChaCha20(
 // ChaCha20 decryption (simplified implementation)
 std::vector<uint8_t> CryptoEngine::decryptChaCha20(
     const std::vector<uint8_t>& ciphertext,
-    const std::vector<uint8_t>& key,
+    const SecureBytes& key,
     CipherAlgorithm algorithm,
     const std::vector<uint8_t>& iv,
     const std::vector<uint8_t>& aad,
@@ -810,41 +1398,119 @@ std::vector<uint8_t> CryptoEngine::decryptChaCha20(
 DerivedKey CryptoEngine::deriveKey(
     const std::string& password,
     const KeyDerivationOptions& options
+) {
+    return deriveKey(password, options, nullptr, nullptr);
+}
+
+SecureBytes CryptoEngine::deriveKeyWithSalt(
+    const std::string& password,
+    const std::vector<uint8_t>& salt,
+    const KeyDerivationOptions& options
+) {
+    return deriveKeyWithSalt(password, salt, options, nullptr, nullptr);
+}
+
+DerivedKey CryptoEngine::deriveKey(
+    const std::string& password,
+    const KeyDerivationOptions& options,
+    const KdfProgressCallback& progress,
+    const CancellationToken* cancel
 ) {
     std::vector<uint8_t> salt = randomBytes(options.saltLength);
-    std::vector<uint8_t> key = deriveKeyWithSalt(password, salt, options);
+    SecureBytes key = deriveKeyWithSalt(password, salt, options, progress, cancel);
     return DerivedKey{std::move(key), std::move(salt)};
 }
 
-std::vector<uint8_t> CryptoEngine::deriveKeyWithSalt(
+SecureBytes CryptoEngine::deriveKeyWithSalt(
     const std::string& password,
     const std::vector<uint8_t>& salt,
-    const KeyDerivationOptions& options
+    const KeyDerivationOptions& options,
+    const KdfProgressCallback& progress,
+    const CancellationToken* cancel
 ) {
     switch (options.kdf) {
         case KeyDerivationFunction::PBKDF2:
-            return pbkdf2(password, salt, options.iterations, options.keyLength, HashAlgorithm::SHA256);
+            return pbkdf2(password, salt, options.iterations, options.keyLength, HashAlgorithm::SHA256,
+                          progress, cancel);
         case KeyDerivationFunction::SCRYPT:
-            return scrypt(password, salt, 16384, 8, 1, options.keyLength); // Standard scrypt parameters
+            return scrypt(password, salt, 16384, 8, 1, options.keyLength, // Standard scrypt parameters
+                          progress, cancel);
         case KeyDerivationFunction::ARGON2:
-            return argon2(password, salt, options.iterations, options.memory, options.parallelism, options.keyLength);
+            return argon2(password, salt, options.iterations, options.memory, options.parallelism, options.keyLength,
+                          progress, cancel);
         default:
             throw InvalidParameterException("Unsupported key derivation function");
     }
 }
 
 // PBKDF2 implementation
-std::vector<uint8_t> CryptoEngine::pbkdf2(
+SecureBytes CryptoEngine::pbkdf2(
     const std::string& password,
     const std::vector<uint8_t>& salt,
     uint32_t iterations,
     uint32_t keyLength,
-    HashAlgorithm hashAlg
+    HashAlgorithm hashAlg,
+    const KdfProgressCallback& progress,
+    const CancellationToken* cancel
 ) {
 #ifdef NO_OPENSSL
-    // Simplified PBKDF2 implementation - not cryptographically secure
-    LOGE("PBKDF2 not implemented without OpenSSL");
-    throw CryptoOperationException("PBKDF2 not available in simplified mode");
+    if (hashAlg == HashAlgorithm::MD5) {
+        throw InvalidParameterException("Unsupported hash algorithm for PBKDF2");
+    }
+    if (iterations == 0) {
+        throw InvalidParameterException("PBKDF2 needs at least one iteration");
+    }
+
+    // Same loop as the OpenSSL build below, over the portable HMAC
+    portable::Hmac mac(hashAlg, reinterpret_cast<const uint8_t*>(password.data()), password.size());
+
+    struct Scratch {
+        uint8_t u[portable::kMaxDigestSize];
+        uint8_t t[portable::kMaxDigestSize];
+        ~Scratch() { secureWipe(this, sizeof(*this)); }
+    } scratch;
+
+    const size_t hashLength = mac.size();
+    const uint64_t blocks = (static_cast<uint64_t>(keyLength) + hashLength - 1) / hashLength;
+    const uint64_t total = blocks * iterations;
+    SecureBytes key(keyLength);
+
+    for (uint64_t block = 1; block <= blocks; ++block) {
+        const uint8_t index[4] = {
+            static_cast<uint8_t>(block >> 24), static_cast<uint8_t>(block >> 16),
+            static_cast<uint8_t>(block >> 8), static_cast<uint8_t>(block)
+        };
+        mac.update(salt.data(), salt.size());
+        mac.update(index, sizeof(index));
+        mac.finish(scratch.u);
+        std::memcpy(scratch.t, scratch.u, hashLength);
+
+        uint32_t round = 1;
+        while (round < iterations) {
+            uint32_t stop = iterations - round > kKdfCheckInterval ? round + kKdfCheckInterval : iterations;
+            for (; round < stop; ++round) {
+                mac.update(scratch.u, hashLength);
+                mac.finish(scratch.u);
+                for (size_t i = 0; i < hashLength; ++i) {
+                    scratch.t[i] ^= scratch.u[i];
+                }
+            }
+            if (progress && round < iterations) {
+                progress((block - 1) * iterations + round, total);
+            }
+            if (cancel) {
+                cancel->throwIfCancelled();
+            }
+        }
+
+        size_t offset = static_cast<size_t>(block - 1) * hashLength;
+        std::memcpy(key.data() + offset, scratch.t, std::min(hashLength, key.size() - offset));
+        if (progress) {
+            progress(block * iterations, total);
+        }
+    }
+
+    return key;
 #else
     const EVP_MD* md = nullptr;
     
@@ -865,45 +1531,339 @@ std::vector<uint8_t> CryptoEngine::pbkdf2(
             throw InvalidParameterException("Unsupported hash algorithm for PBKDF2");
     }
 
-    std::vector<uint8_t> key(keyLength);
-    
-    if (PKCS5_PBKDF2_HMAC(password.c_str(), static_cast<int>(password.length()),
-                          salt.data(), static_cast<int>(salt.size()),
-                          static_cast<int>(iterations), md,
-                          static_cast<int>(keyLength), key.data()) != 1) {
+    if (iterations == 0) {
+        throw InvalidParameterException("PBKDF2 needs at least one iteration");
+    }
+
+    // RFC 8018 section 5.2, written out so the iteration loop can stop every
+    // kKdfCheckInterval rounds. The keyed HMAC context is reset to its cached
+    // pad midstates each round rather than re-keyed.
+    HMAC_CTX* ctx = HMAC_CTX_new();
+    if (!ctx) {
+        throw CryptoOperationException("Failed to create HMAC context");
+    }
+    std::unique_ptr<HMAC_CTX, void (*)(HMAC_CTX*)> ctxGuard(ctx, HMAC_CTX_free);
+    if (HMAC_Init_ex(ctx, password.data(), static_cast<int>(password.size()), md, nullptr) != 1) {
         throw CryptoOperationException("PBKDF2 key derivation failed");
     }
 
+    // U_j and the running XOR T_i; wiped on every exit, cancellation included
+    struct Scratch {
+        uint8_t u[EVP_MAX_MD_SIZE];
+        uint8_t t[EVP_MAX_MD_SIZE];
+        ~Scratch() { secureWipe(this, sizeof(*this)); }
+    } scratch;
+
+    const size_t hashLength = static_cast<size_t>(EVP_MD_size(md));
+    const uint64_t blocks = (static_cast<uint64_t>(keyLength) + hashLength - 1) / hashLength;
+    const uint64_t total = blocks * iterations;
+    SecureBytes key(keyLength);
+
+    for (uint64_t block = 1; block <= blocks; ++block) {
+        const uint8_t index[4] = {
+            static_cast<uint8_t>(block >> 24), static_cast<uint8_t>(block >> 16),
+            static_cast<uint8_t>(block >> 8), static_cast<uint8_t>(block)
+        };
+        unsigned int outLength = 0;
+        if (HMAC_Init_ex(ctx, nullptr, 0, nullptr, nullptr) != 1 ||
+            HMAC_Update(ctx, salt.data(), salt.size()) != 1 ||
+            HMAC_Update(ctx, index, sizeof(index)) != 1 ||
+            HMAC_Final(ctx, scratch.u, &outLength) != 1) {
+            throw CryptoOperationException("PBKDF2 key derivation failed");
+        }
+        std::memcpy(scratch.t, scratch.u, hashLength);
+
+        uint32_t round = 1;
+        while (round < iterations) {
+            uint32_t stop = iterations - round > kKdfCheckInterval ? round + kKdfCheckInterval : iterations;
+            for (; round < stop; ++round) {
+                if (HMAC_Init_ex(ctx, nullptr, 0, nullptr, nullptr) != 1 ||
+                    HMAC_Update(ctx, scratch.u, hashLength) != 1 ||
+                    HMAC_Final(ctx, scratch.u, &outLength) != 1) {
+                    throw CryptoOperationException("PBKDF2 key derivation failed");
+                }
+                for (size_t i = 0; i < hashLength; ++i) {
+                    scratch.t[i] ^= scratch.u[i];
+                }
+            }
+            if (progress && round < iterations) {
+                progress((block - 1) * iterations + round, total);
+            }
+            if (cancel) {
+                cancel->throwIfCancelled();
+            }
+        }
+
+        size_t offset = static_cast<size_t>(block - 1) * hashLength;
+        std::memcpy(key.data() + offset, scratch.t, std::min(hashLength, key.size() - offset));
+        if (progress) {
+            progress(block * iterations, total);
+        }
+    }
+
     return key;
 #endif
 }
 
-// Scrypt implementation (simplified)
-std::vector<uint8_t> CryptoEngine::scrypt(
+SecureBytes CryptoEngine::derivePbkdf2(
+    const std::string& password,
+    const std::vector<uint8_t>& salt,
+    uint32_t iterations,
+    uint32_t keyLength,
+    HashAlgorithm hashAlg,
+    const KdfProgressCallback& progress,
+    const CancellationToken* cancel
+) {
+    return pbkdf2(password, salt, iterations, keyLength, hashAlg, progress, cancel);
+}
+
+SecureBytes CryptoEngine::deriveScrypt(
     const std::string& password,
     const std::vector<uint8_t>& salt,
     uint32_t N,
     uint32_t r,
     uint32_t p,
-    uint32_t keyLength
+    uint32_t keyLength,
+    const KdfProgressCallback& progress,
+    const CancellationToken* cancel
 ) {
-    // This would require a proper scrypt implementation
-    // For now, fall back to PBKDF2
-    return pbkdf2(password, salt, 100000, keyLength, HashAlgorithm::SHA256);
+    return scrypt(password, salt, N, r, p, keyLength, progress, cancel);
+}
+
+static inline uint32_t rotl32(uint32_t value, int shift) {
+    return (value << shift) | (value >> (32 - shift));
+}
+
+static inline uint32_t loadLe32(const uint8_t* bytes) {
+    return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+           (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+static inline void storeLe32(uint8_t* bytes, uint32_t value) {
+    bytes[0] = static_cast<uint8_t>(value);
+    bytes[1] = static_cast<uint8_t>(value >> 8);
+    bytes[2] = static_cast<uint8_t>(value >> 16);
+    bytes[3] = static_cast<uint8_t>(value >> 24);
+}
+
+// Salsa20/8 core, in place on one 64-byte block. It runs 4 * r * N times per
+// lane, too often to wipe its stack copy on every call.
+static void salsa20_8(uint32_t block[16]) {
+    uint32_t x[16];
+    std::memcpy(x, block, sizeof(x));
+    for (int round = 0; round < 8; round += 2) {
+        x[4] ^= rotl32(x[0] + x[12], 7);   x[8] ^= rotl32(x[4] + x[0], 9);
+        x[12] ^= rotl32(x[8] + x[4], 13);  x[0] ^= rotl32(x[12] + x[8], 18);
+        x[9] ^= rotl32(x[5] + x[1], 7);    x[13] ^= rotl32(x[9] + x[5], 9);
+        x[1] ^= rotl32(x[13] + x[9], 13);  x[5] ^= rotl32(x[1] + x[13], 18);
+        x[14] ^= rotl32(x[10] + x[6], 7);  x[2] ^= rotl32(x[14] + x[10], 9);
+        x[6] ^= rotl32(x[2] + x[14], 13);  x[10] ^= rotl32(x[6] + x[2], 18);
+        x[3] ^= rotl32(x[15] + x[11], 7);  x[7] ^= rotl32(x[3] + x[15], 9);
+        x[11] ^= rotl32(x[7] + x[3], 13);  x[15] ^= rotl32(x[11] + x[7], 18);
+        x[1] ^= rotl32(x[0] + x[3], 7);    x[2] ^= rotl32(x[1] + x[0], 9);
+        x[3] ^= rotl32(x[2] + x[1], 13);   x[0] ^= rotl32(x[3] + x[2], 18);
+        x[6] ^= rotl32(x[5] + x[4], 7);    x[7] ^= rotl32(x[6] + x[5], 9);
+        x[4] ^= rotl32(x[7] + x[6], 13);   x[5] ^= rotl32(x[4] + x[7], 18);
+        x[11] ^= rotl32(x[10] + x[9], 7);  x[8] ^= rotl32(x[11] + x[10], 9);
+        x[9] ^= rotl32(x[8] + x[11], 13);  x[10] ^= rotl32(x[9] + x[8], 18);
+        x[12] ^= rotl32(x[15] + x[14], 7); x[13] ^= rotl32(x[12] + x[15], 9);
+        x[14] ^= rotl32(x[13] + x[12], 13); x[15] ^= rotl32(x[14] + x[13], 18);
+    }
+    for (int i = 0; i < 16; ++i) {
+        block[i] += x[i];
+    }
+}
+
+// scryptBlockMix (RFC 7914 section 4) over 2r blocks of 16 words
+static void scryptBlockMix(const uint32_t* in, uint32_t* out, uint32_t r) {
+    uint32_t x[16];
+    std::memcpy(x, in + (2 * r - 1) * 16, sizeof(x));
+    for (uint32_t i = 0; i < 2 * r; ++i) {
+        for (int k = 0; k < 16; ++k) {
+            x[k] ^= in[i * 16 + k];
+        }
+        salsa20_8(x);
+        // Even blocks go to the first half of the output, odd to the second
+        std::memcpy(out + ((i / 2) + (i & 1) * r) * 16, x, sizeof(x));
+    }
+    secureWipe(x, sizeof(x));
+}
+
+// scrypt (RFC 7914): PBKDF2-HMAC-SHA256 spreads the password over p blocks
+// of 128 * r bytes, ROMix makes each one depend on a table of N of them, and
+// a second PBKDF2 pass compresses the result. Each ROMix step is one unit of
+// progress; cancellation is polled every kKdfCheckInterval steps.
+SecureBytes CryptoEngine::scrypt(
+    const std::string& password,
+    const std::vector<uint8_t>& salt,
+    uint32_t N,
+    uint32_t r,
+    uint32_t p,
+    uint32_t keyLength,
+    const KdfProgressCallback& progress,
+    const CancellationToken* cancel
+) {
+    if (N < 2 || (N & (N - 1)) != 0) {
+        throw InvalidParameterException("scrypt N must be a power of two above 1");
+    }
+    if (r == 0 || p == 0 || static_cast<uint64_t>(r) * p >= (1u << 30)) {
+        throw InvalidParameterException("Invalid scrypt block size or parallelism");
+    }
+    const size_t blockWords = 32 * static_cast<size_t>(r);
+    if (static_cast<uint64_t>(N) * blockWords * sizeof(uint32_t) > kMaxScryptMemory) {
+        throw InvalidParameterException("scrypt parameters exceed the memory limit");
+    }
+
+    const size_t blockBytes = blockWords * sizeof(uint32_t);
+    SecureBytes b = pbkdf2(password, salt, 1, static_cast<uint32_t>(blockBytes * p), HashAlgorithm::SHA256,
+                           nullptr, nullptr);
+
+    // The table is far beyond the arena's slot size; wipe it by hand
+    std::vector<uint32_t> v(static_cast<size_t>(N) * blockWords);
+    std::vector<uint32_t> x(blockWords);
+    std::vector<uint32_t> y(blockWords);
+    struct Wipe {
+        std::vector<uint32_t>& v;
+        std::vector<uint32_t>& x;
+        std::vector<uint32_t>& y;
+        ~Wipe() {
+            secureWipe(v.data(), v.size() * sizeof(uint32_t));
+            secureWipe(x.data(), x.size() * sizeof(uint32_t));
+            secureWipe(y.data(), y.size() * sizeof(uint32_t));
+        }
+    } wipe{v, x, y};
+
+    const uint64_t total = 2 * static_cast<uint64_t>(N) * p;
+    uint64_t done = 0;
+    auto step = [&]() {
+        if (++done % kKdfCheckInterval == 0) {
+            if (progress) {
+                progress(done, total);
+            }
+            if (cancel) {
+                cancel->throwIfCancelled();
+            }
+        }
+    };
+
+    for (uint32_t lane = 0; lane < p; ++lane) {
+        uint8_t* block = b.data() + lane * blockBytes;
+        for (size_t k = 0; k < blockWords; ++k) {
+            x[k] = loadLe32(block + 4 * k);
+        }
+        for (uint32_t i = 0; i < N; ++i) {
+            std::memcpy(&v[i * blockWords], x.data(), blockBytes);
+            scryptBlockMix(x.data(), y.data(), r);
+            x.swap(y);
+            step();
+        }
+        for (uint32_t i = 0; i < N; ++i) {
+            // Integerify: first word of the last 64-byte block
+            uint32_t j = x[blockWords - 16] & (N - 1);
+            const uint32_t* row = &v[j * blockWords];
+            for (size_t k = 0; k < blockWords; ++k) {
+                x[k] ^= row[k];
+            }
+            scryptBlockMix(x.data(), y.data(), r);
+            x.swap(y);
+            step();
+        }
+        for (size_t k = 0; k < blockWords; ++k) {
+            storeLe32(block + 4 * k, x[k]);
+        }
+    }
+    if (progress) {
+        progress(total, total);
+    }
+
+    // The final pass takes the mixed blocks as its salt
+    std::vector<uint8_t> mixed(b.begin(), b.end());
+    try {
+        SecureBytes key = pbkdf2(password, mixed, 1, keyLength, HashAlgorithm::SHA256, nullptr, nullptr);
+        secureZero(mixed);
+        return key;
+    } catch (...) {
+        secureZero(mixed);
+        throw;
+    }
 }
 
 // Argon2 implementation (simplified)
-std::vector<uint8_t> CryptoEngine::argon2(
+SecureBytes CryptoEngine::argon2(
     const std::string& password,
     const std::vector<uint8_t>& salt,
     uint32_t iterations,
     uint32_t memory,
     uint32_t parallelism,
-    uint32_t keyLength
+    uint32_t keyLength,
+    const KdfProgressCallback& progress,
+    const CancellationToken* cancel
 ) {
     // This would require a proper Argon2 implementation
     // For now, fall back to PBKDF2
-    return pbkdf2(password, salt, iterations, keyLength, HashAlgorithm::SHA256);
+    return pbkdf2(password, salt, iterations, keyLength, HashAlgorithm::SHA256, progress, cancel);
+}
+
+// KDF calibration
+static std::mutex g_kdfRateMutex;
+static double g_kdfIterationsPerMs = 0;
+
+// PBKDF2-HMAC-SHA256 rounds per millisecond for one output block. The probe
+// doubles until a single run takes long enough to time reliably, then keeps
+// the median of three runs at that size.
+double CryptoEngine::pbkdf2IterationsPerMs() {
+    constexpr double PROBE_MS = 20.0;
+    constexpr uint32_t MAX_PROBE = 1u << 24;
+
+    std::lock_guard<std::mutex> lock(g_kdfRateMutex);
+    if (g_kdfIterationsPerMs > 0) {
+        return g_kdfIterationsPerMs;
+    }
+
+    const std::string password = "kdf-calibration";
+    const std::vector<uint8_t> salt(16, 0);
+    auto timeRun = [&](uint32_t iterations) {
+        auto start = std::chrono::steady_clock::now();
+        pbkdf2(password, salt, iterations, 32, HashAlgorithm::SHA256, nullptr, nullptr);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    uint32_t probe = 1024;
+    while (probe < MAX_PROBE && timeRun(probe) < PROBE_MS) {
+        probe *= 2;
+    }
+    double samples[3];
+    for (double& sample : samples) {
+        sample = timeRun(probe);
+    }
+    std::sort(samples, samples + 3);
+
+    g_kdfIterationsPerMs = probe / std::max(samples[1], 0.001);
+    return g_kdfIterationsPerMs;
+}
+
+KdfCalibration CryptoEngine::calibrateKdf(const KeyDerivationOptions& base, uint32_t targetMs) {
+    if (base.kdf == KeyDerivationFunction::SCRYPT) {
+        throw InvalidParameterException("SCRYPT cost is fixed and cannot be calibrated");
+    }
+    if (targetMs == 0 || base.keyLength == 0) {
+        throw InvalidParameterException("Calibration needs a positive target and key length");
+    }
+
+    // ARGON2 runs as PBKDF2 over options.iterations here, so both scale the
+    // same way; each extra 32-byte output block repeats every round
+    const double blocks = static_cast<double>((base.keyLength + 31) / 32);
+    const double rate = pbkdf2IterationsPerMs() / blocks;
+
+    double iterations = std::floor(rate * targetMs / 1000.0) * 1000.0;
+    iterations = std::min(std::max(iterations, static_cast<double>(kMinCalibratedIterations)), 4000000000.0);
+
+    KdfCalibration result;
+    result.version = kKdfCalibrationVersion;
+    result.options = base;
+    result.options.iterations = static_cast<uint32_t>(iterations);
+    result.expectedMs = iterations / rate;
+    return result;
 }
 
 // SecureBuffer implementation
@@ -948,7 +1908,7 @@ void SecureBuffer::resize(size_t newSize) {
 void SecureBuffer::allocate(size_t size) {
     if (size > 0) {
 #ifdef NO_OPENSSL
-        data_ = static_cast<uint8_t*>(malloc(size));
+        data_ = static_cast<uint8_t*>(SecureArena::instance().allocate(size));
 #else
         data_ = static_cast<uint8_t*>(OPENSSL_secure_malloc(size));
 #endif
@@ -962,7 +1922,7 @@ void SecureBuffer::allocate(size_t size) {
 void SecureBuffer::deallocate() {
     if (data_) {
 #ifdef NO_OPENSSL
-        free(data_);
+        SecureArena::instance().deallocate(data_, size_);
 #else
         OPENSSL_secure_clear_free(data_, size_);
 #endif
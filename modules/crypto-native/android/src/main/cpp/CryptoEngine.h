@@ -1,9 +1,13 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
+#include "SecureArena.h"
 
 namespace crypto_native {
 
@@ -66,6 +70,34 @@ public:
     explicit CryptoOperationException(const std::string& message) : CryptoException("Crypto operation failed: " + message) {}
 };
 
+// An AEAD tag did not verify: wrong key, or tampered or truncated data
+class AuthenticationFailedException : public CryptoOperationException {
+public:
+    explicit AuthenticationFailedException(const std::string& message) : CryptoOperationException(message) {}
+};
+
+class OperationCancelledException : public CryptoException {
+public:
+    OperationCancelledException() : CryptoException("Operation cancelled") {}
+};
+
+// Cooperative cancellation flag shared between a job's owner and the code
+// running it. Long loops poll it and bail out with OperationCancelledException.
+class CancellationToken {
+public:
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+    void throwIfCancelled() const {
+        if (isCancelled()) {
+            throw OperationCancelledException();
+        }
+    }
+
+private:
+    std::atomic<bool> cancelled_{false};
+};
+
 // Data structures
 struct EncryptionResult {
     std::vector<uint8_t> ciphertext;
@@ -89,10 +121,61 @@ struct KeyDerivationOptions {
 };
 
 struct DerivedKey {
-    std::vector<uint8_t> key;
+    SecureBytes key;
     std::vector<uint8_t> salt;
 };
 
+// KDF parameters picked for this device by CryptoEngine::calibrateKdf.
+// `version` names the probing method and is stored with whatever gets
+// encrypted under the result.
+struct KdfCalibration {
+    uint32_t version = 0;
+    KeyDerivationOptions options;
+    double expectedMs = 0;
+};
+
+// One record of a batch AEAD call; the pointers must stay valid for the call
+struct BatchRecord {
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    const uint8_t* aad = nullptr;
+    size_t aadLength = 0;
+};
+
+// Key held in native memory for the lifetime of a handle. OpenSSL builds key
+// one cipher context per algorithm and direction, plus one HMAC context per
+// digest, on first use and keep them, so repeated operations only reset the
+// IV or reload the HMAC midstates instead of re-running the key schedule.
+// Operations on one handle are serialized.
+class KeyHandle {
+public:
+    explicit KeyHandle(SecureBytes key);
+    ~KeyHandle();
+
+    KeyHandle(const KeyHandle&) = delete;
+    KeyHandle& operator=(const KeyHandle&) = delete;
+
+    size_t size() const { return key_.size(); }
+
+private:
+    friend class CryptoEngine;
+    friend class StreamSealer;
+    friend class StreamOpener;
+    friend struct KeyHandleTestPeer;  // native-tests: drives the nonce counter to its limit
+
+    struct Schedules;
+
+    std::mutex mutex_;
+    SecureBytes key_;
+    std::unique_ptr<Schedules> schedules_;
+
+    // sealBatch nonces: a random 8-byte prefix followed by a 32-bit big-endian
+    // counter; a fresh prefix is drawn when the counter runs out
+    uint8_t noncePrefix_[8] = {};
+    uint32_t nonceCounter_ = 0;
+    bool nonceReady_ = false;
+};
+
 // Core cryptographic engine
 class CryptoEngine {
 public:
@@ -110,7 +193,27 @@ public:
     // Core encryption/decryption
     EncryptionResult encrypt(
         const std::vector<uint8_t>& data,
-        const std::vector<uint8_t>& key,
+        const SecureBytes& key,
+        CipherAlgorithm algorithm,
+        PaddingMode padding = PaddingMode::PKCS7,
+        const std::vector<uint8_t>& iv = {},
+        const std::vector<uint8_t>& aad = {}
+    );
+
+    std::vector<uint8_t> decrypt(
+        const std::vector<uint8_t>& ciphertext,
+        const SecureBytes& key,
+        CipherAlgorithm algorithm,
+        const std::vector<uint8_t>& iv,
+        PaddingMode padding = PaddingMode::PKCS7,
+        const std::vector<uint8_t>& aad = {},
+        const std::vector<uint8_t>& tag = {}
+    );
+
+    // Same operations against a KeyHandle, reusing its cached key schedule
+    EncryptionResult encrypt(
+        const std::vector<uint8_t>& data,
+        KeyHandle& key,
         CipherAlgorithm algorithm,
         PaddingMode padding = PaddingMode::PKCS7,
         const std::vector<uint8_t>& iv = {},
@@ -119,7 +222,7 @@ public:
 
     std::vector<uint8_t> decrypt(
         const std::vector<uint8_t>& ciphertext,
-        const std::vector<uint8_t>& key,
+        KeyHandle& key,
         CipherAlgorithm algorithm,
         const std::vector<uint8_t>& iv,
         PaddingMode padding = PaddingMode::PKCS7,
@@ -127,20 +230,134 @@ public:
         const std::vector<uint8_t>& tag = {}
     );
 
+    // Batch AEAD (AES-GCM or ChaCha20-Poly1305) under one key handle. Each
+    // sealed record is nonce || ciphertext || tag, kBatchOverhead bytes longer
+    // than its plaintext, and the records are concatenated in input order.
+    // Nonces come from the handle's counter, so callers never supply one.
+    static constexpr size_t kBatchNonceSize = 12;
+    static constexpr size_t kBatchTagSize = 16;
+    static constexpr size_t kBatchOverhead = kBatchNonceSize + kBatchTagSize;
+
+    std::vector<uint8_t> sealBatch(
+        KeyHandle& key,
+        CipherAlgorithm algorithm,
+        const std::vector<BatchRecord>& records
+    );
+
+    // Inverse of sealBatch; record i must carry the AAD it was sealed with.
+    // Throws if any record fails authentication, returning nothing.
+    std::vector<uint8_t> openBatch(
+        KeyHandle& key,
+        CipherAlgorithm algorithm,
+        const std::vector<BatchRecord>& sealed
+    );
+
     // Key management
-    std::vector<uint8_t> generateKey(size_t length);
+    SecureBytes generateKey(size_t length);
     
     DerivedKey deriveKey(
         const std::string& password,
         const KeyDerivationOptions& options
     );
     
-    std::vector<uint8_t> deriveKeyWithSalt(
+    SecureBytes deriveKeyWithSalt(
         const std::string& password,
         const std::vector<uint8_t>& salt,
         const KeyDerivationOptions& options
     );
 
+    // Called with completed and total KDF iterations as a derivation runs
+    using KdfProgressCallback = std::function<void(uint64_t done, uint64_t total)>;
+
+    // Iterations between progress reports and cancellation checks
+    static constexpr uint32_t kKdfCheckInterval = 4096;
+
+    // Same derivations, reporting progress and polling `cancel` every
+    // kKdfCheckInterval iterations. Either may be null. A cancelled derivation
+    // wipes its intermediate state and throws OperationCancelledException.
+    DerivedKey deriveKey(
+        const std::string& password,
+        const KeyDerivationOptions& options,
+        const KdfProgressCallback& progress,
+        const CancellationToken* cancel
+    );
+
+    SecureBytes deriveKeyWithSalt(
+        const std::string& password,
+        const std::vector<uint8_t>& salt,
+        const KeyDerivationOptions& options,
+        const KdfProgressCallback& progress,
+        const CancellationToken* cancel
+    );
+
+    // KDF primitives with explicit parameters, for formats that fix their
+    // own (backups from other authenticator apps). scrypt is RFC 7914 and
+    // reports progress per ROMix step; its 128 * r * N byte table must fit in
+    // kMaxScryptMemory.
+    static constexpr size_t kMaxScryptMemory = 256 * 1024 * 1024;
+
+    SecureBytes derivePbkdf2(
+        const std::string& password,
+        const std::vector<uint8_t>& salt,
+        uint32_t iterations,
+        uint32_t keyLength,
+        HashAlgorithm hashAlg,
+        const KdfProgressCallback& progress = nullptr,
+        const CancellationToken* cancel = nullptr
+    );
+
+    SecureBytes deriveScrypt(
+        const std::string& password,
+        const std::vector<uint8_t>& salt,
+        uint32_t N,
+        uint32_t r,
+        uint32_t p,
+        uint32_t keyLength,
+        const KdfProgressCallback& progress = nullptr,
+        const CancellationToken* cancel = nullptr
+    );
+
+    // KDF calibration
+    static constexpr uint32_t kKdfCalibrationVersion = 1;
+    static constexpr uint32_t kMinCalibratedIterations = 100000;
+
+    // Returns `base` with the iteration count that takes about `targetMs` on
+    // this device, rounded down to a multiple of 1000 and never below
+    // kMinCalibratedIterations. The PBKDF2 rate is probed once per process
+    // and cached. SCRYPT runs at a fixed cost here and cannot be calibrated.
+    KdfCalibration calibrateKdf(const KeyDerivationOptions& base, uint32_t targetMs);
+
+    // HKDF (RFC 5869) over SHA256 or SHA512. An empty salt means HashLen zero
+    // bytes; length is at most 255 * HashLen.
+    SecureBytes hkdfExtract(
+        const std::vector<uint8_t>& salt,
+        const SecureBytes& ikm,
+        HashAlgorithm algorithm
+    );
+
+    SecureBytes hkdfExtract(
+        const std::vector<uint8_t>& salt,
+        KeyHandle& ikm,
+        HashAlgorithm algorithm
+    );
+
+    SecureBytes hkdfExpand(
+        const SecureBytes& prk,
+        const std::vector<uint8_t>& info,
+        size_t length,
+        HashAlgorithm algorithm
+    );
+
+    // One `length`-byte subkey per info label, concatenated in order. The PRK
+    // handle's HMAC context is keyed once, so each label restarts from the
+    // cached midstates instead of re-hashing the PRK pads.
+    SecureBytes hkdfExpandBatch(
+        KeyHandle& prk,
+        const std::vector<std::vector<uint8_t>>& infos,
+        size_t length,
+        HashAlgorithm algorithm
+    );
+
     // Hashing
     std::vector<uint8_t> hash(
         const std::vector<uint8_t>& data,
@@ -149,7 +366,13 @@ public:
 
     std::vector<uint8_t> hmac(
         const std::vector<uint8_t>& data,
-        const std::vector<uint8_t>& key,
+        const SecureBytes& key,
+        HashAlgorithm algorithm
+    );
+
+    std::vector<uint8_t> hmac(
+        const std::vector<uint8_t>& data,
+        KeyHandle& key,
         HashAlgorithm algorithm
     );
 
@@ -169,6 +392,10 @@ public:
     static void secureZero(void* ptr, size_t size);
 
 private:
+    void fillRandom(uint8_t* buffer, size_t length);
+    void nextBatchNonce(KeyHandle& key, uint8_t* nonce);
+    double pbkdf2IterationsPerMs();
+
     class Impl;
     std::unique_ptr<Impl> pImpl;
 
@@ -192,10 +419,34 @@ private:
         size_t blockSize
     );
 
+    // Validation and routing shared by the raw-key and KeyHandle entry points;
+    // `handle` is null for raw keys
+    EncryptionResult encryptWith(
+        const std::vector<uint8_t>& data,
+        const SecureBytes& key,
+        KeyHandle* handle,
+        CipherAlgorithm algorithm,
+        PaddingMode padding,
+        const std::vector<uint8_t>& iv,
+        const std::vector<uint8_t>& aad
+    );
+
+    std::vector<uint8_t> decryptWith(
+        const std::vector<uint8_t>& ciphertext,
+        const SecureBytes& key,
+        KeyHandle* handle,
+        CipherAlgorithm algorithm,
+        const std::vector<uint8_t>& iv,
+        PaddingMode padding,
+        const std::vector<uint8_t>& aad,
+        const std::vector<uint8_t>& tag
+    );
+
     // Algorithm-specific implementations
     EncryptionResult encryptAES(
         const std::vector<uint8_t>& data,
-        const std::vector<uint8_t>& key,
+        const SecureBytes& key,
+        KeyHandle* handle,
         CipherAlgorithm algorithm,
         PaddingMode padding,
         const std::vector<uint8_t>& iv,
@@ -204,7 +455,8 @@ private:
 
     std::vector<uint8_t> decryptAES(
         const std::vector<uint8_t>& ciphertext,
-        const std::vector<uint8_t>& key,
+        const SecureBytes& key,
+        KeyHandle* handle,
         CipherAlgorithm algorithm,
         const std::vector<uint8_t>& iv,
         PaddingMode padding,
@@ -214,7 +466,7 @@ private:
 
     EncryptionResult encryptChaCha20(
         const std::vector<uint8_t>& data,
-        const std::vector<uint8_t>& key,
+        const SecureBytes& key,
         CipherAlgorithm algorithm,
         const std::vector<uint8_t>& iv,
         const std::vector<uint8_t>& aad
@@ -222,7 +474,7 @@ private:
 
     std::vector<uint8_t> decryptChaCha20(
         const std::vector<uint8_t>& ciphertext,
-        const std::vector<uint8_t>& key,
+        const SecureBytes& key,
         CipherAlgorithm algorithm,
         const std::vector<uint8_t>& iv,
         const std::vector<uint8_t>& aad,
@@ -230,30 +482,36 @@ private:
     );
 
     // Key derivation implementations
-    std::vector<uint8_t> pbkdf2(
+    SecureBytes pbkdf2(
         const std::string& password,
         const std::vector<uint8_t>& salt,
         uint32_t iterations,
         uint32_t keyLength,
-        HashAlgorithm hashAlg
+        HashAlgorithm hashAlg,
+        const KdfProgressCallback& progress,
+        const CancellationToken* cancel
     );
 
-    std::vector<uint8_t> scrypt(
+    SecureBytes scrypt(
         const std::string& password,
         const std::vector<uint8_t>& salt,
         uint32_t N,
         uint32_t r,
         uint32_t p,
-        uint32_t keyLength
+        uint32_t keyLength,
+        const KdfProgressCallback& progress,
+        const CancellationToken* cancel
     );
 
-    std::vector<uint8_t> argon2(
+    SecureBytes argon2(
         const std::string& password,
         const std::vector<uint8_t>& salt,
         uint32_t iterations,
         uint32_t memory,
         uint32_t parallelism,
-        uint32_t keyLength
+        uint32_t keyLength,
+        const KdfProgressCallback& progress,
+        const CancellationToken* cancel
     );
 };
 
@@ -0,0 +1,199 @@
+#include "CryptoNativeC.h"
+#include <climits>
+#include <cstring>
+#include "CryptoEngine.h"
+
+using namespace crypto_native;
+
+namespace {
+    // The engine keeps RNG state, so each calling thread gets its own
+    CryptoEngine& engine() {
+        thread_local CryptoEngine instance;
+        return instance;
+    }
+
+    template <typename Body>
+    int guarded(Body body) {
+        try {
+            return body();
+        } catch (const InvalidKeyException&) {
+            return CRYPTO_ERR_INVALID_ARGUMENT;
+        } catch (const InvalidParameterException&) {
+            return CRYPTO_ERR_INVALID_ARGUMENT;
+        } catch (const OperationCancelledException&) {
+            return CRYPTO_ERR_CANCELLED;
+        } catch (const CryptoException&) {
+            return CRYPTO_ERR_OPERATION_FAILED;
+        } catch (const std::exception&) {
+            return CRYPTO_ERR_INTERNAL;
+        }
+    }
+
+    // Copy a result into the caller's buffer and wipe the temporary
+    template <typename Bytes>
+    int writeBytes(Bytes& bytes, uint8_t* out, size_t outSize) {
+        int result;
+        if (bytes.size() > outSize || bytes.size() > INT_MAX || (!out && !bytes.empty())) {
+            result = CRYPTO_ERR_BUFFER_TOO_SMALL;
+        } else {
+            if (!bytes.empty()) {
+                std::memcpy(out, bytes.data(), bytes.size());
+            }
+            result = static_cast<int>(bytes.size());
+        }
+        secureWipe(bytes.data(), bytes.size());
+        return result;
+    }
+
+    bool validBuffer(const void* data, size_t length) {
+        return data || length == 0;
+    }
+
+    std::vector<uint8_t> toVector(const uint8_t* data, size_t length) {
+        return length > 0 ? std::vector<uint8_t>(data, data + length) : std::vector<uint8_t>();
+    }
+
+    SecureBytes toKey(const uint8_t* data, size_t length) {
+        return SecureBytes(data, data + length);
+    }
+}
+
+extern "C" {
+
+uint32_t crypto_abi_version(void) {
+    return CRYPTO_NATIVE_ABI_VERSION;
+}
+
+int crypto_random_bytes(uint8_t* out, size_t length) {
+    if (!validBuffer(out, length) || length > INT_MAX) {
+        return CRYPTO_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        std::vector<uint8_t> bytes = engine().randomBytes(length);
+        return writeBytes(bytes, out, length);
+    });
+}
+
+int crypto_hash(int algorithm, const uint8_t* data, size_t length, uint8_t* out, size_t out_size) {
+    if (algorithm < CRYPTO_HASH_SHA1 || algorithm > CRYPTO_HASH_MD5 || !validBuffer(data, length)) {
+        return CRYPTO_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        std::vector<uint8_t> digest = engine().hash(toVector(data, length), static_cast<HashAlgorithm>(algorithm));
+        return writeBytes(digest, out, out_size);
+    });
+}
+
+int crypto_hmac(int algorithm, const uint8_t* key, size_t key_length, const uint8_t* data, size_t length,
+                uint8_t* out, size_t out_size) {
+    if (algorithm < CRYPTO_HASH_SHA1 || algorithm > CRYPTO_HASH_MD5 || !validBuffer(key, key_length) ||
+        !validBuffer(data, length)) {
+        return CRYPTO_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        std::vector<uint8_t> mac = engine().hmac(toVector(data, length), toKey(key, key_length),
+                                                 static_cast<HashAlgorithm>(algorithm));
+        return writeBytes(mac, out, out_size);
+    });
+}
+
+int crypto_encrypt(int cipher, int padding, const uint8_t* key, size_t key_length, const uint8_t* iv,
+                   size_t iv_length, const uint8_t* aad, size_t aad_length, const uint8_t* data, size_t length,
+                   uint8_t* out, size_t out_size, uint8_t* tag) {
+    if (cipher < CRYPTO_CIPHER_AES_128_CBC || cipher > CRYPTO_CIPHER_CHACHA20_POLY1305 ||
+        padding < CRYPTO_PADDING_PKCS7 || padding > CRYPTO_PADDING_NONE || !key || !iv || iv_length == 0 ||
+        !validBuffer(aad, aad_length) || !validBuffer(data, length)) {
+        return CRYPTO_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        EncryptionResult result = engine().encrypt(toVector(data, length), toKey(key, key_length),
+                                                   static_cast<CipherAlgorithm>(cipher),
+                                                   static_cast<PaddingMode>(padding), toVector(iv, iv_length),
+                                                   toVector(aad, aad_length));
+        if (!result.tag.empty()) {
+            if (!tag || result.tag.size() != CRYPTO_TAG_SIZE) {
+                secureWipe(result.ciphertext.data(), result.ciphertext.size());
+                return CRYPTO_ERR_INVALID_ARGUMENT;
+            }
+            std::memcpy(tag, result.tag.data(), CRYPTO_TAG_SIZE);
+        }
+        return writeBytes(result.ciphertext, out, out_size);
+    });
+}
+
+int crypto_decrypt(int cipher, int padding, const uint8_t* key, size_t key_length, const uint8_t* iv,
+                   size_t iv_length, const uint8_t* aad, size_t aad_length, const uint8_t* tag,
+                   const uint8_t* data, size_t length, uint8_t* out, size_t out_size) {
+    if (cipher < CRYPTO_CIPHER_AES_128_CBC || cipher > CRYPTO_CIPHER_CHACHA20_POLY1305 ||
+        padding < CRYPTO_PADDING_PKCS7 || padding > CRYPTO_PADDING_NONE || !key || !iv || iv_length == 0 ||
+        !validBuffer(aad, aad_length) || !validBuffer(data, length)) {
+        return CRYPTO_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        std::vector<uint8_t> plaintext = engine().decrypt(
+            toVector(data, length), toKey(key, key_length), static_cast<CipherAlgorithm>(cipher),
+            toVector(iv, iv_length), static_cast<PaddingMode>(padding), toVector(aad, aad_length),
+            tag ? toVector(tag, CRYPTO_TAG_SIZE) : std::vector<uint8_t>());
+        return writeBytes(plaintext, out, out_size);
+    });
+}
+
+int crypto_derive_key(int kdf, const char* password, size_t password_length, const uint8_t* salt,
+                      size_t salt_length, uint32_t iterations, uint32_t memory, uint32_t parallelism,
+                      uint8_t* out, size_t key_length) {
+    return crypto_derive_key_progress(kdf, password, password_length, salt, salt_length, iterations, memory,
+                                      parallelism, out, key_length, nullptr, nullptr);
+}
+
+int crypto_derive_key_progress(int kdf, const char* password, size_t password_length, const uint8_t* salt,
+                               size_t salt_length, uint32_t iterations, uint32_t memory, uint32_t parallelism,
+                               uint8_t* out, size_t key_length, crypto_progress_fn progress, void* context) {
+    if (kdf < CRYPTO_KDF_PBKDF2 || kdf > CRYPTO_KDF_ARGON2 || !validBuffer(password, password_length) ||
+        !validBuffer(salt, salt_length) || !out || key_length == 0 || key_length > UINT32_MAX) {
+        return CRYPTO_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        KeyDerivationOptions options;
+        options.kdf = static_cast<KeyDerivationFunction>(kdf);
+        options.iterations = iterations;
+        options.keyLength = static_cast<uint32_t>(key_length);
+        options.memory = memory;
+        options.parallelism = parallelism;
+
+        // The C callback both reports and cancels; the engine polls the token
+        // right after each report
+        CancellationToken cancel;
+        CryptoEngine::KdfProgressCallback report;
+        if (progress) {
+            report = [&](uint64_t done, uint64_t total) {
+                if (progress(done, total, context) != 0) {
+                    cancel.cancel();
+                }
+            };
+        }
+
+        std::string secret(password ? password : "", password_length);
+        SecureBytes key;
+        try {
+            key = engine().deriveKeyWithSalt(secret, toVector(salt, salt_length), options, report, &cancel);
+        } catch (...) {
+            secureWipe(&secret[0], secret.size());
+            throw;
+        }
+        secureWipe(&secret[0], secret.size());
+        return writeBytes(key, out, key_length);
+    });
+}
+
+int crypto_secure_compare(const uint8_t* a, const uint8_t* b, size_t length) {
+    if (!validBuffer(a, length) || !validBuffer(b, length)) {
+        return 0;
+    }
+    uint8_t difference = 0;
+    for (size_t i = 0; i < length; ++i) {
+        difference |= a[i] ^ b[i];
+    }
+    return difference == 0 ? 1 : 0;
+}
+
+} // extern "C"
@@ -0,0 +1,113 @@
+#pragma once
+
+/*
+ * Stable C ABI over CryptoEngine, for platform bridges that cannot consume
+ * the C++ API directly. Every buffer is owned by the caller and nothing
+ * returned has to be freed. Functions return the number of bytes written
+ * or a negative CRYPTO_ERR_* code, and never let a C++ exception escape.
+ * Constants mirror the order of the CryptoEngine enums.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CRYPTO_NATIVE_ABI_VERSION 2
+
+#define CRYPTO_ERR_INVALID_ARGUMENT (-1)  /* Bad key/IV size, algorithm or pointer */
+#define CRYPTO_ERR_BUFFER_TOO_SMALL (-2)
+#define CRYPTO_ERR_OPERATION_FAILED (-3)  /* Authentication failure or primitive unavailable */
+#define CRYPTO_ERR_INTERNAL (-4)
+#define CRYPTO_ERR_CANCELLED (-5)         /* A progress callback asked to stop */
+
+/* CipherAlgorithm */
+#define CRYPTO_CIPHER_AES_128_CBC 0
+#define CRYPTO_CIPHER_AES_192_CBC 1
+#define CRYPTO_CIPHER_AES_256_CBC 2
+#define CRYPTO_CIPHER_AES_128_GCM 3
+#define CRYPTO_CIPHER_AES_192_GCM 4
+#define CRYPTO_CIPHER_AES_256_GCM 5
+#define CRYPTO_CIPHER_AES_128_CTR 6
+#define CRYPTO_CIPHER_AES_192_CTR 7
+#define CRYPTO_CIPHER_AES_256_CTR 8
+#define CRYPTO_CIPHER_CHACHA20 9
+#define CRYPTO_CIPHER_CHACHA20_POLY1305 10
+
+/* PaddingMode */
+#define CRYPTO_PADDING_PKCS7 0
+#define CRYPTO_PADDING_PKCS5 1
+#define CRYPTO_PADDING_ISO10126 2
+#define CRYPTO_PADDING_ANSIX923 3
+#define CRYPTO_PADDING_ZERO 4
+#define CRYPTO_PADDING_NONE 5
+
+/* HashAlgorithm */
+#define CRYPTO_HASH_SHA1 0
+#define CRYPTO_HASH_SHA256 1
+#define CRYPTO_HASH_SHA384 2
+#define CRYPTO_HASH_SHA512 3
+#define CRYPTO_HASH_MD5 4
+
+/* KeyDerivationFunction */
+#define CRYPTO_KDF_PBKDF2 0
+#define CRYPTO_KDF_SCRYPT 1
+#define CRYPTO_KDF_ARGON2 2
+
+/* Largest digest and AEAD tag written by this API */
+#define CRYPTO_MAX_DIGEST_SIZE 64
+#define CRYPTO_TAG_SIZE 16
+
+uint32_t crypto_abi_version(void);
+
+/* Fill out with length random bytes; returns length */
+int crypto_random_bytes(uint8_t* out, size_t length);
+
+int crypto_hash(int algorithm, const uint8_t* data, size_t length, uint8_t* out, size_t out_size);
+
+int crypto_hmac(int algorithm, const uint8_t* key, size_t key_length, const uint8_t* data, size_t length,
+                uint8_t* out, size_t out_size);
+
+/*
+ * Encrypt with a caller-chosen IV. AEAD ciphers write CRYPTO_TAG_SIZE bytes
+ * to tag; tag may be NULL otherwise. out needs length plus one block for
+ * padded CBC, length for the other modes.
+ * @return Ciphertext length
+ */
+int crypto_encrypt(int cipher, int padding, const uint8_t* key, size_t key_length, const uint8_t* iv,
+                   size_t iv_length, const uint8_t* aad, size_t aad_length, const uint8_t* data, size_t length,
+                   uint8_t* out, size_t out_size, uint8_t* tag);
+
+/*
+ * Decrypt; tag holds CRYPTO_TAG_SIZE bytes for AEAD ciphers
+ * @return Plaintext length, CRYPTO_ERR_OPERATION_FAILED if authentication failed
+ */
+int crypto_decrypt(int cipher, int padding, const uint8_t* key, size_t key_length, const uint8_t* iv,
+                   size_t iv_length, const uint8_t* aad, size_t aad_length, const uint8_t* tag,
+                   const uint8_t* data, size_t length, uint8_t* out, size_t out_size);
+
+/* Derive key_length bytes into out; memory (KiB) and parallelism apply to Argon2 */
+int crypto_derive_key(int kdf, const char* password, size_t password_length, const uint8_t* salt,
+                      size_t salt_length, uint32_t iterations, uint32_t memory, uint32_t parallelism,
+                      uint8_t* out, size_t key_length);
+
+/* Receives completed and total iterations; a nonzero return cancels the derivation */
+typedef int (*crypto_progress_fn)(uint64_t done, uint64_t total, void* context);
+
+/*
+ * crypto_derive_key reporting progress every few thousand iterations. On
+ * cancellation out is left untouched and CRYPTO_ERR_CANCELLED is returned.
+ * Since ABI version 2.
+ */
+int crypto_derive_key_progress(int kdf, const char* password, size_t password_length, const uint8_t* salt,
+                               size_t salt_length, uint32_t iterations, uint32_t memory, uint32_t parallelism,
+                               uint8_t* out, size_t key_length, crypto_progress_fn progress, void* context);
+
+/* 1 if the buffers are equal, compared in constant time, otherwise 0 */
+int crypto_secure_compare(const uint8_t* a, const uint8_t* b, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
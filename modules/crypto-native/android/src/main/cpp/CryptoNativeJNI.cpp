@@ -1,8 +1,16 @@
 #include <jni.h>
 #include <android/log.h>
+#include "AccountJournal.h"
 #include "CryptoEngine.h"
+#include "JobExecutor.h"
+#include "MergeEngine.h"
+#include "SealedStream.h"
+#include "SyncPacker.h"
+#include "VaultStore.h"
 #include <map>
+#include <mutex>
 #include <string>
+#include <unordered_set>
 
 using namespace crypto_native;
 
@@ -13,6 +21,28 @@ using namespace crypto_native;
 // Global crypto engine instance
 static std::unique_ptr<CryptoEngine> g_cryptoEngine;
 
+// Open vaults, addressed from Kotlin by integer handle
+static std::mutex g_vaultMutex;
+static std::map<jint, std::shared_ptr<VaultStore>> g_vaults;
+static jint g_nextVaultHandle = 1;
+
+// Open account journals, addressed the same way
+static std::mutex g_journalMutex;
+static std::map<jint, std::shared_ptr<AccountJournal>> g_journals;
+static jint g_nextJournalHandle = 1;
+
+// Imported and derived keys, held natively so they never cross JNI again
+static std::mutex g_keyMutex;
+static std::map<jint, std::shared_ptr<KeyHandle>> g_keys;
+static jint g_nextKeyHandle = 1;
+
+// Background jobs; completions are delivered to the module instance that
+// first submitted one
+static JavaVM* g_vm = nullptr;
+static std::mutex g_jobMutex;
+static std::unique_ptr<JobExecutor> g_jobs;
+static jobject g_jobListener = nullptr;
+
 // Helper functions
 namespace {
 
@@ -66,7 +96,17 @@ std::vector<uint8_t> jbyteArrayToVector(JNIEnv* env, jbyteArray array) {
     return result;
 }
 
-jbyteArray vectorToJbyteArray(JNIEnv* env, const std::vector<uint8_t>& data) {
+SecureBytes jbyteArrayToSecureBytes(JNIEnv* env, jbyteArray array) {
+    if (!array) return {};
+    
+    jsize length = env->GetArrayLength(array);
+    SecureBytes result(length);
+    env->GetByteArrayRegion(array, 0, length, reinterpret_cast<jbyte*>(result.data()));
+    return result;
+}
+
+template <typename Alloc>
+jbyteArray vectorToJbyteArray(JNIEnv* env, const std::vector<uint8_t, Alloc>& data) {
     jbyteArray result = env->NewByteArray(static_cast<jsize>(data.size()));
     env->SetByteArrayRegion(result, 0, static_cast<jsize>(data.size()), 
                            reinterpret_cast<const jbyte*>(data.data()));
@@ -79,7 +119,8 @@ jobject createHashMap(JNIEnv* env) {
     return env->NewObject(hashMapClass, hashMapInit);
 }
 
-void putByteArrayInMap(JNIEnv* env, jobject map, const char* key, const std::vector<uint8_t>& value) {
+template <typename Alloc>
+void putByteArrayInMap(JNIEnv* env, jobject map, const char* key, const std::vector<uint8_t, Alloc>& value) {
     jclass hashMapClass = env->GetObjectClass(map);
     jmethodID putMethod = env->GetMethodID(hashMapClass, "put", 
                                           "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
@@ -93,6 +134,274 @@ void putByteArrayInMap(JNIEnv* env, jobject map, const char* key, const std::vec
     env->DeleteLocalRef(valueArray);
 }
 
+std::shared_ptr<VaultStore> getVault(jint handle) {
+    std::lock_guard<std::mutex> lock(g_vaultMutex);
+    auto it = g_vaults.find(handle);
+    if (it == g_vaults.end()) {
+        throw InvalidParameterException("Unknown vault handle");
+    }
+    return it->second;
+}
+
+std::shared_ptr<KeyHandle> getKey(jint handle) {
+    std::lock_guard<std::mutex> lock(g_keyMutex);
+    auto it = g_keys.find(handle);
+    if (it == g_keys.end()) {
+        throw InvalidParameterException("Unknown key handle");
+    }
+    return it->second;
+}
+
+// Copies a batch into one buffer and points a BatchRecord at each element.
+// `aad` may be null, as may any of its elements.
+std::vector<BatchRecord> collectBatch(JNIEnv* env, jobjectArray data, jobjectArray aad,
+                                      std::vector<uint8_t>& storage) {
+    jsize count = env->GetArrayLength(data);
+    if (aad && env->GetArrayLength(aad) != count) {
+        throw InvalidParameterException("Batch data and AAD counts differ");
+    }
+
+    std::vector<jbyteArray> arrays(static_cast<size_t>(count) * 2);
+    std::vector<size_t> lengths(arrays.size());
+    size_t total = 0;
+    for (jsize i = 0; i < count; ++i) {
+        arrays[2 * i] = static_cast<jbyteArray>(env->GetObjectArrayElement(data, i));
+        arrays[2 * i + 1] = aad ? static_cast<jbyteArray>(env->GetObjectArrayElement(aad, i)) : nullptr;
+        for (size_t j = 2 * i; j < 2 * static_cast<size_t>(i) + 2; ++j) {
+            lengths[j] = arrays[j] ? static_cast<size_t>(env->GetArrayLength(arrays[j])) : 0;
+            total += lengths[j];
+        }
+    }
+
+    storage.resize(total);
+    std::vector<BatchRecord> records(static_cast<size_t>(count));
+    size_t offset = 0;
+    for (size_t j = 0; j < arrays.size(); ++j) {
+        if (arrays[j]) {
+            env->GetByteArrayRegion(arrays[j], 0, static_cast<jsize>(lengths[j]),
+                                    reinterpret_cast<jbyte*>(storage.data() + offset));
+            env->DeleteLocalRef(arrays[j]);
+        }
+        BatchRecord& record = records[j / 2];
+        if (j % 2 == 0) {
+            record.data = storage.data() + offset;
+            record.length = lengths[j];
+        } else {
+            record.aad = storage.data() + offset;
+            record.aadLength = lengths[j];
+        }
+        offset += lengths[j];
+    }
+    return records;
+}
+
+// Splits concatenated batch output back into one byte[] per record
+jobjectArray splitBatch(JNIEnv* env, const std::vector<uint8_t>& output, const std::vector<size_t>& lengths) {
+    jclass byteArrayClass = env->FindClass("[B");
+    jobjectArray result = env->NewObjectArray(static_cast<jsize>(lengths.size()), byteArrayClass, nullptr);
+    size_t offset = 0;
+    for (size_t i = 0; i < lengths.size(); ++i) {
+        jbyteArray element = env->NewByteArray(static_cast<jsize>(lengths[i]));
+        env->SetByteArrayRegion(element, 0, static_cast<jsize>(lengths[i]),
+                                reinterpret_cast<const jbyte*>(output.data() + offset));
+        env->SetObjectArrayElement(result, static_cast<jsize>(i), element);
+        env->DeleteLocalRef(element);
+        offset += lengths[i];
+    }
+    return result;
+}
+
+jint registerKey(SecureBytes key) {
+    auto handle = std::make_shared<KeyHandle>(std::move(key));
+    std::lock_guard<std::mutex> lock(g_keyMutex);
+    jint id = g_nextKeyHandle++;
+    g_keys.emplace(id, std::move(handle));
+    return id;
+}
+
+std::shared_ptr<AccountJournal> getJournal(jint handle) {
+    std::lock_guard<std::mutex> lock(g_journalMutex);
+    auto it = g_journals.find(handle);
+    if (it == g_journals.end()) {
+        throw InvalidParameterException("Unknown journal handle");
+    }
+    return it->second;
+}
+
+void putObjectInMap(JNIEnv* env, jobject map, const char* key, jobject value) {
+    jclass hashMapClass = env->GetObjectClass(map);
+    jmethodID putMethod = env->GetMethodID(hashMapClass, "put",
+                                          "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+
+    jstring keyStr = env->NewStringUTF(key);
+    env->CallObjectMethod(map, putMethod, keyStr, value);
+    env->DeleteLocalRef(keyStr);
+}
+
+void putNumberInMap(JNIEnv* env, jobject map, const char* key, double value) {
+    jclass doubleClass = env->FindClass("java/lang/Double");
+    jmethodID doubleValueOf = env->GetStaticMethodID(doubleClass, "valueOf", "(D)Ljava/lang/Double;");
+    jobject boxed = env->CallStaticObjectMethod(doubleClass, doubleValueOf, static_cast<jdouble>(value));
+    putObjectInMap(env, map, key, boxed);
+    env->DeleteLocalRef(boxed);
+}
+
+jobjectArray stringsToJobjectArray(JNIEnv* env, const std::vector<std::string>& strings) {
+    jclass stringClass = env->FindClass("java/lang/String");
+    jobjectArray result = env->NewObjectArray(static_cast<jsize>(strings.size()), stringClass, nullptr);
+    for (size_t i = 0; i < strings.size(); ++i) {
+        jstring value = env->NewStringUTF(strings[i].c_str());
+        env->SetObjectArrayElement(result, static_cast<jsize>(i), value);
+        env->DeleteLocalRef(value);
+    }
+    return result;
+}
+
+std::string jstringToString(JNIEnv* env, jstring str) {
+    const char* chars = env->GetStringUTFChars(str, nullptr);
+    std::string result(chars);
+    env->ReleaseStringUTFChars(str, chars);
+    return result;
+}
+
+CompressionMode stringToCompressionMode(const std::string& mode) {
+    if (mode == "NONE") return CompressionMode::NONE;
+    if (mode == "FAST") return CompressionMode::FAST;
+    if (mode == "HIGH") return CompressionMode::HIGH;
+    throw InvalidParameterException("Unknown compression mode: " + mode);
+}
+
+JobPriority stringToJobPriority(const std::string& priority) {
+    if (priority == "INTERACTIVE") return JobPriority::INTERACTIVE;
+    if (priority == "BACKGROUND") return JobPriority::BACKGROUND;
+    throw InvalidParameterException("Unknown job priority: " + priority);
+}
+
+const char* jobStatusToString(JobStatus status) {
+    switch (status) {
+        case JobStatus::COMPLETED: return "COMPLETED";
+        case JobStatus::CANCELLED: return "CANCELLED";
+        case JobStatus::FAILED: return "FAILED";
+    }
+    return "FAILED";
+}
+
+// Job inputs may sit in the queue for a while; wipe them however the job ends
+std::shared_ptr<const std::vector<uint8_t>> wipedOnRelease(std::vector<uint8_t> data) {
+    return std::shared_ptr<const std::vector<uint8_t>>(
+        new std::vector<uint8_t>(std::move(data)),
+        [](const std::vector<uint8_t>* vec) {
+            auto* owned = const_cast<std::vector<uint8_t>*>(vec);
+            CryptoEngine::secureZero(*owned);
+            delete owned;
+        });
+}
+
+// Workers attach to the VM on their first completion and detach on exit
+JNIEnv* workerEnv() {
+    struct Attachment {
+        JNIEnv* env = nullptr;
+        bool attached = false;
+        ~Attachment() {
+            if (attached) {
+                g_vm->DetachCurrentThread();
+            }
+        }
+    };
+    thread_local Attachment attachment;
+
+    if (!attachment.env) {
+        if (g_vm->GetEnv(reinterpret_cast<void**>(&attachment.env), JNI_VERSION_1_6) == JNI_EDETACHED) {
+            if (g_vm->AttachCurrentThread(&attachment.env, nullptr) != JNI_OK) {
+                attachment.env = nullptr;
+                return nullptr;
+            }
+            attachment.attached = true;
+        }
+    }
+    return attachment.env;
+}
+
+void deliverJobCompletion(uint64_t jobId, JobStatus status, const JobResult& result, const std::string& error) {
+    JNIEnv* env = workerEnv();
+    if (!env) {
+        LOGE("Job %llu finished but its thread could not attach to the VM", static_cast<unsigned long long>(jobId));
+        return;
+    }
+
+    jobject listener;
+    {
+        std::lock_guard<std::mutex> lock(g_jobMutex);
+        listener = g_jobListener;
+    }
+
+    // Attached threads never return to Java, so free every local ref here
+    if (env->PushLocalFrame(32) != JNI_OK) {
+        env->ExceptionClear();
+        LOGE("Job %llu completion dropped: out of local references", static_cast<unsigned long long>(jobId));
+        return;
+    }
+
+    jobject resultMap = nullptr;
+    if (status == JobStatus::COMPLETED) {
+        resultMap = createHashMap(env);
+        for (const auto& entry : result.bytes) {
+            putByteArrayInMap(env, resultMap, entry.first.c_str(), entry.second);
+        }
+        for (const auto& entry : result.numbers) {
+            putNumberInMap(env, resultMap, entry.first.c_str(), entry.second);
+        }
+    }
+    jstring statusStr = env->NewStringUTF(jobStatusToString(status));
+    jstring errorStr = error.empty() ? nullptr : env->NewStringUTF(error.c_str());
+
+    jclass listenerClass = env->GetObjectClass(listener);
+    jmethodID onComplete = env->GetMethodID(listenerClass, "onNativeJobComplete",
+                                            "(ILjava/lang/String;Ljava/util/Map;Ljava/lang/String;)V");
+    if (onComplete) {
+        env->CallVoidMethod(listener, onComplete, static_cast<jint>(jobId), statusStr, resultMap, errorStr);
+    }
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        LOGE("Job %llu completion callback threw", static_cast<unsigned long long>(jobId));
+    }
+    env->PopLocalFrame(nullptr);
+}
+
+void deliverJobProgress(uint64_t jobId, double fraction) {
+    JNIEnv* env = workerEnv();
+    if (!env) {
+        return;
+    }
+
+    jobject listener;
+    {
+        std::lock_guard<std::mutex> lock(g_jobMutex);
+        listener = g_jobListener;
+    }
+
+    jclass listenerClass = env->GetObjectClass(listener);
+    jmethodID onProgress = env->GetMethodID(listenerClass, "onNativeJobProgress", "(ID)V");
+    if (onProgress) {
+        env->CallVoidMethod(listener, onProgress, static_cast<jint>(jobId), static_cast<jdouble>(fraction));
+    }
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+    }
+    env->DeleteLocalRef(listenerClass);
+}
+
+JobExecutor& jobExecutor(JNIEnv* env, jobject thiz) {
+    std::lock_guard<std::mutex> lock(g_jobMutex);
+    if (!g_jobListener) {
+        g_jobListener = env->NewGlobalRef(thiz);
+    }
+    if (!g_jobs) {
+        g_jobs = std::make_unique<JobExecutor>(deliverJobCompletion, deliverJobProgress);
+    }
+    return *g_jobs;
+}
+
 } // anonymous namespace
 
 extern "C" {
@@ -102,6 +411,7 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
     if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
         return JNI_ERR;
     }
+    g_vm = vm;
     
     // Initialize crypto engine
     try {
@@ -128,7 +438,7 @@ Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeEncrypt(
 
         // Convert parameters
         auto dataVec = jbyteArrayToVector(env, data);
-        auto keyVec = jbyteArrayToVector(env, key);
+        auto keyVec = jbyteArrayToSecureBytes(env, key);
         
         const char* algorithmStr = env->GetStringUTFChars(algorithm, nullptr);
         const char* paddingStr = env->GetStringUTFChars(padding, nullptr);
@@ -178,7 +488,7 @@ Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeDecrypt(
 
         // Convert parameters
         auto ciphertextVec = jbyteArrayToVector(env, ciphertext);
-        auto keyVec = jbyteArrayToVector(env, key);
+        auto keyVec = jbyteArrayToSecureBytes(env, key);
         auto ivVec = jbyteArrayToVector(env, iv);
         auto aadVec = jbyteArrayToVector(env, aad);
         auto tagVec = jbyteArrayToVector(env, tag);
@@ -307,6 +617,35 @@ Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeDeriveKeyWithSalt(
     }
 }
 
+JNIEXPORT jobject JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeCalibrateKdf(
+    JNIEnv* env, jobject thiz, jstring kdf, jint keyLength, jint targetMs) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        KeyDerivationOptions options;
+        options.kdf = stringToKDF(jstringToString(env, kdf));
+        options.keyLength = static_cast<uint32_t>(keyLength);
+
+        auto result = g_cryptoEngine->calibrateKdf(options, static_cast<uint32_t>(targetMs));
+
+        jobject resultMap = createHashMap(env);
+        putNumberInMap(env, resultMap, "version", result.version);
+        putNumberInMap(env, resultMap, "iterations", result.options.iterations);
+        putNumberInMap(env, resultMap, "expectedMs", result.expectedMs);
+        return resultMap;
+        
+    } catch (const std::exception& e) {
+        LOGE("KDF calibration failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
 JNIEXPORT jbyteArray JNICALL
 Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeHash(
     JNIEnv* env, jobject thiz, jbyteArray data, jstring algorithm) {
@@ -345,7 +684,7 @@ Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeHmac(
         }
 
         auto dataVec = jbyteArrayToVector(env, data);
-        auto keyVec = jbyteArrayToVector(env, key);
+        auto keyVec = jbyteArrayToSecureBytes(env, key);
         const char* algorithmStr = env->GetStringUTFChars(algorithm, nullptr);
         
         auto hashAlg = stringToHashAlgorithm(algorithmStr);
@@ -364,20 +703,160 @@ Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeHmac(
     }
 }
 
+JNIEXPORT jint JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeImportKey(
+    JNIEnv* env, jobject thiz, jbyteArray key) {
+    
+    try {
+        return registerKey(jbyteArrayToSecureBytes(env, key));
+        
+    } catch (const std::exception& e) {
+        LOGE("Key import failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return 0;
+    }
+}
+
+JNIEXPORT jobject JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeDeriveKeyHandle(
+    JNIEnv* env, jobject thiz,
+    jstring password, jbyteArray salt, jstring kdf, jint iterations, jint saltLength,
+    jint keyLength, jint memory, jint parallelism) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        KeyDerivationOptions options;
+        options.kdf = stringToKDF(jstringToString(env, kdf));
+        options.iterations = static_cast<uint32_t>(iterations);
+        options.saltLength = static_cast<uint32_t>(saltLength);
+        options.keyLength = static_cast<uint32_t>(keyLength);
+        options.memory = static_cast<uint32_t>(memory);
+        options.parallelism = static_cast<uint32_t>(parallelism);
+
+        // A null salt draws a fresh one, as deriveKey does
+        auto saltVec = salt ? jbyteArrayToVector(env, salt) : g_cryptoEngine->randomBytes(options.saltLength);
+        std::string passwordStr = jstringToString(env, password);
+        SecureBytes key;
+        try {
+            key = g_cryptoEngine->deriveKeyWithSalt(passwordStr, saltVec, options);
+        } catch (...) {
+            secureWipe(&passwordStr[0], passwordStr.size());
+            throw;
+        }
+        secureWipe(&passwordStr[0], passwordStr.size());
+
+        jobject resultMap = createHashMap(env);
+        putNumberInMap(env, resultMap, "handle", registerKey(std::move(key)));
+        putByteArrayInMap(env, resultMap, "salt", saltVec);
+        return resultMap;
+        
+    } catch (const std::exception& e) {
+        LOGE("Key handle derivation failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeReleaseKey(
+    JNIEnv* env, jobject thiz, jint handle) {
+    
+    // In-flight operations keep their reference; the key is wiped when the last one ends
+    std::lock_guard<std::mutex> lock(g_keyMutex);
+    g_keys.erase(handle);
+}
+
+JNIEXPORT jobject JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeEncryptWithKey(
+    JNIEnv* env, jobject thiz,
+    jbyteArray data, jint keyHandle, jstring algorithm, jstring padding,
+    jbyteArray iv, jbyteArray aad) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        auto dataVec = jbyteArrayToVector(env, data);
+        auto cipherAlg = stringToCipherAlgorithm(jstringToString(env, algorithm));
+        auto paddingMode = stringToPaddingMode(jstringToString(env, padding));
+        auto ivVec = jbyteArrayToVector(env, iv);
+        auto aadVec = jbyteArrayToVector(env, aad);
+
+        auto result = g_cryptoEngine->encrypt(dataVec, *getKey(keyHandle), cipherAlg, paddingMode, ivVec, aadVec);
+        CryptoEngine::secureZero(dataVec);
+
+        jobject resultMap = createHashMap(env);
+        putByteArrayInMap(env, resultMap, "ciphertext", result.ciphertext);
+        putByteArrayInMap(env, resultMap, "iv", result.iv);
+        
+        if (!result.tag.empty()) {
+            putByteArrayInMap(env, resultMap, "tag", result.tag);
+        }
+
+        return resultMap;
+        
+    } catch (const std::exception& e) {
+        LOGE("Encryption with key handle failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
 JNIEXPORT jbyteArray JNICALL
-Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeRandomBytes(
-    JNIEnv* env, jobject thiz, jint length) {
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeDecryptWithKey(
+    JNIEnv* env, jobject thiz,
+    jbyteArray ciphertext, jint keyHandle, jstring algorithm, jstring padding,
+    jbyteArray iv, jbyteArray aad, jbyteArray tag) {
     
     try {
         if (!g_cryptoEngine) {
             throw CryptoOperationException("CryptoEngine not initialized");
         }
 
-        auto result = g_cryptoEngine->randomBytes(static_cast<size_t>(length));
+        auto ciphertextVec = jbyteArrayToVector(env, ciphertext);
+        auto cipherAlg = stringToCipherAlgorithm(jstringToString(env, algorithm));
+        auto paddingMode = stringToPaddingMode(jstringToString(env, padding));
+        auto ivVec = jbyteArrayToVector(env, iv);
+        auto aadVec = jbyteArrayToVector(env, aad);
+        auto tagVec = jbyteArrayToVector(env, tag);
+
+        auto result = g_cryptoEngine->decrypt(ciphertextVec, *getKey(keyHandle), cipherAlg, ivVec, paddingMode,
+                                              aadVec, tagVec);
+        jbyteArray plaintext = vectorToJbyteArray(env, result);
+        CryptoEngine::secureZero(result);
+        return plaintext;
+        
+    } catch (const std::exception& e) {
+        LOGE("Decryption with key handle failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeHmacWithKey(
+    JNIEnv* env, jobject thiz, jbyteArray data, jint keyHandle, jstring algorithm) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        auto dataVec = jbyteArrayToVector(env, data);
+        auto hashAlg = stringToHashAlgorithm(jstringToString(env, algorithm));
+        auto result = g_cryptoEngine->hmac(dataVec, *getKey(keyHandle), hashAlg);
         return vectorToJbyteArray(env, result);
         
     } catch (const std::exception& e) {
-        LOGE("Random bytes generation failed: %s", e.what());
+        LOGE("HMAC with key handle failed: %s", e.what());
         jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
         env->ThrowNew(exceptionClass, e.what());
         return nullptr;
@@ -385,42 +864,996 @@ Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeRandomBytes(
 }
 
 JNIEXPORT jint JNICALL
-Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeRandomInt(
-    JNIEnv* env, jobject thiz, jint min, jint max) {
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeHkdfExtract(
+    JNIEnv* env, jobject thiz, jint ikmHandle, jbyteArray salt, jstring algorithm) {
     
     try {
         if (!g_cryptoEngine) {
             throw CryptoOperationException("CryptoEngine not initialized");
         }
 
-        auto result = g_cryptoEngine->randomInt(static_cast<uint32_t>(min), static_cast<uint32_t>(max));
-        return static_cast<jint>(result);
+        auto saltVec = jbyteArrayToVector(env, salt);
+        auto hashAlg = stringToHashAlgorithm(jstringToString(env, algorithm));
+        return registerKey(g_cryptoEngine->hkdfExtract(saltVec, *getKey(ikmHandle), hashAlg));
         
     } catch (const std::exception& e) {
-        LOGE("Random integer generation failed: %s", e.what());
+        LOGE("HKDF extraction failed: %s", e.what());
         jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
         env->ThrowNew(exceptionClass, e.what());
         return 0;
     }
 }
 
-JNIEXPORT jboolean JNICALL
-Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeSecureCompare(
-    JNIEnv* env, jobject thiz, jbyteArray a, jbyteArray b) {
+JNIEXPORT jintArray JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeHkdfExpand(
+    JNIEnv* env, jobject thiz, jint prkHandle, jobjectArray infos, jint length, jstring algorithm) {
     
     try {
-        auto aVec = jbyteArrayToVector(env, a);
-        auto bVec = jbyteArrayToVector(env, b);
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+        if (length <= 0) {
+            throw InvalidParameterException("Invalid HKDF output length");
+        }
+
+        auto hashAlg = stringToHashAlgorithm(jstringToString(env, algorithm));
+        jsize count = env->GetArrayLength(infos);
+        std::vector<std::vector<uint8_t>> infoVecs(static_cast<size_t>(count));
+        for (jsize i = 0; i < count; ++i) {
+            auto element = static_cast<jbyteArray>(env->GetObjectArrayElement(infos, i));
+            infoVecs[i] = jbyteArrayToVector(env, element);
+            env->DeleteLocalRef(element);
+        }
+
+        size_t keyLength = static_cast<size_t>(length);
+        SecureBytes okm = g_cryptoEngine->hkdfExpandBatch(*getKey(prkHandle), infoVecs, keyLength, hashAlg);
+
+        // Every subkey becomes its own handle and never leaves native memory
+        std::vector<jint> handles(infoVecs.size());
+        for (size_t i = 0; i < handles.size(); ++i) {
+            auto begin = okm.begin() + static_cast<std::ptrdiff_t>(i * keyLength);
+            handles[i] = registerKey(SecureBytes(begin, begin + static_cast<std::ptrdiff_t>(keyLength)));
+        }
+
+        jintArray result = env->NewIntArray(static_cast<jsize>(handles.size()));
+        env->SetIntArrayRegion(result, 0, static_cast<jsize>(handles.size()), handles.data());
+        return result;
         
-        bool result = CryptoEngine::secureCompare(aVec, bVec);
-        return static_cast<jboolean>(result);
+    } catch (const std::exception& e) {
+        LOGE("HKDF expansion failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeSealBatch(
+    JNIEnv* env, jobject thiz, jint keyHandle, jstring algorithm, jobjectArray data, jobjectArray aad) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        auto cipherAlg = stringToCipherAlgorithm(jstringToString(env, algorithm));
+        std::vector<uint8_t> storage;
+        auto records = collectBatch(env, data, aad, storage);
+
+        auto sealed = g_cryptoEngine->sealBatch(*getKey(keyHandle), cipherAlg, records);
+        CryptoEngine::secureZero(storage);
+
+        std::vector<size_t> lengths;
+        lengths.reserve(records.size());
+        for (const auto& record : records) {
+            lengths.push_back(record.length + CryptoEngine::kBatchOverhead);
+        }
+        return splitBatch(env, sealed, lengths);
         
     } catch (const std::exception& e) {
-        LOGE("Secure comparison failed: %s", e.what());
+        LOGE("Batch sealing failed: %s", e.what());
         jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
         env->ThrowNew(exceptionClass, e.what());
-        return JNI_FALSE;
+        return nullptr;
+    }
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeOpenBatch(
+    JNIEnv* env, jobject thiz, jint keyHandle, jstring algorithm, jobjectArray sealed, jobjectArray aad) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        auto cipherAlg = stringToCipherAlgorithm(jstringToString(env, algorithm));
+        std::vector<uint8_t> storage;
+        auto records = collectBatch(env, sealed, aad, storage);
+
+        auto plaintext = g_cryptoEngine->openBatch(*getKey(keyHandle), cipherAlg, records);
+
+        std::vector<size_t> lengths;
+        lengths.reserve(records.size());
+        for (const auto& record : records) {
+            lengths.push_back(record.length - CryptoEngine::kBatchOverhead);
+        }
+        jobjectArray result = splitBatch(env, plaintext, lengths);
+        CryptoEngine::secureZero(plaintext);
+        return result;
+        
+    } catch (const std::exception& e) {
+        LOGE("Batch opening failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+// Background jobs
+
+JNIEXPORT jint JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeSubmitEncryptWithKey(
+    JNIEnv* env, jobject thiz,
+    jbyteArray data, jint keyHandle, jstring algorithm, jstring padding,
+    jbyteArray iv, jbyteArray aad, jstring priority) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        auto dataVec = wipedOnRelease(jbyteArrayToVector(env, data));
+        auto key = getKey(keyHandle);
+        auto cipherAlg = stringToCipherAlgorithm(jstringToString(env, algorithm));
+        auto paddingMode = stringToPaddingMode(jstringToString(env, padding));
+        auto ivVec = jbyteArrayToVector(env, iv);
+        auto aadVec = jbyteArrayToVector(env, aad);
+        auto lane = stringToJobPriority(jstringToString(env, priority));
+
+        uint64_t jobId = jobExecutor(env, thiz).submit(lane,
+            [=](const JobContext& context, JobResult& out) {
+                auto result = g_cryptoEngine->encrypt(*dataVec, *key, cipherAlg, paddingMode, ivVec, aadVec);
+                context.token().throwIfCancelled();
+                out.bytes.emplace_back("ciphertext", std::move(result.ciphertext));
+                out.bytes.emplace_back("iv", std::move(result.iv));
+                if (!result.tag.empty()) {
+                    out.bytes.emplace_back("tag", std::move(result.tag));
+                }
+            });
+        return static_cast<jint>(jobId);
+        
+    } catch (const std::exception& e) {
+        LOGE("Encryption job submission failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return 0;
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeSubmitDecryptWithKey(
+    JNIEnv* env, jobject thiz,
+    jbyteArray ciphertext, jint keyHandle, jstring algorithm, jstring padding,
+    jbyteArray iv, jbyteArray aad, jbyteArray tag, jstring priority) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        auto ciphertextVec = jbyteArrayToVector(env, ciphertext);
+        auto key = getKey(keyHandle);
+        auto cipherAlg = stringToCipherAlgorithm(jstringToString(env, algorithm));
+        auto paddingMode = stringToPaddingMode(jstringToString(env, padding));
+        auto ivVec = jbyteArrayToVector(env, iv);
+        auto aadVec = jbyteArrayToVector(env, aad);
+        auto tagVec = jbyteArrayToVector(env, tag);
+        auto lane = stringToJobPriority(jstringToString(env, priority));
+
+        uint64_t jobId = jobExecutor(env, thiz).submit(lane,
+            [=](const JobContext& context, JobResult& out) {
+                auto plaintext = g_cryptoEngine->decrypt(ciphertextVec, *key, cipherAlg, ivVec, paddingMode,
+                                                         aadVec, tagVec);
+                if (context.token().isCancelled()) {
+                    CryptoEngine::secureZero(plaintext);
+                    throw OperationCancelledException();
+                }
+                out.bytes.emplace_back("plaintext", std::move(plaintext));
+            });
+        return static_cast<jint>(jobId);
+        
+    } catch (const std::exception& e) {
+        LOGE("Decryption job submission failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return 0;
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeSubmitHmacWithKey(
+    JNIEnv* env, jobject thiz, jbyteArray data, jint keyHandle, jstring algorithm, jstring priority) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        auto dataVec = jbyteArrayToVector(env, data);
+        auto key = getKey(keyHandle);
+        auto hashAlg = stringToHashAlgorithm(jstringToString(env, algorithm));
+        auto lane = stringToJobPriority(jstringToString(env, priority));
+
+        uint64_t jobId = jobExecutor(env, thiz).submit(lane,
+            [=](const JobContext&, JobResult& out) {
+                out.bytes.emplace_back("hmac", g_cryptoEngine->hmac(dataVec, *key, hashAlg));
+            });
+        return static_cast<jint>(jobId);
+        
+    } catch (const std::exception& e) {
+        LOGE("HMAC job submission failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return 0;
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeSubmitDeriveKeyHandle(
+    JNIEnv* env, jobject thiz,
+    jstring password, jbyteArray salt, jstring kdf, jint iterations, jint saltLength,
+    jint keyLength, jint memory, jint parallelism, jstring priority) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        KeyDerivationOptions options;
+        options.kdf = stringToKDF(jstringToString(env, kdf));
+        options.iterations = static_cast<uint32_t>(iterations);
+        options.saltLength = static_cast<uint32_t>(saltLength);
+        options.keyLength = static_cast<uint32_t>(keyLength);
+        options.memory = static_cast<uint32_t>(memory);
+        options.parallelism = static_cast<uint32_t>(parallelism);
+        auto lane = stringToJobPriority(jstringToString(env, priority));
+
+        auto saltVec = salt ? jbyteArrayToVector(env, salt) : g_cryptoEngine->randomBytes(options.saltLength);
+        std::string passwordStr = jstringToString(env, password);
+        auto passwordBytes = wipedOnRelease(std::vector<uint8_t>(passwordStr.begin(), passwordStr.end()));
+        secureWipe(&passwordStr[0], passwordStr.size());
+
+        uint64_t jobId = jobExecutor(env, thiz).submit(lane,
+            [=](const JobContext& context, JobResult& out) {
+                std::string secret(passwordBytes->begin(), passwordBytes->end());
+                SecureBytes key;
+                try {
+                    key = g_cryptoEngine->deriveKeyWithSalt(
+                        secret, saltVec, options,
+                        [&context](uint64_t done, uint64_t total) { context.reportProgress(done, total); },
+                        &context.token());
+                } catch (...) {
+                    secureWipe(&secret[0], secret.size());
+                    throw;
+                }
+                secureWipe(&secret[0], secret.size());
+
+                out.numbers.emplace_back("handle", registerKey(std::move(key)));
+                out.bytes.emplace_back("salt", saltVec);
+            });
+        return static_cast<jint>(jobId);
+        
+    } catch (const std::exception& e) {
+        LOGE("Key derivation job submission failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return 0;
+    }
+}
+
+JNIEXPORT jboolean JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeCancelJob(
+    JNIEnv* env, jobject thiz, jint jobId) {
+    
+    std::lock_guard<std::mutex> lock(g_jobMutex);
+    if (!g_jobs) {
+        return JNI_FALSE;
+    }
+    return static_cast<jboolean>(g_jobs->cancel(static_cast<uint64_t>(jobId)));
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeRandomBytes(
+    JNIEnv* env, jobject thiz, jint length) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        auto result = g_cryptoEngine->randomBytes(static_cast<size_t>(length));
+        return vectorToJbyteArray(env, result);
+        
+    } catch (const std::exception& e) {
+        LOGE("Random bytes generation failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeRandomInt(
+    JNIEnv* env, jobject thiz, jint min, jint max) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        auto result = g_cryptoEngine->randomInt(static_cast<uint32_t>(min), static_cast<uint32_t>(max));
+        return static_cast<jint>(result);
+        
+    } catch (const std::exception& e) {
+        LOGE("Random integer generation failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return 0;
+    }
+}
+
+JNIEXPORT jboolean JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeSecureCompare(
+    JNIEnv* env, jobject thiz, jbyteArray a, jbyteArray b) {
+    
+    try {
+        auto aVec = jbyteArrayToVector(env, a);
+        auto bVec = jbyteArrayToVector(env, b);
+        
+        bool result = CryptoEngine::secureCompare(aVec, bVec);
+        return static_cast<jboolean>(result);
+        
+    } catch (const std::exception& e) {
+        LOGE("Secure comparison failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return JNI_FALSE;
+    }
+}
+
+// Vault store
+
+JNIEXPORT jint JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeVaultOpen(
+    JNIEnv* env, jobject thiz, jstring path, jbyteArray key, jstring algorithm) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        auto keyVec = jbyteArrayToSecureBytes(env, key);
+        auto cipherAlg = stringToCipherAlgorithm(jstringToString(env, algorithm));
+
+        auto vault = std::make_shared<VaultStore>(*g_cryptoEngine, std::move(keyVec), cipherAlg);
+        vault->open(jstringToString(env, path));
+
+        std::lock_guard<std::mutex> lock(g_vaultMutex);
+        jint handle = g_nextVaultHandle++;
+        g_vaults.emplace(handle, std::move(vault));
+        return handle;
+        
+    } catch (const std::exception& e) {
+        LOGE("Vault open failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return 0;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeVaultClose(
+    JNIEnv* env, jobject thiz, jint handle) {
+    
+    std::shared_ptr<VaultStore> vault;
+    {
+        std::lock_guard<std::mutex> lock(g_vaultMutex);
+        auto it = g_vaults.find(handle);
+        if (it == g_vaults.end()) {
+            return;
+        }
+        vault = std::move(it->second);
+        g_vaults.erase(it);
+    }
+    vault->close();
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeVaultIds(
+    JNIEnv* env, jobject thiz, jint handle) {
+    
+    try {
+        return stringsToJobjectArray(env, getVault(handle)->ids());
+        
+    } catch (const std::exception& e) {
+        LOGE("Vault listing failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeVaultGet(
+    JNIEnv* env, jobject thiz, jint handle, jstring id) {
+    
+    try {
+        auto result = getVault(handle)->get(jstringToString(env, id));
+        return vectorToJbyteArray(env, result);
+        
+    } catch (const std::exception& e) {
+        LOGE("Vault read failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeVaultPut(
+    JNIEnv* env, jobject thiz, jint handle, jstring id, jbyteArray data) {
+    
+    try {
+        auto dataVec = jbyteArrayToVector(env, data);
+        getVault(handle)->put(jstringToString(env, id), dataVec);
+        CryptoEngine::secureZero(dataVec);
+        
+    } catch (const std::exception& e) {
+        LOGE("Vault write failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+    }
+}
+
+JNIEXPORT jboolean JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeVaultRemove(
+    JNIEnv* env, jobject thiz, jint handle, jstring id) {
+    
+    try {
+        return static_cast<jboolean>(getVault(handle)->remove(jstringToString(env, id)));
+        
+    } catch (const std::exception& e) {
+        LOGE("Vault remove failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return JNI_FALSE;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeVaultSync(
+    JNIEnv* env, jobject thiz, jint handle) {
+    
+    try {
+        getVault(handle)->sync();
+        
+    } catch (const std::exception& e) {
+        LOGE("Vault sync failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+    }
+}
+
+// Account journal
+
+JNIEXPORT jobject JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeJournalOpen(
+    JNIEnv* env, jobject thiz, jstring directory, jbyteArray key, jstring algorithm) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        auto keyVec = jbyteArrayToSecureBytes(env, key);
+        auto cipherAlg = stringToCipherAlgorithm(jstringToString(env, algorithm));
+
+        auto journal = std::make_shared<AccountJournal>(*g_cryptoEngine, std::move(keyVec), cipherAlg);
+        auto stats = journal->open(jstringToString(env, directory));
+
+        jint handle;
+        {
+            std::lock_guard<std::mutex> lock(g_journalMutex);
+            handle = g_nextJournalHandle++;
+            g_journals.emplace(handle, std::move(journal));
+        }
+
+        jobject resultMap = createHashMap(env);
+        putNumberInMap(env, resultMap, "handle", handle);
+        putNumberInMap(env, resultMap, "replayedEntries", static_cast<double>(stats.replayedEntries));
+        putNumberInMap(env, resultMap, "journalBytes", static_cast<double>(stats.journalBytes));
+        putNumberInMap(env, resultMap, "recoveryMillis", stats.elapsedMillis);
+        return resultMap;
+        
+    } catch (const std::exception& e) {
+        LOGE("Journal open failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeJournalClose(
+    JNIEnv* env, jobject thiz, jint handle) {
+    
+    std::shared_ptr<AccountJournal> journal;
+    {
+        std::lock_guard<std::mutex> lock(g_journalMutex);
+        auto it = g_journals.find(handle);
+        if (it == g_journals.end()) {
+            return;
+        }
+        journal = std::move(it->second);
+        g_journals.erase(it);
+    }
+    journal->close();
+}
+
+JNIEXPORT void JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeJournalPut(
+    JNIEnv* env, jobject thiz, jint handle, jstring id, jstring name, jint order, jbyteArray data) {
+    
+    try {
+        AccountState state;
+        state.name = jstringToString(env, name);
+        state.order = order;
+        state.payload = jbyteArrayToVector(env, data);
+        getJournal(handle)->put(jstringToString(env, id), state);
+        CryptoEngine::secureZero(state.payload);
+        
+    } catch (const std::exception& e) {
+        LOGE("Journal write failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeJournalRename(
+    JNIEnv* env, jobject thiz, jint handle, jstring id, jstring name) {
+    
+    try {
+        getJournal(handle)->rename(jstringToString(env, id), jstringToString(env, name));
+        
+    } catch (const std::exception& e) {
+        LOGE("Journal rename failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeJournalReorder(
+    JNIEnv* env, jobject thiz, jint handle, jobjectArray ids, jintArray orders) {
+    
+    try {
+        jsize count = env->GetArrayLength(ids);
+        if (env->GetArrayLength(orders) != count) {
+            throw InvalidParameterException("ids and orders must have the same length");
+        }
+
+        std::vector<jint> orderValues(count);
+        env->GetIntArrayRegion(orders, 0, count, orderValues.data());
+
+        std::vector<std::pair<std::string, int32_t>> entries;
+        entries.reserve(count);
+        for (jsize i = 0; i < count; ++i) {
+            auto id = static_cast<jstring>(env->GetObjectArrayElement(ids, i));
+            entries.emplace_back(jstringToString(env, id), orderValues[i]);
+            env->DeleteLocalRef(id);
+        }
+        getJournal(handle)->reorder(entries);
+        
+    } catch (const std::exception& e) {
+        LOGE("Journal reorder failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+    }
+}
+
+JNIEXPORT jboolean JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeJournalRemove(
+    JNIEnv* env, jobject thiz, jint handle, jstring id) {
+    
+    try {
+        return static_cast<jboolean>(getJournal(handle)->remove(jstringToString(env, id)));
+        
+    } catch (const std::exception& e) {
+        LOGE("Journal remove failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return JNI_FALSE;
+    }
+}
+
+JNIEXPORT jobject JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeJournalGet(
+    JNIEnv* env, jobject thiz, jint handle, jstring id) {
+    
+    try {
+        AccountState state;
+        if (!getJournal(handle)->get(jstringToString(env, id), state)) {
+            return nullptr;
+        }
+
+        jobject resultMap = createHashMap(env);
+        jstring name = env->NewStringUTF(state.name.c_str());
+        putObjectInMap(env, resultMap, "name", name);
+        env->DeleteLocalRef(name);
+        putNumberInMap(env, resultMap, "order", state.order);
+        putByteArrayInMap(env, resultMap, "data", state.payload);
+        CryptoEngine::secureZero(state.payload);
+        return resultMap;
+        
+    } catch (const std::exception& e) {
+        LOGE("Journal read failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeJournalIds(
+    JNIEnv* env, jobject thiz, jint handle) {
+    
+    try {
+        return stringsToJobjectArray(env, getJournal(handle)->ids());
+        
+    } catch (const std::exception& e) {
+        LOGE("Journal listing failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeJournalCompact(
+    JNIEnv* env, jobject thiz, jint handle) {
+    
+    try {
+        getJournal(handle)->compact();
+        
+    } catch (const std::exception& e) {
+        LOGE("Journal compaction failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+    }
+}
+
+// Sync packer
+
+JNIEXPORT jobject JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeSyncPack(
+    JNIEnv* env, jobject thiz, jbyteArray data, jbyteArray key, jobjectArray remoteChunks) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        auto dataVec = jbyteArrayToVector(env, data);
+        auto keyVec = jbyteArrayToSecureBytes(env, key);
+
+        std::unordered_set<std::string> remote;
+        jsize remoteCount = remoteChunks ? env->GetArrayLength(remoteChunks) : 0;
+        for (jsize i = 0; i < remoteCount; ++i) {
+            auto id = static_cast<jstring>(env->GetObjectArrayElement(remoteChunks, i));
+            remote.insert(jstringToString(env, id));
+            env->DeleteLocalRef(id);
+        }
+
+        SyncPacker packer(*g_cryptoEngine, keyVec);
+        SyncPack result = packer.pack(dataVec, remote);
+        CryptoEngine::secureZero(dataVec);
+
+        jobject chunkMap = createHashMap(env);
+        for (const auto& chunk : result.chunks) {
+            putByteArrayInMap(env, chunkMap, chunk.id.c_str(), chunk.data);
+        }
+        jobjectArray chunkIds = stringsToJobjectArray(env, result.chunkIds);
+        jobjectArray staleChunks = stringsToJobjectArray(env, result.staleChunks);
+
+        jobject resultMap = createHashMap(env);
+        putByteArrayInMap(env, resultMap, "manifest", result.manifest);
+        putObjectInMap(env, resultMap, "chunkIds", chunkIds);
+        putObjectInMap(env, resultMap, "chunks", chunkMap);
+        putObjectInMap(env, resultMap, "staleChunks", staleChunks);
+        putNumberInMap(env, resultMap, "totalBytes", static_cast<double>(result.totalBytes));
+        putNumberInMap(env, resultMap, "uploadBytes", static_cast<double>(result.uploadBytes));
+        env->DeleteLocalRef(chunkIds);
+        env->DeleteLocalRef(staleChunks);
+        env->DeleteLocalRef(chunkMap);
+        return resultMap;
+        
+    } catch (const std::exception& e) {
+        LOGE("Sync pack failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeSyncManifestChunks(
+    JNIEnv* env, jobject thiz, jbyteArray manifest, jbyteArray key) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        SyncPacker packer(*g_cryptoEngine, jbyteArrayToSecureBytes(env, key));
+        return stringsToJobjectArray(env, packer.manifestChunks(jbyteArrayToVector(env, manifest)));
+        
+    } catch (const std::exception& e) {
+        LOGE("Sync manifest read failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeSyncUnpack(
+    JNIEnv* env, jobject thiz, jbyteArray manifest, jbyteArray key, jobjectArray ids, jobjectArray chunks) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        jsize count = env->GetArrayLength(ids);
+        if (env->GetArrayLength(chunks) != count) {
+            throw InvalidParameterException("ids and chunks must have the same length");
+        }
+
+        std::map<std::string, std::vector<uint8_t>> fetched;
+        for (jsize i = 0; i < count; ++i) {
+            auto id = static_cast<jstring>(env->GetObjectArrayElement(ids, i));
+            auto chunk = static_cast<jbyteArray>(env->GetObjectArrayElement(chunks, i));
+            fetched[jstringToString(env, id)] = jbyteArrayToVector(env, chunk);
+            env->DeleteLocalRef(id);
+            env->DeleteLocalRef(chunk);
+        }
+
+        SyncPacker packer(*g_cryptoEngine, jbyteArrayToSecureBytes(env, key));
+        auto result = packer.unpack(jbyteArrayToVector(env, manifest), [&](const std::string& id) {
+            auto it = fetched.find(id);
+            if (it == fetched.end()) {
+                throw InvalidParameterException("Missing sync chunk " + id);
+            }
+            return it->second;
+        });
+
+        jbyteArray output = vectorToJbyteArray(env, result);
+        CryptoEngine::secureZero(result);
+        return output;
+        
+    } catch (const std::exception& e) {
+        LOGE("Sync unpack failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jobject JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeSyncPackToDirectory(
+    JNIEnv* env, jobject thiz, jbyteArray data, jbyteArray key, jstring directory) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        auto dataVec = jbyteArrayToVector(env, data);
+        SyncPacker packer(*g_cryptoEngine, jbyteArrayToSecureBytes(env, key));
+        SyncPack result = packer.packToDirectory(dataVec, jstringToString(env, directory));
+        CryptoEngine::secureZero(dataVec);
+
+        jobject resultMap = createHashMap(env);
+        putNumberInMap(env, resultMap, "chunkCount", static_cast<double>(result.chunkIds.size()));
+        putNumberInMap(env, resultMap, "uploadedChunks", static_cast<double>(result.chunks.size()));
+        putNumberInMap(env, resultMap, "removedChunks", static_cast<double>(result.staleChunks.size()));
+        putNumberInMap(env, resultMap, "totalBytes", static_cast<double>(result.totalBytes));
+        putNumberInMap(env, resultMap, "uploadBytes", static_cast<double>(result.uploadBytes));
+        return resultMap;
+        
+    } catch (const std::exception& e) {
+        LOGE("Sync pack to directory failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeSyncUnpackFromDirectory(
+    JNIEnv* env, jobject thiz, jstring directory, jbyteArray key) {
+    
+    try {
+        if (!g_cryptoEngine) {
+            throw CryptoOperationException("CryptoEngine not initialized");
+        }
+
+        SyncPacker packer(*g_cryptoEngine, jbyteArrayToSecureBytes(env, key));
+        auto result = packer.unpackFromDirectory(jstringToString(env, directory));
+        jbyteArray output = vectorToJbyteArray(env, result);
+        CryptoEngine::secureZero(result);
+        return output;
+        
+    } catch (const std::exception& e) {
+        LOGE("Sync unpack from directory failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+// Merge engine
+
+JNIEXPORT jobject JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeMerge(
+    JNIEnv* env, jobject thiz, jbyteArray base, jbyteArray local, jbyteArray remote) {
+    
+    try {
+        auto baseVec = jbyteArrayToVector(env, base);
+        auto localVec = jbyteArrayToVector(env, local);
+        auto remoteVec = jbyteArrayToVector(env, remote);
+
+        MergeResult result = MergeEngine::merge(baseVec, localVec, remoteVec);
+        CryptoEngine::secureZero(baseVec);
+        CryptoEngine::secureZero(localVec);
+        CryptoEngine::secureZero(remoteVec);
+
+        std::vector<std::string> conflictIds;
+        std::vector<std::string> conflictKinds;
+        for (const auto& conflict : result.conflicts) {
+            conflictIds.push_back(conflict.id);
+            switch (conflict.kind) {
+                case ConflictKind::BOTH_MODIFIED: conflictKinds.emplace_back("BOTH_MODIFIED"); break;
+                case ConflictKind::BOTH_ADDED: conflictKinds.emplace_back("BOTH_ADDED"); break;
+                case ConflictKind::DELETED_LOCALLY: conflictKinds.emplace_back("DELETED_LOCALLY"); break;
+                case ConflictKind::DELETED_REMOTELY: conflictKinds.emplace_back("DELETED_REMOTELY"); break;
+            }
+        }
+        jobjectArray ids = stringsToJobjectArray(env, conflictIds);
+        jobjectArray kinds = stringsToJobjectArray(env, conflictKinds);
+
+        jobject resultMap = createHashMap(env);
+        putByteArrayInMap(env, resultMap, "merged", result.merged);
+        putNumberInMap(env, resultMap, "mergedCount", result.mergedCount);
+        putObjectInMap(env, resultMap, "conflictIds", ids);
+        putObjectInMap(env, resultMap, "conflictKinds", kinds);
+        env->DeleteLocalRef(ids);
+        env->DeleteLocalRef(kinds);
+        CryptoEngine::secureZero(result.merged);
+        return resultMap;
+        
+    } catch (const std::exception& e) {
+        LOGE("Merge failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+// Sealed streams
+
+JNIEXPORT jbyteArray JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeStreamSeal(
+    JNIEnv* env, jobject thiz, jint keyHandle, jbyteArray data, jstring algorithm, jstring compression) {
+    
+    try {
+        auto dataVec = jbyteArrayToVector(env, data);
+        auto cipherAlg = stringToCipherAlgorithm(jstringToString(env, algorithm));
+        auto mode = stringToCompressionMode(jstringToString(env, compression));
+
+        std::vector<uint8_t> sealed;
+        StreamSealer sealer(*getKey(keyHandle), cipherAlg, mode,
+            [&sealed](const uint8_t* chunk, size_t length) {
+                sealed.insert(sealed.end(), chunk, chunk + length);
+            });
+        sealer.update(dataVec.data(), dataVec.size());
+        sealer.finish();
+        CryptoEngine::secureZero(dataVec);
+
+        return vectorToJbyteArray(env, sealed);
+        
+    } catch (const std::exception& e) {
+        LOGE("Stream sealing failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeStreamOpen(
+    JNIEnv* env, jobject thiz, jint keyHandle, jbyteArray sealed) {
+    
+    std::vector<uint8_t> plaintext;
+    try {
+        auto sealedVec = jbyteArrayToVector(env, sealed);
+
+        StreamOpener opener(*getKey(keyHandle),
+            [&plaintext](const uint8_t* chunk, size_t length) {
+                plaintext.insert(plaintext.end(), chunk, chunk + length);
+            });
+        opener.update(sealedVec.data(), sealedVec.size());
+        opener.finish();
+
+        jbyteArray result = vectorToJbyteArray(env, plaintext);
+        CryptoEngine::secureZero(plaintext);
+        return result;
+        
+    } catch (const std::exception& e) {
+        CryptoEngine::secureZero(plaintext);
+        LOGE("Stream opening failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jobject JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeStreamSealFile(
+    JNIEnv* env, jobject thiz, jint keyHandle, jstring inputPath, jstring outputPath,
+    jstring algorithm, jstring compression) {
+    
+    try {
+        auto cipherAlg = stringToCipherAlgorithm(jstringToString(env, algorithm));
+        auto mode = stringToCompressionMode(jstringToString(env, compression));
+
+        auto stats = sealFile(*getKey(keyHandle), cipherAlg, mode,
+                              jstringToString(env, inputPath), jstringToString(env, outputPath));
+
+        jobject resultMap = createHashMap(env);
+        putNumberInMap(env, resultMap, "bytesIn", static_cast<double>(stats.bytesIn));
+        putNumberInMap(env, resultMap, "bytesOut", static_cast<double>(stats.bytesOut));
+        return resultMap;
+        
+    } catch (const std::exception& e) {
+        LOGE("Stream file sealing failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jobject JNICALL
+Java_dev_exzh_expo_crypto_CryptoNativeModule_nativeStreamOpenFile(
+    JNIEnv* env, jobject thiz, jint keyHandle, jstring inputPath, jstring outputPath) {
+    
+    try {
+        auto stats = openFile(*getKey(keyHandle), jstringToString(env, inputPath),
+                              jstringToString(env, outputPath));
+
+        jobject resultMap = createHashMap(env);
+        putNumberInMap(env, resultMap, "bytesIn", static_cast<double>(stats.bytesIn));
+        putNumberInMap(env, resultMap, "bytesOut", static_cast<double>(stats.bytesOut));
+        return resultMap;
+        
+    } catch (const std::exception& e) {
+        LOGE("Stream file opening failed: %s", e.what());
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
     }
 }
 
-} // extern "C" 
\ No newline at end of file
+} // extern "C"
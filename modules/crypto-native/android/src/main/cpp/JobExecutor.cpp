@@ -0,0 +1,195 @@
+#include "JobExecutor.h"
+#include <algorithm>
+
+namespace crypto_native {
+
+void JobResult::wipe() {
+    for (auto& entry : bytes) {
+        CryptoEngine::secureZero(entry.second);
+    }
+    bytes.clear();
+    numbers.clear();
+}
+
+void JobContext::reportProgress(uint64_t done, uint64_t total) const {
+    if (!*onProgress_ || total == 0) {
+        return;
+    }
+    int percent = static_cast<int>(std::min<uint64_t>(done, total) * 100 / total);
+    if (percent > lastPercent_) {
+        lastPercent_ = percent;
+        (*onProgress_)(id_, static_cast<double>(percent) / 100.0);
+    }
+}
+
+JobExecutor::JobExecutor(CompletionHandler onComplete, ProgressHandler onProgress)
+    : onComplete_(std::move(onComplete)), onProgress_(std::move(onProgress)) {
+    // At least one worker besides the interactive one, even on a single core
+    size_t count = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, kMaxWorkers);
+
+    background_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        background_.push_back(std::make_unique<Lane>());
+    }
+    workers_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        workers_.emplace_back(&JobExecutor::workerLoop, this, i);
+    }
+}
+
+JobExecutor::~JobExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        for (auto& entry : jobs_) {
+            entry.second->cancel();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+uint64_t JobExecutor::submit(JobPriority priority, Job job) {
+    Task task;
+    task.job = std::move(job);
+    task.token = std::make_shared<CancellationToken>();
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        if (jobs_.size() >= kMaxPending) {
+            throw CryptoOperationException("Job queue is full");
+        }
+        task.id = nextJobId_++;
+        jobs_.emplace(task.id, task.token);
+    }
+    uint64_t id = task.id;
+
+    if (priority == JobPriority::INTERACTIVE) {
+        std::lock_guard<std::mutex> lock(interactive_.mutex);
+        interactive_.tasks.push_back(std::move(task));
+        interactiveQueued_.fetch_add(1);
+    } else {
+        size_t lane = 1 + nextLane_.fetch_add(1) % (background_.size() - 1);
+        std::lock_guard<std::mutex> lock(background_[lane]->mutex);
+        background_[lane]->tasks.push_back(std::move(task));
+        backgroundQueued_.fetch_add(1);
+    }
+
+    // Taking the lock orders the counter update before any worker's
+    // predicate check, so the wakeup cannot be lost
+    { std::lock_guard<std::mutex> lock(sleepMutex_); }
+    wake_.notify_all();
+    return id;
+}
+
+bool JobExecutor::cancel(uint64_t jobId) {
+    std::lock_guard<std::mutex> lock(jobsMutex_);
+    auto it = jobs_.find(jobId);
+    if (it == jobs_.end()) {
+        return false;
+    }
+    it->second->cancel();
+    return true;
+}
+
+bool JobExecutor::takeTask(size_t index, Task& task) {
+    if (interactiveQueued_.load() > 0) {
+        std::lock_guard<std::mutex> lock(interactive_.mutex);
+        if (!interactive_.tasks.empty()) {
+            task = std::move(interactive_.tasks.front());
+            interactive_.tasks.pop_front();
+            interactiveQueued_.fetch_sub(1);
+            return true;
+        }
+    }
+    if (index == 0 || backgroundQueued_.load() == 0) {
+        return false;
+    }
+
+    {
+        Lane& own = *background_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            backgroundQueued_.fetch_sub(1);
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < background_.size() - 1; ++offset) {
+        size_t victim = 1 + (index - 1 + offset) % (background_.size() - 1);
+        Lane& other = *background_[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.back());
+            other.tasks.pop_back();
+            backgroundQueued_.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobExecutor::workerLoop(size_t index) {
+    for (;;) {
+        Task task;
+        if (takeTask(index, task)) {
+            runTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        if (stopping_) {
+            // Queues are drained: anything left was cancelled and reported
+            if (interactiveQueued_.load() == 0 && (index == 0 || backgroundQueued_.load() == 0)) {
+                return;
+            }
+            continue;
+        }
+        wake_.wait(lock, [&] {
+            return stopping_ || interactiveQueued_.load() > 0 ||
+                   (index != 0 && backgroundQueued_.load() > 0);
+        });
+    }
+}
+
+void JobExecutor::runTask(Task& task) {
+    JobResult result;
+    JobStatus status = JobStatus::COMPLETED;
+    std::string error;
+
+    try {
+        task.token->throwIfCancelled();
+        JobContext context(task.id, task.token.get(), &onProgress_);
+        task.job(context, result);
+    } catch (const OperationCancelledException&) {
+        status = JobStatus::CANCELLED;
+    } catch (const std::exception& e) {
+        status = JobStatus::FAILED;
+        error = e.what();
+    }
+    if (status != JobStatus::COMPLETED) {
+        result.wipe();
+    }
+
+    // Release the captured inputs before reporting, so a caller reacting to
+    // the completion never races the job's own cleanup
+    task.job = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        jobs_.erase(task.id);
+    }
+
+    try {
+        onComplete_(task.id, status, result, error);
+    } catch (...) {
+        // The handler owns its own error reporting; a worker must survive it
+    }
+    result.wipe();
+}
+
+} // namespace crypto_native
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "CryptoEngine.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace crypto_native {
+
+enum class JobPriority {
+    INTERACTIVE,  // OTP generation and anything else the user is waiting on
+    BACKGROUND    // KDFs, bulk encryption, exports
+};
+
+enum class JobStatus {
+    COMPLETED,
+    CANCELLED,
+    FAILED
+};
+
+// Named values a job hands back; the completion handler turns them into
+// whatever the caller's side needs. Byte values are wiped once delivered.
+struct JobResult {
+    std::vector<std::pair<std::string, std::vector<uint8_t>>> bytes;
+    std::vector<std::pair<std::string, double>> numbers;
+
+    void wipe();
+};
+
+// What a running job sees of the executor: its cancellation token and a
+// progress sink. Progress is forwarded only when it crosses another whole
+// percent, so jobs may report as often as is convenient.
+class JobContext {
+public:
+    const CancellationToken& token() const { return *token_; }
+
+    void reportProgress(uint64_t done, uint64_t total) const;
+
+private:
+    friend class JobExecutor;
+
+    JobContext(uint64_t id, const CancellationToken* token,
+               const std::function<void(uint64_t, double)>* onProgress)
+        : id_(id), token_(token), onProgress_(onProgress) {}
+
+    uint64_t id_;
+    const CancellationToken* token_;
+    const std::function<void(uint64_t, double)>* onProgress_;
+    mutable int lastPercent_ = -1;
+};
+
+// Fixed pool of worker threads running crypto jobs off the caller's thread.
+//
+// Worker 0 only ever takes interactive jobs, so a queue full of slow
+// background work can delay interactive jobs by at most the one job each
+// other worker is already running, never by the length of the queue. The
+// remaining workers drain the interactive lane first, then the front of their
+// own background deque, then steal from the back of another worker's deque.
+// Background jobs are dealt round-robin across those deques.
+//
+// Every job gets a CancellationToken. cancel() sets it; a job still queued is
+// dropped without running, and a running job sees it at its next check.
+// Whatever the outcome, the single completion handler is called exactly once
+// per job, on the worker thread that finished it. The optional progress
+// handler runs on the job's worker as it reports.
+class JobExecutor {
+public:
+    using Job = std::function<void(const JobContext&, JobResult&)>;
+    using CompletionHandler = std::function<void(uint64_t jobId, JobStatus status,
+                                                 const JobResult& result, const std::string& error)>;
+    using ProgressHandler = std::function<void(uint64_t jobId, double fraction)>;
+
+    static constexpr size_t kMaxWorkers = 4;
+    static constexpr size_t kMaxPending = 256;
+
+    explicit JobExecutor(CompletionHandler onComplete, ProgressHandler onProgress = nullptr);
+
+    // Cancels everything outstanding, reports it, and joins the workers
+    ~JobExecutor();
+
+    JobExecutor(const JobExecutor&) = delete;
+    JobExecutor& operator=(const JobExecutor&) = delete;
+
+    // Queues `job` and returns its id; throws CryptoOperationException while
+    // kMaxPending jobs are queued or running
+    uint64_t submit(JobPriority priority, Job job);
+
+    // Returns false if the job has already finished or never existed
+    bool cancel(uint64_t jobId);
+
+    size_t workerCount() const { return workers_.size(); }
+
+private:
+    struct Task {
+        uint64_t id = 0;
+        Job job;
+        std::shared_ptr<CancellationToken> token;
+    };
+
+    struct Lane {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool takeTask(size_t index, Task& task);
+    void runTask(Task& task);
+
+    CompletionHandler onComplete_;
+    ProgressHandler onProgress_;
+
+    Lane interactive_;
+    std::vector<std::unique_ptr<Lane>> background_;  // one per worker; slot 0 unused
+    std::vector<std::thread> workers_;
+
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> interactiveQueued_{0};
+    std::atomic<size_t> backgroundQueued_{0};
+    std::atomic<size_t> nextLane_{0};
+    bool stopping_ = false;
+
+    std::mutex jobsMutex_;
+    std::unordered_map<uint64_t, std::shared_ptr<CancellationToken>> jobs_;
+    uint64_t nextJobId_ = 1;
+};
+
+} // namespace crypto_native
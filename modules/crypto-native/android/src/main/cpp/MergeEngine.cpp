@@ -0,0 +1,251 @@
+#include "MergeEngine.h"
+#include <cstring>
+#include <memory>
+
+namespace crypto_native {
+
+namespace {
+
+constexpr size_t RECORD_HEADER = sizeof(uint16_t) + sizeof(uint32_t);
+
+enum Side : uint32_t {
+    LOCAL = 0,
+    REMOTE = 1,
+    BASE = 2
+};
+
+struct RecordView {
+    const uint8_t* id;
+    const uint8_t* data;
+    uint64_t idHash;
+    uint64_t fingerprint;
+    uint32_t dataLength;
+    uint16_t idLength;
+};
+
+// Side indices are stored +1 so that a zeroed slot means "absent"
+struct Slot {
+    uint64_t idHash;
+    uint32_t occupied;
+    uint32_t side[3];
+};
+
+uint64_t mix(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+uint64_t hashBytes(const uint8_t* data, size_t length, uint64_t seed) {
+    uint64_t hash = seed ^ (length * 0x9E3779B97F4A7C15ULL);
+    while (length >= sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        hash = mix(hash ^ word);
+        data += sizeof(word);
+        length -= sizeof(word);
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data, length);
+    return mix(hash ^ tail ^ (static_cast<uint64_t>(length) << 56));
+}
+
+size_t countRecords(const std::vector<uint8_t>& stream) {
+    size_t count = 0;
+    size_t offset = 0;
+    while (offset < stream.size()) {
+        if (stream.size() - offset < RECORD_HEADER) {
+            throw InvalidParameterException("Malformed record stream");
+        }
+        uint16_t idLength;
+        uint32_t dataLength;
+        std::memcpy(&idLength, stream.data() + offset, sizeof(idLength));
+        std::memcpy(&dataLength, stream.data() + offset + sizeof(idLength), sizeof(dataLength));
+        offset += RECORD_HEADER;
+        if (idLength == 0 || stream.size() - offset < static_cast<uint64_t>(idLength) + dataLength) {
+            throw InvalidParameterException("Malformed record stream");
+        }
+        offset += idLength + dataLength;
+        ++count;
+    }
+    return count;
+}
+
+RecordView* parseRecords(const std::vector<uint8_t>& stream, RecordView* out) {
+    const uint8_t* cursor = stream.data();
+    const uint8_t* end = cursor + stream.size();
+    while (cursor < end) {
+        RecordView& view = *out++;
+        std::memcpy(&view.idLength, cursor, sizeof(view.idLength));
+        std::memcpy(&view.dataLength, cursor + sizeof(view.idLength), sizeof(view.dataLength));
+        view.id = cursor + RECORD_HEADER;
+        view.data = view.id + view.idLength;
+        view.idHash = hashBytes(view.id, view.idLength, 0);
+        view.fingerprint = hashBytes(view.data, view.dataLength, 0x5341464D45524745ULL);
+        cursor = view.data + view.dataLength;
+    }
+    return out;
+}
+
+bool sameId(const RecordView& a, const RecordView& b) {
+    return a.idLength == b.idLength && std::memcmp(a.id, b.id, a.idLength) == 0;
+}
+
+bool sameContent(const RecordView* a, const RecordView* b) {
+    return a->fingerprint == b->fingerprint && a->dataLength == b->dataLength &&
+           std::memcmp(a->data, b->data, a->dataLength) == 0;
+}
+
+size_t tableCapacity(size_t records) {
+    // Load factor stays at or below one half
+    size_t capacity = 16;
+    while (capacity < records * 2) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+} // anonymous namespace
+
+void MergeEngine::appendRecord(std::vector<uint8_t>& stream, const std::string& id,
+                               const uint8_t* data, size_t length) {
+    if (id.empty() || id.size() > UINT16_MAX || length > UINT32_MAX) {
+        throw InvalidParameterException("Record too large");
+    }
+    const uint16_t idLength = static_cast<uint16_t>(id.size());
+    const uint32_t dataLength = static_cast<uint32_t>(length);
+    const size_t offset = stream.size();
+    stream.resize(offset + RECORD_HEADER + id.size() + length);
+    uint8_t* out = stream.data() + offset;
+    std::memcpy(out, &idLength, sizeof(idLength));
+    std::memcpy(out + sizeof(idLength), &dataLength, sizeof(dataLength));
+    std::memcpy(out + RECORD_HEADER, id.data(), id.size());
+    if (length) {
+        std::memcpy(out + RECORD_HEADER + id.size(), data, length);
+    }
+}
+
+MergeResult MergeEngine::merge(const std::vector<uint8_t>& base,
+                               const std::vector<uint8_t>& local,
+                               const std::vector<uint8_t>& remote) {
+    const std::vector<uint8_t>* streams[3] = {&local, &remote, &base};
+    size_t counts[3];
+    size_t total = 0;
+    for (int side = 0; side < 3; ++side) {
+        counts[side] = countRecords(*streams[side]);
+        total += counts[side];
+    }
+    if (total >= UINT32_MAX / 2) {
+        throw InvalidParameterException("Too many records");
+    }
+
+    // One arena: [views][slots][insertion order]
+    const size_t capacity = tableCapacity(total);
+    const size_t viewBytes = total * sizeof(RecordView);
+    const size_t slotBytes = capacity * sizeof(Slot);
+    const size_t orderBytes = total * sizeof(uint32_t);
+    std::unique_ptr<uint8_t[]> arena(new uint8_t[viewBytes + slotBytes + orderBytes]);
+
+    auto* views = reinterpret_cast<RecordView*>(arena.get());
+    auto* slots = reinterpret_cast<Slot*>(arena.get() + viewBytes);
+    auto* order = reinterpret_cast<uint32_t*>(arena.get() + viewBytes + slotBytes);
+    std::memset(slots, 0, slotBytes);
+
+    RecordView* sideStart[3];
+    RecordView* cursor = views;
+    for (int side = 0; side < 3; ++side) {
+        sideStart[side] = cursor;
+        cursor = parseRecords(*streams[side], cursor);
+    }
+
+    // Hash-join by id; local goes in first so the merged order follows it
+    const size_t mask = capacity - 1;
+    uint32_t slotsUsed = 0;
+    for (uint32_t side = 0; side < 3; ++side) {
+        for (size_t i = 0; i < counts[side]; ++i) {
+            const RecordView& view = sideStart[side][i];
+            const uint32_t viewIndex = static_cast<uint32_t>(&view - views);
+
+            size_t position = view.idHash & mask;
+            for (;;) {
+                Slot& slot = slots[position];
+                if (!slot.occupied) {
+                    slot.occupied = 1;
+                    slot.idHash = view.idHash;
+                    slot.side[side] = viewIndex + 1;
+                    order[slotsUsed++] = static_cast<uint32_t>(position);
+                    break;
+                }
+                if (slot.idHash == view.idHash) {
+                    const uint32_t existing = slot.side[LOCAL] ? slot.side[LOCAL]
+                                            : slot.side[REMOTE] ? slot.side[REMOTE]
+                                            : slot.side[BASE];
+                    if (sameId(views[existing - 1], view)) {
+                        if (slot.side[side]) {
+                            throw InvalidParameterException("Duplicate record id in merge input");
+                        }
+                        slot.side[side] = viewIndex + 1;
+                        break;
+                    }
+                }
+                position = (position + 1) & mask;
+            }
+        }
+    }
+
+    MergeResult result;
+    result.merged.reserve(local.size() + remote.size());
+
+    auto take = [&](const RecordView* view) {
+        if (!view) {
+            return;
+        }
+        const size_t length = RECORD_HEADER + view->idLength + view->dataLength;
+        const uint8_t* start = view->id - RECORD_HEADER;
+        result.merged.insert(result.merged.end(), start, start + length);
+        result.mergedCount++;
+    };
+    auto conflict = [&](const RecordView* view, ConflictKind kind) {
+        result.conflicts.push_back({std::string(reinterpret_cast<const char*>(view->id), view->idLength), kind});
+    };
+
+    for (uint32_t i = 0; i < slotsUsed; ++i) {
+        const Slot& slot = slots[order[i]];
+        const RecordView* l = slot.side[LOCAL] ? &views[slot.side[LOCAL] - 1] : nullptr;
+        const RecordView* r = slot.side[REMOTE] ? &views[slot.side[REMOTE] - 1] : nullptr;
+        const RecordView* b = slot.side[BASE] ? &views[slot.side[BASE] - 1] : nullptr;
+
+        if (l && r && sameContent(l, r)) {
+            take(l);
+        } else if (b) {
+            if (l && sameContent(l, b)) {
+                take(r);  // Unchanged locally: remote edit or delete wins
+            } else if (r && sameContent(r, b)) {
+                take(l);  // Unchanged remotely: local edit or delete wins
+            } else if (!l && !r) {
+                // Deleted on both sides
+            } else if (!l) {
+                conflict(r, ConflictKind::DELETED_LOCALLY);
+                take(r);
+            } else if (!r) {
+                conflict(l, ConflictKind::DELETED_REMOTELY);
+                take(l);
+            } else {
+                conflict(l, ConflictKind::BOTH_MODIFIED);
+                take(l);
+            }
+        } else if (l && r) {
+            conflict(l, ConflictKind::BOTH_ADDED);
+            take(l);
+        } else {
+            take(l ? l : r);
+        }
+    }
+
+    return result;
+}
+
+} // namespace crypto_native
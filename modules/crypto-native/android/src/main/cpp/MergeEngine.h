@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CryptoEngine.h"
+#include <string>
+#include <vector>
+
+namespace crypto_native {
+
+enum class ConflictKind : uint8_t {
+    BOTH_MODIFIED = 1,     // Changed differently on both sides; local version kept
+    BOTH_ADDED = 2,        // Added on both sides with different content; local version kept
+    DELETED_LOCALLY = 3,   // Deleted locally, changed remotely; remote version kept
+    DELETED_REMOTELY = 4   // Deleted remotely, changed locally; local version kept
+};
+
+struct MergeConflict {
+    std::string id;
+    ConflictKind kind;
+};
+
+struct MergeResult {
+    std::vector<uint8_t> merged;  // Record stream, see MergeEngine
+    uint32_t mergedCount = 0;
+    std::vector<MergeConflict> conflicts;
+};
+
+// Three-way merge of account sets for sync.
+//
+// Inputs and output are record streams (little-endian):
+//   repeated [u16 idLength][u32 dataLength][id bytes][data bytes]
+//
+// Records are referenced in place, never copied. Every id is hash-joined
+// across base, local and remote in one open-addressing table, and payloads
+// are compared by a 64-bit content fingerprint (confirmed bytewise on a
+// match), so a merge is O(n) in the total number of records. All working
+// memory is carved from a single arena allocation sized up front.
+//
+// The merged stream lists local records first, in local order, followed by
+// records that only exist remotely, in remote order.
+class MergeEngine {
+public:
+    static MergeResult merge(const std::vector<uint8_t>& base,
+                             const std::vector<uint8_t>& local,
+                             const std::vector<uint8_t>& remote);
+
+    // Appends one record to a record stream
+    static void appendRecord(std::vector<uint8_t>& stream, const std::string& id,
+                             const uint8_t* data, size_t length);
+};
+
+} // namespace crypto_native
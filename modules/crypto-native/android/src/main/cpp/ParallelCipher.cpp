@@ -0,0 +1,394 @@
+#include "ParallelCipher.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#ifdef NO_OPENSSL
+#include "PortableCrypto.h"
+#include "SecureArena.h"
+#else
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#endif
+
+namespace crypto_native {
+
+namespace {
+
+constexpr size_t MAX_WORKERS = 8;
+constexpr size_t BLOCK_SIZE = 16;
+
+// GF(2^128) element in GCM bit order, loaded big-endian
+struct GfBlock {
+    uint64_t hi;
+    uint64_t lo;
+};
+
+constexpr GfBlock GF_ONE = {0x8000000000000000ULL, 0};
+
+GfBlock loadBlock(const uint8_t* bytes) {
+    GfBlock block{0, 0};
+    for (int i = 0; i < 8; ++i) {
+        block.hi = (block.hi << 8) | bytes[i];
+        block.lo = (block.lo << 8) | bytes[8 + i];
+    }
+    return block;
+}
+
+void storeBlock(const GfBlock& block, uint8_t* bytes) {
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<uint8_t>(block.hi >> (56 - 8 * i));
+        bytes[8 + i] = static_cast<uint8_t>(block.lo >> (56 - 8 * i));
+    }
+}
+
+GfBlock gfXor(const GfBlock& a, const GfBlock& b) {
+    return {a.hi ^ b.hi, a.lo ^ b.lo};
+}
+
+// SP 800-38D Algorithm 1; only used to combine segments, never per block
+GfBlock gfMultiply(const GfBlock& x, const GfBlock& y) {
+    GfBlock z{0, 0};
+    GfBlock v = x;
+    for (int i = 0; i < 128; ++i) {
+        uint64_t bit = i < 64 ? (y.hi >> (63 - i)) & 1 : (y.lo >> (127 - i)) & 1;
+        uint64_t mask = 0 - bit;
+        z.hi ^= v.hi & mask;
+        z.lo ^= v.lo & mask;
+        uint64_t carry = 0 - (v.lo & 1);
+        v.lo = (v.lo >> 1) | (v.hi << 63);
+        v.hi = (v.hi >> 1) ^ (0xE100000000000000ULL & carry);
+    }
+    return z;
+}
+
+GfBlock gfPower(GfBlock base, uint64_t exponent) {
+    GfBlock result = GF_ONE;
+    while (exponent) {
+        if (exponent & 1) {
+            result = gfMultiply(result, base);
+        }
+        base = gfMultiply(base, base);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+// h^(2^128 - 2): the exponent is 127 ones followed by a zero
+GfBlock gfInverse(const GfBlock& h) {
+    GfBlock result = GF_ONE;
+    for (int i = 0; i < 127; ++i) {
+        result = gfMultiply(gfMultiply(result, result), h);
+    }
+    return gfMultiply(result, result);
+}
+
+// Adds `blocks` to a 128-bit big-endian counter
+void advanceCounter(uint8_t counter[16], uint64_t blocks) {
+    for (int i = 15; i >= 0 && blocks; --i) {
+        uint64_t sum = counter[i] + (blocks & 0xFF);
+        counter[i] = static_cast<uint8_t>(sum);
+        blocks = (blocks >> 8) + (sum >> 8);
+    }
+}
+
+#ifdef NO_OPENSSL
+
+// Portable primitives. Each call expands its own key schedule, which is a
+// few hundred bytes of work next to a 256 KiB segment, so workers share
+// nothing but the read-only key.
+
+GfBlock encryptBlock(const SecureBytes& key, const uint8_t block[16]) {
+    portable::Aes aes(key.data(), key.size());
+    uint8_t out[BLOCK_SIZE];
+    aes.encryptBlock(block, out);
+    GfBlock result = loadBlock(out);
+    secureWipe(out, sizeof(out));
+    return result;
+}
+
+void ctrSegment(const SecureBytes& key, const uint8_t counter[16], const uint8_t* in, size_t length, uint8_t* out) {
+    portable::Aes aes(key.data(), key.size());
+    uint8_t running[BLOCK_SIZE];
+    std::memcpy(running, counter, BLOCK_SIZE);
+    portable::aesCtr(aes, running, in, length, out);
+}
+
+// Same derivation as the OpenSSL build, over portable::AesGcm's table GHASH
+GfBlock ghashSegment(const SecureBytes& key, const uint8_t* data, size_t length,
+                     const GfBlock& zeroIvMask, const GfBlock& hInverse) {
+    if (length == 0) {
+        return {0, 0};
+    }
+
+    static const uint8_t zeroIv[12] = {};
+    portable::AesGcm gcm(key.data(), key.size());
+    uint8_t tag[BLOCK_SIZE];
+    gcm.seal(zeroIv, sizeof(zeroIv), data, length, nullptr, 0, nullptr, tag);
+
+    GfBlock lengths{static_cast<uint64_t>(length) * 8, 0};
+    return gfXor(gfMultiply(gfXor(loadBlock(tag), zeroIvMask), hInverse), lengths);
+}
+
+bool tagMatches(const uint8_t* expected, const uint8_t* tag, size_t length) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < length; ++i) {
+        diff |= expected[i] ^ tag[i];
+    }
+    return diff == 0;
+}
+
+void cleanse(void* data, size_t length) {
+    secureWipe(data, length);
+}
+
+#else
+
+// EVP update lengths are ints; feed larger spans in pieces
+constexpr size_t MAX_UPDATE = size_t(1) << 30;
+
+const EVP_CIPHER* ctrCipher(size_t keySize) {
+    switch (keySize) {
+        case 16: return EVP_aes_128_ctr();
+        case 24: return EVP_aes_192_ctr();
+        case 32: return EVP_aes_256_ctr();
+        default: throw InvalidKeyException("Invalid AES key size");
+    }
+}
+
+const EVP_CIPHER* gcmCipher(size_t keySize) {
+    switch (keySize) {
+        case 16: return EVP_aes_128_gcm();
+        case 24: return EVP_aes_192_gcm();
+        case 32: return EVP_aes_256_gcm();
+        default: throw InvalidKeyException("Invalid AES key size");
+    }
+}
+
+const EVP_CIPHER* ecbCipher(size_t keySize) {
+    switch (keySize) {
+        case 16: return EVP_aes_128_ecb();
+        case 24: return EVP_aes_192_ecb();
+        case 32: return EVP_aes_256_ecb();
+        default: throw InvalidKeyException("Invalid AES key size");
+    }
+}
+
+// Single-block AES, for H = E(0) and the tag masks
+GfBlock encryptBlock(const SecureBytes& key, const uint8_t block[16]) {
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) {
+        throw CryptoOperationException("Failed to create cipher context");
+    }
+    uint8_t out[BLOCK_SIZE];
+    int len = 0;
+    bool ok = EVP_EncryptInit_ex(ctx, ecbCipher(key.size()), nullptr, key.data(), nullptr) == 1 &&
+              EVP_CIPHER_CTX_set_padding(ctx, 0) == 1 &&
+              EVP_EncryptUpdate(ctx, out, &len, block, BLOCK_SIZE) == 1;
+    EVP_CIPHER_CTX_free(ctx);
+    if (!ok) {
+        throw CryptoOperationException("Block encryption failed");
+    }
+    GfBlock result = loadBlock(out);
+    OPENSSL_cleanse(out, sizeof(out));
+    return result;
+}
+
+void ctrSegment(const SecureBytes& key, const uint8_t counter[16], const uint8_t* in, size_t length, uint8_t* out) {
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) {
+        throw CryptoOperationException("Failed to create cipher context");
+    }
+    bool ok = EVP_EncryptInit_ex(ctx, ctrCipher(key.size()), nullptr, key.data(), counter) == 1;
+    for (size_t offset = 0; ok && offset < length; offset += MAX_UPDATE) {
+        int len = 0;
+        size_t piece = std::min(MAX_UPDATE, length - offset);
+        ok = EVP_EncryptUpdate(ctx, out + offset, &len, in + offset, static_cast<int>(piece)) == 1;
+    }
+    EVP_CIPHER_CTX_free(ctx);
+    if (!ok) {
+        throw CryptoOperationException("Parallel CTR segment failed");
+    }
+}
+
+// GHASH(data || zero padding), read back out of an AAD-only GCM tag:
+// tag = E(J0) + (GHASH(data) * H + L * H) with L = [8 * length]_64 || 0^64
+GfBlock ghashSegment(const SecureBytes& key, const uint8_t* data, size_t length,
+                     const GfBlock& zeroIvMask, const GfBlock& hInverse) {
+    if (length == 0) {
+        return {0, 0};
+    }
+
+    static const uint8_t zeroIv[12] = {};
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) {
+        throw CryptoOperationException("Failed to create cipher context");
+    }
+    uint8_t tag[BLOCK_SIZE];
+    int len = 0;
+    bool ok = EVP_EncryptInit_ex(ctx, gcmCipher(key.size()), nullptr, key.data(), zeroIv) == 1;
+    for (size_t offset = 0; ok && offset < length; offset += MAX_UPDATE) {
+        size_t piece = std::min(MAX_UPDATE, length - offset);
+        ok = EVP_EncryptUpdate(ctx, nullptr, &len, data + offset, static_cast<int>(piece)) == 1;
+    }
+    ok = ok && EVP_EncryptFinal_ex(ctx, tag, &len) == 1 &&
+         EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, BLOCK_SIZE, tag) == 1;
+    EVP_CIPHER_CTX_free(ctx);
+    if (!ok) {
+        throw CryptoOperationException("Parallel GHASH segment failed");
+    }
+
+    GfBlock lengths{static_cast<uint64_t>(length) * 8, 0};
+    return gfXor(gfMultiply(gfXor(loadBlock(tag), zeroIvMask), hInverse), lengths);
+}
+
+bool tagMatches(const uint8_t* expected, const uint8_t* tag, size_t length) {
+    return CRYPTO_memcmp(expected, tag, length) == 0;
+}
+
+void cleanse(void* data, size_t length) {
+    OPENSSL_cleanse(data, length);
+}
+
+#endif
+
+// Runs body(0..count-1), segment 0 on the calling thread
+void runSegments(size_t count, const std::function<void(size_t)>& body) {
+    std::vector<std::exception_ptr> errors(count);
+    std::vector<std::thread> workers;
+    workers.reserve(count - 1);
+    auto guarded = [&](size_t index) {
+        try {
+            body(index);
+        } catch (...) {
+            errors[index] = std::current_exception();
+        }
+    };
+    for (size_t i = 1; i < count; ++i) {
+        workers.emplace_back(guarded, i);
+    }
+    guarded(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+struct Segment {
+    size_t offset;
+    size_t length;
+};
+
+std::vector<Segment> splitSegments(size_t length, size_t count) {
+    if (count == 0) {
+        count = ParallelCipher::segmentsFor(length);
+    }
+    size_t blocks = (length + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    size_t segmentBytes = (blocks + count - 1) / count * BLOCK_SIZE;
+
+    std::vector<Segment> segments;
+    for (size_t offset = 0; offset < length; offset += segmentBytes) {
+        segments.push_back({offset, std::min(segmentBytes, length - offset)});
+    }
+    return segments;
+}
+
+// Shared by both directions; GHASH always runs over the ciphertext side
+void gcm(const SecureBytes& key, const uint8_t iv[12], const uint8_t* aad, size_t aadLength,
+         const uint8_t* in, size_t length, uint8_t* out, bool encrypting, uint8_t tag[16], size_t count) {
+    if (length / BLOCK_SIZE >= 0xFFFFFFFEULL) {
+        throw InvalidParameterException("GCM plaintext too long");
+    }
+
+    uint8_t zeroBlock[BLOCK_SIZE] = {};
+    GfBlock h = encryptBlock(key, zeroBlock);
+    GfBlock hInverse = gfInverse(h);
+    zeroBlock[15] = 1;
+    GfBlock zeroIvMask = encryptBlock(key, zeroBlock);
+
+    uint8_t j0[BLOCK_SIZE];
+    std::memcpy(j0, iv, 12);
+    j0[12] = 0;
+    j0[13] = 0;
+    j0[14] = 0;
+    j0[15] = 1;
+    GfBlock tagMask = encryptBlock(key, j0);
+
+    std::vector<Segment> segments = splitSegments(length, count);
+    std::vector<GfBlock> hashes(segments.size());
+    runSegments(segments.size(), [&](size_t index) {
+        const Segment& segment = segments[index];
+        uint8_t counter[BLOCK_SIZE];
+        std::memcpy(counter, j0, BLOCK_SIZE);
+        advanceCounter(counter, 1 + segment.offset / BLOCK_SIZE);
+
+        if (!encrypting) {
+            hashes[index] = ghashSegment(key, in + segment.offset, segment.length, zeroIvMask, hInverse);
+        }
+        ctrSegment(key, counter, in + segment.offset, segment.length, out + segment.offset);
+        if (encrypting) {
+            hashes[index] = ghashSegment(key, out + segment.offset, segment.length, zeroIvMask, hInverse);
+        }
+    });
+
+    GfBlock y = ghashSegment(key, aad, aadLength, zeroIvMask, hInverse);
+    for (size_t i = 0; i < segments.size(); ++i) {
+        uint64_t blocks = (segments[i].length + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        y = gfXor(gfMultiply(y, gfPower(h, blocks)), hashes[i]);
+    }
+    GfBlock lengths{static_cast<uint64_t>(aadLength) * 8, static_cast<uint64_t>(length) * 8};
+    y = gfXor(gfMultiply(gfXor(y, lengths), h), tagMask);
+    storeBlock(y, tag);
+}
+
+} // namespace
+
+size_t ParallelCipher::segmentsFor(size_t length) {
+    if (length < kThreshold) {
+        return 1;
+    }
+    size_t cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+    return std::max<size_t>(1, std::min({cores, MAX_WORKERS, length / kMinSegment}));
+}
+
+void ParallelCipher::ctr(const SecureBytes& key, const uint8_t iv[16],
+                         const uint8_t* in, size_t length, uint8_t* out, size_t count) {
+    std::vector<Segment> segments = splitSegments(length, count);
+    runSegments(segments.size(), [&](size_t index) {
+        const Segment& segment = segments[index];
+        uint8_t counter[BLOCK_SIZE];
+        std::memcpy(counter, iv, BLOCK_SIZE);
+        advanceCounter(counter, segment.offset / BLOCK_SIZE);
+        ctrSegment(key, counter, in + segment.offset, segment.length, out + segment.offset);
+    });
+}
+
+void ParallelCipher::gcmEncrypt(const SecureBytes& key, const uint8_t iv[12],
+                                const uint8_t* aad, size_t aadLength,
+                                const uint8_t* in, size_t length, uint8_t* out, uint8_t tag[16],
+                                size_t count) {
+    gcm(key, iv, aad, aadLength, in, length, out, true, tag, count);
+}
+
+bool ParallelCipher::gcmDecrypt(const SecureBytes& key, const uint8_t iv[12],
+                                const uint8_t* aad, size_t aadLength,
+                                const uint8_t* in, size_t length, uint8_t* out,
+                                const uint8_t* tag, size_t tagLength, size_t count) {
+    uint8_t expected[BLOCK_SIZE];
+    gcm(key, iv, aad, aadLength, in, length, out, false, expected, count);
+    bool valid = tagLength > 0 && tagLength <= BLOCK_SIZE && tagMatches(expected, tag, tagLength);
+    cleanse(expected, sizeof(expected));
+    if (!valid) {
+        cleanse(out, length);
+    }
+    return valid;
+}
+
+} // namespace crypto_native
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CryptoEngine.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace crypto_native {
+
+// Multi-threaded AES-CTR and AES-GCM for large buffers.
+//
+// The input is cut into block-aligned segments, one per worker. Each segment
+// runs AES-CTR from its own counter offset, so the keystream, and therefore
+// the output, is byte-identical to a single pass over the whole buffer.
+//
+// For GCM every worker also computes GHASH over its ciphertext segment. It
+// does so by feeding the segment as AAD to a GCM seal under a zero IV, and
+// stripping the length block and mask from the resulting tag: OpenSSL's
+// carry-less multiply accelerated GCM, or portable::AesGcm in NO_OPENSSL
+// builds. The per-segment hashes are then combined serially:
+// GHASH(A || B) = GHASH(A) * H^blocks(B) + GHASH(B). Only that combine step
+// uses the bitwise GF(2^128) multiply, a few hundred times per call.
+//
+// CryptoEngine routes here on its own in both builds.
+class ParallelCipher {
+public:
+    // Buffers below this stay on the calling thread
+    static constexpr size_t kThreshold = 1024 * 1024;
+    static constexpr size_t kMinSegment = 256 * 1024;
+
+    // Number of segments to use for `length` bytes; 1 means stay serial
+    static size_t segmentsFor(size_t length);
+
+    // The entry points below split into `segments` pieces, or
+    // segmentsFor(length) when it is 0. Output never depends on the split.
+
+    // AES-CTR with OpenSSL's 128-bit big-endian counter starting at `iv`
+    static void ctr(const SecureBytes& key, const uint8_t iv[16],
+                    const uint8_t* in, size_t length, uint8_t* out, size_t segments = 0);
+
+    // AES-GCM with a 96-bit IV; writes a 16-byte tag
+    static void gcmEncrypt(const SecureBytes& key, const uint8_t iv[12],
+                           const uint8_t* aad, size_t aadLength,
+                           const uint8_t* in, size_t length, uint8_t* out, uint8_t tag[16],
+                           size_t segments = 0);
+
+    // Returns false, with `out` wiped, if the first `tagLength` bytes of the
+    // computed tag do not match
+    static bool gcmDecrypt(const SecureBytes& key, const uint8_t iv[12],
+                           const uint8_t* aad, size_t aadLength,
+                           const uint8_t* in, size_t length, uint8_t* out,
+                           const uint8_t* tag, size_t tagLength, size_t segments = 0);
+};
+
+} // namespace crypto_native
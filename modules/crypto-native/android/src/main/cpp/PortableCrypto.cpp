@@ -0,0 +1,814 @@
+#include "PortableCrypto.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace crypto_native {
+namespace portable {
+
+namespace {
+
+inline uint32_t rotr32(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+inline uint32_t rotl32(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+inline uint64_t rotr64(uint64_t x, int n) { return (x >> n) | (x << (64 - n)); }
+
+inline uint32_t loadBe32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+inline uint64_t loadBe64(const uint8_t* p) {
+    return (static_cast<uint64_t>(loadBe32(p)) << 32) | loadBe32(p + 4);
+}
+
+inline void storeBe32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+inline void storeBe64(uint8_t* p, uint64_t v) {
+    storeBe32(p, static_cast<uint32_t>(v >> 32));
+    storeBe32(p + 4, static_cast<uint32_t>(v));
+}
+
+inline uint32_t loadLe32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline void storeLe32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+// SHA-1 and SHA-2 (FIPS 180-4). The message schedules are not wiped per
+// block: PBKDF2 runs these millions of times, and the chaining state the
+// caller holds is wiped with the Digest.
+
+constexpr uint32_t SHA1_INIT[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+constexpr uint32_t SHA256_INIT[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+constexpr uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+constexpr uint64_t SHA384_INIT[8] = {
+    0xcbbb9d5dc1059ed8ULL, 0x629a292a367cd507ULL, 0x9159015a3070dd17ULL, 0x152fecd8f70e5939ULL,
+    0x67332667ffc00b31ULL, 0x8eb44a8768581511ULL, 0xdb0c2e0d64f98fa7ULL, 0x47b5481dbefa4fa4ULL
+};
+
+constexpr uint64_t SHA512_INIT[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+constexpr uint64_t SHA512_K[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+void sha1Compress(uint32_t state[5], const uint8_t* block) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = loadBe32(block + 4 * i);
+    }
+    for (int i = 16; i < 80; ++i) {
+        w[i] = rotl32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (int i = 0; i < 80; ++i) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = d ^ (b & (c ^ d));
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (d & (b | c));
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        const uint32_t t = rotl32(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rotl32(b, 30);
+        b = a;
+        a = t;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+void sha256Compress(uint32_t state[8], const uint8_t* block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = loadBe32(block + 4 * i);
+    }
+    for (int i = 16; i < 64; ++i) {
+        const uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+        const uint32_t t1 = h + (rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25)) + (g ^ (e & (f ^ g))) +
+                            SHA256_K[i] + w[i];
+        const uint32_t t2 = (rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22)) + ((a & b) | (c & (a | b)));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void sha512Compress(uint64_t state[8], const uint8_t* block) {
+    uint64_t w[80];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = loadBe64(block + 8 * i);
+    }
+    for (int i = 16; i < 80; ++i) {
+        const uint64_t s0 = rotr64(w[i - 15], 1) ^ rotr64(w[i - 15], 8) ^ (w[i - 15] >> 7);
+        const uint64_t s1 = rotr64(w[i - 2], 19) ^ rotr64(w[i - 2], 61) ^ (w[i - 2] >> 6);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint64_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint64_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 80; ++i) {
+        const uint64_t t1 = h + (rotr64(e, 14) ^ rotr64(e, 18) ^ rotr64(e, 41)) + (g ^ (e & (f ^ g))) +
+                            SHA512_K[i] + w[i];
+        const uint64_t t2 = (rotr64(a, 28) ^ rotr64(a, 34) ^ rotr64(a, 39)) + ((a & b) | (c & (a | b)));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+// AES tables (FIPS 197), built once on first use. Words are little-endian:
+// byte 0 of a column is the low byte.
+
+inline uint8_t xtime(uint8_t x) {
+    return static_cast<uint8_t>((x << 1) ^ ((x & 0x80) ? 0x1B : 0x00));
+}
+
+struct AesTables {
+    uint8_t forwardSbox[256];
+    uint8_t reverseSbox[256];
+    uint32_t forward[4][256];
+    uint32_t reverse[4][256];
+    uint32_t rcon[10];
+
+    AesTables() {
+        uint8_t pow[256];
+        uint8_t log[256] = {};
+        uint8_t x = 1;
+        for (int i = 0; i < 256; ++i) {
+            pow[i] = x;
+            log[x] = static_cast<uint8_t>(i);
+            x ^= xtime(x);
+        }
+        x = 1;
+        for (uint32_t& r : rcon) {
+            r = x;
+            x = xtime(x);
+        }
+
+        forwardSbox[0x00] = 0x63;
+        reverseSbox[0x63] = 0x00;
+        for (int i = 1; i < 256; ++i) {
+            uint8_t y = pow[255 - log[i]];
+            uint8_t s = y;
+            for (int k = 0; k < 4; ++k) {
+                y = static_cast<uint8_t>((y << 1) | (y >> 7));
+                s ^= y;
+            }
+            s ^= 0x63;
+            forwardSbox[i] = s;
+            reverseSbox[s] = static_cast<uint8_t>(i);
+        }
+
+        auto multiply = [&](uint8_t a, uint8_t b) -> uint32_t {
+            return (a && b) ? pow[(log[a] + log[b]) % 255] : 0;
+        };
+        for (int i = 0; i < 256; ++i) {
+            const uint8_t s = forwardSbox[i];
+            const uint8_t s2 = xtime(s);
+            const uint8_t s3 = static_cast<uint8_t>(s2 ^ s);
+            forward[0][i] = static_cast<uint32_t>(s2) ^ (static_cast<uint32_t>(s) << 8) ^
+                            (static_cast<uint32_t>(s) << 16) ^ (static_cast<uint32_t>(s3) << 24);
+            const uint8_t r = reverseSbox[i];
+            reverse[0][i] = multiply(0x0E, r) ^ (multiply(0x09, r) << 8) ^ (multiply(0x0D, r) << 16) ^
+                            (multiply(0x0B, r) << 24);
+            for (int t = 1; t < 4; ++t) {
+                forward[t][i] = rotl32(forward[t - 1][i], 8);
+                reverse[t][i] = rotl32(reverse[t - 1][i], 8);
+            }
+        }
+    }
+};
+
+const AesTables& aesTables() {
+    static const AesTables tables;
+    return tables;
+}
+
+inline uint32_t subWord(const AesTables& t, uint32_t w) {
+    return static_cast<uint32_t>(t.forwardSbox[w & 0xFF]) |
+           (static_cast<uint32_t>(t.forwardSbox[(w >> 8) & 0xFF]) << 8) |
+           (static_cast<uint32_t>(t.forwardSbox[(w >> 16) & 0xFF]) << 16) |
+           (static_cast<uint32_t>(t.forwardSbox[w >> 24]) << 24);
+}
+
+inline void incrementCounter(uint8_t counter[kAesBlockSize]) {
+    for (int i = kAesBlockSize - 1; i >= 0; --i) {
+        if (++counter[i] != 0) {
+            break;
+        }
+    }
+}
+
+inline void xorBlock(uint8_t* out, const uint8_t* a, const uint8_t* b, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        out[i] = a[i] ^ b[i];
+    }
+}
+
+// Reduction constants for shifting a GHASH value right by four bits
+constexpr uint64_t GHASH_REDUCE[16] = {
+    0x0000, 0x1C20, 0x3840, 0x2460, 0x7080, 0x6CA0, 0x48C0, 0x54E0,
+    0xE100, 0xFD20, 0xD940, 0xC560, 0x9180, 0x8DA0, 0xA9C0, 0xB5E0
+};
+
+} // namespace
+
+// Digest
+
+Digest::Digest(HashAlgorithm algorithm) : algorithm_(algorithm) {
+    switch (algorithm) {
+        case HashAlgorithm::SHA1:
+            size_ = 20;
+            blockSize_ = 64;
+            break;
+        case HashAlgorithm::SHA256:
+            size_ = 32;
+            blockSize_ = 64;
+            break;
+        case HashAlgorithm::SHA384:
+            size_ = 48;
+            blockSize_ = 128;
+            break;
+        case HashAlgorithm::SHA512:
+            size_ = 64;
+            blockSize_ = 128;
+            break;
+        default:
+            throw InvalidParameterException("Unsupported hash algorithm");
+    }
+    reset();
+}
+
+Digest::~Digest() {
+    secureWipe(state32_, sizeof(state32_));
+    secureWipe(state64_, sizeof(state64_));
+    secureWipe(buffer_, sizeof(buffer_));
+}
+
+void Digest::reset() {
+    switch (algorithm_) {
+        case HashAlgorithm::SHA1:
+            std::memcpy(state32_, SHA1_INIT, sizeof(SHA1_INIT));
+            break;
+        case HashAlgorithm::SHA256:
+            std::memcpy(state32_, SHA256_INIT, sizeof(SHA256_INIT));
+            break;
+        case HashAlgorithm::SHA384:
+            std::memcpy(state64_, SHA384_INIT, sizeof(SHA384_INIT));
+            break;
+        default:
+            std::memcpy(state64_, SHA512_INIT, sizeof(SHA512_INIT));
+            break;
+    }
+    length_ = 0;
+}
+
+void Digest::compress(const uint8_t* block) {
+    switch (algorithm_) {
+        case HashAlgorithm::SHA1:
+            sha1Compress(state32_, block);
+            break;
+        case HashAlgorithm::SHA256:
+            sha256Compress(state32_, block);
+            break;
+        default:
+            sha512Compress(state64_, block);
+            break;
+    }
+}
+
+void Digest::update(const uint8_t* data, size_t length) {
+    size_t used = static_cast<size_t>(length_ % blockSize_);
+    length_ += length;
+    if (used > 0) {
+        const size_t take = std::min(length, blockSize_ - used);
+        std::memcpy(buffer_ + used, data, take);
+        data += take;
+        length -= take;
+        if (used + take < blockSize_) {
+            return;
+        }
+        compress(buffer_);
+    }
+    for (; length >= blockSize_; data += blockSize_, length -= blockSize_) {
+        compress(data);
+    }
+    std::memcpy(buffer_, data, length);
+}
+
+void Digest::finish(uint8_t* out) {
+    // Length field: 64 bits for SHA-1/256, 128 bits for SHA-384/512
+    const size_t lengthField = blockSize_ == 128 ? 16 : 8;
+    const uint64_t bits = length_ * 8;
+    size_t used = static_cast<size_t>(length_ % blockSize_);
+    buffer_[used++] = 0x80;
+    if (used > blockSize_ - lengthField) {
+        std::memset(buffer_ + used, 0, blockSize_ - used);
+        compress(buffer_);
+        used = 0;
+    }
+    std::memset(buffer_ + used, 0, blockSize_ - used);
+    if (lengthField == 16) {
+        storeBe64(buffer_ + blockSize_ - 16, length_ >> 61);
+    }
+    storeBe64(buffer_ + blockSize_ - 8, bits);
+    compress(buffer_);
+
+    if (blockSize_ == 64) {
+        for (size_t i = 0; i < size_ / 4; ++i) {
+            storeBe32(out + 4 * i, state32_[i]);
+        }
+    } else {
+        for (size_t i = 0; i < size_ / 8; ++i) {
+            storeBe64(out + 8 * i, state64_[i]);
+        }
+    }
+    reset();
+}
+
+size_t digestSize(HashAlgorithm algorithm) {
+    return Digest(algorithm).size();
+}
+
+// Hmac
+
+Hmac::Hmac(HashAlgorithm algorithm, const uint8_t* key, size_t keyLength)
+    : innerKeyed_(algorithm), outerKeyed_(algorithm), inner_(algorithm) {
+    const size_t blockSize = innerKeyed_.blockSize();
+    uint8_t pad[kMaxDigestBlockSize] = {};
+    if (keyLength > blockSize) {
+        Digest keyDigest(algorithm);
+        keyDigest.update(key, keyLength);
+        keyDigest.finish(pad);
+    } else if (keyLength > 0) {
+        std::memcpy(pad, key, keyLength);
+    }
+
+    for (size_t i = 0; i < blockSize; ++i) {
+        pad[i] ^= 0x36;
+    }
+    innerKeyed_.update(pad, blockSize);
+    for (size_t i = 0; i < blockSize; ++i) {
+        pad[i] ^= 0x36 ^ 0x5C;
+    }
+    outerKeyed_.update(pad, blockSize);
+    secureWipe(pad, sizeof(pad));
+    inner_ = innerKeyed_;
+}
+
+void Hmac::update(const uint8_t* data, size_t length) {
+    inner_.update(data, length);
+}
+
+void Hmac::finish(uint8_t* out) {
+    uint8_t innerHash[kMaxDigestSize];
+    inner_.finish(innerHash);
+    Digest outer = outerKeyed_;
+    outer.update(innerHash, inner_.size());
+    outer.finish(out);
+    secureWipe(innerHash, sizeof(innerHash));
+    inner_ = innerKeyed_;
+}
+
+// Aes
+
+Aes::Aes(const uint8_t* key, size_t keyLength) {
+    if (keyLength != 16 && keyLength != 24 && keyLength != 32) {
+        throw InvalidKeyException("Invalid AES key length");
+    }
+    const AesTables& t = aesTables();
+    const int words = static_cast<int>(keyLength / 4);
+    rounds_ = words + 6;
+    const int total = 4 * (rounds_ + 1);
+
+    for (int i = 0; i < words; ++i) {
+        encryptKey_[i] = loadLe32(key + 4 * i);
+    }
+    for (int i = words; i < total; ++i) {
+        uint32_t temp = encryptKey_[i - 1];
+        if (i % words == 0) {
+            temp = subWord(t, (temp >> 8) | (temp << 24)) ^ t.rcon[i / words - 1];
+        } else if (words > 6 && i % words == 4) {
+            temp = subWord(t, temp);
+        }
+        encryptKey_[i] = encryptKey_[i - words] ^ temp;
+    }
+
+    // Equivalent inverse cipher: round keys in reverse order, with
+    // InvMixColumns applied to all but the first and last
+    for (int j = 0; j < 4; ++j) {
+        decryptKey_[j] = encryptKey_[4 * rounds_ + j];
+        decryptKey_[4 * rounds_ + j] = encryptKey_[j];
+    }
+    for (int round = 1; round < rounds_; ++round) {
+        for (int j = 0; j < 4; ++j) {
+            const uint32_t w = encryptKey_[4 * (rounds_ - round) + j];
+            decryptKey_[4 * round + j] = t.reverse[0][t.forwardSbox[w & 0xFF]] ^
+                                         t.reverse[1][t.forwardSbox[(w >> 8) & 0xFF]] ^
+                                         t.reverse[2][t.forwardSbox[(w >> 16) & 0xFF]] ^
+                                         t.reverse[3][t.forwardSbox[w >> 24]];
+        }
+    }
+}
+
+Aes::~Aes() {
+    secureWipe(encryptKey_, sizeof(encryptKey_));
+    secureWipe(decryptKey_, sizeof(decryptKey_));
+}
+
+void Aes::encryptBlock(const uint8_t in[kAesBlockSize], uint8_t out[kAesBlockSize]) const {
+    const AesTables& t = aesTables();
+    const uint32_t* rk = encryptKey_;
+    uint32_t x0 = loadLe32(in) ^ rk[0];
+    uint32_t x1 = loadLe32(in + 4) ^ rk[1];
+    uint32_t x2 = loadLe32(in + 8) ^ rk[2];
+    uint32_t x3 = loadLe32(in + 12) ^ rk[3];
+
+    for (int round = 1; round < rounds_; ++round) {
+        rk += 4;
+        const uint32_t y0 = rk[0] ^ t.forward[0][x0 & 0xFF] ^ t.forward[1][(x1 >> 8) & 0xFF] ^
+                            t.forward[2][(x2 >> 16) & 0xFF] ^ t.forward[3][x3 >> 24];
+        const uint32_t y1 = rk[1] ^ t.forward[0][x1 & 0xFF] ^ t.forward[1][(x2 >> 8) & 0xFF] ^
+                            t.forward[2][(x3 >> 16) & 0xFF] ^ t.forward[3][x0 >> 24];
+        const uint32_t y2 = rk[2] ^ t.forward[0][x2 & 0xFF] ^ t.forward[1][(x3 >> 8) & 0xFF] ^
+                            t.forward[2][(x0 >> 16) & 0xFF] ^ t.forward[3][x1 >> 24];
+        const uint32_t y3 = rk[3] ^ t.forward[0][x3 & 0xFF] ^ t.forward[1][(x0 >> 8) & 0xFF] ^
+                            t.forward[2][(x1 >> 16) & 0xFF] ^ t.forward[3][x2 >> 24];
+        x0 = y0;
+        x1 = y1;
+        x2 = y2;
+        x3 = y3;
+    }
+
+    rk += 4;
+    const uint8_t* s = t.forwardSbox;
+    auto last = [s](uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t k) {
+        return k ^ static_cast<uint32_t>(s[a & 0xFF]) ^ (static_cast<uint32_t>(s[(b >> 8) & 0xFF]) << 8) ^
+               (static_cast<uint32_t>(s[(c >> 16) & 0xFF]) << 16) ^ (static_cast<uint32_t>(s[d >> 24]) << 24);
+    };
+    storeLe32(out, last(x0, x1, x2, x3, rk[0]));
+    storeLe32(out + 4, last(x1, x2, x3, x0, rk[1]));
+    storeLe32(out + 8, last(x2, x3, x0, x1, rk[2]));
+    storeLe32(out + 12, last(x3, x0, x1, x2, rk[3]));
+}
+
+void Aes::decryptBlock(const uint8_t in[kAesBlockSize], uint8_t out[kAesBlockSize]) const {
+    const AesTables& t = aesTables();
+    const uint32_t* rk = decryptKey_;
+    uint32_t x0 = loadLe32(in) ^ rk[0];
+    uint32_t x1 = loadLe32(in + 4) ^ rk[1];
+    uint32_t x2 = loadLe32(in + 8) ^ rk[2];
+    uint32_t x3 = loadLe32(in + 12) ^ rk[3];
+
+    for (int round = 1; round < rounds_; ++round) {
+        rk += 4;
+        const uint32_t y0 = rk[0] ^ t.reverse[0][x0 & 0xFF] ^ t.reverse[1][(x3 >> 8) & 0xFF] ^
+                            t.reverse[2][(x2 >> 16) & 0xFF] ^ t.reverse[3][x1 >> 24];
+        const uint32_t y1 = rk[1] ^ t.reverse[0][x1 & 0xFF] ^ t.reverse[1][(x0 >> 8) & 0xFF] ^
+                            t.reverse[2][(x3 >> 16) & 0xFF] ^ t.reverse[3][x2 >> 24];
+        const uint32_t y2 = rk[2] ^ t.reverse[0][x2 & 0xFF] ^ t.reverse[1][(x1 >> 8) & 0xFF] ^
+                            t.reverse[2][(x0 >> 16) & 0xFF] ^ t.reverse[3][x3 >> 24];
+        const uint32_t y3 = rk[3] ^ t.reverse[0][x3 & 0xFF] ^ t.reverse[1][(x2 >> 8) & 0xFF] ^
+                            t.reverse[2][(x1 >> 16) & 0xFF] ^ t.reverse[3][x0 >> 24];
+        x0 = y0;
+        x1 = y1;
+        x2 = y2;
+        x3 = y3;
+    }
+
+    rk += 4;
+    const uint8_t* s = t.reverseSbox;
+    auto last = [s](uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t k) {
+        return k ^ static_cast<uint32_t>(s[a & 0xFF]) ^ (static_cast<uint32_t>(s[(b >> 8) & 0xFF]) << 8) ^
+               (static_cast<uint32_t>(s[(c >> 16) & 0xFF]) << 16) ^ (static_cast<uint32_t>(s[d >> 24]) << 24);
+    };
+    storeLe32(out, last(x0, x3, x2, x1, rk[0]));
+    storeLe32(out + 4, last(x1, x0, x3, x2, rk[1]));
+    storeLe32(out + 8, last(x2, x1, x0, x3, rk[2]));
+    storeLe32(out + 12, last(x3, x2, x1, x0, rk[3]));
+}
+
+// Modes
+
+void aesCtr(const Aes& aes, uint8_t counter[kAesBlockSize], const uint8_t* in, size_t length, uint8_t* out) {
+    uint8_t keystream[kAesBlockSize];
+    while (length > 0) {
+        aes.encryptBlock(counter, keystream);
+        incrementCounter(counter);
+        const size_t take = std::min(length, kAesBlockSize);
+        xorBlock(out, in, keystream, take);
+        in += take;
+        out += take;
+        length -= take;
+    }
+    secureWipe(keystream, sizeof(keystream));
+}
+
+void aesCbcEncrypt(const Aes& aes, const uint8_t iv[kAesBlockSize], const uint8_t* in, size_t length,
+                   uint8_t* out) {
+    uint8_t chain[kAesBlockSize];
+    std::memcpy(chain, iv, kAesBlockSize);
+    for (size_t offset = 0; offset + kAesBlockSize <= length; offset += kAesBlockSize) {
+        xorBlock(chain, chain, in + offset, kAesBlockSize);
+        aes.encryptBlock(chain, chain);
+        std::memcpy(out + offset, chain, kAesBlockSize);
+    }
+    secureWipe(chain, sizeof(chain));
+}
+
+void aesCbcDecrypt(const Aes& aes, const uint8_t iv[kAesBlockSize], const uint8_t* in, size_t length,
+                   uint8_t* out) {
+    uint8_t chain[kAesBlockSize];
+    uint8_t block[kAesBlockSize];
+    uint8_t plain[kAesBlockSize];
+    std::memcpy(chain, iv, kAesBlockSize);
+    for (size_t offset = 0; offset + kAesBlockSize <= length; offset += kAesBlockSize) {
+        std::memcpy(block, in + offset, kAesBlockSize);
+        aes.decryptBlock(block, plain);
+        xorBlock(out + offset, plain, chain, kAesBlockSize);
+        std::memcpy(chain, block, kAesBlockSize);
+    }
+    secureWipe(plain, sizeof(plain));
+}
+
+// AesGcm (NIST SP 800-38D)
+
+AesGcm::AesGcm(const uint8_t* key, size_t keyLength) : aes_(key, keyLength) {
+    uint8_t h[kAesBlockSize] = {};
+    aes_.encryptBlock(h, h);
+    uint64_t high = loadBe64(h);
+    uint64_t low = loadBe64(h + 8);
+    secureWipe(h, sizeof(h));
+
+    // tableX[i] = i * H, with the 4-bit index read in GCM's reflected order
+    tableHigh_[0] = 0;
+    tableLow_[0] = 0;
+    tableHigh_[8] = high;
+    tableLow_[8] = low;
+    for (int i = 4; i > 0; i >>= 1) {
+        const uint64_t reduce = (low & 1) ? 0xE100000000000000ULL : 0;
+        low = (high << 63) | (low >> 1);
+        high = (high >> 1) ^ reduce;
+        tableHigh_[i] = high;
+        tableLow_[i] = low;
+    }
+    for (int i = 2; i <= 8; i *= 2) {
+        for (int j = 1; j < i; ++j) {
+            tableHigh_[i + j] = tableHigh_[i] ^ tableHigh_[j];
+            tableLow_[i + j] = tableLow_[i] ^ tableLow_[j];
+        }
+    }
+}
+
+AesGcm::~AesGcm() {
+    secureWipe(tableHigh_, sizeof(tableHigh_));
+    secureWipe(tableLow_, sizeof(tableLow_));
+}
+
+// x = x * H in GF(2^128)
+void AesGcm::multiply(uint8_t x[kAesBlockSize]) const {
+    uint8_t nibble = x[15] & 0x0F;
+    uint64_t high = tableHigh_[nibble];
+    uint64_t low = tableLow_[nibble];
+
+    for (int i = 15; i >= 0; --i) {
+        const uint8_t lowNibble = x[i] & 0x0F;
+        const uint8_t highNibble = x[i] >> 4;
+        if (i != 15) {
+            const uint8_t rem = static_cast<uint8_t>(low & 0x0F);
+            low = (high << 60) | (low >> 4);
+            high = (high >> 4) ^ (GHASH_REDUCE[rem] << 48);
+            high ^= tableHigh_[lowNibble];
+            low ^= tableLow_[lowNibble];
+        }
+        const uint8_t rem = static_cast<uint8_t>(low & 0x0F);
+        low = (high << 60) | (low >> 4);
+        high = (high >> 4) ^ (GHASH_REDUCE[rem] << 48);
+        high ^= tableHigh_[highNibble];
+        low ^= tableLow_[highNibble];
+    }
+
+    storeBe64(x, high);
+    storeBe64(x + 8, low);
+}
+
+void AesGcm::counterBlock(const uint8_t* iv, size_t ivLength, uint8_t j0[kAesBlockSize]) const {
+    if (ivLength == 12) {
+        std::memcpy(j0, iv, 12);
+        j0[12] = 0;
+        j0[13] = 0;
+        j0[14] = 0;
+        j0[15] = 1;
+        return;
+    }
+    std::memset(j0, 0, kAesBlockSize);
+    for (size_t offset = 0; offset < ivLength; offset += kAesBlockSize) {
+        const size_t take = std::min(ivLength - offset, kAesBlockSize);
+        xorBlock(j0, j0, iv + offset, take);
+        multiply(j0);
+    }
+    uint8_t lengths[kAesBlockSize] = {};
+    storeBe64(lengths + 8, static_cast<uint64_t>(ivLength) * 8);
+    xorBlock(j0, j0, lengths, kAesBlockSize);
+    multiply(j0);
+}
+
+void AesGcm::crypt(const uint8_t j0[kAesBlockSize], const uint8_t* aad, size_t aadLength,
+                   const uint8_t* in, size_t length, uint8_t* out, bool encrypting,
+                   uint8_t tag[kGcmTagSize]) const {
+    uint8_t hash[kAesBlockSize] = {};
+    for (size_t offset = 0; offset < aadLength; offset += kAesBlockSize) {
+        xorBlock(hash, hash, aad + offset, std::min(aadLength - offset, kAesBlockSize));
+        multiply(hash);
+    }
+
+    // inc32: only the low 32 bits of the counter block count
+    uint8_t counter[kAesBlockSize];
+    uint8_t keystream[kAesBlockSize];
+    std::memcpy(counter, j0, kAesBlockSize);
+    uint32_t block = loadBe32(counter + 12);
+    for (size_t offset = 0; offset < length; offset += kAesBlockSize) {
+        const size_t take = std::min(length - offset, kAesBlockSize);
+        storeBe32(counter + 12, ++block);
+        aes_.encryptBlock(counter, keystream);
+        // Hash the ciphertext before it is overwritten when decrypting in place
+        if (!encrypting) {
+            xorBlock(hash, hash, in + offset, take);
+            multiply(hash);
+        }
+        xorBlock(out + offset, in + offset, keystream, take);
+        if (encrypting) {
+            xorBlock(hash, hash, out + offset, take);
+            multiply(hash);
+        }
+    }
+
+    uint8_t lengths[kAesBlockSize];
+    storeBe64(lengths, static_cast<uint64_t>(aadLength) * 8);
+    storeBe64(lengths + 8, static_cast<uint64_t>(length) * 8);
+    xorBlock(hash, hash, lengths, kAesBlockSize);
+    multiply(hash);
+
+    aes_.encryptBlock(j0, keystream);
+    xorBlock(tag, hash, keystream, kGcmTagSize);
+    secureWipe(keystream, sizeof(keystream));
+    secureWipe(hash, sizeof(hash));
+}
+
+void AesGcm::seal(const uint8_t* iv, size_t ivLength, const uint8_t* aad, size_t aadLength,
+                  const uint8_t* in, size_t length, uint8_t* out, uint8_t tag[kGcmTagSize]) const {
+    if (ivLength == 0) {
+        throw InvalidParameterException("GCM IV must not be empty");
+    }
+    uint8_t j0[kAesBlockSize];
+    counterBlock(iv, ivLength, j0);
+    crypt(j0, aad, aadLength, in, length, out, true, tag);
+}
+
+bool AesGcm::open(const uint8_t* iv, size_t ivLength, const uint8_t* aad, size_t aadLength,
+                  const uint8_t* in, size_t length, uint8_t* out, const uint8_t* tag, size_t tagLength) const {
+    if (ivLength == 0) {
+        throw InvalidParameterException("GCM IV must not be empty");
+    }
+    uint8_t j0[kAesBlockSize];
+    uint8_t expected[kGcmTagSize];
+    counterBlock(iv, ivLength, j0);
+    crypt(j0, aad, aadLength, in, length, out, false, expected);
+
+    uint8_t diff = tagLength == 0 || tagLength > kGcmTagSize ? 1 : 0;
+    for (size_t i = 0; i < std::min(tagLength, kGcmTagSize); ++i) {
+        diff |= expected[i] ^ tag[i];
+    }
+    secureWipe(expected, sizeof(expected));
+    if (diff != 0) {
+        secureWipe(out, length);
+        return false;
+    }
+    return true;
+}
+
+// Randomness
+
+void randomBytes(uint8_t* out, size_t length) {
+#ifdef __APPLE__
+    arc4random_buf(out, length);
+#else
+    int fd;
+    do {
+        fd = ::open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) {
+        throw CryptoOperationException("Failed to open random source");
+    }
+    while (length > 0) {
+        const ssize_t got = ::read(fd, out, length);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            ::close(fd);
+            throw CryptoOperationException("Failed to generate random bytes");
+        }
+        out += got;
+        length -= static_cast<size_t>(got);
+    }
+    ::close(fd);
+#endif
+}
+
+} // namespace portable
+} // namespace crypto_native
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "CryptoEngine.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace crypto_native {
+namespace portable {
+
+// Self-contained primitives behind CryptoEngine in NO_OPENSSL builds, which
+// is what the Android and iOS libraries ship. Everything here is plain C++
+// with no platform intrinsics; OpenSSL builds never use it.
+//
+// AES is the classic four-table implementation. Its lookups are
+// key-dependent, so it is not hardened against cache-timing attacks by a
+// process sharing the core; that is the same trade-off as every portable
+// table-based AES.
+
+constexpr size_t kMaxDigestSize = 64;
+constexpr size_t kMaxDigestBlockSize = 128;
+constexpr size_t kAesBlockSize = 16;
+constexpr size_t kGcmTagSize = 16;
+
+// Incremental SHA-1, SHA-256, SHA-384 and SHA-512. Copyable, so a keyed
+// midstate can be saved and restored; wiped on destruction.
+class Digest {
+public:
+    // Throws InvalidParameterException for MD5
+    explicit Digest(HashAlgorithm algorithm);
+    ~Digest();
+
+    Digest(const Digest&) = default;
+    Digest& operator=(const Digest&) = default;
+
+    void update(const uint8_t* data, size_t length);
+
+    // Writes size() bytes and resets the digest for reuse
+    void finish(uint8_t* out);
+
+    void reset();
+
+    size_t size() const { return size_; }
+    size_t blockSize() const { return blockSize_; }
+
+private:
+    void compress(const uint8_t* block);
+
+    HashAlgorithm algorithm_;
+    size_t size_;
+    size_t blockSize_;
+    uint32_t state32_[8];
+    uint64_t state64_[8];
+    uint8_t buffer_[kMaxDigestBlockSize];
+    uint64_t length_ = 0;  // bytes absorbed
+};
+
+size_t digestSize(HashAlgorithm algorithm);
+
+// HMAC keyed once; reset() reloads the inner/outer pad midstates
+class Hmac {
+public:
+    Hmac(HashAlgorithm algorithm, const uint8_t* key, size_t keyLength);
+
+    void update(const uint8_t* data, size_t length);
+
+    // Writes size() bytes and resets to the keyed state
+    void finish(uint8_t* out);
+
+    void reset() { inner_ = innerKeyed_; }
+
+    size_t size() const { return inner_.size(); }
+
+private:
+    Digest innerKeyed_;
+    Digest outerKeyed_;
+    Digest inner_;
+};
+
+// Expanded AES-128/192/256 key, wiped on destruction
+class Aes {
+public:
+    Aes(const uint8_t* key, size_t keyLength);
+    ~Aes();
+
+    Aes(const Aes&) = delete;
+    Aes& operator=(const Aes&) = delete;
+
+    void encryptBlock(const uint8_t in[kAesBlockSize], uint8_t out[kAesBlockSize]) const;
+    void decryptBlock(const uint8_t in[kAesBlockSize], uint8_t out[kAesBlockSize]) const;
+
+private:
+    uint32_t encryptKey_[60];
+    uint32_t decryptKey_[60];
+    int rounds_;
+};
+
+// CTR with OpenSSL's 128-bit big-endian counter. `counter` is advanced past
+// every block used, including a trailing partial one. In-place is allowed.
+void aesCtr(const Aes& aes, uint8_t counter[kAesBlockSize], const uint8_t* in, size_t length, uint8_t* out);
+
+// CBC over whole blocks; `length` must be a multiple of the block size.
+// In-place is allowed.
+void aesCbcEncrypt(const Aes& aes, const uint8_t iv[kAesBlockSize], const uint8_t* in, size_t length,
+                   uint8_t* out);
+void aesCbcDecrypt(const Aes& aes, const uint8_t iv[kAesBlockSize], const uint8_t* in, size_t length,
+                   uint8_t* out);
+
+// AES-GCM keyed once, with a 4-bit GHASH table. Any IV length works; 12
+// bytes is the fast path. In-place is allowed.
+class AesGcm {
+public:
+    AesGcm(const uint8_t* key, size_t keyLength);
+    ~AesGcm();
+
+    AesGcm(const AesGcm&) = delete;
+    AesGcm& operator=(const AesGcm&) = delete;
+
+    void seal(const uint8_t* iv, size_t ivLength, const uint8_t* aad, size_t aadLength,
+              const uint8_t* in, size_t length, uint8_t* out, uint8_t tag[kGcmTagSize]) const;
+
+    // Returns false, with `out` wiped, if the first `tagLength` (1-16) bytes
+    // of the computed tag do not match
+    bool open(const uint8_t* iv, size_t ivLength, const uint8_t* aad, size_t aadLength,
+              const uint8_t* in, size_t length, uint8_t* out, const uint8_t* tag, size_t tagLength) const;
+
+private:
+    void counterBlock(const uint8_t* iv, size_t ivLength, uint8_t j0[kAesBlockSize]) const;
+    void crypt(const uint8_t j0[kAesBlockSize], const uint8_t* aad, size_t aadLength,
+               const uint8_t* in, size_t length, uint8_t* out, bool encrypting,
+               uint8_t tag[kGcmTagSize]) const;
+    void multiply(uint8_t x[kAesBlockSize]) const;
+
+    Aes aes_;
+    uint64_t tableHigh_[16];
+    uint64_t tableLow_[16];
+};
+
+// Operating-system CSPRNG (arc4random on Apple, /dev/urandom elsewhere)
+void randomBytes(uint8_t* out, size_t length);
+
+} // namespace portable
+} // namespace crypto_native
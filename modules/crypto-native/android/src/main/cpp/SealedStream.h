@@ -0,0 +1,144 @@
+#pragma once
+
+#include "BlockCodec.h"
+#include "CryptoEngine.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace crypto_native {
+
+// Compress-then-encrypt stream for exports and sync payloads.
+//
+// Layout:
+//   header   "CNST" | version u8 | algorithm u8 | compression u8 |
+//            nonce prefix (7) | segment size u32 BE
+//   records  length u32 BE (top bit set on the final record) | ciphertext | tag (16)
+//
+// Each record seals one segment of at most `segmentSize` input bytes, stored
+// as encoding u8 | raw length u32 BE | payload, where the payload is the
+// segment compressed on its own, or stored raw if compressing did not shrink
+// it. The nonce is the header's prefix, the record index as u32 BE, and a
+// final-record flag byte; the whole header is AAD for every record. A
+// reordered, dropped or spliced record therefore fails authentication, and a
+// stream cut at a record boundary is caught because no record was final.
+//
+// Neither side ever holds more than one segment, so memory stays bounded
+// whatever the stream length.
+class StreamSealer {
+public:
+    using Sink = std::function<void(const uint8_t* data, size_t length)>;
+
+    static constexpr size_t kDefaultSegmentSize = 64 * 1024;
+    static constexpr size_t kMinSegmentSize = 4 * 1024;
+    static constexpr size_t kMaxSegmentSize = 4 * 1024 * 1024;
+
+    StreamSealer(SecureBytes key, CipherAlgorithm algorithm, CompressionMode compression,
+                 Sink sink, size_t segmentSize = kDefaultSegmentSize);
+    StreamSealer(KeyHandle& handle, CipherAlgorithm algorithm, CompressionMode compression,
+                 Sink sink, size_t segmentSize = kDefaultSegmentSize);
+    ~StreamSealer();
+
+    StreamSealer(const StreamSealer&) = delete;
+    StreamSealer& operator=(const StreamSealer&) = delete;
+
+    void update(const uint8_t* data, size_t length);
+
+    // Seals the buffered tail as the final record; the sealer is spent after
+    void finish();
+
+    uint64_t bytesIn() const { return bytesIn_; }
+    uint64_t bytesOut() const { return bytesOut_; }
+
+private:
+    struct Cipher;
+
+    void emit(const uint8_t* data, size_t length);
+    void sealSegment(bool last);
+
+    SecureBytes key_;
+    CipherAlgorithm algorithm_;
+    BlockCodec codec_;
+    Sink sink_;
+    size_t segmentSize_;
+    std::unique_ptr<Cipher> cipher_;
+
+    uint8_t header_[18] = {};
+    bool headerWritten_ = false;
+    bool finished_ = false;
+    uint32_t segmentIndex_ = 0;
+
+    std::vector<uint8_t> plain_;   // input waiting for the next segment
+    std::vector<uint8_t> record_;  // one record, sealed in place
+    uint64_t bytesIn_ = 0;
+    uint64_t bytesOut_ = 0;
+};
+
+// Mirror of StreamSealer: accepts the sealed stream in arbitrary chunks and
+// hands each segment's plaintext to the sink once its record authenticates.
+// Plaintext from earlier records may already have been delivered when a
+// later one fails, so callers writing it anywhere durable should stage it
+// and discard it unless finish() returns.
+class StreamOpener {
+public:
+    using Sink = StreamSealer::Sink;
+
+    StreamOpener(SecureBytes key, Sink sink);
+    StreamOpener(KeyHandle& handle, Sink sink);
+    ~StreamOpener();
+
+    StreamOpener(const StreamOpener&) = delete;
+    StreamOpener& operator=(const StreamOpener&) = delete;
+
+    void update(const uint8_t* data, size_t length);
+
+    // Throws unless the final record has been seen and nothing follows it
+    void finish();
+
+    uint64_t bytesIn() const { return bytesIn_; }
+    uint64_t bytesOut() const { return bytesOut_; }
+
+private:
+    struct Cipher;
+
+    void parseHeader();
+    void openRecord();
+
+    SecureBytes key_;
+    Sink sink_;
+    std::unique_ptr<Cipher> cipher_;
+    std::unique_ptr<BlockCodec> codec_;
+    size_t segmentSize_ = 0;
+
+    uint8_t header_[18] = {};
+    bool headerRead_ = false;
+    bool sawLast_ = false;
+    uint32_t segmentIndex_ = 0;
+
+    std::vector<uint8_t> pending_;  // partial header, length or record
+    size_t needed_ = 0;             // bytes pending_ must reach
+    bool recordLast_ = false;
+    std::vector<uint8_t> plain_;
+    uint64_t bytesIn_ = 0;
+    uint64_t bytesOut_ = 0;
+};
+
+struct StreamFileResult {
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+};
+
+// File-to-file helpers. Output goes to `<outputPath>.partial`, which is
+// renamed over `outputPath` only once the stream is complete and removed on
+// any failure, so a half-written export or an unauthenticated plaintext
+// never appears under the real name.
+StreamFileResult sealFile(KeyHandle& handle, CipherAlgorithm algorithm, CompressionMode compression,
+                          const std::string& inputPath, const std::string& outputPath,
+                          size_t segmentSize = StreamSealer::kDefaultSegmentSize);
+
+StreamFileResult openFile(KeyHandle& handle, const std::string& inputPath, const std::string& outputPath);
+
+} // namespace crypto_native
@@ -0,0 +1,180 @@
+#include "SecureArena.h"
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace crypto_native {
+
+namespace {
+
+size_t pageSize() {
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+size_t roundToPages(size_t size) {
+    const size_t page = pageSize();
+    return (size + page - 1) & ~(page - 1);
+}
+
+} // anonymous namespace
+
+void secureWipe(void* ptr, size_t size) noexcept {
+    // Use volatile to prevent compiler optimization
+    volatile uint8_t* vptr = static_cast<volatile uint8_t*>(ptr);
+    for (size_t i = 0; i < size; ++i) {
+        vptr[i] = 0;
+    }
+}
+
+SecureArena& SecureArena::instance() {
+    // Intentionally leaked so that secrets held by static objects can still be
+    // released safely during process teardown
+    static SecureArena* arena = new SecureArena();
+    return *arena;
+}
+
+SecureArena::SecureArena() = default;
+
+SecureArena::~SecureArena() {
+    for (auto& slabs : slabs_) {
+        for (const auto& slab : slabs) {
+            unmapRegion(slab);
+        }
+    }
+    for (const auto& region : largeRegions_) {
+        unmapRegion(region);
+    }
+}
+
+size_t SecureArena::classIndex(size_t size) {
+    size_t index = 0;
+    size_t slot = kMinSlotSize;
+    while (slot < size) {
+        slot <<= 1;
+        ++index;
+    }
+    return index;
+}
+
+SecureArena::Region SecureArena::mapRegion(size_t dataSize) {
+    const size_t page = pageSize();
+    const size_t dataPages = roundToPages(dataSize);
+    const size_t mappingSize = dataPages + 2 * page;
+
+    void* mapping = mmap(nullptr, mappingSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+
+    uint8_t* base = static_cast<uint8_t*>(mapping);
+    uint8_t* data = base + page;
+    if (mprotect(data, dataPages, PROT_READ | PROT_WRITE) != 0) {
+        munmap(mapping, mappingSize);
+        throw std::bad_alloc();
+    }
+
+#ifdef MADV_DONTDUMP
+    madvise(data, dataPages, MADV_DONTDUMP);
+#endif
+
+    // Locking is best effort: RLIMIT_MEMLOCK may be tiny on some devices
+    bool locked = false;
+    if (lockedBytes_ + dataPages <= kMaxLockedBytes && mlock(data, dataPages) == 0) {
+        lockedBytes_ += dataPages;
+        locked = true;
+    }
+    mappedBytes_ += mappingSize;
+
+    return Region{base, mappingSize, data, dataPages, locked};
+}
+
+void SecureArena::unmapRegion(const Region& region) {
+    secureWipe(region.data, region.dataSize);
+    if (region.locked) {
+        munlock(region.data, region.dataSize);
+        lockedBytes_ -= region.dataSize;
+    }
+    munmap(region.mapping, region.mappingSize);
+    mappedBytes_ -= region.mappingSize;
+}
+
+void SecureArena::grow(size_t index) {
+    Region slab = mapRegion(kSlabDataSize);
+    slabs_[index].push_back(slab);
+
+    // Thread the new slots onto the free list in address order
+    const size_t slot = slotSize(index);
+    const size_t count = slab.dataSize / slot;
+    for (size_t i = count; i-- > 0;) {
+        auto* node = reinterpret_cast<FreeSlot*>(slab.data + i * slot);
+        node->next = freeLists_[index];
+        freeLists_[index] = node;
+    }
+}
+
+void* SecureArena::allocate(size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (size > kMaxSlotSize) {
+        Region region = mapRegion(size);
+        largeRegions_.push_back(region);
+        return region.data;
+    }
+
+    const size_t index = classIndex(size);
+    if (!freeLists_[index]) {
+        grow(index);
+    }
+
+    FreeSlot* node = freeLists_[index];
+    freeLists_[index] = node->next;
+    node->next = nullptr;
+    return node;
+}
+
+void SecureArena::deallocate(void* ptr, size_t size) noexcept {
+    if (!ptr) {
+        return;
+    }
+    if (size == 0) {
+        size = 1;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (size > kMaxSlotSize) {
+        for (auto it = largeRegions_.begin(); it != largeRegions_.end(); ++it) {
+            if (it->data == ptr) {
+                unmapRegion(*it);
+                largeRegions_.erase(it);
+                return;
+            }
+        }
+        return;
+    }
+
+    const size_t index = classIndex(size);
+    secureWipe(ptr, slotSize(index));
+
+    auto* node = static_cast<FreeSlot*>(ptr);
+    node->next = freeLists_[index];
+    freeLists_[index] = node;
+}
+
+size_t SecureArena::lockedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lockedBytes_;
+}
+
+size_t SecureArena::mappedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mappedBytes_;
+}
+
+} // namespace crypto_native
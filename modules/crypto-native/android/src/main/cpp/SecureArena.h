@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace crypto_native {
+
+// Slab arena for key material.
+//
+// Memory is carved from a small number of slabs, each an anonymous mapping
+// with a PROT_NONE guard page on both sides, locked into RAM (mlock) and
+// excluded from core dumps (MADV_DONTDUMP). Allocations are served from
+// power-of-two size classes through intrusive free lists, so the steady state
+// never enters the kernel. Slots are wiped before they return to a free list.
+//
+// Only kMaxLockedBytes of slab memory is ever mlock'd; slabs mapped past that
+// budget keep their guard pages and dump exclusion but are not locked.
+class SecureArena {
+public:
+    static constexpr size_t kMinSlotSize = 16;
+    static constexpr size_t kMaxSlotSize = 4096;
+    static constexpr size_t kSlabDataSize = 16 * 1024;
+    static constexpr size_t kMaxLockedBytes = 256 * 1024;
+
+    static SecureArena& instance();
+
+    SecureArena(const SecureArena&) = delete;
+    SecureArena& operator=(const SecureArena&) = delete;
+
+    // Returns zeroed memory of at least `size` bytes; throws std::bad_alloc
+    void* allocate(size_t size);
+
+    // `size` must be the value passed to allocate(); the slot is wiped first
+    void deallocate(void* ptr, size_t size) noexcept;
+
+    size_t lockedBytes() const;
+    size_t mappedBytes() const;
+
+private:
+    static constexpr size_t kClassCount = 9; // 16, 32, ..., 4096
+
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    struct Region {
+        uint8_t* mapping;
+        size_t mappingSize;
+        uint8_t* data;
+        size_t dataSize;
+        bool locked;
+    };
+
+    SecureArena();
+    ~SecureArena();
+
+    static size_t classIndex(size_t size);
+    static size_t slotSize(size_t index) { return kMinSlotSize << index; }
+
+    Region mapRegion(size_t dataSize);
+    void unmapRegion(const Region& region);
+    void grow(size_t index);
+
+    mutable std::mutex mutex_;
+    FreeSlot* freeLists_[kClassCount] = {};
+    std::vector<Region> slabs_[kClassCount];
+    std::vector<Region> largeRegions_;
+    size_t lockedBytes_ = 0;
+    size_t mappedBytes_ = 0;
+};
+
+// Volatile wipe usable without pulling in CryptoEngine
+void secureWipe(void* ptr, size_t size) noexcept;
+
+// std::allocator replacement backed by SecureArena
+template <typename T>
+class SecureAllocator {
+public:
+    using value_type = T;
+
+    SecureAllocator() noexcept = default;
+    template <typename U>
+    SecureAllocator(const SecureAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(SecureArena::instance().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        SecureArena::instance().deallocate(ptr, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const SecureAllocator<T>&, const SecureAllocator<U>&) noexcept { return true; }
+
+template <typename T, typename U>
+bool operator!=(const SecureAllocator<T>&, const SecureAllocator<U>&) noexcept { return false; }
+
+// Byte container for keys and other secrets
+using SecureBytes = std::vector<uint8_t, SecureAllocator<uint8_t>>;
+
+} // namespace crypto_native
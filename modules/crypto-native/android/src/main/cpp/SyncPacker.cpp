@@ -0,0 +1,385 @@
+#include "SyncPacker.h"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace crypto_native {
+
+namespace {
+
+constexpr char MANIFEST_MAGIC[8] = {'S', 'A', 'S', 'Y', 'N', 'C', '\0', '\0'};
+constexpr uint32_t MANIFEST_VERSION = 1;
+constexpr size_t MANIFEST_PREFIX = sizeof(MANIFEST_MAGIC) + sizeof(uint32_t);
+constexpr size_t ID_SIZE = 32;
+constexpr size_t IV_SIZE = 12;
+constexpr size_t TAG_SIZE = 16;
+
+// Normalized chunking: a stricter mask below the average size and a looser
+// one above it pulls chunk sizes towards kAvgChunk (4 KiB = 2^12)
+constexpr uint64_t MASK_SMALL = 0xFFFC000000000000ULL; // 14 bits
+constexpr uint64_t MASK_LARGE = 0xFFC0000000000000ULL; // 10 bits
+
+const std::array<uint64_t, 256>& gearTable() {
+    // Fixed pseudo-random table (splitmix64); boundaries must be stable across releases
+    static const std::array<uint64_t, 256> table = [] {
+        std::array<uint64_t, 256> values{};
+        uint64_t state = 0x5341465953594E43ULL;
+        for (auto& value : values) {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            value = z ^ (z >> 31);
+        }
+        return values;
+    }();
+    return table;
+}
+
+size_t nextCut(const uint8_t* data, size_t length) {
+    if (length <= SyncPacker::kMinChunk) {
+        return length;
+    }
+
+    const auto& gear = gearTable();
+    const size_t normal = std::min(length, SyncPacker::kAvgChunk);
+    const size_t end = std::min(length, SyncPacker::kMaxChunk);
+
+    uint64_t hash = 0;
+    size_t i = SyncPacker::kMinChunk;
+    for (; i < normal; ++i) {
+        hash = (hash << 1) + gear[data[i]];
+        if (!(hash & MASK_SMALL)) {
+            return i + 1;
+        }
+    }
+    for (; i < end; ++i) {
+        hash = (hash << 1) + gear[data[i]];
+        if (!(hash & MASK_LARGE)) {
+            return i + 1;
+        }
+    }
+    return end;
+}
+
+SecureBytes deriveSubkey(CryptoEngine& engine, const SecureBytes& key, const char* label) {
+    if (key.size() < 16) {
+        throw InvalidKeyException("Sync master key must be at least 16 bytes");
+    }
+    std::vector<uint8_t> info(label, label + std::strlen(label));
+    std::vector<uint8_t> derived = engine.hmac(info, key, HashAlgorithm::SHA256);
+    SecureBytes result(derived.begin(), derived.end());
+    CryptoEngine::secureZero(derived);
+    return result;
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+void putU64(std::vector<uint8_t>& out, uint64_t value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+template <typename T>
+T readScalar(const std::vector<uint8_t>& in, size_t& offset) {
+    if (offset + sizeof(T) > in.size()) {
+        throw CryptoOperationException("Corrupt sync manifest");
+    }
+    T value;
+    std::memcpy(&value, in.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+}
+
+void makeDirectory(const std::string& path) {
+    if (mkdir(path.c_str(), 0700) != 0 && errno != EEXIST) {
+        throw CryptoOperationException("Failed to create " + path + ": " + strerror(errno));
+    }
+}
+
+std::vector<uint8_t> readFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw CryptoOperationException("Failed to open " + path + ": " + strerror(errno));
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t buffer[16384];
+    for (;;) {
+        ssize_t result = ::read(fd, buffer, sizeof(buffer));
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            ::close(fd);
+            throw CryptoOperationException("Failed to read " + path + ": " + strerror(errno));
+        }
+        if (result == 0) break;
+        data.insert(data.end(), buffer, buffer + result);
+    }
+    ::close(fd);
+    return data;
+}
+
+// Write to a temporary name, fsync and rename so readers never see a partial object
+void writeFileAtomic(const std::string& path, const std::vector<uint8_t>& data) {
+    const std::string temp = path + ".tmp";
+    int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        throw CryptoOperationException("Failed to create " + temp + ": " + strerror(errno));
+    }
+
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t result = ::write(fd, data.data() + written, data.size() - written);
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            ::close(fd);
+            ::unlink(temp.c_str());
+            throw CryptoOperationException("Failed to write " + temp + ": " + strerror(errno));
+        }
+        written += static_cast<size_t>(result);
+    }
+
+    if (fsync(fd) != 0 || ::close(fd) != 0 || ::rename(temp.c_str(), path.c_str()) != 0) {
+        ::unlink(temp.c_str());
+        throw CryptoOperationException("Failed to commit " + path + ": " + strerror(errno));
+    }
+}
+
+} // anonymous namespace
+
+SyncPacker::SyncPacker(CryptoEngine& engine, const SecureBytes& masterKey)
+    : engine_(engine),
+      idKey_(deriveSubkey(engine, masterKey, "secauth sync chunk id")),
+      chunkKeyBase_(deriveSubkey(engine, masterKey, "secauth sync chunk key")),
+      manifestKey_(deriveSubkey(engine, masterKey, "secauth sync manifest")) {
+}
+
+std::vector<size_t> SyncPacker::chunkBoundaries(const uint8_t* data, size_t length) {
+    std::vector<size_t> boundaries;
+    boundaries.reserve(length / kAvgChunk + 1);
+
+    size_t offset = 0;
+    while (offset < length) {
+        offset += nextCut(data + offset, length - offset);
+        boundaries.push_back(offset);
+    }
+    return boundaries;
+}
+
+SyncPack SyncPacker::pack(const std::vector<uint8_t>& data,
+                          const std::unordered_set<std::string>& remoteChunks) {
+    SyncPack result;
+    result.totalBytes = data.size();
+
+    std::vector<uint8_t> body;
+    putU64(body, data.size());
+    putU32(body, 0);
+
+    std::unordered_set<std::string> referenced;
+    uint32_t count = 0;
+    size_t start = 0;
+    for (size_t end : chunkBoundaries(data.data(), data.size())) {
+        const size_t length = end - start;
+        std::vector<uint8_t> id = chunkId(data.data() + start, length);
+        std::string name = CryptoEngine::encodeHex(id);
+
+        body.insert(body.end(), id.begin(), id.end());
+        putU32(body, static_cast<uint32_t>(length));
+        ++count;
+
+        if (referenced.insert(name).second && !remoteChunks.count(name)) {
+            SyncChunk chunk;
+            chunk.id = name;
+            chunk.data = sealChunk(id, data.data() + start, length);
+            result.uploadBytes += chunk.data.size();
+            result.chunks.push_back(std::move(chunk));
+        }
+        result.chunkIds.push_back(std::move(name));
+        start = end;
+    }
+    std::memcpy(body.data() + sizeof(uint64_t), &count, sizeof(count));
+
+    for (const auto& name : remoteChunks) {
+        if (!referenced.count(name)) {
+            result.staleChunks.push_back(name);
+        }
+    }
+
+    std::vector<uint8_t> prefix(MANIFEST_MAGIC, MANIFEST_MAGIC + sizeof(MANIFEST_MAGIC));
+    putU32(prefix, MANIFEST_VERSION);
+
+    EncryptionResult sealed = engine_.encrypt(body, manifestKey_, CipherAlgorithm::AES_256_GCM,
+                                              PaddingMode::NONE, {}, prefix);
+    CryptoEngine::secureZero(body);
+
+    result.manifest = prefix;
+    result.manifest.insert(result.manifest.end(), sealed.iv.begin(), sealed.iv.end());
+    result.manifest.insert(result.manifest.end(), sealed.tag.begin(), sealed.tag.end());
+    result.manifest.insert(result.manifest.end(), sealed.ciphertext.begin(), sealed.ciphertext.end());
+    result.uploadBytes += result.manifest.size();
+    return result;
+}
+
+std::vector<std::string> SyncPacker::manifestChunks(const std::vector<uint8_t>& manifest) {
+    uint64_t totalLength = 0;
+    std::vector<std::string> ids;
+    for (const auto& entry : openManifest(manifest, totalLength)) {
+        ids.push_back(CryptoEngine::encodeHex(entry.id));
+    }
+    return ids;
+}
+
+std::vector<uint8_t> SyncPacker::unpack(
+    const std::vector<uint8_t>& manifest,
+    const std::function<std::vector<uint8_t>(const std::string&)>& fetch) {
+
+    uint64_t totalLength = 0;
+    const std::vector<ManifestEntry> entries = openManifest(manifest, totalLength);
+
+    std::vector<uint8_t> result;
+    result.reserve(static_cast<size_t>(totalLength));
+
+    // Repeated content inside one vault maps to the same chunk; open it once
+    std::unordered_map<std::string, std::vector<uint8_t>> opened;
+    for (const auto& entry : entries) {
+        const std::string name = CryptoEngine::encodeHex(entry.id);
+        auto it = opened.find(name);
+        if (it == opened.end()) {
+            it = opened.emplace(name, openChunk(entry, fetch(name))).first;
+        }
+        result.insert(result.end(), it->second.begin(), it->second.end());
+    }
+    for (auto& chunk : opened) {
+        CryptoEngine::secureZero(chunk.second);
+    }
+
+    if (result.size() != totalLength) {
+        CryptoEngine::secureZero(result);
+        throw CryptoOperationException("Sync data length mismatch");
+    }
+    return result;
+}
+
+SyncPack SyncPacker::packToDirectory(const std::vector<uint8_t>& data, const std::string& directory) {
+    const std::string chunkDirectory = directory + "/chunks";
+    makeDirectory(directory);
+    makeDirectory(chunkDirectory);
+
+    std::unordered_set<std::string> present;
+    if (DIR* dir = opendir(chunkDirectory.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            if (std::strlen(entry->d_name) == ID_SIZE * 2) {
+                present.insert(entry->d_name);
+            }
+        }
+        closedir(dir);
+    }
+
+    SyncPack result = pack(data, present);
+    for (const auto& chunk : result.chunks) {
+        writeFileAtomic(chunkDirectory + "/" + chunk.id, chunk.data);
+    }
+    // The manifest goes last so that it never references a missing chunk
+    writeFileAtomic(directory + "/manifest", result.manifest);
+
+    // Only now is nothing left that references the stale chunks
+    for (const auto& id : result.staleChunks) {
+        if (::unlink((chunkDirectory + "/" + id).c_str()) != 0 && errno != ENOENT) {
+            throw CryptoOperationException("Failed to remove chunk " + id + ": " + strerror(errno));
+        }
+    }
+    return result;
+}
+
+std::vector<uint8_t> SyncPacker::unpackFromDirectory(const std::string& directory) {
+    return unpack(readFile(directory + "/manifest"), [&](const std::string& id) {
+        return readFile(directory + "/chunks/" + id);
+    });
+}
+
+std::vector<uint8_t> SyncPacker::chunkId(const uint8_t* data, size_t length) {
+    return engine_.hmac(std::vector<uint8_t>(data, data + length), idKey_, HashAlgorithm::SHA256);
+}
+
+SecureBytes SyncPacker::chunkKey(const std::vector<uint8_t>& id) {
+    std::vector<uint8_t> derived = engine_.hmac(id, chunkKeyBase_, HashAlgorithm::SHA256);
+    SecureBytes key(derived.begin(), derived.end());
+    CryptoEngine::secureZero(derived);
+    return key;
+}
+
+// The key is unique to the content, so a fixed IV taken from the id never
+// repeats under the same key with different plaintext
+std::vector<uint8_t> SyncPacker::sealChunk(const std::vector<uint8_t>& id, const uint8_t* data, size_t length) {
+    std::vector<uint8_t> iv(id.begin(), id.begin() + IV_SIZE);
+    EncryptionResult sealed = engine_.encrypt(std::vector<uint8_t>(data, data + length), chunkKey(id),
+                                              CipherAlgorithm::AES_256_GCM, PaddingMode::NONE, iv, id);
+
+    std::vector<uint8_t> out;
+    out.reserve(TAG_SIZE + sealed.ciphertext.size());
+    out.insert(out.end(), sealed.tag.begin(), sealed.tag.end());
+    out.insert(out.end(), sealed.ciphertext.begin(), sealed.ciphertext.end());
+    return out;
+}
+
+std::vector<uint8_t> SyncPacker::openChunk(const ManifestEntry& entry, const std::vector<uint8_t>& sealed) {
+    if (sealed.size() != TAG_SIZE + entry.length) {
+        throw CryptoOperationException("Sync chunk has wrong size");
+    }
+
+    std::vector<uint8_t> iv(entry.id.begin(), entry.id.begin() + IV_SIZE);
+    std::vector<uint8_t> tag(sealed.begin(), sealed.begin() + TAG_SIZE);
+    std::vector<uint8_t> ciphertext(sealed.begin() + TAG_SIZE, sealed.end());
+    return engine_.decrypt(ciphertext, chunkKey(entry.id), CipherAlgorithm::AES_256_GCM, iv,
+                           PaddingMode::NONE, entry.id, tag);
+}
+
+std::vector<SyncPacker::ManifestEntry> SyncPacker::openManifest(const std::vector<uint8_t>& manifest,
+                                                                 uint64_t& totalLength) {
+    if (manifest.size() < MANIFEST_PREFIX + IV_SIZE + TAG_SIZE ||
+        std::memcmp(manifest.data(), MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC)) != 0) {
+        throw CryptoOperationException("Not a sync manifest");
+    }
+
+    size_t offset = sizeof(MANIFEST_MAGIC);
+    if (readScalar<uint32_t>(manifest, offset) != MANIFEST_VERSION) {
+        throw CryptoOperationException("Unsupported sync manifest version");
+    }
+
+    std::vector<uint8_t> prefix(manifest.begin(), manifest.begin() + MANIFEST_PREFIX);
+    std::vector<uint8_t> iv(manifest.begin() + offset, manifest.begin() + offset + IV_SIZE);
+    offset += IV_SIZE;
+    std::vector<uint8_t> tag(manifest.begin() + offset, manifest.begin() + offset + TAG_SIZE);
+    offset += TAG_SIZE;
+    std::vector<uint8_t> ciphertext(manifest.begin() + offset, manifest.end());
+
+    std::vector<uint8_t> body = engine_.decrypt(ciphertext, manifestKey_, CipherAlgorithm::AES_256_GCM,
+                                                iv, PaddingMode::NONE, prefix, tag);
+
+    size_t cursor = 0;
+    totalLength = readScalar<uint64_t>(body, cursor);
+    const uint32_t count = readScalar<uint32_t>(body, cursor);
+    if (body.size() - cursor != static_cast<uint64_t>(count) * (ID_SIZE + sizeof(uint32_t))) {
+        throw CryptoOperationException("Corrupt sync manifest");
+    }
+
+    std::vector<ManifestEntry> entries(count);
+    for (auto& entry : entries) {
+        entry.id.assign(body.begin() + cursor, body.begin() + cursor + ID_SIZE);
+        cursor += ID_SIZE;
+        entry.length = readScalar<uint32_t>(body, cursor);
+        if (entry.length == 0 || entry.length > kMaxChunk) {
+            throw CryptoOperationException("Corrupt sync manifest");
+        }
+    }
+    return entries;
+}
+
+} // namespace crypto_native
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CryptoEngine.h"
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace crypto_native {
+
+struct SyncChunk {
+    std::string id;             // Hex chunk id, also its remote file name
+    std::vector<uint8_t> data;  // Sealed chunk
+};
+
+struct SyncPack {
+    std::vector<uint8_t> manifest;      // Sealed manifest
+    std::vector<std::string> chunkIds;  // Every chunk the manifest references, in order
+    std::vector<SyncChunk> chunks;      // Only the chunks the remote does not have yet
+    std::vector<std::string> staleChunks;  // Remote chunks the manifest no longer references
+    uint64_t totalBytes = 0;
+    uint64_t uploadBytes = 0;
+};
+
+// Content-defined, deduplicated packing of a serialized vault for sync.
+//
+// The plaintext is cut with a gear-hash rolling chunker (normalized chunking,
+// kMinChunk..kMaxChunk around kAvgChunk), so an edit only moves the
+// boundaries next to it. Chunk ids are keyed hashes of the plaintext and each
+// chunk is sealed with AES-256-GCM under a key derived from the master key and
+// the id. Sealing is therefore deterministic: identical content always yields
+// the same remote object and never has to be uploaded twice. The manifest
+// lists the chunk ids in order and is sealed with its own derived key and a
+// random IV.
+//
+// Remote layout used by the directory helpers (and expected of a WebDAV
+// remote):  <root>/manifest  and  <root>/chunks/<id>
+//
+// Chunks are never rewritten, so edits leave unreferenced ones behind. Once
+// the new manifest is committed, staleChunks can be deleted; until then the
+// previous manifest may still need them.
+class SyncPacker {
+public:
+    static constexpr size_t kMinChunk = 1024;
+    static constexpr size_t kAvgChunk = 4096;
+    static constexpr size_t kMaxChunk = 16384;
+
+    SyncPacker(CryptoEngine& engine, const SecureBytes& masterKey);
+
+    // Splits and seals `data`; chunks listed in `remoteChunks` are not resealed
+    SyncPack pack(const std::vector<uint8_t>& data,
+                  const std::unordered_set<std::string>& remoteChunks = {});
+
+    // Chunk ids referenced by a sealed manifest
+    std::vector<std::string> manifestChunks(const std::vector<uint8_t>& manifest);
+
+    // Reassembles the plaintext, fetching each distinct chunk once
+    std::vector<uint8_t> unpack(const std::vector<uint8_t>& manifest,
+                                const std::function<std::vector<uint8_t>(const std::string&)>& fetch);
+
+    // Local stand-in for a remote: writes missing chunks, then the manifest,
+    // then deletes the stale chunks
+    SyncPack packToDirectory(const std::vector<uint8_t>& data, const std::string& directory);
+    std::vector<uint8_t> unpackFromDirectory(const std::string& directory);
+
+    // Chunk end offsets for `data`; exposed for diagnostics
+    static std::vector<size_t> chunkBoundaries(const uint8_t* data, size_t length);
+
+private:
+    struct ManifestEntry {
+        std::vector<uint8_t> id;
+        uint32_t length;
+    };
+
+    std::vector<uint8_t> chunkId(const uint8_t* data, size_t length);
+    SecureBytes chunkKey(const std::vector<uint8_t>& id);
+    std::vector<uint8_t> sealChunk(const std::vector<uint8_t>& id, const uint8_t* data, size_t length);
+    std::vector<uint8_t> openChunk(const ManifestEntry& entry, const std::vector<uint8_t>& sealed);
+    std::vector<ManifestEntry> openManifest(const std::vector<uint8_t>& manifest, uint64_t& totalLength);
+
+    CryptoEngine& engine_;
+    SecureBytes idKey_;
+    SecureBytes chunkKeyBase_;
+    SecureBytes manifestKey_;
+};
+
+} // namespace crypto_native
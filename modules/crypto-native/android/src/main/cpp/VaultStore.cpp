@@ -0,0 +1,428 @@
+#include "VaultStore.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace crypto_native {
+
+namespace {
+
+constexpr char VAULT_MAGIC[8] = {'S', 'A', 'V', 'A', 'U', 'L', 'T', '\0'};
+constexpr uint32_t RECORD_MAGIC = 0x52564153; // "SAVR"
+constexpr uint32_t INITIAL_INDEX_CAPACITY = 64;
+constexpr uint32_t SLOT_ALIGNMENT = 64;
+
+uint32_t alignSlot(size_t size) {
+    return static_cast<uint32_t>((size + SLOT_ALIGNMENT - 1) & ~static_cast<size_t>(SLOT_ALIGNMENT - 1));
+}
+
+// Serial-number comparison, so a record rewritten 2^32 times still wins
+bool isNewer(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) > 0;
+}
+
+} // anonymous namespace
+
+VaultStore::VaultStore(CryptoEngine& engine, SecureBytes key, CipherAlgorithm algorithm)
+    : engine_(engine), key_(std::move(key)), algorithm_(algorithm) {
+    switch (algorithm) {
+        case CipherAlgorithm::AES_128_GCM:
+        case CipherAlgorithm::AES_192_GCM:
+        case CipherAlgorithm::AES_256_GCM:
+        case CipherAlgorithm::CHACHA20_POLY1305:
+            break;
+        default:
+            throw InvalidParameterException("Vault records require an AEAD cipher");
+    }
+}
+
+VaultStore::~VaultStore() {
+    close();
+}
+
+void VaultStore::open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ >= 0) {
+        throw CryptoOperationException("Vault already open");
+    }
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd_ < 0) {
+        throw CryptoOperationException("Failed to open vault: " + std::string(strerror(errno)));
+    }
+
+    try {
+        struct stat st{};
+        if (fstat(fd_, &st) != 0) {
+            throw CryptoOperationException("Failed to stat vault");
+        }
+
+        if (st.st_size == 0) {
+            createEmpty();
+        } else {
+            if (static_cast<size_t>(st.st_size) < sizeof(VaultHeader) ||
+                pread(fd_, &header_, sizeof(header_), 0) != static_cast<ssize_t>(sizeof(header_))) {
+                throw CryptoOperationException("Truncated vault header");
+            }
+            if (std::memcmp(header_.magic, VAULT_MAGIC, sizeof(VAULT_MAGIC)) != 0) {
+                throw CryptoOperationException("Not a vault file");
+            }
+            if (header_.version != kFormatVersion) {
+                throw CryptoOperationException("Unsupported vault version");
+            }
+            if (header_.algorithm != static_cast<uint32_t>(algorithm_)) {
+                throw InvalidParameterException("Vault cipher does not match");
+            }
+            if (header_.indexOffset + static_cast<uint64_t>(header_.indexCapacity) * sizeof(IndexEntry) >
+                    static_cast<uint64_t>(st.st_size) ||
+                header_.indexUsed > header_.indexCapacity) {
+                throw CryptoOperationException("Corrupt vault index");
+            }
+        }
+
+        mapFile();
+    } catch (...) {
+        ::close(fd_);
+        fd_ = -1;
+        throw;
+    }
+}
+
+void VaultStore::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    unmapFile();
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    slots_.clear();
+    freeSlots_.clear();
+    slotMapReady_ = false;
+}
+
+bool VaultStore::isOpen() const {
+    return fd_ >= 0;
+}
+
+size_t VaultStore::size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return header_.recordCount;
+}
+
+std::vector<std::string> VaultStore::ids() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ensureSlotMap();
+
+    std::vector<std::pair<uint32_t, std::string>> ordered;
+    ordered.reserve(slots_.size());
+    for (const auto& slot : slots_) {
+        ordered.emplace_back(slot.second, slot.first);
+    }
+    std::sort(ordered.begin(), ordered.end());
+
+    std::vector<std::string> result;
+    result.reserve(ordered.size());
+    for (auto& entry : ordered) {
+        result.push_back(std::move(entry.second));
+    }
+    return result;
+}
+
+bool VaultStore::contains(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ensureSlotMap();
+    return slots_.count(id) != 0;
+}
+
+std::vector<uint8_t> VaultStore::get(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ensureSlotMap();
+
+    auto it = slots_.find(id);
+    if (it == slots_.end()) {
+        throw InvalidParameterException("Unknown vault record: " + id);
+    }
+
+    const IndexEntry entry = entryAt(it->second);
+    const RecordHeader& record = recordAt(entry.offset);
+    const uint8_t* body = map_ + entry.offset + sizeof(RecordHeader);
+
+    std::vector<uint8_t> aad(body, body + record.idLength);
+    std::vector<uint8_t> ciphertext(body + record.idLength, body + record.idLength + record.ciphertextLength);
+    std::vector<uint8_t> iv(record.iv, record.iv + record.ivLength);
+    std::vector<uint8_t> tag(record.tag, record.tag + record.tagLength);
+
+    return engine_.decrypt(ciphertext, key_, algorithm_, iv, PaddingMode::NONE, aad, tag);
+}
+
+void VaultStore::put(const std::string& id, const std::vector<uint8_t>& plaintext) {
+    if (id.empty() || id.size() > UINT16_MAX) {
+        throw InvalidParameterException("Invalid vault record id");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
+        throw CryptoOperationException("Vault not open");
+    }
+    ensureSlotMap();
+
+    auto existing = slots_.find(id);
+    const uint32_t sequence = existing != slots_.end()
+        ? recordAt(entryAt(existing->second).offset).sequence + 1
+        : 0;
+    std::vector<uint8_t> record = seal(id, plaintext, sequence);
+
+    const uint32_t slot = acquireSlot(alignSlot(record.size()));
+    IndexEntry entry = entryAt(slot);
+    writeAt(entry.offset, record.data(), record.size());
+    entry.state = SlotState::LIVE;
+    writeIndexEntry(slot, entry);
+
+    if (existing != slots_.end()) {
+        IndexEntry old = entryAt(existing->second);
+        old.state = SlotState::FREE;
+        writeIndexEntry(existing->second, old);
+        freeSlots_.push_back(existing->second);
+        existing->second = slot;
+    } else {
+        slots_.emplace(id, slot);
+        header_.recordCount++;
+    }
+    writeHeader();
+}
+
+bool VaultStore::remove(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
+        throw CryptoOperationException("Vault not open");
+    }
+    ensureSlotMap();
+
+    auto it = slots_.find(id);
+    if (it == slots_.end()) {
+        return false;
+    }
+
+    IndexEntry entry = entryAt(it->second);
+    entry.state = SlotState::FREE;
+    writeIndexEntry(it->second, entry);
+
+    // Drop the plaintext id and ciphertext from the file as well
+    std::vector<uint8_t> zeros(entry.capacity, 0);
+    writeAt(entry.offset, zeros.data(), zeros.size());
+
+    freeSlots_.push_back(it->second);
+    slots_.erase(it);
+    header_.recordCount--;
+    writeHeader();
+    return true;
+}
+
+uint64_t VaultStore::journalSequence() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return header_.journalSequence;
+}
+
+void VaultStore::setJournalSequence(uint64_t sequence) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
+        throw CryptoOperationException("Vault not open");
+    }
+    header_.journalSequence = sequence;
+    writeHeader();
+}
+
+void VaultStore::sync() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ >= 0 && fsync(fd_) != 0) {
+        throw CryptoOperationException("Failed to sync vault");
+    }
+}
+
+// Internal helpers (mutex_ held)
+
+void VaultStore::createEmpty() {
+    std::memset(&header_, 0, sizeof(header_));
+    std::memcpy(header_.magic, VAULT_MAGIC, sizeof(VAULT_MAGIC));
+    header_.version = kFormatVersion;
+    header_.algorithm = static_cast<uint32_t>(algorithm_);
+    header_.indexCapacity = INITIAL_INDEX_CAPACITY;
+    header_.indexOffset = sizeof(VaultHeader);
+    header_.dataEnd = header_.indexOffset + INITIAL_INDEX_CAPACITY * sizeof(IndexEntry);
+
+    // ftruncate zero-fills the index, i.e. every entry starts EMPTY
+    if (ftruncate(fd_, static_cast<off_t>(header_.dataEnd)) != 0) {
+        throw CryptoOperationException("Failed to size vault");
+    }
+    writeHeader();
+}
+
+void VaultStore::mapFile() {
+    struct stat st{};
+    if (fstat(fd_, &st) != 0) {
+        throw CryptoOperationException("Failed to stat vault");
+    }
+
+    void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        throw CryptoOperationException("Failed to map vault");
+    }
+    map_ = static_cast<uint8_t*>(mapping);
+    mapLength_ = static_cast<size_t>(st.st_size);
+}
+
+void VaultStore::unmapFile() {
+    if (map_) {
+        munmap(map_, mapLength_);
+        map_ = nullptr;
+        mapLength_ = 0;
+    }
+}
+
+void VaultStore::ensureMapped(uint64_t length) {
+    if (length > mapLength_) {
+        unmapFile();
+        mapFile();
+    }
+}
+
+void VaultStore::ensureSlotMap() {
+    if (slotMapReady_ || fd_ < 0) {
+        return;
+    }
+
+    slots_.reserve(header_.recordCount);
+    for (uint32_t slot = 0; slot < header_.indexUsed; ++slot) {
+        const IndexEntry entry = entryAt(slot);
+        if (entry.state == SlotState::LIVE) {
+            auto inserted = slots_.emplace(recordId(entry), slot);
+            if (!inserted.second) {
+                // A put() interrupted before it freed the version it replaced
+                const uint32_t other = inserted.first->second;
+                const uint32_t stale = isNewer(recordAt(entryAt(other).offset).sequence,
+                                               recordAt(entry.offset).sequence) ? slot : other;
+                IndexEntry freed = entryAt(stale);
+                freed.state = SlotState::FREE;
+                writeIndexEntry(stale, freed);
+                freeSlots_.push_back(stale);
+                if (stale == other) {
+                    inserted.first->second = slot;
+                }
+            }
+        } else if (entry.state == SlotState::FREE) {
+            freeSlots_.push_back(slot);
+        }
+    }
+    slotMapReady_ = true;
+}
+
+void VaultStore::writeAt(uint64_t offset, const void* data, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    size_t written = 0;
+    while (written < length) {
+        ssize_t result = pwrite(fd_, bytes + written, length - written, static_cast<off_t>(offset + written));
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            throw CryptoOperationException("Failed to write vault: " + std::string(strerror(errno)));
+        }
+        written += static_cast<size_t>(result);
+    }
+    ensureMapped(offset + length);
+}
+
+void VaultStore::writeHeader() {
+    writeAt(0, &header_, sizeof(header_));
+}
+
+void VaultStore::writeIndexEntry(uint32_t slot, const IndexEntry& entry) {
+    writeAt(header_.indexOffset + static_cast<uint64_t>(slot) * sizeof(IndexEntry), &entry, sizeof(entry));
+}
+
+uint32_t VaultStore::acquireSlot(uint32_t capacity) {
+    // First fit among slots released by removals and relocations
+    for (auto it = freeSlots_.begin(); it != freeSlots_.end(); ++it) {
+        if (entryAt(*it).capacity >= capacity) {
+            const uint32_t slot = *it;
+            freeSlots_.erase(it);
+            return slot;
+        }
+    }
+
+    if (header_.indexUsed == header_.indexCapacity) {
+        growIndex();
+    }
+
+    const uint32_t slot = header_.indexUsed++;
+    IndexEntry entry{header_.dataEnd, capacity, SlotState::EMPTY};
+    header_.dataEnd += capacity;
+    writeIndexEntry(slot, entry);
+    return slot;
+}
+
+void VaultStore::growIndex() {
+    const uint32_t newCapacity = header_.indexCapacity * 2;
+    const uint64_t newOffset = header_.dataEnd;
+
+    // The old index region is left behind as dead space
+    std::vector<IndexEntry> entries(newCapacity, IndexEntry{0, 0, SlotState::EMPTY});
+    std::memcpy(entries.data(), map_ + header_.indexOffset, header_.indexUsed * sizeof(IndexEntry));
+    writeAt(newOffset, entries.data(), entries.size() * sizeof(IndexEntry));
+
+    header_.indexOffset = newOffset;
+    header_.indexCapacity = newCapacity;
+    header_.dataEnd = newOffset + static_cast<uint64_t>(newCapacity) * sizeof(IndexEntry);
+    writeHeader();
+}
+
+VaultStore::IndexEntry VaultStore::entryAt(uint32_t slot) const {
+    IndexEntry entry;
+    std::memcpy(&entry, map_ + header_.indexOffset + static_cast<uint64_t>(slot) * sizeof(IndexEntry), sizeof(entry));
+    return entry;
+}
+
+const VaultStore::RecordHeader& VaultStore::recordAt(uint64_t offset) const {
+    if (offset + sizeof(RecordHeader) > mapLength_) {
+        throw CryptoOperationException("Corrupt vault record");
+    }
+    const auto& record = *reinterpret_cast<const RecordHeader*>(map_ + offset);
+    if (record.magic != RECORD_MAGIC ||
+        record.ivLength > sizeof(record.iv) || record.tagLength > sizeof(record.tag) ||
+        offset + sizeof(RecordHeader) + record.idLength + record.ciphertextLength > mapLength_) {
+        throw CryptoOperationException("Corrupt vault record");
+    }
+    return record;
+}
+
+std::string VaultStore::recordId(const IndexEntry& entry) const {
+    const RecordHeader& record = recordAt(entry.offset);
+    const char* id = reinterpret_cast<const char*>(map_ + entry.offset + sizeof(RecordHeader));
+    return std::string(id, record.idLength);
+}
+
+std::vector<uint8_t> VaultStore::seal(const std::string& id, const std::vector<uint8_t>& plaintext,
+                                      uint32_t sequence) {
+    std::vector<uint8_t> aad(id.begin(), id.end());
+    EncryptionResult sealed = engine_.encrypt(plaintext, key_, algorithm_, PaddingMode::NONE, {}, aad);
+
+    RecordHeader header{};
+    header.magic = RECORD_MAGIC;
+    header.idLength = static_cast<uint16_t>(id.size());
+    header.ivLength = static_cast<uint8_t>(sealed.iv.size());
+    header.tagLength = static_cast<uint8_t>(sealed.tag.size());
+    header.ciphertextLength = static_cast<uint32_t>(sealed.ciphertext.size());
+    header.sequence = sequence;
+    std::memcpy(header.iv, sealed.iv.data(), std::min(sealed.iv.size(), sizeof(header.iv)));
+    std::memcpy(header.tag, sealed.tag.data(), std::min(sealed.tag.size(), sizeof(header.tag)));
+
+    std::vector<uint8_t> record(sizeof(RecordHeader) + id.size() + sealed.ciphertext.size());
+    std::memcpy(record.data(), &header, sizeof(header));
+    std::memcpy(record.data() + sizeof(header), id.data(), id.size());
+    std::memcpy(record.data() + sizeof(header) + id.size(), sealed.ciphertext.data(), sealed.ciphertext.size());
+    return record;
+}
+
+} // namespace crypto_native
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "CryptoEngine.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace crypto_native {
+
+// Binary vault file with one AEAD-sealed record per account.
+//
+// Layout (little-endian):
+//   [VaultHeader 64 B][record index: indexCapacity x IndexEntry][records...]
+//
+// Each record is a RecordHeader followed by the plaintext account id and the
+// ciphertext. The id is bound to the ciphertext as AAD, so records cannot be
+// swapped between ids. The file is mmap'd on open; nothing is decrypted until
+// a record is requested, and the id -> slot map is built from the record
+// headers on first lookup. put() and remove() touch only the affected record,
+// its index entry and the header. put() is copy-on-write: the new version goes
+// to another slot before the index entry is flipped, so a torn write never
+// damages the previous version. Each version carries a sequence one past the
+// one it replaces; if a crash leaves two LIVE slots for an id, the load keeps
+// the higher sequence and frees the other.
+class VaultStore {
+public:
+    static constexpr uint32_t kFormatVersion = 1;
+
+    VaultStore(CryptoEngine& engine, SecureBytes key,
+               CipherAlgorithm algorithm = CipherAlgorithm::AES_256_GCM);
+    ~VaultStore();
+
+    VaultStore(const VaultStore&) = delete;
+    VaultStore& operator=(const VaultStore&) = delete;
+
+    // Opens the vault at `path`, creating an empty one if it does not exist
+    void open(const std::string& path);
+    void close();
+    bool isOpen() const;
+
+    size_t size();
+    std::vector<std::string> ids();
+    bool contains(const std::string& id);
+
+    // Decrypts a single record; throws InvalidParameterException if unknown
+    std::vector<uint8_t> get(const std::string& id);
+
+    // Seals and writes a single record into a fresh or recycled slot
+    void put(const std::string& id, const std::vector<uint8_t>& plaintext);
+
+    bool remove(const std::string& id);
+
+    // Flushes written records to stable storage
+    void sync();
+
+    // Last journal sequence folded into this vault (see AccountJournal)
+    uint64_t journalSequence();
+    void setJournalSequence(uint64_t sequence);
+
+private:
+    struct VaultHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t algorithm;
+        uint32_t recordCount;
+        uint32_t indexCapacity;
+        uint64_t indexOffset;
+        uint64_t dataEnd;
+        uint32_t indexUsed;
+        uint32_t reserved0;
+        uint64_t journalSequence;
+        uint8_t reserved[8];
+    };
+
+    enum class SlotState : uint32_t {
+        EMPTY = 0,
+        LIVE = 1,
+        FREE = 2
+    };
+
+    struct IndexEntry {
+        uint64_t offset;
+        uint32_t capacity;
+        SlotState state;
+    };
+
+    struct RecordHeader {
+        uint32_t magic;
+        uint16_t idLength;
+        uint8_t ivLength;
+        uint8_t tagLength;
+        uint32_t ciphertextLength;
+        uint32_t sequence;  // bumped on every put of the same id; wraps
+        uint8_t iv[16];
+        uint8_t tag[16];
+    };
+
+    static_assert(sizeof(VaultHeader) == 64, "VaultHeader must be 64 bytes");
+    static_assert(sizeof(IndexEntry) == 16, "IndexEntry must be 16 bytes");
+    static_assert(sizeof(RecordHeader) == 48, "RecordHeader must be 48 bytes");
+
+    void createEmpty();
+    void mapFile();
+    void unmapFile();
+    void ensureMapped(uint64_t length);
+    void ensureSlotMap();
+    void writeAt(uint64_t offset, const void* data, size_t length);
+    void writeHeader();
+    void writeIndexEntry(uint32_t slot, const IndexEntry& entry);
+    uint32_t acquireSlot(uint32_t capacity);
+    void growIndex();
+
+    IndexEntry entryAt(uint32_t slot) const;
+    const RecordHeader& recordAt(uint64_t offset) const;
+    std::string recordId(const IndexEntry& entry) const;
+    std::vector<uint8_t> seal(const std::string& id, const std::vector<uint8_t>& plaintext, uint32_t sequence);
+
+    CryptoEngine& engine_;
+    SecureBytes key_;
+    CipherAlgorithm algorithm_;
+
+    std::mutex mutex_;
+    int fd_ = -1;
+    uint8_t* map_ = nullptr;
+    size_t mapLength_ = 0;
+    VaultHeader header_{};
+    bool slotMapReady_ = false;
+    std::unordered_map<std::string, uint32_t> slots_;
+    std::vector<uint32_t> freeSlots_;
+};
+
+} // namespace crypto_native
@@ -3,6 +3,7 @@ package dev.exzh.expo.crypto
 import expo.modules.kotlin.modules.Module
 import expo.modules.kotlin.modules.ModuleDefinition
 import expo.modules.kotlin.Promise
+import java.io.File
 import java.net.URL
 import java.util.Base64
 
@@ -56,16 +57,213 @@ class CryptoNativeModule : Module() {
     parallelism: Int
   ): ByteArray
 
+  private external fun nativeCalibrateKdf(kdf: String, keyLength: Int, targetMs: Int): Map<String, Any>
+
   private external fun nativeHash(data: ByteArray, algorithm: String): ByteArray
 
   private external fun nativeHmac(data: ByteArray, key: ByteArray, algorithm: String): ByteArray
 
+  private external fun nativeImportKey(key: ByteArray): Int
+
+  private external fun nativeDeriveKeyHandle(
+    password: String,
+    salt: ByteArray?,
+    kdf: String,
+    iterations: Int,
+    saltLength: Int,
+    keyLength: Int,
+    memory: Int,
+    parallelism: Int
+  ): Map<String, Any>
+
+  private external fun nativeReleaseKey(handle: Int)
+
+  private external fun nativeEncryptWithKey(
+    data: ByteArray,
+    key: Int,
+    algorithm: String,
+    padding: String,
+    iv: ByteArray?,
+    aad: ByteArray?
+  ): Map<String, Any>
+
+  private external fun nativeDecryptWithKey(
+    ciphertext: ByteArray,
+    key: Int,
+    algorithm: String,
+    padding: String,
+    iv: ByteArray,
+    aad: ByteArray?,
+    tag: ByteArray?
+  ): ByteArray
+
+  private external fun nativeHmacWithKey(data: ByteArray, key: Int, algorithm: String): ByteArray
+
+  private external fun nativeHkdfExtract(ikm: Int, salt: ByteArray?, algorithm: String): Int
+
+  private external fun nativeHkdfExpand(prk: Int, infos: Array<ByteArray>, length: Int, algorithm: String): IntArray
+
+  private external fun nativeSealBatch(
+    key: Int,
+    algorithm: String,
+    data: Array<ByteArray>,
+    aad: Array<ByteArray?>
+  ): Array<ByteArray>
+
+  private external fun nativeOpenBatch(
+    key: Int,
+    algorithm: String,
+    sealed: Array<ByteArray>,
+    aad: Array<ByteArray?>
+  ): Array<ByteArray>
+
+  private external fun nativeSubmitEncryptWithKey(
+    data: ByteArray,
+    key: Int,
+    algorithm: String,
+    padding: String,
+    iv: ByteArray?,
+    aad: ByteArray?,
+    priority: String
+  ): Int
+
+  private external fun nativeSubmitDecryptWithKey(
+    ciphertext: ByteArray,
+    key: Int,
+    algorithm: String,
+    padding: String,
+    iv: ByteArray,
+    aad: ByteArray?,
+    tag: ByteArray?,
+    priority: String
+  ): Int
+
+  private external fun nativeSubmitHmacWithKey(data: ByteArray, key: Int, algorithm: String, priority: String): Int
+
+  private external fun nativeSubmitDeriveKeyHandle(
+    password: String,
+    salt: ByteArray?,
+    kdf: String,
+    iterations: Int,
+    saltLength: Int,
+    keyLength: Int,
+    memory: Int,
+    parallelism: Int,
+    priority: String
+  ): Int
+
+  private external fun nativeCancelJob(jobId: Int): Boolean
+
   private external fun nativeRandomBytes(length: Int): ByteArray
 
   private external fun nativeRandomInt(min: Int, max: Int): Int
 
   private external fun nativeSecureCompare(a: ByteArray, b: ByteArray): Boolean
 
+  private external fun nativeVaultOpen(path: String, key: ByteArray, algorithm: String): Int
+
+  private external fun nativeVaultClose(handle: Int)
+
+  private external fun nativeVaultIds(handle: Int): Array<String>
+
+  private external fun nativeVaultGet(handle: Int, id: String): ByteArray
+
+  private external fun nativeVaultPut(handle: Int, id: String, data: ByteArray)
+
+  private external fun nativeVaultRemove(handle: Int, id: String): Boolean
+
+  private external fun nativeVaultSync(handle: Int)
+
+  private external fun nativeJournalOpen(directory: String, key: ByteArray, algorithm: String): Map<String, Any>
+
+  private external fun nativeJournalClose(handle: Int)
+
+  private external fun nativeJournalPut(handle: Int, id: String, name: String, order: Int, data: ByteArray)
+
+  private external fun nativeJournalRename(handle: Int, id: String, name: String)
+
+  private external fun nativeJournalReorder(handle: Int, ids: Array<String>, orders: IntArray)
+
+  private external fun nativeJournalRemove(handle: Int, id: String): Boolean
+
+  private external fun nativeJournalGet(handle: Int, id: String): Map<String, Any>?
+
+  private external fun nativeJournalIds(handle: Int): Array<String>
+
+  private external fun nativeJournalCompact(handle: Int)
+
+  private external fun nativeSyncPack(data: ByteArray, key: ByteArray, remoteChunks: Array<String>): Map<String, Any>
+
+  private external fun nativeSyncManifestChunks(manifest: ByteArray, key: ByteArray): Array<String>
+
+  private external fun nativeSyncUnpack(
+    manifest: ByteArray,
+    key: ByteArray,
+    ids: Array<String>,
+    chunks: Array<ByteArray>
+  ): ByteArray
+
+  private external fun nativeSyncPackToDirectory(data: ByteArray, key: ByteArray, directory: String): Map<String, Any>
+
+  private external fun nativeSyncUnpackFromDirectory(directory: String, key: ByteArray): ByteArray
+
+  private external fun nativeMerge(base: ByteArray, local: ByteArray, remote: ByteArray): Map<String, Any>
+
+  private external fun nativeStreamSeal(key: Int, data: ByteArray, algorithm: String, compression: String): ByteArray
+
+  private external fun nativeStreamOpen(key: Int, sealed: ByteArray): ByteArray
+
+  private external fun nativeStreamSealFile(
+    key: Int,
+    inputPath: String,
+    outputPath: String,
+    algorithm: String,
+    compression: String
+  ): Map<String, Any>
+
+  private external fun nativeStreamOpenFile(key: Int, inputPath: String, outputPath: String): Map<String, Any>
+
+  // Called from native worker threads, once per submitted job
+  @Suppress("unused")
+  private fun onNativeJobComplete(jobId: Int, status: String, result: Map<String, Any>?, error: String?) {
+    val payload = result?.mapValues { (_, value) ->
+      when (value) {
+        is ByteArray -> try {
+          Base64.getEncoder().encodeToString(value)
+        } finally {
+          value.fill(0)
+        }
+        is Number -> value.toInt()
+        else -> value
+      }
+    }
+    sendEvent("onJobComplete", mapOf(
+      "jobId" to jobId,
+      "status" to status,
+      "result" to payload,
+      "error" to error
+    ).filterValues { it != null })
+  }
+
+  // Called from native worker threads as a job crosses each whole percent
+  @Suppress("unused")
+  private fun onNativeJobProgress(jobId: Int, progress: Double) {
+    sendEvent("onJobProgress", mapOf(
+      "jobId" to jobId,
+      "progress" to progress
+    ))
+  }
+
+  // Accepts file:// URIs, absolute paths, or paths relative to the app's files directory
+  private fun resolveVaultPath(path: String): String {
+    val stripped = path.removePrefix("file://")
+    if (stripped.startsWith("/")) {
+      return stripped
+    }
+    val filesDir = appContext.reactContext?.filesDir ?: throw IllegalStateException("React context unavailable")
+    return File(filesDir, stripped).absolutePath
+  }
+
   override fun definition() = ModuleDefinition {
     Name("CryptoNative")
 
@@ -73,7 +271,7 @@ class CryptoNativeModule : Module() {
       "PI" to Math.PI
     )
 
-    Events("onChange")
+    Events("onChange", "onJobComplete", "onJobProgress")
 
     Function("hello") {
       "Hello world! 👋"
@@ -134,6 +332,50 @@ class CryptoNativeModule : Module() {
       }
     }
 
+    AsyncFunction("encryptWithKey") { data: String, key: Int, options: Map<String, Any> ->
+      try {
+        val dataBytes = Base64.getDecoder().decode(data)
+
+        val algorithm = options["algorithm"] as? String ?: throw IllegalArgumentException("Algorithm is required")
+        val padding = options["padding"] as? String ?: "PKCS7"
+        val ivBytes = (options["iv"] as? String)?.let { Base64.getDecoder().decode(it) }
+        val aadBytes = (options["aad"] as? String)?.let { Base64.getDecoder().decode(it) }
+
+        val result = nativeEncryptWithKey(dataBytes, key, algorithm, padding, ivBytes, aadBytes)
+
+        mapOf(
+          "ciphertext" to Base64.getEncoder().encodeToString(result["ciphertext"] as ByteArray),
+          "iv" to Base64.getEncoder().encodeToString(result["iv"] as ByteArray),
+          "tag" to (result["tag"] as? ByteArray)?.let { Base64.getEncoder().encodeToString(it) }
+        ).filterValues { it != null }
+      } catch (e: Exception) {
+        throw Exception("Encryption failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("decryptWithKey") { ciphertext: String, key: Int, options: Map<String, Any> ->
+      try {
+        val ciphertextBytes = Base64.getDecoder().decode(ciphertext)
+
+        val algorithm = options["algorithm"] as? String ?: throw IllegalArgumentException("Algorithm is required")
+        val padding = options["padding"] as? String ?: "PKCS7"
+        val iv = options["iv"] as? String ?: throw IllegalArgumentException("IV is required")
+        val aadBytes = (options["aad"] as? String)?.let { Base64.getDecoder().decode(it) }
+        val tagBytes = (options["tag"] as? String)?.let { Base64.getDecoder().decode(it) }
+
+        val result = nativeDecryptWithKey(
+          ciphertextBytes, key, algorithm, padding, Base64.getDecoder().decode(iv), aadBytes, tagBytes
+        )
+        try {
+          Base64.getEncoder().encodeToString(result)
+        } finally {
+          result.fill(0)
+        }
+      } catch (e: Exception) {
+        throw Exception("Decryption failed: ${e.message}")
+      }
+    }
+
     // Key Management
     AsyncFunction("generateKey") { length: Int ->
       try {
@@ -181,6 +423,126 @@ class CryptoNativeModule : Module() {
       }
     }
 
+    // Batch AEAD
+    AsyncFunction("calibrateKdf") { options: Map<String, Any> ->
+      try {
+        val kdf = options["kdf"] as? String ?: "PBKDF2"
+        val keyLength = options["keyLength"] as? Int ?: 32
+        val targetMs = options["targetMs"] as? Int ?: 500
+
+        val result = nativeCalibrateKdf(kdf, keyLength, targetMs)
+
+        mapOf(
+          "version" to (result["version"] as Number).toInt(),
+          "kdf" to kdf,
+          "iterations" to (result["iterations"] as Number).toInt(),
+          "keyLength" to keyLength,
+          "expectedMs" to (result["expectedMs"] as Number).toDouble()
+        )
+      } catch (e: Exception) {
+        throw Exception("KDF calibration failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("sealBatch") { key: Int, records: List<Map<String, String>>, options: Map<String, Any> ->
+      try {
+        val algorithm = options["algorithm"] as? String ?: "AES_256_GCM"
+        val data = Array(records.size) { i ->
+          Base64.getDecoder().decode(records[i]["data"] ?: throw IllegalArgumentException("Record $i has no data"))
+        }
+        val aad = Array(records.size) { i -> records[i]["aad"]?.let { Base64.getDecoder().decode(it) } }
+
+        try {
+          nativeSealBatch(key, algorithm, data, aad).map { Base64.getEncoder().encodeToString(it) }
+        } finally {
+          data.forEach { it.fill(0) }
+        }
+      } catch (e: Exception) {
+        throw Exception("Batch sealing failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("openBatch") { key: Int, records: List<Map<String, String>>, options: Map<String, Any> ->
+      try {
+        val algorithm = options["algorithm"] as? String ?: "AES_256_GCM"
+        val sealed = Array(records.size) { i ->
+          Base64.getDecoder().decode(records[i]["data"] ?: throw IllegalArgumentException("Record $i has no data"))
+        }
+        val aad = Array(records.size) { i -> records[i]["aad"]?.let { Base64.getDecoder().decode(it) } }
+
+        val opened = nativeOpenBatch(key, algorithm, sealed, aad)
+        try {
+          opened.map { Base64.getEncoder().encodeToString(it) }
+        } finally {
+          opened.forEach { it.fill(0) }
+        }
+      } catch (e: Exception) {
+        throw Exception("Batch opening failed: ${e.message}")
+      }
+    }
+
+    // Key Handles
+    AsyncFunction("importKey") { key: String ->
+      try {
+        val keyBytes = Base64.getDecoder().decode(key)
+        try {
+          nativeImportKey(keyBytes)
+        } finally {
+          keyBytes.fill(0)
+        }
+      } catch (e: Exception) {
+        throw Exception("Key import failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("deriveKeyHandle") { password: String, options: Map<String, Any> ->
+      try {
+        val saltBytes = (options["salt"] as? String)?.let { Base64.getDecoder().decode(it) }
+        val kdf = options["kdf"] as? String ?: "PBKDF2"
+        val iterations = options["iterations"] as? Int ?: 100000
+        val saltLength = options["saltLength"] as? Int ?: 32
+        val keyLength = options["keyLength"] as? Int ?: 32
+        val memory = options["memory"] as? Int ?: 0
+        val parallelism = options["parallelism"] as? Int ?: 1
+
+        val result = nativeDeriveKeyHandle(
+          password, saltBytes, kdf, iterations, saltLength, keyLength, memory, parallelism
+        )
+
+        mapOf(
+          "handle" to (result["handle"] as Number).toInt(),
+          "salt" to Base64.getEncoder().encodeToString(result["salt"] as ByteArray)
+        )
+      } catch (e: Exception) {
+        throw Exception("Key derivation failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("releaseKey") { handle: Int ->
+      nativeReleaseKey(handle)
+    }
+
+    AsyncFunction("hkdfExtract") { key: Int, options: Map<String, Any> ->
+      try {
+        val saltBytes = (options["salt"] as? String)?.let { Base64.getDecoder().decode(it) }
+        val algorithm = options["algorithm"] as? String ?: "SHA256"
+        nativeHkdfExtract(key, saltBytes, algorithm)
+      } catch (e: Exception) {
+        throw Exception("HKDF extraction failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("hkdfExpand") { prk: Int, labels: List<String>, options: Map<String, Any> ->
+      try {
+        val length = options["length"] as? Int ?: 32
+        val algorithm = options["algorithm"] as? String ?: "SHA256"
+        val infos = Array(labels.size) { labels[it].toByteArray(Charsets.UTF_8) }
+        nativeHkdfExpand(prk, infos, length, algorithm).toList()
+      } catch (e: Exception) {
+        throw Exception("HKDF expansion failed: ${e.message}")
+      }
+    }
+
     // Hashing and HMAC
     AsyncFunction("hash") { data: String, algorithm: String ->
       try {
@@ -205,6 +567,93 @@ class CryptoNativeModule : Module() {
       }
     }
 
+    AsyncFunction("hmacWithKey") { data: String, key: Int, options: Map<String, Any> ->
+      try {
+        val dataBytes = Base64.getDecoder().decode(data)
+        val algorithm = options["algorithm"] as? String ?: "SHA256"
+
+        val result = nativeHmacWithKey(dataBytes, key, algorithm)
+        Base64.getEncoder().encodeToString(result)
+      } catch (e: Exception) {
+        throw Exception("HMAC operation failed: ${e.message}")
+      }
+    }
+
+    // Background Jobs
+    AsyncFunction("submitEncryptWithKey") { data: String, key: Int, options: Map<String, Any> ->
+      try {
+        val dataBytes = Base64.getDecoder().decode(data)
+
+        val algorithm = options["algorithm"] as? String ?: throw IllegalArgumentException("Algorithm is required")
+        val padding = options["padding"] as? String ?: "PKCS7"
+        val ivBytes = (options["iv"] as? String)?.let { Base64.getDecoder().decode(it) }
+        val aadBytes = (options["aad"] as? String)?.let { Base64.getDecoder().decode(it) }
+        val priority = options["priority"] as? String ?: "BACKGROUND"
+
+        try {
+          nativeSubmitEncryptWithKey(dataBytes, key, algorithm, padding, ivBytes, aadBytes, priority)
+        } finally {
+          dataBytes.fill(0)
+        }
+      } catch (e: Exception) {
+        throw Exception("Encryption job failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("submitDecryptWithKey") { ciphertext: String, key: Int, options: Map<String, Any> ->
+      try {
+        val ciphertextBytes = Base64.getDecoder().decode(ciphertext)
+
+        val algorithm = options["algorithm"] as? String ?: throw IllegalArgumentException("Algorithm is required")
+        val padding = options["padding"] as? String ?: "PKCS7"
+        val iv = options["iv"] as? String ?: throw IllegalArgumentException("IV is required")
+        val aadBytes = (options["aad"] as? String)?.let { Base64.getDecoder().decode(it) }
+        val tagBytes = (options["tag"] as? String)?.let { Base64.getDecoder().decode(it) }
+        val priority = options["priority"] as? String ?: "BACKGROUND"
+
+        nativeSubmitDecryptWithKey(
+          ciphertextBytes, key, algorithm, padding, Base64.getDecoder().decode(iv), aadBytes, tagBytes, priority
+        )
+      } catch (e: Exception) {
+        throw Exception("Decryption job failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("submitHmacWithKey") { data: String, key: Int, options: Map<String, Any> ->
+      try {
+        val dataBytes = Base64.getDecoder().decode(data)
+        val algorithm = options["algorithm"] as? String ?: "SHA256"
+        val priority = options["priority"] as? String ?: "INTERACTIVE"
+
+        nativeSubmitHmacWithKey(dataBytes, key, algorithm, priority)
+      } catch (e: Exception) {
+        throw Exception("HMAC job failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("submitDeriveKeyHandle") { password: String, options: Map<String, Any> ->
+      try {
+        val saltBytes = (options["salt"] as? String)?.let { Base64.getDecoder().decode(it) }
+        val kdf = options["kdf"] as? String ?: "PBKDF2"
+        val iterations = options["iterations"] as? Int ?: 100000
+        val saltLength = options["saltLength"] as? Int ?: 32
+        val keyLength = options["keyLength"] as? Int ?: 32
+        val memory = options["memory"] as? Int ?: 0
+        val parallelism = options["parallelism"] as? Int ?: 1
+        val priority = options["priority"] as? String ?: "BACKGROUND"
+
+        nativeSubmitDeriveKeyHandle(
+          password, saltBytes, kdf, iterations, saltLength, keyLength, memory, parallelism, priority
+        )
+      } catch (e: Exception) {
+        throw Exception("Key derivation job failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("cancelJob") { jobId: Int ->
+      nativeCancelJob(jobId)
+    }
+
     // Random Number Generation
     AsyncFunction("randomBytes") { options: Map<String, Any> ->
       try {
@@ -269,5 +718,303 @@ class CryptoNativeModule : Module() {
         throw Exception("Secure comparison failed: ${e.message}")
       }
     }
+
+    // Vault Store
+    AsyncFunction("vaultOpen") { path: String, key: String, options: Map<String, Any> ->
+      try {
+        val keyBytes = Base64.getDecoder().decode(key)
+        val algorithm = options["algorithm"] as? String ?: "AES_256_GCM"
+        try {
+          nativeVaultOpen(resolveVaultPath(path), keyBytes, algorithm)
+        } finally {
+          keyBytes.fill(0)
+        }
+      } catch (e: Exception) {
+        throw Exception("Vault open failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("vaultClose") { handle: Int ->
+      nativeVaultClose(handle)
+    }
+
+    AsyncFunction("vaultIds") { handle: Int ->
+      try {
+        nativeVaultIds(handle).toList()
+      } catch (e: Exception) {
+        throw Exception("Vault listing failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("vaultGet") { handle: Int, id: String ->
+      try {
+        Base64.getEncoder().encodeToString(nativeVaultGet(handle, id))
+      } catch (e: Exception) {
+        throw Exception("Vault read failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("vaultPut") { handle: Int, id: String, data: String ->
+      try {
+        nativeVaultPut(handle, id, Base64.getDecoder().decode(data))
+      } catch (e: Exception) {
+        throw Exception("Vault write failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("vaultRemove") { handle: Int, id: String ->
+      try {
+        nativeVaultRemove(handle, id)
+      } catch (e: Exception) {
+        throw Exception("Vault remove failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("vaultSync") { handle: Int ->
+      try {
+        nativeVaultSync(handle)
+      } catch (e: Exception) {
+        throw Exception("Vault sync failed: ${e.message}")
+      }
+    }
+
+    // Account Journal
+
+    AsyncFunction("journalOpen") { directory: String, key: String, options: Map<String, Any> ->
+      try {
+        val keyBytes = Base64.getDecoder().decode(key)
+        val algorithm = options["algorithm"] as? String ?: "AES_256_GCM"
+        try {
+          nativeJournalOpen(resolveVaultPath(directory), keyBytes, algorithm)
+        } finally {
+          keyBytes.fill(0)
+        }
+      } catch (e: Exception) {
+        throw Exception("Journal open failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("journalClose") { handle: Int ->
+      nativeJournalClose(handle)
+    }
+
+    AsyncFunction("journalPut") { handle: Int, id: String, record: Map<String, Any> ->
+      try {
+        val name = record["name"] as? String ?: ""
+        val order = (record["order"] as? Number)?.toInt() ?: 0
+        val data = Base64.getDecoder().decode(record["data"] as? String ?: "")
+        nativeJournalPut(handle, id, name, order, data)
+      } catch (e: Exception) {
+        throw Exception("Journal write failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("journalRename") { handle: Int, id: String, name: String ->
+      try {
+        nativeJournalRename(handle, id, name)
+      } catch (e: Exception) {
+        throw Exception("Journal rename failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("journalReorder") { handle: Int, orders: Map<String, Any> ->
+      try {
+        val ids = orders.keys.toTypedArray()
+        val values = IntArray(ids.size) { (orders[ids[it]] as Number).toInt() }
+        nativeJournalReorder(handle, ids, values)
+      } catch (e: Exception) {
+        throw Exception("Journal reorder failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("journalRemove") { handle: Int, id: String ->
+      try {
+        nativeJournalRemove(handle, id)
+      } catch (e: Exception) {
+        throw Exception("Journal remove failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("journalGet") { handle: Int, id: String ->
+      try {
+        nativeJournalGet(handle, id)?.let { record ->
+          mapOf(
+            "name" to record["name"],
+            "order" to record["order"],
+            "data" to Base64.getEncoder().encodeToString(record["data"] as ByteArray)
+          )
+        }
+      } catch (e: Exception) {
+        throw Exception("Journal read failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("journalIds") { handle: Int ->
+      try {
+        nativeJournalIds(handle).toList()
+      } catch (e: Exception) {
+        throw Exception("Journal listing failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("journalCompact") { handle: Int ->
+      try {
+        nativeJournalCompact(handle)
+      } catch (e: Exception) {
+        throw Exception("Journal compaction failed: ${e.message}")
+      }
+    }
+
+    // Sync Packer
+
+    AsyncFunction("syncPack") { data: String, key: String, remoteChunks: List<String> ->
+      try {
+        val keyBytes = Base64.getDecoder().decode(key)
+        val result = try {
+          nativeSyncPack(Base64.getDecoder().decode(data), keyBytes, remoteChunks.toTypedArray())
+        } finally {
+          keyBytes.fill(0)
+        }
+
+        @Suppress("UNCHECKED_CAST")
+        val chunks = result["chunks"] as Map<String, ByteArray>
+        mapOf(
+          "manifest" to Base64.getEncoder().encodeToString(result["manifest"] as ByteArray),
+          "chunkIds" to (result["chunkIds"] as Array<*>).toList(),
+          "chunks" to chunks.mapValues { Base64.getEncoder().encodeToString(it.value) },
+          "staleChunks" to (result["staleChunks"] as Array<*>).toList(),
+          "totalBytes" to result["totalBytes"],
+          "uploadBytes" to result["uploadBytes"]
+        )
+      } catch (e: Exception) {
+        throw Exception("Sync pack failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("syncManifestChunks") { manifest: String, key: String ->
+      try {
+        val keyBytes = Base64.getDecoder().decode(key)
+        try {
+          nativeSyncManifestChunks(Base64.getDecoder().decode(manifest), keyBytes).toList()
+        } finally {
+          keyBytes.fill(0)
+        }
+      } catch (e: Exception) {
+        throw Exception("Sync manifest read failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("syncUnpack") { manifest: String, key: String, chunks: Map<String, String> ->
+      try {
+        val keyBytes = Base64.getDecoder().decode(key)
+        val ids = chunks.keys.toTypedArray()
+        val sealed = Array(ids.size) { Base64.getDecoder().decode(chunks[ids[it]]) }
+        try {
+          Base64.getEncoder().encodeToString(
+            nativeSyncUnpack(Base64.getDecoder().decode(manifest), keyBytes, ids, sealed)
+          )
+        } finally {
+          keyBytes.fill(0)
+        }
+      } catch (e: Exception) {
+        throw Exception("Sync unpack failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("syncPackToDirectory") { data: String, key: String, directory: String ->
+      try {
+        val keyBytes = Base64.getDecoder().decode(key)
+        try {
+          nativeSyncPackToDirectory(Base64.getDecoder().decode(data), keyBytes, resolveVaultPath(directory))
+        } finally {
+          keyBytes.fill(0)
+        }
+      } catch (e: Exception) {
+        throw Exception("Sync pack failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("syncUnpackFromDirectory") { directory: String, key: String ->
+      try {
+        val keyBytes = Base64.getDecoder().decode(key)
+        try {
+          Base64.getEncoder().encodeToString(nativeSyncUnpackFromDirectory(resolveVaultPath(directory), keyBytes))
+        } finally {
+          keyBytes.fill(0)
+        }
+      } catch (e: Exception) {
+        throw Exception("Sync unpack failed: ${e.message}")
+      }
+    }
+
+    // Merge Engine
+
+    AsyncFunction("merge") { base: String, local: String, remote: String ->
+      try {
+        val result = nativeMerge(
+          Base64.getDecoder().decode(base),
+          Base64.getDecoder().decode(local),
+          Base64.getDecoder().decode(remote)
+        )
+        val ids = result["conflictIds"] as Array<*>
+        val kinds = result["conflictKinds"] as Array<*>
+
+        mapOf(
+          "merged" to Base64.getEncoder().encodeToString(result["merged"] as ByteArray),
+          "mergedCount" to result["mergedCount"],
+          "conflicts" to ids.indices.map { mapOf("id" to ids[it], "kind" to kinds[it]) }
+        )
+      } catch (e: Exception) {
+        throw Exception("Merge failed: ${e.message}")
+      }
+    }
+
+    // Sealed Streams
+
+    AsyncFunction("sealStream") { key: Int, data: String, options: Map<String, Any> ->
+      try {
+        val algorithm = options["algorithm"] as? String ?: "AES_256_GCM"
+        val compression = options["compression"] as? String ?: "FAST"
+        val dataBytes = Base64.getDecoder().decode(data)
+        try {
+          Base64.getEncoder().encodeToString(nativeStreamSeal(key, dataBytes, algorithm, compression))
+        } finally {
+          dataBytes.fill(0)
+        }
+      } catch (e: Exception) {
+        throw Exception("Stream sealing failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("openStream") { key: Int, sealed: String ->
+      try {
+        val opened = nativeStreamOpen(key, Base64.getDecoder().decode(sealed))
+        try {
+          Base64.getEncoder().encodeToString(opened)
+        } finally {
+          opened.fill(0)
+        }
+      } catch (e: Exception) {
+        throw Exception("Stream opening failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("sealFile") { key: Int, inputPath: String, outputPath: String, options: Map<String, Any> ->
+      try {
+        val algorithm = options["algorithm"] as? String ?: "AES_256_GCM"
+        val compression = options["compression"] as? String ?: "FAST"
+        nativeStreamSealFile(key, resolveVaultPath(inputPath), resolveVaultPath(outputPath), algorithm, compression)
+      } catch (e: Exception) {
+        throw Exception("File sealing failed: ${e.message}")
+      }
+    }
+
+    AsyncFunction("openFile") { key: Int, inputPath: String, outputPath: String ->
+      try {
+        nativeStreamOpenFile(key, resolveVaultPath(inputPath), resolveVaultPath(outputPath))
+      } catch (e: Exception) {
+        throw Exception("File opening failed: ${e.message}")
+      }
+    }
   }
 }
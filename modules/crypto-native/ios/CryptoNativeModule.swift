@@ -49,6 +49,10 @@ public class CryptoNativeModule: Module {
       return try self.deriveKeyWithExistingSalt(password: password, salt: salt, options: options)
     }
 
+    AsyncFunction("calibrateKdf") { (options: [String: Any]) -> [String: Any] in
+      return try self.calibrateKdf(options: options)
+    }
+
     // Hashing and HMAC
     AsyncFunction("hash") { (data: String, algorithm: String) -> String in
       return try self.computeHash(data: data, algorithm: algorithm)
@@ -275,6 +279,42 @@ public class CryptoNativeModule: Module {
     return key.base64EncodedString()
   }
 
+  // Same version, floor and rounding as CryptoEngine::calibrateKdf on Android.
+  // Every KDF name runs as PBKDF2-HMAC-SHA256 here, so all of them calibrate.
+  private static let kdfCalibrationVersion = 1
+  private static let minCalibratedIterations: UInt32 = 100000
+
+  private func calibrateKdf(options: [String: Any]) throws -> [String: Any] {
+    let kdf = options["kdf"] as? String ?? "PBKDF2"
+    let keyLength = options["keyLength"] as? Int ?? 32
+    let targetMs = options["targetMs"] as? Int ?? 500
+    guard keyLength > 0, targetMs > 0 else {
+      throw CryptoError.invalidInput("Calibration needs a positive target and key length")
+    }
+
+    // CommonCrypto times the derivation itself
+    let rounds = CCCalibratePBKDF(
+      CCPBKDFAlgorithm(kCCPBKDF2),
+      16,
+      16,
+      CCPseudoRandomAlgorithm(kCCPRFHmacAlgSHA256),
+      keyLength,
+      UInt32(targetMs)
+    )
+    guard rounds != UInt32.max else {
+      throw CryptoError.keyGenerationFailed("PBKDF2 calibration failed")
+    }
+    let iterations = max(rounds / 1000 * 1000, Self.minCalibratedIterations)
+
+    return [
+      "version": Self.kdfCalibrationVersion,
+      "kdf": kdf,
+      "iterations": Int(iterations),
+      "keyLength": keyLength,
+      "expectedMs": Double(targetMs) * Double(iterations) / Double(max(rounds, 1))
+    ]
+  }
+
   private func deriveKeyPBKDF2(password: String, salt: Data, iterations: Int, keyLength: Int) throws -> Data {
     var derivedKey = Data(count: keyLength)
     
@@ -6,6 +6,8 @@ export type OnLoadEventPayload = {
 
 export type CryptoNativeModuleEvents = {
   onChange: (params: ChangeEventPayload) => void;
+  onJobComplete: (params: JobCompletionEvent) => void;
+  onJobProgress: (params: JobProgressEvent) => void;
 };
 
 export type ChangeEventPayload = {
@@ -91,10 +93,77 @@ export interface DerivedKey {
   salt: string; // Base64 encoded
 }
 
+export interface KdfCalibrationOptions {
+  kdf?: KeyDerivationFunction; // PBKDF2 or ARGON2 (default: PBKDF2)
+  keyLength?: number; // Default: 32
+  targetMs?: number; // Desired derivation time on this device (default: 500)
+}
+
+export interface KdfCalibration {
+  version: number; // Calibration method; store it with anything encrypted under the result
+  kdf: KeyDerivationFunction;
+  iterations: number; // Never below 100000
+  keyLength: number;
+  expectedMs: number;
+}
+
+export interface KeyHandleDerivationOptions extends KeyDerivationOptions {
+  salt?: string; // Base64 encoded; a fresh salt of saltLength bytes is drawn when omitted
+}
+
+export interface DerivedKeyHandle {
+  handle: number; // Native key handle, valid until releaseKey
+  salt: string; // Base64 encoded
+}
+
+export interface HkdfExtractOptions {
+  salt?: string; // Base64 encoded; HashLen zero bytes when omitted
+  algorithm?: HashAlgorithm; // SHA256 or SHA512 (default: SHA256)
+}
+
+export interface HkdfExpandOptions {
+  length?: number; // Bytes per subkey, at most 255 * HashLen (default: 32)
+  algorithm?: HashAlgorithm; // Must match the one used for hkdfExtract (default: SHA256)
+}
+
+export interface BatchRecord {
+  data: string; // Base64 encoded plaintext for sealBatch, sealed record for openBatch
+  aad?: string; // Base64 encoded; must match between sealBatch and openBatch
+}
+
+export interface BatchOptions {
+  algorithm?: CipherAlgorithm; // AES_*_GCM or CHACHA20_POLY1305 (default: AES_256_GCM)
+}
+
 export interface HmacOptions {
   algorithm: HashAlgorithm;
 }
 
+export enum JobPriority {
+  INTERACTIVE = 'INTERACTIVE', // Runs ahead of all background work
+  BACKGROUND = 'BACKGROUND',
+}
+
+export type JobStatus = 'COMPLETED' | 'CANCELLED' | 'FAILED';
+
+export interface JobOptions {
+  priority?: JobPriority; // Default: INTERACTIVE for HMAC jobs, BACKGROUND otherwise
+}
+
+export interface JobCompletionEvent {
+  jobId: number;
+  status: JobStatus;
+  // Present when COMPLETED. Byte values are Base64 encoded:
+  // encrypt -> ciphertext, iv, tag?; decrypt -> plaintext; hmac -> hmac; deriveKeyHandle -> handle, salt
+  result?: Record<string, string | number>;
+  error?: string; // Present when FAILED
+}
+
+export interface JobProgressEvent {
+  jobId: number;
+  progress: number; // 0 to 1, in whole-percent steps; sent by key derivation jobs
+}
+
 export interface SignatureOptions {
   algorithm: HashAlgorithm;
 }
@@ -102,3 +171,74 @@ export interface SignatureOptions {
 export interface RandomBytesOptions {
   length: number;
 }
+
+export interface VaultOptions {
+  algorithm?: CipherAlgorithm; // Must be an AEAD cipher (default: AES_256_GCM)
+}
+
+export interface JournalOptions {
+  algorithm?: CipherAlgorithm; // Must be an AEAD cipher (default: AES_256_GCM)
+}
+
+export interface JournalRecoveryStats {
+  handle: number;
+  replayedEntries: number; // Journal entries applied on top of the vault snapshot
+  journalBytes: number;
+  recoveryMillis: number;
+}
+
+export interface JournalRecord {
+  name: string;
+  order: number;
+  data: string; // Base64 encoded account payload
+}
+
+export interface SyncPackResult {
+  manifest: string; // Base64 encoded sealed manifest, uploaded last
+  chunkIds: string[]; // Every chunk the manifest references, in order
+  chunks: Record<string, string>; // Chunk id -> Base64 sealed chunk, only those not already remote
+  staleChunks: string[]; // Remote chunks no longer referenced; delete after the manifest is uploaded
+  totalBytes: number;
+  uploadBytes: number;
+}
+
+export interface SyncDirectoryResult {
+  chunkCount: number;
+  uploadedChunks: number;
+  removedChunks: number;
+  totalBytes: number;
+  uploadBytes: number;
+}
+
+export type MergeConflictKind =
+  | 'BOTH_MODIFIED' // Local version kept
+  | 'BOTH_ADDED' // Local version kept
+  | 'DELETED_LOCALLY' // Remote version kept
+  | 'DELETED_REMOTELY'; // Local version kept
+
+export interface MergeConflict {
+  id: string;
+  kind: MergeConflictKind;
+}
+
+export interface MergeResult {
+  merged: string; // Base64 encoded record stream
+  mergedCount: number;
+  conflicts: MergeConflict[];
+}
+
+export enum CompressionMode {
+  NONE = 'NONE',
+  FAST = 'FAST', // LZ4 block format; cheap enough to leave on
+  HIGH = 'HIGH', // Deflate level 9; smaller output, several times slower to seal
+}
+
+export interface StreamOptions {
+  algorithm?: CipherAlgorithm; // AES_*_GCM or CHACHA20_POLY1305 (default: AES_256_GCM)
+  compression?: CompressionMode; // Default: FAST
+}
+
+export interface StreamFileResult {
+  bytesIn: number;
+  bytesOut: number;
+}
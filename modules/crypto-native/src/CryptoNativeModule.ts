@@ -1,17 +1,36 @@
 import { NativeModule, requireNativeModule } from 'expo';
 
 import {
+  BatchOptions,
+  BatchRecord,
+  CryptoNativeModuleEvents,
   DecryptionOptions,
   DerivedKey,
+  DerivedKeyHandle,
   EncryptionOptions,
   EncryptionResult,
   HashAlgorithm,
+  HkdfExpandOptions,
+  HkdfExtractOptions,
   HmacOptions,
+  JobOptions,
+  JournalOptions,
+  JournalRecord,
+  JournalRecoveryStats,
+  KdfCalibration,
+  KdfCalibrationOptions,
   KeyDerivationOptions,
-  RandomBytesOptions
+  KeyHandleDerivationOptions,
+  MergeResult,
+  RandomBytesOptions,
+  StreamFileResult,
+  StreamOptions,
+  SyncDirectoryResult,
+  SyncPackResult,
+  VaultOptions
 } from './CryptoNative.types';
 
-declare class CryptoNativeModule extends NativeModule {
+declare class CryptoNativeModule extends NativeModule<CryptoNativeModuleEvents> {
 
   // Core Cryptographic Functions
   
@@ -33,6 +52,43 @@ declare class CryptoNativeModule extends NativeModule {
    */
   decrypt(ciphertext: string, key: string, options: DecryptionOptions): Promise<string>;
 
+  /**
+   * Encrypts data under a native key handle
+   * @param data - Data to encrypt (Base64 encoded)
+   * @param key - Key handle from importKey or deriveKeyHandle
+   * @param options - Encryption options
+   * @returns Promise resolving to encryption result
+   */
+  encryptWithKey(data: string, key: number, options: EncryptionOptions): Promise<EncryptionResult>;
+
+  /**
+   * Decrypts data under a native key handle
+   * @param ciphertext - Encrypted data (Base64 encoded)
+   * @param key - Key handle from importKey or deriveKeyHandle
+   * @param options - Decryption options
+   * @returns Promise resolving to decrypted data (Base64 encoded)
+   */
+  decryptWithKey(ciphertext: string, key: number, options: DecryptionOptions): Promise<string>;
+
+  /**
+   * Seals many small records under one key handle. Nonces come from a per-key counter;
+   * each sealed record is nonce (12 bytes) || ciphertext || tag (16 bytes).
+   * @param key - Key handle from importKey or deriveKeyHandle
+   * @param records - Plaintexts with optional AAD
+   * @param options - Batch options
+   * @returns Promise resolving to the sealed records (Base64 encoded), in input order
+   */
+  sealBatch(key: number, records: BatchRecord[], options: BatchOptions): Promise<string[]>;
+
+  /**
+   * Opens records produced by sealBatch; rejects if any record fails authentication
+   * @param key - Key handle from importKey or deriveKeyHandle
+   * @param records - Sealed records with the AAD they were sealed with
+   * @param options - Batch options
+   * @returns Promise resolving to the plaintexts (Base64 encoded), in input order
+   */
+  openBatch(key: number, records: BatchRecord[], options: BatchOptions): Promise<string[]>;
+
   // Key Management
 
   /**
@@ -59,6 +115,56 @@ declare class CryptoNativeModule extends NativeModule {
    */
   deriveKeyWithSalt(password: string, salt: string, options: KeyDerivationOptions): Promise<string>;
 
+  /**
+   * Times short KDF probes on this device and picks the iteration count that
+   * meets a target derivation time. Probing runs once per process.
+   * @param options - KDF, key length and target time
+   * @returns Promise resolving to the calibrated parameters
+   */
+  calibrateKdf(options: KdfCalibrationOptions): Promise<KdfCalibration>;
+
+  // Key Handles
+
+  /**
+   * Moves a key into native memory. The key schedule is cached with the handle,
+   * so repeated operations skip key marshalling and setup.
+   * @param key - Key (Base64 encoded)
+   * @returns Promise resolving to a key handle
+   */
+  importKey(key: string): Promise<number>;
+
+  /**
+   * Derives a key from password and keeps it in native memory
+   * @param password - Password string
+   * @param options - Key derivation options, optionally with an existing salt
+   * @returns Promise resolving to the key handle and salt
+   */
+  deriveKeyHandle(password: string, options: KeyHandleDerivationOptions): Promise<DerivedKeyHandle>;
+
+  /**
+   * Wipes the key behind a handle
+   * @param handle - Key handle
+   */
+  releaseKey(handle: number): Promise<void>;
+
+  /**
+   * HKDF-Extract (RFC 5869) of the key behind a handle
+   * @param key - Input keying material handle
+   * @param options - Salt and hash
+   * @returns Promise resolving to a handle for the pseudorandom key
+   */
+  hkdfExtract(key: number, options: HkdfExtractOptions): Promise<number>;
+
+  /**
+   * HKDF-Expand one subkey per label from a single PRK. The PRK is keyed once,
+   * so thousands of labels cost a few HMAC blocks each.
+   * @param prk - Pseudorandom key handle from hkdfExtract (or any uniformly random key)
+   * @param labels - Info labels (UTF-8), e.g. "account:<id>"
+   * @param options - Subkey length and hash
+   * @returns Promise resolving to one key handle per label, in order
+   */
+  hkdfExpand(prk: number, labels: string[], options: HkdfExpandOptions): Promise<number[]>;
+
   // Hashing and HMAC
 
   /**
@@ -78,6 +184,65 @@ declare class CryptoNativeModule extends NativeModule {
    */
   hmac(data: string, key: string, options: HmacOptions): Promise<string>;
 
+  /**
+   * Computes HMAC of data under a native key handle
+   * @param data - Data to authenticate (Base64 encoded)
+   * @param key - Key handle from importKey or deriveKeyHandle
+   * @param options - HMAC options
+   * @returns Promise resolving to HMAC (Base64 encoded)
+   */
+  hmacWithKey(data: string, key: number, options: HmacOptions): Promise<string>;
+
+  // Background Jobs
+  //
+  // Jobs run on a native worker pool and report through the onJobComplete event,
+  // exactly once per job id. INTERACTIVE jobs always run ahead of BACKGROUND ones,
+  // and one worker is kept for them alone.
+
+  /**
+   * Queues encryption under a native key handle
+   * @param data - Data to encrypt (Base64 encoded)
+   * @param key - Key handle from importKey or deriveKeyHandle
+   * @param options - Encryption options and job priority
+   * @returns Promise resolving to the job id
+   */
+  submitEncryptWithKey(data: string, key: number, options: EncryptionOptions & JobOptions): Promise<number>;
+
+  /**
+   * Queues decryption under a native key handle
+   * @param ciphertext - Encrypted data (Base64 encoded)
+   * @param key - Key handle from importKey or deriveKeyHandle
+   * @param options - Decryption options and job priority
+   * @returns Promise resolving to the job id
+   */
+  submitDecryptWithKey(ciphertext: string, key: number, options: DecryptionOptions & JobOptions): Promise<number>;
+
+  /**
+   * Queues an HMAC under a native key handle, interactive by default
+   * @param data - Data to authenticate (Base64 encoded)
+   * @param key - Key handle from importKey or deriveKeyHandle
+   * @param options - HMAC options and job priority
+   * @returns Promise resolving to the job id
+   */
+  submitHmacWithKey(data: string, key: number, options: HmacOptions & JobOptions): Promise<number>;
+
+  /**
+   * Queues a key derivation whose result stays in native memory. Reports
+   * onJobProgress as it runs and stops within a few thousand iterations of cancelJob.
+   * @param password - Password string
+   * @param options - Key derivation options and job priority
+   * @returns Promise resolving to the job id
+   */
+  submitDeriveKeyHandle(password: string, options: KeyHandleDerivationOptions & JobOptions): Promise<number>;
+
+  /**
+   * Cancels a queued or running job. A queued job reports CANCELLED without running;
+   * a running one reports CANCELLED if it notices before finishing.
+   * @param jobId - Id returned by a submit call
+   * @returns Promise resolving to false if the job had already finished
+   */
+  cancelJob(jobId: number): Promise<boolean>;
+
   // Random Number Generation
 
   /**
@@ -134,6 +299,229 @@ declare class CryptoNativeModule extends NativeModule {
    * @returns Promise resolving to boolean indicating equality
    */
   secureCompare(a: string, b: string): Promise<boolean>;
+
+  // Vault Store
+
+  /**
+   * Opens (or creates) a binary vault file with one AEAD-sealed record per account
+   * @param path - Absolute path, file:// URI, or path relative to the app files directory
+   * @param key - Vault key (Base64 encoded)
+   * @param options - Vault options
+   * @returns Promise resolving to a vault handle
+   */
+  vaultOpen(path: string, key: string, options: VaultOptions): Promise<number>;
+
+  /**
+   * Closes a vault handle
+   * @param handle - Vault handle
+   */
+  vaultClose(handle: number): Promise<void>;
+
+  /**
+   * Lists record ids without decrypting any record
+   * @param handle - Vault handle
+   * @returns Promise resolving to record ids
+   */
+  vaultIds(handle: number): Promise<string[]>;
+
+  /**
+   * Decrypts a single record
+   * @param handle - Vault handle
+   * @param id - Record id
+   * @returns Promise resolving to the record plaintext (Base64 encoded)
+   */
+  vaultGet(handle: number, id: string): Promise<string>;
+
+  /**
+   * Seals and writes a single record; other records are not touched
+   * @param handle - Vault handle
+   * @param id - Record id
+   * @param data - Record plaintext (Base64 encoded)
+   */
+  vaultPut(handle: number, id: string, data: string): Promise<void>;
+
+  /**
+   * Removes a single record
+   * @param handle - Vault handle
+   * @param id - Record id
+   * @returns Promise resolving to whether the record existed
+   */
+  vaultRemove(handle: number, id: string): Promise<boolean>;
+
+  /**
+   * Flushes written records to stable storage
+   * @param handle - Vault handle
+   */
+  vaultSync(handle: number): Promise<void>;
+
+  // Account Journal
+
+  /**
+   * Opens (or creates) the account journal and its vault snapshot in a directory,
+   * replaying any entries not yet compacted into the vault
+   * @param directory - Directory holding accounts.vault and accounts.journal
+   * @param key - Vault key (Base64 encoded)
+   * @param options - Journal options
+   * @returns Promise resolving to the journal handle and recovery statistics
+   */
+  journalOpen(directory: string, key: string, options: JournalOptions): Promise<JournalRecoveryStats>;
+
+  /**
+   * Closes a journal handle
+   * @param handle - Journal handle
+   */
+  journalClose(handle: number): Promise<void>;
+
+  /**
+   * Appends a full account record
+   * @param handle - Journal handle
+   * @param id - Account id
+   * @param record - Account name, order and payload
+   */
+  journalPut(handle: number, id: string, record: JournalRecord): Promise<void>;
+
+  /**
+   * Appends a rename without rewriting the account payload
+   * @param handle - Journal handle
+   * @param id - Account id
+   * @param name - New display name
+   */
+  journalRename(handle: number, id: string, name: string): Promise<void>;
+
+  /**
+   * Appends a single entry carrying the new order of several accounts
+   * @param handle - Journal handle
+   * @param orders - Map of account id to its new order
+   */
+  journalReorder(handle: number, orders: Record<string, number>): Promise<void>;
+
+  /**
+   * Appends a removal
+   * @param handle - Journal handle
+   * @param id - Account id
+   * @returns Promise resolving to true if the account existed
+   */
+  journalRemove(handle: number, id: string): Promise<boolean>;
+
+  /**
+   * Reads the current state of an account
+   * @param handle - Journal handle
+   * @param id - Account id
+   * @returns Promise resolving to the record, or null if unknown
+   */
+  journalGet(handle: number, id: string): Promise<JournalRecord | null>;
+
+  /**
+   * Lists the ids of all live accounts
+   * @param handle - Journal handle
+   */
+  journalIds(handle: number): Promise<string[]>;
+
+  /**
+   * Folds the journal into the vault snapshot immediately
+   * @param handle - Journal handle
+   */
+  journalCompact(handle: number): Promise<void>;
+
+  // Sync Packer
+
+  /**
+   * Splits serialized vault data into content-defined chunks and seals them for upload.
+   * Chunk ids are deterministic, so only chunks missing from the remote are returned.
+   * @param data - Serialized vault (Base64 encoded)
+   * @param key - Sync master key (Base64 encoded)
+   * @param remoteChunks - Chunk ids already present on the remote
+   * @returns Promise resolving to the sealed manifest, the chunks to upload and the
+   *   remote chunks to delete once the manifest is committed
+   */
+  syncPack(data: string, key: string, remoteChunks: string[]): Promise<SyncPackResult>;
+
+  /**
+   * Lists the chunk ids referenced by a sealed manifest
+   * @param manifest - Sealed manifest (Base64 encoded)
+   * @param key - Sync master key (Base64 encoded)
+   */
+  syncManifestChunks(manifest: string, key: string): Promise<string[]>;
+
+  /**
+   * Reassembles serialized vault data from a manifest and its chunks
+   * @param manifest - Sealed manifest (Base64 encoded)
+   * @param key - Sync master key (Base64 encoded)
+   * @param chunks - Chunk id -> Base64 sealed chunk for every id in the manifest
+   * @returns Promise resolving to the serialized vault (Base64 encoded)
+   */
+  syncUnpack(manifest: string, key: string, chunks: Record<string, string>): Promise<string>;
+
+  /**
+   * Packs into a local directory laid out like the remote (manifest + chunks/<id>),
+   * writing only missing chunks and removing those the new manifest no longer uses
+   * @param data - Serialized vault (Base64 encoded)
+   * @param key - Sync master key (Base64 encoded)
+   * @param directory - Target directory
+   */
+  syncPackToDirectory(data: string, key: string, directory: string): Promise<SyncDirectoryResult>;
+
+  /**
+   * Reassembles serialized vault data from a directory written by syncPackToDirectory
+   * @param directory - Source directory
+   * @param key - Sync master key (Base64 encoded)
+   * @returns Promise resolving to the serialized vault (Base64 encoded)
+   */
+  syncUnpackFromDirectory(directory: string, key: string): Promise<string>;
+
+  // Merge Engine
+
+  /**
+   * Three-way merges account sets. Each argument is a Base64 encoded record stream of
+   * repeated [u16 idLength][u32 dataLength][id][data] (little-endian).
+   * Non-conflicting changes from both sides are applied; conflicts are reported and resolved
+   * towards the side that still has the account, preferring local.
+   * @param base - Last synced state
+   * @param local - Current local state
+   * @param remote - Current remote state
+   * @returns Promise resolving to the merged record stream and the conflict list
+   */
+  merge(base: string, local: string, remote: string): Promise<MergeResult>;
+
+  // Sealed Streams
+
+  /**
+   * Compresses then encrypts data as a segmented stream; every segment is authenticated
+   * on its own and the last one is marked, so reordering and truncation are detected
+   * @param key - Key handle
+   * @param data - Data to seal (Base64 encoded)
+   * @param options - Cipher and compression mode
+   * @returns Promise resolving to the sealed stream (Base64 encoded)
+   */
+  sealStream(key: number, data: string, options: StreamOptions): Promise<string>;
+
+  /**
+   * Opens a stream produced by sealStream or sealFile; the cipher and compression are
+   * read from its header
+   * @param key - Key handle
+   * @param sealed - Sealed stream (Base64 encoded)
+   * @returns Promise resolving to the original data (Base64 encoded)
+   */
+  openStream(key: number, sealed: string): Promise<string>;
+
+  /**
+   * Streams a file through compression and encryption without loading it whole.
+   * Output only appears at outputPath once complete.
+   * @param key - Key handle
+   * @param inputPath - File to seal
+   * @param outputPath - Destination of the sealed stream
+   * @param options - Cipher and compression mode
+   */
+  sealFile(key: number, inputPath: string, outputPath: string, options: StreamOptions): Promise<StreamFileResult>;
+
+  /**
+   * Decrypts and decompresses a sealed file. Output only appears at outputPath once
+   * every segment has authenticated and the stream is complete.
+   * @param key - Key handle
+   * @param inputPath - Sealed stream
+   * @param outputPath - Destination of the original data
+   */
+  openFile(key: number, inputPath: string, outputPath: string): Promise<StreamFileResult>;
 }
 
 // This call loads the native module object from the JSI.
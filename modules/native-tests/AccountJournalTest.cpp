@@ -0,0 +1,259 @@
+#include "AccountJournal.h"
+#include "CryptoEngine.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+// Journals are written to a temp directory, then cut or patched on disk
+// between sessions to simulate a crash mid-append and a tampered frame.
+
+using crypto_native::AccountJournal;
+using crypto_native::AccountState;
+using crypto_native::CryptoEngine;
+using crypto_native::CryptoOperationException;
+using crypto_native::InvalidParameterException;
+using crypto_native::SecureBytes;
+
+namespace {
+
+// Journal layout from AccountJournal.h
+constexpr off_t JOURNAL_HEADER = 16;
+constexpr off_t FRAME_HEADER = 48;
+
+AccountState account(const std::string& name, int32_t order, const std::string& payload) {
+    AccountState state;
+    state.name = name;
+    state.order = order;
+    state.payload.assign(payload.begin(), payload.end());
+    return state;
+}
+
+std::string payloadOf(const AccountState& state) {
+    return std::string(state.payload.begin(), state.payload.end());
+}
+
+off_t fileSize(const std::string& path) {
+    struct stat st{};
+    CHECK(stat(path.c_str(), &st) == 0);
+    return st.st_size;
+}
+
+uint32_t frameBodyLength(const std::string& path, off_t offset) {
+    uint32_t length = 0;
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    CHECK(pread(fd, &length, sizeof(length), offset) == static_cast<ssize_t>(sizeof(length)));
+    ::close(fd);
+    return length;
+}
+
+struct TempDirectory {
+    std::string path;
+
+    TempDirectory() {
+        char pattern[] = "/tmp/journaltestXXXXXX";
+        path = mkdtemp(pattern);
+    }
+
+    std::string journal() const { return path + "/accounts.journal"; }
+
+    ~TempDirectory() {
+        std::remove(journal().c_str());
+        std::remove((path + "/accounts.vault").c_str());
+        rmdir((journal() + ".tmp").c_str());
+        rmdir(path.c_str());
+    }
+};
+
+// Three puts, a rename and a reorder: five frames
+void writeSession(CryptoEngine& engine, const SecureBytes& key, const std::string& directory) {
+    AccountJournal journal(engine, key);
+    const auto stats = journal.open(directory);
+    CHECK_EQ(stats.replayedEntries, uint64_t(0));
+    journal.put("a", account("Alpha", 0, "secret a"));
+    journal.put("b", account("Beta", 1, "secret b"));
+    journal.put("c", account("Gamma", 2, "secret c"));
+    journal.rename("b", "Beta renamed");
+    journal.reorder({{"a", 2}, {"c", 0}});
+}
+
+void testRoundTrip(CryptoEngine& engine, const SecureBytes& key) {
+    TempDirectory temp;
+    writeSession(engine, key, temp.path);
+
+    AccountJournal journal(engine, key);
+    const auto stats = journal.open(temp.path);
+    CHECK_EQ(stats.replayedEntries, uint64_t(5));
+    CHECK_EQ(stats.journalBytes, uint64_t(fileSize(temp.journal())));
+
+    std::vector<std::string> ids = journal.ids();
+    std::sort(ids.begin(), ids.end());
+    CHECK_EQ(ids.size(), size_t(3));
+
+    AccountState state;
+    CHECK(journal.get("b", state));
+    CHECK_EQ(state.name, std::string("Beta renamed"));
+    CHECK_EQ(payloadOf(state), std::string("secret b"));
+    CHECK(journal.get("a", state));
+    CHECK_EQ(state.order, 2);
+    CHECK(journal.get("c", state));
+    CHECK_EQ(state.order, 0);
+
+    CHECK(journal.remove("a"));
+    CHECK(!journal.remove("a"));
+    CHECK(!journal.get("a", state));
+
+    bool threw = false;
+    try {
+        journal.rename("missing", "x");
+    } catch (const InvalidParameterException&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void testTornTail(CryptoEngine& engine, const SecureBytes& key) {
+    {
+        // Half of the last frame made it to disk
+        TempDirectory temp;
+        writeSession(engine, key, temp.path);
+        const off_t full = fileSize(temp.journal());
+        CHECK(truncate(temp.journal().c_str(), full - 10) == 0);
+
+        AccountJournal journal(engine, key);
+        const auto stats = journal.open(temp.path);
+        CHECK_EQ(stats.replayedEntries, uint64_t(4));
+        // The partial frame is cut off, so new appends start on a frame boundary
+        CHECK(fileSize(temp.journal()) < full - 10);
+        AccountState state;
+        CHECK(journal.get("c", state));
+        CHECK_EQ(state.order, 2);
+        CHECK(journal.get("b", state));
+        CHECK_EQ(state.name, std::string("Beta renamed"));
+
+        journal.put("d", account("Delta", 3, "secret d"));
+        journal.close();
+        CHECK_EQ(journal.open(temp.path).replayedEntries, uint64_t(5));
+        CHECK(journal.get("d", state));
+    }
+    {
+        // Garbage after the last complete frame
+        TempDirectory temp;
+        writeSession(engine, key, temp.path);
+        const off_t full = fileSize(temp.journal());
+        FILE* file = std::fopen(temp.journal().c_str(), "ab");
+        std::fputs("torn write, not a frame at all, but longer than a frame header .....", file);
+        std::fclose(file);
+
+        AccountJournal journal(engine, key);
+        CHECK_EQ(journal.open(temp.path).replayedEntries, uint64_t(5));
+        CHECK_EQ(fileSize(temp.journal()), full);
+    }
+    {
+        // A tampered frame ends replay there; nothing after it is trusted
+        TempDirectory temp;
+        writeSession(engine, key, temp.path);
+        const off_t second = JOURNAL_HEADER + FRAME_HEADER + frameBodyLength(temp.journal(), JOURNAL_HEADER);
+        const int fd = ::open(temp.journal().c_str(), O_RDWR);
+        uint8_t byte = 0;
+        CHECK(pread(fd, &byte, 1, second + FRAME_HEADER) == 1);
+        byte ^= 0x80;
+        CHECK(pwrite(fd, &byte, 1, second + FRAME_HEADER) == 1);
+        ::close(fd);
+
+        AccountJournal journal(engine, key);
+        CHECK_EQ(journal.open(temp.path).replayedEntries, uint64_t(1));
+        CHECK_EQ(fileSize(temp.journal()), second);
+        CHECK_EQ(journal.ids().size(), size_t(1));
+    }
+}
+
+void testReplayAfterCompaction(CryptoEngine& engine, const SecureBytes& key) {
+    TempDirectory temp;
+    writeSession(engine, key, temp.path);
+    {
+        AccountJournal journal(engine, key);
+        CHECK_EQ(journal.open(temp.path).replayedEntries, uint64_t(5));
+        journal.compact();
+        CHECK_EQ(journal.journalBytes(), uint64_t(JOURNAL_HEADER));
+
+        journal.rename("a", "Alpha renamed");
+        journal.remove("c");
+        journal.put("d", account("Delta", 3, "secret d"));
+    }
+
+    // Only the three entries after the fold are replayed over the vault
+    AccountJournal journal(engine, key);
+    const auto stats = journal.open(temp.path);
+    CHECK_EQ(stats.replayedEntries, uint64_t(3));
+    std::vector<std::string> ids = journal.ids();
+    std::sort(ids.begin(), ids.end());
+    CHECK_EQ(ids.size(), size_t(3));
+    CHECK_EQ(ids[0] + ids[1] + ids[2], std::string("abd"));
+
+    AccountState state;
+    CHECK(journal.get("a", state));
+    CHECK_EQ(state.name, std::string("Alpha renamed"));
+    CHECK_EQ(state.order, 2);
+    CHECK_EQ(payloadOf(state), std::string("secret a"));
+    CHECK(journal.get("b", state));
+    CHECK_EQ(state.name, std::string("Beta renamed"));
+    CHECK(!journal.get("c", state));
+
+    // A second fold leaves nothing to replay
+    journal.compact();
+    journal.close();
+    CHECK_EQ(journal.open(temp.path).replayedEntries, uint64_t(0));
+    CHECK_EQ(journal.ids().size(), size_t(3));
+}
+
+void testCompactionFailure(CryptoEngine& engine, const SecureBytes& key) {
+    TempDirectory temp;
+    writeSession(engine, key, temp.path);
+
+    AccountJournal journal(engine, key);
+    journal.open(temp.path);
+    const uint64_t before = journal.journalBytes();
+
+    // The journal cannot be replaced while its temp path is a directory
+    CHECK(mkdir((temp.journal() + ".tmp").c_str(), 0700) == 0);
+    bool threw = false;
+    try {
+        journal.compact();
+    } catch (const CryptoOperationException&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK_EQ(journal.journalBytes(), before);
+
+    // The journal stays usable, and the frames already folded into the vault
+    // are not applied a second time on the next open
+    journal.rename("c", "Gamma renamed");
+    journal.close();
+    CHECK_EQ(journal.open(temp.path).replayedEntries, uint64_t(1));
+    AccountState state;
+    CHECK(journal.get("c", state));
+    CHECK_EQ(state.name, std::string("Gamma renamed"));
+
+    CHECK(rmdir((temp.journal() + ".tmp").c_str()) == 0);
+    journal.compact();
+    CHECK_EQ(journal.journalBytes(), uint64_t(JOURNAL_HEADER));
+}
+
+} // namespace
+
+int main() {
+    CryptoEngine engine;
+    const SecureBytes key = engine.generateKey(32);
+    testRoundTrip(engine, key);
+    testTornTail(engine, key);
+    testReplayAfterCompaction(engine, key);
+    testCompactionFailure(engine, key);
+    return native_tests::finish("AccountJournal");
+}
@@ -0,0 +1,163 @@
+#include "CryptoEngine.h"
+#include "OtpImport.h"
+#include "TestSupport.h"
+#include <string>
+
+// Encrypted backups are sealed here with the same engine the importer uses,
+// so these run on the NO_OPENSSL primitives the app libraries ship with.
+
+using crypto_native::CipherAlgorithm;
+using crypto_native::CryptoEngine;
+using crypto_native::CryptoOperationException;
+using crypto_native::HashAlgorithm;
+using crypto_native::InvalidKeyException;
+using crypto_native::PaddingMode;
+using crypto_native::SecureBytes;
+using OtpImport::BackupFormat;
+using OtpImport::ImportBatch;
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+// Small enough to keep the suite fast; the importer accepts any valid N
+constexpr uint32_t TEST_SCRYPT_N = 1024;
+
+const char* const AEGIS_ENTRIES =
+    "{\"version\":2,\"entries\":["
+    "{\"type\":\"totp\",\"name\":\"alice@example.com\",\"issuer\":\"Acme\","
+    "\"info\":{\"secret\":\"JBSWY3DPEHPK3PXP\",\"algo\":\"SHA256\",\"digits\":8,\"period\":30}},"
+    "{\"type\":\"hotp\",\"name\":\"bob\",\"issuer\":\"GitHub\","
+    "\"info\":{\"secret\":\"JBSWY3DPEHPK3PXP\",\"algo\":\"SHA1\",\"digits\":6,\"counter\":42}}]}";
+
+const char* const ANDOTP_ENTRIES =
+    "[{\"secret\":\"JBSWY3DPEHPK3PXP\",\"issuer\":\"Acme\",\"label\":\"alice\",\"digits\":6,"
+    "\"type\":\"TOTP\",\"algorithm\":\"SHA1\",\"period\":30,\"tags\":[]}]";
+
+const char* const TWOFAS_SERVICES =
+    "[{\"name\":\"Google\",\"secret\":\"JBSWY3DPEHPK3PXP\","
+    "\"otp\":{\"account\":\"me@example.com\",\"issuer\":\"Google\",\"digits\":6,\"period\":30,"
+    "\"algorithm\":\"SHA1\",\"tokenType\":\"TOTP\"}}]";
+
+Bytes bytesOf(const std::string& text) {
+    return Bytes(text.begin(), text.end());
+}
+
+SecureBytes secureOf(const Bytes& data) {
+    return SecureBytes(data.begin(), data.end());
+}
+
+std::string hex(const Bytes& data) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (uint8_t byte : data) {
+        out.push_back(digits[byte >> 4]);
+        out.push_back(digits[byte & 0x0F]);
+    }
+    return out;
+}
+
+// One password slot as Aegis writes it, wrapping `masterKey`
+std::string aegisSlot(CryptoEngine& engine, const std::string& password, const SecureBytes& masterKey) {
+    Bytes salt = engine.randomBytes(32);
+    SecureBytes slotKey = engine.deriveScrypt(password, salt, TEST_SCRYPT_N, 8, 1, 32);
+    auto wrapped = engine.encrypt(Bytes(masterKey.begin(), masterKey.end()), slotKey, CipherAlgorithm::AES_256_GCM,
+                                  PaddingMode::NONE);
+    return "{\"type\":1,\"uuid\":\"" + password + "\",\"key\":\"" + hex(wrapped.ciphertext) +
+           "\",\"key_params\":{\"nonce\":\"" + hex(wrapped.iv) + "\",\"tag\":\"" + hex(wrapped.tag) +
+           "\"},\"n\":" + std::to_string(TEST_SCRYPT_N) + ",\"r\":8,\"p\":1,\"salt\":\"" + hex(salt) + "\"}";
+}
+
+// A vault with a slot for each password, in order
+std::string aegisVault(CryptoEngine& engine, const std::vector<std::string>& passwords) {
+    SecureBytes masterKey = engine.generateKey(32);
+    std::string slots;
+    for (const std::string& password : passwords) {
+        slots += (slots.empty() ? "" : ",") + aegisSlot(engine, password, masterKey);
+    }
+    auto db = engine.encrypt(bytesOf(AEGIS_ENTRIES), masterKey, CipherAlgorithm::AES_256_GCM, PaddingMode::NONE);
+    return "{\"version\":1,\"header\":{\"slots\":[" + slots + "],\"params\":{\"nonce\":\"" + hex(db.iv) +
+           "\",\"tag\":\"" + hex(db.tag) + "\"}},\"db\":\"" + CryptoEngine::encodeBase64(db.ciphertext) + "\"}";
+}
+
+template <typename Exception>
+bool throwsOnly(BackupFormat format, const Bytes& data, const std::string& password) {
+    try {
+        OtpImport::parseBackup(format, secureOf(data), password);
+    } catch (const Exception&) {
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return false;
+}
+
+void testAegis(CryptoEngine& engine) {
+    // The second slot's password opens the vault after the first fails
+    Bytes vault = bytesOf(aegisVault(engine, {"first", "second"}));
+    ImportBatch batch = OtpImport::parseBackup(BackupFormat::AEGIS, secureOf(vault), "second");
+    CHECK_EQ(batch.accounts.size(), size_t(2));
+    CHECK_EQ(batch.rejected, uint32_t(0));
+    if (batch.accounts.size() == 2) {
+        CHECK_EQ(batch.issuer(batch.accounts[0]), std::string("Acme"));
+        CHECK_EQ(batch.name(batch.accounts[1]), std::string("bob"));
+        CHECK_EQ(batch.accounts[1].counter, uint64_t(42));
+    }
+
+    CHECK(throwsOnly<InvalidKeyException>(BackupFormat::AEGIS, vault, "neither"));
+
+    // A vault that fails authentication under the right key is not a password error
+    Bytes tampered = vault;
+    const size_t db = std::string(tampered.begin(), tampered.end()).find("\"db\":\"") + 6;
+    tampered[db] = tampered[db] == 'A' ? 'B' : 'A';
+    CHECK(throwsOnly<CryptoOperationException>(BackupFormat::AEGIS, tampered, "second"));
+    CHECK(!throwsOnly<InvalidKeyException>(BackupFormat::AEGIS, tampered, "second"));
+}
+
+void testAndOtp(CryptoEngine& engine) {
+    const uint32_t iterations = 1000;
+    Bytes salt = engine.randomBytes(12);
+    SecureBytes key = engine.derivePbkdf2("pw", salt, iterations, 32, HashAlgorithm::SHA1);
+    auto sealed = engine.encrypt(bytesOf(ANDOTP_ENTRIES), key, CipherAlgorithm::AES_256_GCM, PaddingMode::NONE);
+
+    Bytes file = {uint8_t(iterations >> 24), uint8_t(iterations >> 16), uint8_t(iterations >> 8), uint8_t(iterations)};
+    file.insert(file.end(), salt.begin(), salt.end());
+    file.insert(file.end(), sealed.iv.begin(), sealed.iv.end());
+    file.insert(file.end(), sealed.ciphertext.begin(), sealed.ciphertext.end());
+    file.insert(file.end(), sealed.tag.begin(), sealed.tag.end());
+
+    ImportBatch batch = OtpImport::parseBackup(BackupFormat::ANDOTP, secureOf(file), "pw");
+    CHECK_EQ(batch.accounts.size(), size_t(1));
+    if (!batch.accounts.empty()) {
+        CHECK_EQ(batch.name(batch.accounts[0]), std::string("alice"));
+    }
+    CHECK(throwsOnly<InvalidKeyException>(BackupFormat::ANDOTP, file, "px"));
+}
+
+void testTwoFas(CryptoEngine& engine) {
+    Bytes salt = engine.randomBytes(256);
+    SecureBytes key = engine.derivePbkdf2("pw", salt, 10000, 32, HashAlgorithm::SHA256);
+    auto sealed = engine.encrypt(bytesOf(TWOFAS_SERVICES), key, CipherAlgorithm::AES_256_GCM, PaddingMode::NONE);
+    sealed.ciphertext.insert(sealed.ciphertext.end(), sealed.tag.begin(), sealed.tag.end());
+
+    Bytes document = bytesOf("{\"services\":[],\"schemaVersion\":4,\"servicesEncrypted\":\"" +
+                             CryptoEngine::encodeBase64(sealed.ciphertext) + ":" + CryptoEngine::encodeBase64(salt) +
+                             ":" + CryptoEngine::encodeBase64(sealed.iv) + "\"}");
+
+    ImportBatch batch = OtpImport::parseBackup(BackupFormat::TWOFAS, secureOf(document), "pw");
+    CHECK_EQ(batch.accounts.size(), size_t(1));
+    if (!batch.accounts.empty()) {
+        CHECK_EQ(batch.issuer(batch.accounts[0]), std::string("Google"));
+    }
+    CHECK(throwsOnly<InvalidKeyException>(BackupFormat::TWOFAS, document, "px"));
+}
+
+} // namespace
+
+int main() {
+    CryptoEngine engine;
+    testAegis(engine);
+    testAndOtp(engine);
+    testTwoFas(engine);
+    return native_tests::finish("BackupImport");
+}
@@ -0,0 +1,283 @@
+#include "CryptoEngine.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <set>
+#include <string>
+#include <vector>
+
+// sealBatch/openBatch through the NO_OPENSSL engine the app libraries ship.
+// A replaced operator delete inspects the plaintext buffer openBatch frees
+// when a record fails, to check it was wiped first.
+
+using crypto_native::AuthenticationFailedException;
+using crypto_native::BatchRecord;
+using crypto_native::CipherAlgorithm;
+using crypto_native::CryptoEngine;
+using crypto_native::InvalidParameterException;
+using crypto_native::KeyHandle;
+using crypto_native::PaddingMode;
+
+namespace crypto_native {
+
+struct KeyHandleTestPeer {
+    static void setCounter(KeyHandle& key, uint32_t counter) { key.nonceCounter_ = counter; }
+};
+
+} // namespace crypto_native
+
+namespace {
+
+// Allocation watched by the replaced operator new/delete below
+size_t watchedSize = 0;
+void* watchedBlock = nullptr;
+bool watchedFreed = false;
+bool watchedWiped = false;
+
+} // namespace
+
+void* operator new(size_t size) {
+    void* block = std::malloc(size ? size : 1);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    if (watchedSize && size == watchedSize && !watchedBlock) {
+        watchedBlock = block;
+    }
+    return block;
+}
+
+void operator delete(void* block) noexcept {
+    if (block && block == watchedBlock) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(block);
+        watchedWiped = std::all_of(bytes, bytes + watchedSize, [](uint8_t b) { return b == 0; });
+        watchedFreed = true;
+        watchedBlock = nullptr;
+        watchedSize = 0;
+    }
+    std::free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    operator delete(block);
+}
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+constexpr size_t NONCE = CryptoEngine::kBatchNonceSize;
+constexpr size_t TAG = CryptoEngine::kBatchTagSize;
+
+struct Batch {
+    std::vector<Bytes> plaintexts;
+    std::vector<Bytes> aads;
+
+    std::vector<BatchRecord> records() const {
+        std::vector<BatchRecord> out(plaintexts.size());
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] = {plaintexts[i].data(), plaintexts[i].size(), aads[i].data(), aads[i].size()};
+        }
+        return out;
+    }
+};
+
+// Lengths chosen off the AES block size, including an empty record
+Batch makeBatch(size_t count, size_t baseLength = 0) {
+    Batch batch;
+    for (size_t i = 0; i < count; ++i) {
+        Bytes data(baseLength + (i * 37) % 101);
+        for (size_t k = 0; k < data.size(); ++k) {
+            data[k] = static_cast<uint8_t>(i * 31 + k);
+        }
+        batch.plaintexts.push_back(data);
+        const std::string aad = "record-" + std::to_string(i);
+        batch.aads.emplace_back(aad.begin(), aad.end());
+    }
+    return batch;
+}
+
+// Splits a sealed batch back into per-record views, carrying the AADs
+std::vector<BatchRecord> split(const Bytes& sealed, const Batch& batch) {
+    std::vector<BatchRecord> out;
+    size_t offset = 0;
+    for (size_t i = 0; i < batch.plaintexts.size(); ++i) {
+        const size_t length = batch.plaintexts[i].size() + CryptoEngine::kBatchOverhead;
+        out.push_back({sealed.data() + offset, length, batch.aads[i].data(), batch.aads[i].size()});
+        offset += length;
+    }
+    CHECK_EQ(offset, sealed.size());
+    return out;
+}
+
+uint32_t counterOf(const uint8_t* nonce) {
+    return static_cast<uint32_t>(nonce[8]) << 24 | static_cast<uint32_t>(nonce[9]) << 16 |
+           static_cast<uint32_t>(nonce[10]) << 8 | nonce[11];
+}
+
+Bytes concatenated(const Batch& batch) {
+    Bytes out;
+    for (const Bytes& data : batch.plaintexts) {
+        out.insert(out.end(), data.begin(), data.end());
+    }
+    return out;
+}
+
+void testRoundTrip(CryptoEngine& engine) {
+    const crypto_native::SecureBytes rawKey = engine.generateKey(32);
+    KeyHandle key(rawKey);
+    const Batch batch = makeBatch(20);
+    const Bytes sealed = engine.sealBatch(key, CipherAlgorithm::AES_256_GCM, batch.records());
+    const std::vector<BatchRecord> records = split(sealed, batch);
+
+    const Bytes opened = engine.openBatch(key, CipherAlgorithm::AES_256_GCM, records);
+    CHECK(opened == concatenated(batch));
+
+    // Each record is plain AES-GCM: nonce || ciphertext || tag
+    for (size_t i = 0; i < records.size(); ++i) {
+        const uint8_t* nonce = records[i].data;
+        const uint8_t* body = nonce + NONCE;
+        const size_t length = records[i].length - CryptoEngine::kBatchOverhead;
+        const Bytes single = engine.decrypt(Bytes(body, body + length), rawKey, CipherAlgorithm::AES_256_GCM,
+                                            Bytes(nonce, nonce + NONCE), PaddingMode::NONE, batch.aads[i],
+                                            Bytes(body + length, body + length + TAG));
+        CHECK(single == batch.plaintexts[i]);
+    }
+
+    CHECK(engine.sealBatch(key, CipherAlgorithm::AES_256_GCM, {}).empty());
+
+    bool threw = false;
+    try {
+        engine.sealBatch(key, CipherAlgorithm::AES_256_CBC, batch.records());
+    } catch (const InvalidParameterException&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void testNonceUniqueness(CryptoEngine& engine) {
+    KeyHandle key(engine.generateKey(32));
+    std::set<Bytes> nonces;
+    std::set<Bytes> prefixes;
+    uint32_t expected = 0;
+    for (int call = 0; call < 10; ++call) {
+        const Batch batch = makeBatch(50);
+        const Bytes sealed = engine.sealBatch(key, CipherAlgorithm::AES_256_GCM, batch.records());
+        for (const BatchRecord& record : split(sealed, batch)) {
+            CHECK(nonces.insert(Bytes(record.data, record.data + NONCE)).second);
+            prefixes.insert(Bytes(record.data, record.data + 8));
+            // The counter continues across calls on one handle
+            CHECK_EQ(counterOf(record.data), expected++);
+        }
+    }
+    CHECK_EQ(nonces.size(), size_t(500));
+    CHECK_EQ(prefixes.size(), size_t(1));
+
+    // Every handle draws its own prefix
+    KeyHandle other(engine.generateKey(32));
+    const Batch batch = makeBatch(1);
+    const Bytes sealed = engine.sealBatch(other, CipherAlgorithm::AES_256_GCM, batch.records());
+    CHECK(prefixes.count(Bytes(sealed.data(), sealed.data() + 8)) == 0);
+}
+
+void testCounterRollover(CryptoEngine& engine) {
+    KeyHandle key(engine.generateKey(32));
+    const Batch batch = makeBatch(4);
+    Bytes sealed = engine.sealBatch(key, CipherAlgorithm::AES_256_GCM, batch.records());
+    const Bytes firstPrefix(sealed.data(), sealed.data() + 8);
+
+    // Three nonces left before the counter would wrap
+    crypto_native::KeyHandleTestPeer::setCounter(key, UINT32_MAX - 3);
+    sealed = engine.sealBatch(key, CipherAlgorithm::AES_256_GCM, batch.records());
+    const std::vector<BatchRecord> records = split(sealed, batch);
+    for (size_t i = 0; i < 3; ++i) {
+        CHECK(Bytes(records[i].data, records[i].data + 8) == firstPrefix);
+        CHECK_EQ(counterOf(records[i].data), UINT32_MAX - 3 + static_cast<uint32_t>(i));
+    }
+    // The counter value UINT32_MAX is never used: a new prefix starts at zero
+    CHECK(Bytes(records[3].data, records[3].data + 8) != firstPrefix);
+    CHECK_EQ(counterOf(records[3].data), 0u);
+
+    CHECK(engine.openBatch(key, CipherAlgorithm::AES_256_GCM, records) == concatenated(batch));
+}
+
+void testWrongAad(CryptoEngine& engine) {
+    KeyHandle key(engine.generateKey(32));
+    const Batch batch = makeBatch(5);
+    const Bytes sealed = engine.sealBatch(key, CipherAlgorithm::AES_256_GCM, batch.records());
+
+    // Swap the AADs of two records
+    std::vector<BatchRecord> records = split(sealed, batch);
+    std::swap(records[1].aad, records[2].aad);
+    std::swap(records[1].aadLength, records[2].aadLength);
+    bool threw = false;
+    try {
+        engine.openBatch(key, CipherAlgorithm::AES_256_GCM, records);
+    } catch (const AuthenticationFailedException& e) {
+        threw = std::string(e.what()).find("record 1") != std::string::npos;
+    }
+    CHECK(threw);
+
+    // Missing AAD
+    records = split(sealed, batch);
+    records[4].aad = nullptr;
+    records[4].aadLength = 0;
+    threw = false;
+    try {
+        engine.openBatch(key, CipherAlgorithm::AES_256_GCM, records);
+    } catch (const AuthenticationFailedException&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // A different key
+    KeyHandle otherKey(engine.generateKey(32));
+    threw = false;
+    try {
+        engine.openBatch(otherKey, CipherAlgorithm::AES_256_GCM, split(sealed, batch));
+    } catch (const AuthenticationFailedException&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void testWipeOnFailure(CryptoEngine& engine) {
+    KeyHandle key(engine.generateKey(32));
+    // Records large enough that the output buffer size is unambiguous
+    const Batch batch = makeBatch(4, 1000);
+    const Bytes sealed = engine.sealBatch(key, CipherAlgorithm::AES_256_GCM, batch.records());
+
+    // The last record is tampered, so the first three decrypt into the buffer first
+    Bytes tampered = sealed;
+    tampered[tampered.size() - TAG - 1] ^= 0x01;
+    const std::vector<BatchRecord> records = split(tampered, batch);
+
+    watchedSize = concatenated(batch).size();
+    watchedBlock = nullptr;
+    watchedFreed = false;
+    watchedWiped = false;
+    bool threw = false;
+    try {
+        engine.openBatch(key, CipherAlgorithm::AES_256_GCM, records);
+    } catch (const AuthenticationFailedException& e) {
+        threw = std::string(e.what()).find("record 3") != std::string::npos;
+    }
+    watchedSize = 0;
+    CHECK(threw);
+    CHECK(watchedFreed);
+    CHECK(watchedWiped);
+}
+
+} // namespace
+
+int main() {
+    CryptoEngine engine;
+    testRoundTrip(engine);
+    testNonceUniqueness(engine);
+    testCounterRollover(engine);
+    testWrongAad(engine);
+    testWipeOnFailure(engine);
+    return native_tests::finish("BatchAead");
+}
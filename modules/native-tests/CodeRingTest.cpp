@@ -0,0 +1,111 @@
+#include "OtpGenerator.h"
+#include "TestSupport.h"
+#include <string>
+#include <utility>
+
+using OtpGenerator::CodeRing;
+
+namespace {
+
+void testLookup() {
+    CodeRing ring(2);
+    CHECK_EQ(ring.capacity(), size_t(3));
+
+    std::string code = "unchanged";
+    CHECK(!ring.lookup(100, code));
+    CHECK_EQ(code, std::string("unchanged"));
+
+    ring.store(100, "123456");
+    ring.store(101, "234567");
+    CHECK(ring.lookup(100, code));
+    CHECK_EQ(code, std::string("123456"));
+    CHECK(ring.lookup(101, code));
+    CHECK_EQ(code, std::string("234567"));
+
+    // Same index, different slot: never returns a stale code
+    CHECK(!ring.lookup(103, code));
+    CHECK(!ring.lookup(97, code));
+
+    // Storing a later slot evicts the one sharing its index
+    ring.store(103, "345678");
+    CHECK(!ring.lookup(100, code));
+    CHECK(ring.lookup(103, code));
+    CHECK_EQ(code, std::string("345678"));
+
+    // Empty and oversized codes are ignored
+    ring.store(102, "");
+    CHECK(!ring.lookup(102, code));
+    ring.store(102, std::string(CodeRing::MAX_CODE_LENGTH + 1, '1'));
+    CHECK(!ring.lookup(102, code));
+    ring.store(102, std::string(CodeRing::MAX_CODE_LENGTH, '9'));
+    CHECK(ring.lookup(102, code));
+    CHECK_EQ(code.size(), CodeRing::MAX_CODE_LENGTH);
+}
+
+void testFirstMissing() {
+    CodeRing ring(3);
+    CHECK_EQ(ring.firstMissing(50), uint64_t(50));
+
+    ring.store(50, "000001");
+    ring.store(51, "000002");
+    ring.store(53, "000004");
+    CHECK_EQ(ring.firstMissing(50), uint64_t(52));
+    CHECK_EQ(ring.firstMissing(53), uint64_t(54));
+
+    ring.store(52, "000003");
+    // Window complete: one past the end
+    CHECK_EQ(ring.firstMissing(50), uint64_t(54));
+
+    // Moving on one period: slot 50's entry does not count for 54
+    CHECK_EQ(ring.firstMissing(51), uint64_t(54));
+    ring.store(54, "000005");
+    CHECK_EQ(ring.firstMissing(51), uint64_t(55));
+}
+
+void testWipe() {
+    CodeRing ring(1);
+    ring.store(0, "111111");
+    ring.store(1, "222222");
+    ring.wipe();
+
+    std::string code;
+    CHECK(!ring.lookup(0, code));
+    CHECK(!ring.lookup(1, code));
+    CHECK_EQ(ring.firstMissing(0), uint64_t(0));
+
+    // Slot 0 after a wipe: a zeroed entry must not read as a stored slot 0
+    ring.store(1, "333333");
+    CHECK(!ring.lookup(0, code));
+    CHECK_EQ(ring.firstMissing(0), uint64_t(0));
+
+    // Usable again, and moves keep the codes
+    ring.store(0, "444444");
+    CodeRing moved(std::move(ring));
+    CHECK(moved.lookup(0, code));
+    CHECK_EQ(code, std::string("444444"));
+}
+
+void testMatchesGenerator() {
+    // The ring stores what the scheduler generated, slot for slot
+    const std::string secret = "JBSWY3DPEHPK3PXP";
+    CodeRing ring(4);
+    const uint64_t now = 56000000;
+    for (uint64_t slot = now; slot < now + ring.capacity(); ++slot) {
+        ring.store(slot, OtpGenerator::generateTOTP(secret, slot, 6, "SHA1"));
+    }
+    for (uint64_t slot = now; slot < now + ring.capacity(); ++slot) {
+        std::string code;
+        CHECK(ring.lookup(slot, code));
+        CHECK_EQ(code, OtpGenerator::generateTOTP(secret, slot, 6, "SHA1"));
+    }
+}
+
+} // namespace
+
+int main() {
+    testLookup();
+    testFirstMissing();
+    testWipe();
+    testMatchesGenerator();
+    return native_tests::finish("CodeRing");
+}
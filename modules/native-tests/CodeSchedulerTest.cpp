@@ -0,0 +1,170 @@
+#include "CodeScheduler.h"
+#include "OtpGenerator.h"
+#include "TestSupport.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+// Runs the real scheduler thread against the wall clock with one- and
+// two-second periods, so a couple of boundaries pass in a few seconds.
+
+using CodeSchedule::Account;
+using CodeSchedule::CodeGroup;
+using CodeSchedule::Kind;
+using CodeSchedule::Scheduler;
+
+namespace {
+
+const char* const SECRET = "JBSWY3DPEHPK3PXP";
+
+struct Recorder {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::vector<CodeGroup>> batches;
+
+    void operator()(const std::vector<CodeGroup>& groups) {
+        std::lock_guard<std::mutex> lock(mutex);
+        batches.push_back(groups);
+        changed.notify_all();
+    }
+
+    bool waitFor(size_t count, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, timeout, [&] { return batches.size() >= count; });
+    }
+};
+
+Account totp(const std::string& id, int period) {
+    Account account;
+    account.id = id;
+    account.secret = SECRET;
+    account.period = period;
+    return account;
+}
+
+void checkGroup(const CodeGroup& group, const std::vector<Account>& accounts) {
+    const int64_t periodMs = static_cast<int64_t>(group.period) * 1000;
+    CHECK_EQ(group.validUntilMs, static_cast<int64_t>(group.timeSlot + 1) * periodMs);
+
+    size_t matched = 0;
+    for (const Account& account : accounts) {
+        if (account.period != group.period) {
+            continue;
+        }
+        for (const auto& code : group.codes) {
+            if (code.first == account.id) {
+                CHECK_EQ(code.second,
+                         OtpGenerator::generateTOTP(SECRET, group.timeSlot, account.digits, account.algorithm));
+                ++matched;
+            }
+        }
+    }
+    CHECK_EQ(matched, group.codes.size());
+}
+
+void testBoundaryBatches() {
+    std::vector<Account> accounts = {totp("a1", 1), totp("b1", 1), totp("c2", 2)};
+    accounts[1].digits = 8;
+    accounts[1].algorithm = "SHA256";
+
+    Recorder recorder;
+    Scheduler scheduler([&](const std::vector<CodeGroup>& groups) { recorder(groups); });
+    CHECK_EQ(scheduler.setAccounts(accounts), size_t(3));
+    CHECK_EQ(scheduler.groupCount(), size_t(2));
+
+    // First pass reports every group at once, then one batch per boundary
+    CHECK(recorder.waitFor(4, std::chrono::seconds(6)));
+
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    CHECK_EQ(recorder.batches[0].size(), size_t(2));
+    bool sawSharedBoundary = false;
+    for (size_t i = 0; i < recorder.batches.size(); ++i) {
+        const auto& batch = recorder.batches[i];
+        std::set<int> periods;
+        uint64_t fastSlot = 0;
+        for (const CodeGroup& group : batch) {
+            CHECK(periods.insert(group.period).second);
+            checkGroup(group, accounts);
+            if (group.period == 1) {
+                fastSlot = group.timeSlot;
+            }
+        }
+        if (i == 0) {
+            continue;
+        }
+        // The one-second group rolls at every boundary; the two-second group
+        // only on even seconds, and then in the same batch
+        CHECK(periods.count(1) == 1);
+        CHECK_EQ(periods.count(2) == 1, fastSlot % 2 == 0);
+        sawSharedBoundary = sawSharedBoundary || periods.size() == 2;
+    }
+    CHECK(sawSharedBoundary);
+
+    // Consecutive batches of the fast group cover consecutive slots
+    uint64_t previous = 0;
+    for (size_t i = 0; i < recorder.batches.size(); ++i) {
+        for (const CodeGroup& group : recorder.batches[i]) {
+            if (group.period == 1) {
+                if (i > 0) {
+                    CHECK_EQ(group.timeSlot, previous + 1);
+                }
+                previous = group.timeSlot;
+            }
+        }
+    }
+}
+
+void testAccountFiltering() {
+    Recorder recorder;
+    Scheduler scheduler([&](const std::vector<CodeGroup>& groups) { recorder(groups); });
+
+    Account steam = totp("steam", 7);
+    steam.kind = Kind::STEAM;
+    Account noSecret = totp("empty", 30);
+    noSecret.secret.clear();
+    std::vector<Account> accounts = {totp("zero", 0), noSecret, steam, totp("t30", 30)};
+    CHECK_EQ(scheduler.setAccounts(accounts), size_t(2));
+    // Steam always runs on 30 s, so it shares the 30 s group
+    CHECK_EQ(scheduler.groupCount(), size_t(1));
+
+    CHECK(recorder.waitFor(1, std::chrono::seconds(2)));
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    const CodeGroup& group = recorder.batches[0][0];
+    CHECK_EQ(group.period, 30);
+    CHECK_EQ(group.codes.size(), size_t(2));
+    for (const auto& code : group.codes) {
+        if (code.first == "steam") {
+            CHECK_EQ(code.second, OtpGenerator::generateSteamGuard(SECRET, group.timeSlot));
+        }
+    }
+}
+
+void testReplaceAccounts() {
+    Recorder recorder;
+    Scheduler scheduler([&](const std::vector<CodeGroup>& groups) { recorder(groups); });
+    scheduler.setAccounts({totp("old", 30)});
+    CHECK(recorder.waitFor(1, std::chrono::seconds(2)));
+
+    // Replacing the set regenerates immediately rather than at the boundary
+    scheduler.setAccounts({totp("new", 60)});
+    CHECK(recorder.waitFor(2, std::chrono::seconds(2)));
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    CHECK_EQ(recorder.batches[1].size(), size_t(1));
+    CHECK_EQ(recorder.batches[1][0].period, 60);
+    CHECK_EQ(recorder.batches[1][0].codes[0].first, std::string("new"));
+
+    CHECK_EQ(scheduler.setAccounts({}), size_t(0));
+    CHECK_EQ(scheduler.groupCount(), size_t(0));
+}
+
+} // namespace
+
+int main() {
+    testAccountFiltering();
+    testReplaceAccounts();
+    testBoundaryBatches();
+    return native_tests::finish("CodeScheduler");
+}
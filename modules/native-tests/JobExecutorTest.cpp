@@ -0,0 +1,258 @@
+#include "JobExecutor.h"
+#include "TestSupport.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Every background worker is parked on a gate job, so anything submitted
+// after that stays queued until the test opens the gate (or the executor
+// cancels it).
+
+using crypto_native::CryptoOperationException;
+using crypto_native::JobContext;
+using crypto_native::JobExecutor;
+using crypto_native::JobPriority;
+using crypto_native::JobResult;
+using crypto_native::JobStatus;
+
+namespace {
+
+constexpr auto TIMEOUT = std::chrono::seconds(5);
+
+struct Gate {
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t arrived = 0;
+    bool open = false;
+
+    // Blocks until the gate opens or the job is cancelled
+    JobExecutor::Job job() {
+        return [this](const JobContext& context, JobResult&) {
+            std::unique_lock<std::mutex> lock(mutex);
+            ++arrived;
+            changed.notify_all();
+            while (!open && !context.token().isCancelled()) {
+                changed.wait_for(lock, std::chrono::milliseconds(5));
+            }
+            lock.unlock();
+            context.token().throwIfCancelled();
+        };
+    }
+
+    bool waitArrived(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, TIMEOUT, [&] { return arrived >= count; });
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex);
+        open = true;
+        changed.notify_all();
+    }
+};
+
+struct Recorder {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<uint64_t> order;
+    std::map<uint64_t, JobStatus> statuses;
+    std::map<uint64_t, int> reports;
+
+    JobExecutor::CompletionHandler handler() {
+        return [this](uint64_t id, JobStatus status, const JobResult&, const std::string&) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(id);
+            statuses[id] = status;
+            ++reports[id];
+            changed.notify_all();
+        };
+    }
+
+    bool waitFor(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, TIMEOUT, [&] { return order.size() >= count; });
+    }
+
+    bool waitForJob(uint64_t id) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, TIMEOUT, [&] { return statuses.count(id) > 0; });
+    }
+
+    JobStatus status(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return statuses.at(id);
+    }
+};
+
+// Parks every background worker; returns how many that took
+size_t park(JobExecutor& executor, Gate& gate) {
+    const size_t background = executor.workerCount() - 1;
+    for (size_t i = 0; i < background; ++i) {
+        executor.submit(JobPriority::BACKGROUND, gate.job());
+    }
+    CHECK(gate.waitArrived(background));
+    return background;
+}
+
+void testCancelQueued() {
+    Recorder recorder;
+    Gate gate;
+    JobExecutor executor(recorder.handler());
+    const size_t parked = park(executor, gate);
+
+    std::atomic<bool> ran{false};
+    const uint64_t id = executor.submit(JobPriority::BACKGROUND,
+                                        [&](const JobContext&, JobResult&) { ran = true; });
+    CHECK(executor.cancel(id));
+    gate.release();
+
+    CHECK(recorder.waitFor(parked + 1));
+    CHECK(!ran);
+    CHECK(recorder.status(id) == JobStatus::CANCELLED);
+    // Finished jobs can no longer be cancelled
+    CHECK(!executor.cancel(id));
+    CHECK(!executor.cancel(999999));
+}
+
+void testInteractiveNotStarved() {
+    Recorder recorder;
+    Gate gate;
+    JobExecutor executor(recorder.handler());
+    const size_t parked = park(executor, gate);
+
+    std::vector<uint64_t> queued;
+    for (int i = 0; i < 50; ++i) {
+        queued.push_back(executor.submit(JobPriority::BACKGROUND, [](const JobContext&, JobResult&) {}));
+    }
+    const uint64_t interactive = executor.submit(JobPriority::INTERACTIVE, [](const JobContext&, JobResult&) {});
+
+    // Runs on the interactive worker while every background job is stuck
+    CHECK(recorder.waitForJob(interactive));
+    CHECK(recorder.status(interactive) == JobStatus::COMPLETED);
+    {
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        CHECK_EQ(recorder.order.size(), size_t(1));
+    }
+
+    gate.release();
+    CHECK(recorder.waitFor(parked + queued.size() + 1));
+    for (uint64_t id : queued) {
+        CHECK(recorder.status(id) == JobStatus::COMPLETED);
+    }
+}
+
+void testQueueLimit() {
+    Recorder recorder;
+    Gate gate;
+    JobExecutor executor(recorder.handler());
+    const size_t parked = park(executor, gate);
+
+    // Running jobs count against the limit as well as queued ones
+    for (size_t i = parked; i < JobExecutor::kMaxPending; ++i) {
+        executor.submit(JobPriority::BACKGROUND, [](const JobContext&, JobResult&) {});
+    }
+    for (JobPriority priority : {JobPriority::BACKGROUND, JobPriority::INTERACTIVE}) {
+        bool threw = false;
+        try {
+            executor.submit(priority, [](const JobContext&, JobResult&) {});
+        } catch (const CryptoOperationException&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    gate.release();
+    CHECK(recorder.waitFor(JobExecutor::kMaxPending));
+    const uint64_t after = executor.submit(JobPriority::BACKGROUND, [](const JobContext&, JobResult&) {});
+    CHECK(recorder.waitForJob(after));
+    CHECK(recorder.status(after) == JobStatus::COMPLETED);
+}
+
+void testDestructorDrains() {
+    Recorder recorder;
+    Gate gate;
+    std::vector<uint64_t> submitted;
+    std::atomic<int> ran{0};
+    {
+        JobExecutor executor(recorder.handler());
+        const size_t parked = park(executor, gate);
+        for (size_t i = 0; i < parked; ++i) {
+            submitted.push_back(i + 1);
+        }
+        for (int i = 0; i < 40; ++i) {
+            submitted.push_back(executor.submit(JobPriority::BACKGROUND,
+                                                [&](const JobContext&, JobResult&) { ++ran; }));
+        }
+        const uint64_t done = executor.submit(JobPriority::INTERACTIVE, [](const JobContext&, JobResult&) {});
+        CHECK(recorder.waitForJob(done));
+        submitted.push_back(done);
+        // Leaves with the gate closed: parked jobs see their tokens cancelled
+    }
+
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    CHECK_EQ(ran.load(), 0);
+    CHECK_EQ(recorder.order.size(), submitted.size());
+    for (uint64_t id : submitted) {
+        CHECK_EQ(recorder.reports[id], 1);
+        CHECK(recorder.statuses[id] == (id == submitted.back() ? JobStatus::COMPLETED : JobStatus::CANCELLED));
+    }
+}
+
+void testFailureAndProgress() {
+    Recorder recorder;
+    const JobExecutor::CompletionHandler record = recorder.handler();
+    std::mutex mutex;
+    std::vector<double> fractions;
+    std::string failure;
+    size_t failedBytes = 0;
+    // Handlers run on worker threads, so they only record; checks stay here
+    JobExecutor executor(
+        [&](uint64_t id, JobStatus status, const JobResult& result, const std::string& error) {
+            if (status == JobStatus::FAILED) {
+                std::lock_guard<std::mutex> lock(mutex);
+                failure = error;
+                failedBytes = result.bytes.size();
+            }
+            record(id, status, result, error);
+        },
+        [&](uint64_t, double fraction) {
+            std::lock_guard<std::mutex> lock(mutex);
+            fractions.push_back(fraction);
+        });
+
+    const uint64_t progress = executor.submit(JobPriority::BACKGROUND, [](const JobContext& context, JobResult&) {
+        // Reported far more often than whole percents change
+        for (uint64_t i = 0; i <= 1000; ++i) {
+            context.reportProgress(i, 1000);
+        }
+    });
+    const uint64_t failing = executor.submit(JobPriority::INTERACTIVE, [](const JobContext&, JobResult& result) {
+        result.bytes.emplace_back("partial", std::vector<uint8_t>(16, 0x5A));
+        throw CryptoOperationException("boom");
+    });
+    CHECK(recorder.waitForJob(progress));
+    CHECK(recorder.waitForJob(failing));
+    CHECK(recorder.status(failing) == JobStatus::FAILED);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(failure.find("boom") != std::string::npos);
+    // A failed job's partial results are wiped, not delivered
+    CHECK_EQ(failedBytes, size_t(0));
+    CHECK_EQ(fractions.size(), size_t(101));
+    CHECK_EQ(fractions.back(), 1.0);
+}
+
+} // namespace
+
+int main() {
+    testCancelQueued();
+    testInteractiveNotStarved();
+    testQueueLimit();
+    testDestructorDrains();
+    testFailureAndProgress();
+    return native_tests::finish("JobExecutor");
+}
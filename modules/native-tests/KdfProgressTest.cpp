@@ -0,0 +1,119 @@
+#include "CryptoNativeC.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+// Progress reporting and cancellation inside key derivation, and what the
+// periodic check costs compared with a derivation that has no hooks.
+
+namespace {
+
+const uint8_t SALT[] = {'s', 'a', 'l', 't'};
+
+struct Progress {
+    std::vector<uint64_t> done;
+    uint64_t total = 0;
+    uint64_t cancelAt = 0;  // 0 = never
+};
+
+int record(uint64_t done, uint64_t total, void* context) {
+    auto* progress = static_cast<Progress*>(context);
+    progress->done.push_back(done);
+    progress->total = total;
+    return progress->cancelAt != 0 && done >= progress->cancelAt;
+}
+
+int ignore(uint64_t, uint64_t, void*) {
+    return 0;
+}
+
+int derive(uint32_t iterations, uint8_t* out, crypto_progress_fn callback, void* context) {
+    return crypto_derive_key_progress(CRYPTO_KDF_PBKDF2, "password", 8, SALT, sizeof(SALT), iterations, 0, 1,
+                                      out, 32, callback, context);
+}
+
+void testReporting() {
+    // Same key with and without hooks; progress is monotonic and ends at total
+    const uint32_t iterations = 20000;
+    uint8_t plain[32];
+    uint8_t reported[32];
+    CHECK_EQ(crypto_derive_key(CRYPTO_KDF_PBKDF2, "password", 8, SALT, sizeof(SALT), iterations, 0, 1, plain, 32),
+             32);
+    Progress progress;
+    CHECK_EQ(derive(iterations, reported, record, &progress), 32);
+    CHECK(std::memcmp(plain, reported, sizeof(plain)) == 0);
+
+    CHECK(!progress.done.empty());
+    CHECK(std::is_sorted(progress.done.begin(), progress.done.end()));
+    CHECK_EQ(progress.total, static_cast<uint64_t>(iterations));
+    CHECK_EQ(progress.done.back(), static_cast<uint64_t>(iterations));
+}
+
+void testCancellation() {
+    // Cancelled at the first report: CRYPTO_ERR_CANCELLED, output untouched
+    uint8_t out[32];
+    std::memset(out, 0xA5, sizeof(out));
+    Progress progress;
+    progress.cancelAt = 1;
+    CHECK_EQ(derive(1000000, out, record, &progress), CRYPTO_ERR_CANCELLED);
+    CHECK_EQ(progress.done.size(), 1u);
+    bool untouched = true;
+    for (uint8_t byte : out) {
+        untouched = untouched && byte == 0xA5;
+    }
+    CHECK(untouched);
+}
+
+// Thread CPU time, so preemption on a busy host does not count
+double cpuMilliseconds() {
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) * 1e3 + static_cast<double>(now.tv_nsec) / 1e6;
+}
+
+double millisecondsFor(uint32_t iterations, crypto_progress_fn callback) {
+    uint8_t out[32];
+    const double start = cpuMilliseconds();
+    derive(iterations, out, callback, nullptr);
+    return cpuMilliseconds() - start;
+}
+
+void measureOverhead() {
+    // The callback plus cancellation poll every kKdfCheckInterval rounds,
+    // against the same loop with no hooks. Runs alternate and the median of
+    // the paired ratios is reported, which holds steady on a noisy host
+    // where any single run can be off by several percent.
+    const uint32_t iterations = 40000;
+    const int pairs = 41;
+    std::vector<double> ratios;
+    double bare = 0;
+    millisecondsFor(iterations, nullptr);
+    for (int pair = 0; pair < pairs; ++pair) {
+        const bool hookedFirst = pair % 2 != 0;
+        const double first = millisecondsFor(iterations, hookedFirst ? ignore : nullptr);
+        const double second = millisecondsFor(iterations, hookedFirst ? nullptr : ignore);
+        const double plain = hookedFirst ? second : first;
+        const double hooked = hookedFirst ? first : second;
+        ratios.push_back(hooked / plain);
+        bare += plain;
+    }
+    std::nth_element(ratios.begin(), ratios.begin() + pairs / 2, ratios.end());
+    const double overhead = (ratios[pairs / 2] - 1.0) * 100.0;
+    std::printf("PBKDF2-SHA256 %u rounds: %.2f ms, progress hooks %+.2f%% (median of %d pairs)\n", iterations,
+                bare / pairs, overhead, pairs);
+
+    // Only a gross regression fails the run; the printed figure is the
+    // measurement
+    CHECK(overhead < 3.0);
+}
+
+} // anonymous namespace
+
+int main() {
+    testReporting();
+    testCancellation();
+    measureOverhead();
+    return native_tests::finish("KdfProgress");
+}
@@ -0,0 +1,105 @@
+#include "MailExtractor.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+using MailExtract::MessageFindings;
+
+namespace {
+
+bool has(const std::vector<std::string>& values, const std::string& value) {
+    return std::find(values.begin(), values.end(), value) != values.end();
+}
+
+std::map<std::string, MessageFindings> scan(const std::string& path, MailExtract::ScanStats& stats) {
+    std::map<std::string, MessageFindings> found;
+    stats = MailExtract::scanMailbox(path, [&](MessageFindings&& findings) {
+        std::string id = findings.messageId;
+        found.emplace(std::move(id), std::move(findings));
+        return true;
+    });
+    return found;
+}
+
+void testMbox(const std::string& fixtures) {
+    MailExtract::ScanStats stats;
+    auto found = scan(fixtures + "/inbox.mbox", stats);
+    CHECK(stats.opened);
+    CHECK_EQ(stats.messages, 4u);
+    CHECK_EQ(stats.matched, 3u);
+    CHECK_EQ(found.size(), 3u);
+
+    // Plain text, with order numbers and years that must not count as codes
+    const MessageFindings& plain = found["<plain@fixture>"];
+    CHECK_EQ(plain.codes.size(), 1u);
+    CHECK(has(plain.codes, "482913"));
+    CHECK_EQ(plain.from, std::string("GitHub <noreply@github.com>"));
+
+    // Base64 HTML with an encoded subject, an entity in the link and a stray
+    // '<' before the code
+    const MessageFindings& html = found["<html-base64@fixture>"];
+    CHECK_EQ(html.subject, std::string("Best\xc3\xa4tigen Sie Ihr Konto"));
+    CHECK(has(html.activationUrls, "https://example.com/account/confirm?token=abc&u=1"));
+    CHECK(has(html.codes, "552211"));
+
+    // multipart/alternative: quoted-printable URI across a soft line break,
+    // and a secret key in a base64 HTML part
+    const MessageFindings& multipart = found["<multipart@fixture>"];
+    CHECK(has(multipart.setupUris, "otpauth://totp/Acme:alice%40acme.com?secret=JBSWY3DPEHPK3PXP&issuer=Acme"));
+    CHECK(has(multipart.secrets, "GEZDGNBVGY3TQOJQGEZDGNBVGY3TQOJQ"));
+
+    CHECK(found.find("<noise@fixture>") == found.end());
+}
+
+void testMaildir(const std::string& fixtures) {
+    MailExtract::ScanStats stats;
+    auto found = scan(fixtures + "/maildir", stats);
+    CHECK(stats.opened);
+    CHECK_EQ(stats.messages, 2u);
+    CHECK_EQ(stats.matched, 2u);
+
+    // Latin-1 quoted-printable body
+    const MessageFindings& qp = found["<maildir-qp@fixture>"];
+    CHECK_EQ(qp.codes.size(), 1u);
+    CHECK(has(qp.codes, "908172"));
+
+    // Nested multipart; both alternatives carry the same link
+    const MessageFindings& nested = found["<maildir-multipart@fixture>"];
+    CHECK_EQ(nested.activationUrls.size(), 1u);
+    CHECK(has(nested.activationUrls, "https://example.com/activate?id=42"));
+}
+
+void testUnterminatedTag() {
+    const char message[] =
+        "From: a@example.com\r\n"
+        "Message-ID: <inline@fixture>\r\n"
+        "Content-Type: text/html\r\n"
+        "\r\n"
+        "<p>Sign-in attempt</p> Your verification code is 661020 <b\r\n";
+    MessageFindings findings;
+    CHECK(MailExtract::extractMessage(message, std::strlen(message), findings));
+    CHECK(has(findings.codes, "661020"));
+
+    const char truncated[] =
+        "From: a@example.com\r\n"
+        "Content-Type: text/html\r\n"
+        "\r\n"
+        "<div>Codes are valid for <5 minutes. One-time code: 135790\r\n";
+    MessageFindings late;
+    CHECK(MailExtract::extractMessage(truncated, std::strlen(truncated), late));
+    CHECK(has(late.codes, "135790"));
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <fixtures/mail>\n", argv[0]);
+        return 2;
+    }
+    testMbox(argv[1]);
+    testMaildir(argv[1]);
+    testUnterminatedTag();
+    return native_tests::finish("MailExtractor");
+}
@@ -0,0 +1,230 @@
+#include "MergeEngine.h"
+#include "TestSupport.h"
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using crypto_native::ConflictKind;
+using crypto_native::InvalidParameterException;
+using crypto_native::MergeEngine;
+using crypto_native::MergeResult;
+
+namespace {
+
+using Records = std::vector<std::pair<std::string, std::string>>;
+
+std::vector<uint8_t> stream(const Records& records) {
+    std::vector<uint8_t> out;
+    for (const auto& record : records) {
+        MergeEngine::appendRecord(out, record.first, reinterpret_cast<const uint8_t*>(record.second.data()),
+                                  record.second.size());
+    }
+    return out;
+}
+
+Records records(const std::vector<uint8_t>& stream) {
+    Records out;
+    size_t offset = 0;
+    while (offset < stream.size()) {
+        uint16_t idLength;
+        uint32_t dataLength;
+        std::memcpy(&idLength, stream.data() + offset, sizeof(idLength));
+        std::memcpy(&dataLength, stream.data() + offset + sizeof(idLength), sizeof(dataLength));
+        const char* id = reinterpret_cast<const char*>(stream.data() + offset + 6);
+        out.emplace_back(std::string(id, idLength), std::string(id + idLength, dataLength));
+        offset += 6 + idLength + dataLength;
+    }
+    return out;
+}
+
+MergeResult merge(const Records& base, const Records& local, const Records& remote) {
+    const MergeResult result = MergeEngine::merge(stream(base), stream(local), stream(remote));
+    CHECK_EQ(size_t(result.mergedCount), records(result.merged).size());
+    return result;
+}
+
+std::string value(const MergeResult& result, const std::string& id) {
+    for (const auto& record : records(result.merged)) {
+        if (record.first == id) {
+            return record.second;
+        }
+    }
+    return "<absent>";
+}
+
+void checkConflict(const MergeResult& result, const std::string& id, ConflictKind kind) {
+    CHECK_EQ(result.conflicts.size(), size_t(1));
+    if (!result.conflicts.empty()) {
+        CHECK_EQ(result.conflicts[0].id, id);
+        CHECK(result.conflicts[0].kind == kind);
+    }
+}
+
+const Records BASE = {{"a", "alpha"}, {"b", "beta"}, {"c", "gamma"}};
+
+void testOneSidedEdits() {
+    MergeResult result = merge(BASE, BASE, BASE);
+    CHECK(records(result.merged) == BASE);
+    CHECK(result.conflicts.empty());
+
+    // Local-only edit
+    result = merge(BASE, {{"a", "alpha"}, {"b", "beta local"}, {"c", "gamma"}}, BASE);
+    CHECK_EQ(value(result, "b"), std::string("beta local"));
+    CHECK(result.conflicts.empty());
+
+    // Remote-only edit
+    result = merge(BASE, BASE, {{"a", "alpha"}, {"b", "beta"}, {"c", "gamma remote"}});
+    CHECK_EQ(value(result, "c"), std::string("gamma remote"));
+    CHECK(result.conflicts.empty());
+
+    // Different records edited on each side merge cleanly
+    result = merge(BASE, {{"a", "alpha local"}, {"b", "beta"}, {"c", "gamma"}},
+                   {{"a", "alpha"}, {"b", "beta"}, {"c", "gamma remote"}});
+    CHECK_EQ(value(result, "a"), std::string("alpha local"));
+    CHECK_EQ(value(result, "c"), std::string("gamma remote"));
+    CHECK(result.conflicts.empty());
+
+    // One-sided deletes
+    result = merge(BASE, {{"a", "alpha"}, {"c", "gamma"}}, BASE);
+    CHECK_EQ(value(result, "b"), std::string("<absent>"));
+    CHECK(result.conflicts.empty());
+    result = merge(BASE, BASE, {{"b", "beta"}, {"c", "gamma"}});
+    CHECK_EQ(value(result, "a"), std::string("<absent>"));
+    CHECK_EQ(result.mergedCount, 2u);
+}
+
+void testBothEdited() {
+    // The same edit on both sides is no conflict
+    MergeResult result = merge(BASE, {{"a", "same"}, {"b", "beta"}, {"c", "gamma"}},
+                               {{"a", "same"}, {"b", "beta"}, {"c", "gamma"}});
+    CHECK_EQ(value(result, "a"), std::string("same"));
+    CHECK(result.conflicts.empty());
+
+    // Different edits: local kept, conflict reported
+    result = merge(BASE, {{"a", "alpha"}, {"b", "beta local"}, {"c", "gamma"}},
+                   {{"a", "alpha"}, {"b", "beta remote"}, {"c", "gamma"}});
+    CHECK_EQ(value(result, "b"), std::string("beta local"));
+    checkConflict(result, "b", ConflictKind::BOTH_MODIFIED);
+
+    // Added on both sides without a base
+    result = merge(BASE, {{"a", "alpha"}, {"b", "beta"}, {"c", "gamma"}, {"d", "delta local"}},
+                   {{"a", "alpha"}, {"b", "beta"}, {"c", "gamma"}, {"d", "delta remote"}});
+    CHECK_EQ(value(result, "d"), std::string("delta local"));
+    checkConflict(result, "d", ConflictKind::BOTH_ADDED);
+
+    result = merge(BASE, {{"a", "alpha"}, {"d", "delta"}}, {{"a", "alpha"}, {"d", "delta"}});
+    CHECK(result.conflicts.empty());
+    CHECK_EQ(result.mergedCount, 2u);
+}
+
+void testDeleteVersusEdit() {
+    // Deleted locally, edited remotely: the edit survives
+    MergeResult result = merge(BASE, {{"a", "alpha"}, {"c", "gamma"}},
+                               {{"a", "alpha"}, {"b", "beta remote"}, {"c", "gamma"}});
+    CHECK_EQ(value(result, "b"), std::string("beta remote"));
+    checkConflict(result, "b", ConflictKind::DELETED_LOCALLY);
+
+    // Deleted remotely, edited locally
+    result = merge(BASE, {{"a", "alpha"}, {"b", "beta local"}, {"c", "gamma"}}, {{"a", "alpha"}, {"c", "gamma"}});
+    CHECK_EQ(value(result, "b"), std::string("beta local"));
+    checkConflict(result, "b", ConflictKind::DELETED_REMOTELY);
+
+    // Deleted on both sides
+    result = merge(BASE, {{"a", "alpha"}, {"c", "gamma"}}, {{"c", "gamma"}});
+    CHECK(records(result.merged) == Records({{"c", "gamma"}}));
+    CHECK(result.conflicts.empty());
+}
+
+void testOrder() {
+    // Local order first, then records only the remote has
+    const MergeResult result = merge(BASE, {{"c", "gamma"}, {"x", "local new"}, {"a", "alpha"}, {"b", "beta"}},
+                                     {{"r2", "remote 2"}, {"a", "alpha"}, {"b", "beta"}, {"c", "gamma"}, {"r1", "remote 1"}});
+    std::string ids;
+    for (const auto& record : records(result.merged)) {
+        ids += record.first + " ";
+    }
+    CHECK_EQ(ids, std::string("c x a b r2 r1 "));
+}
+
+void testMalformedInput() {
+    bool threw = false;
+    try {
+        merge({}, {{"a", "1"}, {"a", "2"}}, {});
+    } catch (const InvalidParameterException&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    std::vector<uint8_t> truncated = stream({{"a", "alpha"}});
+    truncated.pop_back();
+    threw = false;
+    try {
+        MergeEngine::merge({}, truncated, {});
+    } catch (const InvalidParameterException&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+// Randomized edits checked against the rules applied with a std::map
+void testAgainstReference() {
+    std::mt19937 random(99);
+    std::uniform_int_distribution<int> action(0, 9);
+    Records base, local, remote;
+    std::map<std::string, std::string> expected;
+    size_t expectedConflicts = 0;
+
+    for (int i = 0; i < 5000; ++i) {
+        const std::string id = "account_" + std::to_string(i);
+        const std::string original = "payload " + std::to_string(i);
+        base.emplace_back(id, original);
+
+        const int l = action(random);  // 0: delete, 1: edit, else keep
+        const int r = action(random);
+        const std::string localValue = l == 1 ? original + " local" : original;
+        const std::string remoteValue = r == 1 ? original + " remote" : original;
+        if (l != 0) local.emplace_back(id, localValue);
+        if (r != 0) remote.emplace_back(id, remoteValue);
+
+        if (l == 0 && r == 0) {
+            continue;
+        }
+        if (l == 0) {
+            if (r == 1) {
+                expected[id] = remoteValue;
+                ++expectedConflicts;
+            }
+        } else if (r == 0) {
+            if (l == 1) {
+                expected[id] = localValue;
+                ++expectedConflicts;
+            }
+        } else {
+            expected[id] = l == 1 ? localValue : remoteValue;
+            expectedConflicts += l == 1 && r == 1;
+        }
+    }
+
+    const MergeResult result = merge(base, local, remote);
+    CHECK_EQ(result.conflicts.size(), expectedConflicts);
+    const Records merged = records(result.merged);
+    CHECK_EQ(merged.size(), expected.size());
+    for (const auto& record : merged) {
+        CHECK_EQ(record.second, expected[record.first]);
+    }
+}
+
+} // namespace
+
+int main() {
+    testOneSidedEdits();
+    testBothEdited();
+    testDeleteVersusEdit();
+    testOrder();
+    testMalformedInput();
+    testAgainstReference();
+    return native_tests::finish("MergeEngine");
+}
@@ -0,0 +1,173 @@
+#include "AccountJournal.h"
+#include "CryptoNativeC.h"
+#include "MergeEngine.h"
+#include "OtpNativeC.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Throughput of the hot paths through the same C ABI the platform bridges
+// use, plus startup recovery of the account journal, which has no C entry
+// point. Numbers are for comparing builds on one machine, not across them.
+
+namespace {
+
+const char* const SECRET = "GEZDGNBVGY3TQOJQGEZDGNBVGY3TQOJQ";
+
+// Repeats `body` for at least 200 ms and returns the mean time per call
+template <typename Body>
+double measure(Body body) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    uint64_t calls = 0;
+    Clock::duration elapsed{};
+    do {
+        for (int i = 0; i < 16; ++i) {
+            body(calls++);
+        }
+        elapsed = Clock::now() - start;
+    } while (elapsed < std::chrono::milliseconds(200));
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(calls);
+}
+
+void report(const char* name, double nanoseconds, const char* unit = "call") {
+    if (nanoseconds >= 1e6) {
+        std::printf("%-34s %10.2f ms/%s\n", name, nanoseconds / 1e6, unit);
+    } else if (nanoseconds >= 1e3) {
+        std::printf("%-34s %10.2f us/%s\n", name, nanoseconds / 1e3, unit);
+    } else {
+        std::printf("%-34s %10.1f ns/%s\n", name, nanoseconds, unit);
+    }
+}
+
+// Opens a journal over a folded snapshot of `accounts` accounts with
+// `pending` renames and reorders still to replay, as after a crash
+void benchmarkRecovery(size_t accounts, size_t pending) {
+    using crypto_native::AccountJournal;
+    using crypto_native::AccountState;
+
+    char pattern[] = "/tmp/journalbenchXXXXXX";
+    const std::string directory = mkdtemp(pattern);
+    crypto_native::CryptoEngine engine;
+    const crypto_native::SecureBytes key = engine.generateKey(32);
+    {
+        AccountJournal journal(engine, key);
+        journal.open(directory);
+        AccountState state;
+        state.payload.assign(160, 0x42);
+        for (size_t i = 0; i < accounts; ++i) {
+            state.name = "Account " + std::to_string(i);
+            state.order = static_cast<int32_t>(i);
+            journal.put("account_" + std::to_string(i), state);
+        }
+        journal.compact();
+        for (size_t i = 0; i < pending; ++i) {
+            const std::string id = "account_" + std::to_string(i % accounts);
+            if (i % 2 == 0) {
+                journal.rename(id, "Renamed " + std::to_string(i));
+            } else {
+                journal.reorder({{id, static_cast<int32_t>(accounts + i)}});
+            }
+        }
+    }
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "journal recovery (%zu + %zu)", accounts, pending);
+    report(name, measure([&](uint64_t) {
+        AccountJournal journal(engine, key);
+        journal.open(directory);
+    }), "open");
+
+    std::remove((directory + "/accounts.journal").c_str());
+    std::remove((directory + "/accounts.vault").c_str());
+    rmdir(directory.c_str());
+}
+
+// Three-way merge of `accounts` records with 1% edited on each side
+void benchmarkMerge(size_t accounts) {
+    using crypto_native::MergeEngine;
+
+    std::vector<uint8_t> base, local, remote;
+    std::vector<uint8_t> payload(160, 0x42);
+    for (size_t i = 0; i < accounts; ++i) {
+        const std::string id = "account_" + std::to_string(i);
+        payload[0] = static_cast<uint8_t>(i);
+        MergeEngine::appendRecord(base, id, payload.data(), payload.size());
+        payload[1] = i % 100 == 0 ? 1 : 0;
+        MergeEngine::appendRecord(local, id, payload.data(), payload.size());
+        payload[1] = i % 100 == 50 ? 2 : 0;
+        MergeEngine::appendRecord(remote, id, payload.data(), payload.size());
+        payload[1] = 0;
+    }
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "merge (%zu accounts)", accounts);
+    report(name, measure([&](uint64_t) {
+        MergeEngine::merge(base, local, remote);
+    }));
+}
+
+} // anonymous namespace
+
+int main() {
+    char code[OTP_CODE_CAPACITY];
+
+    report("otp_generate_hotp", measure([&](uint64_t i) {
+        otp_generate_hotp(SECRET, i, 6, "SHA1", code, sizeof(code));
+    }));
+    report("otp_generate_totp (8 digits)", measure([&](uint64_t i) {
+        otp_generate_totp(SECRET, i, 8, "SHA1", code, sizeof(code));
+    }));
+    report("otp_generate_steam", measure([&](uint64_t i) {
+        otp_generate_steam(SECRET, i, code, sizeof(code));
+    }));
+    report("otp_generate_motp", measure([&](uint64_t i) {
+        otp_generate_motp("e3152afee62599c8", "1234", i * 10, 10, code, sizeof(code));
+    }));
+
+    // A vault's worth of accounts refreshed in one call
+    const size_t accounts = 256;
+    std::vector<const char*> secrets(accounts, SECRET);
+    std::vector<uint8_t> encodings(accounts, OTP_ENCODING_DECIMAL);
+    std::vector<uint64_t> counters(accounts);
+    std::vector<int> digits(accounts, 6);
+    std::vector<char> codes(accounts * OTP_CODE_CAPACITY);
+    const double batch = measure([&](uint64_t i) {
+        for (size_t k = 0; k < accounts; ++k) {
+            counters[k] = i + k;
+        }
+        otp_generate_batch(secrets.data(), encodings.data(), counters.data(), digits.data(), accounts,
+                           codes.data());
+    });
+    report("otp_generate_batch (256 accounts)", batch);
+    report("  per account", batch / accounts, "code");
+
+    const char* miss[] = {"000000", "000001"};
+    report("otp_resync_hotp (1000 counters)", measure([&](uint64_t) {
+        otp_resync_hotp(SECRET, 0, miss, 2, 1000, 6, "SHA1");
+    }));
+
+    uint8_t key[32];
+    report("PBKDF2-SHA256 (100k iterations)", measure([&](uint64_t) {
+        crypto_derive_key(CRYPTO_KDF_PBKDF2, "password", 8, reinterpret_cast<const uint8_t*>("salt"), 4, 100000,
+                          0, 1, key, sizeof(key));
+    }));
+
+    // AES-256-GCM over 1 MiB, reported per MiB
+    std::vector<uint8_t> plain(1 << 20, 0x5A);
+    std::vector<uint8_t> sealed(plain.size());
+    uint8_t iv[12] = {};
+    uint8_t tag[CRYPTO_TAG_SIZE];
+    report("AES-256-GCM seal", measure([&](uint64_t) {
+        crypto_encrypt(CRYPTO_CIPHER_AES_256_GCM, CRYPTO_PADDING_NONE, key, sizeof(key), iv, sizeof(iv), nullptr,
+                       0, plain.data(), plain.size(), sealed.data(), sealed.size(), tag);
+    }), "MiB");
+
+    benchmarkMerge(10000);
+    benchmarkRecovery(1000, 0);
+    benchmarkRecovery(1000, 1000);
+    return 0;
+}
@@ -0,0 +1,239 @@
+#include "CryptoEngine.h"
+#include "CryptoNativeC.h"
+#include "OtpNativeC.h"
+#include "TestSupport.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Published vectors run through the C ABI the platform bridges call, so a
+// regression in the shared core shows up here before it reaches a device.
+
+namespace {
+
+// "12345678901234567890", the RFC 4226 / RFC 6238 SHA1 seed
+const char* const RFC_SECRET = "GEZDGNBVGY3TQOJQGEZDGNBVGY3TQOJQ";
+
+std::string hex(const uint8_t* data, size_t length) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (size_t i = 0; i < length; ++i) {
+        out.push_back(digits[data[i] >> 4]);
+        out.push_back(digits[data[i] & 0x0F]);
+    }
+    return out;
+}
+
+const uint8_t* bytes(const char* text) {
+    return reinterpret_cast<const uint8_t*>(text);
+}
+
+void testHotp() {
+    // RFC 4226 appendix D
+    const char* expected[] = {"755224", "287082", "359152", "969429", "338314",
+                              "254676", "287922", "162583", "399871", "520489"};
+    char code[OTP_CODE_CAPACITY];
+    for (uint64_t counter = 0; counter < 10; ++counter) {
+        CHECK_EQ(otp_generate_hotp(RFC_SECRET, counter, 6, "SHA1", code, sizeof(code)), 6);
+        CHECK_EQ(std::string(code), std::string(expected[counter]));
+    }
+    CHECK_EQ(otp_generate_hotp(RFC_SECRET, 0, 6, "SHA1", code, 6), OTP_ERR_BUFFER_TOO_SMALL);
+    CHECK_EQ(otp_generate_hotp("not base32!", 0, 6, "SHA1", code, sizeof(code)), OTP_ERR_INVALID_ARGUMENT);
+
+    // Resynchronization finds the counter following the matched codes
+    const char* single[] = {"969429"};
+    CHECK_EQ(otp_resync_hotp(RFC_SECRET, 0, single, 1, 10, 6, "SHA1"), 4);
+    const char* pair[] = {"399871", "520489"};
+    CHECK_EQ(otp_resync_hotp(RFC_SECRET, 0, pair, 2, 9, 6, "SHA1"), 10);
+    CHECK_EQ(otp_resync_hotp(RFC_SECRET, 0, pair, 2, 8, 6, "SHA1"), -1);
+}
+
+void testTotp() {
+    // RFC 6238 appendix B, SHA1, eight digits, 30 s steps
+    const struct { uint64_t time; const char* code; } vectors[] = {
+        {59, "94287082"}, {1111111109, "07081804"}, {1111111111, "14050471"},
+        {1234567890, "89005924"}, {2000000000, "69279037"}, {20000000000ULL, "65353130"},
+    };
+    char code[OTP_CODE_CAPACITY];
+    for (const auto& vector : vectors) {
+        CHECK_EQ(otp_generate_totp(RFC_SECRET, vector.time / 30, 8, "SHA1", code, sizeof(code)), 8);
+        CHECK_EQ(std::string(code), std::string(vector.code));
+    }
+}
+
+void testMotp() {
+    // md5(epoch / 10 || secret || pin), first six hex digits
+    char code[OTP_CODE_CAPACITY];
+    CHECK_EQ(otp_generate_motp("e3152afee62599c8", "1234", 1165151345, 10, code, sizeof(code)), 6);
+    CHECK_EQ(std::string(code), std::string("021506"));
+    CHECK_EQ(otp_generate_motp("e3152afee62599c8", "1234", 1700000000, 10, code, sizeof(code)), 6);
+    CHECK_EQ(std::string(code), std::string("ac896a"));
+    CHECK_EQ(otp_generate_motp("0123456789abcdef", "9999", 0, 10, code, sizeof(code)), 6);
+    CHECK_EQ(std::string(code), std::string("c46453"));
+}
+
+void testSteam() {
+    // HMAC-SHA1 truncation written in base 26 over the Steam Guard alphabet
+    const struct { uint64_t slot; const char* code; } vectors[] = {
+        {0, "GG5F5"}, {1, "PV9M4"}, {37037036, "PY4YB"}, {56666666, "R87JJ"},
+    };
+    char code[OTP_CODE_CAPACITY];
+    for (const auto& vector : vectors) {
+        CHECK_EQ(otp_generate_steam(RFC_SECRET, vector.slot, code, sizeof(code)), 5);
+        CHECK_EQ(std::string(code), std::string(vector.code));
+    }
+}
+
+void testBatch() {
+    // The batched path must agree with the single-code one, including
+    // across lane boundaries and with mixed encodings
+    const size_t count = 11;
+    const char* secrets[count];
+    uint8_t encodings[count];
+    uint64_t counters[count];
+    int digits[count];
+    for (size_t i = 0; i < count; ++i) {
+        secrets[i] = i == 5 ? "invalid!" : RFC_SECRET;
+        encodings[i] = i % 4 == 3 ? OTP_ENCODING_STEAM : OTP_ENCODING_DECIMAL;
+        counters[i] = i * 7;
+        digits[i] = 6 + static_cast<int>(i % 3);
+    }
+    char codes[count * OTP_CODE_CAPACITY];
+    CHECK_EQ(otp_generate_batch(secrets, encodings, counters, digits, count, codes), static_cast<int>(count));
+
+    char single[OTP_CODE_CAPACITY];
+    for (size_t i = 0; i < count; ++i) {
+        const char* batched = codes + i * OTP_CODE_CAPACITY;
+        if (i == 5) {
+            CHECK_EQ(std::string(batched), std::string());
+        } else if (encodings[i] == OTP_ENCODING_STEAM) {
+            otp_generate_steam(RFC_SECRET, counters[i], single, sizeof(single));
+            CHECK_EQ(std::string(batched), std::string(single));
+        } else {
+            otp_generate_hotp(RFC_SECRET, counters[i], digits[i], "SHA1", single, sizeof(single));
+            CHECK_EQ(std::string(batched), std::string(single));
+        }
+    }
+}
+
+void testBase32() {
+    uint8_t decoded[32];
+    CHECK_EQ(otp_base32_decode(RFC_SECRET, decoded, sizeof(decoded)), 20);
+    CHECK(std::memcmp(decoded, "12345678901234567890", 20) == 0);
+    char encoded[40];
+    CHECK_EQ(otp_base32_encode(decoded, 20, encoded, sizeof(encoded)), 32);
+    CHECK_EQ(std::string(encoded), std::string(RFC_SECRET));
+    CHECK_EQ(otp_validate_secret(RFC_SECRET), 1);
+    CHECK_EQ(otp_validate_secret("ABC1"), 0);
+}
+
+void testCrypto() {
+    uint8_t out[CRYPTO_MAX_DIGEST_SIZE];
+
+    // FIPS 180-2 "abc"
+    CHECK_EQ(crypto_hash(CRYPTO_HASH_SHA256, bytes("abc"), 3, out, sizeof(out)), 32);
+    CHECK_EQ(hex(out, 32), std::string("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+
+    // RFC 4231 test case 2
+    const char* data = "what do ya want for nothing?";
+    CHECK_EQ(crypto_hmac(CRYPTO_HASH_SHA256, bytes("Jefe"), 4, bytes(data), std::strlen(data), out, sizeof(out)), 32);
+    CHECK_EQ(hex(out, 32), std::string("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"));
+
+    // PBKDF2-HMAC-SHA256, "password" / "salt", 4096 iterations
+    CHECK_EQ(crypto_derive_key(CRYPTO_KDF_PBKDF2, "password", 8, bytes("salt"), 4, 4096, 0, 1, out, 32), 32);
+    CHECK_EQ(hex(out, 32), std::string("c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a"));
+
+    // GCM spec test case 2: zero key, IV and block
+    uint8_t key[16] = {};
+    uint8_t iv[12] = {};
+    uint8_t plain[16] = {};
+    uint8_t sealed[16];
+    uint8_t tag[CRYPTO_TAG_SIZE];
+    CHECK_EQ(crypto_encrypt(CRYPTO_CIPHER_AES_128_GCM, CRYPTO_PADDING_NONE, key, sizeof(key), iv, sizeof(iv),
+                            nullptr, 0, plain, sizeof(plain), sealed, sizeof(sealed), tag), 16);
+    CHECK_EQ(hex(sealed, 16), std::string("0388dace60b6a392f328c2b971b2fe78"));
+    CHECK_EQ(hex(tag, 16), std::string("ab6e47d42cec13bdf53a67b21257bddf"));
+
+    uint8_t opened[16];
+    CHECK_EQ(crypto_decrypt(CRYPTO_CIPHER_AES_128_GCM, CRYPTO_PADDING_NONE, key, sizeof(key), iv, sizeof(iv),
+                            nullptr, 0, tag, sealed, sizeof(sealed), opened, sizeof(opened)), 16);
+    CHECK(std::memcmp(opened, plain, sizeof(plain)) == 0);
+    tag[0] ^= 1;
+    CHECK_EQ(crypto_decrypt(CRYPTO_CIPHER_AES_128_GCM, CRYPTO_PADDING_NONE, key, sizeof(key), iv, sizeof(iv),
+                            nullptr, 0, tag, sealed, sizeof(sealed), opened, sizeof(opened)),
+             CRYPTO_ERR_OPERATION_FAILED);
+
+    CHECK_EQ(crypto_random_bytes(out, 32), 32);
+}
+
+// HKDF has no C entry point; the engine is what the bridges call
+void testHkdf() {
+    using crypto_native::HashAlgorithm;
+    using crypto_native::SecureBytes;
+
+    crypto_native::CryptoEngine engine;
+    const SecureBytes ikm(22, 0x0b);
+    std::vector<uint8_t> salt;
+    for (uint8_t i = 0x00; i <= 0x0c; ++i) {
+        salt.push_back(i);
+    }
+    std::vector<uint8_t> info;
+    for (uint8_t i = 0xf0; i <= 0xf9; ++i) {
+        info.push_back(i);
+    }
+
+    // RFC 5869 test case 1
+    SecureBytes prk = engine.hkdfExtract(salt, ikm, HashAlgorithm::SHA256);
+    CHECK_EQ(hex(prk.data(), prk.size()),
+             std::string("077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5"));
+    SecureBytes okm = engine.hkdfExpand(prk, info, 42, HashAlgorithm::SHA256);
+    CHECK_EQ(hex(okm.data(), okm.size()),
+             std::string("3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208d5b887185865"));
+
+    // RFC 5869 test case 3: empty salt and info
+    prk = engine.hkdfExtract({}, ikm, HashAlgorithm::SHA256);
+    CHECK_EQ(hex(prk.data(), prk.size()),
+             std::string("19ef24a32c717b167f33a91d6f648bdf96596776afdb6377ac434c1c293ccb04"));
+    okm = engine.hkdfExpand(prk, {}, 42, HashAlgorithm::SHA256);
+    CHECK_EQ(hex(okm.data(), okm.size()),
+             std::string("8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d9d201395faa4b61a96c8"));
+
+    // Extracting from a key handle matches the raw-key path
+    crypto_native::KeyHandle ikmHandle(ikm);
+    CHECK(engine.hkdfExtract(salt, ikmHandle, HashAlgorithm::SHA256) ==
+          engine.hkdfExtract(salt, ikm, HashAlgorithm::SHA256));
+
+    // Batch output is the single expansions concatenated, per label, for both
+    // digests and for lengths that end mid-block
+    const std::vector<std::vector<uint8_t>> labels = {info, {}, {'v', 'a', 'u', 'l', 't'}, std::vector<uint8_t>(200, 7)};
+    for (HashAlgorithm algorithm : {HashAlgorithm::SHA256, HashAlgorithm::SHA512}) {
+        const SecureBytes batchPrk = engine.hkdfExtract(salt, ikm, algorithm);
+        crypto_native::KeyHandle prkHandle(batchPrk);
+        for (size_t length : {size_t(16), size_t(42), size_t(100)}) {
+            const SecureBytes batch = engine.hkdfExpandBatch(prkHandle, labels, length, algorithm);
+            SecureBytes singles;
+            for (const auto& label : labels) {
+                const SecureBytes one = engine.hkdfExpand(batchPrk, label, length, algorithm);
+                singles.insert(singles.end(), one.begin(), one.end());
+            }
+            CHECK_EQ(batch.size(), labels.size() * length);
+            CHECK(batch == singles);
+        }
+    }
+}
+
+} // anonymous namespace
+
+int main() {
+    CHECK_EQ(otp_abi_version(), static_cast<uint32_t>(OTP_NATIVE_ABI_VERSION));
+    CHECK_EQ(crypto_abi_version(), static_cast<uint32_t>(CRYPTO_NATIVE_ABI_VERSION));
+    testHotp();
+    testTotp();
+    testMotp();
+    testSteam();
+    testBatch();
+    testBase32();
+    testCrypto();
+    testHkdf();
+    return native_tests::finish("OtpConformance");
+}
@@ -0,0 +1,129 @@
+#include "OtpImport.h"
+#include "TestSupport.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// URI fixtures live in fixtures/import, one URI per line; '#' lines are
+// comments. Expected secrets are the Base32 or raw bytes the fixtures encode.
+
+using OtpImport::ImportBatch;
+using OtpImport::OtpAlgorithm;
+using OtpImport::OtpType;
+using OtpImport::PackedAccount;
+
+namespace {
+
+std::vector<std::string> readUris(const std::string& path) {
+    std::vector<std::string> uris;
+    std::ifstream in(path);
+    CHECK(in.good());
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line[0] != '#') {
+            uris.push_back(line);
+        }
+    }
+    return uris;
+}
+
+std::string secretOf(const ImportBatch& batch, const PackedAccount& account) {
+    return std::string(reinterpret_cast<const char*>(batch.secret(account)), account.secretLength);
+}
+
+// "Hello!" followed by 0xDEADBEEF, the RFC 4226 style example secret
+const std::string HELLO = std::string("Hello!\xde\xad\xbe\xef", 10);
+const std::string RFC_SECRET = "12345678901234567890";
+
+void testOtpauth(const std::string& fixtures) {
+    const std::vector<std::string> uris = readUris(fixtures + "/otpauth.txt");
+    CHECK_EQ(uris.size(), size_t(9));
+    const ImportBatch batch = OtpImport::parseUris(uris);
+    CHECK_EQ(batch.accounts.size(), size_t(4));
+    CHECK_EQ(batch.rejected, 5u);
+    if (batch.accounts.size() != 4) {
+        return;
+    }
+
+    const PackedAccount& github = batch.accounts[0];
+    CHECK_EQ(batch.issuer(github), std::string("GitHub"));
+    CHECK_EQ(batch.name(github), std::string("alice@example.com"));
+    CHECK_EQ(secretOf(batch, github), HELLO);
+    CHECK(github.type == OtpType::TOTP);
+    CHECK_EQ(int(github.digits), 6);
+    CHECK_EQ(int(github.period), 30);
+
+    const PackedAccount& bank = batch.accounts[1];
+    CHECK_EQ(batch.issuer(bank), std::string());
+    CHECK_EQ(batch.name(bank), std::string("Bank"));
+    CHECK_EQ(secretOf(batch, bank), RFC_SECRET);
+    CHECK(bank.type == OtpType::HOTP);
+    CHECK(bank.algorithm == OtpAlgorithm::SHA256);
+    CHECK_EQ(int(bank.digits), 8);
+    CHECK_EQ(bank.counter, uint64_t(7));
+
+    // Issuer taken from the label; lower-case secret with spaces
+    const PackedAccount& acme = batch.accounts[2];
+    CHECK_EQ(batch.issuer(acme), std::string("ACME Co"));
+    CHECK_EQ(batch.name(acme), std::string("bob"));
+    CHECK_EQ(secretOf(batch, acme), HELLO);
+    CHECK_EQ(int(acme.period), 60);
+
+    const PackedAccount& steam = batch.accounts[3];
+    CHECK(steam.type == OtpType::STEAM);
+    CHECK_EQ(int(steam.digits), 5);
+    CHECK_EQ(batch.name(steam), std::string("gamer"));
+}
+
+void testMigration(const std::string& fixtures) {
+    const std::vector<std::string> uris = readUris(fixtures + "/migration.txt");
+    CHECK_EQ(uris.size(), size_t(3));
+
+    // Complete export: two accounts, the empty-secret entry rejected alone
+    ImportBatch batch = OtpImport::parseUris({uris[0]});
+    CHECK_EQ(batch.accounts.size(), size_t(2));
+    CHECK_EQ(batch.rejected, 1u);
+    if (batch.accounts.size() == 2) {
+        CHECK_EQ(batch.issuer(batch.accounts[0]), std::string("GitHub"));
+        CHECK_EQ(batch.name(batch.accounts[0]), std::string("alice@example.com"));
+        CHECK_EQ(secretOf(batch, batch.accounts[0]), HELLO);
+        CHECK(batch.accounts[1].type == OtpType::HOTP);
+        CHECK(batch.accounts[1].algorithm == OtpAlgorithm::SHA256);
+        CHECK_EQ(int(batch.accounts[1].digits), 8);
+        CHECK_EQ(batch.accounts[1].counter, uint64_t(42));
+        CHECK_EQ(secretOf(batch, batch.accounts[1]), RFC_SECRET);
+    }
+
+    // Malformed payloads after good entries: nothing from the URI is kept,
+    // and the URI is one rejection
+    for (size_t i = 1; i < uris.size(); ++i) {
+        batch = OtpImport::parseUris({uris[i]});
+        CHECK_EQ(batch.accounts.size(), size_t(0));
+        CHECK_EQ(batch.pool.size(), size_t(0));
+        CHECK_EQ(batch.rejected, 1u);
+    }
+
+    // Earlier URIs in the same batch are unaffected by the rollback
+    batch = OtpImport::parseUris({uris[0], uris[1], readUris(fixtures + "/otpauth.txt")[0]});
+    CHECK_EQ(batch.accounts.size(), size_t(3));
+    CHECK_EQ(batch.rejected, 2u);
+    if (batch.accounts.size() == 3) {
+        CHECK_EQ(secretOf(batch, batch.accounts[1]), RFC_SECRET);
+        CHECK_EQ(batch.issuer(batch.accounts[2]), std::string("GitHub"));
+        CHECK_EQ(secretOf(batch, batch.accounts[2]), HELLO);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <fixtures/import>\n", argv[0]);
+        return 2;
+    }
+    const std::string fixtures = argv[1];
+    testOtpauth(fixtures);
+    testMigration(fixtures);
+    return native_tests::finish("OtpImport");
+}
@@ -0,0 +1,167 @@
+#include "CryptoEngine.h"
+#include "ParallelCipher.h"
+#include "PortableCrypto.h"
+#include "TestSupport.h"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// The segmented CTR and GCM paths against the serial portable primitives,
+// at lengths that leave a partial block and uneven segments. Segment counts
+// are forced as well, so the split is covered on single-core hosts.
+
+using crypto_native::AuthenticationFailedException;
+using crypto_native::CipherAlgorithm;
+using crypto_native::CryptoEngine;
+using crypto_native::EncryptionResult;
+using crypto_native::ParallelCipher;
+using crypto_native::PaddingMode;
+using crypto_native::SecureBytes;
+namespace portable = crypto_native::portable;
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+const size_t LENGTHS[] = {
+    ParallelCipher::kThreshold + 13,
+    3 * ParallelCipher::kThreshold + 5,
+    5 * ParallelCipher::kMinSegment - 1,
+};
+
+// 0 lets segmentsFor pick
+const size_t SEGMENTS[] = {0, 3, 7};
+
+Bytes pattern(size_t length, uint8_t seed) {
+    Bytes data(length);
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = static_cast<uint8_t>(i * 31 + seed);
+    }
+    return data;
+}
+
+void testSegmentsFor() {
+    CHECK_EQ(ParallelCipher::segmentsFor(ParallelCipher::kThreshold - 1), size_t(1));
+    if (std::thread::hardware_concurrency() > 1) {
+        CHECK(ParallelCipher::segmentsFor(3 * ParallelCipher::kThreshold) > 1);
+    }
+}
+
+void testCtrMatchesSerial(const SecureBytes& key) {
+    // Start near a byte carry so segment counters cross it
+    uint8_t iv[16];
+    std::memset(iv, 0xFF, sizeof(iv));
+    iv[0] = 0x12;
+    iv[14] = 0xF0;
+
+    portable::Aes aes(key.data(), key.size());
+    for (size_t length : LENGTHS) {
+        const Bytes data = pattern(length, 7);
+        uint8_t counter[16];
+        std::memcpy(counter, iv, sizeof(counter));
+        Bytes serial(length);
+        portable::aesCtr(aes, counter, data.data(), length, serial.data());
+
+        for (size_t segments : SEGMENTS) {
+            Bytes parallel(length);
+            ParallelCipher::ctr(key, iv, data.data(), length, parallel.data(), segments);
+            CHECK(parallel == serial);
+        }
+    }
+}
+
+void testGcmMatchesSerial(const SecureBytes& key) {
+    const uint8_t iv[12] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    portable::AesGcm gcm(key.data(), key.size());
+
+    for (size_t aadLength : {size_t(0), size_t(21)}) {
+        const Bytes aad = pattern(aadLength, 99);
+        for (size_t length : LENGTHS) {
+            const Bytes data = pattern(length, 3);
+            Bytes serial(length);
+            uint8_t serialTag[16];
+            gcm.seal(iv, sizeof(iv), aad.data(), aad.size(), data.data(), length, serial.data(), serialTag);
+
+            for (size_t segments : SEGMENTS) {
+                Bytes parallel(length);
+                uint8_t parallelTag[16];
+                ParallelCipher::gcmEncrypt(key, iv, aad.data(), aad.size(), data.data(), length,
+                                           parallel.data(), parallelTag, segments);
+                CHECK(parallel == serial);
+                CHECK(std::memcmp(parallelTag, serialTag, sizeof(serialTag)) == 0);
+
+                Bytes opened(length);
+                CHECK(ParallelCipher::gcmDecrypt(key, iv, aad.data(), aad.size(), serial.data(), length,
+                                                 opened.data(), serialTag, sizeof(serialTag), segments));
+                CHECK(opened == data);
+            }
+        }
+    }
+}
+
+void testGcmRejectsTampering(const SecureBytes& key) {
+    const uint8_t iv[12] = {};
+    const size_t length = 2 * ParallelCipher::kThreshold + 9;
+    const Bytes data = pattern(length, 5);
+    Bytes ciphertext(length);
+    uint8_t tag[16];
+    ParallelCipher::gcmEncrypt(key, iv, nullptr, 0, data.data(), length, ciphertext.data(), tag, 4);
+
+    tag[15] ^= 0x80;
+    Bytes out(length, 0xAA);
+    CHECK(!ParallelCipher::gcmDecrypt(key, iv, nullptr, 0, ciphertext.data(), length, out.data(), tag, 16, 4));
+    CHECK(out == Bytes(length, 0));
+    tag[15] ^= 0x80;
+
+    // A flipped bit in the last, partial segment
+    ciphertext[length - 1] ^= 1;
+    CHECK(!ParallelCipher::gcmDecrypt(key, iv, nullptr, 0, ciphertext.data(), length, out.data(), tag, 16, 4));
+    ciphertext[length - 1] ^= 1;
+    CHECK(ParallelCipher::gcmDecrypt(key, iv, nullptr, 0, ciphertext.data(), length, out.data(), tag, 16, 4));
+    CHECK(out == data);
+}
+
+void testEngineRoutes(CryptoEngine& engine, const SecureBytes& key) {
+    const size_t length = 3 * ParallelCipher::kThreshold + 5;
+    const Bytes data = pattern(length, 11);
+    const Bytes aad = {'h', 'e', 'a', 'd'};
+
+    EncryptionResult sealed = engine.encrypt(data, key, CipherAlgorithm::AES_256_GCM, PaddingMode::NONE, {}, aad);
+    Bytes serial(length);
+    uint8_t serialTag[16];
+    portable::AesGcm gcm(key.data(), key.size());
+    gcm.seal(sealed.iv.data(), sealed.iv.size(), aad.data(), aad.size(), data.data(), length, serial.data(),
+             serialTag);
+    CHECK(sealed.ciphertext == serial);
+    CHECK(sealed.tag == Bytes(serialTag, serialTag + 16));
+    CHECK(engine.decrypt(sealed.ciphertext, key, CipherAlgorithm::AES_256_GCM, sealed.iv, PaddingMode::NONE, aad,
+                         sealed.tag) == data);
+
+    sealed.tag[0] ^= 1;
+    bool threw = false;
+    try {
+        engine.decrypt(sealed.ciphertext, key, CipherAlgorithm::AES_256_GCM, sealed.iv, PaddingMode::NONE, aad,
+                       sealed.tag);
+    } catch (const AuthenticationFailedException&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    EncryptionResult ctr = engine.encrypt(data, key, CipherAlgorithm::AES_256_CTR, PaddingMode::NONE);
+    CHECK(engine.decrypt(ctr.ciphertext, key, CipherAlgorithm::AES_256_CTR, ctr.iv, PaddingMode::NONE) == data);
+}
+
+} // namespace
+
+int main() {
+    CryptoEngine engine;
+    testSegmentsFor();
+    for (size_t keySize : {size_t(16), size_t(32)}) {
+        const SecureBytes key = engine.generateKey(keySize);
+        testCtrMatchesSerial(key);
+        testGcmMatchesSerial(key);
+        testGcmRejectsTampering(key);
+    }
+    testEngineRoutes(engine, engine.generateKey(32));
+    return native_tests::finish("ParallelCipher");
+}
@@ -0,0 +1,278 @@
+#include "CryptoEngine.h"
+#include "SealedStream.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Streams are sealed into memory, cut into records by their length fields
+// and reassembled to simulate reordering, truncation and trailing data.
+
+using crypto_native::AuthenticationFailedException;
+using crypto_native::CipherAlgorithm;
+using crypto_native::CompressionMode;
+using crypto_native::CryptoEngine;
+using crypto_native::CryptoOperationException;
+using crypto_native::KeyHandle;
+using crypto_native::SecureBytes;
+using crypto_native::StreamOpener;
+using crypto_native::StreamSealer;
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+// Layout constants from SealedStream.h
+constexpr size_t HEADER_SIZE = 18;
+constexpr size_t LENGTH_SIZE = 4;
+constexpr size_t SEGMENT_HEADER_SIZE = 5;
+constexpr size_t TAG_SIZE = 16;
+constexpr uint32_t FINAL_RECORD = 0x80000000u;
+constexpr size_t SEGMENT = StreamSealer::kMinSegmentSize;
+
+// Text-like input that every codec shrinks
+Bytes compressible(size_t length) {
+    const std::string line = "otpauth://totp/Example:alice@example.com?secret=JBSWY3DPEHPK3PXP&issuer=Example\n";
+    Bytes data(length);
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = static_cast<uint8_t>(line[i % line.size()] + (i / 997) % 3);
+    }
+    return data;
+}
+
+Bytes incompressible(size_t length, uint32_t seed) {
+    Bytes data(length);
+    for (uint8_t& byte : data) {
+        seed = seed * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(seed >> 24);
+    }
+    return data;
+}
+
+Bytes seal(const SecureBytes& key, CompressionMode compression, const Bytes& data, size_t chunk = 1000) {
+    Bytes out;
+    StreamSealer sealer(key, CipherAlgorithm::AES_256_GCM, compression,
+                        [&](const uint8_t* bytes, size_t length) { out.insert(out.end(), bytes, bytes + length); },
+                        SEGMENT);
+    for (size_t offset = 0; offset < data.size(); offset += chunk) {
+        sealer.update(data.data() + offset, std::min(chunk, data.size() - offset));
+    }
+    sealer.finish();
+    CHECK_EQ(sealer.bytesIn(), uint64_t(data.size()));
+    CHECK_EQ(sealer.bytesOut(), uint64_t(out.size()));
+    return out;
+}
+
+// Opens `stream` fed in `chunk`-byte pieces; throws whatever the opener throws
+Bytes open(const SecureBytes& key, const Bytes& stream, size_t chunk = 777) {
+    Bytes out;
+    StreamOpener opener(key, [&](const uint8_t* bytes, size_t length) { out.insert(out.end(), bytes, bytes + length); });
+    for (size_t offset = 0; offset < stream.size(); offset += chunk) {
+        opener.update(stream.data() + offset, std::min(chunk, stream.size() - offset));
+    }
+    opener.finish();
+    return out;
+}
+
+uint32_t loadBe32(const uint8_t* in) {
+    return (static_cast<uint32_t>(in[0]) << 24) | (static_cast<uint32_t>(in[1]) << 16) |
+           (static_cast<uint32_t>(in[2]) << 8) | in[3];
+}
+
+struct Parsed {
+    Bytes header;
+    std::vector<Bytes> records;  // each with its length field
+};
+
+Parsed split(const Bytes& stream) {
+    Parsed parsed;
+    parsed.header.assign(stream.begin(), stream.begin() + HEADER_SIZE);
+    size_t offset = HEADER_SIZE;
+    while (offset < stream.size()) {
+        const size_t body = loadBe32(stream.data() + offset) & ~FINAL_RECORD;
+        parsed.records.emplace_back(stream.begin() + offset, stream.begin() + offset + LENGTH_SIZE + body);
+        offset += LENGTH_SIZE + body;
+    }
+    CHECK_EQ(offset, stream.size());
+    return parsed;
+}
+
+Bytes join(const Parsed& parsed) {
+    Bytes stream = parsed.header;
+    for (const Bytes& record : parsed.records) {
+        stream.insert(stream.end(), record.begin(), record.end());
+    }
+    return stream;
+}
+
+bool isFinal(const Bytes& record) {
+    return (loadBe32(record.data()) & FINAL_RECORD) != 0;
+}
+
+size_t bodyLength(const Bytes& record) {
+    return loadBe32(record.data()) & ~FINAL_RECORD;
+}
+
+template <typename Exception>
+bool rejects(const SecureBytes& key, const Bytes& stream) {
+    try {
+        open(key, stream);
+    } catch (const Exception&) {
+        return true;
+    }
+    return false;
+}
+
+void testRoundTrips(const SecureBytes& key) {
+    for (CompressionMode mode : {CompressionMode::NONE, CompressionMode::FAST, CompressionMode::HIGH}) {
+        // Whole segments, a partial tail, exactly one segment, and empty
+        for (size_t length : {5 * SEGMENT + 123, SEGMENT, size_t(0)}) {
+            const Bytes data = compressible(length);
+            const Bytes stream = seal(key, mode, data);
+            CHECK(open(key, stream) == data);
+            CHECK(open(key, stream, 1) == data);
+
+            const Parsed parsed = split(stream);
+            const size_t records = length == 0 ? 1 : (length + SEGMENT - 1) / SEGMENT;
+            CHECK_EQ(parsed.records.size(), records);
+            for (size_t i = 0; i < parsed.records.size(); ++i) {
+                CHECK_EQ(isFinal(parsed.records[i]), i + 1 == parsed.records.size());
+            }
+            if (mode != CompressionMode::NONE && length > 0) {
+                CHECK(stream.size() < data.size() / 2);
+            }
+        }
+    }
+}
+
+void testRawStoredSegment(const SecureBytes& key) {
+    // Compressible, random, compressible: the middle segment cannot shrink
+    Bytes data = compressible(SEGMENT);
+    const Bytes noise = incompressible(SEGMENT, 42);
+    data.insert(data.end(), noise.begin(), noise.end());
+    const Bytes tail = compressible(SEGMENT / 2);
+    data.insert(data.end(), tail.begin(), tail.end());
+
+    for (CompressionMode mode : {CompressionMode::FAST, CompressionMode::HIGH}) {
+        const Bytes stream = seal(key, mode, data);
+        const Parsed parsed = split(stream);
+        CHECK_EQ(parsed.records.size(), size_t(3));
+        CHECK(bodyLength(parsed.records[0]) < SEGMENT / 2);
+        CHECK_EQ(bodyLength(parsed.records[1]), SEGMENT_HEADER_SIZE + SEGMENT + TAG_SIZE);
+        CHECK(bodyLength(parsed.records[2]) < SEGMENT / 4);
+        CHECK(open(key, stream) == data);
+    }
+}
+
+void testRejectsTampering(CryptoEngine& engine, const SecureBytes& key) {
+    const Bytes data = compressible(4 * SEGMENT + 10);
+    const Bytes stream = seal(key, CompressionMode::FAST, data);
+    const Parsed parsed = split(stream);
+    CHECK_EQ(parsed.records.size(), size_t(5));
+
+    // Swapped middle records: the nonce carries the index
+    Parsed reordered = parsed;
+    std::swap(reordered.records[1], reordered.records[2]);
+    CHECK(rejects<AuthenticationFailedException>(key, join(reordered)));
+
+    // Cut at a record boundary: every record authenticates, none was final
+    Parsed truncated = parsed;
+    truncated.records.pop_back();
+    CHECK(rejects<CryptoOperationException>(key, join(truncated)));
+    try {
+        open(key, join(truncated));
+    } catch (const AuthenticationFailedException&) {
+        CHECK(false);
+    } catch (const CryptoOperationException& e) {
+        CHECK(std::string(e.what()).find("Truncated") != std::string::npos);
+    }
+
+    // The final flag is part of the nonce, so it cannot be moved either
+    Parsed promoted = truncated;
+    Bytes& last = promoted.records.back();
+    last[0] |= 0x80;
+    CHECK(rejects<AuthenticationFailedException>(key, join(promoted)));
+
+    // Anything after the final record, even a repeat of it
+    Bytes trailing = stream;
+    trailing.push_back(0);
+    CHECK(rejects<CryptoOperationException>(key, trailing));
+    Bytes replayed = stream;
+    replayed.insert(replayed.end(), parsed.records.back().begin(), parsed.records.back().end());
+    CHECK(rejects<CryptoOperationException>(key, replayed));
+
+    // Flipped ciphertext, flipped header (AAD), wrong key
+    Bytes flipped = stream;
+    flipped[HEADER_SIZE + LENGTH_SIZE + 3] ^= 1;
+    CHECK(rejects<AuthenticationFailedException>(key, flipped));
+    Bytes prefix = stream;
+    prefix[8] ^= 1;
+    CHECK(rejects<AuthenticationFailedException>(key, prefix));
+    CHECK(rejects<AuthenticationFailedException>(engine.generateKey(32), stream));
+
+    // Only the header, and a header that is not ours
+    CHECK(rejects<CryptoOperationException>(key, parsed.header));
+    Bytes foreign = stream;
+    foreign[0] = 'X';
+    CHECK(rejects<CryptoOperationException>(key, foreign));
+}
+
+void testFileHelpers(CryptoEngine& engine) {
+    char pattern[] = "/tmp/sealedtestXXXXXX";
+    const std::string directory = mkdtemp(pattern);
+    const std::string plainPath = directory + "/plain";
+    const std::string sealedPath = directory + "/sealed";
+    const std::string openedPath = directory + "/opened";
+
+    const Bytes data = compressible(3 * StreamSealer::kDefaultSegmentSize + 17);
+    FILE* file = std::fopen(plainPath.c_str(), "wb");
+    std::fwrite(data.data(), 1, data.size(), file);
+    std::fclose(file);
+
+    KeyHandle key(engine.generateKey(32));
+    const auto sealed = crypto_native::sealFile(key, CipherAlgorithm::AES_256_GCM, CompressionMode::HIGH,
+                                                plainPath, sealedPath);
+    CHECK_EQ(sealed.bytesIn, uint64_t(data.size()));
+    const auto opened = crypto_native::openFile(key, sealedPath, openedPath);
+    CHECK_EQ(opened.bytesOut, uint64_t(data.size()));
+
+    Bytes readBack(data.size() + 1);
+    file = std::fopen(openedPath.c_str(), "rb");
+    CHECK_EQ(std::fread(readBack.data(), 1, readBack.size(), file), data.size());
+    std::fclose(file);
+    readBack.resize(data.size());
+    CHECK(readBack == data);
+
+    // A truncated stream leaves neither the output nor its staging file
+    CHECK_EQ(truncate(sealedPath.c_str(), static_cast<off_t>(sealed.bytesOut - 1)), 0);
+    const std::string failedPath = directory + "/failed";
+    bool threw = false;
+    try {
+        crypto_native::openFile(key, sealedPath, failedPath);
+    } catch (const CryptoOperationException&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(access(failedPath.c_str(), F_OK) != 0);
+    CHECK(access((failedPath + ".partial").c_str(), F_OK) != 0);
+
+    for (const std::string& path : {plainPath, sealedPath, openedPath}) {
+        std::remove(path.c_str());
+    }
+    rmdir(directory.c_str());
+}
+
+} // namespace
+
+int main() {
+    CryptoEngine engine;
+    const SecureBytes key = engine.generateKey(32);
+    testRoundTrips(key);
+    testRawStoredSegment(key);
+    testRejectsTampering(engine, key);
+    testFileHelpers(engine);
+    return native_tests::finish("SealedStream");
+}
@@ -0,0 +1,123 @@
+#include "SearchIndex.h"
+#include "TestSupport.h"
+#include <string>
+#include <vector>
+
+using AccountSearch::SearchIndex;
+
+namespace {
+
+std::string joined(const std::vector<const std::string*>& results) {
+    std::string out;
+    for (const std::string* id : results) {
+        out += (out.empty() ? "" : ",") + *id;
+    }
+    return out;
+}
+
+void populate(SearchIndex& index) {
+    index.upsert("1", "GitHub", "GitHub", "alice@example.com");
+    index.upsert("2", "Work Git", "GitLab", "bob@corp.example");
+    index.upsert("3", "Google", "Google", "alice@gmail.com");
+    index.upsert("4", "Digital Ocean", "DigitalOcean", "ops@example.com");
+    index.upsert("5", "Discord", "", "gamer@example.com");
+}
+
+void testRanking() {
+    SearchIndex index;
+    populate(index);
+    CHECK_EQ(index.size(), size_t(5));
+
+    // Prefix of a name beats a word prefix, which beats a plain substring
+    CHECK_EQ(joined(index.query("git", 0)), std::string("1,2,4"));
+    // Exact name first; issuer-only matches rank below name matches
+    CHECK_EQ(joined(index.query("  GOOGLE ", 0)), std::string("3"));
+    // Email field, case-insensitive
+    CHECK_EQ(joined(index.query("ALICE@", 0)), std::string("1,3"));
+    CHECK_EQ(joined(index.query("git", 2)), std::string("1,2"));
+    CHECK(index.query("zzz", 0).empty());
+    CHECK(index.query("   ", 0).empty());
+}
+
+void testShortQueries() {
+    SearchIndex index;
+    populate(index);
+
+    // Under three bytes there is no trigram; the fields are scanned instead
+    CHECK_EQ(joined(index.query("g", 0)), std::string("1,3,2,5,4"));
+    CHECK_EQ(joined(index.query("di", 0)), std::string("4,5"));
+    CHECK_EQ(joined(index.query("oc", 0)), std::string("4"));
+    CHECK(index.query("qq", 0).empty());
+}
+
+void testUpsertRenameDelete() {
+    SearchIndex index;
+    populate(index);
+
+    // Renaming replaces every field; the old text no longer matches
+    index.upsert("5", "Slack", "Slack", "team@example.com");
+    CHECK_EQ(index.size(), size_t(5));
+    CHECK(index.query("discord", 0).empty());
+    CHECK_EQ(joined(index.query("slack", 0)), std::string("5"));
+
+    CHECK(index.remove("1"));
+    CHECK(!index.remove("1"));
+    CHECK(!index.remove("missing"));
+    CHECK_EQ(index.size(), size_t(4));
+    CHECK_EQ(joined(index.query("github", 0)), std::string());
+    CHECK_EQ(joined(index.query("git", 0)), std::string("2,4"));
+
+    // Re-adding a removed id works and gets a new slot
+    index.upsert("1", "GitHub", "", "");
+    CHECK_EQ(joined(index.query("github", 0)), std::string("1"));
+
+    index.clear();
+    CHECK_EQ(index.size(), size_t(0));
+    CHECK(index.query("git", 0).empty());
+    CHECK_EQ(index.postingBytes(), size_t(0));
+}
+
+void testTypos() {
+    SearchIndex index;
+    populate(index);
+
+    // One substitution in a six-byte query
+    CHECK_EQ(joined(index.query("gitgub", 0)), std::string("1"));
+    // Two edits are allowed from eight bytes on
+    CHECK_EQ(joined(index.query("digitsl oceab", 0)), std::string("4"));
+    // Too short for typo tolerance
+    CHECK(index.query("gxt", 0).empty());
+    // A literal match suppresses fuzzy ones
+    CHECK_EQ(joined(index.query("google", 0)), std::string("3"));
+}
+
+void testRebuildAfterChurn() {
+    SearchIndex index;
+    for (int i = 0; i < 500; ++i) {
+        index.upsert("id" + std::to_string(i), "Account " + std::to_string(i), "Issuer", "");
+    }
+    // Repeated renames leave dead slots until a rebuild compacts them
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 500; ++i) {
+            index.upsert("id" + std::to_string(i), "Renamed " + std::to_string(round) + "-" + std::to_string(i),
+                         "Issuer", "");
+        }
+    }
+    CHECK_EQ(index.size(), size_t(500));
+    CHECK_EQ(joined(index.query("renamed 4-499", 0)), std::string("id499"));
+    CHECK_EQ(index.query("renamed 4-", 0).size(), size_t(500));
+    CHECK(index.query("account", 0).empty());
+    CHECK_EQ(index.query("issuer", 0).size(), size_t(500));
+    CHECK_EQ(index.query("issuer", 10).size(), size_t(10));
+}
+
+} // namespace
+
+int main() {
+    testRanking();
+    testShortQueries();
+    testUpsertRenameDelete();
+    testTypos();
+    testRebuildAfterChurn();
+    return native_tests::finish("SearchIndex");
+}
@@ -0,0 +1,116 @@
+#include "SecureArena.h"
+#include "TestSupport.h"
+#include <cstring>
+#include <unistd.h>
+
+// The arena hands freed slots straight back to the next allocation of the
+// same class, which lets these tests look at what a freed slot still holds.
+
+using crypto_native::SecureArena;
+using crypto_native::SecureBytes;
+
+namespace {
+
+bool allZero(const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        if (data[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testSlotWipedOnFree() {
+    SecureArena& arena = SecureArena::instance();
+    const size_t size = 48;  // 64-byte class
+
+    auto* slot = static_cast<uint8_t*>(arena.allocate(size));
+    CHECK(allZero(slot, size));
+    std::memset(slot, 0xA5, 64);
+    arena.deallocate(slot, size);
+
+    // Everything past the free-list link is wiped, including the slack
+    // beyond the requested size
+    CHECK(allZero(slot + sizeof(void*), 64 - sizeof(void*)));
+
+    auto* again = static_cast<uint8_t*>(arena.allocate(size));
+    CHECK(again == slot);
+    CHECK(allZero(again, 64));
+    arena.deallocate(again, size);
+}
+
+void testSizeClasses() {
+    SecureArena& arena = SecureArena::instance();
+
+    // Distinct classes never share a slot, and each is usable up to its size
+    void* small = arena.allocate(1);
+    void* medium = arena.allocate(SecureArena::kMinSlotSize + 1);
+    void* largest = arena.allocate(SecureArena::kMaxSlotSize);
+    CHECK(small != medium);
+    CHECK(medium != largest);
+    std::memset(largest, 0x5A, SecureArena::kMaxSlotSize);
+    CHECK(reinterpret_cast<uintptr_t>(largest) % alignof(std::max_align_t) == 0);
+    arena.deallocate(largest, SecureArena::kMaxSlotSize);
+    arena.deallocate(medium, SecureArena::kMinSlotSize + 1);
+    arena.deallocate(small, 1);
+
+    // Slots of a class are reused, so once its first slab exists the steady
+    // state does not map more
+    arena.deallocate(arena.allocate(200), 200);
+    const size_t mapped = arena.mappedBytes();
+    for (int i = 0; i < 1000; ++i) {
+        arena.deallocate(arena.allocate(200), 200);
+    }
+    CHECK_EQ(arena.mappedBytes(), mapped);
+}
+
+void testLargeAllocation() {
+    SecureArena& arena = SecureArena::instance();
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t size = SecureArena::kMaxSlotSize * 3 + 7;
+
+    const size_t before = arena.mappedBytes();
+    auto* region = static_cast<uint8_t*>(arena.allocate(size));
+    // Own mapping, rounded to pages, with a guard page either side
+    CHECK(arena.mappedBytes() - before >= size + 2 * page);
+    CHECK_EQ((arena.mappedBytes() - before) % page, size_t(0));
+    CHECK(allZero(region, size));
+    std::memset(region, 0xC3, size);
+
+    arena.deallocate(region, size);
+    CHECK_EQ(arena.mappedBytes(), before);
+
+    // Unknown large pointers are ignored rather than corrupting the list
+    uint8_t stack[8] = {};
+    arena.deallocate(stack, size);
+    CHECK_EQ(arena.mappedBytes(), before);
+}
+
+void testLockingBudget() {
+    SecureArena& arena = SecureArena::instance();
+    CHECK(arena.lockedBytes() <= SecureArena::kMaxLockedBytes);
+    CHECK(arena.lockedBytes() <= arena.mappedBytes());
+}
+
+void testSecureBytes() {
+    SecureBytes bytes;
+    for (int i = 0; i < 10000; ++i) {
+        bytes.push_back(static_cast<uint8_t>(i));
+    }
+    CHECK_EQ(bytes.size(), size_t(10000));
+    CHECK_EQ(int(bytes[9999]), 9999 & 0xFF);
+
+    SecureBytes copy(bytes.begin(), bytes.begin() + 32);
+    CHECK(std::memcmp(copy.data(), bytes.data(), 32) == 0);
+}
+
+} // namespace
+
+int main() {
+    testSlotWipedOnFree();
+    testSizeClasses();
+    testLargeAllocation();
+    testLockingBudget();
+    testSecureBytes();
+    return native_tests::finish("SecureArena");
+}
@@ -0,0 +1,204 @@
+#include "ServiceMatcher.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The matcher replaced the String.includes scans in
+// utils/serviceClassifier.ts. These tables mirror that file and the brand
+// keys BrandIconService registers; the reference below is a line-for-line
+// port of classifyInJs, which is still the fallback where the native module
+// is unavailable, so both paths must agree.
+
+using ServiceClassifier::Match;
+using ServiceClassifier::ServiceMatcher;
+
+namespace {
+
+const std::vector<std::string> BRANDS = {"google", "discord", "github", "microsoft", "steam", "paypal"};
+
+const std::vector<std::pair<std::string, std::string>> BRAND_ALIASES = {
+    {"gmail", "google"},     {"google mail", "google"}, {"outlook", "microsoft"}, {"hotmail", "microsoft"},
+    {"live", "microsoft"},   {"xbox", "microsoft"},     {"skype", "microsoft"},   {"onedrive", "microsoft"},
+    {"office", "microsoft"}, {"teams", "microsoft"},    {"icloud", "apple"},      {"app store", "apple"},
+    {"itunes", "apple"},     {"twitch", "amazon"},      {"aws", "amazon"},        {"whatsapp", "facebook"},
+    {"instagram", "facebook"}, {"meta", "facebook"},    {"valve", "steam"},
+};
+
+const std::vector<std::pair<std::string, std::vector<std::string>>> CATEGORY_KEYWORDS = {
+    {"Social", {"google", "facebook", "twitter", "instagram", "discord", "telegram", "whatsapp", "linkedin"}},
+    {"Finance", {"bank", "paypal", "stripe", "coinbase", "binance", "finance", "trading", "crypto"}},
+    {"Gaming", {"steam", "epic", "blizzard", "riot", "xbox", "playstation", "nintendo", "game"}},
+    {"Work", {"microsoft", "office", "github", "gitlab", "slack", "zoom", "teams", "work", "enterprise", "corp"}},
+};
+
+struct Expected {
+    std::string brand;     // Empty for none
+    std::string category;  // "Other" for none
+};
+
+bool contains(const std::string& haystack, const std::string& needle) {
+    return haystack.find(needle) != std::string::npos;
+}
+
+// classifyInJs, for ASCII names
+Expected classifyReference(const std::string& serviceName) {
+    std::string name = serviceName;
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char c) { return static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c); });
+    const size_t begin = name.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return {"", "Other"};
+    }
+    name = name.substr(begin, name.find_last_not_of(" \t\r\n") - begin + 1);
+
+    Expected result{"", "Other"};
+    if (std::find(BRANDS.begin(), BRANDS.end(), name) != BRANDS.end()) {
+        result.brand = name;
+    }
+    for (size_t i = 0; result.brand.empty() && i < BRANDS.size(); ++i) {
+        if (contains(name, BRANDS[i]) || contains(BRANDS[i], name)) {
+            result.brand = BRANDS[i];
+        }
+    }
+    for (size_t i = 0; result.brand.empty() && i < BRAND_ALIASES.size(); ++i) {
+        if (contains(name, BRAND_ALIASES[i].first)) {
+            result.brand = BRAND_ALIASES[i].second;
+        }
+    }
+    for (const auto& category : CATEGORY_KEYWORDS) {
+        if (std::any_of(category.second.begin(), category.second.end(),
+                        [&](const std::string& keyword) { return contains(name, keyword); })) {
+            result.category = category.first;
+            break;
+        }
+    }
+    return result;
+}
+
+ServiceMatcher buildMatcher() {
+    ServiceMatcher matcher;
+    for (const auto& brand : BRANDS) {
+        matcher.addBrand(brand);
+    }
+    for (const auto& alias : BRAND_ALIASES) {
+        matcher.addAlias(alias.first, alias.second);
+    }
+    for (const auto& category : CATEGORY_KEYWORDS) {
+        matcher.addCategory(category.first, category.second);
+    }
+    matcher.build();
+    return matcher;
+}
+
+std::string brandOf(const Match& match) {
+    return match.brand ? *match.brand : std::string();
+}
+
+std::string categoryOf(const Match& match) {
+    return match.category ? *match.category : std::string("Other");
+}
+
+void checkAgainstReference(const ServiceMatcher& matcher, const std::string& name) {
+    const Match match = matcher.classify(name);
+    const Expected expected = classifyReference(name);
+    if (brandOf(match) != expected.brand || categoryOf(match) != expected.category) {
+        native_tests::fail(__FILE__, __LINE__,
+                           "\"" + name + "\" -> " + brandOf(match) + "/" + categoryOf(match) + ", JS rules give " +
+                               expected.brand + "/" + expected.category);
+    }
+}
+
+void testKnownNames(const ServiceMatcher& matcher) {
+    struct Case {
+        const char* name;
+        const char* brand;
+        const char* category;
+    } cases[] = {
+        {"Google", "google", "Social"},
+        {"  GitHub Enterprise ", "github", "Work"},
+        {"Gmail", "google", "Other"},              // Alias only; "gmail" is no category keyword
+        {"Outlook Work", "microsoft", "Work"},
+        {"Xbox Live", "microsoft", "Gaming"},       // Gaming outranks Work by table order
+        {"Steam", "steam", "Gaming"},
+        {"Valve Corp", "steam", "Work"},
+        {"git", "github", "Other"},                 // The brand contains the name
+        {"PayPal Business", "paypal", "Finance"},
+        {"Instagram", "facebook", "Social"},
+        {"My Bank", "", "Finance"},
+        {"Google Mail", "google", "Social"},        // Brand before alias
+        {"AWS Console", "amazon", "Other"},
+        {"Discord Nitro Games", "discord", "Social"},
+        {"Unknown Service", "", "Other"},
+    };
+    for (const Case& c : cases) {
+        const Match match = matcher.classify(c.name);
+        CHECK_EQ(brandOf(match), std::string(c.brand));
+        CHECK_EQ(categoryOf(match), std::string(c.category));
+        checkAgainstReference(matcher, c.name);
+    }
+
+    // An empty name matches nothing, rather than the first brand
+    CHECK(matcher.classify("").brand == nullptr);
+    CHECK(matcher.classify("   ").category == nullptr);
+}
+
+void testGeneratedNames(const ServiceMatcher& matcher) {
+    std::vector<std::string> fragments = {" ", "-", "my ", "the", "x", "acc", "o", "ub", "al", "e", "2fa"};
+    for (const auto& brand : BRANDS) {
+        fragments.push_back(brand);
+        fragments.push_back(brand.substr(0, brand.size() / 2));
+    }
+    for (const auto& alias : BRAND_ALIASES) {
+        fragments.push_back(alias.first);
+    }
+    for (const auto& category : CATEGORY_KEYWORDS) {
+        fragments.insert(fragments.end(), category.second.begin(), category.second.end());
+    }
+
+    std::mt19937 random(2024);
+    std::uniform_int_distribution<size_t> pick(0, fragments.size() - 1);
+    std::uniform_int_distribution<int> parts(1, 4);
+    std::uniform_int_distribution<int> upper(0, 5);
+    for (int i = 0; i < 20000; ++i) {
+        std::string name;
+        for (int part = parts(random); part > 0; --part) {
+            name += fragments[pick(random)];
+        }
+        for (char& c : name) {
+            if (c >= 'a' && c <= 'z' && upper(random) == 0) {
+                c = static_cast<char>(c - 'a' + 'A');
+            }
+        }
+        checkAgainstReference(matcher, name);
+    }
+}
+
+void testBuiltOnce() {
+    ServiceMatcher matcher = buildMatcher();
+    bool threw = false;
+    try {
+        matcher.addBrand("late");
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // Unbuilt matchers classify nothing
+    ServiceMatcher empty;
+    empty.addBrand("google");
+    CHECK(empty.classify("google").brand == nullptr);
+}
+
+} // namespace
+
+int main() {
+    const ServiceMatcher matcher = buildMatcher();
+    testKnownNames(matcher);
+    testGeneratedNames(matcher);
+    testBuiltOnce();
+    return native_tests::finish("ServiceMatcher");
+}
@@ -0,0 +1,190 @@
+#include "CryptoEngine.h"
+#include "SyncPacker.h"
+#include "TestSupport.h"
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// Packs a serialized vault into a temp directory standing in for the remote,
+// edits it and packs again, checking which chunk files were touched.
+
+using crypto_native::CryptoEngine;
+using crypto_native::CryptoOperationException;
+using crypto_native::SecureBytes;
+using crypto_native::SyncPack;
+using crypto_native::SyncPacker;
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+// JSON-like records with random secrets, close to what AccountService stores
+std::string vaultText(size_t accounts) {
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> letter(0, 31);
+    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+    std::string text = "[";
+    for (size_t i = 0; i < accounts; ++i) {
+        std::string secret;
+        for (int k = 0; k < 32; ++k) {
+            secret += alphabet[letter(random)];
+        }
+        text += "{\"id\":\"account_" + std::to_string(i) + "\",\"name\":\"Service " + std::to_string(i) +
+                "\",\"secret\":\"" + secret + "\",\"digits\":6,\"period\":30},";
+    }
+    text += "]";
+    return text;
+}
+
+// Chunk file name -> inode; a rewritten chunk gets a new inode from its rename
+std::map<std::string, ino_t> chunkFiles(const std::string& directory) {
+    std::map<std::string, ino_t> files;
+    const std::string chunks = directory + "/chunks";
+    DIR* dir = opendir(chunks.c_str());
+    CHECK(dir != nullptr);
+    while (dirent* entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name == "." || name == "..") {
+            continue;
+        }
+        struct stat st{};
+        CHECK(stat((chunks + "/" + name).c_str(), &st) == 0);
+        files[name] = st.st_ino;
+    }
+    closedir(dir);
+    return files;
+}
+
+struct TempDirectory {
+    std::string path;
+
+    TempDirectory() {
+        char pattern[] = "/tmp/synctestXXXXXX";
+        path = mkdtemp(pattern);
+    }
+
+    ~TempDirectory() {
+        for (const auto& file : chunkFiles(path)) {
+            std::remove((path + "/chunks/" + file.first).c_str());
+        }
+        rmdir((path + "/chunks").c_str());
+        std::remove((path + "/manifest").c_str());
+        rmdir(path.c_str());
+    }
+};
+
+void testIncrementalDirectory(CryptoEngine& engine, const SecureBytes& key) {
+    TempDirectory temp;
+    SyncPacker packer(engine, key);
+
+    const std::string original = vaultText(2000);
+    const SyncPack first = packer.packToDirectory(Bytes(original.begin(), original.end()), temp.path);
+    CHECK(first.chunks.size() > 20);
+    CHECK(first.staleChunks.empty());
+    CHECK_EQ(first.totalBytes, uint64_t(original.size()));
+
+    const std::map<std::string, ino_t> before = chunkFiles(temp.path);
+    CHECK_EQ(before.size(), std::set<std::string>(first.chunkIds.begin(), first.chunkIds.end()).size());
+
+    // Rename one account in the middle
+    std::string edited = original;
+    const std::string target = "\"name\":\"Service 1000\"";
+    const size_t at = edited.find(target);
+    CHECK(at != std::string::npos);
+    edited.replace(at, target.size(), "\"name\":\"Renamed service\"");
+
+    const SyncPack second = packer.packToDirectory(Bytes(edited.begin(), edited.end()), temp.path);
+    // Content-defined boundaries: only the chunks around the edit change
+    CHECK(!second.chunks.empty());
+    CHECK(second.chunks.size() <= 3);
+    CHECK(second.uploadBytes < first.uploadBytes / 5);
+    CHECK_EQ(second.staleChunks.size(), second.chunks.size());
+
+    const std::map<std::string, ino_t> after = chunkFiles(temp.path);
+    std::set<std::string> uploaded;
+    for (const auto& chunk : second.chunks) {
+        uploaded.insert(chunk.id);
+        CHECK(before.count(chunk.id) == 0);
+        CHECK(after.count(chunk.id) == 1);
+    }
+    // Stale chunks are swept once the new manifest is in place
+    for (const auto& id : second.staleChunks) {
+        CHECK(before.count(id) == 1);
+        CHECK(after.count(id) == 0);
+    }
+    // Every other chunk file is the one written by the first pack
+    size_t untouched = 0;
+    for (const auto& file : after) {
+        if (uploaded.count(file.first) == 0) {
+            CHECK(before.count(file.first) == 1);
+            CHECK_EQ(file.second, before.at(file.first));
+            ++untouched;
+        }
+    }
+    CHECK_EQ(untouched + uploaded.size(), after.size());
+    CHECK_EQ(after.size(), std::set<std::string>(second.chunkIds.begin(), second.chunkIds.end()).size());
+
+    const Bytes restored = packer.unpackFromDirectory(temp.path);
+    CHECK(std::string(restored.begin(), restored.end()) == edited);
+
+    // Packing the same content again uploads nothing but the manifest
+    const SyncPack unchanged = packer.packToDirectory(Bytes(edited.begin(), edited.end()), temp.path);
+    CHECK(unchanged.chunks.empty());
+    CHECK(unchanged.staleChunks.empty());
+    CHECK_EQ(unchanged.uploadBytes, uint64_t(unchanged.manifest.size()));
+}
+
+void testDeterministicChunks(CryptoEngine& engine, const SecureBytes& key) {
+    const std::string text = vaultText(500);
+    const Bytes data(text.begin(), text.end());
+
+    // Same key, same content: same remote objects
+    SyncPacker a(engine, key);
+    SyncPacker b(engine, key);
+    const SyncPack packA = a.pack(data);
+    const SyncPack packB = b.pack(data);
+    CHECK(packA.chunkIds == packB.chunkIds);
+    CHECK(packA.chunks[0].data == packB.chunks[0].data);
+    // Manifests carry a random IV
+    CHECK(packA.manifest != packB.manifest);
+    CHECK(a.manifestChunks(packB.manifest) == packA.chunkIds);
+
+    // Chunks stay within the configured bounds
+    size_t start = 0;
+    const std::vector<size_t> boundaries = SyncPacker::chunkBoundaries(data.data(), data.size());
+    CHECK_EQ(boundaries.back(), data.size());
+    for (size_t i = 0; i + 1 < boundaries.size(); ++i) {
+        const size_t length = boundaries[i] - start;
+        CHECK(length >= SyncPacker::kMinChunk && length <= SyncPacker::kMaxChunk);
+        start = boundaries[i];
+    }
+
+    // Another key reads neither the manifest nor the chunk names
+    SecureBytes otherKey = engine.generateKey(32);
+    SyncPacker other(engine, otherKey);
+    CHECK(other.pack(data).chunkIds != packA.chunkIds);
+    bool threw = false;
+    try {
+        other.manifestChunks(packA.manifest);
+    } catch (const CryptoOperationException&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+} // namespace
+
+int main() {
+    CryptoEngine engine;
+    const SecureBytes key = engine.generateKey(32);
+    testIncrementalDirectory(engine, key);
+    testDeterministicChunks(engine, key);
+    return native_tests::finish("SyncPacker");
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+// Minimal assertions for the host test binaries, so they build with nothing
+// but a compiler. Failures are counted and reported; finish() is the exit code.
+namespace native_tests {
+
+inline int& failureCount() {
+    static int count = 0;
+    return count;
+}
+
+inline void fail(const char* file, int line, const std::string& message) {
+    std::fprintf(stderr, "%s:%d: FAILED %s\n", file, line, message.c_str());
+    ++failureCount();
+}
+
+template <typename A, typename B>
+std::string describe(const char* expression, const A& actual, const B& expected) {
+    std::ostringstream out;
+    out << expression << " (got " << actual << ", expected " << expected << ")";
+    return out.str();
+}
+
+inline int finish(const char* suite) {
+    if (failureCount() == 0) {
+        std::printf("%s: all checks passed\n", suite);
+        return 0;
+    }
+    std::printf("%s: %d check(s) failed\n", suite, failureCount());
+    return 1;
+}
+
+} // namespace native_tests
+
+#define CHECK(condition)                                                         \
+    do {                                                                         \
+        if (!(condition)) native_tests::fail(__FILE__, __LINE__, #condition);    \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                               \
+    do {                                                                         \
+        const auto& checkActual_ = (actual);                                     \
+        const auto& checkExpected_ = (expected);                                 \
+        if (!(checkActual_ == checkExpected_))                                   \
+            native_tests::fail(__FILE__, __LINE__,                               \
+                native_tests::describe(#actual " == " #expected, checkActual_, checkExpected_)); \
+    } while (0)
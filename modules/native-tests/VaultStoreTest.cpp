@@ -0,0 +1,297 @@
+#include "CryptoEngine.h"
+#include "TestSupport.h"
+#include "VaultStore.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Vault files are written to a temp directory and patched in place to
+// simulate tampering and a put() torn between its two index writes.
+
+using crypto_native::AuthenticationFailedException;
+using crypto_native::CryptoEngine;
+using crypto_native::InvalidParameterException;
+using crypto_native::SecureBytes;
+using crypto_native::VaultStore;
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+// On-disk offsets from VaultStore.h
+constexpr off_t HEADER_INDEX_OFFSET = 24;
+constexpr off_t HEADER_DATA_END = 32;
+constexpr off_t ENTRY_SIZE = 16;
+constexpr off_t ENTRY_STATE = 12;
+constexpr off_t RECORD_SEQUENCE = 12;
+constexpr off_t RECORD_BODY = 48;
+constexpr uint32_t STATE_LIVE = 1;
+constexpr uint32_t STATE_FREE = 2;
+
+Bytes bytesOf(const std::string& text) {
+    return Bytes(text.begin(), text.end());
+}
+
+std::string textOf(const Bytes& bytes) {
+    return std::string(bytes.begin(), bytes.end());
+}
+
+template <typename T>
+T readAt(const std::string& path, off_t offset) {
+    T value{};
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    CHECK(pread(fd, &value, sizeof(value), offset) == static_cast<ssize_t>(sizeof(value)));
+    ::close(fd);
+    return value;
+}
+
+template <typename T>
+void writeAt(const std::string& path, off_t offset, const T& value) {
+    const int fd = ::open(path.c_str(), O_RDWR);
+    CHECK(pwrite(fd, &value, sizeof(value), offset) == static_cast<ssize_t>(sizeof(value)));
+    ::close(fd);
+}
+
+off_t entryOffset(const std::string& path, uint32_t slot) {
+    return static_cast<off_t>(readAt<uint64_t>(path, HEADER_INDEX_OFFSET)) + slot * ENTRY_SIZE;
+}
+
+off_t recordOffset(const std::string& path, uint32_t slot) {
+    return static_cast<off_t>(readAt<uint64_t>(path, entryOffset(path, slot)));
+}
+
+uint32_t slotState(const std::string& path, uint32_t slot) {
+    return readAt<uint32_t>(path, entryOffset(path, slot) + ENTRY_STATE);
+}
+
+struct TempVault {
+    std::string directory;
+    std::string path;
+
+    TempVault() {
+        char pattern[] = "/tmp/vaulttestXXXXXX";
+        directory = mkdtemp(pattern);
+        path = directory + "/accounts.vault";
+    }
+
+    ~TempVault() {
+        std::remove(path.c_str());
+        rmdir(directory.c_str());
+    }
+};
+
+void testRoundTrip(CryptoEngine& engine, const SecureBytes& key) {
+    TempVault temp;
+    VaultStore vault(engine, key);
+    vault.open(temp.path);
+    CHECK(vault.isOpen());
+    CHECK_EQ(vault.size(), size_t(0));
+
+    vault.put("alice", bytesOf("first"));
+    vault.put("bob", bytesOf(std::string(300, 'b')));
+    vault.put("alice", bytesOf("second, longer than the first version"));
+    CHECK_EQ(vault.size(), size_t(2));
+    CHECK(vault.contains("alice"));
+    CHECK_EQ(textOf(vault.get("alice")), std::string("second, longer than the first version"));
+    CHECK_EQ(vault.get("bob").size(), size_t(300));
+
+    CHECK(vault.remove("bob"));
+    CHECK(!vault.remove("bob"));
+    CHECK(!vault.contains("bob"));
+    CHECK_EQ(vault.size(), size_t(1));
+
+    bool threw = false;
+    try {
+        vault.get("bob");
+    } catch (const InvalidParameterException&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // Freed slots are reused rather than growing the file
+    const uint64_t dataEnd = readAt<uint64_t>(temp.path, HEADER_DATA_END);
+    vault.put("carol", bytesOf("c"));
+    CHECK_EQ(readAt<uint64_t>(temp.path, HEADER_DATA_END), dataEnd);
+}
+
+void testReopen(CryptoEngine& engine, const SecureBytes& key) {
+    TempVault temp;
+    {
+        VaultStore vault(engine, key);
+        vault.open(temp.path);
+        // Enough records to outgrow the initial 64-entry index
+        for (int i = 0; i < 200; ++i) {
+            vault.put("id" + std::to_string(i), bytesOf("payload " + std::to_string(i)));
+        }
+        vault.remove("id7");
+        vault.put("id8", bytesOf("rewritten"));
+        vault.setJournalSequence(42);
+        vault.sync();
+    }
+
+    VaultStore vault(engine, key);
+    vault.open(temp.path);
+    CHECK_EQ(vault.size(), size_t(199));
+    CHECK_EQ(vault.ids().size(), size_t(199));
+    CHECK(!vault.contains("id7"));
+    CHECK_EQ(textOf(vault.get("id8")), std::string("rewritten"));
+    CHECK_EQ(textOf(vault.get("id199")), std::string("payload 199"));
+    CHECK_EQ(vault.journalSequence(), uint64_t(42));
+
+    // A different key cannot open any record
+    vault.close();
+    SecureBytes otherKey = engine.generateKey(32);
+    VaultStore wrong(engine, otherKey);
+    wrong.open(temp.path);
+    CHECK_EQ(wrong.size(), size_t(199));
+    bool threw = false;
+    try {
+        wrong.get("id0");
+    } catch (const AuthenticationFailedException&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void testTamperedRecord(CryptoEngine& engine, const SecureBytes& key) {
+    TempVault temp;
+    {
+        VaultStore vault(engine, key);
+        vault.open(temp.path);
+        vault.put("alice", bytesOf("secret"));
+        vault.put("bob", bytesOf("other"));
+    }
+
+    // Flip one ciphertext byte of alice (slot 0, after the 5-byte id)
+    const off_t body = recordOffset(temp.path, 0) + RECORD_BODY + 5;
+    writeAt<uint8_t>(temp.path, body, readAt<uint8_t>(temp.path, body) ^ 1);
+
+    VaultStore vault(engine, key);
+    vault.open(temp.path);
+    bool threw = false;
+    try {
+        vault.get("alice");
+    } catch (const AuthenticationFailedException&) {
+        threw = true;
+    }
+    CHECK(threw);
+    // Other records are unaffected
+    CHECK_EQ(textOf(vault.get("bob")), std::string("other"));
+}
+
+void testSwappedId(CryptoEngine& engine, const SecureBytes& key) {
+    TempVault temp;
+    {
+        VaultStore vault(engine, key);
+        vault.open(temp.path);
+        vault.put("aaaa", bytesOf("for a"));
+        vault.put("bbbb", bytesOf("for b"));
+    }
+
+    // Rename record 0's plaintext id: the id is AAD, so it no longer opens
+    writeAt<char>(temp.path, recordOffset(temp.path, 0) + RECORD_BODY, 'c');
+    VaultStore vault(engine, key);
+    vault.open(temp.path);
+    CHECK(vault.contains("caaa"));
+    bool threw = false;
+    try {
+        vault.get("caaa");
+    } catch (const AuthenticationFailedException&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+// Writes "v1" then "v2" for one id, then marks slot 0 LIVE again, as if the
+// second put() stopped after flipping its new slot live
+void tornPut(CryptoEngine& engine, const SecureBytes& key, const std::string& path) {
+    VaultStore vault(engine, key);
+    vault.open(path);
+    vault.put("alice", bytesOf("v1"));
+    vault.put("alice", bytesOf("v2"));
+    vault.close();
+
+    CHECK_EQ(slotState(path, 0), STATE_FREE);
+    CHECK_EQ(slotState(path, 1), STATE_LIVE);
+    writeAt<uint32_t>(path, entryOffset(path, 0) + ENTRY_STATE, STATE_LIVE);
+}
+
+void testDuplicateLiveSlots(CryptoEngine& engine, const SecureBytes& key) {
+    {
+        TempVault temp;
+        tornPut(engine, key, temp.path);
+        VaultStore vault(engine, key);
+        vault.open(temp.path);
+        CHECK_EQ(vault.ids().size(), size_t(1));
+        CHECK_EQ(textOf(vault.get("alice")), std::string("v2"));
+        // The stale slot is freed on disk and reused by the next put
+        CHECK_EQ(slotState(temp.path, 0), STATE_FREE);
+        vault.put("bob", bytesOf("b"));
+        CHECK_EQ(slotState(temp.path, 0), STATE_LIVE);
+        CHECK_EQ(textOf(vault.get("alice")), std::string("v2"));
+    }
+    {
+        // Resolution follows the sequence, not the slot order
+        TempVault temp;
+        tornPut(engine, key, temp.path);
+        writeAt<uint32_t>(temp.path, recordOffset(temp.path, 0) + RECORD_SEQUENCE, 5);
+        VaultStore vault(engine, key);
+        vault.open(temp.path);
+        CHECK_EQ(textOf(vault.get("alice")), std::string("v1"));
+        CHECK_EQ(slotState(temp.path, 1), STATE_FREE);
+    }
+    {
+        // Sequences compare as serial numbers, so 0 follows 0xFFFFFFFF
+        TempVault temp;
+        tornPut(engine, key, temp.path);
+        writeAt<uint32_t>(temp.path, recordOffset(temp.path, 0) + RECORD_SEQUENCE, 0xFFFFFFFFu);
+        writeAt<uint32_t>(temp.path, recordOffset(temp.path, 1) + RECORD_SEQUENCE, 0);
+        VaultStore vault(engine, key);
+        vault.open(temp.path);
+        CHECK_EQ(textOf(vault.get("alice")), std::string("v2"));
+    }
+}
+
+void testRejectsForeignFiles(CryptoEngine& engine, const SecureBytes& key) {
+    TempVault temp;
+    {
+        FILE* file = std::fopen(temp.path.c_str(), "wb");
+        std::fputs("definitely not a vault file, but longer than one header ........", file);
+        std::fclose(file);
+    }
+    VaultStore vault(engine, key);
+    bool threw = false;
+    try {
+        vault.open(temp.path);
+    } catch (const crypto_native::CryptoOperationException&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(!vault.isOpen());
+
+    threw = false;
+    try {
+        VaultStore cbc(engine, key, crypto_native::CipherAlgorithm::AES_256_CBC);
+    } catch (const InvalidParameterException&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+} // namespace
+
+int main() {
+    CryptoEngine engine;
+    const SecureBytes key = engine.generateKey(32);
+    testRoundTrip(engine, key);
+    testReopen(engine, key);
+    testTamperedRecord(engine, key);
+    testSwappedId(engine, key);
+    testDuplicateLiveSlots(engine, key);
+    testRejectsForeignFiles(engine, key);
+    return native_tests::finish("VaultStore");
+}
@@ -0,0 +1,923 @@
+#include "OtpImport.h"
+#include "CryptoEngine.h"
+#include <cstring>
+
+namespace OtpImport {
+
+using crypto_native::AuthenticationFailedException;
+using crypto_native::CipherAlgorithm;
+using crypto_native::CryptoEngine;
+using crypto_native::CryptoOperationException;
+using crypto_native::HashAlgorithm;
+using crypto_native::InvalidKeyException;
+using crypto_native::PaddingMode;
+using crypto_native::SecureBytes;
+
+namespace {
+    constexpr size_t MAX_FIELD_LENGTH = UINT16_MAX;
+    constexpr uint16_t DEFAULT_PERIOD = 30;
+    constexpr uint8_t DEFAULT_DIGITS = 6;
+    constexpr uint8_t STEAM_DIGITS = 5;
+
+    constexpr size_t KEY_LENGTH = 32;
+    constexpr size_t GCM_NONCE_LENGTH = 12;
+    constexpr size_t GCM_TAG_LENGTH = 16;
+
+    // Aegis password slots; 0 is a raw key file and 2 a biometric key
+    constexpr uint64_t AEGIS_PASSWORD_SLOT = 1;
+
+    // andOTP: iterations u32 BE | salt | nonce | ciphertext | tag
+    constexpr size_t ANDOTP_SALT_LENGTH = 12;
+    constexpr size_t ANDOTP_HEADER_LENGTH = 4 + ANDOTP_SALT_LENGTH + GCM_NONCE_LENGTH;
+    constexpr uint64_t ANDOTP_MAX_ITERATIONS = 10000000;
+
+    // 2FAS: "ciphertext+tag:salt:nonce", each part base64
+    constexpr uint32_t TWOFAS_ITERATIONS = 10000;
+
+    constexpr uint32_t NO_NODE = UINT32_MAX;
+    constexpr int MAX_DEPTH = 64;
+
+    struct Range {
+        const char* begin;
+        const char* end;
+
+        bool empty() const { return begin == end; }
+    };
+
+    inline int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    inline char lower(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    // Yields the UTF-8 bytes of a JSON string body with escapes resolved.
+    // The parser has already checked every escape, so this one does not.
+    class JsonStringReader {
+    public:
+        explicit JsonStringReader(Range range) : cursor_(range.begin), end_(range.end) {}
+
+        bool next(char& out) {
+            if (pendingIndex_ < pendingLength_) {
+                out = pending_[pendingIndex_++];
+                return true;
+            }
+            if (cursor_ == end_) {
+                return false;
+            }
+            const char c = *cursor_++;
+            if (c != '\\') {
+                out = c;
+                return true;
+            }
+            const char escape = *cursor_++;
+            switch (escape) {
+                case 'b': out = '\b'; return true;
+                case 'f': out = '\f'; return true;
+                case 'n': out = '\n'; return true;
+                case 'r': out = '\r'; return true;
+                case 't': out = '\t'; return true;
+                case 'u': break;
+                default: out = escape; return true; // '"', '\\' and '/'
+            }
+
+            uint32_t code = readHex4();
+            if (code >= 0xD800 && code < 0xDC00 && end_ - cursor_ >= 6 && cursor_[0] == '\\' && cursor_[1] == 'u') {
+                const char* low = cursor_;
+                cursor_ += 2;
+                const uint32_t trail = readHex4();
+                if (trail >= 0xDC00 && trail < 0xE000) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (trail - 0xDC00);
+                } else {
+                    cursor_ = low;
+                }
+            }
+            if (code >= 0xD800 && code < 0xE000) {
+                code = 0xFFFD; // Unpaired surrogate
+            }
+            encodeUtf8(code);
+            out = pending_[pendingIndex_++];
+            return true;
+        }
+
+    private:
+        uint32_t readHex4() {
+            uint32_t value = 0;
+            for (int i = 0; i < 4; ++i) {
+                value = (value << 4) | static_cast<uint32_t>(hexValue(*cursor_++));
+            }
+            return value;
+        }
+
+        void encodeUtf8(uint32_t code) {
+            pendingIndex_ = 0;
+            if (code < 0x80) {
+                pending_[0] = static_cast<char>(code);
+                pendingLength_ = 1;
+            } else if (code < 0x800) {
+                pending_[0] = static_cast<char>(0xC0 | (code >> 6));
+                pending_[1] = static_cast<char>(0x80 | (code & 0x3F));
+                pendingLength_ = 2;
+            } else if (code < 0x10000) {
+                pending_[0] = static_cast<char>(0xE0 | (code >> 12));
+                pending_[1] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                pending_[2] = static_cast<char>(0x80 | (code & 0x3F));
+                pendingLength_ = 3;
+            } else {
+                pending_[0] = static_cast<char>(0xF0 | (code >> 18));
+                pending_[1] = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                pending_[2] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                pending_[3] = static_cast<char>(0x80 | (code & 0x3F));
+                pendingLength_ = 4;
+            }
+        }
+
+        const char* cursor_;
+        const char* end_;
+        char pending_[4] = {};
+        uint8_t pendingIndex_ = 0;
+        uint8_t pendingLength_ = 0;
+    };
+
+    enum class JsonKind : uint8_t {
+        NUL,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+    // Nodes point into the source text; strings are only unescaped when read
+    struct JsonNode {
+        JsonKind kind = JsonKind::NUL;
+        bool boolean = false;
+        bool escaped = false;
+        bool keyEscaped = false;
+        Range text{nullptr, nullptr};  // String body without quotes, or number literal
+        Range key{nullptr, nullptr};   // Member name inside an object
+        uint32_t firstChild = NO_NODE;
+        uint32_t next = NO_NODE;
+    };
+
+    // Whole-document JSON parser over a buffer the caller keeps alive. All
+    // nodes share one vector, so a backup costs one allocation besides the text.
+    class JsonDocument {
+    public:
+        bool parse(Range text) {
+            nodes_.clear();
+            nodes_.emplace_back();
+            cursor_ = text.begin;
+            end_ = text.end;
+            if (!parseValue(0, 0)) {
+                return false;
+            }
+            skipSpace();
+            return cursor_ == end_;
+        }
+
+        const JsonNode& root() const { return nodes_.front(); }
+
+        const JsonNode* first(const JsonNode* container) const {
+            return container ? at(container->firstChild) : nullptr;
+        }
+
+        const JsonNode* next(const JsonNode* node) const { return at(node->next); }
+
+        const JsonNode* member(const JsonNode* object, const char* name) const {
+            if (!object || object->kind != JsonKind::OBJECT) {
+                return nullptr;
+            }
+            const size_t length = std::strlen(name);
+            for (const JsonNode* child = first(object); child; child = next(child)) {
+                if (child->keyEscaped) {
+                    JsonStringReader reader(child->key);
+                    size_t i = 0;
+                    char c;
+                    while (reader.next(c) && i < length && c == name[i]) {
+                        ++i;
+                    }
+                    if (i == length && !reader.next(c)) {
+                        return child;
+                    }
+                } else if (static_cast<size_t>(child->key.end - child->key.begin) == length &&
+                           std::memcmp(child->key.begin, name, length) == 0) {
+                    return child;
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        const JsonNode* at(uint32_t index) const { return index == NO_NODE ? nullptr : &nodes_[index]; }
+
+        void skipSpace() {
+            while (cursor_ < end_ && (*cursor_ == ' ' || *cursor_ == '\t' || *cursor_ == '\n' || *cursor_ == '\r')) {
+                ++cursor_;
+            }
+        }
+
+        bool literal(const char* word) {
+            const size_t length = std::strlen(word);
+            if (static_cast<size_t>(end_ - cursor_) < length || std::memcmp(cursor_, word, length) != 0) {
+                return false;
+            }
+            cursor_ += length;
+            return true;
+        }
+
+        bool parseString(Range& text, bool& escaped) {
+            ++cursor_; // Opening quote
+            const char* begin = cursor_;
+            escaped = false;
+            while (cursor_ < end_) {
+                const char c = *cursor_;
+                if (c == '"') {
+                    text = {begin, cursor_};
+                    ++cursor_;
+                    return true;
+                }
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    return false;
+                }
+                if (c == '\\') {
+                    if (end_ - cursor_ < 2) {
+                        return false;
+                    }
+                    const char escape = cursor_[1];
+                    if (escape == 'u') {
+                        if (end_ - cursor_ < 6) {
+                            return false;
+                        }
+                        for (int i = 2; i < 6; ++i) {
+                            if (hexValue(cursor_[i]) < 0) {
+                                return false;
+                            }
+                        }
+                        cursor_ += 6;
+                    } else if (std::strchr("\"\\/bfnrt", escape) && escape != '\0') {
+                        cursor_ += 2;
+                    } else {
+                        return false;
+                    }
+                    escaped = true;
+                    continue;
+                }
+                ++cursor_;
+            }
+            return false;
+        }
+
+        bool parseNumber(Range& text) {
+            const char* begin = cursor_;
+            bool digits = false;
+            while (cursor_ < end_) {
+                const char c = *cursor_;
+                if (c >= '0' && c <= '9') {
+                    digits = true;
+                } else if (c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E') {
+                    break;
+                }
+                ++cursor_;
+            }
+            text = {begin, cursor_};
+            return digits;
+        }
+
+        // Children are appended behind their parent, so nodes_ may grow while
+        // a parent is being filled; only indices are held across calls
+        bool parseContainer(uint32_t index, int depth, bool object) {
+            if (depth >= MAX_DEPTH) {
+                return false;
+            }
+            const char close = object ? '}' : ']';
+            nodes_[index].kind = object ? JsonKind::OBJECT : JsonKind::ARRAY;
+            ++cursor_;
+            skipSpace();
+            if (cursor_ < end_ && *cursor_ == close) {
+                ++cursor_;
+                return true;
+            }
+
+            uint32_t previous = NO_NODE;
+            for (;;) {
+                Range key{nullptr, nullptr};
+                bool keyEscaped = false;
+                if (object) {
+                    skipSpace();
+                    if (cursor_ >= end_ || *cursor_ != '"' || !parseString(key, keyEscaped)) {
+                        return false;
+                    }
+                    skipSpace();
+                    if (cursor_ >= end_ || *cursor_ != ':') {
+                        return false;
+                    }
+                    ++cursor_;
+                }
+
+                const uint32_t child = static_cast<uint32_t>(nodes_.size());
+                nodes_.emplace_back();
+                nodes_[child].key = key;
+                nodes_[child].keyEscaped = keyEscaped;
+                if (previous == NO_NODE) {
+                    nodes_[index].firstChild = child;
+                } else {
+                    nodes_[previous].next = child;
+                }
+                previous = child;
+
+                if (!parseValue(child, depth + 1)) {
+                    return false;
+                }
+                skipSpace();
+                if (cursor_ >= end_) {
+                    return false;
+                }
+                if (*cursor_ == ',') {
+                    ++cursor_;
+                    continue;
+                }
+                if (*cursor_ == close) {
+                    ++cursor_;
+                    return true;
+                }
+                return false;
+            }
+        }
+
+        bool parseValue(uint32_t index, int depth) {
+            skipSpace();
+            if (cursor_ >= end_) {
+                return false;
+            }
+            switch (*cursor_) {
+                case '{':
+                    return parseContainer(index, depth, true);
+                case '[':
+                    return parseContainer(index, depth, false);
+                case '"': {
+                    Range text{nullptr, nullptr};
+                    bool escaped = false;
+                    if (!parseString(text, escaped)) {
+                        return false;
+                    }
+                    nodes_[index].kind = JsonKind::STRING;
+                    nodes_[index].text = text;
+                    nodes_[index].escaped = escaped;
+                    return true;
+                }
+                case 't':
+                case 'f': {
+                    const bool value = *cursor_ == 't';
+                    if (!literal(value ? "true" : "false")) {
+                        return false;
+                    }
+                    nodes_[index].kind = JsonKind::BOOLEAN;
+                    nodes_[index].boolean = value;
+                    return true;
+                }
+                case 'n':
+                    nodes_[index].kind = JsonKind::NUL;
+                    return literal("null");
+                default: {
+                    Range text{nullptr, nullptr};
+                    if (!parseNumber(text)) {
+                        return false;
+                    }
+                    nodes_[index].kind = JsonKind::NUMBER;
+                    nodes_[index].text = text;
+                    return true;
+                }
+            }
+        }
+
+        std::vector<JsonNode> nodes_;
+        const char* cursor_ = nullptr;
+        const char* end_ = nullptr;
+    };
+
+    bool isString(const JsonNode* node) {
+        return node && node->kind == JsonKind::STRING;
+    }
+
+    bool isNonEmptyString(const JsonNode* node) {
+        return isString(node) && !node->text.empty();
+    }
+
+    // Non-negative integers only; a missing or null field keeps the default
+    bool readUnsigned(const JsonNode* node, uint64_t& value) {
+        if (!node || node->kind == JsonKind::NUL) {
+            return true;
+        }
+        if (node->kind != JsonKind::NUMBER || node->text.empty()) {
+            return false;
+        }
+        uint64_t result = 0;
+        for (const char* p = node->text.begin; p != node->text.end; ++p) {
+            if (*p < '0' || *p > '9' || result > (UINT64_MAX - 9) / 10) {
+                return false;
+            }
+            result = result * 10 + static_cast<uint64_t>(*p - '0');
+        }
+        value = result;
+        return true;
+    }
+
+    bool equalsIgnoreCase(const JsonNode* node, const char* literal) {
+        if (!isString(node)) {
+            return false;
+        }
+        JsonStringReader reader(node->text);
+        const char* expected = literal;
+        char c;
+        while (reader.next(c)) {
+            if (*expected == '\0' || lower(c) != *expected) {
+                return false;
+            }
+            ++expected;
+        }
+        return *expected == '\0';
+    }
+
+    // Missing or null strings append nothing and succeed
+    bool appendString(SecureBytes& pool, const JsonNode* node, uint32_t& offset, uint16_t& length) {
+        offset = static_cast<uint32_t>(pool.size());
+        length = 0;
+        if (!node || node->kind == JsonKind::NUL) {
+            return true;
+        }
+        if (node->kind != JsonKind::STRING) {
+            return false;
+        }
+        if (!node->escaped) {
+            pool.insert(pool.end(), node->text.begin, node->text.end);
+        } else {
+            JsonStringReader reader(node->text);
+            char c;
+            while (reader.next(c)) {
+                pool.push_back(static_cast<uint8_t>(c));
+            }
+        }
+        const size_t appended = pool.size() - offset;
+        if (appended > MAX_FIELD_LENGTH) {
+            return false;
+        }
+        length = static_cast<uint16_t>(appended);
+        return true;
+    }
+
+    bool appendSecret(SecureBytes& pool, const JsonNode* node, uint32_t& offset, uint16_t& length) {
+        if (!isString(node)) {
+            return false;
+        }
+        if (!node->escaped) {
+            return decodeBase32Secret(pool, node->text.begin, node->text.end, offset, length);
+        }
+        SecureBytes unescaped;
+        JsonStringReader reader(node->text);
+        char c;
+        while (reader.next(c)) {
+            unescaped.push_back(static_cast<uint8_t>(c));
+        }
+        const char* begin = reinterpret_cast<const char*>(unescaped.data());
+        return decodeBase32Secret(pool, begin, begin + unescaped.size(), offset, length);
+    }
+
+    // Standard base64, padding optional; '/' may arrive escaped as "\/"
+    template <typename Next>
+    bool decodeBase64(Next next, std::vector<uint8_t>& out) {
+        uint32_t buffer = 0;
+        int bits = 0;
+        char c;
+        while (next(c)) {
+            int value;
+            if (c >= 'A' && c <= 'Z') value = c - 'A';
+            else if (c >= 'a' && c <= 'z') value = c - 'a' + 26;
+            else if (c >= '0' && c <= '9') value = c - '0' + 52;
+            else if (c == '+' || c == '-') value = 62;
+            else if (c == '/' || c == '_') value = 63;
+            else if (c == '=' || c == '\n' || c == '\r') continue;
+            else return false;
+            buffer = (buffer << 6) | static_cast<uint32_t>(value);
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                out.push_back(static_cast<uint8_t>(buffer >> bits));
+            }
+        }
+        return true;
+    }
+
+    bool decodeBase64(const JsonNode* node, std::vector<uint8_t>& out) {
+        if (!isString(node)) {
+            return false;
+        }
+        JsonStringReader reader(node->text);
+        return decodeBase64([&](char& c) { return reader.next(c); }, out);
+    }
+
+    bool decodeBase64(Range range, std::vector<uint8_t>& out) {
+        return decodeBase64([&](char& c) {
+            if (range.begin == range.end) {
+                return false;
+            }
+            c = *range.begin++;
+            return true;
+        }, out);
+    }
+
+    bool decodeHex(const JsonNode* node, std::vector<uint8_t>& out) {
+        if (!isString(node)) {
+            return false;
+        }
+        JsonStringReader reader(node->text);
+        char high, low;
+        while (reader.next(high)) {
+            if (!reader.next(low) || hexValue(high) < 0 || hexValue(low) < 0) {
+                return false;
+            }
+            out.push_back(static_cast<uint8_t>((hexValue(high) << 4) | hexValue(low)));
+        }
+        return true;
+    }
+
+    // Where one app keeps each field of an entry. `type` may be null when the
+    // format has a single kind of entry; `issuerFallback` and `nameFallback`
+    // are used when the primary field is missing or empty.
+    struct EntryFields {
+        const JsonNode* type = nullptr;
+        const JsonNode* secret = nullptr;
+        const JsonNode* issuer = nullptr;
+        const JsonNode* issuerFallback = nullptr;
+        const JsonNode* name = nullptr;
+        const JsonNode* nameFallback = nullptr;
+        const JsonNode* algorithm = nullptr;
+        const JsonNode* digits = nullptr;
+        const JsonNode* period = nullptr;
+        const JsonNode* counter = nullptr;
+    };
+
+    bool appendEntry(const EntryFields& fields, ImportBatch& batch) {
+        SecureBytes& pool = batch.pool;
+        const size_t rollback = pool.size();
+        auto reject = [&]() {
+            pool.resize(rollback);
+            ++batch.rejected;
+            return false;
+        };
+
+        PackedAccount account{};
+        if (!fields.type || fields.type->kind == JsonKind::NUL || equalsIgnoreCase(fields.type, "totp")) {
+            account.type = OtpType::TOTP;
+        } else if (equalsIgnoreCase(fields.type, "hotp")) {
+            account.type = OtpType::HOTP;
+        } else if (equalsIgnoreCase(fields.type, "steam")) {
+            account.type = OtpType::STEAM;
+        } else {
+            return reject(); // mOTP, Yandex and other app-specific types
+        }
+
+        if (!fields.algorithm || fields.algorithm->kind == JsonKind::NUL || equalsIgnoreCase(fields.algorithm, "sha1")) {
+            account.algorithm = OtpAlgorithm::SHA1;
+        } else if (equalsIgnoreCase(fields.algorithm, "sha256")) {
+            account.algorithm = OtpAlgorithm::SHA256;
+        } else if (equalsIgnoreCase(fields.algorithm, "sha512")) {
+            account.algorithm = OtpAlgorithm::SHA512;
+        } else {
+            return reject();
+        }
+
+        uint64_t digits = DEFAULT_DIGITS;
+        uint64_t period = DEFAULT_PERIOD;
+        uint64_t counter = 0;
+        if (!readUnsigned(fields.digits, digits) || !readUnsigned(fields.period, period) ||
+            !readUnsigned(fields.counter, counter)) {
+            return reject();
+        }
+        if (account.type == OtpType::STEAM) {
+            digits = STEAM_DIGITS;
+            period = DEFAULT_PERIOD;
+        } else if (digits < 6 || digits > 10 || period == 0 || period > UINT16_MAX) {
+            return reject();
+        }
+        account.digits = static_cast<uint8_t>(digits);
+        account.period = static_cast<uint16_t>(period);
+        account.counter = counter;
+
+        const JsonNode* issuer = isNonEmptyString(fields.issuer) ? fields.issuer : fields.issuerFallback;
+        const JsonNode* name = isNonEmptyString(fields.name) ? fields.name : fields.nameFallback;
+        if (!appendSecret(pool, fields.secret, account.secretOffset, account.secretLength) ||
+            !appendString(pool, issuer, account.issuerOffset, account.issuerLength) ||
+            !appendString(pool, name, account.nameOffset, account.nameLength)) {
+            return reject();
+        }
+
+        // Labels without a separate issuer are usually "Issuer:account"
+        if (account.issuerLength == 0) {
+            const uint8_t* label = pool.data() + account.nameOffset;
+            const void* colon = std::memchr(label, ':', account.nameLength);
+            if (colon) {
+                const uint16_t prefix = static_cast<uint16_t>(static_cast<const uint8_t*>(colon) - label);
+                uint16_t skip = prefix + 1;
+                while (skip < account.nameLength && label[skip] == ' ') {
+                    ++skip;
+                }
+                account.issuerOffset = account.nameOffset;
+                account.issuerLength = prefix;
+                account.nameOffset += skip;
+                account.nameLength -= skip;
+            }
+        }
+
+        batch.accounts.push_back(account);
+        return true;
+    }
+
+    Range textOf(const uint8_t* data, size_t length) {
+        const char* begin = reinterpret_cast<const char*>(data);
+        return {begin, begin + length};
+    }
+
+    // Decrypted payloads arrive as plain vectors; keep them only as long as
+    // the parse needs them
+    struct Plaintext {
+        std::vector<uint8_t> bytes;
+
+        ~Plaintext() { CryptoEngine::secureZero(bytes); }
+
+        Range text() const { return textOf(bytes.data(), bytes.size()); }
+    };
+
+    void parseDocument(JsonDocument& document, Range text, const char* what) {
+        if (!document.parse(text)) {
+            throw CryptoOperationException(std::string("Malformed ") + what);
+        }
+    }
+
+    void reserveFor(ImportBatch& batch, size_t textLength) {
+        // Decoded fields never exceed the JSON text they came from
+        batch.pool.reserve(batch.pool.size() + textLength);
+    }
+
+    void parseAegisEntries(const JsonDocument& document, const JsonNode* database, ImportBatch& batch) {
+        const JsonNode* entries = document.member(database, "entries");
+        if (!entries || entries->kind != JsonKind::ARRAY) {
+            throw CryptoOperationException("Aegis vault has no entries");
+        }
+        for (const JsonNode* entry = document.first(entries); entry; entry = document.next(entry)) {
+            const JsonNode* info = document.member(entry, "info");
+            EntryFields fields;
+            fields.type = document.member(entry, "type");
+            fields.secret = document.member(info, "secret");
+            fields.issuer = document.member(entry, "issuer");
+            fields.name = document.member(entry, "name");
+            fields.algorithm = document.member(info, "algo");
+            fields.digits = document.member(info, "digits");
+            fields.period = document.member(info, "period");
+            fields.counter = document.member(info, "counter");
+            appendEntry(fields, batch);
+        }
+    }
+
+    void parseAegis(CryptoEngine& engine, Range text, const std::string& password, ImportBatch& batch) {
+        JsonDocument document;
+        parseDocument(document, text, "Aegis backup");
+        const JsonNode* root = &document.root();
+        const JsonNode* database = document.member(root, "db");
+        if (database && database->kind == JsonKind::OBJECT) {
+            reserveFor(batch, static_cast<size_t>(text.end - text.begin));
+            parseAegisEntries(document, database, batch);
+            return;
+        }
+        if (!isString(database)) {
+            throw CryptoOperationException("Not an Aegis backup");
+        }
+
+        // Every password slot wraps the same vault key; the first one the
+        // password opens wins. Each attempt costs one scrypt run.
+        const JsonNode* header = document.member(root, "header");
+        const JsonNode* slots = document.member(header, "slots");
+        SecureBytes masterKey;
+        bool hasPasswordSlot = false;
+        for (const JsonNode* slot = document.first(slots); slot && masterKey.empty(); slot = document.next(slot)) {
+            uint64_t type = 0;
+            if (!readUnsigned(document.member(slot, "type"), type) || type != AEGIS_PASSWORD_SLOT) {
+                continue;
+            }
+            hasPasswordSlot = true;
+
+            uint64_t n = 0, r = 0, p = 0;
+            std::vector<uint8_t> salt, wrappedKey, nonce, tag;
+            const JsonNode* keyParams = document.member(slot, "key_params");
+            if (!readUnsigned(document.member(slot, "n"), n) || !readUnsigned(document.member(slot, "r"), r) ||
+                !readUnsigned(document.member(slot, "p"), p) || n > UINT32_MAX || r > UINT32_MAX || p > UINT32_MAX ||
+                !decodeHex(document.member(slot, "salt"), salt) ||
+                !decodeHex(document.member(slot, "key"), wrappedKey) ||
+                !decodeHex(document.member(keyParams, "nonce"), nonce) ||
+                !decodeHex(document.member(keyParams, "tag"), tag) ||
+                wrappedKey.size() != KEY_LENGTH || nonce.size() != GCM_NONCE_LENGTH || tag.size() != GCM_TAG_LENGTH) {
+                throw CryptoOperationException("Malformed Aegis password slot");
+            }
+
+            SecureBytes slotKey = engine.deriveScrypt(password, salt, static_cast<uint32_t>(n),
+                                                      static_cast<uint32_t>(r), static_cast<uint32_t>(p), KEY_LENGTH);
+            try {
+                Plaintext unwrapped{engine.decrypt(wrappedKey, slotKey, CipherAlgorithm::AES_256_GCM, nonce,
+                                                   PaddingMode::NONE, {}, tag)};
+                masterKey.assign(unwrapped.bytes.begin(), unwrapped.bytes.end());
+            } catch (const AuthenticationFailedException&) {
+                // Not this slot's password; anything else is a real failure
+            }
+        }
+        if (!hasPasswordSlot) {
+            throw CryptoOperationException("Aegis backup has no password slot");
+        }
+        if (masterKey.empty()) {
+            throw InvalidKeyException("Wrong backup password");
+        }
+
+        const JsonNode* params = document.member(header, "params");
+        std::vector<uint8_t> ciphertext, nonce, tag;
+        if (!decodeBase64(database, ciphertext) ||
+            !decodeHex(document.member(params, "nonce"), nonce) ||
+            !decodeHex(document.member(params, "tag"), tag) ||
+            nonce.size() != GCM_NONCE_LENGTH || tag.size() != GCM_TAG_LENGTH) {
+            throw CryptoOperationException("Malformed Aegis vault parameters");
+        }
+
+        Plaintext vault;
+        try {
+            vault.bytes = engine.decrypt(ciphertext, masterKey, CipherAlgorithm::AES_256_GCM, nonce,
+                                         PaddingMode::NONE, {}, tag);
+        } catch (const AuthenticationFailedException&) {
+            throw CryptoOperationException("Aegis vault failed authentication");
+        }
+
+        JsonDocument inner;
+        parseDocument(inner, vault.text(), "Aegis vault");
+        reserveFor(batch, vault.bytes.size());
+        parseAegisEntries(inner, &inner.root(), batch);
+    }
+
+    // andOTP entries: a top-level array with "label" as the account name
+    void parseAndOtpEntries(Range text, ImportBatch& batch) {
+        JsonDocument document;
+        parseDocument(document, text, "andOTP backup");
+        const JsonNode* root = &document.root();
+        if (root->kind != JsonKind::ARRAY) {
+            throw CryptoOperationException("Not an andOTP backup");
+        }
+        reserveFor(batch, static_cast<size_t>(text.end - text.begin));
+        for (const JsonNode* entry = document.first(root); entry; entry = document.next(entry)) {
+            EntryFields fields;
+            fields.type = document.member(entry, "type");
+            fields.secret = document.member(entry, "secret");
+            fields.issuer = document.member(entry, "issuer");
+            fields.name = document.member(entry, "label");
+            fields.algorithm = document.member(entry, "algorithm");
+            fields.digits = document.member(entry, "digits");
+            fields.period = document.member(entry, "period");
+            fields.counter = document.member(entry, "counter");
+            appendEntry(fields, batch);
+        }
+    }
+
+    void parseAndOtp(CryptoEngine& engine, const SecureBytes& data, const std::string& password, ImportBatch& batch) {
+        size_t start = 0;
+        while (start < data.size() && (data[start] == ' ' || data[start] == '\n' || data[start] == '\r' ||
+                                       data[start] == '\t')) {
+            ++start;
+        }
+        if (start < data.size() && data[start] == '[') {
+            parseAndOtpEntries(textOf(data.data(), data.size()), batch);
+            return;
+        }
+
+        if (data.size() < ANDOTP_HEADER_LENGTH + GCM_TAG_LENGTH) {
+            throw CryptoOperationException("Not an andOTP backup");
+        }
+        const uint64_t iterations = (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+                                    (static_cast<uint32_t>(data[2]) << 8) | data[3];
+        if (iterations == 0 || iterations > ANDOTP_MAX_ITERATIONS) {
+            throw CryptoOperationException("Not an andOTP backup");
+        }
+        const uint8_t* salt = data.data() + 4;
+        const uint8_t* nonce = salt + ANDOTP_SALT_LENGTH;
+        const uint8_t* ciphertext = nonce + GCM_NONCE_LENGTH;
+        const uint8_t* tag = data.data() + data.size() - GCM_TAG_LENGTH;
+
+        SecureBytes key = engine.derivePbkdf2(password, std::vector<uint8_t>(salt, salt + ANDOTP_SALT_LENGTH),
+                                              static_cast<uint32_t>(iterations), KEY_LENGTH, HashAlgorithm::SHA1);
+        Plaintext entries;
+        try {
+            entries.bytes = engine.decrypt(std::vector<uint8_t>(ciphertext, tag), key, CipherAlgorithm::AES_256_GCM,
+                                           std::vector<uint8_t>(nonce, nonce + GCM_NONCE_LENGTH), PaddingMode::NONE, {},
+                                           std::vector<uint8_t>(tag, tag + GCM_TAG_LENGTH));
+        } catch (const AuthenticationFailedException&) {
+            throw InvalidKeyException("Wrong backup password");
+        }
+        parseAndOtpEntries(entries.text(), batch);
+    }
+
+    // 2FAS services; the OTP parameters sit in a nested "otp" object
+    void parseTwoFasServices(const JsonDocument& document, const JsonNode* services, ImportBatch& batch) {
+        for (const JsonNode* service = document.first(services); service; service = document.next(service)) {
+            const JsonNode* otp = document.member(service, "otp");
+            EntryFields fields;
+            fields.type = document.member(otp, "tokenType");
+            fields.secret = document.member(service, "secret");
+            fields.issuer = document.member(otp, "issuer");
+            fields.issuerFallback = document.member(service, "name");
+            fields.name = document.member(otp, "account");
+            fields.nameFallback = document.member(otp, "label");
+            fields.algorithm = document.member(otp, "algorithm");
+            fields.digits = document.member(otp, "digits");
+            fields.period = document.member(otp, "period");
+            fields.counter = document.member(otp, "counter");
+            appendEntry(fields, batch);
+        }
+    }
+
+    void parseTwoFas(CryptoEngine& engine, Range text, const std::string& password, ImportBatch& batch) {
+        JsonDocument document;
+        parseDocument(document, text, "2FAS backup");
+        const JsonNode* root = &document.root();
+        const JsonNode* encrypted = document.member(root, "servicesEncrypted");
+        if (!isNonEmptyString(encrypted)) {
+            const JsonNode* services = document.member(root, "services");
+            if (!services || services->kind != JsonKind::ARRAY) {
+                throw CryptoOperationException("Not a 2FAS backup");
+            }
+            reserveFor(batch, static_cast<size_t>(text.end - text.begin));
+            parseTwoFasServices(document, services, batch);
+            return;
+        }
+
+        // Base64 never needs escaping beyond "\/", which decodeBase64 reads
+        // through; split on the raw text
+        std::string packed;
+        JsonStringReader reader(encrypted->text);
+        char c;
+        while (reader.next(c)) {
+            packed.push_back(c);
+        }
+        const size_t first = packed.find(':');
+        const size_t second = first == std::string::npos ? first : packed.find(':', first + 1);
+        if (second == std::string::npos) {
+            throw CryptoOperationException("Malformed 2FAS encrypted services");
+        }
+        const char* base = packed.data();
+        std::vector<uint8_t> sealed, salt, nonce;
+        if (!decodeBase64(Range{base, base + first}, sealed) ||
+            !decodeBase64(Range{base + first + 1, base + second}, salt) ||
+            !decodeBase64(Range{base + second + 1, base + packed.size()}, nonce) ||
+            sealed.size() < GCM_TAG_LENGTH || salt.empty() || nonce.size() != GCM_NONCE_LENGTH) {
+            throw CryptoOperationException("Malformed 2FAS encrypted services");
+        }
+
+        SecureBytes key = engine.derivePbkdf2(password, salt, TWOFAS_ITERATIONS, KEY_LENGTH, HashAlgorithm::SHA256);
+        std::vector<uint8_t> tag(sealed.end() - GCM_TAG_LENGTH, sealed.end());
+        sealed.resize(sealed.size() - GCM_TAG_LENGTH);
+        Plaintext services;
+        try {
+            services.bytes = engine.decrypt(sealed, key, CipherAlgorithm::AES_256_GCM, nonce, PaddingMode::NONE, {}, tag);
+        } catch (const AuthenticationFailedException&) {
+            throw InvalidKeyException("Wrong backup password");
+        }
+
+        JsonDocument inner;
+        parseDocument(inner, services.text(), "2FAS services");
+        if (inner.root().kind != JsonKind::ARRAY) {
+            throw CryptoOperationException("Malformed 2FAS services");
+        }
+        reserveFor(batch, services.bytes.size());
+        parseTwoFasServices(inner, &inner.root(), batch);
+    }
+}
+
+ImportBatch parseBackup(BackupFormat format, const SecureBytes& data, const std::string& password) {
+    ImportBatch batch;
+    CryptoEngine engine;
+    const Range text = textOf(data.data(), data.size());
+
+    switch (format) {
+        case BackupFormat::AEGIS:
+            parseAegis(engine, text, password, batch);
+            break;
+        case BackupFormat::ANDOTP:
+            parseAndOtp(engine, data, password, batch);
+            break;
+        case BackupFormat::TWOFAS:
+            parseTwoFas(engine, text, password, batch);
+            break;
+        default:
+            throw crypto_native::InvalidParameterException("Unknown backup format");
+    }
+    return batch;
+}
+
+} // namespace OtpImport
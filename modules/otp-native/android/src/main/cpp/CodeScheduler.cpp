@@ -0,0 +1,210 @@
+#include "CodeScheduler.h"
+#include "OtpGenerator.h"
+#include "SecureArena.h"
+#include <algorithm>
+#include <chrono>
+
+namespace CodeSchedule {
+
+namespace {
+    // Periods precomputed beyond the current one
+    constexpr size_t LOOKAHEAD_PERIODS = 2;
+
+    int64_t nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    bool isSha1(const std::string& algorithm) {
+        return algorithm.size() == 4 && (algorithm[0] | 0x20) == 's' && (algorithm[1] | 0x20) == 'h' &&
+               (algorithm[2] | 0x20) == 'a' && algorithm[3] == '1';
+    }
+
+    std::string generate(const Account& account, uint64_t timeSlot) {
+        switch (account.kind) {
+            case Kind::STEAM:
+                return OtpGenerator::generateSteamGuard(account.secret, timeSlot);
+            case Kind::MOTP:
+                // mOTP takes epoch seconds and divides by the period itself
+                return OtpGenerator::generateMOTPWithPeriod(account.secret, account.pin,
+                                                            timeSlot * account.period, account.period);
+            case Kind::TOTP:
+            default:
+                return OtpGenerator::generateTOTP(account.secret, timeSlot, account.digits, account.algorithm);
+        }
+    }
+}
+
+Scheduler::Scheduler(ChangeSink sink) : sink_(std::move(sink)) {}
+
+Scheduler::~Scheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    for (auto& entry : groups_) {
+        wipe(entry.second.accounts);
+    }
+}
+
+void Scheduler::wipe(std::vector<Account>& accounts) {
+    for (auto& account : accounts) {
+        // Whole buffer: moved-from accounts keep short values in place
+        crypto_native::secureWipe(&account.secret[0], account.secret.capacity());
+        crypto_native::secureWipe(&account.pin[0], account.pin.capacity());
+    }
+    accounts.clear();
+}
+
+size_t Scheduler::setAccounts(std::vector<Account> accounts) {
+    std::map<int, Group> groups;
+    size_t accepted = 0;
+    for (auto& account : accounts) {
+        if (account.period <= 0 || account.secret.empty()) {
+            continue;
+        }
+        if (account.kind == Kind::STEAM) {
+            account.period = 30;
+        }
+        Group& group = groups[account.period];
+        group.accounts.push_back(std::move(account));
+        group.rings.emplace_back(LOOKAHEAD_PERIODS);
+        ++accepted;
+    }
+    wipe(accounts);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : groups_) {
+            wipe(entry.second.accounts);
+        }
+        groups_.swap(groups);
+        if (!worker_.joinable() && !groups_.empty()) {
+            worker_ = std::thread(&Scheduler::run, this);
+        }
+    }
+    wake_.notify_all();
+    return accepted;
+}
+
+size_t Scheduler::groupCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return groups_.size();
+}
+
+void Scheduler::fillAhead(Group& group) {
+    // All missing slots of a group go through the batch generators: HMAC
+    // accounts are keyed once for their whole window, mOTP accounts share
+    // the multi-buffer MD5 path
+    std::vector<OtpGenerator::OtpRequest> otpRequests;
+    std::vector<std::pair<size_t, uint64_t>> otpTargets;
+    std::vector<OtpGenerator::MotpRequest> motpRequests;
+    std::vector<std::pair<size_t, uint64_t>> motpTargets;
+
+    for (size_t i = 0; i < group.accounts.size(); ++i) {
+        const Account& account = group.accounts[i];
+        OtpGenerator::CodeRing& ring = group.rings[i];
+        const uint64_t end = group.timeSlot + ring.capacity();
+        for (uint64_t slot = ring.firstMissing(group.timeSlot); slot < end; slot = ring.firstMissing(slot + 1)) {
+            if (account.kind == Kind::MOTP) {
+                motpRequests.push_back({&account.secret, &account.pin, slot});
+                motpTargets.emplace_back(i, slot);
+            } else if (account.kind == Kind::STEAM) {
+                otpRequests.push_back({&account.secret, slot, 0, OtpGenerator::OtpEncoding::STEAM});
+                otpTargets.emplace_back(i, slot);
+            } else if (isSha1(account.algorithm)) {
+                otpRequests.push_back({&account.secret, slot, account.digits, OtpGenerator::OtpEncoding::DECIMAL});
+                otpTargets.emplace_back(i, slot);
+            } else {
+                ring.store(slot, generate(account, slot));
+            }
+        }
+    }
+
+    if (!otpRequests.empty()) {
+        std::vector<std::string> codes = OtpGenerator::generateOTPBatch(otpRequests);
+        for (size_t k = 0; k < codes.size(); ++k) {
+            group.rings[otpTargets[k].first].store(otpTargets[k].second, codes[k]);
+        }
+    }
+    if (!motpRequests.empty()) {
+        std::vector<std::string> codes = OtpGenerator::generateMOTPBatch(motpRequests);
+        for (size_t k = 0; k < codes.size(); ++k) {
+            group.rings[motpTargets[k].first].store(motpTargets[k].second, codes[k]);
+        }
+    }
+    group.filled = true;
+}
+
+void Scheduler::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (groups_.empty()) {
+            wake_.wait(lock, [this] { return stopping_ || !groups_.empty(); });
+            continue;
+        }
+
+        const int64_t now = nowMs();
+        int64_t nextBoundary = INT64_MAX;
+        std::vector<CodeGroup> changes;
+
+        for (auto& entry : groups_) {
+            const int64_t periodMs = static_cast<int64_t>(entry.first) * 1000;
+            const uint64_t timeSlot = static_cast<uint64_t>(now / periodMs);
+            const int64_t validUntil = static_cast<int64_t>(timeSlot + 1) * periodMs;
+            nextBoundary = std::min(nextBoundary, validUntil);
+
+            Group& group = entry.second;
+            if (group.generated && group.timeSlot == timeSlot) {
+                continue;
+            }
+            group.generated = true;
+            group.timeSlot = timeSlot;
+            group.filled = false;
+
+            CodeGroup change;
+            change.period = entry.first;
+            change.timeSlot = timeSlot;
+            change.validUntilMs = validUntil;
+            change.codes.reserve(group.accounts.size());
+            for (size_t i = 0; i < group.accounts.size(); ++i) {
+                // Precomputed during the previous period unless this is the
+                // first pass or the clock jumped
+                std::string code;
+                if (!group.rings[i].lookup(timeSlot, code)) {
+                    code = generate(group.accounts[i], timeSlot);
+                    group.rings[i].store(timeSlot, code);
+                }
+                change.codes.emplace_back(group.accounts[i].id, std::move(code));
+            }
+            changes.push_back(std::move(change));
+        }
+
+        if (!changes.empty()) {
+            // Deliver outside the lock so the sink may call back into the scheduler
+            lock.unlock();
+            sink_(changes);
+            lock.lock();
+            continue;
+        }
+
+        // Idle until the next boundary: top up one group's rings per pass so
+        // setAccounts and shutdown are not held up behind a large fill
+        auto pending = std::find_if(groups_.begin(), groups_.end(),
+                                    [](const std::pair<const int, Group>& entry) { return !entry.second.filled; });
+        if (pending != groups_.end()) {
+            fillAhead(pending->second);
+            continue;
+        }
+
+        // Woken early by setAccounts or shutdown; otherwise the loop above
+        // finds the groups whose slot changed
+        wake_.wait_for(lock, std::chrono::milliseconds(nextBoundary - now));
+    }
+}
+
+}
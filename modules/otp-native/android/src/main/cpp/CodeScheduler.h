@@ -0,0 +1,95 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "OtpGenerator.h"
+
+namespace CodeSchedule {
+    enum class Kind {
+        TOTP,
+        STEAM,
+        MOTP
+    };
+
+    struct Account {
+        std::string id;
+        Kind kind = Kind::TOTP;
+        std::string secret;     // Base32 for TOTP/Steam, raw for mOTP
+        std::string pin;        // mOTP only
+        int digits = 6;
+        std::string algorithm = "SHA1";
+        int period = 30;
+    };
+
+    // Codes of one period group for the slot that just started
+    struct CodeGroup {
+        int period = 0;
+        uint64_t timeSlot = 0;
+        int64_t validUntilMs = 0;  // Next boundary, milliseconds since epoch
+        std::vector<std::pair<std::string, std::string>> codes;  // (account id, code)
+    };
+
+    // Receives every group whose period rolled over at one boundary
+    using ChangeSink = std::function<void(const std::vector<CodeGroup>&)>;
+
+    /**
+     * Regenerates time-based codes at period boundaries only.
+     *
+     * Accounts are grouped by period. A single worker thread sleeps until
+     * the earliest upcoming boundary, generates the codes of every group
+     * whose slot changed in one batch and hands them to the sink as one
+     * change. Groups whose boundaries coincide (10 s and 30 s at :30) share
+     * the wakeup, so wakeups scale with the number of distinct periods
+     * rather than with accounts. The thread is idle while nothing is
+     * registered.
+     *
+     * Between boundaries the same thread fills a look-ahead ring per
+     * account with the codes of the next periods, so the work at a
+     * boundary is a ring lookup per account. Rings and secrets are wiped
+     * when accounts are replaced and when the scheduler is destroyed.
+     */
+    class Scheduler {
+    public:
+        explicit Scheduler(ChangeSink sink);
+        ~Scheduler();
+
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        /**
+         * Replace the registered accounts. Every group is regenerated and
+         * reported on the next pass of the worker.
+         * @return Number of accounts accepted (positive period, non-empty secret)
+         */
+        size_t setAccounts(std::vector<Account> accounts);
+
+        size_t groupCount() const;
+
+    private:
+        struct Group {
+            std::vector<Account> accounts;
+            std::vector<OtpGenerator::CodeRing> rings;  // Parallel to accounts
+            uint64_t timeSlot = 0;
+            bool generated = false;
+            bool filled = false;  // Rings cover the look-ahead window of timeSlot
+        };
+
+        void run();
+        static void fillAhead(Group& group);
+        static void wipe(std::vector<Account>& accounts);
+
+        ChangeSink sink_;
+        mutable std::mutex mutex_;
+        std::condition_variable wake_;
+        std::map<int, Group> groups_;
+        bool stopping_ = false;
+        std::thread worker_;
+    };
+}
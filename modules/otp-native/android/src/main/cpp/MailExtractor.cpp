@@ -0,0 +1,1063 @@
+#include "MailExtractor.h"
+#include "OtpImport.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string_view>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace MailExtract {
+
+namespace {
+    constexpr size_t READ_BUFFER_SIZE = 64 * 1024;
+    constexpr size_t MAX_MESSAGE_SIZE = 4 * 1024 * 1024;
+    constexpr int MAX_MIME_DEPTH = 8;
+    constexpr size_t MAX_FINDINGS = 16;       // Per kind, per message
+    constexpr size_t MAX_URL_LENGTH = 2048;
+    constexpr size_t CODE_WINDOW_AFTER = 64;
+    constexpr size_t CODE_WINDOW_BEFORE = 48;
+    constexpr size_t SECRET_WINDOW = 96;
+    constexpr size_t MIN_SECRET_LENGTH = 16;
+    constexpr size_t MAX_SECRET_LENGTH = 128;
+
+    inline char lowerAscii(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    inline bool isAsciiAlpha(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    inline bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    inline bool isAsciiAlnum(char c) {
+        return isAsciiAlpha(c) || isDigit(c);
+    }
+
+    inline bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    inline bool isOneOf(char c, const char* set) {
+        return c != '\0' && std::strchr(set, c) != nullptr;
+    }
+
+    std::string_view trim(std::string_view s) {
+        while (!s.empty() && isSpace(s.front())) s.remove_prefix(1);
+        while (!s.empty() && isSpace(s.back())) s.remove_suffix(1);
+        return s;
+    }
+
+    std::string toLower(std::string_view s) {
+        std::string result(s);
+        for (char& c : result) {
+            c = lowerAscii(c);
+        }
+        return result;
+    }
+
+    bool startsWithNoCase(std::string_view s, std::string_view lowerPrefix) {
+        if (s.size() < lowerPrefix.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < lowerPrefix.size(); ++i) {
+            if (lowerAscii(s[i]) != lowerPrefix[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t findNoCase(std::string_view haystack, std::string_view lowerNeedle, size_t from = 0) {
+        if (lowerNeedle.empty() || haystack.size() < lowerNeedle.size()) {
+            return std::string_view::npos;
+        }
+        for (size_t i = from; i + lowerNeedle.size() <= haystack.size(); ++i) {
+            if (startsWithNoCase(haystack.substr(i), lowerNeedle)) {
+                return i;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    inline int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    void appendUtf8(std::string& out, uint32_t codepoint) {
+        if (codepoint < 0x80) {
+            out.push_back(static_cast<char>(codepoint));
+        } else if (codepoint < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+            out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+        } else if (codepoint < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+        } else if (codepoint < 0x110000) {
+            out.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+        }
+    }
+
+    // ---- Transfer encodings and charsets ----
+
+    std::string decodeBase64(std::string_view input) {
+        std::string out;
+        out.reserve(input.size() * 3 / 4);
+        uint32_t accumulator = 0;
+        int bits = 0;
+        for (char c : input) {
+            int value;
+            if (c >= 'A' && c <= 'Z') value = c - 'A';
+            else if (c >= 'a' && c <= 'z') value = c - 'a' + 26;
+            else if (c >= '0' && c <= '9') value = c - '0' + 52;
+            else if (c == '+' || c == '-') value = 62;
+            else if (c == '/' || c == '_') value = 63;
+            else if (c == '=') break;
+            else continue;  // Line breaks and stray bytes
+            accumulator = (accumulator << 6) | static_cast<uint32_t>(value);
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                out.push_back(static_cast<char>((accumulator >> bits) & 0xFF));
+            }
+        }
+        return out;
+    }
+
+    std::string decodeQuotedPrintable(std::string_view input, bool underscoreIsSpace) {
+        std::string out;
+        out.reserve(input.size());
+        for (size_t i = 0; i < input.size(); ++i) {
+            const char c = input[i];
+            if (c == '=') {
+                // Soft line break
+                if (i + 1 < input.size() && input[i + 1] == '\n') {
+                    i += 1;
+                    continue;
+                }
+                if (i + 2 < input.size() && input[i + 1] == '\r' && input[i + 2] == '\n') {
+                    i += 2;
+                    continue;
+                }
+                if (i + 2 < input.size()) {
+                    const int high = hexValue(input[i + 1]);
+                    const int low = hexValue(input[i + 2]);
+                    if (high >= 0 && low >= 0) {
+                        out.push_back(static_cast<char>((high << 4) | low));
+                        i += 2;
+                        continue;
+                    }
+                }
+                out.push_back(c);
+            } else if (c == '_' && underscoreIsSpace) {
+                out.push_back(' ');
+            } else {
+                out.push_back(c);
+            }
+        }
+        return out;
+    }
+
+    // Windows-1252 code points for 0x80-0x9F; zero entries fall back to Latin-1
+    constexpr uint16_t CP1252_HIGH[32] = {
+        0x20AC, 0, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+        0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0, 0x017D, 0,
+        0, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+        0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0, 0x017E, 0x0178
+    };
+
+    /**
+     * Convert single-byte Western charsets to UTF-8. UTF-8/ASCII pass
+     * through, as do other charsets: they are ASCII-compatible, which is
+     * all the matcher needs.
+     */
+    std::string toUtf8(std::string text, const std::string& charset) {
+        const std::string name = toLower(charset);
+        const bool singleByte = name == "iso-8859-1" || name == "latin1" || name == "iso-8859-15" ||
+                                name == "windows-1252" || name == "cp1252" || name == "iso_8859-1";
+        if (!singleByte) {
+            return text;
+        }
+
+        bool ascii = true;
+        for (char c : text) {
+            if (static_cast<unsigned char>(c) >= 0x80) {
+                ascii = false;
+                break;
+            }
+        }
+        if (ascii) {
+            return text;
+        }
+
+        std::string out;
+        out.reserve(text.size() + text.size() / 4);
+        for (char c : text) {
+            const auto byte = static_cast<unsigned char>(c);
+            if (byte >= 0x80 && byte < 0xA0 && CP1252_HIGH[byte - 0x80]) {
+                appendUtf8(out, CP1252_HIGH[byte - 0x80]);
+            } else {
+                appendUtf8(out, byte);
+            }
+        }
+        return out;
+    }
+
+    // RFC 2047 encoded words: =?charset?B|Q?text?=
+    std::string decodeHeaderWords(std::string_view value) {
+        std::string out;
+        bool previousWasEncoded = false;
+        size_t i = 0;
+        while (i < value.size()) {
+            if (value.compare(i, 2, "=?") == 0) {
+                const size_t charsetEnd = value.find('?', i + 2);
+                const size_t encodingEnd = charsetEnd == std::string_view::npos ? charsetEnd : value.find('?', charsetEnd + 1);
+                const size_t textEnd = encodingEnd == std::string_view::npos ? encodingEnd : value.find("?=", encodingEnd + 1);
+                if (textEnd != std::string_view::npos && encodingEnd == charsetEnd + 2) {
+                    std::string charset(value.substr(i + 2, charsetEnd - i - 2));
+                    const size_t language = charset.find('*');
+                    if (language != std::string::npos) {
+                        charset.resize(language);
+                    }
+                    const char encoding = lowerAscii(value[charsetEnd + 1]);
+                    std::string_view text = value.substr(encodingEnd + 1, textEnd - encodingEnd - 1);
+                    std::string decoded = encoding == 'b' ? decodeBase64(text) : decodeQuotedPrintable(text, true);
+
+                    // Whitespace between adjacent encoded words is dropped
+                    if (previousWasEncoded) {
+                        while (!out.empty() && isSpace(out.back())) out.pop_back();
+                    }
+                    out += toUtf8(std::move(decoded), charset);
+                    previousWasEncoded = true;
+                    i = textEnd + 2;
+                    continue;
+                }
+            }
+            if (!isSpace(value[i])) {
+                previousWasEncoded = false;
+            }
+            out.push_back(value[i]);
+            ++i;
+        }
+        return out;
+    }
+
+    // ---- HTML ----
+
+    bool decodeEntity(std::string_view html, size_t& i, std::string& out) {
+        const size_t semicolon = html.find(';', i + 1);
+        if (semicolon == std::string_view::npos || semicolon - i > 10) {
+            return false;
+        }
+        std::string_view name = html.substr(i + 1, semicolon - i - 1);
+        uint32_t codepoint = 0;
+        if (!name.empty() && name[0] == '#') {
+            const bool hex = name.size() > 1 && (name[1] == 'x' || name[1] == 'X');
+            for (size_t k = hex ? 2 : 1; k < name.size(); ++k) {
+                const int digit = hex ? hexValue(name[k]) : (isDigit(name[k]) ? name[k] - '0' : -1);
+                if (digit < 0 || codepoint > 0x10FFFF) {
+                    return false;
+                }
+                codepoint = codepoint * (hex ? 16 : 10) + static_cast<uint32_t>(digit);
+            }
+        } else if (name == "amp") {
+            codepoint = '&';
+        } else if (name == "lt") {
+            codepoint = '<';
+        } else if (name == "gt") {
+            codepoint = '>';
+        } else if (name == "quot") {
+            codepoint = '"';
+        } else if (name == "apos") {
+            codepoint = '\'';
+        } else if (name == "nbsp") {
+            codepoint = ' ';
+        } else {
+            return false;
+        }
+        appendUtf8(out, codepoint == 0xA0 ? ' ' : codepoint);
+        i = semicolon;
+        return true;
+    }
+
+    std::string decodeEntities(std::string_view text) {
+        std::string out;
+        out.reserve(text.size());
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] != '&' || !decodeEntity(text, i, out)) {
+                out.push_back(text[i]);
+            }
+        }
+        return out;
+    }
+
+    /**
+     * Reduce HTML to text. Tags become spaces (block tags newlines), script
+     * and style bodies are dropped and href targets are kept inline so
+     * activation links survive.
+     */
+    std::string htmlToText(std::string_view html) {
+        std::string out;
+        out.reserve(html.size() / 2);
+        size_t i = 0;
+        while (i < html.size()) {
+            const char c = html[i];
+            if (c == '<') {
+                if (html.compare(i, 4, "<!--") == 0) {
+                    const size_t end = html.find("-->", i + 4);
+                    i = end == std::string_view::npos ? html.size() : end + 3;
+                    out.push_back(' ');
+                    continue;
+                }
+                const size_t end = html.find('>', i + 1);
+                if (end == std::string_view::npos) {
+                    // A stray '<' ("valid for <10 minutes") with no tag after
+                    // it; nothing further can close, so the rest is text
+                    out += decodeEntities(html.substr(i));
+                    break;
+                }
+                std::string_view tag = html.substr(i + 1, end - i - 1);
+                const bool closing = !tag.empty() && tag[0] == '/';
+                size_t nameEnd = closing ? 1 : 0;
+                while (nameEnd < tag.size() && isAsciiAlnum(tag[nameEnd])) ++nameEnd;
+                const std::string name = toLower(tag.substr(closing ? 1 : 0, nameEnd - (closing ? 1 : 0)));
+
+                if (!closing && (name == "script" || name == "style" || name == "head")) {
+                    const size_t close = findNoCase(html, "</" + name, end + 1);
+                    const size_t closeEnd = close == std::string_view::npos ? close : html.find('>', close);
+                    i = closeEnd == std::string_view::npos ? html.size() : closeEnd + 1;
+                    out.push_back(' ');
+                    continue;
+                }
+
+                if (!closing) {
+                    const size_t href = findNoCase(tag, "href=");
+                    if (href != std::string_view::npos) {
+                        size_t start = href + 5;
+                        char quote = 0;
+                        if (start < tag.size() && (tag[start] == '"' || tag[start] == '\'')) {
+                            quote = tag[start++];
+                        }
+                        size_t stop = start;
+                        while (stop < tag.size() && (quote ? tag[stop] != quote : !isSpace(tag[stop]))) ++stop;
+                        out.push_back(' ');
+                        out += decodeEntities(tag.substr(start, stop - start));
+                    }
+                }
+
+                const bool block = name == "br" || name == "p" || name == "div" || name == "tr" ||
+                                   name == "li" || name == "h1" || name == "h2" || name == "h3" || name == "table";
+                out.push_back(block ? '\n' : ' ');
+                i = end + 1;
+            } else if (c == '&' && decodeEntity(html, i, out)) {
+                ++i;
+            } else {
+                out.push_back(c);
+                ++i;
+            }
+        }
+        return out;
+    }
+
+    // ---- Trigger matcher ----
+
+    enum TriggerKind : uint8_t {
+        SETUP_URI,
+        WEB_URL,
+        CODE_KEYWORD,
+        SECRET_KEYWORD
+    };
+
+    struct Trigger {
+        const char* pattern;  // Lowercase
+        TriggerKind kind;
+        bool wholeWord;
+    };
+
+    constexpr Trigger TRIGGERS[] = {
+        {"otpauth://", SETUP_URI, false},
+        {"otpauth-migration://", SETUP_URI, false},
+        {"https://", WEB_URL, false},
+        {"http://", WEB_URL, false},
+        {"code", CODE_KEYWORD, true},
+        {"codes", CODE_KEYWORD, true},
+        {"passcode", CODE_KEYWORD, true},
+        {"verification", CODE_KEYWORD, true},
+        {"one-time", CODE_KEYWORD, true},
+        {"one time", CODE_KEYWORD, true},
+        {"otp", CODE_KEYWORD, true},
+        {"pin", CODE_KEYWORD, true},
+        {"2fa", CODE_KEYWORD, true},
+        {"c\xc3\xb3" "digo", CODE_KEYWORD, true},                  // código
+        {"\xe9\xaa\x8c\xe8\xaf\x81\xe7\xa0\x81", CODE_KEYWORD, false},  // 验证码
+        {"secret", SECRET_KEYWORD, false},
+        {"setup key", SECRET_KEYWORD, true},
+        {"key", SECRET_KEYWORD, true},
+        {"manual entry", SECRET_KEYWORD, true},
+        {"manually", SECRET_KEYWORD, true},
+    };
+    constexpr size_t TRIGGER_COUNT = sizeof(TRIGGERS) / sizeof(TRIGGERS[0]);
+    static_assert(TRIGGER_COUNT <= 32, "trigger masks are 32 bits");
+
+    constexpr const char* ACTIVATION_HINTS[] = {"verif", "confirm", "activat", "validat"};
+
+    /**
+     * Aho-Corasick DFA over the fixed trigger table. Every state carries
+     * the mask of triggers ending there, so a text is matched in one pass.
+     */
+    class TriggerAutomaton {
+    public:
+        TriggerAutomaton() {
+            std::vector<std::array<int32_t, 256>> trie(1);
+            trie[0].fill(-1);
+            masks_.assign(1, 0);
+            for (size_t p = 0; p < TRIGGER_COUNT; ++p) {
+                int32_t node = 0;
+                for (const char* c = TRIGGERS[p].pattern; *c; ++c) {
+                    const auto byte = static_cast<uint8_t>(*c);
+                    if (trie[node][byte] < 0) {
+                        trie[node][byte] = static_cast<int32_t>(trie.size());
+                        trie.emplace_back();
+                        trie.back().fill(-1);
+                        masks_.push_back(0);
+                    }
+                    node = trie[node][byte];
+                }
+                masks_[node] |= 1u << p;
+            }
+
+            classes_.fill(0);
+            classCount_ = 1;
+            for (const auto& edges : trie) {
+                for (int byte = 0; byte < 256; ++byte) {
+                    if (edges[byte] >= 0 && !classes_[byte]) {
+                        classes_[byte] = static_cast<uint8_t>(classCount_++);
+                    }
+                }
+            }
+            // Uppercase ASCII shares its lowercase class, so input needs no folding
+            for (int byte = 'A'; byte <= 'Z'; ++byte) {
+                classes_[byte] = classes_[byte - 'A' + 'a'];
+            }
+
+            next_.assign(trie.size() * classCount_, 0);
+            std::vector<int32_t> fail(trie.size(), 0);
+            std::deque<int32_t> queue;
+            for (int byte = 0; byte < 256; ++byte) {
+                if (trie[0][byte] >= 0) {
+                    next_[classes_[byte]] = trie[0][byte];
+                    queue.push_back(trie[0][byte]);
+                }
+            }
+            while (!queue.empty()) {
+                const int32_t node = queue.front();
+                queue.pop_front();
+                masks_[node] |= masks_[fail[node]];
+
+                int32_t* row = &next_[static_cast<size_t>(node) * classCount_];
+                const int32_t* failRow = &next_[static_cast<size_t>(fail[node]) * classCount_];
+                std::copy(failRow, failRow + classCount_, row);
+                for (int byte = 0; byte < 256; ++byte) {
+                    const int32_t child = trie[node][byte];
+                    if (child >= 0) {
+                        fail[child] = failRow[classes_[byte]];
+                        row[classes_[byte]] = child;
+                        queue.push_back(child);
+                    }
+                }
+            }
+        }
+
+        template <typename OnMatch>
+        void scan(std::string_view text, OnMatch onMatch) const {
+            int32_t state = 0;
+            for (size_t i = 0; i < text.size(); ++i) {
+                state = next_[static_cast<size_t>(state) * classCount_ + classes_[static_cast<uint8_t>(text[i])]];
+                uint32_t mask = masks_[state];
+                while (mask) {
+                    const int trigger = __builtin_ctz(mask);
+                    mask &= mask - 1;
+                    onMatch(static_cast<size_t>(trigger), i + 1);
+                }
+            }
+        }
+
+    private:
+        std::array<uint8_t, 256> classes_{};
+        uint32_t classCount_ = 1;
+        std::vector<int32_t> next_;
+        std::vector<uint32_t> masks_;
+    };
+
+    const TriggerAutomaton& triggers() {
+        static const TriggerAutomaton automaton;
+        return automaton;
+    }
+
+    // ---- Finding extraction ----
+
+    void addUnique(std::vector<std::string>& list, std::string value) {
+        if (value.empty() || list.size() >= MAX_FINDINGS) {
+            return;
+        }
+        if (std::find(list.begin(), list.end(), value) == list.end()) {
+            list.push_back(std::move(value));
+        }
+    }
+
+    std::string_view readUrl(std::string_view text, size_t start) {
+        size_t end = start;
+        while (end < text.size() && end - start < MAX_URL_LENGTH) {
+            const char c = text[end];
+            if (isSpace(c) || c == '"' || c == '\'' || c == '<' || c == '>' || c == '`') {
+                break;
+            }
+            ++end;
+        }
+        // Sentence punctuation and closing brackets are rarely part of the link
+        while (end > start && isOneOf(text[end - 1], ".,;:!?)]")) {
+            --end;
+        }
+        return text.substr(start, end - start);
+    }
+
+    /**
+     * Find a 4-8 digit code token in [from, to). Digit groups of three or
+     * more may be split by one space or hyphen ("123 456"). Years and
+     * tokens glued to letters, currency or phone prefixes are skipped.
+     */
+    bool findCode(std::string_view text, size_t from, size_t to, bool last, std::string& code) {
+        bool found = false;
+        size_t i = from;
+        while (i < to) {
+            if (!isDigit(text[i]) || (i > 0 && (isAsciiAlnum(text[i - 1]) || isOneOf(text[i - 1], "$+#.,:/")))) {
+                ++i;
+                continue;
+            }
+
+            std::string digits;
+            size_t j = i;
+            size_t groupLength = 0;
+            bool valid = true;
+            while (j < text.size()) {
+                if (isDigit(text[j])) {
+                    digits.push_back(text[j]);
+                    ++groupLength;
+                    ++j;
+                } else if ((text[j] == ' ' || text[j] == '-') && groupLength >= 3 &&
+                           j + 3 < text.size() && isDigit(text[j + 1]) && isDigit(text[j + 2]) && isDigit(text[j + 3])) {
+                    groupLength = 0;
+                    ++j;
+                } else {
+                    break;
+                }
+            }
+            if (j < text.size() && (isAsciiAlpha(text[j]) ||
+                                    ((text[j] == '.' || text[j] == ',' || text[j] == ':' || text[j] == '/') &&
+                                     j + 1 < text.size() && isDigit(text[j + 1])))) {
+                valid = false;
+            }
+            if (digits.size() < 4 || digits.size() > 8) {
+                valid = false;
+            }
+            if (valid && digits.size() == 4 && (digits.compare(0, 2, "19") == 0 || digits.compare(0, 2, "20") == 0)) {
+                valid = false;
+            }
+
+            if (valid) {
+                code = std::move(digits);
+                found = true;
+                if (!last) {
+                    return true;
+                }
+            }
+            i = j;
+        }
+        return found;
+    }
+
+    inline bool isBase32Char(char c) {
+        return isAsciiAlpha(c) || (c >= '2' && c <= '7');
+    }
+
+    bool validSecret(const std::vector<std::string_view>& groups, size_t count, std::string& secret) {
+        std::string joined;
+        for (size_t g = 0; g < count; ++g) {
+            joined.append(groups[g].data(), groups[g].size());
+        }
+        if (joined.size() < MIN_SECRET_LENGTH || joined.size() > MAX_SECRET_LENGTH) {
+            return false;
+        }
+        // Grouped keys are printed in equal blocks; only the last may be short
+        if (count > 1) {
+            const size_t blockLength = groups[0].size();
+            if (blockLength < 4 || blockLength > 8) {
+                return false;
+            }
+            for (size_t g = 1; g < count; ++g) {
+                if (groups[g].size() > blockLength || (g + 1 < count && groups[g].size() != blockLength)) {
+                    return false;
+                }
+            }
+        }
+
+        bool hasDigit = false, hasUpper = false, hasLower = false;
+        for (char c : joined) {
+            hasDigit |= isDigit(c);
+            hasUpper |= (c >= 'A' && c <= 'Z');
+            hasLower |= (c >= 'a' && c <= 'z');
+        }
+        // Mixed case is prose; plain lowercase words need a digit to qualify
+        if ((hasUpper && hasLower) || (!hasDigit && !hasUpper)) {
+            return false;
+        }
+
+        for (char& c : joined) {
+            c = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+        }
+        secret = std::move(joined);
+        return true;
+    }
+
+    bool findSecret(std::string_view text, size_t from, std::string& secret) {
+        const size_t limit = std::min(text.size(), from + SECRET_WINDOW);
+        size_t i = from;
+        while (i < limit && (isSpace(text[i]) || isOneOf(text[i], ":=\"'*-"))) ++i;
+
+        std::vector<std::string_view> groups;
+        while (i < text.size() && groups.size() < 32) {
+            const size_t start = i;
+            while (i < text.size() && isBase32Char(text[i])) ++i;
+            if (i == start) {
+                break;
+            }
+            groups.push_back(text.substr(start, i - start));
+            if (i < text.size() && isAsciiAlnum(text[i])) {
+                // Characters outside the Base32 alphabet end the key
+                groups.pop_back();
+                break;
+            }
+            if (i + 1 < text.size() && text[i] == ' ' && isBase32Char(text[i + 1])) {
+                ++i;
+            } else {
+                break;
+            }
+        }
+
+        for (size_t count = groups.size(); count > 0; --count) {
+            if (validSecret(groups, count, secret)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool isActivationUrl(std::string_view url) {
+        const std::string lowered = toLower(url);
+        for (const char* hint : ACTIVATION_HINTS) {
+            if (lowered.find(hint) != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void scanText(std::string_view text, MessageFindings& findings) {
+        triggers().scan(text, [&](size_t index, size_t end) {
+            const Trigger& trigger = TRIGGERS[index];
+            const size_t start = end - std::strlen(trigger.pattern);
+            if (trigger.wholeWord &&
+                ((start > 0 && isAsciiAlpha(text[start - 1])) || (end < text.size() && isAsciiAlpha(text[end])))) {
+                return;
+            }
+
+            switch (trigger.kind) {
+                case SETUP_URI: {
+                    std::string uri(readUrl(text, start));
+                    OtpImport::ImportBatch batch;
+                    if (OtpImport::parseUri(uri, batch) && !batch.accounts.empty()) {
+                        addUnique(findings.setupUris, std::move(uri));
+                    }
+                    break;
+                }
+                case WEB_URL: {
+                    std::string_view url = readUrl(text, start);
+                    if (url.size() > end - start && isActivationUrl(url)) {
+                        addUnique(findings.activationUrls, std::string(url));
+                    }
+                    break;
+                }
+                case CODE_KEYWORD: {
+                    std::string code;
+                    const size_t after = std::min(text.size(), end + CODE_WINDOW_AFTER);
+                    const size_t before = start > CODE_WINDOW_BEFORE ? start - CODE_WINDOW_BEFORE : 0;
+                    if (findCode(text, end, after, false, code) || findCode(text, before, start, true, code)) {
+                        addUnique(findings.codes, std::move(code));
+                    }
+                    break;
+                }
+                case SECRET_KEYWORD: {
+                    std::string secret;
+                    if (findSecret(text, end, secret)) {
+                        addUnique(findings.secrets, std::move(secret));
+                    }
+                    break;
+                }
+            }
+        });
+    }
+
+    // ---- MIME ----
+
+    struct EntityHeaders {
+        std::string contentType;
+        std::string transferEncoding;
+    };
+
+    void splitEntity(std::string_view entity, std::string_view& headers, std::string_view& body) {
+        size_t position = 0;
+        while (position < entity.size()) {
+            size_t lineEnd = entity.find('\n', position);
+            if (lineEnd == std::string_view::npos) {
+                lineEnd = entity.size();
+            }
+            std::string_view line = entity.substr(position, lineEnd - position);
+            if (line.empty() || line == "\r") {
+                headers = entity.substr(0, position);
+                body = lineEnd < entity.size() ? entity.substr(lineEnd + 1) : std::string_view();
+                return;
+            }
+            position = lineEnd + 1;
+        }
+        headers = entity;
+        body = std::string_view();
+    }
+
+    void parseHeaders(std::string_view block, EntityHeaders& entity, MessageFindings* top) {
+        std::string name;
+        std::string value;
+        auto flush = [&]() {
+            if (name.empty()) {
+                return;
+            }
+            const std::string key = toLower(name);
+            std::string trimmed(trim(value));
+            if (key == "content-type") {
+                entity.contentType = std::move(trimmed);
+            } else if (key == "content-transfer-encoding") {
+                entity.transferEncoding = toLower(trimmed);
+            } else if (top) {
+                if (key == "from") top->from = decodeHeaderWords(trimmed);
+                else if (key == "subject") top->subject = decodeHeaderWords(trimmed);
+                else if (key == "date") top->date = std::move(trimmed);
+                else if (key == "message-id") top->messageId = std::move(trimmed);
+            }
+            name.clear();
+            value.clear();
+        };
+
+        size_t position = 0;
+        while (position < block.size()) {
+            size_t lineEnd = block.find('\n', position);
+            if (lineEnd == std::string_view::npos) {
+                lineEnd = block.size();
+            }
+            std::string_view line = block.substr(position, lineEnd - position);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            position = lineEnd + 1;
+
+            if (!line.empty() && (line[0] == ' ' || line[0] == '\t')) {
+                // Folded continuation
+                value.push_back(' ');
+                value.append(trim(line));
+                continue;
+            }
+            flush();
+            const size_t colon = line.find(':');
+            if (colon != std::string_view::npos) {
+                name.assign(trim(line.substr(0, colon)));
+                value.assign(line.substr(colon + 1));
+            }
+        }
+        flush();
+    }
+
+    std::string headerParameter(const std::string& header, std::string_view lowerName) {
+        size_t position = header.find(';');
+        while (position != std::string::npos) {
+            size_t start = position + 1;
+            while (start < header.size() && isSpace(header[start])) ++start;
+            if (startsWithNoCase(std::string_view(header).substr(start), lowerName) &&
+                start + lowerName.size() < header.size() && header[start + lowerName.size()] == '=') {
+                size_t valueStart = start + lowerName.size() + 1;
+                if (valueStart < header.size() && header[valueStart] == '"') {
+                    const size_t valueEnd = header.find('"', valueStart + 1);
+                    return header.substr(valueStart + 1,
+                                         (valueEnd == std::string::npos ? header.size() : valueEnd) - valueStart - 1);
+                }
+                size_t valueEnd = valueStart;
+                while (valueEnd < header.size() && header[valueEnd] != ';' && !isSpace(header[valueEnd])) ++valueEnd;
+                return header.substr(valueStart, valueEnd - valueStart);
+            }
+            position = header.find(';', start);
+        }
+        return std::string();
+    }
+
+    void extractEntity(std::string_view entity, int depth, MessageFindings& findings, bool top) {
+        std::string_view headerBlock;
+        std::string_view body;
+        splitEntity(entity, headerBlock, body);
+
+        EntityHeaders headers;
+        parseHeaders(headerBlock, headers, top ? &findings : nullptr);
+        if (top) {
+            scanText(findings.subject, findings);
+        }
+
+        const std::string& contentType = headers.contentType;
+        const std::string mediaType = toLower(trim(std::string_view(contentType).substr(0, contentType.find(';'))));
+
+        if (mediaType.compare(0, 10, "multipart/") == 0) {
+            const std::string boundary = headerParameter(contentType, "boundary");
+            if (boundary.empty() || depth >= MAX_MIME_DEPTH) {
+                return;
+            }
+            const std::string delimiter = "--" + boundary;
+            size_t partStart = std::string_view::npos;
+            size_t position = 0;
+            while (position < body.size()) {
+                size_t lineEnd = body.find('\n', position);
+                if (lineEnd == std::string_view::npos) {
+                    lineEnd = body.size();
+                }
+                std::string_view line = body.substr(position, lineEnd - position);
+                if (line.compare(0, delimiter.size(), delimiter) == 0) {
+                    if (partStart != std::string_view::npos && position > partStart) {
+                        extractEntity(body.substr(partStart, position - partStart), depth + 1, findings, false);
+                    }
+                    if (line.compare(delimiter.size(), 2, "--") == 0) {
+                        return;  // Closing delimiter
+                    }
+                    partStart = lineEnd + 1;
+                }
+                position = lineEnd + 1;
+            }
+            if (partStart != std::string_view::npos && partStart < body.size()) {
+                extractEntity(body.substr(partStart), depth + 1, findings, false);
+            }
+            return;
+        }
+
+        if (mediaType == "message/rfc822") {
+            if (depth < MAX_MIME_DEPTH) {
+                extractEntity(body, depth + 1, findings, false);
+            }
+            return;
+        }
+
+        const bool html = mediaType == "text/html";
+        if (!mediaType.empty() && mediaType != "text/plain" && !html) {
+            return;  // Attachments and other media
+        }
+
+        std::string decoded;
+        if (headers.transferEncoding == "base64") {
+            decoded = decodeBase64(body);
+        } else if (headers.transferEncoding == "quoted-printable") {
+            decoded = decodeQuotedPrintable(body, false);
+        } else {
+            decoded.assign(body);
+        }
+        decoded = toUtf8(std::move(decoded), headerParameter(contentType, "charset"));
+
+        if (html) {
+            scanText(htmlToText(decoded), findings);
+        } else {
+            scanText(decoded, findings);
+        }
+    }
+
+    bool deliver(std::string& message, bool truncated, ScanStats& stats, const FindingSink& sink) {
+        if (message.empty()) {
+            return true;
+        }
+        ++stats.messages;
+        if (truncated) {
+            ++stats.truncated;
+        }
+
+        MessageFindings findings;
+        const bool found = extractMessage(message.data(), message.size(), findings);
+        message.clear();
+        if (!found) {
+            return true;
+        }
+        ++stats.matched;
+        return sink(std::move(findings));
+    }
+}
+
+bool extractMessage(const char* data, size_t length, MessageFindings& findings) {
+    extractEntity(std::string_view(data, length), 0, findings, true);
+    return !findings.empty();
+}
+
+ScanStats scanMbox(const std::string& path, const FindingSink& sink) {
+    ScanStats stats;
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return stats;
+    }
+    stats.opened = true;
+
+    std::vector<char> buffer(READ_BUFFER_SIZE);
+    std::string message;
+    bool truncated = false;
+    bool previousBlank = true;
+    bool continuation = false;  // Current line started in an earlier buffer
+    bool stopped = false;
+    bool eof = false;
+    size_t filled = 0;
+
+    // Lines starting with "From " after a blank line (or at the start of the
+    // file) separate messages; a file without one is a single message
+    auto handleLine = [&](std::string_view line, bool partial) {
+        if (!continuation && previousBlank && line.compare(0, 5, "From ") == 0) {
+            if (!deliver(message, truncated, stats, sink)) {
+                stopped = true;
+            }
+            truncated = false;
+            previousBlank = false;
+            return;
+        }
+        if (!continuation) {
+            previousBlank = !partial && (line == "\n" || line == "\r\n");
+            // mboxrd: ">From " lines were escaped with one extra '>'
+            size_t quotes = 0;
+            while (quotes < line.size() && line[quotes] == '>') ++quotes;
+            if (quotes > 0 && line.compare(quotes, 5, "From ") == 0) {
+                line.remove_prefix(1);
+            }
+        } else if (partial) {
+            previousBlank = false;
+        }
+
+        const size_t room = MAX_MESSAGE_SIZE - message.size();
+        if (line.size() > room) {
+            truncated = true;
+        }
+        message.append(line.data(), std::min(line.size(), room));
+    };
+
+    while (!stopped) {
+        if (!eof) {
+            const size_t read = std::fread(buffer.data() + filled, 1, buffer.size() - filled, file);
+            filled += read;
+            stats.bytes += read;
+            eof = read == 0;
+        }
+
+        size_t position = 0;
+        while (position < filled && !stopped) {
+            const void* newline = std::memchr(buffer.data() + position, '\n', filled - position);
+            if (!newline && !eof && !(position == 0 && filled == buffer.size())) {
+                break;  // Wait for the rest of the line
+            }
+            const size_t lineEnd = newline ? static_cast<const char*>(newline) - buffer.data() + 1 : filled;
+            handleLine(std::string_view(buffer.data() + position, lineEnd - position), newline == nullptr);
+            continuation = newline == nullptr;
+            position = lineEnd;
+        }
+        std::memmove(buffer.data(), buffer.data() + position, filled - position);
+        filled -= position;
+
+        if (eof && filled == 0) {
+            break;
+        }
+    }
+
+    if (!stopped) {
+        deliver(message, truncated, stats, sink);
+    }
+    std::fclose(file);
+    return stats;
+}
+
+ScanStats scanMaildir(const std::string& path, const FindingSink& sink) {
+    ScanStats stats;
+
+    std::vector<std::string> files;
+    auto listDirectory = [&](const std::string& directory) {
+        DIR* dir = opendir(directory.c_str());
+        if (!dir) {
+            return false;
+        }
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                files.push_back(directory + "/" + entry->d_name);
+            }
+        }
+        closedir(dir);
+        return true;
+    };
+
+    const bool hasCur = listDirectory(path + "/cur");
+    const bool hasNew = listDirectory(path + "/new");
+    if (!hasCur && !hasNew && !listDirectory(path)) {
+        return stats;
+    }
+    stats.opened = true;
+
+    // Maildir names start with the delivery time
+    std::sort(files.begin(), files.end(), [](const std::string& a, const std::string& b) {
+        return a.substr(a.rfind('/') + 1) < b.substr(b.rfind('/') + 1);
+    });
+
+    std::string message;
+    for (const auto& name : files) {
+        struct stat info;
+        if (stat(name.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+            continue;
+        }
+        FILE* file = std::fopen(name.c_str(), "rb");
+        if (!file) {
+            continue;
+        }
+        const size_t size = static_cast<size_t>(info.st_size);
+        message.resize(std::min(size, MAX_MESSAGE_SIZE));
+        const size_t read = std::fread(&message[0], 1, message.size(), file);
+        std::fclose(file);
+        message.resize(read);
+        stats.bytes += read;
+
+        if (!deliver(message, size > MAX_MESSAGE_SIZE, stats, sink)) {
+            break;
+        }
+    }
+    return stats;
+}
+
+ScanStats scanMailbox(const std::string& path, const FindingSink& sink) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return ScanStats();
+    }
+    return S_ISDIR(info.st_mode) ? scanMaildir(path, sink) : scanMbox(path, sink);
+}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace MailExtract {
+    struct MessageFindings {
+        std::string messageId;
+        std::string from;
+        std::string subject;
+        std::string date;
+        std::vector<std::string> codes;           // One-time codes next to a code keyword
+        std::vector<std::string> setupUris;       // Valid otpauth:// and otpauth-migration:// links
+        std::vector<std::string> secrets;         // Base32 keys offered for manual entry
+        std::vector<std::string> activationUrls;  // Verify/confirm/activate links
+
+        bool empty() const {
+            return codes.empty() && setupUris.empty() && secrets.empty() && activationUrls.empty();
+        }
+    };
+
+    struct ScanStats {
+        bool opened = false;
+        uint64_t messages = 0;
+        uint64_t bytes = 0;
+        uint32_t truncated = 0;  // Messages cut at the per-message size cap
+        uint32_t matched = 0;    // Messages with at least one finding
+    };
+
+    // Receives each message with findings; return false to stop the scan
+    using FindingSink = std::function<bool(MessageFindings&&)>;
+
+    /**
+     * Extract codes, setup secrets and activation links from one RFC 822
+     * message. Multipart bodies are walked recursively; text parts are
+     * decoded from base64/quoted-printable, converted to UTF-8 and, for HTML,
+     * reduced to text plus link targets before matching.
+     * @param data Raw message
+     * @param length Message size in bytes
+     * @param findings Filled with the message headers and findings
+     * @return True if anything was found
+     */
+    bool extractMessage(const char* data, size_t length, MessageFindings& findings);
+
+    /**
+     * Stream an mbox file through the extractor with a fixed read buffer.
+     * Memory use is bounded by the per-message cap regardless of file size.
+     */
+    ScanStats scanMbox(const std::string& path, const FindingSink& sink);
+
+    /**
+     * Scan every message of a Maildir (cur/ and new/, oldest first)
+     */
+    ScanStats scanMaildir(const std::string& path, const FindingSink& sink);
+
+    /**
+     * Scan a Maildir if the path is a directory, otherwise an mbox file
+     */
+    ScanStats scanMailbox(const std::string& path, const FindingSink& sink);
+}
@@ -5,10 +5,12 @@
 #include <iomanip>
 #include <sstream>
 #include <stdexcept>
-#include <android/log.h>
+#include "SecureArena.h"
 
 namespace OtpGenerator {
 
+using crypto_native::SecureBytes;
+
 namespace {
     // Base32 alphabet
     constexpr char BASE32_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
@@ -36,10 +38,33 @@ namespace {
         -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
     };
     
-    // Forward declarations
-    void sha1Simple(const uint8_t* data, size_t len, uint8_t* hash);
-    void hmacSha1Fast(const std::vector<uint8_t>& key, const uint8_t* data, size_t dataLen, uint8_t* hash);
-    void md5HashFast(const std::string& input, uint8_t* hash);
+    // Decode a Base32 secret directly into secure memory (no logging of key bytes)
+    SecureBytes decodeKey(const std::string& input) {
+        SecureBytes key;
+        key.reserve((input.size() * 5) / 8 + 1);
+        
+        uint64_t buffer = 0;
+        int bitsLeft = 0;
+        
+        for (char c : input) {
+            if (c == '=') continue; // Padding character
+            int value = BASE32_DECODE_TABLE[static_cast<unsigned char>(c)];
+            if (value < 0) {
+                return {};
+            }
+            
+            buffer = (buffer << 5) | static_cast<uint64_t>(value);
+            bitsLeft += 5;
+            
+            if (bitsLeft >= 8) {
+                key.push_back(static_cast<uint8_t>((buffer >> (bitsLeft - 8)) & 0xFF));
+                bitsLeft -= 8;
+            }
+        }
+        
+        crypto_native::secureWipe(&buffer, sizeof(buffer));
+        return key;
+    }
     
     // Helper function to convert uint64_t to big-endian bytes (optimized)
     inline void uint64ToBytes(uint64_t value, uint8_t* bytes) {
@@ -53,177 +78,480 @@ namespace {
         bytes[7] = static_cast<uint8_t>(value & 0xFF);
     }
     
-    // Simplified but reliable SHA1 implementation
-    void sha1Simple(const uint8_t* data, size_t len, uint8_t* hash) {
-        // Initialize hash values
-        uint32_t h0 = 0x67452301;
-        uint32_t h1 = 0xEFCDAB89;
-        uint32_t h2 = 0x98BADCFE;
-        uint32_t h3 = 0x10325476;
-        uint32_t h4 = 0xC3D2E1F0;
-        
-        // Pre-processing: adding a single 1 bit
-        size_t msgLen = len;
-        size_t bitLen = msgLen * 8;
-        
-        // Calculate padded length
-        size_t paddedLen = msgLen + 1;
-        while (paddedLen % 64 != 56) {
-            paddedLen++;
-        }
-        paddedLen += 8;
-        
-        // Use reasonable buffer size for OTP operations
-        uint8_t paddedData[512]; // Should be enough for most OTP operations
-        if (paddedLen > sizeof(paddedData)) {
-            // Input too large, return zero hash
-            std::memset(hash, 0, 20);
-            return;
+    constexpr size_t SHA1_BLOCK_SIZE = 64;
+    constexpr size_t SHA1_HASH_SIZE = 20;
+    constexpr uint32_t SHA1_INIT[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    // SHA-1 rounds over a generic word type, like the MD5 rounds below:
+    // uint32_t compresses one block, Sha1Lanes four independent blocks
+    typedef uint32_t Sha1Lanes __attribute__((vector_size(16)));
+    constexpr size_t SHA1_LANES = 4;
+
+    template <typename W>
+    inline void sha1Rounds(W state[5], W w[80]) {
+        // Extend the sixteen 32-bit words into eighty 32-bit words
+        for (int i = 16; i < 80; i++) {
+            w[i] = w[i-3] ^ w[i-8] ^ w[i-14] ^ w[i-16];
+            w[i] = (w[i] << 1) | (w[i] >> 31);
         }
         
-        // Copy data and add padding
-        std::memcpy(paddedData, data, msgLen);
-        paddedData[msgLen] = 0x80;
+        // Initialize hash value for this chunk
+        W a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
         
-        // Zero fill
-        for (size_t i = msgLen + 1; i < paddedLen - 8; i++) {
-            paddedData[i] = 0;
+        // One loop per round function, so the body has no branches
+#define SHA1_STEP(f, k) \
+        { \
+            const W temp = ((a << 5) | (a >> 27)) + (f) + e + static_cast<uint32_t>(k) + w[i]; \
+            e = d; \
+            d = c; \
+            c = (b << 30) | (b >> 2); \
+            b = a; \
+            a = temp; \
         }
+        int i = 0;
+        for (; i < 20; i++) SHA1_STEP(d ^ (b & (c ^ d)), 0x5A827999)
+        for (; i < 40; i++) SHA1_STEP(b ^ c ^ d, 0x6ED9EBA1)
+        for (; i < 60; i++) SHA1_STEP((b & c) | (d & (b | c)), 0x8F1BBCDC)
+        for (; i < 80; i++) SHA1_STEP(b ^ c ^ d, 0xCA62C1D6)
+#undef SHA1_STEP
         
-        // Append length as 64-bit big-endian
-        for (int i = 0; i < 8; i++) {
-            paddedData[paddedLen - 8 + i] = (bitLen >> (56 - i * 8)) & 0xFF;
-        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+
+    // SHA-1 compression of one 64-byte block into state
+    void sha1Compress(uint32_t state[5], const uint8_t* block) {
+        uint32_t w[80];
         
-        // Process message in 512-bit chunks
-        for (size_t chunk = 0; chunk < paddedLen; chunk += 64) {
-            uint32_t w[80];
-            
-            // Break chunk into sixteen 32-bit big-endian words
-            for (int i = 0; i < 16; i++) {
-                w[i] = (paddedData[chunk + i * 4] << 24) |
-                       (paddedData[chunk + i * 4 + 1] << 16) |
-                       (paddedData[chunk + i * 4 + 2] << 8) |
-                       paddedData[chunk + i * 4 + 3];
-            }
-            
-            // Extend the sixteen 32-bit words into eighty 32-bit words
-            for (int i = 16; i < 80; i++) {
-                w[i] = w[i-3] ^ w[i-8] ^ w[i-14] ^ w[i-16];
-                w[i] = (w[i] << 1) | (w[i] >> 31);
-            }
-            
-            // Initialize hash value for this chunk
-            uint32_t a = h0, b = h1, c = h2, d = h3, e = h4;
-            
-            // Main loop
-            for (int i = 0; i < 80; i++) {
-                uint32_t f, k;
-                if (i < 20) {
-                    f = (b & c) | (~b & d);
-                    k = 0x5A827999;
-                } else if (i < 40) {
-                    f = b ^ c ^ d;
-                    k = 0x6ED9EBA1;
-                } else if (i < 60) {
-                    f = (b & c) | (b & d) | (c & d);
-                    k = 0x8F1BBCDC;
-                } else {
-                    f = b ^ c ^ d;
-                    k = 0xCA62C1D6;
-                }
-                
-                uint32_t temp = ((a << 5) | (a >> 27)) + f + e + k + w[i];
-                e = d;
-                d = c;
-                c = (b << 30) | (b >> 2);
-                b = a;
-                a = temp;
+        // Break chunk into sixteen 32-bit big-endian words
+        for (int i = 0; i < 16; i++) {
+            w[i] = (static_cast<uint32_t>(block[i * 4]) << 24) |
+                   (static_cast<uint32_t>(block[i * 4 + 1]) << 16) |
+                   (static_cast<uint32_t>(block[i * 4 + 2]) << 8) |
+                   static_cast<uint32_t>(block[i * 4 + 3]);
+        }
+        sha1Rounds(state, w);
+    }
+
+    inline void storeBe32(uint32_t value, uint8_t* out) {
+        out[0] = static_cast<uint8_t>(value >> 24);
+        out[1] = static_cast<uint8_t>(value >> 16);
+        out[2] = static_cast<uint8_t>(value >> 8);
+        out[3] = static_cast<uint8_t>(value);
+    }
+
+    // Streaming SHA-1: full blocks are compressed straight from the
+    // input, only a partial tail is buffered, so any length works
+    struct Sha1Context {
+        uint32_t state[5];
+        uint64_t length;
+        uint8_t buffer[SHA1_BLOCK_SIZE];
+    };
+
+    void sha1Init(Sha1Context& ctx) {
+        std::memcpy(ctx.state, SHA1_INIT, sizeof(ctx.state));
+        ctx.length = 0;
+    }
+
+    void sha1Update(Sha1Context& ctx, const uint8_t* data, size_t len) {
+        size_t used = static_cast<size_t>(ctx.length % SHA1_BLOCK_SIZE);
+        ctx.length += len;
+        if (used > 0) {
+            const size_t take = std::min(len, SHA1_BLOCK_SIZE - used);
+            std::memcpy(ctx.buffer + used, data, take);
+            data += take;
+            len -= take;
+            if (used + take < SHA1_BLOCK_SIZE) {
+                return;
             }
-            
-            // Add this chunk's hash to result so far
-            h0 += a;
-            h1 += b;
-            h2 += c;
-            h3 += d;
-            h4 += e;
+            sha1Compress(ctx.state, ctx.buffer);
         }
-        
-        // Produce the final hash value as a 160-bit number (big-endian)
-        hash[0] = (h0 >> 24) & 0xFF; hash[1] = (h0 >> 16) & 0xFF; hash[2] = (h0 >> 8) & 0xFF; hash[3] = h0 & 0xFF;
-        hash[4] = (h1 >> 24) & 0xFF; hash[5] = (h1 >> 16) & 0xFF; hash[6] = (h1 >> 8) & 0xFF; hash[7] = h1 & 0xFF;
-        hash[8] = (h2 >> 24) & 0xFF; hash[9] = (h2 >> 16) & 0xFF; hash[10] = (h2 >> 8) & 0xFF; hash[11] = h2 & 0xFF;
-        hash[12] = (h3 >> 24) & 0xFF; hash[13] = (h3 >> 16) & 0xFF; hash[14] = (h3 >> 8) & 0xFF; hash[15] = h3 & 0xFF;
-        hash[16] = (h4 >> 24) & 0xFF; hash[17] = (h4 >> 16) & 0xFF; hash[18] = (h4 >> 8) & 0xFF; hash[19] = h4 & 0xFF;
+        for (; len >= SHA1_BLOCK_SIZE; data += SHA1_BLOCK_SIZE, len -= SHA1_BLOCK_SIZE) {
+            sha1Compress(ctx.state, data);
+        }
+        std::memcpy(ctx.buffer, data, len);
+    }
+
+    void sha1Final(Sha1Context& ctx, uint8_t* hash) {
+        const uint64_t bitLength = ctx.length * 8;
+        size_t used = static_cast<size_t>(ctx.length % SHA1_BLOCK_SIZE);
+        ctx.buffer[used++] = 0x80;
+        if (used > SHA1_BLOCK_SIZE - 8) {
+            std::memset(ctx.buffer + used, 0, SHA1_BLOCK_SIZE - used);
+            sha1Compress(ctx.state, ctx.buffer);
+            used = 0;
+        }
+        std::memset(ctx.buffer + used, 0, SHA1_BLOCK_SIZE - 8 - used);
+        storeBe32(static_cast<uint32_t>(bitLength >> 32), ctx.buffer + SHA1_BLOCK_SIZE - 8);
+        storeBe32(static_cast<uint32_t>(bitLength), ctx.buffer + SHA1_BLOCK_SIZE - 4);
+        sha1Compress(ctx.state, ctx.buffer);
+
+        for (int i = 0; i < 5; ++i) {
+            storeBe32(ctx.state[i], hash + i * 4);
+        }
+        crypto_native::secureWipe(&ctx, sizeof(ctx));
     }
     
-    // Simplified HMAC-SHA1 implementation
-    void hmacSha1Fast(const std::vector<uint8_t>& key, const uint8_t* data, size_t dataLen, uint8_t* hash) {
-        const size_t BLOCK_SIZE = 64;
-        const size_t HASH_SIZE = 20;
-        
-        // Prepare the key
-        uint8_t keyPad[BLOCK_SIZE];
-        std::memset(keyPad, 0, BLOCK_SIZE);
-        
-        if (key.size() <= BLOCK_SIZE) {
+    /**
+     * HMAC-SHA1 key reduced to the SHA-1 states after the ipad and opad
+     * blocks. Every HMAC of an 8-byte counter then costs two compressions
+     * instead of four, and the key bytes are not touched again.
+     */
+    struct HmacSha1Key {
+        uint32_t inner[5];
+        uint32_t outer[5];
+    };
+
+    void hmacSha1Prepare(const SecureBytes& key, HmacSha1Key& prepared) {
+        uint8_t keyPad[SHA1_BLOCK_SIZE];
+        std::memset(keyPad, 0, sizeof(keyPad));
+        if (key.size() <= SHA1_BLOCK_SIZE) {
             std::memcpy(keyPad, key.data(), key.size());
         } else {
             // Hash the key if it's too long
-            sha1Simple(key.data(), key.size(), keyPad);
+            Sha1Context ctx;
+            sha1Init(ctx);
+            sha1Update(ctx, key.data(), key.size());
+            sha1Final(ctx, keyPad);
         }
-        
-        // Create inner and outer padded keys
-        uint8_t innerKey[BLOCK_SIZE];
-        uint8_t outerKey[BLOCK_SIZE];
-        
-        for (size_t i = 0; i < BLOCK_SIZE; i++) {
-            innerKey[i] = keyPad[i] ^ 0x36;
-            outerKey[i] = keyPad[i] ^ 0x5C;
+
+        uint8_t pad[SHA1_BLOCK_SIZE];
+        for (size_t i = 0; i < SHA1_BLOCK_SIZE; ++i) {
+            pad[i] = keyPad[i] ^ 0x36;
+        }
+        std::memcpy(prepared.inner, SHA1_INIT, sizeof(prepared.inner));
+        sha1Compress(prepared.inner, pad);
+
+        for (size_t i = 0; i < SHA1_BLOCK_SIZE; ++i) {
+            pad[i] = keyPad[i] ^ 0x5C;
+        }
+        std::memcpy(prepared.outer, SHA1_INIT, sizeof(prepared.outer));
+        sha1Compress(prepared.outer, pad);
+
+        crypto_native::secureWipe(keyPad, sizeof(keyPad));
+        crypto_native::secureWipe(pad, sizeof(pad));
+    }
+
+    // HMAC-SHA1 of a big-endian 64-bit counter from the precomputed midstates
+    void hmacSha1Counter(const HmacSha1Key& key, uint64_t counter, uint8_t* hash) {
+        // Inner: ipad block already absorbed; counter, padding and the
+        // length of (64 + 8) bytes fit the second block
+        uint8_t block[SHA1_BLOCK_SIZE];
+        uint32_t state[5];
+        std::memset(block, 0, sizeof(block));
+        uint64ToBytes(counter, block);
+        block[8] = 0x80;
+        block[62] = static_cast<uint8_t>(((SHA1_BLOCK_SIZE + 8) * 8) >> 8);
+        block[63] = static_cast<uint8_t>((SHA1_BLOCK_SIZE + 8) * 8);
+        std::memcpy(state, key.inner, sizeof(state));
+        sha1Compress(state, block);
+
+        // Outer: the inner digest, padding and the length of (64 + 20) bytes
+        std::memset(block, 0, sizeof(block));
+        for (int i = 0; i < 5; ++i) {
+            storeBe32(state[i], block + i * 4);
+        }
+        block[SHA1_HASH_SIZE] = 0x80;
+        block[62] = static_cast<uint8_t>(((SHA1_BLOCK_SIZE + SHA1_HASH_SIZE) * 8) >> 8);
+        block[63] = static_cast<uint8_t>((SHA1_BLOCK_SIZE + SHA1_HASH_SIZE) * 8);
+        std::memcpy(state, key.outer, sizeof(state));
+        sha1Compress(state, block);
+
+        for (int i = 0; i < 5; ++i) {
+            storeBe32(state[i], hash + i * 4);
+        }
+        crypto_native::secureWipe(block, sizeof(block));
+        crypto_native::secureWipe(state, sizeof(state));
+    }
+
+    // Working state of hmacSha1CounterLanes. Callers own it and wipe it
+    // once after their whole scan rather than after every call.
+    struct Sha1LaneScratch {
+        Sha1Lanes state[5];
+        Sha1Lanes w[80];
+    };
+
+    /**
+     * hmacSha1Counter for four (key, counter) pairs at once. The padded
+     * blocks of a counter HMAC are fixed apart from the counter and the
+     * inner digest, so they are built directly as words.
+     */
+    void hmacSha1CounterLanes(const HmacSha1Key* const keys[SHA1_LANES], const uint64_t counters[SHA1_LANES],
+                              uint8_t hashes[SHA1_LANES][SHA1_HASH_SIZE], Sha1LaneScratch& scratch) {
+        Sha1Lanes* state = scratch.state;
+        Sha1Lanes* w = scratch.w;
+        for (size_t lane = 0; lane < SHA1_LANES; ++lane) {
+            for (int i = 0; i < 5; ++i) {
+                state[i][lane] = keys[lane]->inner[i];
+            }
+            w[0][lane] = static_cast<uint32_t>(counters[lane] >> 32);
+            w[1][lane] = static_cast<uint32_t>(counters[lane]);
+        }
+        w[2] = Sha1Lanes{} + 0x80000000u;
+        for (int i = 3; i < 15; ++i) {
+            w[i] = Sha1Lanes{};
+        }
+        w[15] = Sha1Lanes{} + static_cast<uint32_t>((SHA1_BLOCK_SIZE + 8) * 8);
+        sha1Rounds(state, w);
+
+        for (int i = 0; i < 5; ++i) {
+            w[i] = state[i];
+        }
+        w[5] = Sha1Lanes{} + 0x80000000u;
+        for (int i = 6; i < 15; ++i) {
+            w[i] = Sha1Lanes{};
+        }
+        w[15] = Sha1Lanes{} + static_cast<uint32_t>((SHA1_BLOCK_SIZE + SHA1_HASH_SIZE) * 8);
+        for (size_t lane = 0; lane < SHA1_LANES; ++lane) {
+            for (int i = 0; i < 5; ++i) {
+                state[i][lane] = keys[lane]->outer[i];
+            }
+        }
+        sha1Rounds(state, w);
+
+        for (size_t lane = 0; lane < SHA1_LANES; ++lane) {
+            for (int i = 0; i < 5; ++i) {
+                storeBe32(state[i][lane], hashes[lane] + i * 4);
+            }
+        }
+    }
+
+    // RFC 4226 dynamic truncation to a 31-bit value
+    inline uint32_t truncateHash(const uint8_t* hash) {
+        const int offset = hash[SHA1_HASH_SIZE - 1] & 0x0F;
+        return (static_cast<uint32_t>(hash[offset] & 0x7F) << 24) |
+               (static_cast<uint32_t>(hash[offset + 1]) << 16) |
+               (static_cast<uint32_t>(hash[offset + 2]) << 8) |
+               static_cast<uint32_t>(hash[offset + 3]);
+    }
+
+    // Output encoders over the truncated value; out needs digits (or 5) chars
+    inline void encodeDecimal(uint32_t value, int digits, char* out) {
+        for (int i = digits - 1; i >= 0; --i) {
+            out[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    }
+
+    constexpr int STEAM_CODE_LENGTH = 5;
+    constexpr uint32_t STEAM_ALPHABET_SIZE = sizeof(STEAM_ALPHABET) - 1;
+
+    inline void encodeSteam(uint32_t value, char* out) {
+        for (int i = 0; i < STEAM_CODE_LENGTH; ++i) {
+            out[i] = STEAM_ALPHABET[value % STEAM_ALPHABET_SIZE];
+            value /= STEAM_ALPHABET_SIZE;
         }
-        
-        // Calculate inner hash
-        uint8_t innerData[BLOCK_SIZE + 8]; // Should be enough for counter data
-        std::memcpy(innerData, innerKey, BLOCK_SIZE);
-        std::memcpy(innerData + BLOCK_SIZE, data, dataLen);
-        
-        uint8_t innerHash[HASH_SIZE];
-        sha1Simple(innerData, BLOCK_SIZE + dataLen, innerHash);
-        
-        // Calculate outer hash
-        uint8_t outerData[BLOCK_SIZE + HASH_SIZE];
-        std::memcpy(outerData, outerKey, BLOCK_SIZE);
-        std::memcpy(outerData + BLOCK_SIZE, innerHash, HASH_SIZE);
-        
-        sha1Simple(outerData, BLOCK_SIZE + HASH_SIZE, hash);
     }
     
-    // Fast MD5-like hash for mOTP (optimized)
-    void md5HashFast(const std::string& input, uint8_t* hash) {
-        uint32_t h[4] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476};
-        
-        // Process input string
-        for (size_t i = 0; i < input.length(); ++i) {
-            uint32_t w = static_cast<uint8_t>(input[i]);
-            
-            // Simplified MD5-like round
-            uint32_t f = (h[1] & h[2]) | (~h[1] & h[3]);
-            uint32_t temp = h[0] + f + w + 0xD76AA478;
-            temp = ((temp << 7) | (temp >> 25)) + h[1];
-            
-            // Rotate registers
-            h[0] = h[3];
-            h[3] = h[2];
-            h[2] = h[1];
-            h[1] = temp;
+    // MD5 (RFC 1321) for mOTP. The unrolled rounds are written once over a
+    // generic word type: uint32_t hashes one message, Md5Lanes hashes four
+    // independent single-block messages side by side (NEON/SSE through the
+    // compiler's vector extensions).
+    typedef uint32_t Md5Lanes __attribute__((vector_size(16)));
+    constexpr size_t MD5_LANES = 4;
+    constexpr size_t MD5_BLOCK_SIZE = 64;
+    constexpr uint32_t MD5_INIT[4] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476};
+
+    template <typename W> inline W md5F(W x, W y, W z) { return z ^ (x & (y ^ z)); }
+    template <typename W> inline W md5G(W x, W y, W z) { return y ^ (z & (x ^ y)); }
+    template <typename W> inline W md5H(W x, W y, W z) { return x ^ y ^ z; }
+    template <typename W> inline W md5I(W x, W y, W z) { return y ^ (x | ~z); }
+
+#define MD5_STEP(f, a, b, c, d, x, t, s) \
+    (a) += f((b), (c), (d)) + (x) + static_cast<uint32_t>(t); \
+    (a) = (((a) << (s)) | ((a) >> (32 - (s)))) + (b)
+
+    template <typename W>
+    inline void md5Rounds(W state[4], const W x[16]) {
+        W a = state[0];
+        W b = state[1];
+        W c = state[2];
+        W d = state[3];
+
+        MD5_STEP(md5F, a, b, c, d, x[0], 0xd76aa478, 7);
+        MD5_STEP(md5F, d, a, b, c, x[1], 0xe8c7b756, 12);
+        MD5_STEP(md5F, c, d, a, b, x[2], 0x242070db, 17);
+        MD5_STEP(md5F, b, c, d, a, x[3], 0xc1bdceee, 22);
+        MD5_STEP(md5F, a, b, c, d, x[4], 0xf57c0faf, 7);
+        MD5_STEP(md5F, d, a, b, c, x[5], 0x4787c62a, 12);
+        MD5_STEP(md5F, c, d, a, b, x[6], 0xa8304613, 17);
+        MD5_STEP(md5F, b, c, d, a, x[7], 0xfd469501, 22);
+        MD5_STEP(md5F, a, b, c, d, x[8], 0x698098d8, 7);
+        MD5_STEP(md5F, d, a, b, c, x[9], 0x8b44f7af, 12);
+        MD5_STEP(md5F, c, d, a, b, x[10], 0xffff5bb1, 17);
+        MD5_STEP(md5F, b, c, d, a, x[11], 0x895cd7be, 22);
+        MD5_STEP(md5F, a, b, c, d, x[12], 0x6b901122, 7);
+        MD5_STEP(md5F, d, a, b, c, x[13], 0xfd987193, 12);
+        MD5_STEP(md5F, c, d, a, b, x[14], 0xa679438e, 17);
+        MD5_STEP(md5F, b, c, d, a, x[15], 0x49b40821, 22);
+
+        MD5_STEP(md5G, a, b, c, d, x[1], 0xf61e2562, 5);
+        MD5_STEP(md5G, d, a, b, c, x[6], 0xc040b340, 9);
+        MD5_STEP(md5G, c, d, a, b, x[11], 0x265e5a51, 14);
+        MD5_STEP(md5G, b, c, d, a, x[0], 0xe9b6c7aa, 20);
+        MD5_STEP(md5G, a, b, c, d, x[5], 0xd62f105d, 5);
+        MD5_STEP(md5G, d, a, b, c, x[10], 0x02441453, 9);
+        MD5_STEP(md5G, c, d, a, b, x[15], 0xd8a1e681, 14);
+        MD5_STEP(md5G, b, c, d, a, x[4], 0xe7d3fbc8, 20);
+        MD5_STEP(md5G, a, b, c, d, x[9], 0x21e1cde6, 5);
+        MD5_STEP(md5G, d, a, b, c, x[14], 0xc33707d6, 9);
+        MD5_STEP(md5G, c, d, a, b, x[3], 0xf4d50d87, 14);
+        MD5_STEP(md5G, b, c, d, a, x[8], 0x455a14ed, 20);
+        MD5_STEP(md5G, a, b, c, d, x[13], 0xa9e3e905, 5);
+        MD5_STEP(md5G, d, a, b, c, x[2], 0xfcefa3f8, 9);
+        MD5_STEP(md5G, c, d, a, b, x[7], 0x676f02d9, 14);
+        MD5_STEP(md5G, b, c, d, a, x[12], 0x8d2a4c8a, 20);
+
+        MD5_STEP(md5H, a, b, c, d, x[5], 0xfffa3942, 4);
+        MD5_STEP(md5H, d, a, b, c, x[8], 0x8771f681, 11);
+        MD5_STEP(md5H, c, d, a, b, x[11], 0x6d9d6122, 16);
+        MD5_STEP(md5H, b, c, d, a, x[14], 0xfde5380c, 23);
+        MD5_STEP(md5H, a, b, c, d, x[1], 0xa4beea44, 4);
+        MD5_STEP(md5H, d, a, b, c, x[4], 0x4bdecfa9, 11);
+        MD5_STEP(md5H, c, d, a, b, x[7], 0xf6bb4b60, 16);
+        MD5_STEP(md5H, b, c, d, a, x[10], 0xbebfbc70, 23);
+        MD5_STEP(md5H, a, b, c, d, x[13], 0x289b7ec6, 4);
+        MD5_STEP(md5H, d, a, b, c, x[0], 0xeaa127fa, 11);
+        MD5_STEP(md5H, c, d, a, b, x[3], 0xd4ef3085, 16);
+        MD5_STEP(md5H, b, c, d, a, x[6], 0x04881d05, 23);
+        MD5_STEP(md5H, a, b, c, d, x[9], 0xd9d4d039, 4);
+        MD5_STEP(md5H, d, a, b, c, x[12], 0xe6db99e5, 11);
+        MD5_STEP(md5H, c, d, a, b, x[15], 0x1fa27cf8, 16);
+        MD5_STEP(md5H, b, c, d, a, x[2], 0xc4ac5665, 23);
+
+        MD5_STEP(md5I, a, b, c, d, x[0], 0xf4292244, 6);
+        MD5_STEP(md5I, d, a, b, c, x[7], 0x432aff97, 10);
+        MD5_STEP(md5I, c, d, a, b, x[14], 0xab9423a7, 15);
+        MD5_STEP(md5I, b, c, d, a, x[5], 0xfc93a039, 21);
+        MD5_STEP(md5I, a, b, c, d, x[12], 0x655b59c3, 6);
+        MD5_STEP(md5I, d, a, b, c, x[3], 0x8f0ccc92, 10);
+        MD5_STEP(md5I, c, d, a, b, x[10], 0xffeff47d, 15);
+        MD5_STEP(md5I, b, c, d, a, x[1], 0x85845dd1, 21);
+        MD5_STEP(md5I, a, b, c, d, x[8], 0x6fa87e4f, 6);
+        MD5_STEP(md5I, d, a, b, c, x[15], 0xfe2ce6e0, 10);
+        MD5_STEP(md5I, c, d, a, b, x[6], 0xa3014314, 15);
+        MD5_STEP(md5I, b, c, d, a, x[13], 0x4e0811a1, 21);
+        MD5_STEP(md5I, a, b, c, d, x[4], 0xf7537e82, 6);
+        MD5_STEP(md5I, d, a, b, c, x[11], 0xbd3af235, 10);
+        MD5_STEP(md5I, c, d, a, b, x[2], 0x2ad7d2bb, 15);
+        MD5_STEP(md5I, b, c, d, a, x[9], 0xeb86d391, 21);
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+    }
+
+#undef MD5_STEP
+
+    inline uint32_t loadLe32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    inline void md5Block(uint32_t state[4], const uint8_t* block) {
+        uint32_t x[16];
+        for (int i = 0; i < 16; ++i) {
+            x[i] = loadLe32(block + i * 4);
         }
-        
-        // Convert to 16 bytes (little-endian for MD5)
+        md5Rounds(state, x);
+    }
+
+    // Streaming MD5; full blocks are compressed straight from the input
+    struct Md5Context {
+        uint32_t state[4];
+        uint64_t length;
+        uint8_t buffer[MD5_BLOCK_SIZE];
+    };
+
+    void md5Init(Md5Context& ctx) {
+        std::memcpy(ctx.state, MD5_INIT, sizeof(ctx.state));
+        ctx.length = 0;
+    }
+
+    void md5Update(Md5Context& ctx, const uint8_t* data, size_t len) {
+        size_t used = static_cast<size_t>(ctx.length % MD5_BLOCK_SIZE);
+        ctx.length += len;
+        if (used > 0) {
+            const size_t take = std::min(len, MD5_BLOCK_SIZE - used);
+            std::memcpy(ctx.buffer + used, data, take);
+            data += take;
+            len -= take;
+            if (used + take < MD5_BLOCK_SIZE) {
+                return;
+            }
+            md5Block(ctx.state, ctx.buffer);
+        }
+        for (; len >= MD5_BLOCK_SIZE; data += MD5_BLOCK_SIZE, len -= MD5_BLOCK_SIZE) {
+            md5Block(ctx.state, data);
+        }
+        std::memcpy(ctx.buffer, data, len);
+    }
+
+    void md5Final(Md5Context& ctx, uint8_t* hash) {
+        const uint64_t bitLength = ctx.length * 8;
+        size_t used = static_cast<size_t>(ctx.length % MD5_BLOCK_SIZE);
+        ctx.buffer[used++] = 0x80;
+        if (used > MD5_BLOCK_SIZE - 8) {
+            std::memset(ctx.buffer + used, 0, MD5_BLOCK_SIZE - used);
+            md5Block(ctx.state, ctx.buffer);
+            used = 0;
+        }
+        std::memset(ctx.buffer + used, 0, MD5_BLOCK_SIZE - 8 - used);
+        for (int i = 0; i < 8; ++i) {
+            ctx.buffer[MD5_BLOCK_SIZE - 8 + i] = static_cast<uint8_t>(bitLength >> (8 * i));
+        }
+        md5Block(ctx.state, ctx.buffer);
+
         for (int i = 0; i < 4; ++i) {
-            hash[i * 4] = static_cast<uint8_t>(h[i] & 0xFF);
-            hash[i * 4 + 1] = static_cast<uint8_t>((h[i] >> 8) & 0xFF);
-            hash[i * 4 + 2] = static_cast<uint8_t>((h[i] >> 16) & 0xFF);
-            hash[i * 4 + 3] = static_cast<uint8_t>((h[i] >> 24) & 0xFF);
+            hash[i * 4] = static_cast<uint8_t>(ctx.state[i]);
+            hash[i * 4 + 1] = static_cast<uint8_t>(ctx.state[i] >> 8);
+            hash[i * 4 + 2] = static_cast<uint8_t>(ctx.state[i] >> 16);
+            hash[i * 4 + 3] = static_cast<uint8_t>(ctx.state[i] >> 24);
+        }
+        crypto_native::secureWipe(&ctx, sizeof(ctx));
+    }
+
+    // Decimal digits of value without a terminator; returns the length
+    size_t formatDecimal(uint64_t value, char* out) {
+        char reversed[20];
+        size_t length = 0;
+        do {
+            reversed[length++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        for (size_t i = 0; i < length; ++i) {
+            out[i] = reversed[length - 1 - i];
+        }
+        return length;
+    }
+
+    // Reference mOTP: md5(counter + secret + pin), first three bytes as hex
+    void motpHash(const std::string& secret, const std::string& pin, uint64_t counter, uint8_t* hash) {
+        char digits[20];
+        const size_t digitCount = formatDecimal(counter, digits);
+
+        Md5Context ctx;
+        md5Init(ctx);
+        md5Update(ctx, reinterpret_cast<const uint8_t*>(digits), digitCount);
+        md5Update(ctx, reinterpret_cast<const uint8_t*>(secret.data()), secret.size());
+        md5Update(ctx, reinterpret_cast<const uint8_t*>(pin.data()), pin.size());
+        md5Final(ctx, hash);
+    }
+
+    inline bool isSha1(const std::string& algorithm) {
+        return algorithm.size() == 4 && (algorithm[0] | 0x20) == 's' && (algorithm[1] | 0x20) == 'h' &&
+               (algorithm[2] | 0x20) == 'a' && algorithm[3] == '1';
+    }
+
+    inline void motpFormat(const uint8_t* hash, char* out) {
+        static const char HEX[] = "0123456789abcdef";
+        for (int i = 0; i < 3; ++i) {
+            out[i * 2] = HEX[hash[i] >> 4];
+            out[i * 2 + 1] = HEX[hash[i] & 0x0F];
         }
     }
 }
@@ -238,11 +566,8 @@ std::string generateTOTP(const std::string& secret, uint64_t timeSlot, int digit
 
 std::string generateHOTP(const std::string& secret, uint64_t counter, int digits, const std::string& algorithm) {
     try {
-        __android_log_print(ANDROID_LOG_DEBUG, "OtpGenerator", "generateHOTP called with secret length: %zu, counter: %llu, digits: %d, algorithm: %s", secret.length(), counter, digits, algorithm.c_str());
-        
         // Quick validation
         if (secret.empty() || digits < 4 || digits > 9) {
-            __android_log_print(ANDROID_LOG_ERROR, "OtpGenerator", "generateHOTP: validation failed - empty secret or invalid digits (must be 4-9)");
             return "";
         }
 
@@ -251,65 +576,28 @@ std::string generateHOTP(const std::string& secret, uint64_t counter, int digits
         std::transform(upper_algorithm.begin(), upper_algorithm.end(), upper_algorithm.begin(), 
                        [](unsigned char c){ return std::toupper(c); });
         if (upper_algorithm != "SHA1") {
-            __android_log_print(ANDROID_LOG_ERROR, "OtpGenerator", "generateHOTP: unsupported algorithm '%s'. Only SHA1 is currently supported.", algorithm.c_str());
             return "";
         }
         
-        // For now, let's return a simple test code to verify the function is being called
-        if (secret == "GEZDGNBVGY3TQOJQGEZDGNBVGY3TQOJQ" && counter == 1) {
-            __android_log_print(ANDROID_LOG_DEBUG, "OtpGenerator", "generateHOTP: returning test vector result for SHA1, 6 digits");
-            return "287082";
-        }
-        
-        // Decode the secret (optimized)
-        std::vector<uint8_t> key = base32Decode(secret);
+        // Decode the secret straight into secure memory
+        SecureBytes key = decodeKey(secret);
         if (key.empty()) {
-            // Add debug logging for base32 decode failure
-            __android_log_print(ANDROID_LOG_ERROR, "OtpGenerator", "base32Decode returned empty for secret: %s", secret.substr(0, 4).c_str());
             return "";
         }
         
-        __android_log_print(ANDROID_LOG_DEBUG, "OtpGenerator", "base32Decode success, key size: %zu", key.size());
-        
-        // Convert counter to big-endian bytes (stack allocated)
-        uint8_t counterBytes[8];
-        uint64ToBytes(counter, counterBytes);
-        
-        __android_log_print(ANDROID_LOG_DEBUG, "OtpGenerator", "Counter bytes: %02x %02x %02x %02x %02x %02x %02x %02x", 
-                           counterBytes[0], counterBytes[1], counterBytes[2], counterBytes[3],
-                           counterBytes[4], counterBytes[5], counterBytes[6], counterBytes[7]);
-        
-        // Calculate HMAC (optimized)
-        uint8_t hash[20];
-        hmacSha1Fast(key, counterBytes, 8, hash);
-        
-        __android_log_print(ANDROID_LOG_DEBUG, "OtpGenerator", "HMAC hash first 4 bytes: %02x %02x %02x %02x", 
-                           hash[0], hash[1], hash[2], hash[3]);
-        
-        // Dynamic truncation
-        int offset = hash[19] & 0x0F;
-        uint32_t code = ((hash[offset] & 0x7F) << 24) |
-                       ((hash[offset + 1] & 0xFF) << 16) |
-                       ((hash[offset + 2] & 0xFF) << 8) |
-                       (hash[offset + 3] & 0xFF);
-        
-        __android_log_print(ANDROID_LOG_DEBUG, "OtpGenerator", "Offset: %d, Raw code: %u", offset, code);
-        
-        // Generate the final code (optimized)
-        static const uint32_t modulus[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
-        code %= modulus[digits];
+        // Key the HMAC once; the counter then costs two compressions
+        HmacSha1Key prepared;
+        hmacSha1Prepare(key, prepared);
+        uint8_t hash[SHA1_HASH_SIZE];
+        hmacSha1Counter(prepared, counter, hash);
         
-        __android_log_print(ANDROID_LOG_DEBUG, "OtpGenerator", "Final code: %u", code);
+        char result[9];
+        encodeDecimal(truncateHash(hash), digits, result);
+        crypto_native::secureWipe(&prepared, sizeof(prepared));
+        crypto_native::secureWipe(hash, sizeof(hash));
         
-        // Format with leading zeros (optimized)
-        char result[11];
-        snprintf(result, sizeof(result), "%0*u", digits, code);
-        
-        __android_log_print(ANDROID_LOG_DEBUG, "OtpGenerator", "Formatted result: %s", result);
-        
-        return std::string(result);
-    } catch (const std::exception& e) {
-        __android_log_print(ANDROID_LOG_ERROR, "OtpGenerator", "Exception in generateHOTP: %s", e.what());
+        return std::string(result, digits);
+    } catch (const std::exception&) {
         return "";
     }
 }
@@ -319,32 +607,99 @@ std::string generateMOTP(const std::string& secret, const std::string& pin, uint
 }
 
 std::string generateMOTPWithPeriod(const std::string& secret, const std::string& pin, uint64_t timeSlot, int period) {
-    try {
-        // Quick validation
-        if (secret.empty() || pin.empty() || period <= 0) {
-            return "";
-        }
-        
-        // Calculate time period
-        uint64_t timePeriod = timeSlot / period;
-        
-        // Create input string: secret + pin + time_period (optimized)
-        std::string input;
-        input.reserve(secret.length() + pin.length() + 20);
-        input = secret + pin + std::to_string(timePeriod);
-        
-        // Calculate MD5 hash (optimized)
-        uint8_t hash[16];
-        md5HashFast(input, hash);
-        
-        // Take first 6 characters as hex (optimized)
-        char result[7];
-        snprintf(result, sizeof(result), "%02x%02x%02x", hash[0], hash[1], hash[2]);
-        
-        return std::string(result);
-    } catch (const std::exception&) {
+    // Quick validation
+    if (secret.empty() || pin.empty() || period <= 0) {
         return "";
     }
+
+    uint8_t hash[16];
+    motpHash(secret, pin, timeSlot / period, hash);
+
+    char result[6];
+    motpFormat(hash, result);
+    crypto_native::secureWipe(hash, sizeof(hash));
+    return std::string(result, sizeof(result));
+}
+
+std::vector<std::string> generateMOTPBatch(const std::vector<MotpRequest>& requests) {
+    std::vector<std::string> codes(requests.size());
+
+    // Messages that fit one padded block are hashed four at a time; the
+    // rest (long secrets) take the streaming path
+    size_t laneIndex[MD5_LANES];
+    uint8_t blocks[MD5_LANES][MD5_BLOCK_SIZE];
+    size_t lanes = 0;
+    uint8_t hash[16];
+    char code[6];
+
+    auto flush = [&]() {
+        Md5Lanes state[4];
+        Md5Lanes x[16];
+        for (int i = 0; i < 4; ++i) {
+            for (size_t lane = 0; lane < MD5_LANES; ++lane) {
+                state[i][lane] = MD5_INIT[i];
+            }
+        }
+        for (int i = 0; i < 16; ++i) {
+            for (size_t lane = 0; lane < MD5_LANES; ++lane) {
+                x[i][lane] = loadLe32(blocks[lane] + i * 4);
+            }
+        }
+        md5Rounds(state, x);
+
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            const uint32_t a = state[0][lane];
+            hash[0] = static_cast<uint8_t>(a);
+            hash[1] = static_cast<uint8_t>(a >> 8);
+            hash[2] = static_cast<uint8_t>(a >> 16);
+            motpFormat(hash, code);
+            codes[laneIndex[lane]].assign(code, sizeof(code));
+        }
+        crypto_native::secureWipe(state, sizeof(state));
+        crypto_native::secureWipe(x, sizeof(x));
+        lanes = 0;
+    };
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const MotpRequest& request = requests[i];
+        if (!request.secret || !request.pin || request.secret->empty() || request.pin->empty()) {
+            continue;
+        }
+
+        char digits[20];
+        const size_t digitCount = formatDecimal(request.counter, digits);
+        const size_t length = digitCount + request.secret->size() + request.pin->size();
+        if (length > MD5_BLOCK_SIZE - 9) {
+            motpHash(*request.secret, *request.pin, request.counter, hash);
+            motpFormat(hash, code);
+            codes[i].assign(code, sizeof(code));
+            continue;
+        }
+
+        uint8_t* block = blocks[lanes];
+        std::memcpy(block, digits, digitCount);
+        std::memcpy(block + digitCount, request.secret->data(), request.secret->size());
+        std::memcpy(block + digitCount + request.secret->size(), request.pin->data(), request.pin->size());
+        block[length] = 0x80;
+        std::memset(block + length + 1, 0, MD5_BLOCK_SIZE - 8 - length - 1);
+        const uint64_t bitLength = static_cast<uint64_t>(length) * 8;
+        for (int b = 0; b < 8; ++b) {
+            block[MD5_BLOCK_SIZE - 8 + b] = static_cast<uint8_t>(bitLength >> (8 * b));
+        }
+
+        laneIndex[lanes++] = i;
+        if (lanes == MD5_LANES) {
+            flush();
+        }
+    }
+    if (lanes > 0) {
+        // Unused lanes hash stale blocks; their results are discarded
+        flush();
+    }
+
+    crypto_native::secureWipe(blocks, sizeof(blocks));
+    crypto_native::secureWipe(hash, sizeof(hash));
+    return codes;
 }
 
 std::string generateSteamGuard(const std::string& secret, uint64_t timeSlot) {
@@ -354,34 +709,180 @@ std::string generateSteamGuard(const std::string& secret, uint64_t timeSlot) {
             return "";
         }
         
-        // Decode the secret (optimized)
-        std::vector<uint8_t> key = base32Decode(secret);
+        // Decode the secret straight into secure memory
+        SecureBytes key = decodeKey(secret);
         if (key.empty()) {
             return "";
         }
         
-        // Convert time slot to big-endian bytes (stack allocated)
-        uint8_t timeBytes[8];
-        uint64ToBytes(timeSlot, timeBytes);
+        // Same keyed HMAC-SHA1 and truncation as TOTP; only the encoding differs
+        HmacSha1Key prepared;
+        hmacSha1Prepare(key, prepared);
+        uint8_t hash[SHA1_HASH_SIZE];
+        hmacSha1Counter(prepared, timeSlot, hash);
         
-        // Calculate HMAC (optimized)
-        uint8_t hash[20];
-        hmacSha1Fast(key, timeBytes, 8, hash);
-        
-        // Steam Guard uses a different alphabet and 5 characters (optimized)
-        char code[6];
-        for (int i = 0; i < 5; ++i) {
-            int index = hash[i] % 25; // 25 characters in STEAM_ALPHABET
-            code[i] = STEAM_ALPHABET[index];
-        }
-        code[5] = '\0';
+        char code[STEAM_CODE_LENGTH];
+        encodeSteam(truncateHash(hash), code);
+        crypto_native::secureWipe(&prepared, sizeof(prepared));
+        crypto_native::secureWipe(hash, sizeof(hash));
         
-        return std::string(code);
+        return std::string(code, sizeof(code));
     } catch (const std::exception&) {
         return "";
     }
 }
 
+std::vector<std::string> generateOTPBatch(const std::vector<OtpRequest>& requests) {
+    std::vector<std::string> codes(requests.size());
+    HmacSha1Key prepared;
+    const std::string* preparedSecret = nullptr;
+    bool keyValid = false;
+
+    // Requests are HMACed four at a time; each lane carries its own copy
+    // of the keyed midstates, so lanes may mix accounts
+    HmacSha1Key laneKeys[SHA1_LANES];
+    const HmacSha1Key* laneKeyPtrs[SHA1_LANES];
+    uint64_t laneCounters[SHA1_LANES] = {};
+    size_t laneIndex[SHA1_LANES];
+    uint8_t hashes[SHA1_LANES][SHA1_HASH_SIZE];
+    Sha1LaneScratch scratch;
+    size_t lanes = 0;
+    char code[9];
+
+    for (size_t lane = 0; lane < SHA1_LANES; ++lane) {
+        laneKeyPtrs[lane] = &laneKeys[lane];
+    }
+
+    auto flush = [&]() {
+        hmacSha1CounterLanes(laneKeyPtrs, laneCounters, hashes, scratch);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            const OtpRequest& request = requests[laneIndex[lane]];
+            const uint32_t value = truncateHash(hashes[lane]);
+            if (request.encoding == OtpEncoding::STEAM) {
+                encodeSteam(value, code);
+                codes[laneIndex[lane]].assign(code, STEAM_CODE_LENGTH);
+            } else {
+                encodeDecimal(value, request.digits, code);
+                codes[laneIndex[lane]].assign(code, request.digits);
+            }
+        }
+        lanes = 0;
+    };
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const OtpRequest& request = requests[i];
+        if (!request.secret || request.secret->empty()) {
+            continue;
+        }
+        if (request.encoding == OtpEncoding::DECIMAL && (request.digits < 4 || request.digits > 9)) {
+            continue;
+        }
+
+        // Consecutive requests for the same secret reuse the keyed midstates
+        if (request.secret != preparedSecret) {
+            preparedSecret = request.secret;
+            SecureBytes key = decodeKey(*request.secret);
+            keyValid = !key.empty();
+            if (keyValid) {
+                hmacSha1Prepare(key, prepared);
+            }
+        }
+        if (!keyValid) {
+            continue;
+        }
+
+        laneKeys[lanes] = prepared;
+        laneCounters[lanes] = request.counter;
+        laneIndex[lanes++] = i;
+        if (lanes == SHA1_LANES) {
+            flush();
+        }
+    }
+    if (lanes > 0) {
+        // Unused lanes hash stale keys and counters; their results are discarded
+        flush();
+    }
+
+    crypto_native::secureWipe(&prepared, sizeof(prepared));
+    crypto_native::secureWipe(laneKeys, sizeof(laneKeys));
+    crypto_native::secureWipe(hashes, sizeof(hashes));
+    crypto_native::secureWipe(&scratch, sizeof(scratch));
+    crypto_native::secureWipe(code, sizeof(code));
+    return codes;
+}
+
+int64_t resyncHOTP(const std::string& secret, uint64_t counter, const std::vector<std::string>& codes,
+                   int window, int digits, const std::string& algorithm) {
+    if (secret.empty() || codes.empty() || codes.size() > 2 || window <= 0 || digits < 4 || digits > 9 ||
+        !isSha1(algorithm)) {
+        return -1;
+    }
+
+    // Compare truncated values instead of formatted strings
+    uint32_t modulus = 1;
+    for (int i = 0; i < digits; ++i) {
+        modulus *= 10;
+    }
+    uint32_t observed[2] = {};
+    for (size_t k = 0; k < codes.size(); ++k) {
+        if (codes[k].size() != static_cast<size_t>(digits)) {
+            return -1;
+        }
+        for (char c : codes[k]) {
+            if (c < '0' || c > '9') {
+                return -1;
+            }
+            observed[k] = observed[k] * 10 + static_cast<uint32_t>(c - '0');
+        }
+    }
+
+    SecureBytes key = decodeKey(secret);
+    if (key.empty()) {
+        return -1;
+    }
+    HmacSha1Key prepared;
+    hmacSha1Prepare(key, prepared);
+    const HmacSha1Key* keyPtrs[SHA1_LANES] = {&prepared, &prepared, &prepared, &prepared};
+
+    // A pair matches at c when the second code is c + 1, so the scan runs
+    // one counter past the window
+    const uint64_t end = counter + static_cast<uint64_t>(window) + (codes.size() - 1);
+    uint64_t laneCounters[SHA1_LANES];
+    uint8_t hashes[SHA1_LANES][SHA1_HASH_SIZE];
+    Sha1LaneScratch scratch;
+    bool previousMatched = false;
+    int64_t result = -1;
+
+    for (uint64_t base = counter; base < end && result < 0; base += SHA1_LANES) {
+        for (size_t lane = 0; lane < SHA1_LANES; ++lane) {
+            laneCounters[lane] = base + lane;
+        }
+        hmacSha1CounterLanes(keyPtrs, laneCounters, hashes, scratch);
+
+        for (size_t lane = 0; lane < SHA1_LANES && base + lane < end; ++lane) {
+            const uint32_t value = truncateHash(hashes[lane]) % modulus;
+            if (codes.size() == 1) {
+                if (value == observed[0]) {
+                    result = static_cast<int64_t>(base + lane + 1);
+                    break;
+                }
+                continue;
+            }
+            if (previousMatched && value == observed[1]) {
+                result = static_cast<int64_t>(base + lane + 1);
+                break;
+            }
+            previousMatched = value == observed[0] && base + lane < end - 1;
+        }
+    }
+
+    crypto_native::secureWipe(&prepared, sizeof(prepared));
+    crypto_native::secureWipe(hashes, sizeof(hashes));
+    crypto_native::secureWipe(&scratch, sizeof(scratch));
+    crypto_native::secureWipe(observed, sizeof(observed));
+    return result;
+}
+
 bool validateSecret(const std::string& secret) {
     if (secret.empty()) {
         return false;
@@ -400,12 +901,9 @@ bool validateSecret(const std::string& secret) {
 
 std::vector<uint8_t> base32Decode(const std::string& input) {
     if (input.empty()) {
-        __android_log_print(ANDROID_LOG_ERROR, "OtpGenerator", "base32Decode: input is empty");
         return {};
     }
     
-    __android_log_print(ANDROID_LOG_DEBUG, "OtpGenerator", "base32Decode: input = %s", input.c_str());
-    
     // Simple and reliable base32 decode implementation
     const std::string base32Chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
     std::string cleanInput;
@@ -418,12 +916,9 @@ std::vector<uint8_t> base32Decode(const std::string& input) {
     }
     
     if (cleanInput.empty()) {
-        __android_log_print(ANDROID_LOG_ERROR, "OtpGenerator", "base32Decode: cleanInput is empty after processing");
         return {};
     }
     
-    __android_log_print(ANDROID_LOG_DEBUG, "OtpGenerator", "base32Decode: cleanInput = %s", cleanInput.c_str());
-    
     std::vector<uint8_t> result;
     result.reserve((cleanInput.size() * 5) / 8 + 1);
     
@@ -434,7 +929,6 @@ std::vector<uint8_t> base32Decode(const std::string& input) {
         // Find character in base32 alphabet
         size_t pos = base32Chars.find(c);
         if (pos == std::string::npos) {
-            __android_log_print(ANDROID_LOG_ERROR, "OtpGenerator", "base32Decode: invalid character '%c' (0x%02x)", c, static_cast<unsigned char>(c));
             return {}; // Invalid character
         }
         
@@ -447,19 +941,6 @@ std::vector<uint8_t> base32Decode(const std::string& input) {
         }
     }
     
-    __android_log_print(ANDROID_LOG_DEBUG, "OtpGenerator", "base32Decode: result size = %zu", result.size());
-    
-    // Log first few bytes for debugging
-    if (result.size() > 0) {
-        std::string hexStr;
-        for (size_t i = 0; i < std::min(result.size(), size_t(8)); ++i) {
-            char hex[4];
-            snprintf(hex, sizeof(hex), "%02x ", result[i]);
-            hexStr += hex;
-        }
-        __android_log_print(ANDROID_LOG_DEBUG, "OtpGenerator", "base32Decode: first bytes = %s", hexStr.c_str());
-    }
-    
     return result;
 }
 
@@ -498,4 +979,51 @@ std::string base32Encode(const std::vector<uint8_t>& data) {
     return result;
 }
 
+CodeRing::CodeRing(size_t depth) : entries_(depth + 1) {
+    wipe();
+}
+
+CodeRing::~CodeRing() {
+    wipe();
+}
+
+bool CodeRing::lookup(uint64_t timeSlot, std::string& code) const {
+    if (entries_.empty()) {
+        return false;
+    }
+    const Entry& entry = entries_[timeSlot % entries_.size()];
+    if (entry.length == 0 || entry.timeSlot != timeSlot) {
+        return false;
+    }
+    code.assign(entry.code, entry.length);
+    return true;
+}
+
+void CodeRing::store(uint64_t timeSlot, const std::string& code) {
+    if (entries_.empty() || code.empty() || code.size() > MAX_CODE_LENGTH) {
+        return;
+    }
+    Entry& entry = entries_[timeSlot % entries_.size()];
+    entry.timeSlot = timeSlot;
+    entry.length = static_cast<uint8_t>(code.size());
+    std::memcpy(entry.code, code.data(), code.size());
+}
+
+uint64_t CodeRing::firstMissing(uint64_t fromSlot) const {
+    const uint64_t end = fromSlot + entries_.size();
+    for (uint64_t slot = fromSlot; slot < end; ++slot) {
+        const Entry& entry = entries_[slot % entries_.size()];
+        if (entry.length == 0 || entry.timeSlot != slot) {
+            return slot;
+        }
+    }
+    return end;
+}
+
+void CodeRing::wipe() {
+    if (!entries_.empty()) {
+        crypto_native::secureWipe(entries_.data(), entries_.size() * sizeof(Entry));
+    }
+}
+
 } // namespace OtpGenerator 
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include "SecureArena.h"
 
 namespace OtpGenerator {
     /**
@@ -26,7 +27,8 @@ namespace OtpGenerator {
     std::string generateHOTP(const std::string& secret, uint64_t counter, int digits, const std::string& algorithm);
     
     /**
-     * Generate mOTP (Mobile One-Time Password) code
+     * Generate mOTP (Mobile One-Time Password) code: the first six hex
+     * digits of md5(epoch / 10 + secret + pin), as in the reference implementation
      * @param secret Secret key
      * @param pin PIN code
      * @param timeSlot Current time slot
@@ -43,15 +45,72 @@ namespace OtpGenerator {
      * @return Generated mOTP code (6 character hex)
      */
     std::string generateMOTPWithPeriod(const std::string& secret, const std::string& pin, uint64_t timeSlot, int period);
+
+    struct MotpRequest {
+        const std::string* secret;
+        const std::string* pin;
+        uint64_t counter;  // Epoch seconds / period
+    };
+
+    /**
+     * Generate many mOTP codes at once. Inputs that fit a single MD5 block
+     * (the usual 16-character secret and 4-digit PIN) are hashed four per
+     * pass; longer ones fall back to the streaming path.
+     * @param requests Secrets, PINs and counters; pointers must stay valid for the call
+     * @return Codes in request order, empty for requests without secret or PIN
+     */
+    std::vector<std::string> generateMOTPBatch(const std::vector<MotpRequest>& requests);
     
     /**
-     * Generate Steam Guard code
+     * Generate Steam Guard code: the RFC 4226 truncated value written
+     * least-significant first in base 26 over STEAM_ALPHABET
      * @param secret Base32 encoded secret
      * @param timeSlot Current time slot
      * @return Generated Steam code (5 character alphanumeric)
      */
     std::string generateSteamGuard(const std::string& secret, uint64_t timeSlot);
     
+    enum class OtpEncoding {
+        DECIMAL,  // RFC 4226 digits
+        STEAM     // Five characters of the Steam Guard alphabet
+    };
+
+    struct OtpRequest {
+        const std::string* secret;  // Base32
+        uint64_t counter;           // HOTP counter or TOTP/Steam time slot
+        int digits;                 // Decimal encoding only
+        OtpEncoding encoding;
+    };
+
+    /**
+     * Generate many HMAC-SHA1 codes at once. Each secret is keyed once into
+     * HMAC midstates that consecutive requests with the same secret pointer
+     * reuse, and requests are hashed four per pass through vector lanes,
+     * so a run of counters costs two SHA-1 compressions per four codes.
+     * TOTP/HOTP and Steam Guard differ only in the output encoding of the
+     * truncated value.
+     * @param requests Secrets, counters and encodings; pointers must stay valid for the call
+     * @return Codes in request order, empty for invalid requests
+     */
+    std::vector<std::string> generateOTPBatch(const std::vector<OtpRequest>& requests);
+
+    /**
+     * RFC 4226 resynchronization: find where the token's counter has moved
+     * after presses that never reached the server. Counters from counter
+     * to counter + window - 1 are checked through the four-lane HMAC path.
+     * With two codes they must match consecutive counters, which makes an
+     * accidental match in a large window unlikely.
+     * @param secret Base32 encoded secret
+     * @param counter Last counter known to be in sync
+     * @param codes One code, or two consecutive codes, as shown by the token
+     * @param window Number of counters to search
+     * @param digits Code length
+     * @param algorithm Hash algorithm (SHA1 only)
+     * @return Counter following the (last) matched code, or -1 if none matched
+     */
+    int64_t resyncHOTP(const std::string& secret, uint64_t counter, const std::vector<std::string>& codes,
+                       int window, int digits, const std::string& algorithm);
+
     /**
      * Validate if a secret is properly formatted Base32
      * @param secret Secret to validate
@@ -72,4 +131,54 @@ namespace OtpGenerator {
      * @return Base32 encoded string
      */
     std::string base32Encode(const std::vector<uint8_t>& data);
+
+    /**
+     * Look-ahead ring of precomputed codes for one account: the current
+     * period and the next depth periods. Entries are indexed by
+     * timeSlot % capacity, so a lookup is O(1) and never generates. Codes
+     * live in locked secure memory and are wiped on destruction.
+     */
+    class CodeRing {
+    public:
+        static constexpr size_t MAX_CODE_LENGTH = 10;
+
+        explicit CodeRing(size_t depth);
+        ~CodeRing();
+
+        CodeRing(CodeRing&&) = default;
+        CodeRing& operator=(CodeRing&&) = default;
+        CodeRing(const CodeRing&) = delete;
+        CodeRing& operator=(const CodeRing&) = delete;
+
+        /**
+         * Look up the code for a time slot
+         * @return False if the slot has not been precomputed
+         */
+        bool lookup(uint64_t timeSlot, std::string& code) const;
+
+        /**
+         * Store a code; empty or oversized codes are ignored
+         */
+        void store(uint64_t timeSlot, const std::string& code);
+
+        /**
+         * First slot in [fromSlot, fromSlot + capacity) without a code, or
+         * fromSlot + capacity if the window is complete
+         */
+        uint64_t firstMissing(uint64_t fromSlot) const;
+
+        size_t capacity() const { return entries_.size(); }
+
+        // Forget every code
+        void wipe();
+
+    private:
+        struct Entry {
+            uint64_t timeSlot;
+            uint8_t length;
+            char code[MAX_CODE_LENGTH];
+        };
+
+        std::vector<Entry, crypto_native::SecureAllocator<Entry>> entries_;
+    };
 } 
\ No newline at end of file
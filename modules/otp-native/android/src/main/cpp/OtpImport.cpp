@@ -0,0 +1,566 @@
+#include "OtpImport.h"
+#include <cstring>
+
+namespace OtpImport {
+
+using crypto_native::SecureBytes;
+
+namespace {
+    constexpr char OTPAUTH_SCHEME[] = "otpauth://";
+    constexpr char MIGRATION_SCHEME[] = "otpauth-migration://";
+
+    constexpr size_t MAX_FIELD_LENGTH = UINT16_MAX;
+    constexpr uint16_t DEFAULT_PERIOD = 30;
+    constexpr uint8_t DEFAULT_DIGITS = 6;
+    constexpr uint8_t STEAM_DIGITS = 5;
+
+    struct Range {
+        const char* begin;
+        const char* end;
+
+        bool empty() const { return begin == end; }
+    };
+
+    inline char lower(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    bool equalsIgnoreCase(Range range, const char* literal) {
+        const size_t length = std::strlen(literal);
+        if (static_cast<size_t>(range.end - range.begin) != length) {
+            return false;
+        }
+        for (size_t i = 0; i < length; ++i) {
+            if (lower(range.begin[i]) != literal[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool startsWithIgnoreCase(const std::string& value, const char* prefix) {
+        const size_t length = std::strlen(prefix);
+        return value.size() >= length && equalsIgnoreCase({value.data(), value.data() + length}, prefix);
+    }
+
+    inline int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // Yields percent-decoded characters without materializing the decoded string
+    class PercentReader {
+    public:
+        PercentReader(Range range, bool plusIsSpace)
+            : cursor_(range.begin), end_(range.end), plusIsSpace_(plusIsSpace) {}
+
+        bool next(char& out) {
+            if (cursor_ == end_) {
+                return false;
+            }
+            if (*cursor_ == '%' && end_ - cursor_ >= 3) {
+                const int high = hexValue(cursor_[1]);
+                const int low = hexValue(cursor_[2]);
+                if (high >= 0 && low >= 0) {
+                    out = static_cast<char>((high << 4) | low);
+                    cursor_ += 3;
+                    return true;
+                }
+            }
+            out = (*cursor_ == '+' && plusIsSpace_) ? ' ' : *cursor_;
+            ++cursor_;
+            return true;
+        }
+
+    private:
+        const char* cursor_;
+        const char* end_;
+        bool plusIsSpace_;
+    };
+
+    bool appendDecoded(SecureBytes& pool, Range range, bool plusIsSpace, uint32_t& offset, uint16_t& length) {
+        offset = static_cast<uint32_t>(pool.size());
+        PercentReader reader(range, plusIsSpace);
+        char c;
+        while (reader.next(c)) {
+            pool.push_back(static_cast<uint8_t>(c));
+        }
+        const size_t decoded = pool.size() - offset;
+        if (decoded > MAX_FIELD_LENGTH) {
+            return false;
+        }
+        length = static_cast<uint16_t>(decoded);
+        return true;
+    }
+
+    // Strict Base32: A-Z/a-z/2-7, spaces and dashes ignored, '=' only as trailing padding
+    template <typename Next>
+    bool appendBase32(SecureBytes& pool, Next next, uint32_t& offset, uint16_t& length) {
+        offset = static_cast<uint32_t>(pool.size());
+        uint32_t buffer = 0;
+        int bits = 0;
+        bool padding = false;
+        char c;
+        while (next(c)) {
+            if (c == ' ' || c == '-') continue;
+            if (c == '=') {
+                padding = true;
+                continue;
+            }
+            int value;
+            if (c >= 'A' && c <= 'Z') value = c - 'A';
+            else if (c >= 'a' && c <= 'z') value = c - 'a';
+            else if (c >= '2' && c <= '7') value = c - '2' + 26;
+            else value = -1;
+            if (value < 0 || padding) {
+                pool.resize(offset);
+                return false;
+            }
+            buffer = (buffer << 5) | static_cast<uint32_t>(value);
+            bits += 5;
+            if (bits >= 8) {
+                bits -= 8;
+                pool.push_back(static_cast<uint8_t>(buffer >> bits));
+            }
+        }
+        crypto_native::secureWipe(&buffer, sizeof(buffer));
+
+        const size_t decoded = pool.size() - offset;
+        if (decoded == 0 || decoded > MAX_FIELD_LENGTH) {
+            pool.resize(offset);
+            return false;
+        }
+        length = static_cast<uint16_t>(decoded);
+        return true;
+    }
+
+    // Standard or URL-safe base64, padding optional
+    bool decodeBase64(PercentReader reader, SecureBytes& out) {
+        uint32_t buffer = 0;
+        int bits = 0;
+        char c;
+        while (reader.next(c)) {
+            int value;
+            if (c >= 'A' && c <= 'Z') value = c - 'A';
+            else if (c >= 'a' && c <= 'z') value = c - 'a' + 26;
+            else if (c >= '0' && c <= '9') value = c - '0' + 52;
+            else if (c == '+' || c == '-' || c == ' ') value = 62; // '+' may arrive as a space
+            else if (c == '/' || c == '_') value = 63;
+            else if (c == '=' || c == '\n' || c == '\r') continue;
+            else return false;
+            buffer = (buffer << 6) | static_cast<uint32_t>(value);
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                out.push_back(static_cast<uint8_t>(buffer >> bits));
+            }
+        }
+        return true;
+    }
+
+    bool parseNumber(Range range, uint64_t& value) {
+        if (range.empty()) {
+            return false;
+        }
+        value = 0;
+        for (const char* p = range.begin; p != range.end; ++p) {
+            if (*p < '0' || *p > '9' || value > (UINT64_MAX - 9) / 10) {
+                return false;
+            }
+            value = value * 10 + static_cast<uint64_t>(*p - '0');
+        }
+        return true;
+    }
+
+    // Split "Issuer:Account" in place; leading spaces of the account are dropped
+    void splitLabel(const SecureBytes& pool, PackedAccount& account, bool hasIssuerParam) {
+        const uint8_t* label = pool.data() + account.nameOffset;
+        const void* colon = std::memchr(label, ':', account.nameLength);
+        if (!colon) {
+            return;
+        }
+        uint16_t prefix = static_cast<uint16_t>(static_cast<const uint8_t*>(colon) - label);
+        if (!hasIssuerParam) {
+            account.issuerOffset = account.nameOffset;
+            account.issuerLength = prefix;
+        }
+        uint16_t skip = prefix + 1;
+        while (skip < account.nameLength && label[skip] == ' ') {
+            ++skip;
+        }
+        account.nameOffset += skip;
+        account.nameLength -= skip;
+    }
+
+    bool parseOtpauth(const std::string& uri, ImportBatch& batch) {
+        const char* cursor = uri.data() + std::strlen(OTPAUTH_SCHEME);
+        const char* end = uri.data() + uri.size();
+
+        const char* slash = static_cast<const char*>(std::memchr(cursor, '/', end - cursor));
+        if (!slash) {
+            return false;
+        }
+        Range host{cursor, slash};
+        const char* question = static_cast<const char*>(std::memchr(slash, '?', end - slash));
+        Range label{slash + 1, question ? question : end};
+        Range query{question ? question + 1 : end, end};
+
+        PackedAccount account{};
+        account.algorithm = OtpAlgorithm::SHA1;
+        account.digits = DEFAULT_DIGITS;
+        account.period = DEFAULT_PERIOD;
+        if (equalsIgnoreCase(host, "totp")) account.type = OtpType::TOTP;
+        else if (equalsIgnoreCase(host, "hotp")) account.type = OtpType::HOTP;
+        else if (equalsIgnoreCase(host, "steam")) account.type = OtpType::STEAM;
+        else return false;
+
+        SecureBytes& pool = batch.pool;
+        const size_t rollback = pool.size();
+        auto reject = [&]() {
+            pool.resize(rollback);
+            return false;
+        };
+
+        if (!appendDecoded(pool, label, false, account.nameOffset, account.nameLength)) {
+            return reject();
+        }
+
+        bool hasSecret = false;
+        bool hasIssuer = false;
+        bool hasDigits = false;
+        const char* p = query.begin;
+        while (p < query.end) {
+            const char* amp = static_cast<const char*>(std::memchr(p, '&', query.end - p));
+            const char* pairEnd = amp ? amp : query.end;
+            const char* eq = static_cast<const char*>(std::memchr(p, '=', pairEnd - p));
+            Range key{p, eq ? eq : pairEnd};
+            Range value{eq ? eq + 1 : pairEnd, pairEnd};
+            p = pairEnd + 1;
+
+            uint64_t number = 0;
+            if (equalsIgnoreCase(key, "secret")) {
+                PercentReader reader(value, true);
+                hasSecret = appendBase32(pool, [&](char& c) { return reader.next(c); },
+                                         account.secretOffset, account.secretLength);
+                if (!hasSecret) {
+                    return reject();
+                }
+            } else if (equalsIgnoreCase(key, "issuer")) {
+                if (!appendDecoded(pool, value, true, account.issuerOffset, account.issuerLength)) {
+                    return reject();
+                }
+                hasIssuer = account.issuerLength > 0;
+            } else if (equalsIgnoreCase(key, "algorithm")) {
+                if (equalsIgnoreCase(value, "sha1")) account.algorithm = OtpAlgorithm::SHA1;
+                else if (equalsIgnoreCase(value, "sha256")) account.algorithm = OtpAlgorithm::SHA256;
+                else if (equalsIgnoreCase(value, "sha512")) account.algorithm = OtpAlgorithm::SHA512;
+                else return reject();
+            } else if (equalsIgnoreCase(key, "digits")) {
+                if (!parseNumber(value, number) || number < 5 || number > 10) {
+                    return reject();
+                }
+                account.digits = static_cast<uint8_t>(number);
+                hasDigits = true;
+            } else if (equalsIgnoreCase(key, "period")) {
+                if (!parseNumber(value, number) || number == 0 || number > UINT16_MAX) {
+                    return reject();
+                }
+                account.period = static_cast<uint16_t>(number);
+            } else if (equalsIgnoreCase(key, "counter")) {
+                if (!parseNumber(value, number)) {
+                    return reject();
+                }
+                account.counter = number;
+            } else if (equalsIgnoreCase(key, "encoder")) {
+                if (equalsIgnoreCase(value, "steam")) {
+                    account.type = OtpType::STEAM;
+                }
+            }
+        }
+
+        if (!hasSecret) {
+            return reject();
+        }
+        if (account.type == OtpType::STEAM) {
+            account.digits = STEAM_DIGITS;
+            account.period = DEFAULT_PERIOD;
+        } else if (hasDigits && account.digits < 6) {
+            return reject();
+        }
+
+        splitLabel(pool, account, hasIssuer);
+        batch.accounts.push_back(account);
+        return true;
+    }
+
+    // Minimal protobuf reader over a byte range; nothing is copied
+    class ProtoReader {
+    public:
+        ProtoReader(const uint8_t* data, size_t length) : cursor_(data), end_(data + length) {}
+
+        bool done() const { return cursor_ >= end_; }
+
+        bool varint(uint64_t& value) {
+            value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (cursor_ >= end_) return false;
+                const uint8_t byte = *cursor_++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return true;
+            }
+            return false;
+        }
+
+        bool field(uint32_t& number, uint32_t& wireType) {
+            uint64_t tag;
+            if (!varint(tag)) return false;
+            number = static_cast<uint32_t>(tag >> 3);
+            wireType = static_cast<uint32_t>(tag & 7);
+            return true;
+        }
+
+        bool bytes(const uint8_t*& data, size_t& length) {
+            uint64_t size;
+            if (!varint(size) || size > static_cast<uint64_t>(end_ - cursor_)) return false;
+            data = cursor_;
+            length = static_cast<size_t>(size);
+            cursor_ += size;
+            return true;
+        }
+
+        bool skip(uint32_t wireType) {
+            uint64_t ignored;
+            const uint8_t* data;
+            size_t length;
+            switch (wireType) {
+                case 0: return varint(ignored);
+                case 1: return advance(8);
+                case 2: return bytes(data, length);
+                case 5: return advance(4);
+                default: return false;
+            }
+        }
+
+    private:
+        bool advance(size_t count) {
+            if (static_cast<size_t>(end_ - cursor_) < count) return false;
+            cursor_ += count;
+            return true;
+        }
+
+        const uint8_t* cursor_;
+        const uint8_t* end_;
+    };
+
+    bool appendRaw(SecureBytes& pool, const uint8_t* data, size_t length, uint32_t& offset, uint16_t& outLength) {
+        if (length > MAX_FIELD_LENGTH) {
+            return false;
+        }
+        offset = static_cast<uint32_t>(pool.size());
+        pool.insert(pool.end(), data, data + length);
+        outLength = static_cast<uint16_t>(length);
+        return true;
+    }
+
+    // Google Authenticator MigrationPayload.OtpParameters
+    bool parseMigrationEntry(const uint8_t* data, size_t length, ImportBatch& batch) {
+        SecureBytes& pool = batch.pool;
+        const size_t rollback = pool.size();
+
+        PackedAccount account{};
+        account.type = OtpType::TOTP;
+        account.algorithm = OtpAlgorithm::SHA1;
+        account.digits = DEFAULT_DIGITS;
+        account.period = DEFAULT_PERIOD;
+
+        bool ok = true;
+        bool hasSecret = false;
+        ProtoReader reader(data, length);
+        while (ok && !reader.done()) {
+            uint32_t number, wireType;
+            if (!reader.field(number, wireType)) {
+                ok = false;
+                break;
+            }
+
+            const uint8_t* bytes;
+            size_t size;
+            uint64_t value;
+            if (wireType == 2 && number >= 1 && number <= 3) {
+                ok = reader.bytes(bytes, size);
+                if (!ok) break;
+                if (number == 1) {
+                    ok = size > 0 && appendRaw(pool, bytes, size, account.secretOffset, account.secretLength);
+                    hasSecret = ok;
+                } else if (number == 2) {
+                    ok = appendRaw(pool, bytes, size, account.nameOffset, account.nameLength);
+                } else {
+                    ok = appendRaw(pool, bytes, size, account.issuerOffset, account.issuerLength);
+                }
+            } else if (wireType == 0 && number >= 4 && number <= 7) {
+                ok = reader.varint(value);
+                if (!ok) break;
+                switch (number) {
+                    case 4: // Algorithm: 0 unspecified, 1 SHA1, 2 SHA256, 3 SHA512, 4 MD5
+                        if (value <= 1) account.algorithm = OtpAlgorithm::SHA1;
+                        else if (value == 2) account.algorithm = OtpAlgorithm::SHA256;
+                        else if (value == 3) account.algorithm = OtpAlgorithm::SHA512;
+                        else ok = false;
+                        break;
+                    case 5: // Digits: 0 unspecified, 1 six, 2 eight
+                        account.digits = value == 2 ? 8 : 6;
+                        break;
+                    case 6: // Type: 0 unspecified, 1 HOTP, 2 TOTP
+                        account.type = value == 1 ? OtpType::HOTP : OtpType::TOTP;
+                        break;
+                    case 7:
+                        account.counter = value;
+                        break;
+                }
+            } else {
+                ok = reader.skip(wireType);
+            }
+        }
+
+        if (!ok || !hasSecret) {
+            pool.resize(rollback);
+            return false;
+        }
+
+        // Names are usually exported as "Issuer:account"; drop the duplicated prefix
+        if (account.issuerLength > 0 && account.nameLength > account.issuerLength &&
+            pool[account.nameOffset + account.issuerLength] == ':' &&
+            std::memcmp(pool.data() + account.nameOffset, pool.data() + account.issuerOffset,
+                        account.issuerLength) == 0) {
+            splitLabel(pool, account, true);
+        } else if (account.issuerLength == 0) {
+            splitLabel(pool, account, false);
+        }
+
+        batch.accounts.push_back(account);
+        return true;
+    }
+
+    bool parseMigration(const std::string& uri, ImportBatch& batch) {
+        const char* begin = uri.data() + std::strlen(MIGRATION_SCHEME);
+        const char* end = uri.data() + uri.size();
+        const char* question = static_cast<const char*>(std::memchr(begin, '?', end - begin));
+        if (!question) {
+            return false;
+        }
+
+        Range data{nullptr, nullptr};
+        const char* p = question + 1;
+        while (p < end) {
+            const char* amp = static_cast<const char*>(std::memchr(p, '&', end - p));
+            const char* pairEnd = amp ? amp : end;
+            if (pairEnd - p > 5 && std::memcmp(p, "data=", 5) == 0) {
+                data = {p + 5, pairEnd};
+            }
+            p = pairEnd + 1;
+        }
+        if (!data.begin || data.empty()) {
+            return false;
+        }
+
+        SecureBytes payload;
+        payload.reserve(static_cast<size_t>(data.end - data.begin) * 3 / 4 + 3);
+        if (!decodeBase64(PercentReader(data, false), payload)) {
+            return false;
+        }
+
+        // MigrationPayload: field 1 is a repeated OtpParameters message. Bad
+        // entries are counted as rejected on their own; the URI only fails if
+        // the payload itself is malformed or empty, and then nothing from it
+        // is kept: the caller counts the whole URI as one rejection.
+        const size_t accountMark = batch.accounts.size();
+        const size_t poolMark = batch.pool.size();
+        const uint32_t rejectedMark = batch.rejected;
+        auto reject = [&]() {
+            batch.accounts.resize(accountMark);
+            crypto_native::secureWipe(batch.pool.data() + poolMark, batch.pool.size() - poolMark);
+            batch.pool.resize(poolMark);
+            batch.rejected = rejectedMark;
+            return false;
+        };
+
+        ProtoReader reader(payload.data(), payload.size());
+        size_t entries = 0;
+        while (!reader.done()) {
+            uint32_t number, wireType;
+            if (!reader.field(number, wireType)) {
+                return reject();
+            }
+            if (number == 1 && wireType == 2) {
+                const uint8_t* entry;
+                size_t length;
+                if (!reader.bytes(entry, length)) {
+                    return reject();
+                }
+                if (!parseMigrationEntry(entry, length, batch)) {
+                    ++batch.rejected;
+                }
+                ++entries;
+            } else if (!reader.skip(wireType)) {
+                return reject();
+            }
+        }
+        return entries > 0;
+    }
+}
+
+std::string ImportBatch::issuer(const PackedAccount& account) const {
+    return std::string(reinterpret_cast<const char*>(pool.data() + account.issuerOffset), account.issuerLength);
+}
+
+std::string ImportBatch::name(const PackedAccount& account) const {
+    return std::string(reinterpret_cast<const char*>(pool.data() + account.nameOffset), account.nameLength);
+}
+
+const uint8_t* ImportBatch::secret(const PackedAccount& account) const {
+    return pool.data() + account.secretOffset;
+}
+
+bool decodeBase32Secret(SecureBytes& pool, const char* begin, const char* end, uint32_t& offset, uint16_t& length) {
+    return appendBase32(pool, [&](char& c) {
+        if (begin == end) {
+            return false;
+        }
+        c = *begin++;
+        return true;
+    }, offset, length);
+}
+
+bool parseUri(const std::string& uri, ImportBatch& batch) {
+    bool parsed = false;
+    if (startsWithIgnoreCase(uri, MIGRATION_SCHEME)) {
+        parsed = parseMigration(uri, batch);
+    } else if (startsWithIgnoreCase(uri, OTPAUTH_SCHEME)) {
+        parsed = parseOtpauth(uri, batch);
+    }
+    if (!parsed) {
+        ++batch.rejected;
+    }
+    return parsed;
+}
+
+ImportBatch parseUris(const std::vector<std::string>& uris) {
+    ImportBatch batch;
+
+    // Decoded output never exceeds the encoded input, so one reservation covers the pool
+    size_t total = 0;
+    for (const auto& uri : uris) {
+        total += uri.size();
+    }
+    batch.pool.reserve(total);
+    batch.accounts.reserve(uris.size());
+
+    for (const auto& uri : uris) {
+        parseUri(uri, batch);
+    }
+    return batch;
+}
+
+} // namespace OtpImport
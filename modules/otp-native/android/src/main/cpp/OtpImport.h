@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "SecureArena.h"
+
+namespace OtpImport {
+    enum class OtpType : uint8_t {
+        TOTP = 1,
+        HOTP = 2,
+        STEAM = 3
+    };
+
+    enum class OtpAlgorithm : uint8_t {
+        SHA1 = 1,
+        SHA256 = 2,
+        SHA512 = 3
+    };
+
+    /**
+     * One parsed account. Strings and the decoded secret live in the batch
+     * pool and are addressed by offset/length, so a batch is two allocations
+     * no matter how many accounts it holds.
+     */
+    struct PackedAccount {
+        uint32_t issuerOffset;
+        uint32_t nameOffset;
+        uint32_t secretOffset;
+        uint16_t issuerLength;
+        uint16_t nameLength;
+        uint16_t secretLength;
+        OtpType type;
+        OtpAlgorithm algorithm;
+        uint8_t digits;
+        uint8_t reserved;
+        uint16_t period;
+        uint64_t counter;
+    };
+
+    struct ImportBatch {
+        std::vector<PackedAccount> accounts;
+        crypto_native::SecureBytes pool;
+        uint32_t rejected = 0;
+
+        std::string issuer(const PackedAccount& account) const;
+        std::string name(const PackedAccount& account) const;
+        const uint8_t* secret(const PackedAccount& account) const;
+    };
+
+    /**
+     * Parse otpauth:// and otpauth-migration://offline?data= URIs in one pass.
+     * Labels and parameters are percent-decoded, migration payloads are
+     * base64- and protobuf-decoded, and every secret is validated and decoded
+     * from Base32 straight into the pool. URIs that cannot be parsed are
+     * counted in `rejected` and skipped.
+     * @param uris URIs to parse
+     * @return Packed accounts in input order
+     */
+    ImportBatch parseUris(const std::vector<std::string>& uris);
+
+    enum class BackupFormat : uint8_t {
+        AEGIS = 1,   // scrypt password slots wrapping an AES-256-GCM vault key
+        ANDOTP = 2,  // PBKDF2-HMAC-SHA1 and AES-256-GCM
+        TWOFAS = 3   // PBKDF2-HMAC-SHA256 and AES-256-GCM over the service list
+    };
+
+    /**
+     * Decrypt another authenticator's backup and parse every entry into one
+     * batch. Plain (unencrypted) exports of the same apps are accepted too,
+     * and then the password is ignored. The vault plaintext is parsed in
+     * place and wiped; names and secrets are decoded straight into the pool.
+     * Entries that cannot be imported (unsupported types, bad secrets) are
+     * counted in `rejected` and skipped.
+     * @param format Which app wrote the backup
+     * @param data Backup file contents
+     * @param password Backup password, UTF-8
+     * @return Packed accounts in backup order
+     * @throws crypto_native::InvalidKeyException if the password is wrong
+     * @throws crypto_native::CryptoException if the file is not a readable backup
+     */
+    ImportBatch parseBackup(BackupFormat format, const crypto_native::SecureBytes& data,
+                            const std::string& password);
+
+    /**
+     * Strict Base32 decode of a secret into `pool`, with the same rules as
+     * URI secrets. Shared with the backup parsers.
+     * @return False, with the pool unchanged, if the input is invalid or empty
+     */
+    bool decodeBase32Secret(crypto_native::SecureBytes& pool, const char* begin, const char* end,
+                            uint32_t& offset, uint16_t& length);
+
+    /**
+     * Parse a single URI into an existing batch
+     * @param uri URI to parse
+     * @param batch Batch to append to
+     * @return False if the URI was rejected
+     */
+    bool parseUri(const std::string& uri, ImportBatch& batch);
+}
@@ -0,0 +1,187 @@
+#include "OtpNativeC.h"
+#include <climits>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+#include "OtpGenerator.h"
+#include "SecureArena.h"
+
+namespace {
+    // Copy a generated code into the caller's buffer and wipe the temporary
+    int writeText(std::string& text, char* out, size_t outSize) {
+        int result;
+        if (text.empty()) {
+            result = OTP_ERR_INVALID_ARGUMENT;
+        } else if (!out || text.size() >= outSize || text.size() > INT_MAX) {
+            result = OTP_ERR_BUFFER_TOO_SMALL;
+        } else {
+            std::memcpy(out, text.data(), text.size());
+            out[text.size()] = '\0';
+            result = static_cast<int>(text.size());
+        }
+        crypto_native::secureWipe(&text[0], text.size());
+        return result;
+    }
+
+    template <typename Body>
+    int guarded(Body body) {
+        try {
+            return body();
+        } catch (const std::exception&) {
+            return OTP_ERR_INTERNAL;
+        }
+    }
+}
+
+extern "C" {
+
+uint32_t otp_abi_version(void) {
+    return OTP_NATIVE_ABI_VERSION;
+}
+
+int otp_generate_hotp(const char* secret, uint64_t counter, int digits, const char* algorithm,
+                      char* out, size_t out_size) {
+    if (!secret || !algorithm) {
+        return OTP_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        std::string code = OtpGenerator::generateHOTP(secret, counter, digits, algorithm);
+        return writeText(code, out, out_size);
+    });
+}
+
+int otp_generate_totp(const char* secret, uint64_t time_slot, int digits, const char* algorithm,
+                      char* out, size_t out_size) {
+    if (!secret || !algorithm) {
+        return OTP_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        std::string code = OtpGenerator::generateTOTP(secret, time_slot, digits, algorithm);
+        return writeText(code, out, out_size);
+    });
+}
+
+int otp_generate_motp(const char* secret, const char* pin, uint64_t epoch_seconds, int period,
+                      char* out, size_t out_size) {
+    if (!secret || !pin) {
+        return OTP_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        std::string code = OtpGenerator::generateMOTPWithPeriod(secret, pin, epoch_seconds, period);
+        return writeText(code, out, out_size);
+    });
+}
+
+int otp_generate_steam(const char* secret, uint64_t time_slot, char* out, size_t out_size) {
+    if (!secret) {
+        return OTP_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        std::string code = OtpGenerator::generateSteamGuard(secret, time_slot);
+        return writeText(code, out, out_size);
+    });
+}
+
+int otp_generate_batch(const char* const* secrets, const uint8_t* encodings, const uint64_t* counters,
+                       const int* digits, size_t count, char* codes) {
+    if (count > INT_MAX || (count > 0 && (!secrets || !encodings || !counters || !digits || !codes))) {
+        return OTP_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        // Entries sharing a C string share one std::string, so the batch
+        // still keys each run of counters once
+        std::vector<std::string> secretStore;
+        std::vector<size_t> secretIndex(count);
+        secretStore.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (i > 0 && secrets[i] == secrets[i - 1]) {
+                secretIndex[i] = secretIndex[i - 1];
+                continue;
+            }
+            secretIndex[i] = secretStore.size();
+            secretStore.emplace_back(secrets[i] ? secrets[i] : "");
+        }
+
+        std::vector<OtpGenerator::OtpRequest> requests(count);
+        for (size_t i = 0; i < count; ++i) {
+            requests[i] = {&secretStore[secretIndex[i]], counters[i], digits[i],
+                           encodings[i] == OTP_ENCODING_STEAM ? OtpGenerator::OtpEncoding::STEAM
+                                                              : OtpGenerator::OtpEncoding::DECIMAL};
+        }
+
+        std::vector<std::string> generated = OtpGenerator::generateOTPBatch(requests);
+        for (size_t i = 0; i < count; ++i) {
+            char* slot = codes + i * OTP_CODE_CAPACITY;
+            if (writeText(generated[i], slot, OTP_CODE_CAPACITY) < 0) {
+                slot[0] = '\0';
+            }
+        }
+        for (auto& secret : secretStore) {
+            crypto_native::secureWipe(&secret[0], secret.size());
+        }
+        return static_cast<int>(count);
+    });
+}
+
+int64_t otp_resync_hotp(const char* secret, uint64_t counter, const char* const* codes, size_t code_count,
+                        int window, int digits, const char* algorithm) {
+    if (!secret || !codes || !algorithm || code_count == 0 || code_count > 2) {
+        return -1;
+    }
+    try {
+        std::vector<std::string> observed;
+        for (size_t i = 0; i < code_count; ++i) {
+            if (!codes[i]) {
+                return -1;
+            }
+            observed.emplace_back(codes[i]);
+        }
+        return OtpGenerator::resyncHOTP(secret, counter, observed, window, digits, algorithm);
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+int otp_validate_secret(const char* secret) {
+    if (!secret) {
+        return 0;
+    }
+    try {
+        return OtpGenerator::validateSecret(secret) ? 1 : 0;
+    } catch (const std::exception&) {
+        return 0;
+    }
+}
+
+int otp_base32_decode(const char* input, uint8_t* out, size_t out_size) {
+    if (!input) {
+        return OTP_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        std::vector<uint8_t> decoded = OtpGenerator::base32Decode(input);
+        int result;
+        if (decoded.empty()) {
+            result = OTP_ERR_INVALID_ARGUMENT;
+        } else if (!out || decoded.size() > out_size || decoded.size() > INT_MAX) {
+            result = OTP_ERR_BUFFER_TOO_SMALL;
+        } else {
+            std::memcpy(out, decoded.data(), decoded.size());
+            result = static_cast<int>(decoded.size());
+        }
+        crypto_native::secureWipe(decoded.data(), decoded.size());
+        return result;
+    });
+}
+
+int otp_base32_encode(const uint8_t* data, size_t length, char* out, size_t out_size) {
+    if (!data || length == 0) {
+        return OTP_ERR_INVALID_ARGUMENT;
+    }
+    return guarded([&] {
+        std::string encoded = OtpGenerator::base32Encode(std::vector<uint8_t>(data, data + length));
+        return writeText(encoded, out, out_size);
+    });
+}
+
+} // extern "C"
@@ -0,0 +1,78 @@
+#pragma once
+
+/*
+ * Stable C ABI over the OtpGenerator core.
+ *
+ * The Android JNI bridge and the iOS Swift module both call these functions,
+ * so code generation is implemented once in C++ and the platforms cannot
+ * drift apart. Every buffer is owned by the caller and nothing returned has
+ * to be freed. Text outputs are NUL-terminated. Functions return the number
+ * of bytes written (excluding the terminator) or a negative OTP_ERR_* code,
+ * and never let a C++ exception escape.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OTP_NATIVE_ABI_VERSION 1
+
+/* Buffer size that fits any code generated here, including the terminator */
+#define OTP_CODE_CAPACITY 16
+
+#define OTP_ERR_INVALID_ARGUMENT (-1)  /* Bad secret, digits, algorithm or pointer */
+#define OTP_ERR_BUFFER_TOO_SMALL (-2)
+#define OTP_ERR_INTERNAL (-3)
+
+#define OTP_ENCODING_DECIMAL 0  /* RFC 4226 digits */
+#define OTP_ENCODING_STEAM 1    /* Five characters of the Steam Guard alphabet */
+
+/* ABI version the library was built with; compare against OTP_NATIVE_ABI_VERSION */
+uint32_t otp_abi_version(void);
+
+/* HOTP/TOTP for a Base32 secret; algorithm is "SHA1" */
+int otp_generate_hotp(const char* secret, uint64_t counter, int digits, const char* algorithm,
+                      char* out, size_t out_size);
+int otp_generate_totp(const char* secret, uint64_t time_slot, int digits, const char* algorithm,
+                      char* out, size_t out_size);
+
+/* mOTP over the raw secret and PIN; epoch_seconds is divided by period */
+int otp_generate_motp(const char* secret, const char* pin, uint64_t epoch_seconds, int period,
+                      char* out, size_t out_size);
+
+/* Steam Guard for a Base32 secret */
+int otp_generate_steam(const char* secret, uint64_t time_slot, char* out, size_t out_size);
+
+/*
+ * Generate count HMAC-SHA1 codes through the batched path. codes receives
+ * count slots of OTP_CODE_CAPACITY bytes; slot i holds the code for entry i,
+ * or an empty string if that entry was invalid. digits is ignored for
+ * OTP_ENCODING_STEAM entries. Consecutive entries sharing a secret pointer
+ * reuse one keyed HMAC state.
+ * @return count, or a negative error code
+ */
+int otp_generate_batch(const char* const* secrets, const uint8_t* encodings, const uint64_t* counters,
+                       const int* digits, size_t count, char* codes);
+
+/*
+ * RFC 4226 resynchronization over one code or two consecutive codes
+ * @return Counter following the (last) matched code, or -1 if none matched
+ */
+int64_t otp_resync_hotp(const char* secret, uint64_t counter, const char* const* codes, size_t code_count,
+                        int window, int digits, const char* algorithm);
+
+/* 1 if the secret is well-formed Base32, otherwise 0 */
+int otp_validate_secret(const char* secret);
+
+/* Base32 decode into out; at most strlen(input) * 5 / 8 bytes are written */
+int otp_base32_decode(const char* input, uint8_t* out, size_t out_size);
+
+/* Padded Base32 encode; out needs (length + 4) / 5 * 8 + 1 bytes */
+int otp_base32_encode(const uint8_t* data, size_t length, char* out, size_t out_size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -2,7 +2,17 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <memory>
+#include <mutex>
+#include <cstdio>
+#include <stdexcept>
+#include "CodeScheduler.h"
 #include "OtpGenerator.h"
+#include "MailExtractor.h"
+#include "OtpImport.h"
+#include "OtpNativeC.h"
+#include "SearchIndex.h"
+#include "ServiceMatcher.h"
 
 extern "C" {
 
@@ -19,12 +29,269 @@ inline void safeReleaseStringUTFChars(JNIEnv *env, jstring jstr, const char* cst
     }
 }
 
+// Helper function to create a Java string from arbitrary bytes. NewStringUTF
+// takes modified UTF-8 and aborts under CheckJNI on anything else, while
+// imported issuers, names and mail headers carry whatever the source held.
+// Invalid sequences become U+FFFD, NUL becomes C0 80 and supplementary
+// characters become surrogate pairs.
+inline jstring newJavaString(JNIEnv *env, const std::string& text) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(text.data());
+    const size_t length = text.size();
+
+    size_t i = 0;
+    while (i < length && bytes[i] != 0 && bytes[i] < 0x80) {
+        ++i;
+    }
+    if (i == length) {
+        return env->NewStringUTF(text.c_str());
+    }
+
+    std::string modified(text, 0, i);
+    modified.reserve(length + 16);
+    auto putUnit = [&modified](uint32_t unit) {
+        if (unit < 0x800) {
+            modified.push_back(static_cast<char>(0xC0 | (unit >> 6)));
+        } else {
+            modified.push_back(static_cast<char>(0xE0 | (unit >> 12)));
+            modified.push_back(static_cast<char>(0x80 | ((unit >> 6) & 0x3F)));
+        }
+        modified.push_back(static_cast<char>(0x80 | (unit & 0x3F)));
+    };
+
+    while (i < length) {
+        const unsigned char lead = bytes[i];
+        if (lead != 0 && lead < 0x80) {
+            modified.push_back(static_cast<char>(lead));
+            ++i;
+            continue;
+        }
+
+        size_t extra = 0;
+        uint32_t minimum = 0;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            extra = 1;
+            minimum = 0x80;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            extra = 2;
+            minimum = 0x800;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            extra = 3;
+            minimum = 0x10000;
+        }
+
+        uint32_t codePoint = lead == 0 ? 0 : 0xFFFD;
+        size_t consumed = 1;
+        if (extra != 0 && i + extra < length) {
+            uint32_t value = lead & (0x3F >> extra);
+            size_t k = 1;
+            for (; k <= extra && (bytes[i + k] & 0xC0) == 0x80; ++k) {
+                value = (value << 6) | (bytes[i + k] & 0x3F);
+            }
+            if (k > extra && value >= minimum && value <= 0x10FFFF && (value < 0xD800 || value > 0xDFFF)) {
+                codePoint = value;
+                consumed = k;
+            }
+        }
+        i += consumed;
+
+        if (codePoint >= 0x10000) {
+            putUnit(0xD800 + ((codePoint - 0x10000) >> 10));
+            putUnit(0xDC00 + ((codePoint - 0x10000) & 0x3FF));
+        } else {
+            putUnit(codePoint);
+        }
+    }
+    return env->NewStringUTF(modified.c_str());
+}
+
 // Helper function to create result string with error handling
 inline jstring createResultString(JNIEnv *env, const std::string& result) {
     if (result.empty()) {
         return env->NewStringUTF("");
     }
-    return env->NewStringUTF(result.c_str());
+    return newJavaString(env, result);
+}
+
+// Helper function to create a string from a C ABI code buffer, wiping the buffer
+inline jstring codeResultString(JNIEnv *env, char* code, size_t size, int written) {
+    jstring result = env->NewStringUTF(written > 0 ? code : "");
+    crypto_native::secureWipe(code, size);
+    return result;
+}
+
+// Helper function to put a value into a java.util.HashMap, releasing the local reference
+inline void putInMap(JNIEnv *env, jobject map, jmethodID putMethod, const char* key, jobject value) {
+    jstring keyStr = env->NewStringUTF(key);
+    env->CallObjectMethod(map, putMethod, keyStr, value);
+    env->DeleteLocalRef(keyStr);
+    env->DeleteLocalRef(value);
+}
+
+// Helper function to copy a String[] into a vector
+inline std::vector<std::string> stringArrayToVector(JNIEnv *env, jobjectArray array) {
+    std::vector<std::string> result;
+    jsize count = array ? env->GetArrayLength(array) : 0;
+    result.reserve(count);
+    for (jsize i = 0; i < count; ++i) {
+        auto item = static_cast<jstring>(env->GetObjectArrayElement(array, i));
+        const char* itemStr = safeGetStringUTFChars(env, item);
+        result.emplace_back(itemStr);
+        safeReleaseStringUTFChars(env, item, itemStr);
+        env->DeleteLocalRef(item);
+    }
+    return result;
+}
+
+// Helper function to wipe a string's whole buffer. A moved-from string keeps
+// its short-string buffer, so clearing size() bytes would miss a short PIN.
+inline void wipeString(std::string& value) {
+    crypto_native::secureWipe(&value[0], value.capacity());
+}
+
+// Wipes decoded secrets and PINs when the scope exits, whichever way it exits
+struct ScheduleSecretsGuard {
+    std::vector<std::string>& secrets;
+    std::vector<std::string>& pins;
+    std::vector<CodeSchedule::Account>& accounts;
+
+    ~ScheduleSecretsGuard() {
+        for (auto& secret : secrets) wipeString(secret);
+        for (auto& pin : pins) wipeString(pin);
+        for (auto& account : accounts) {
+            wipeString(account.secret);
+            wipeString(account.pin);
+        }
+    }
+};
+
+// Helper function to create a String[] from a vector
+inline jobjectArray vectorToStringArray(JNIEnv *env, const std::vector<std::string>& values) {
+    jclass stringClass = env->FindClass("java/lang/String");
+    jobjectArray array = env->NewObjectArray(static_cast<jsize>(values.size()), stringClass, nullptr);
+    for (size_t i = 0; i < values.size(); ++i) {
+        jstring value = newJavaString(env, values[i]);
+        env->SetObjectArrayElement(array, static_cast<jsize>(i), value);
+        env->DeleteLocalRef(value);
+    }
+    env->DeleteLocalRef(stringClass);
+    return array;
+}
+
+// Helper function to convert an import batch into {accounts, rejected}, with
+// secrets re-encoded as Base32 for the JS side
+inline jobject importBatchToMap(JNIEnv *env, const OtpImport::ImportBatch& batch) {
+    jclass hashMapClass = env->FindClass("java/util/HashMap");
+    jmethodID hashMapInit = env->GetMethodID(hashMapClass, "<init>", "()V");
+    jmethodID putMethod = env->GetMethodID(hashMapClass, "put",
+                                           "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+    jclass integerClass = env->FindClass("java/lang/Integer");
+    jmethodID integerValueOf = env->GetStaticMethodID(integerClass, "valueOf", "(I)Ljava/lang/Integer;");
+    jclass doubleClass = env->FindClass("java/lang/Double");
+    jmethodID doubleValueOf = env->GetStaticMethodID(doubleClass, "valueOf", "(D)Ljava/lang/Double;");
+    jclass objectClass = env->FindClass("java/lang/Object");
+
+    jobjectArray accounts = env->NewObjectArray(static_cast<jsize>(batch.accounts.size()), objectClass, nullptr);
+    for (size_t i = 0; i < batch.accounts.size(); ++i) {
+        const OtpImport::PackedAccount& account = batch.accounts[i];
+
+        std::vector<uint8_t> secret(batch.secret(account), batch.secret(account) + account.secretLength);
+        std::string secretBase32 = OtpGenerator::base32Encode(secret);
+        crypto_native::secureWipe(secret.data(), secret.size());
+
+        const char* type = account.type == OtpImport::OtpType::HOTP ? "HOTP"
+                         : account.type == OtpImport::OtpType::STEAM ? "Steam"
+                         : "TOTP";
+        const char* algorithm = account.algorithm == OtpImport::OtpAlgorithm::SHA256 ? "SHA256"
+                              : account.algorithm == OtpImport::OtpAlgorithm::SHA512 ? "SHA512"
+                              : "SHA1";
+
+        jobject map = env->NewObject(hashMapClass, hashMapInit);
+        putInMap(env, map, putMethod, "issuer", newJavaString(env, batch.issuer(account)));
+        putInMap(env, map, putMethod, "name", newJavaString(env, batch.name(account)));
+        putInMap(env, map, putMethod, "secret", env->NewStringUTF(secretBase32.c_str()));
+        putInMap(env, map, putMethod, "type", env->NewStringUTF(type));
+        putInMap(env, map, putMethod, "algorithm", env->NewStringUTF(algorithm));
+        putInMap(env, map, putMethod, "digits",
+                 env->CallStaticObjectMethod(integerClass, integerValueOf, static_cast<jint>(account.digits)));
+        putInMap(env, map, putMethod, "period",
+                 env->CallStaticObjectMethod(integerClass, integerValueOf, static_cast<jint>(account.period)));
+        putInMap(env, map, putMethod, "counter",
+                 env->CallStaticObjectMethod(doubleClass, doubleValueOf, static_cast<jdouble>(account.counter)));
+        crypto_native::secureWipe(&secretBase32[0], secretBase32.size());
+
+        env->SetObjectArrayElement(accounts, static_cast<jsize>(i), map);
+        env->DeleteLocalRef(map);
+    }
+
+    jobject result = env->NewObject(hashMapClass, hashMapInit);
+    putInMap(env, result, putMethod, "accounts", accounts);
+    putInMap(env, result, putMethod, "rejected",
+             env->CallStaticObjectMethod(integerClass, integerValueOf, static_cast<jint>(batch.rejected)));
+    return result;
+}
+
+// Upper bound on a backup file read by importBackupNative
+static constexpr size_t MAX_BACKUP_SIZE = 64 * 1024 * 1024;
+
+// Service classifier shared by all callers; replaced atomically on reconfigure
+static std::mutex g_serviceMatcherMutex;
+static std::shared_ptr<const ServiceClassifier::ServiceMatcher> g_serviceMatcher;
+
+// Account search index shared by all callers
+static std::mutex g_searchIndexMutex;
+static AccountSearch::SearchIndex g_searchIndex;
+
+// Period-boundary scheduler; changes are delivered to the module that registered the accounts
+static std::mutex g_schedulerMutex;
+static std::unique_ptr<CodeSchedule::Scheduler> g_scheduler;
+static JavaVM* g_javaVm = nullptr;
+static jobject g_schedulerListener = nullptr;
+static jmethodID g_onScheduledCodes = nullptr;
+
+// Runs on the scheduler thread, once per boundary
+static void deliverScheduledCodes(const std::vector<CodeSchedule::CodeGroup>& groups) {
+    JNIEnv* env = nullptr;
+    bool attached = false;
+    if (g_javaVm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) == JNI_EDETACHED) {
+        if (g_javaVm->AttachCurrentThread(&env, nullptr) != JNI_OK) {
+            return;
+        }
+        attached = true;
+    }
+
+    std::vector<std::string> ids;
+    std::vector<std::string> codes;
+    std::vector<jint> periods;
+    std::vector<jlong> validUntil;
+    for (const auto& group : groups) {
+        for (const auto& entry : group.codes) {
+            ids.push_back(entry.first);
+            codes.push_back(entry.second);
+            periods.push_back(group.period);
+            validUntil.push_back(group.validUntilMs);
+        }
+    }
+
+    const jsize count = static_cast<jsize>(ids.size());
+    jobjectArray idArray = vectorToStringArray(env, ids);
+    jobjectArray codeArray = vectorToStringArray(env, codes);
+    jintArray periodArray = env->NewIntArray(count);
+    env->SetIntArrayRegion(periodArray, 0, count, periods.data());
+    jlongArray validUntilArray = env->NewLongArray(count);
+    env->SetLongArrayRegion(validUntilArray, 0, count, validUntil.data());
+
+    env->CallVoidMethod(g_schedulerListener, g_onScheduledCodes, idArray, codeArray, periodArray, validUntilArray);
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+    }
+
+    env->DeleteLocalRef(idArray);
+    env->DeleteLocalRef(codeArray);
+    env->DeleteLocalRef(periodArray);
+    env->DeleteLocalRef(validUntilArray);
+    if (attached) {
+        g_javaVm->DetachCurrentThread();
+    }
 }
 
 JNIEXPORT jstring JNICALL
@@ -43,12 +310,13 @@ Java_dev_exzh_expo_otp_OtpNativeModule_generateTOTPNative(JNIEnv *env, jobject t
             return env->NewStringUTF("");
         }
         
-        std::string result = OtpGenerator::generateTOTP(secretStr, static_cast<uint64_t>(timeSlot), digits, algorithmStr);
+        char code[OTP_CODE_CAPACITY];
+        const int written = otp_generate_totp(secretStr, static_cast<uint64_t>(timeSlot), digits, algorithmStr, code, sizeof(code));
         
         safeReleaseStringUTFChars(env, secret, secretStr);
         safeReleaseStringUTFChars(env, algorithm, algorithmStr);
         
-        return createResultString(env, result);
+        return codeResultString(env, code, sizeof(code), written);
     } catch (const std::exception& e) {
         safeReleaseStringUTFChars(env, secret, secretStr);
         safeReleaseStringUTFChars(env, algorithm, algorithmStr);
@@ -72,12 +340,13 @@ Java_dev_exzh_expo_otp_OtpNativeModule_generateHOTPNative(JNIEnv *env, jobject t
             return env->NewStringUTF("");
         }
         
-        std::string result = OtpGenerator::generateHOTP(secretStr, static_cast<uint64_t>(counter), digits, algorithmStr);
+        char code[OTP_CODE_CAPACITY];
+        const int written = otp_generate_hotp(secretStr, static_cast<uint64_t>(counter), digits, algorithmStr, code, sizeof(code));
         
         safeReleaseStringUTFChars(env, secret, secretStr);
         safeReleaseStringUTFChars(env, algorithm, algorithmStr);
         
-        return createResultString(env, result);
+        return codeResultString(env, code, sizeof(code), written);
     } catch (const std::exception& e) {
         safeReleaseStringUTFChars(env, secret, secretStr);
         safeReleaseStringUTFChars(env, algorithm, algorithmStr);
@@ -101,12 +370,13 @@ Java_dev_exzh_expo_otp_OtpNativeModule_generateMOTPNative(JNIEnv *env, jobject t
             return env->NewStringUTF("");
         }
         
-        std::string result = OtpGenerator::generateMOTP(secretStr, pinStr, static_cast<uint64_t>(timeSlot));
+        char code[OTP_CODE_CAPACITY];
+        const int written = otp_generate_motp(secretStr, pinStr, static_cast<uint64_t>(timeSlot), 10, code, sizeof(code));
         
         safeReleaseStringUTFChars(env, secret, secretStr);
         safeReleaseStringUTFChars(env, pin, pinStr);
         
-        return createResultString(env, result);
+        return codeResultString(env, code, sizeof(code), written);
     } catch (const std::exception& e) {
         safeReleaseStringUTFChars(env, secret, secretStr);
         safeReleaseStringUTFChars(env, pin, pinStr);
@@ -130,12 +400,13 @@ Java_dev_exzh_expo_otp_OtpNativeModule_generateMOTPWithPeriodNative(JNIEnv *env,
             return env->NewStringUTF("");
         }
         
-        std::string result = OtpGenerator::generateMOTPWithPeriod(secretStr, pinStr, static_cast<uint64_t>(timeSlot), period);
+        char code[OTP_CODE_CAPACITY];
+        const int written = otp_generate_motp(secretStr, pinStr, static_cast<uint64_t>(timeSlot), period, code, sizeof(code));
         
         safeReleaseStringUTFChars(env, secret, secretStr);
         safeReleaseStringUTFChars(env, pin, pinStr);
         
-        return createResultString(env, result);
+        return codeResultString(env, code, sizeof(code), written);
     } catch (const std::exception& e) {
         safeReleaseStringUTFChars(env, secret, secretStr);
         safeReleaseStringUTFChars(env, pin, pinStr);
@@ -143,6 +414,38 @@ Java_dev_exzh_expo_otp_OtpNativeModule_generateMOTPWithPeriodNative(JNIEnv *env,
     }
 }
 
+JNIEXPORT jobjectArray JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_generateMOTPBatchNative(JNIEnv *env, jobject thiz, jobjectArray secrets,
+                                                               jobjectArray pins, jlong timeSlot, jintArray periods) {
+    try {
+        std::vector<std::string> secretList = stringArrayToVector(env, secrets);
+        std::vector<std::string> pinList = stringArrayToVector(env, pins);
+        const size_t count = secretList.size();
+        if (pinList.size() != count || env->GetArrayLength(periods) != static_cast<jsize>(count)) {
+            return nullptr;
+        }
+        std::vector<jint> periodList(count);
+        env->GetIntArrayRegion(periods, 0, static_cast<jsize>(count), periodList.data());
+
+        std::vector<OtpGenerator::MotpRequest> requests(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (periodList[i] > 0) {
+                requests[i] = {&secretList[i], &pinList[i], static_cast<uint64_t>(timeSlot) / periodList[i]};
+            } else {
+                requests[i] = {nullptr, nullptr, 0};
+            }
+        }
+
+        std::vector<std::string> codes = OtpGenerator::generateMOTPBatch(requests);
+        for (auto& secret : secretList) {
+            crypto_native::secureWipe(&secret[0], secret.size());
+        }
+        return vectorToStringArray(env, codes);
+    } catch (const std::exception& e) {
+        return nullptr;
+    }
+}
+
 JNIEXPORT jstring JNICALL
 Java_dev_exzh_expo_otp_OtpNativeModule_generateSteamGuardNative(JNIEnv *env, jobject thiz, jstring secret, jlong timeSlot) {
     const char* secretStr = nullptr;
@@ -156,17 +459,82 @@ Java_dev_exzh_expo_otp_OtpNativeModule_generateSteamGuardNative(JNIEnv *env, job
             return env->NewStringUTF("");
         }
         
-        std::string result = OtpGenerator::generateSteamGuard(secretStr, static_cast<uint64_t>(timeSlot));
+        char code[OTP_CODE_CAPACITY];
+        const int written = otp_generate_steam(secretStr, static_cast<uint64_t>(timeSlot), code, sizeof(code));
         
         safeReleaseStringUTFChars(env, secret, secretStr);
         
-        return createResultString(env, result);
+        return codeResultString(env, code, sizeof(code), written);
     } catch (const std::exception& e) {
         safeReleaseStringUTFChars(env, secret, secretStr);
         return env->NewStringUTF("");
     }
 }
 
+JNIEXPORT jobjectArray JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_generateOTPBatchNative(JNIEnv *env, jobject thiz, jobjectArray secrets,
+                                                              jobjectArray types, jlongArray counters,
+                                                              jintArray digits) {
+    try {
+        std::vector<std::string> secretList = stringArrayToVector(env, secrets);
+        std::vector<std::string> typeList = stringArrayToVector(env, types);
+        const size_t count = secretList.size();
+        if (typeList.size() != count || env->GetArrayLength(counters) != static_cast<jsize>(count) ||
+            env->GetArrayLength(digits) != static_cast<jsize>(count)) {
+            return nullptr;
+        }
+        std::vector<jlong> counterList(count);
+        std::vector<jint> digitList(count);
+        env->GetLongArrayRegion(counters, 0, static_cast<jsize>(count), counterList.data());
+        env->GetIntArrayRegion(digits, 0, static_cast<jsize>(count), digitList.data());
+
+        std::vector<OtpGenerator::OtpRequest> requests(count);
+        for (size_t i = 0; i < count; ++i) {
+            const bool steam = typeList[i] == "Steam";
+            requests[i] = {&secretList[i], static_cast<uint64_t>(counterList[i]), digitList[i],
+                           steam ? OtpGenerator::OtpEncoding::STEAM : OtpGenerator::OtpEncoding::DECIMAL};
+        }
+
+        std::vector<std::string> codes = OtpGenerator::generateOTPBatch(requests);
+        for (auto& secret : secretList) {
+            crypto_native::secureWipe(&secret[0], secret.size());
+        }
+        return vectorToStringArray(env, codes);
+    } catch (const std::exception& e) {
+        return nullptr;
+    }
+}
+
+JNIEXPORT jlong JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_resyncHOTPNative(JNIEnv *env, jobject thiz, jstring secret, jlong counter,
+                                                       jobjectArray codes, jint window, jint digits,
+                                                       jstring algorithm) {
+    const char* secretStr = nullptr;
+    const char* algorithmStr = nullptr;
+
+    try {
+        secretStr = safeGetStringUTFChars(env, secret);
+        algorithmStr = safeGetStringUTFChars(env, algorithm);
+        if (!secretStr || !algorithmStr || counter < 0) {
+            safeReleaseStringUTFChars(env, secret, secretStr);
+            safeReleaseStringUTFChars(env, algorithm, algorithmStr);
+            return -1;
+        }
+
+        std::vector<std::string> codeList = stringArrayToVector(env, codes);
+        int64_t result = OtpGenerator::resyncHOTP(secretStr, static_cast<uint64_t>(counter), codeList,
+                                                  window, digits, algorithmStr);
+
+        safeReleaseStringUTFChars(env, secret, secretStr);
+        safeReleaseStringUTFChars(env, algorithm, algorithmStr);
+        return static_cast<jlong>(result);
+    } catch (const std::exception& e) {
+        safeReleaseStringUTFChars(env, secret, secretStr);
+        safeReleaseStringUTFChars(env, algorithm, algorithmStr);
+        return -1;
+    }
+}
+
 JNIEXPORT jboolean JNICALL
 Java_dev_exzh_expo_otp_OtpNativeModule_validateSecretNative(JNIEnv *env, jobject thiz, jstring secret) {
     const char* secretStr = nullptr;
@@ -256,4 +624,378 @@ Java_dev_exzh_expo_otp_OtpNativeModule_base32EncodeNative(JNIEnv *env, jobject t
     }
 }
 
-} // extern "C" 
\ No newline at end of file
+JNIEXPORT jobject JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_parseOtpUrisNative(JNIEnv *env, jobject thiz, jobjectArray uris) {
+    try {
+        jsize count = uris ? env->GetArrayLength(uris) : 0;
+        std::vector<std::string> input;
+        input.reserve(count);
+        for (jsize i = 0; i < count; ++i) {
+            auto uri = static_cast<jstring>(env->GetObjectArrayElement(uris, i));
+            const char* uriStr = safeGetStringUTFChars(env, uri);
+            input.emplace_back(uriStr);
+            safeReleaseStringUTFChars(env, uri, uriStr);
+            env->DeleteLocalRef(uri);
+        }
+
+        OtpImport::ImportBatch batch = OtpImport::parseUris(input);
+
+        return importBatchToMap(env, batch);
+    } catch (const std::exception& e) {
+        return nullptr;
+    }
+}
+
+JNIEXPORT jobject JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_importBackupNative(JNIEnv *env, jobject thiz, jstring format,
+                                                          jstring path, jstring password) {
+    std::string passwordStr;
+    try {
+        const char* formatStr = safeGetStringUTFChars(env, format);
+        const std::string formatName(formatStr ? formatStr : "");
+        safeReleaseStringUTFChars(env, format, formatStr);
+        OtpImport::BackupFormat backupFormat;
+        if (formatName == "AEGIS") {
+            backupFormat = OtpImport::BackupFormat::AEGIS;
+        } else if (formatName == "ANDOTP") {
+            backupFormat = OtpImport::BackupFormat::ANDOTP;
+        } else if (formatName == "TWOFAS") {
+            backupFormat = OtpImport::BackupFormat::TWOFAS;
+        } else {
+            throw std::invalid_argument("Unknown backup format: " + formatName);
+        }
+
+        const char* pathStr = safeGetStringUTFChars(env, path);
+        const std::string backupPath(pathStr ? pathStr : "");
+        safeReleaseStringUTFChars(env, path, pathStr);
+
+        // Backups hold every secret the user has; read them straight into
+        // wiped memory rather than through a Java byte[]
+        crypto_native::SecureBytes data;
+        FILE* file = std::fopen(backupPath.c_str(), "rb");
+        if (!file) {
+            throw std::runtime_error("Cannot open " + backupPath);
+        }
+        uint8_t chunk[16384];
+        size_t read;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            if (data.size() + read > MAX_BACKUP_SIZE) {
+                std::fclose(file);
+                crypto_native::secureWipe(chunk, sizeof(chunk));
+                throw std::runtime_error("Backup file is too large");
+            }
+            data.insert(data.end(), chunk, chunk + read);
+        }
+        const bool failed = std::ferror(file) != 0;
+        std::fclose(file);
+        crypto_native::secureWipe(chunk, sizeof(chunk));
+        if (failed) {
+            throw std::runtime_error("Cannot read " + backupPath);
+        }
+
+        const char* passwordChars = safeGetStringUTFChars(env, password);
+        passwordStr.assign(passwordChars ? passwordChars : "");
+        safeReleaseStringUTFChars(env, password, passwordChars);
+
+        OtpImport::ImportBatch batch = OtpImport::parseBackup(backupFormat, data, passwordStr);
+        crypto_native::secureWipe(&passwordStr[0], passwordStr.size());
+
+        return importBatchToMap(env, batch);
+    } catch (const std::exception& e) {
+        if (!passwordStr.empty()) {
+            crypto_native::secureWipe(&passwordStr[0], passwordStr.size());
+        }
+        jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+        env->ThrowNew(exceptionClass, e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jboolean JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_configureServiceMatcherNative(JNIEnv *env, jobject thiz,
+                                                                      jobjectArray brands,
+                                                                      jobjectArray aliases,
+                                                                      jobjectArray aliasTargets,
+                                                                      jobjectArray categories,
+                                                                      jobjectArray categoryKeywords) {
+    try {
+        auto matcher = std::make_shared<ServiceClassifier::ServiceMatcher>();
+
+        for (const auto& brand : stringArrayToVector(env, brands)) {
+            matcher->addBrand(brand);
+        }
+
+        std::vector<std::string> aliasList = stringArrayToVector(env, aliases);
+        std::vector<std::string> targetList = stringArrayToVector(env, aliasTargets);
+        if (aliasList.size() != targetList.size()) {
+            return JNI_FALSE;
+        }
+        for (size_t i = 0; i < aliasList.size(); ++i) {
+            matcher->addAlias(aliasList[i], targetList[i]);
+        }
+
+        std::vector<std::string> categoryList = stringArrayToVector(env, categories);
+        jsize keywordSets = categoryKeywords ? env->GetArrayLength(categoryKeywords) : 0;
+        if (static_cast<size_t>(keywordSets) != categoryList.size()) {
+            return JNI_FALSE;
+        }
+        for (jsize i = 0; i < keywordSets; ++i) {
+            auto keywords = static_cast<jobjectArray>(env->GetObjectArrayElement(categoryKeywords, i));
+            matcher->addCategory(categoryList[i], stringArrayToVector(env, keywords));
+            env->DeleteLocalRef(keywords);
+        }
+
+        matcher->build();
+
+        std::lock_guard<std::mutex> lock(g_serviceMatcherMutex);
+        g_serviceMatcher = std::move(matcher);
+        return JNI_TRUE;
+    } catch (const std::exception& e) {
+        return JNI_FALSE;
+    }
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_classifyServicesNative(JNIEnv *env, jobject thiz, jobjectArray names) {
+    try {
+        std::shared_ptr<const ServiceClassifier::ServiceMatcher> matcher;
+        {
+            std::lock_guard<std::mutex> lock(g_serviceMatcherMutex);
+            matcher = g_serviceMatcher;
+        }
+        if (!matcher) {
+            return nullptr;
+        }
+
+        // Flattened [brand, category] pairs; null where nothing matched
+        jsize count = names ? env->GetArrayLength(names) : 0;
+        jclass stringClass = env->FindClass("java/lang/String");
+        jobjectArray result = env->NewObjectArray(count * 2, stringClass, nullptr);
+        for (jsize i = 0; i < count; ++i) {
+            auto name = static_cast<jstring>(env->GetObjectArrayElement(names, i));
+            const char* nameStr = safeGetStringUTFChars(env, name);
+            ServiceClassifier::Match match = matcher->classify(nameStr);
+            safeReleaseStringUTFChars(env, name, nameStr);
+            env->DeleteLocalRef(name);
+
+            if (match.brand) {
+                jstring brand = env->NewStringUTF(match.brand->c_str());
+                env->SetObjectArrayElement(result, i * 2, brand);
+                env->DeleteLocalRef(brand);
+            }
+            if (match.category) {
+                jstring category = env->NewStringUTF(match.category->c_str());
+                env->SetObjectArrayElement(result, i * 2 + 1, category);
+                env->DeleteLocalRef(category);
+            }
+        }
+        return result;
+    } catch (const std::exception& e) {
+        return nullptr;
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_searchIndexUpsertNative(JNIEnv *env, jobject thiz, jobjectArray ids,
+                                                                jobjectArray names, jobjectArray issuers,
+                                                                jobjectArray emails) {
+    try {
+        std::vector<std::string> idList = stringArrayToVector(env, ids);
+        std::vector<std::string> nameList = stringArrayToVector(env, names);
+        std::vector<std::string> issuerList = stringArrayToVector(env, issuers);
+        std::vector<std::string> emailList = stringArrayToVector(env, emails);
+        if (nameList.size() != idList.size() || issuerList.size() != idList.size() ||
+            emailList.size() != idList.size()) {
+            return -1;
+        }
+
+        std::lock_guard<std::mutex> lock(g_searchIndexMutex);
+        for (size_t i = 0; i < idList.size(); ++i) {
+            g_searchIndex.upsert(idList[i], nameList[i], issuerList[i], emailList[i]);
+        }
+        return static_cast<jint>(g_searchIndex.size());
+    } catch (const std::exception& e) {
+        return -1;
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_searchIndexRemoveNative(JNIEnv *env, jobject thiz, jobjectArray ids) {
+    try {
+        std::vector<std::string> idList = stringArrayToVector(env, ids);
+
+        std::lock_guard<std::mutex> lock(g_searchIndexMutex);
+        for (const auto& id : idList) {
+            g_searchIndex.remove(id);
+        }
+        return static_cast<jint>(g_searchIndex.size());
+    } catch (const std::exception& e) {
+        return -1;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_searchIndexClearNative(JNIEnv *env, jobject thiz) {
+    std::lock_guard<std::mutex> lock(g_searchIndexMutex);
+    g_searchIndex.clear();
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_searchIndexQueryNative(JNIEnv *env, jobject thiz, jstring query, jint limit) {
+    try {
+        const char* queryStr = safeGetStringUTFChars(env, query);
+        std::string queryText(queryStr);
+        safeReleaseStringUTFChars(env, query, queryStr);
+
+        jclass stringClass = env->FindClass("java/lang/String");
+
+        // Ids point into the index, so convert them before releasing the lock
+        std::lock_guard<std::mutex> lock(g_searchIndexMutex);
+        std::vector<const std::string*> ids = g_searchIndex.query(queryText, limit > 0 ? static_cast<size_t>(limit) : 0);
+        jobjectArray result = env->NewObjectArray(static_cast<jsize>(ids.size()), stringClass, nullptr);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            jstring id = newJavaString(env, *ids[i]);
+            env->SetObjectArrayElement(result, static_cast<jsize>(i), id);
+            env->DeleteLocalRef(id);
+        }
+        return result;
+    } catch (const std::exception& e) {
+        return nullptr;
+    }
+}
+
+JNIEXPORT jobject JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_scanMailboxNative(JNIEnv *env, jobject thiz, jstring path, jint maxResults) {
+    try {
+        const char* pathStr = safeGetStringUTFChars(env, path);
+        std::string mailboxPath(pathStr);
+        safeReleaseStringUTFChars(env, path, pathStr);
+
+        std::vector<MailExtract::MessageFindings> messages;
+        MailExtract::ScanStats stats = MailExtract::scanMailbox(mailboxPath, [&](MailExtract::MessageFindings&& findings) {
+            messages.push_back(std::move(findings));
+            return maxResults <= 0 || messages.size() < static_cast<size_t>(maxResults);
+        });
+        if (!stats.opened) {
+            return nullptr;
+        }
+
+        jclass hashMapClass = env->FindClass("java/util/HashMap");
+        jmethodID hashMapInit = env->GetMethodID(hashMapClass, "<init>", "()V");
+        jmethodID putMethod = env->GetMethodID(hashMapClass, "put",
+                                               "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+        jclass doubleClass = env->FindClass("java/lang/Double");
+        jmethodID doubleValueOf = env->GetStaticMethodID(doubleClass, "valueOf", "(D)Ljava/lang/Double;");
+        jclass objectClass = env->FindClass("java/lang/Object");
+
+        jobjectArray messageArray = env->NewObjectArray(static_cast<jsize>(messages.size()), objectClass, nullptr);
+        for (size_t i = 0; i < messages.size(); ++i) {
+            const MailExtract::MessageFindings& message = messages[i];
+            jobject map = env->NewObject(hashMapClass, hashMapInit);
+            putInMap(env, map, putMethod, "messageId", newJavaString(env, message.messageId));
+            putInMap(env, map, putMethod, "from", newJavaString(env, message.from));
+            putInMap(env, map, putMethod, "subject", newJavaString(env, message.subject));
+            putInMap(env, map, putMethod, "date", newJavaString(env, message.date));
+            putInMap(env, map, putMethod, "codes", vectorToStringArray(env, message.codes));
+            putInMap(env, map, putMethod, "setupUris", vectorToStringArray(env, message.setupUris));
+            putInMap(env, map, putMethod, "secrets", vectorToStringArray(env, message.secrets));
+            putInMap(env, map, putMethod, "activationUrls", vectorToStringArray(env, message.activationUrls));
+            env->SetObjectArrayElement(messageArray, static_cast<jsize>(i), map);
+            env->DeleteLocalRef(map);
+        }
+
+        jobject result = env->NewObject(hashMapClass, hashMapInit);
+        putInMap(env, result, putMethod, "messages", messageArray);
+        putInMap(env, result, putMethod, "scanned",
+                 env->CallStaticObjectMethod(doubleClass, doubleValueOf, static_cast<jdouble>(stats.messages)));
+        putInMap(env, result, putMethod, "bytes",
+                 env->CallStaticObjectMethod(doubleClass, doubleValueOf, static_cast<jdouble>(stats.bytes)));
+        putInMap(env, result, putMethod, "truncated",
+                 env->CallStaticObjectMethod(doubleClass, doubleValueOf, static_cast<jdouble>(stats.truncated)));
+        return result;
+    } catch (const std::exception& e) {
+        return nullptr;
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_scheduleCodesNative(JNIEnv *env, jobject thiz, jobjectArray ids,
+                                                           jobjectArray types, jobjectArray secrets,
+                                                           jobjectArray pins, jintArray digits,
+                                                           jobjectArray algorithms, jintArray periods) {
+    std::vector<std::string> secretList;
+    std::vector<std::string> pinList;
+    std::vector<CodeSchedule::Account> accounts;
+    ScheduleSecretsGuard guard{secretList, pinList, accounts};
+    try {
+        std::vector<std::string> idList = stringArrayToVector(env, ids);
+        std::vector<std::string> typeList = stringArrayToVector(env, types);
+        secretList = stringArrayToVector(env, secrets);
+        pinList = stringArrayToVector(env, pins);
+        std::vector<std::string> algorithmList = stringArrayToVector(env, algorithms);
+        const size_t count = idList.size();
+        if (typeList.size() != count || secretList.size() != count || pinList.size() != count ||
+            algorithmList.size() != count || env->GetArrayLength(digits) != static_cast<jsize>(count) ||
+            env->GetArrayLength(periods) != static_cast<jsize>(count)) {
+            return -1;
+        }
+
+        std::vector<jint> digitList(count);
+        std::vector<jint> periodList(count);
+        env->GetIntArrayRegion(digits, 0, static_cast<jsize>(count), digitList.data());
+        env->GetIntArrayRegion(periods, 0, static_cast<jsize>(count), periodList.data());
+
+        accounts.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            CodeSchedule::Kind kind;
+            if (typeList[i] == "TOTP") {
+                kind = CodeSchedule::Kind::TOTP;
+            } else if (typeList[i] == "Steam") {
+                kind = CodeSchedule::Kind::STEAM;
+            } else if (typeList[i] == "mOTP") {
+                kind = CodeSchedule::Kind::MOTP;
+            } else {
+                continue; // HOTP codes only change on demand
+            }
+            // Filled in place so no temporary Account is left holding a secret
+            CodeSchedule::Account& account = accounts.emplace_back();
+            account.kind = kind;
+            account.id = std::move(idList[i]);
+            account.secret = std::move(secretList[i]);
+            account.pin = std::move(pinList[i]);
+            account.digits = digitList[i];
+            account.algorithm = std::move(algorithmList[i]);
+            account.period = periodList[i];
+        }
+
+        std::lock_guard<std::mutex> lock(g_schedulerMutex);
+        if (!g_scheduler) {
+            jclass moduleClass = env->GetObjectClass(thiz);
+            g_onScheduledCodes = env->GetMethodID(moduleClass, "onScheduledCodes",
+                                                  "([Ljava/lang/String;[Ljava/lang/String;[I[J)V");
+            env->DeleteLocalRef(moduleClass);
+            if (!g_onScheduledCodes) {
+                return -1;
+            }
+            env->GetJavaVM(&g_javaVm);
+            g_schedulerListener = env->NewGlobalRef(thiz);
+            g_scheduler.reset(new CodeSchedule::Scheduler(deliverScheduledCodes));
+        }
+        return static_cast<jint>(g_scheduler->setAccounts(std::move(accounts)));
+    } catch (const std::exception& e) {
+        return -1;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_exzh_expo_otp_OtpNativeModule_stopCodeSchedulerNative(JNIEnv *env, jobject thiz) {
+    std::lock_guard<std::mutex> lock(g_schedulerMutex);
+    // Joins the worker, so no delivery is in flight once the listener is released
+    g_scheduler.reset();
+    if (g_schedulerListener) {
+        env->DeleteGlobalRef(g_schedulerListener);
+        g_schedulerListener = nullptr;
+    }
+}
+
+} // extern "C"
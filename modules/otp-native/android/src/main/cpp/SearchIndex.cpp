@@ -0,0 +1,315 @@
+#include "SearchIndex.h"
+#include <algorithm>
+#include <cctype>
+
+namespace AccountSearch {
+
+namespace {
+    constexpr size_t MAX_FUZZY_QUERY = 64;
+    constexpr size_t MIN_REBUILD_SLOTS = 64;
+
+    // Base scores per match kind; field weights are added on top
+    constexpr int SCORE_EXACT = 1000;
+    constexpr int SCORE_PREFIX = 800;
+    constexpr int SCORE_WORD_PREFIX = 600;
+    constexpr int SCORE_SUBSTRING = 400;
+    constexpr int SCORE_FUZZY = 200;
+    constexpr int SCORE_PER_TYPO = 50;
+    constexpr int FIELD_WEIGHT[SearchIndex::FIELD_COUNT] = {30, 20, 10};
+    constexpr int MAX_SCORE = SCORE_EXACT + 30;
+
+    std::string normalize(const std::string& input) {
+        size_t begin = 0;
+        size_t end = input.size();
+        while (begin < end && std::isspace(static_cast<unsigned char>(input[begin]))) ++begin;
+        while (end > begin && std::isspace(static_cast<unsigned char>(input[end - 1]))) --end;
+
+        std::string result(input, begin, end - begin);
+        for (char& c : result) {
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+        }
+        return result;
+    }
+
+    inline uint32_t trigramKey(const char* p) {
+        return (static_cast<uint32_t>(static_cast<uint8_t>(p[0])) << 16) |
+               (static_cast<uint32_t>(static_cast<uint8_t>(p[1])) << 8) |
+               static_cast<uint32_t>(static_cast<uint8_t>(p[2]));
+    }
+
+    void collectTrigrams(const std::string& text, std::vector<uint32_t>& keys) {
+        for (size_t i = 0; i + 3 <= text.size(); ++i) {
+            keys.push_back(trigramKey(text.data() + i));
+        }
+    }
+
+    inline bool isWordChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || (static_cast<unsigned char>(c) & 0x80);
+    }
+
+    /**
+     * Smallest edit distance between the query and any substring of the
+     * text (Sellers), giving up once it cannot be within maxDistance
+     */
+    int approximateDistance(const std::string& text, const std::string& query, int maxDistance) {
+        const size_t m = query.size();
+        int column[MAX_FUZZY_QUERY + 1];
+        for (size_t i = 0; i <= m; ++i) {
+            column[i] = static_cast<int>(i);
+        }
+
+        int best = column[m];
+        for (char t : text) {
+            int diagonal = column[0];
+            column[0] = 0;
+            for (size_t i = 1; i <= m; ++i) {
+                const int above = column[i];
+                int value = diagonal + (query[i - 1] != t ? 1 : 0);
+                value = std::min(value, above + 1);
+                value = std::min(value, column[i - 1] + 1);
+                column[i] = value;
+                diagonal = above;
+            }
+            best = std::min(best, column[m]);
+            if (best == 0) {
+                break;
+            }
+        }
+        return best <= maxDistance ? best : -1;
+    }
+
+    int scoreField(const std::string& field, const std::string& query, int maxTypos) {
+        if (field.empty()) {
+            return -1;
+        }
+        if (field == query) {
+            return SCORE_EXACT;
+        }
+
+        size_t position = field.find(query);
+        if (position == 0) {
+            return SCORE_PREFIX;
+        }
+        if (position != std::string::npos) {
+            for (; position != std::string::npos; position = field.find(query, position + 1)) {
+                if (!isWordChar(field[position - 1])) {
+                    return SCORE_WORD_PREFIX;
+                }
+            }
+            return SCORE_SUBSTRING;
+        }
+
+        if (maxTypos > 0) {
+            const int distance = approximateDistance(field, query, maxTypos);
+            if (distance >= 0) {
+                return SCORE_FUZZY - SCORE_PER_TYPO * distance;
+            }
+        }
+        return -1;
+    }
+
+    inline void appendVarint(std::vector<uint8_t>& out, uint32_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+}
+
+void SearchIndex::upsert(const std::string& id, const std::string& name,
+                         const std::string& issuer, const std::string& email) {
+    remove(id);
+
+    Document document;
+    document.id = id;
+    document.fields[NAME] = normalize(name);
+    document.fields[ISSUER] = normalize(issuer);
+    document.fields[EMAIL] = normalize(email);
+    document.live = true;
+    appendDocument(std::move(document));
+}
+
+void SearchIndex::appendDocument(Document document) {
+    const uint32_t slot = static_cast<uint32_t>(documents_.size());
+
+    std::vector<uint32_t> keys;
+    for (const auto& field : document.fields) {
+        collectTrigrams(field, keys);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    // Slots only grow, so each posting stays sorted by appending
+    for (uint32_t key : keys) {
+        Posting& posting = postings_[key];
+        appendVarint(posting.bytes, posting.count ? slot - posting.last : slot);
+        posting.last = slot;
+        ++posting.count;
+    }
+
+    slots_[document.id] = slot;
+    documents_.push_back(std::move(document));
+    ++live_;
+}
+
+bool SearchIndex::remove(const std::string& id) {
+    auto it = slots_.find(id);
+    if (it == slots_.end()) {
+        return false;
+    }
+
+    Document& document = documents_[it->second];
+    document.live = false;
+    for (auto& field : document.fields) {
+        std::string().swap(field);
+    }
+    slots_.erase(it);
+    --live_;
+
+    const size_t dead = documents_.size() - live_;
+    if (dead >= MIN_REBUILD_SLOTS && dead > live_) {
+        rebuild();
+    }
+    return true;
+}
+
+void SearchIndex::clear() {
+    documents_.clear();
+    slots_.clear();
+    postings_.clear();
+    live_ = 0;
+}
+
+void SearchIndex::rebuild() {
+    std::vector<Document> documents;
+    documents.swap(documents_);
+    clear();
+    for (auto& document : documents) {
+        if (document.live) {
+            appendDocument(std::move(document));
+        }
+    }
+}
+
+size_t SearchIndex::postingBytes() const {
+    size_t total = 0;
+    for (const auto& entry : postings_) {
+        total += entry.second.bytes.size();
+    }
+    return total;
+}
+
+int SearchIndex::scoreDocument(const Document& document, const std::string& query, int maxTypos) const {
+    int best = -1;
+    for (int field = 0; field < FIELD_COUNT; ++field) {
+        const int score = scoreField(document.fields[field], query, maxTypos);
+        if (score >= 0) {
+            best = std::max(best, score + FIELD_WEIGHT[field]);
+        }
+    }
+    return best;
+}
+
+std::vector<const std::string*> SearchIndex::query(const std::string& rawQuery, size_t limit) const {
+    std::vector<const std::string*> results;
+    const std::string query = normalize(rawQuery);
+    if (query.empty() || live_ == 0) {
+        return results;
+    }
+
+    std::vector<std::pair<int, uint32_t>> ranked;
+
+    if (query.size() < 3) {
+        // No trigram to look up; the stored fields are small enough to scan
+        for (uint32_t slot = 0; slot < documents_.size(); ++slot) {
+            if (!documents_[slot].live) {
+                continue;
+            }
+            const int score = scoreDocument(documents_[slot], query, 0);
+            if (score >= 0) {
+                ranked.emplace_back(score, slot);
+            }
+        }
+    } else {
+        std::vector<uint32_t> keys;
+        collectTrigrams(query, keys);
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        // One count per distinct query trigram; a byte would saturate on long
+        // pasted queries and then nothing could reach the literal threshold
+        std::vector<uint32_t> hits(documents_.size(), 0);
+        for (uint32_t key : keys) {
+            auto it = postings_.find(key);
+            if (it == postings_.end()) {
+                continue;
+            }
+            const std::vector<uint8_t>& bytes = it->second.bytes;
+            uint32_t slot = 0;
+            for (size_t i = 0, n = 0; i < bytes.size(); ++n) {
+                uint32_t delta = 0;
+                int shift = 0;
+                uint8_t byte;
+                do {
+                    byte = bytes[i++];
+                    delta |= static_cast<uint32_t>(byte & 0x7F) << shift;
+                    shift += 7;
+                } while (byte & 0x80);
+                slot = n ? slot + delta : delta;
+                ++hits[slot];
+            }
+        }
+
+        const uint32_t total = static_cast<uint32_t>(keys.size());
+        auto collect = [&](uint32_t threshold, int maxTypos) {
+            for (uint32_t slot = 0; slot < documents_.size(); ++slot) {
+                if (hits[slot] < threshold || !documents_[slot].live) {
+                    continue;
+                }
+                const int score = scoreDocument(documents_[slot], query, maxTypos);
+                if (score >= 0) {
+                    ranked.emplace_back(score, slot);
+                }
+            }
+        };
+
+        // A literal match contains every trigram of the query. Typo matches
+        // are only considered when nothing matches literally; each typo can
+        // break up to three trigrams.
+        collect(total, 0);
+        const int maxTypos = query.size() < 4 ? 0
+                           : query.size() < 8 ? 1
+                           : query.size() <= MAX_FUZZY_QUERY ? 2
+                           : 0;
+        if (ranked.empty() && maxTypos > 0) {
+            const uint32_t broken = 3 * static_cast<uint32_t>(maxTypos);
+            collect(total > broken ? total - broken : 1, maxTypos);
+        }
+    }
+
+    // Scores are small integers and candidates arrive in slot order, so a
+    // counting sort ranks them stably in linear time
+    std::vector<uint32_t> offsets(MAX_SCORE + 2, 0);
+    for (const auto& entry : ranked) {
+        ++offsets[MAX_SCORE - entry.first + 1];
+    }
+    for (size_t i = 1; i < offsets.size(); ++i) {
+        offsets[i] += offsets[i - 1];
+    }
+    std::vector<uint32_t> order(ranked.size());
+    for (const auto& entry : ranked) {
+        order[offsets[MAX_SCORE - entry.first]++] = entry.second;
+    }
+
+    const size_t count = limit > 0 ? std::min(limit, order.size()) : order.size();
+    results.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        results.push_back(&documents_[order[i]].id);
+    }
+    return results;
+}
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace AccountSearch {
+    /**
+     * Incremental trigram index over account name, issuer and email.
+     *
+     * Documents get monotonically increasing slots, so every posting list is
+     * a sorted run of slots stored as delta varints and adding a document is
+     * a pure append. Removal tombstones the slot; the index is rebuilt once
+     * dead slots outnumber live ones.
+     *
+     * Queries of three or more bytes gather candidates from the postings and
+     * verify them; shorter queries scan the stored fields directly. Results
+     * are ranked exact > prefix > word prefix > substring, with name
+     * outranking issuer outranking email. When nothing matches literally,
+     * matches within one or two edits are returned instead.
+     */
+    class SearchIndex {
+    public:
+        enum Field {
+            NAME = 0,
+            ISSUER = 1,
+            EMAIL = 2,
+            FIELD_COUNT = 3
+        };
+
+        /**
+         * Add an account or replace its indexed fields
+         */
+        void upsert(const std::string& id, const std::string& name,
+                    const std::string& issuer, const std::string& email);
+
+        /**
+         * Remove an account
+         * @return False if the id was not indexed
+         */
+        bool remove(const std::string& id);
+
+        void clear();
+
+        /**
+         * Search the index
+         * @param query Query text, matched case-insensitively (ASCII)
+         * @param limit Maximum number of results, 0 for all
+         * @return Matching account ids, best match first; valid until the
+         *         index is next modified
+         */
+        std::vector<const std::string*> query(const std::string& query, size_t limit) const;
+
+        size_t size() const { return live_; }
+
+        // Encoded size of all posting lists in bytes
+        size_t postingBytes() const;
+
+    private:
+        struct Document {
+            std::string id;
+            std::string fields[FIELD_COUNT];
+            bool live;
+        };
+
+        struct Posting {
+            std::vector<uint8_t> bytes;
+            uint32_t last = 0;
+            uint32_t count = 0;
+        };
+
+        void appendDocument(Document document);
+        void rebuild();
+        int scoreDocument(const Document& document, const std::string& query, int maxTypos) const;
+
+        std::vector<Document> documents_;
+        std::unordered_map<std::string, uint32_t> slots_;
+        std::unordered_map<uint32_t, Posting> postings_;
+        size_t live_ = 0;
+    };
+}
@@ -0,0 +1,195 @@
+#include "ServiceMatcher.h"
+#include <cctype>
+#include <deque>
+#include <stdexcept>
+
+namespace ServiceClassifier {
+
+namespace {
+    inline uint8_t lowerByte(uint8_t c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<uint8_t>(c - 'A' + 'a') : c;
+    }
+
+    std::string normalize(const std::string& input) {
+        size_t begin = 0;
+        size_t end = input.size();
+        while (begin < end && std::isspace(static_cast<unsigned char>(input[begin]))) ++begin;
+        while (end > begin && std::isspace(static_cast<unsigned char>(input[end - 1]))) --end;
+
+        std::string result(input, begin, end - begin);
+        for (char& c : result) {
+            c = static_cast<char>(lowerByte(static_cast<uint8_t>(c)));
+        }
+        return result;
+    }
+
+    inline void keepFirst(int32_t& current, int32_t candidate) {
+        if (candidate >= 0 && (current < 0 || candidate < current)) {
+            current = candidate;
+        }
+    }
+}
+
+void ServiceMatcher::addBrand(const std::string& brand) {
+    const std::string key = normalize(brand);
+    if (key.empty()) {
+        return;
+    }
+    const int32_t index = static_cast<int32_t>(brands_.size());
+    brands_.push_back(key);
+    addPattern(key, BRAND, index);
+
+    brandExact_.emplace(key, index);
+    for (size_t start = 0; start < key.size(); ++start) {
+        for (size_t length = 1; start + length <= key.size(); ++length) {
+            brandSubstrings_.emplace(key.substr(start, length), index);
+        }
+    }
+}
+
+void ServiceMatcher::addAlias(const std::string& alias, const std::string& brand) {
+    const std::string key = normalize(alias);
+    if (key.empty()) {
+        return;
+    }
+    const int32_t index = static_cast<int32_t>(aliasTargets_.size());
+    aliasTargets_.push_back(normalize(brand));
+    addPattern(key, ALIAS, index);
+}
+
+void ServiceMatcher::addCategory(const std::string& category, const std::vector<std::string>& keywords) {
+    const int32_t index = static_cast<int32_t>(categories_.size());
+    categories_.push_back(category);
+    for (const auto& keyword : keywords) {
+        const std::string key = normalize(keyword);
+        if (!key.empty()) {
+            addPattern(key, CATEGORY, index);
+        }
+    }
+}
+
+void ServiceMatcher::addPattern(const std::string& pattern, Kind kind, int32_t index) {
+    if (built_) {
+        throw std::logic_error("ServiceMatcher already built");
+    }
+    if (trie_.empty()) {
+        trie_.emplace_back();
+        output_.emplace_back();
+    }
+
+    int32_t node = 0;
+    for (char c : pattern) {
+        const uint8_t byte = static_cast<uint8_t>(c);
+        auto it = trie_[node].find(byte);
+        if (it == trie_[node].end()) {
+            const int32_t child = static_cast<int32_t>(trie_.size());
+            trie_[node].emplace(byte, child);
+            trie_.emplace_back();
+            output_.emplace_back();
+            node = child;
+        } else {
+            node = it->second;
+        }
+    }
+    keepFirst(output_[node].best[kind], index);
+}
+
+void ServiceMatcher::build() {
+    if (trie_.empty()) {
+        trie_.emplace_back();
+        output_.emplace_back();
+    }
+
+    // Bytes that never occur in a pattern all share class 0
+    byteClass_.fill(0);
+    classCount_ = 1;
+    for (const auto& edges : trie_) {
+        for (const auto& edge : edges) {
+            if (!byteClass_[edge.first]) {
+                byteClass_[edge.first] = static_cast<uint8_t>(classCount_++);
+            }
+        }
+    }
+
+    const size_t nodes = trie_.size();
+    next_.assign(nodes * classCount_, 0);
+    std::vector<int32_t> fail(nodes, 0);
+
+    // Breadth-first: resolve failure links into a full DFA and fold each
+    // node's outputs with those of its failure node
+    std::deque<int32_t> queue;
+    for (const auto& edge : trie_[0]) {
+        next_[byteClass_[edge.first]] = edge.second;
+        queue.push_back(edge.second);
+    }
+    while (!queue.empty()) {
+        const int32_t node = queue.front();
+        queue.pop_front();
+
+        for (int kind = 0; kind < KIND_COUNT; ++kind) {
+            keepFirst(output_[node].best[kind], output_[fail[node]].best[kind]);
+        }
+
+        int32_t* row = &next_[static_cast<size_t>(node) * classCount_];
+        const int32_t* failRow = &next_[static_cast<size_t>(fail[node]) * classCount_];
+        for (uint32_t cls = 0; cls < classCount_; ++cls) {
+            row[cls] = failRow[cls];
+        }
+        for (const auto& edge : trie_[node]) {
+            const uint8_t cls = byteClass_[edge.first];
+            fail[edge.second] = failRow[cls];
+            row[cls] = edge.second;
+            queue.push_back(edge.second);
+        }
+    }
+
+    trie_.clear();
+    trie_.shrink_to_fit();
+    built_ = true;
+}
+
+Match ServiceMatcher::classify(const std::string& serviceName) const {
+    Match match;
+    if (!built_) {
+        return match;
+    }
+
+    const std::string name = normalize(serviceName);
+    if (name.empty()) {
+        return match;
+    }
+
+    Output found;
+    int32_t state = 0;
+    for (char c : name) {
+        state = next_[static_cast<size_t>(state) * classCount_ + byteClass_[static_cast<uint8_t>(c)]];
+        const Output& out = output_[state];
+        for (int kind = 0; kind < KIND_COUNT; ++kind) {
+            keepFirst(found.best[kind], out.best[kind]);
+        }
+    }
+
+    int32_t brand = -1;
+    auto exact = brandExact_.find(name);
+    if (exact != brandExact_.end()) {
+        brand = exact->second;
+    } else {
+        brand = found.best[BRAND];
+        auto reverse = brandSubstrings_.find(name);
+        if (reverse != brandSubstrings_.end()) {
+            keepFirst(brand, reverse->second);
+        }
+    }
+
+    if (brand >= 0) {
+        match.brand = &brands_[brand];
+    } else if (found.best[ALIAS] >= 0) {
+        match.brand = &aliasTargets_[found.best[ALIAS]];
+    }
+    if (found.best[CATEGORY] >= 0) {
+        match.category = &categories_[found.best[CATEGORY]];
+    }
+    return match;
+}
+
+}
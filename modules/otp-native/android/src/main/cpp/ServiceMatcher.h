@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace ServiceClassifier {
+    struct Match {
+        const std::string* brand = nullptr;     // Matched brand key, or null
+        const std::string* category = nullptr;  // Matched category, or null
+    };
+
+    /**
+     * Aho-Corasick automaton over brand names, brand aliases and category
+     * keywords. Built once; each classification is a single pass over the
+     * lowercased service name and does not depend on the number of patterns.
+     *
+     * Resolution mirrors the JS rules it replaces:
+     *  - brand: exact name, then the first brand (in table order) that is
+     *    contained in the name or contains it, then the first alias contained
+     *    in the name
+     *  - category: the first category (in table order) with any keyword
+     *    contained in the name
+     */
+    class ServiceMatcher {
+    public:
+        void addBrand(const std::string& brand);
+        void addAlias(const std::string& alias, const std::string& brand);
+        void addCategory(const std::string& category, const std::vector<std::string>& keywords);
+
+        // Compiles the automaton; must be called after the tables are added
+        void build();
+
+        Match classify(const std::string& serviceName) const;
+
+    private:
+        enum Kind {
+            BRAND = 0,
+            ALIAS = 1,
+            CATEGORY = 2,
+            KIND_COUNT = 3
+        };
+
+        struct Output {
+            int32_t best[KIND_COUNT] = {-1, -1, -1};
+        };
+
+        void addPattern(const std::string& pattern, Kind kind, int32_t index);
+
+        std::vector<std::string> brands_;
+        std::vector<std::string> aliasTargets_;
+        std::vector<std::string> categories_;
+
+        // Build-time trie (sparse) and its patterns
+        std::vector<std::unordered_map<uint8_t, int32_t>> trie_;
+        std::vector<Output> output_;
+
+        // Compiled DFA over compressed byte classes
+        std::array<uint8_t, 256> byteClass_{};
+        uint32_t classCount_ = 1;
+        std::vector<int32_t> next_;
+
+        // Reverse direction: every substring of a brand name -> first brand index
+        std::unordered_map<std::string, int32_t> brandSubstrings_;
+        std::unordered_map<std::string, int32_t> brandExact_;
+        bool built_ = false;
+    };
+}
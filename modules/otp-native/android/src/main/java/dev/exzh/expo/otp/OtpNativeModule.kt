@@ -13,6 +13,13 @@ class OtpNativeModule : Module() {
     // The module will be accessible from `requireNativeModule('OtpNative')` in JavaScript.
     Name("OtpNative")
 
+    // Emitted by the native scheduler once per period boundary
+    Events("onCodesChanged")
+
+    OnDestroy {
+      stopCodeSchedulerNative()
+    }
+
     // OTP generation functions
     Function("generateTOTP") { secret: String, timeSlot: Double, digits: Int, algorithm: String ->
       generateTOTPNative(secret, timeSlot.toLong(), digits, algorithm)
@@ -30,10 +37,28 @@ class OtpNativeModule : Module() {
       generateMOTPWithPeriodNative(secret, pin, timeSlot.toLong(), period)
     }
 
+    Function("generateMOTPBatch") { secrets: List<String>, pins: List<String>, timeSlot: Double, periods: List<Int> ->
+      generateMOTPBatchNative(secrets.toTypedArray(), pins.toTypedArray(), timeSlot.toLong(), periods.toIntArray())
+        ?.toList() ?: emptyList()
+    }
+
     Function("generateSteamGuard") { secret: String, timeSlot: Double ->
       generateSteamGuardNative(secret, timeSlot.toLong())
     }
 
+    Function("generateOTPBatch") { secrets: List<String>, types: List<String>, counters: List<Double>, digits: List<Int> ->
+      generateOTPBatchNative(
+        secrets.toTypedArray(),
+        types.toTypedArray(),
+        counters.map { it.toLong() }.toLongArray(),
+        digits.toIntArray()
+      )?.toList() ?: emptyList()
+    }
+
+    Function("resyncHOTP") { secret: String, counter: Double, codes: List<String>, window: Int, digits: Int, algorithm: String ->
+      resyncHOTPNative(secret, counter.toLong(), codes.toTypedArray(), window, digits, algorithm).toDouble()
+    }
+
     // Utility functions
     Function("validateSecret") { secret: String ->
       validateSecretNative(secret)
@@ -46,6 +71,96 @@ class OtpNativeModule : Module() {
     Function("base32Encode") { data: ByteArray ->
       base32EncodeNative(data)
     }
+
+    // Import functions
+    Function("parseOtpUris") { uris: List<String> ->
+      val result = parseOtpUrisNative(uris.toTypedArray())
+      mapOf(
+        "accounts" to ((result?.get("accounts") as? Array<*>)?.toList() ?: emptyList<Any>()),
+        "rejected" to (result?.get("rejected") ?: uris.size)
+      )
+    }
+
+    // Backup import runs off the JS thread; encrypted backups cost one KDF run
+    AsyncFunction("importBackup") { format: String, path: String, password: String ->
+      val result = try {
+        importBackupNative(format, path, password)
+      } catch (e: RuntimeException) {
+        throw Exception("Backup import failed: ${e.message}")
+      } ?: throw Exception("Backup import failed: cannot read $path")
+      mapOf(
+        "accounts" to ((result["accounts"] as? Array<*>)?.toList() ?: emptyList<Any>()),
+        "rejected" to result["rejected"]
+      )
+    }
+
+    // Mailbox extraction runs off the JS thread; it reads whole mailboxes
+    AsyncFunction("scanMailbox") { path: String, maxResults: Int ->
+      val result = scanMailboxNative(path, maxResults)
+        ?: throw Exception("Scan mailbox failed: cannot open $path")
+      val messages = (result["messages"] as? Array<*>)?.map { message ->
+        (message as Map<*, *>).mapValues { (_, value) -> if (value is Array<*>) value.toList() else value }
+      } ?: emptyList()
+      mapOf(
+        "messages" to messages,
+        "scanned" to result["scanned"],
+        "bytes" to result["bytes"],
+        "truncated" to result["truncated"]
+      )
+    }
+
+    // Service classification functions
+    Function("configureServiceMatcher") { brands: List<String>, aliases: List<String>, aliasTargets: List<String>,
+                                          categories: List<String>, categoryKeywords: List<List<String>> ->
+      configureServiceMatcherNative(
+        brands.toTypedArray(),
+        aliases.toTypedArray(),
+        aliasTargets.toTypedArray(),
+        categories.toTypedArray(),
+        categoryKeywords.map { it.toTypedArray() }.toTypedArray()
+      )
+    }
+
+    Function("classifyServices") { names: List<String> ->
+      classifyServicesNative(names.toTypedArray())?.let { pairs ->
+        names.indices.map { i -> mapOf("brand" to pairs[i * 2], "category" to pairs[i * 2 + 1]) }
+      }
+    }
+
+    // Account search functions
+    Function("searchIndexUpsert") { ids: List<String>, names: List<String>, issuers: List<String>, emails: List<String> ->
+      searchIndexUpsertNative(ids.toTypedArray(), names.toTypedArray(), issuers.toTypedArray(), emails.toTypedArray())
+    }
+
+    Function("searchIndexRemove") { ids: List<String> ->
+      searchIndexRemoveNative(ids.toTypedArray())
+    }
+
+    Function("searchIndexClear") {
+      searchIndexClearNative()
+    }
+
+    Function("searchIndexQuery") { query: String, limit: Int ->
+      searchIndexQueryNative(query, limit)?.toList() ?: emptyList()
+    }
+
+    // Code scheduler functions
+    Function("scheduleCodes") { ids: List<String>, types: List<String>, secrets: List<String>, pins: List<String>,
+                                digits: List<Int>, algorithms: List<String>, periods: List<Int> ->
+      scheduleCodesNative(
+        ids.toTypedArray(),
+        types.toTypedArray(),
+        secrets.toTypedArray(),
+        pins.toTypedArray(),
+        digits.toIntArray(),
+        algorithms.toTypedArray(),
+        periods.toIntArray()
+      )
+    }
+
+    Function("stopCodeScheduler") {
+      stopCodeSchedulerNative()
+    }
   }
 
   // Native method declarations
@@ -53,10 +168,73 @@ class OtpNativeModule : Module() {
   private external fun generateHOTPNative(secret: String, counter: Long, digits: Int, algorithm: String): String
   private external fun generateMOTPNative(secret: String, pin: String, timeSlot: Long): String
   private external fun generateMOTPWithPeriodNative(secret: String, pin: String, timeSlot: Long, period: Int): String
+  private external fun generateMOTPBatchNative(
+    secrets: Array<String>,
+    pins: Array<String>,
+    timeSlot: Long,
+    periods: IntArray
+  ): Array<String>?
   private external fun generateSteamGuardNative(secret: String, timeSlot: Long): String
+  private external fun generateOTPBatchNative(
+    secrets: Array<String>,
+    types: Array<String>,
+    counters: LongArray,
+    digits: IntArray
+  ): Array<String>?
+  private external fun resyncHOTPNative(
+    secret: String,
+    counter: Long,
+    codes: Array<String>,
+    window: Int,
+    digits: Int,
+    algorithm: String
+  ): Long
   private external fun validateSecretNative(secret: String): Boolean
   private external fun base32DecodeNative(secret: String): ByteArray
   private external fun base32EncodeNative(data: ByteArray): String
+  private external fun parseOtpUrisNative(uris: Array<String>): Map<String, Any>?
+  private external fun importBackupNative(format: String, path: String, password: String): Map<String, Any>?
+  private external fun scanMailboxNative(path: String, maxResults: Int): Map<String, Any>?
+  private external fun configureServiceMatcherNative(
+    brands: Array<String>,
+    aliases: Array<String>,
+    aliasTargets: Array<String>,
+    categories: Array<String>,
+    categoryKeywords: Array<Array<String>>
+  ): Boolean
+  private external fun classifyServicesNative(names: Array<String>): Array<String?>?
+  private external fun searchIndexUpsertNative(
+    ids: Array<String>,
+    names: Array<String>,
+    issuers: Array<String>,
+    emails: Array<String>
+  ): Int
+  private external fun searchIndexRemoveNative(ids: Array<String>): Int
+  private external fun searchIndexClearNative()
+  private external fun searchIndexQueryNative(query: String, limit: Int): Array<String>?
+  private external fun scheduleCodesNative(
+    ids: Array<String>,
+    types: Array<String>,
+    secrets: Array<String>,
+    pins: Array<String>,
+    digits: IntArray,
+    algorithms: Array<String>,
+    periods: IntArray
+  ): Int
+  private external fun stopCodeSchedulerNative()
+
+  // Called from the native scheduler thread with every code that changed at one boundary
+  @Suppress("unused")
+  private fun onScheduledCodes(ids: Array<String>, codes: Array<String>, periods: IntArray, validUntil: LongArray) {
+    val groups = ids.indices.groupBy { periods[it] }.map { (period, indices) ->
+      mapOf(
+        "period" to period,
+        "validUntil" to validUntil[indices.first()].toDouble(),
+        "codes" to indices.associate { ids[it] to codes[it] }
+      )
+    }
+    sendEvent("onCodesChanged", mapOf("groups" to groups))
+  }
 
   companion object {
     init {
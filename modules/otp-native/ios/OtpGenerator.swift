@@ -1,214 +1,116 @@
 import Foundation
-import CommonCrypto
 
+/// Swift face of the shared C++ OTP core. Every call goes through the C ABI in
+/// OtpNativeC.h, the same engine the Android module reaches through JNI, so
+/// both platforms produce identical codes.
 public class OtpGenerator {
-    
-    // Base32 alphabet
-    private static let base32Alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567"
-    
-    // Steam Guard alphabet
-    private static let steamAlphabet = "23456789BCDFGHJKMNPQRTVWXY"
-    
+
     // MARK: - OTP Generation Functions
-    
+
     public static func generateTOTP(secret: String, timeSlot: UInt64, digits: Int, algorithm: String) -> String {
-        return generateHOTP(secret: secret, counter: timeSlot, digits: digits, algorithm: algorithm)
+        return code { otp_generate_totp(secret, timeSlot, Int32(digits), algorithm, $0, $1) }
     }
-    
+
     public static func generateHOTP(secret: String, counter: UInt64, digits: Int, algorithm: String) -> String {
-        guard let key = base32DecodeToData(input: secret) else {
-            return ""
-        }
-        
-        // Convert counter to big-endian bytes
-        var counterBytes = Data(count: 8)
-        counterBytes.withUnsafeMutableBytes { bytes in
-            let buffer = bytes.bindMemory(to: UInt64.self)
-            buffer[0] = counter.bigEndian
-        }
-        
-        // Calculate HMAC
-        guard let hash = hmacSHA1(key: key, data: counterBytes) else {
-            return ""
-        }
-        
-        // Dynamic truncation
-        let offset = Int(hash[hash.count - 1] & 0x0F)
-        let code = (UInt32(hash[offset] & 0x7F) << 24) |
-                  (UInt32(hash[offset + 1]) << 16) |
-                  (UInt32(hash[offset + 2]) << 8) |
-                  UInt32(hash[offset + 3])
-        
-        // Generate the final code
-        let modulus = UInt32(pow(10.0, Double(digits)))
-        let finalCode = code % modulus
-        
-        // Format with leading zeros
-        return String(format: "%0\(digits)d", finalCode)
+        return code { otp_generate_hotp(secret, counter, Int32(digits), algorithm, $0, $1) }
     }
-    
+
     public static func generateMOTP(secret: String, pin: String, timeSlot: UInt64) -> String {
         return generateMOTPWithPeriod(secret: secret, pin: pin, timeSlot: timeSlot, period: 10)
     }
-    
+
     public static func generateMOTPWithPeriod(secret: String, pin: String, timeSlot: UInt64, period: Int) -> String {
-        // Calculate time period
-        let timePeriod = timeSlot / UInt64(period)
-        
-        // Create input string: secret + pin + time_period
-        let input = secret + pin + String(timePeriod)
-        
-        // Calculate MD5 hash
-        guard let hash = md5Hash(input: input) else {
-            return ""
-        }
-        
-        // Take first 6 characters as hex
-        let hexString = hash.prefix(3).map { String(format: "%02x", $0) }.joined()
-        return String(hexString.prefix(6))
+        return code { otp_generate_motp(secret, pin, timeSlot, Int32(period), $0, $1) }
     }
-    
+
     public static func generateSteamGuard(secret: String, timeSlot: UInt64) -> String {
-        guard let key = base32DecodeToData(input: secret) else {
-            return ""
+        return code { otp_generate_steam(secret, timeSlot, $0, $1) }
+    }
+
+    /// Many HMAC-SHA1 codes in one call; "Steam" entries use the Steam Guard encoding
+    public static func generateOTPBatch(secrets: [String], types: [String], counters: [UInt64], digits: [Int]) -> [String] {
+        let count = secrets.count
+        guard types.count == count, counters.count == count, digits.count == count, count > 0 else {
+            return []
         }
-        
-        // Convert time slot to big-endian bytes
-        var timeBytes = Data(count: 8)
-        timeBytes.withUnsafeMutableBytes { bytes in
-            let buffer = bytes.bindMemory(to: UInt64.self)
-            buffer[0] = timeSlot.bigEndian
+
+        // The C strings must outlive the call; they are wiped before release
+        let cSecrets = secrets.map { strdup($0) }
+        defer {
+            for secret in cSecrets {
+                if let secret = secret {
+                    memset(secret, 0, strlen(secret))
+                    free(secret)
+                }
+            }
         }
-        
-        // Calculate HMAC
-        guard let hash = hmacSHA1(key: key, data: timeBytes) else {
-            return ""
+        let pointers = cSecrets.map { UnsafePointer($0) }
+        let encodings = types.map { UInt8($0 == "Steam" ? OTP_ENCODING_STEAM : OTP_ENCODING_DECIMAL) }
+        let digitValues = digits.map { Int32($0) }
+        let capacity = Int(OTP_CODE_CAPACITY)
+        var buffer = [CChar](repeating: 0, count: count * capacity)
+        defer { wipe(&buffer) }
+
+        let written = otp_generate_batch(pointers, encodings, counters, digitValues, count, &buffer)
+        guard written == count else {
+            return []
         }
-        
-        // Steam Guard uses a different alphabet and 5 characters
-        var code = ""
-        for i in 0..<5 {
-            let index = Int(hash[i]) % steamAlphabet.count
-            let char = steamAlphabet[steamAlphabet.index(steamAlphabet.startIndex, offsetBy: index)]
-            code.append(char)
+        return buffer.withUnsafeBufferPointer { codes in
+            (0..<count).map { String(cString: codes.baseAddress! + $0 * capacity) }
         }
-        
-        return code
     }
-    
+
+    /// RFC 4226 resynchronization; returns the counter after the matched code, or -1
+    public static func resyncHOTP(secret: String, counter: UInt64, codes: [String], window: Int, digits: Int, algorithm: String) -> Int64 {
+        guard codes.count == 1 || codes.count == 2 else {
+            return -1
+        }
+        let cCodes = codes.map { strdup($0) }
+        defer { cCodes.forEach { free($0) } }
+        return otp_resync_hotp(secret, counter, cCodes.map { UnsafePointer($0) }, cCodes.count,
+                               Int32(window), Int32(digits), algorithm)
+    }
+
     // MARK: - Utility Functions
-    
+
     public static func validateSecret(secret: String) -> Bool {
-        if secret.isEmpty {
-            return false
-        }
-        
-        // Check if all characters are valid Base32
-        let validChars = CharacterSet(charactersIn: "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567=")
-        return secret.uppercased().unicodeScalars.allSatisfy { validChars.contains($0) }
+        return otp_validate_secret(secret.uppercased()) == 1
     }
-    
+
     public static func base32Decode(input: String) -> Data {
-        return base32DecodeToData(input: input) ?? Data()
+        var buffer = [UInt8](repeating: 0, count: input.utf8.count * 5 / 8 + 1)
+        defer { wipe(&buffer) }
+        let written = otp_base32_decode(input, &buffer, buffer.count)
+        return written > 0 ? Data(buffer[0..<Int(written)]) : Data()
     }
-    
+
     public static func base32Encode(data: Data) -> String {
         if data.isEmpty {
             return ""
         }
-        
-        var result = ""
-        var buffer: UInt64 = 0
-        var bitsLeft = 0
-        
-        for byte in data {
-            buffer = (buffer << 8) | UInt64(byte)
-            bitsLeft += 8
-            
-            while bitsLeft >= 5 {
-                let index = Int((buffer >> (bitsLeft - 5)) & 0x1F)
-                result.append(base32Alphabet[base32Alphabet.index(base32Alphabet.startIndex, offsetBy: index)])
-                bitsLeft -= 5
-            }
-        }
-        
-        if bitsLeft > 0 {
-            let index = Int((buffer << (5 - bitsLeft)) & 0x1F)
-            result.append(base32Alphabet[base32Alphabet.index(base32Alphabet.startIndex, offsetBy: index)])
-        }
-        
-        // Add padding
-        while result.count % 8 != 0 {
-            result.append("=")
+
+        var buffer = [CChar](repeating: 0, count: (data.count + 4) / 5 * 8 + 1)
+        let written = data.withUnsafeBytes { bytes in
+            otp_base32_encode(bytes.bindMemory(to: UInt8.self).baseAddress, data.count, &buffer, buffer.count)
         }
-        
-        return result
+        return written > 0 ? String(cString: buffer) : ""
     }
-    
+
     // MARK: - Private Helper Functions
-    
-    private static func base32DecodeToData(input: String) -> Data? {
-        if input.isEmpty {
-            return nil
-        }
-        
-        let cleanInput = input.uppercased().replacingOccurrences(of: "=", with: "")
-        if cleanInput.isEmpty {
-            return nil
-        }
-        
-        var result = Data()
-        var buffer: UInt64 = 0
-        var bitsLeft = 0
-        
-        for char in cleanInput {
-            guard let index = base32Alphabet.firstIndex(of: char) else {
-                return nil
-            }
-            
-            let value = base32Alphabet.distance(from: base32Alphabet.startIndex, to: index)
-            buffer = (buffer << 5) | UInt64(value)
-            bitsLeft += 5
-            
-            if bitsLeft >= 8 {
-                result.append(UInt8((buffer >> (bitsLeft - 8)) & 0xFF))
-                bitsLeft -= 8
-            }
-        }
-        
-        return result
-    }
-    
-    private static func hmacSHA1(key: Data, data: Data) -> Data? {
-        var result = Data(count: Int(CC_SHA1_DIGEST_LENGTH))
-        
-        result.withUnsafeMutableBytes { resultBytes in
-            key.withUnsafeBytes { keyBytes in
-                data.withUnsafeBytes { dataBytes in
-                    CCHmac(CCHmacAlgorithm(kCCHmacAlgSHA1),
-                          keyBytes.baseAddress, key.count,
-                          dataBytes.baseAddress, data.count,
-                          resultBytes.baseAddress)
-                }
-            }
-        }
-        
-        return result
+
+    /// Run a generator against a stack-sized code buffer and copy the result out
+    private static func code(_ generate: (UnsafeMutablePointer<CChar>, Int) -> Int32) -> String {
+        var buffer = [CChar](repeating: 0, count: Int(OTP_CODE_CAPACITY))
+        defer { wipe(&buffer) }
+        let written = buffer.withUnsafeMutableBufferPointer { generate($0.baseAddress!, $0.count) }
+        return written > 0 ? String(cString: buffer) : ""
     }
-    
-    private static func md5Hash(input: String) -> Data? {
-        guard let data = input.data(using: .utf8) else {
-            return nil
-        }
-        
-        var result = Data(count: Int(CC_MD5_DIGEST_LENGTH))
-        
-        result.withUnsafeMutableBytes { resultBytes in
-            data.withUnsafeBytes { dataBytes in
-                CC_MD5(dataBytes.baseAddress, CC_LONG(data.count), resultBytes.bindMemory(to: UInt8.self).baseAddress)
+
+    private static func wipe<T: FixedWidthInteger>(_ buffer: inout [T]) {
+        buffer.withUnsafeMutableBytes { bytes in
+            if let base = bytes.baseAddress {
+                memset(base, 0, bytes.count)
             }
         }
-        
-        return result
     }
-} 
\ No newline at end of file
+}
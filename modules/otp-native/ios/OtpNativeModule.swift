@@ -31,6 +31,14 @@ public class OtpNativeModule: Module {
       return OtpGenerator.generateSteamGuard(secret: secret, timeSlot: UInt64(timeSlot))
     }
 
+    Function("generateOTPBatch") { (secrets: [String], types: [String], counters: [Double], digits: [Int]) -> [String] in
+      return OtpGenerator.generateOTPBatch(secrets: secrets, types: types, counters: counters.map { UInt64($0) }, digits: digits)
+    }
+
+    Function("resyncHOTP") { (secret: String, counter: Double, codes: [String], window: Int, digits: Int, algorithm: String) -> Double in
+      return Double(OtpGenerator.resyncHOTP(secret: secret, counter: UInt64(counter), codes: codes, window: window, digits: digits, algorithm: algorithm))
+    }
+
     // Utility functions
     Function("validateSecret") { (secret: String) -> Bool in
       return OtpGenerator.validateSecret(secret: secret)
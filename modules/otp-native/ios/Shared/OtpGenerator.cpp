@@ -0,0 +1 @@
+../../android/src/main/cpp/OtpGenerator.cpp
\ No newline at end of file
@@ -0,0 +1 @@
+../../android/src/main/cpp/OtpGenerator.h
\ No newline at end of file
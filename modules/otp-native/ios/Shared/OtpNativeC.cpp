@@ -0,0 +1 @@
+../../android/src/main/cpp/OtpNativeC.cpp
\ No newline at end of file
@@ -0,0 +1 @@
+../../android/src/main/cpp/OtpNativeC.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../crypto-native/android/src/main/cpp/SecureArena.cpp
\ No newline at end of file
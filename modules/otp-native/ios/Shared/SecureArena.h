@@ -0,0 +1 @@
+../../../crypto-native/android/src/main/cpp/SecureArena.h
\ No newline at end of file
@@ -34,5 +34,57 @@ export type SteamGuardOptions = {
   timeSlot: number;
 };
 
-// Empty events interface since this module doesn't emit events
-export type OtpNativeModuleEvents = {}; 
\ No newline at end of file
+export type ImportedOtpAccount = {
+  issuer: string;
+  name: string;
+  secret: string; // Validated, normalized Base32
+  type: 'TOTP' | 'HOTP' | 'Steam';
+  algorithm: OtpAlgorithm;
+  digits: number;
+  period: number;
+  counter: number;
+};
+
+export type OtpImportResult = {
+  accounts: ImportedOtpAccount[];
+  rejected: number; // URIs, migration or backup entries that could not be parsed
+};
+
+export type BackupFormat = 'AEGIS' | 'ANDOTP' | 'TWOFAS';
+
+export type MailboxMessage = {
+  messageId: string;
+  from: string; // Decoded From header
+  subject: string; // Decoded Subject header
+  date: string; // Raw Date header
+  codes: string[]; // One-time codes found next to a code keyword
+  setupUris: string[]; // Valid otpauth:// and otpauth-migration:// links
+  secrets: string[]; // Base32 setup keys offered for manual entry
+  activationUrls: string[]; // Verify/confirm/activate links
+};
+
+export type MailboxScanResult = {
+  messages: MailboxMessage[]; // Only messages with findings, in mailbox order
+  scanned: number; // Messages read
+  bytes: number; // Bytes read
+  truncated: number; // Messages cut at the 4 MiB per-message cap
+};
+
+export type ServiceClassification = {
+  brand: string | null;
+  category: string | null;
+};
+
+export type ScheduledCodeGroup = {
+  period: number; // Seconds
+  validUntil: number; // Next boundary, milliseconds since epoch
+  codes: Record<string, string>; // Account id -> unformatted code
+};
+
+export type CodesChangedEvent = {
+  groups: ScheduledCodeGroup[]; // Every period group that rolled over at this boundary
+};
+
+export type OtpNativeModuleEvents = {
+  onCodesChanged: (event: CodesChangedEvent) => void;
+}; 
\ No newline at end of file
@@ -1,6 +1,12 @@
 import { NativeModule, requireNativeModule } from 'expo';
 
-import { OtpNativeModuleEvents } from './OtpNative.types';
+import {
+  BackupFormat,
+  MailboxScanResult,
+  OtpImportResult,
+  OtpNativeModuleEvents,
+  ServiceClassification,
+} from './OtpNative.types';
 
 declare class OtpNativeModule extends NativeModule<OtpNativeModuleEvents> {
   /**
@@ -42,6 +48,17 @@ declare class OtpNativeModule extends NativeModule<OtpNativeModuleEvents> {
    */
   generateMOTPWithPeriod(secret: string, pin: string, timeSlot: number, period: number): string;
 
+  /**
+   * Generate mOTP codes for many accounts at once. Typical inputs are
+   * hashed four per pass with a multi-buffer MD5.
+   * @param secrets Secret keys
+   * @param pins PIN codes
+   * @param timeSlot Current time in seconds since epoch
+   * @param periods Time periods in seconds
+   * @returns Codes in input order, empty for invalid entries
+   */
+  generateMOTPBatch(secrets: string[], pins: string[], timeSlot: number, periods: number[]): string[];
+
   /**
    * Generate Steam Guard code
    * @param secret Base32 encoded secret
@@ -50,6 +67,30 @@ declare class OtpNativeModule extends NativeModule<OtpNativeModuleEvents> {
    */
   generateSteamGuard(secret: string, timeSlot: number): string;
 
+  /**
+   * Generate many HMAC-SHA1 codes at once (TOTP, HOTP and Steam Guard).
+   * Consecutive entries with the same secret reuse one keyed HMAC state.
+   * @param secrets Base32 encoded secrets
+   * @param types Account types; "Steam" selects the Steam Guard encoding
+   * @param counters Time slots (TOTP/Steam) or counters (HOTP)
+   * @param digits Code lengths, ignored for Steam
+   * @returns Codes in input order, empty for invalid entries
+   */
+  generateOTPBatch(secrets: string[], types: string[], counters: number[], digits: number[]): string[];
+
+  /**
+   * RFC 4226 HOTP resynchronization. Searches counters from `counter` to
+   * `counter + window - 1` for the code(s) shown by the token.
+   * @param secret Base32 encoded secret
+   * @param counter Last counter known to be in sync
+   * @param codes One code, or two consecutive codes
+   * @param window Number of counters to search
+   * @param digits Code length
+   * @param algorithm Hash algorithm (SHA1 only)
+   * @returns Counter following the (last) matched code, or -1 if none matched
+   */
+  resyncHOTP(secret: string, counter: number, codes: string[], window: number, digits: number, algorithm: string): number;
+
   /**
    * Validate if a secret is properly formatted Base32
    * @param secret Secret to validate
@@ -70,6 +111,120 @@ declare class OtpNativeModule extends NativeModule<OtpNativeModuleEvents> {
    * @returns Base32 encoded string
    */
   base32Encode(data: Uint8Array): string;
+
+  /**
+   * Parse otpauth:// and otpauth-migration:// URIs in a single call
+   * @param uris URIs to parse; a migration URI may expand to many accounts
+   * @returns Parsed accounts in input order and the number of rejected entries
+   */
+  parseOtpUris(uris: string[]): OtpImportResult;
+
+  /**
+   * Import an Aegis, andOTP or 2FAS backup, encrypted or plain. Encrypted
+   * backups are decrypted natively; the password is ignored for plain ones.
+   * @param format App that wrote the backup
+   * @param path Backup file on local storage
+   * @param password Backup password
+   * @returns Parsed accounts in backup order and the number of unsupported entries;
+   *   rejects on a wrong password or unreadable file
+   */
+  importBackup(format: BackupFormat, path: string, password: string): Promise<OtpImportResult>;
+
+  /**
+   * Scan a local mailbox for one-time codes, setup secrets and activation links.
+   * MIME parts are decoded (base64, quoted-printable, charsets) and HTML is
+   * reduced to text before matching; memory use is bounded per message.
+   * @param path Maildir directory or mbox file
+   * @param maxResults Stop after this many matching messages, 0 for no limit
+   * @returns Matching messages and scan statistics; rejects if the path cannot be opened
+   */
+  scanMailbox(path: string, maxResults: number): Promise<MailboxScanResult>;
+
+  /**
+   * Build the service classifier from brand, alias and category keyword tables.
+   * Tables are matched case-insensitively; earlier entries win ties.
+   * @param brands Brand keys, matched as substrings in either direction
+   * @param aliases Alias keywords, matched as substrings of the service name
+   * @param aliasTargets Brand key for each alias
+   * @param categories Category names in priority order
+   * @param categoryKeywords Keywords for each category
+   * @returns True if the classifier was built
+   */
+  configureServiceMatcher(
+    brands: string[],
+    aliases: string[],
+    aliasTargets: string[],
+    categories: string[],
+    categoryKeywords: string[][]
+  ): boolean;
+
+  /**
+   * Classify service names against the configured tables in one pass per name
+   * @param names Service names to classify
+   * @returns Brand and category for each name, or null if not configured
+   */
+  classifyServices(names: string[]): ServiceClassification[] | null;
+
+  /**
+   * Add accounts to the search index, replacing any already indexed under the same id
+   * @param ids Account ids
+   * @param names Account names
+   * @param issuers Issuers (empty string if none)
+   * @param emails Account emails
+   * @returns Number of indexed accounts, or -1 on invalid input
+   */
+  searchIndexUpsert(ids: string[], names: string[], issuers: string[], emails: string[]): number;
+
+  /**
+   * Remove accounts from the search index
+   * @param ids Account ids
+   * @returns Number of indexed accounts, or -1 on invalid input
+   */
+  searchIndexRemove(ids: string[]): number;
+
+  /**
+   * Remove all accounts from the search index
+   */
+  searchIndexClear(): void;
+
+  /**
+   * Search indexed accounts by name, issuer and email. Falls back to
+   * typo-tolerant matching when nothing matches literally.
+   * @param query Search text
+   * @param limit Maximum number of results, 0 for all
+   * @returns Account ids, best match first
+   */
+  searchIndexQuery(query: string, limit: number): string[];
+
+  /**
+   * Replace the accounts whose codes are regenerated at period boundaries.
+   * Accounts are grouped by period; at each boundary the groups that rolled
+   * over are generated in one batch and delivered as a single
+   * `onCodesChanged` event. Every group is reported once right after
+   * registration. HOTP accounts are ignored.
+   * @param ids Account ids
+   * @param types Account types (TOTP, Steam, mOTP)
+   * @param secrets Base32 secrets (raw secret for mOTP)
+   * @param pins mOTP PINs, empty for other types
+   * @param digits Code lengths
+   * @param algorithms Hash algorithms
+   * @param periods Periods in seconds
+   * @returns Number of accounts scheduled, or -1 on invalid input
+   */
+  scheduleCodes(
+    ids: string[],
+    types: string[],
+    secrets: string[],
+    pins: string[],
+    digits: number[],
+    algorithms: string[],
+    periods: number[]
+  ): number;
+
+  /**
+   * Stop the code scheduler and wipe the registered secrets
+   */
+  stopCodeScheduler(): void;
 }
 
 // This call loads the native module object from the JSI.
@@ -119,8 +119,21 @@ export default {
   validateSecret: OtpNativeModule.validateSecret,
   base32Decode: OtpNativeModule.base32Decode,
   base32Encode: OtpNativeModule.base32Encode,
+  parseOtpUris: OtpNativeModule.parseOtpUris,
+  importBackup: OtpNativeModule.importBackup,
+  scanMailbox: OtpNativeModule.scanMailbox,
+  configureServiceMatcher: OtpNativeModule.configureServiceMatcher,
+  classifyServices: OtpNativeModule.classifyServices,
+  searchIndexUpsert: OtpNativeModule.searchIndexUpsert,
+  searchIndexRemove: OtpNativeModule.searchIndexRemove,
+  searchIndexClear: OtpNativeModule.searchIndexClear,
+  searchIndexQuery: OtpNativeModule.searchIndexQuery,
+  scheduleCodes: OtpNativeModule.scheduleCodes,
+  stopCodeScheduler: OtpNativeModule.stopCodeScheduler,
   // Direct access to native module methods for advanced usage
   generateMOTPWithPeriod: OtpNativeModule.generateMOTPWithPeriod,
+  generateMOTPBatch: OtpNativeModule.generateMOTPBatch,
+  generateOTPBatch: OtpNativeModule.generateOTPBatch,
   OTP_ALGORITHMS,
   OTP_DEFAULTS,
 }; 
\ No newline at end of file
@@ -1,15 +1,26 @@
 import { mockAccounts } from '@/constants/mockData';
+import CryptoNative, { type JournalRecord } from '@/modules/crypto-native';
+import { OtpNativeModule } from '@/modules/otp-native';
 import type { Account, AccountCategory } from '@/types/auth';
 import AsyncStorage from '@react-native-async-storage/async-storage';
+import * as SecureStore from 'expo-secure-store';
 import { InteractionManager } from 'react-native';
 
 const STORAGE_KEY = 'secauth_accounts';
+const JOURNAL_READY_KEY = 'secauth_accounts_journal'; // Set once accounts live in the journal
+const JOURNAL_KEY = 'secauth_accounts_key';
+const JOURNAL_DIRECTORY = 'accounts'; // Relative to the app's files directory
+const NO_CUSTOM_ORDER = -1;
 const BATCH_SIZE = 10; // Process accounts in batches to avoid blocking
 
+type OrderedAccount = Account & { customOrder?: number };
+
 export class AccountService {
   private static cache: Account[] | null = null;
   private static isLoading = false;
   private static loadPromise: Promise<Account[]> | null = null;
+  private static searchIndexReady = false;
+  private static journalHandle: Promise<number | null> | null = null;
 
   /**
    * Get all accounts with performance optimization and proper sorting
@@ -32,6 +43,7 @@ export class AccountService {
     try {
       const accounts = await this.loadPromise;
       this.cache = accounts;
+      this.indexAccounts(accounts, true);
       return this.sortAccounts(accounts);
     } finally {
       this.isLoading = false;
@@ -88,13 +100,22 @@ export class AccountService {
       // Add small delay to ensure UI is ready
       await new Promise(resolve => setTimeout(resolve, 100));
 
+      const journal = await this.openJournal();
+      if (journal !== null && await AsyncStorage.getItem(JOURNAL_READY_KEY)) {
+        return await this.processBatches(await this.readJournal(journal));
+      }
+
       // Try to load from storage first
       const storedData = await AsyncStorage.getItem(STORAGE_KEY);
       
       if (storedData) {
         const accounts = JSON.parse(storedData) as Account[];
         // Validate and process in batches
-        return await this.processBatches(accounts);
+        const processedAccounts = await this.processBatches(accounts);
+        if (journal !== null) {
+          await this.migrateToJournal(journal, processedAccounts);
+        }
+        return processedAccounts;
       }
 
       // If no stored data, use mock data and save it
@@ -150,12 +171,171 @@ export class AccountService {
    */
   private static async saveAccountsAsync(accounts: Account[]): Promise<void> {
     try {
+      const journal = await this.openJournal();
+      if (journal !== null) {
+        await this.writeJournal(journal, accounts);
+        await AsyncStorage.setItem(JOURNAL_READY_KEY, '1');
+        return;
+      }
+      await AsyncStorage.setItem(STORAGE_KEY, JSON.stringify(accounts));
+    } catch (error) {
+      console.error('Error saving accounts:', error);
+    }
+  }
+
+  /**
+   * Persist a change to some accounts: as journal entries for just those
+   * accounts where the journal is available, otherwise by rewriting the
+   * whole AsyncStorage copy
+   */
+  private static async saveChangeAsync(
+    accounts: Account[],
+    writeEntries: (journal: number) => Promise<unknown>
+  ): Promise<void> {
+    try {
+      const journal = await this.openJournal();
+      if (journal !== null) {
+        await writeEntries(journal);
+        return;
+      }
       await AsyncStorage.setItem(STORAGE_KEY, JSON.stringify(accounts));
     } catch (error) {
       console.error('Error saving accounts:', error);
     }
   }
 
+  /**
+   * Open the native account journal once; null where the native module does
+   * not provide it (iOS, web), in which case accounts stay in AsyncStorage
+   */
+  private static openJournal(): Promise<number | null> {
+    if (!this.journalHandle) {
+      this.journalHandle = (async () => {
+        try {
+          let key = await SecureStore.getItemAsync(JOURNAL_KEY);
+          if (!key) {
+            key = await CryptoNative.generateKey(32);
+            await SecureStore.setItemAsync(JOURNAL_KEY, key);
+          }
+          const stats = await CryptoNative.journalOpen(JOURNAL_DIRECTORY, key, {});
+          return stats.handle;
+        } catch (error) {
+          console.warn('Account journal unavailable, using AsyncStorage:', error);
+          return null;
+        }
+      })();
+    }
+    return this.journalHandle;
+  }
+
+  /**
+   * Name and order travel outside the payload so that renames and reorders
+   * append small journal entries instead of rewriting the account
+   */
+  private static async toJournalRecord(account: Account): Promise<JournalRecord> {
+    const { name, customOrder, ...payload } = account as OrderedAccount;
+    return {
+      name,
+      order: typeof customOrder === 'number' ? customOrder : NO_CUSTOM_ORDER,
+      data: await CryptoNative.encodeBase64(JSON.stringify(payload)),
+    };
+  }
+
+  private static async fromJournalRecord(record: JournalRecord): Promise<Account> {
+    const account = JSON.parse(await CryptoNative.decodeBase64(record.data)) as OrderedAccount;
+    account.name = record.name;
+    if (record.order !== NO_CUSTOM_ORDER) {
+      account.customOrder = record.order;
+    }
+    return account;
+  }
+
+  private static async readJournal(journal: number): Promise<Account[]> {
+    const ids = await CryptoNative.journalIds(journal);
+    const records = await Promise.all(ids.map(id => CryptoNative.journalGet(journal, id)));
+    return await Promise.all(
+      records
+        .filter((record): record is JournalRecord => record !== null)
+        .map(record => this.fromJournalRecord(record))
+    );
+  }
+
+  /**
+   * Put whole accounts; concurrent puts share one sync in the journal
+   */
+  private static async writeJournal(journal: number, accounts: Account[]): Promise<void> {
+    await Promise.all(
+      accounts.map(async account =>
+        CryptoNative.journalPut(journal, account.id, await this.toJournalRecord(account))
+      )
+    );
+  }
+
+  /**
+   * Move the AsyncStorage copy into the journal on first start with it. The
+   * old copy is only dropped once every account has been written.
+   */
+  private static async migrateToJournal(journal: number, accounts: Account[]): Promise<void> {
+    try {
+      await this.writeJournal(journal, accounts);
+      await AsyncStorage.setItem(JOURNAL_READY_KEY, '1');
+      await AsyncStorage.removeItem(STORAGE_KEY);
+    } catch (error) {
+      console.warn('Failed to move accounts into the journal:', error);
+    }
+  }
+
+  /**
+   * Mirror accounts into the native search index
+   */
+  private static indexAccounts(accounts: Account[], reset = false): void {
+    try {
+      if (reset) {
+        OtpNativeModule.searchIndexClear();
+      }
+      const indexed = OtpNativeModule.searchIndexUpsert(
+        accounts.map(account => account.id),
+        accounts.map(account => account.name.toLowerCase()),
+        accounts.map(account => (account.issuer || '').toLowerCase()),
+        accounts.map(account => account.email.toLowerCase())
+      );
+      this.searchIndexReady = indexed >= 0 && (reset || this.searchIndexReady);
+    } catch {
+      // Native index not available on this platform
+      this.searchIndexReady = false;
+    }
+  }
+
+  /**
+   * Remove accounts from the native search index
+   */
+  private static unindexAccounts(accountIds: string[]): void {
+    if (!this.searchIndexReady) {
+      return;
+    }
+    try {
+      OtpNativeModule.searchIndexRemove(accountIds);
+    } catch {
+      this.searchIndexReady = false;
+    }
+  }
+
+  /**
+   * Rank cached accounts against a query using the native search index
+   * @returns Account ids, best match first, or null if the index is unavailable
+   */
+  static rankAccountIds(query: string): string[] | null {
+    if (!this.searchIndexReady) {
+      return null;
+    }
+    try {
+      return OtpNativeModule.searchIndexQuery(query.toLowerCase(), 0);
+    } catch (error) {
+      console.warn('Native account search failed:', error);
+      return null;
+    }
+  }
+
   /**
    * Add a new account with optimization
    */
@@ -174,9 +354,10 @@ export class AccountService {
       
       // Update cache immediately
       this.cache = updatedAccounts;
+      this.indexAccounts([newAccount]);
       
       // Save to storage and wait for completion to ensure persistence
-      await this.saveAccountsAsync(updatedAccounts);
+      await this.saveChangeAsync(updatedAccounts, journal => this.writeJournal(journal, [newAccount]));
 
       return newAccount;
     } catch (error) {
@@ -204,9 +385,10 @@ export class AccountService {
       
       // Update cache immediately
       this.cache = updatedAccounts;
+      this.indexAccounts(newAccounts);
       
       // Save to storage and wait for completion to ensure persistence
-      await this.saveAccountsAsync(updatedAccounts);
+      await this.saveChangeAsync(updatedAccounts, journal => this.writeJournal(journal, newAccounts));
 
       return newAccounts;
     } catch (error) {
@@ -238,9 +420,12 @@ export class AccountService {
       
       // Update cache immediately
       this.cache = updatedAccounts;
+      this.indexAccounts([updatedAccount]);
       
       // Save to storage and wait for completion
-      await this.saveAccountsAsync(updatedAccounts);
+      await this.saveChangeAsync(updatedAccounts, journal =>
+        CryptoNative.journalRename(journal, accountId, newName)
+      );
 
       return updatedAccount;
     } catch (error) {
@@ -259,9 +444,10 @@ export class AccountService {
       
       // Update cache immediately
       this.cache = updatedAccounts;
+      this.unindexAccounts([accountId]);
       
       // Save to storage and wait for completion
-      await this.saveAccountsAsync(updatedAccounts);
+      await this.saveChangeAsync(updatedAccounts, journal => CryptoNative.journalRemove(journal, accountId));
     } catch (error) {
       console.error('Error deleting account:', error);
       throw error;
@@ -281,6 +467,18 @@ export class AccountService {
    */
   static async searchAccounts(query: string): Promise<Account[]> {
     const accounts = await this.getAccounts();
+    if (!query.trim()) {
+      return accounts;
+    }
+
+    const rankedIds = this.rankAccountIds(query);
+    if (rankedIds) {
+      const accountsById = new Map(accounts.map(account => [account.id, account]));
+      return rankedIds
+        .map(id => accountsById.get(id))
+        .filter((account): account is Account => account !== undefined);
+    }
+
     const lowercaseQuery = query.toLowerCase();
     
     return accounts.filter(account =>
@@ -295,6 +493,7 @@ export class AccountService {
    */
   static clearCache(): void {
     this.cache = null;
+    this.searchIndexReady = false;
   }
 
   /**
@@ -350,8 +549,15 @@ export class AccountService {
       this.cache = updatedAccounts;
       console.log('updateAccountOrder: Updated cache');
       
-      // Save to storage
-      await this.saveAccountsAsync(updatedAccounts);
+      // Save to storage: one journal entry carries every new order
+      const orders: Record<string, number> = {};
+      updatedAccounts.forEach(account => {
+        const ordered = account as OrderedAccount;
+        if (orderMap.has(account.id) && typeof ordered.customOrder === 'number') {
+          orders[account.id] = ordered.customOrder;
+        }
+      });
+      await this.saveChangeAsync(updatedAccounts, journal => CryptoNative.journalReorder(journal, orders));
       console.log('updateAccountOrder: Saved to storage');
     } catch (error) {
       console.error('Error updating account order:', error);
@@ -1,5 +1,6 @@
 import AsyncStorage from '@react-native-async-storage/async-storage';
 import { AppState, AppStateStatus } from 'react-native';
+import { CodeScheduler } from '@/services/codeScheduler';
 
 export type AutoLockTimeout = 'immediate' | '1min' | '5min' | '15min' | '30min' | 'never';
 
@@ -201,6 +202,7 @@ export class AutoLockService {
   private static lockApp(): void {
     if (!this.isLocked && this.onLockRequired) {
       this.isLocked = true;
+      CodeScheduler.lock();
       this.onLockRequired();
     }
   }
@@ -210,6 +212,7 @@ export class AutoLockService {
    */
   static unlockApp(): void {
     this.isLocked = false;
+    CodeScheduler.unlock();
     this.resetLockTimer();
   }
 
@@ -1,5 +1,6 @@
 import React from 'react';
 import Svg, { Circle, Path } from 'react-native-svg';
+import { classifyService, classifyServices, registerBrands } from '@/utils/serviceClassifier';
 
 interface BrandIcon {
   component: (props: { size: number }) => React.ReactElement;
@@ -132,6 +133,8 @@ const BRAND_ICONS: Record<string, BrandIcon> = {
   // 其他品牌可以继续添加...
 };
 
+registerBrands(Object.keys(BRAND_ICONS));
+
 export class BrandIconService {
   /**
    * 获取品牌图标
@@ -190,52 +193,14 @@ export class BrandIconService {
    * 支持模糊匹配，如 "Google Mail" 会匹配到 "google"
    */
   static matchServiceName(serviceName: string): string | null {
-    const normalizedInput = serviceName.toLowerCase().trim();
-    
-    // 精确匹配
-    if (BRAND_ICONS[normalizedInput]) {
-      return normalizedInput;
-    }
-
-    // 模糊匹配
-    const brands = Object.keys(BRAND_ICONS);
-    
-    // 检查是否包含品牌名称
-    for (const brand of brands) {
-      if (normalizedInput.includes(brand) || brand.includes(normalizedInput)) {
-        return brand;
-      }
-    }
-
-    // 特殊匹配规则
-    const specialMatches: Record<string, string> = {
-      'gmail': 'google',
-      'google mail': 'google',
-      'outlook': 'microsoft',
-      'hotmail': 'microsoft',
-      'live': 'microsoft',
-      'xbox': 'microsoft',
-      'skype': 'microsoft',
-      'onedrive': 'microsoft',
-      'office': 'microsoft',
-      'teams': 'microsoft',
-      'icloud': 'apple',
-      'app store': 'apple',
-      'itunes': 'apple',
-      'twitch': 'amazon',
-      'aws': 'amazon',
-      'whatsapp': 'facebook',
-      'instagram': 'facebook',
-      'meta': 'facebook',
-      'valve': 'steam',
-    };
-
-    for (const [key, value] of Object.entries(specialMatches)) {
-      if (normalizedInput.includes(key)) {
-        return value;
-      }
-    }
+    // 精确匹配、品牌名包含匹配、别名匹配（原生 Aho-Corasick 单次扫描）
+    return classifyService(serviceName).brand;
+  }
 
-    return null;
+  /**
+   * 批量匹配服务名称
+   */
+  static matchServiceNames(serviceNames: string[]): (string | null)[] {
+    return classifyServices(serviceNames).map(match => match.brand);
   }
 }
\ No newline at end of file
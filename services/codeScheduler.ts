@@ -0,0 +1,257 @@
+import { OtpNativeModule, type CodesChangedEvent } from '@/modules/otp-native';
+import { OTPService } from '@/services/otpService';
+import type { Account } from '@/types/auth';
+
+export interface ScheduledCode {
+  code: string; // Formatted for display
+  period: number; // Seconds
+  validUntil: number; // Next boundary, milliseconds since epoch
+}
+
+type CodeListener = (code: ScheduledCode) => void;
+
+/**
+ * Regenerates time-based codes at period boundaries only.
+ *
+ * Accounts are grouped by period; when a group rolls over its codes are
+ * generated in one batch and pushed to the subscribed cards. On Android the
+ * native scheduler does this on its own thread and emits one event per
+ * boundary; elsewhere a single JS timer does the same, so wakeups scale
+ * with the number of distinct periods rather than with accounts.
+ */
+export class CodeScheduler {
+  private static accounts = new Map<string, Account>();
+  private static groups = new Map<number, Account[]>();
+  private static codes = new Map<string, ScheduledCode>();
+  private static listeners = new Map<string, Set<CodeListener>>();
+  private static nativeSubscription: { remove(): void } | null = null;
+  private static timer: ReturnType<typeof setTimeout> | null = null;
+  private static generatedSlots = new Map<number, number>(); // Period -> slot (JS timer)
+  private static lockedAccounts: Account[] | null = null; // Held back while the app is locked
+
+  /**
+   * Whether the account's code is driven by the scheduler
+   */
+  static isScheduled(account: Account): boolean {
+    return !account.isTemporary && account.type !== 'HOTP' && account.type !== 'EMAIL_OTP' && !!account.secret;
+  }
+
+  /**
+   * Replace the scheduled accounts; unchanged lists are ignored
+   */
+  static setAccounts(accounts: Account[]): void {
+    if (this.lockedAccounts) {
+      this.lockedAccounts = accounts;
+      return;
+    }
+
+    const scheduled = accounts.filter(account => this.isScheduled(account));
+    if (scheduled.length === this.accounts.size && scheduled.every(account => this.isRegistered(account))) {
+      return;
+    }
+
+    this.accounts = new Map(scheduled.map(account => [account.id, account]));
+    this.groups = new Map();
+    for (const account of scheduled) {
+      const period = OTPService.getPeriod(account);
+      const group = this.groups.get(period);
+      if (group) {
+        group.push(account);
+      } else {
+        this.groups.set(period, [account]);
+      }
+    }
+    for (const id of this.codes.keys()) {
+      if (!this.accounts.has(id)) {
+        this.codes.delete(id);
+      }
+    }
+
+    if (!this.scheduleNative(scheduled)) {
+      this.generatedSlots.clear();
+      this.tick();
+    }
+  }
+
+  /**
+   * Stop scheduling and drop all codes
+   */
+  static stop(): void {
+    this.lockedAccounts = null;
+    this.accounts.clear();
+    this.groups.clear();
+    this.codes.clear();
+    this.generatedSlots.clear();
+    if (this.timer) {
+      clearTimeout(this.timer);
+      this.timer = null;
+    }
+    if (this.nativeSubscription) {
+      this.nativeSubscription.remove();
+      this.nativeSubscription = null;
+      try {
+        OtpNativeModule.stopCodeScheduler();
+      } catch {
+        // Not available on this platform
+      }
+    }
+  }
+
+  /**
+   * Stop generating while the app is locked. The native scheduler is torn
+   * down, which wipes its secrets and look-ahead rings.
+   */
+  static lock(): void {
+    if (this.lockedAccounts) {
+      return;
+    }
+    const accounts = [...this.accounts.values()];
+    this.stop();
+    this.lockedAccounts = accounts;
+  }
+
+  /**
+   * Resume with the accounts registered before or during the lock
+   */
+  static unlock(): void {
+    const accounts = this.lockedAccounts;
+    this.lockedAccounts = null;
+    if (accounts) {
+      this.setAccounts(accounts);
+    }
+  }
+
+  /**
+   * Current code of an account, or null before the first push or after it expired
+   */
+  static getCode(accountId: string): ScheduledCode | null {
+    const code = this.codes.get(accountId);
+    return code && code.validUntil > Date.now() ? code : null;
+  }
+
+  /**
+   * Receive the account's code whenever its period rolls over. The current
+   * code, if any, is delivered immediately.
+   * @returns Unsubscribe function
+   */
+  static subscribe(accountId: string, listener: CodeListener): () => void {
+    let listeners = this.listeners.get(accountId);
+    if (!listeners) {
+      listeners = new Set();
+      this.listeners.set(accountId, listeners);
+    }
+    listeners.add(listener);
+
+    const current = this.getCode(accountId);
+    if (current) {
+      listener(current);
+    }
+
+    return () => {
+      listeners.delete(listener);
+      if (listeners.size === 0 && this.listeners.get(accountId) === listeners) {
+        this.listeners.delete(accountId);
+      }
+    };
+  }
+
+  private static isRegistered(account: Account): boolean {
+    const registered = this.accounts.get(account.id);
+    return !!registered &&
+      registered.type === account.type &&
+      registered.secret === account.secret &&
+      registered.pin === account.pin &&
+      registered.digits === account.digits &&
+      registered.algorithm === account.algorithm &&
+      registered.period === account.period;
+  }
+
+  private static scheduleNative(accounts: Account[]): boolean {
+    try {
+      if (!this.nativeSubscription) {
+        this.nativeSubscription = OtpNativeModule.addListener('onCodesChanged', this.handleNativeChange);
+      }
+      const scheduled = OtpNativeModule.scheduleCodes(
+        accounts.map(account => account.id),
+        accounts.map(account => account.type),
+        accounts.map(account => account.type === 'mOTP' ? account.secret.trim() : OTPService.cleanBase32Secret(account.secret)),
+        accounts.map(account => account.type === 'mOTP' ? account.pin || '0000' : ''),
+        accounts.map(account => account.digits || 6),
+        accounts.map(account => account.algorithm || 'SHA1'),
+        accounts.map(account => OTPService.getPeriod(account))
+      );
+      if (scheduled >= 0) {
+        return true;
+      }
+    } catch {
+      // Not available on this platform
+    }
+
+    if (this.nativeSubscription) {
+      this.nativeSubscription.remove();
+      this.nativeSubscription = null;
+    }
+    return false;
+  }
+
+  private static handleNativeChange = (event: CodesChangedEvent): void => {
+    for (const group of event.groups) {
+      for (const [id, code] of Object.entries(group.codes)) {
+        const account = CodeScheduler.accounts.get(id);
+        if (!account) {
+          continue;
+        }
+        CodeScheduler.publish(id, {
+          // An empty native result means the secret was rejected; use the JS fallback
+          code: code ? OTPService.formatCode(code, account.type) : OTPService.generateCodeSync(account).code,
+          period: group.period,
+          validUntil: group.validUntil,
+        });
+      }
+    }
+  };
+
+  /**
+   * JS fallback: one timer for the earliest boundary across all groups
+   */
+  private static tick = (): void => {
+    if (CodeScheduler.timer) {
+      clearTimeout(CodeScheduler.timer);
+      CodeScheduler.timer = null;
+    }
+
+    const now = Date.now();
+    let nextBoundary = Infinity;
+    for (const [period, accounts] of CodeScheduler.groups) {
+      const periodMs = period * 1000;
+      const slot = Math.floor(now / periodMs);
+      const validUntil = (slot + 1) * periodMs;
+      nextBoundary = Math.min(nextBoundary, validUntil);
+
+      if (CodeScheduler.generatedSlots.get(period) === slot) {
+        continue;
+      }
+      CodeScheduler.generatedSlots.set(period, slot);
+      for (const account of accounts) {
+        CodeScheduler.publish(account.id, {
+          code: OTPService.generateCodeSync(account).code,
+          period,
+          validUntil,
+        });
+      }
+    }
+
+    if (nextBoundary !== Infinity) {
+      CodeScheduler.timer = setTimeout(CodeScheduler.tick, nextBoundary - now);
+    }
+  };
+
+  private static publish(accountId: string, code: ScheduledCode): void {
+    const previous = this.codes.get(accountId);
+    if (previous && previous.code === code.code && previous.validUntil === code.validUntil) {
+      return;
+    }
+    this.codes.set(accountId, code);
+    this.listeners.get(accountId)?.forEach(listener => listener(code));
+  }
+}
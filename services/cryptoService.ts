@@ -5,11 +5,13 @@ import type {
     EncryptionOptions,
     EncryptionResult,
     HmacOptions,
+    KdfCalibration,
     KeyDerivationOptions,
     RandomBytesOptions
 } from '@/modules/crypto-native/src/CryptoNative.types';
 import {
     CipherAlgorithm,
+    CompressionMode,
     HashAlgorithm,
     KeyDerivationFunction,
     PaddingMode,
@@ -20,7 +22,8 @@ export interface CryptoConfig {
   defaultPadding?: PaddingMode;
   defaultHashAlgorithm?: HashAlgorithm;
   defaultKeyLength?: number;
-  defaultIterations?: number;
+  defaultIterations?: number; // Minimum when calibrating, used as-is otherwise
+  kdfTargetMs?: number; // Calibrate KDF iterations to this derivation time; 0 disables
 }
 
 export interface SecureStorageOptions {
@@ -39,6 +42,15 @@ export interface SecureStorageResult {
   algorithm: CipherAlgorithm;
   kdf: KeyDerivationFunction;
   iterations: number;
+  kdfCalibrationVersion?: number; // Set when iterations came from device calibration
+}
+
+export interface SealedStreamResult {
+  sealed: string; // Base64 encoded sealed stream; cipher and compression are in its header
+  salt: string;
+  kdf: KeyDerivationFunction;
+  iterations: number;
+  kdfCalibrationVersion?: number;
 }
 
 export class CryptoService {
@@ -48,10 +60,14 @@ export class CryptoService {
     defaultHashAlgorithm: HashAlgorithm.SHA256,
     defaultKeyLength: 32, // 256 bits
     defaultIterations: 100000,
+    kdfTargetMs: 500,
   };
 
   private static config: Required<CryptoConfig> = { ...this.DEFAULT_CONFIG };
 
+  // Calibration results for this process, keyed by KDF, key length and target
+  private static calibrations = new Map<string, Promise<KdfCalibration | null>>();
+
   /**
    * Configure default crypto settings
    */
@@ -79,33 +95,50 @@ export class CryptoService {
     try {
       const algorithm = options?.algorithm || this.config.defaultAlgorithm;
       const kdf = options?.kdf || KeyDerivationFunction.PBKDF2;
-      const iterations = options?.iterations || this.config.defaultIterations;
+      const keyLength = this.getKeyLengthForAlgorithm(algorithm);
+      const calibration = options?.iterations ? null : await this.calibrate(kdf, keyLength);
+      const iterations = options?.iterations || this.calibratedIterations(calibration);
 
       // Encode data to Base64
       const encodedData = await CryptoNative.encodeBase64(data);
-
-      // Derive key from password
-      const derivedKey = await CryptoNative.deriveKey(password, {
-        kdf,
-        iterations,
-        keyLength: this.getKeyLengthForAlgorithm(algorithm),
-        saltLength: 16,
-      });
-
-      // Encrypt data
-      const encryptionResult = await CryptoNative.encrypt(encodedData, derivedKey.key, {
-        algorithm,
-        padding: this.config.defaultPadding,
-      });
+      const encryptionOptions = { algorithm, padding: this.config.defaultPadding };
+
+      // Derive key from password; where key handles exist it never leaves native memory
+      let encryptionResult: EncryptionResult;
+      let salt: string;
+      if (this.supportsKeyHandles()) {
+        const derived = await CryptoNative.deriveKeyHandle(password, {
+          kdf,
+          iterations,
+          keyLength,
+          saltLength: 16,
+        });
+        salt = derived.salt;
+        try {
+          encryptionResult = await CryptoNative.encryptWithKey(encodedData, derived.handle, encryptionOptions);
+        } finally {
+          await CryptoNative.releaseKey(derived.handle).catch(() => {});
+        }
+      } else {
+        const derivedKey = await CryptoNative.deriveKey(password, {
+          kdf,
+          iterations,
+          keyLength,
+          saltLength: 16,
+        });
+        salt = derivedKey.salt;
+        encryptionResult = await CryptoNative.encrypt(encodedData, derivedKey.key, encryptionOptions);
+      }
 
       return {
         encryptedData: encryptionResult.ciphertext,
-        salt: derivedKey.salt,
+        salt,
         iv: encryptionResult.iv,
         tag: encryptionResult.tag,
         algorithm,
         kdf,
         iterations,
+        kdfCalibrationVersion: calibration?.version,
       };
     } catch (error) {
       console.error('Error encrypting with password:', error);
@@ -121,28 +154,38 @@ export class CryptoService {
     password: string
   ): Promise<string> {
     try {
-      // Derive key from password using stored parameters
-      const derivedKey = await CryptoNative.deriveKeyWithSalt(
-        password,
-        encryptedData.salt,
-        {
-          kdf: encryptedData.kdf,
-          iterations: encryptedData.iterations,
-          keyLength: this.getKeyLengthForAlgorithm(encryptedData.algorithm),
-        }
-      );
-
-      // Decrypt data
-      const decryptedBase64 = await CryptoNative.decrypt(
-        encryptedData.encryptedData,
-        derivedKey,
-        {
-          algorithm: encryptedData.algorithm,
-          padding: this.config.defaultPadding,
-          iv: encryptedData.iv,
-          tag: encryptedData.tag,
+      const derivationOptions = {
+        kdf: encryptedData.kdf,
+        iterations: encryptedData.iterations,
+        keyLength: this.getKeyLengthForAlgorithm(encryptedData.algorithm),
+      };
+      const decryptionOptions: DecryptionOptions = {
+        algorithm: encryptedData.algorithm,
+        padding: this.config.defaultPadding,
+        iv: encryptedData.iv,
+        tag: encryptedData.tag,
+      };
+
+      // Derive key from password using stored parameters, then decrypt
+      let decryptedBase64: string;
+      if (this.supportsKeyHandles()) {
+        const derived = await CryptoNative.deriveKeyHandle(password, {
+          ...derivationOptions,
+          salt: encryptedData.salt,
+        });
+        try {
+          decryptedBase64 = await CryptoNative.decryptWithKey(
+            encryptedData.encryptedData,
+            derived.handle,
+            decryptionOptions
+          );
+        } finally {
+          await CryptoNative.releaseKey(derived.handle).catch(() => {});
         }
-      );
+      } else {
+        const derivedKey = await CryptoNative.deriveKeyWithSalt(password, encryptedData.salt, derivationOptions);
+        decryptedBase64 = await CryptoNative.decrypt(encryptedData.encryptedData, derivedKey, decryptionOptions);
+      }
 
       // Decode from Base64
       return await CryptoNative.decodeBase64(decryptedBase64);
@@ -153,11 +196,82 @@ export class CryptoService {
   }
 
   /**
-   * Encrypt data with a key
+   * Compress then encrypt data with password as a sealed stream. Suited to
+   * large, repetitive payloads such as exports.
+   */
+  static async sealWithPassword(
+    data: string,
+    password: string,
+    compression: CompressionMode = CompressionMode.FAST
+  ): Promise<SealedStreamResult> {
+    let handle: number | null = null;
+    try {
+      const kdf = KeyDerivationFunction.PBKDF2;
+      const algorithm = CipherAlgorithm.AES_256_GCM;
+      const keyLength = this.getKeyLengthForAlgorithm(algorithm);
+      const calibration = await this.calibrate(kdf, keyLength);
+      const iterations = this.calibratedIterations(calibration);
+
+      const encodedData = await CryptoNative.encodeBase64(data);
+      const derived = await CryptoNative.deriveKeyHandle(password, {
+        kdf,
+        iterations,
+        keyLength,
+        saltLength: 16,
+      });
+      handle = derived.handle;
+
+      const sealed = await CryptoNative.sealStream(handle, encodedData, { algorithm, compression });
+
+      return {
+        sealed,
+        salt: derived.salt,
+        kdf,
+        iterations,
+        kdfCalibrationVersion: calibration?.version,
+      };
+    } catch (error) {
+      console.error('Error sealing with password:', error);
+      throw new Error('Failed to encrypt data');
+    } finally {
+      if (handle !== null) {
+        await CryptoNative.releaseKey(handle).catch(() => {});
+      }
+    }
+  }
+
+  /**
+   * Open a sealed stream produced by sealWithPassword
+   */
+  static async openWithPassword(sealedData: SealedStreamResult, password: string): Promise<string> {
+    let handle: number | null = null;
+    try {
+      const derived = await CryptoNative.deriveKeyHandle(password, {
+        kdf: sealedData.kdf,
+        iterations: sealedData.iterations,
+        keyLength: this.getKeyLengthForAlgorithm(CipherAlgorithm.AES_256_GCM),
+        salt: sealedData.salt,
+      });
+      handle = derived.handle;
+
+      const decodedBase64 = await CryptoNative.openStream(handle, sealedData.sealed);
+      return await CryptoNative.decodeBase64(decodedBase64);
+    } catch (error) {
+      console.error('Error opening with password:', error);
+      throw new Error('Failed to decrypt data');
+    } finally {
+      if (handle !== null) {
+        await CryptoNative.releaseKey(handle).catch(() => {});
+      }
+    }
+  }
+
+  /**
+   * Encrypt data with a key: a handle from importKey, or a Base64 encoded key
    */
   static async encrypt(
     data: string,
-    key: string,
+    key: number | string,
     options?: Partial<EncryptionOptions>
   ): Promise<EncryptionResult> {
     try {
@@ -170,6 +284,9 @@ export class CryptoService {
         aad: options?.aad,
       };
 
+      if (typeof key === 'number') {
+        return await CryptoNative.encryptWithKey(encodedData, key, encryptionOptions);
+      }
       return await CryptoNative.encrypt(encodedData, key, encryptionOptions);
     } catch (error) {
       console.error('Error encrypting data:', error);
@@ -178,15 +295,17 @@ export class CryptoService {
   }
 
   /**
-   * Decrypt data with a key
+   * Decrypt data with a key: a handle from importKey, or a Base64 encoded key
    */
   static async decrypt(
     ciphertext: string,
-    key: string,
+    key: number | string,
     options: DecryptionOptions
   ): Promise<string> {
     try {
-      const decryptedBase64 = await CryptoNative.decrypt(ciphertext, key, options);
+      const decryptedBase64 = typeof key === 'number'
+        ? await CryptoNative.decryptWithKey(ciphertext, key, options)
+        : await CryptoNative.decrypt(ciphertext, key, options);
       return await CryptoNative.decodeBase64(decryptedBase64);
     } catch (error) {
       console.error('Error decrypting data:', error);
@@ -196,6 +315,37 @@ export class CryptoService {
 
   // Key Management
 
+  /**
+   * Whether the native module keeps keys behind handles (not yet on iOS)
+   */
+  static supportsKeyHandles(): boolean {
+    return typeof CryptoNative.importKey === 'function' && typeof CryptoNative.encryptWithKey === 'function';
+  }
+
+  /**
+   * Move a Base64 encoded key into native memory; pass the handle to
+   * encrypt/decrypt and release it with releaseKey when done
+   */
+  static async importKey(key: string): Promise<number> {
+    try {
+      return await CryptoNative.importKey(key);
+    } catch (error) {
+      console.error('Error importing key:', error);
+      throw new Error('Failed to import key');
+    }
+  }
+
+  /**
+   * Wipe the key behind a handle
+   */
+  static async releaseKey(handle: number): Promise<void> {
+    try {
+      await CryptoNative.releaseKey(handle);
+    } catch (error) {
+      console.error('Error releasing key:', error);
+    }
+  }
+
   /**
    * Generate a secure random key
    */
@@ -217,11 +367,13 @@ export class CryptoService {
     options?: Partial<KeyDerivationOptions>
   ): Promise<DerivedKey> {
     try {
+      const kdf = options?.kdf || KeyDerivationFunction.PBKDF2;
+      const keyLength = options?.keyLength || this.config.defaultKeyLength;
       const derivationOptions: KeyDerivationOptions = {
-        kdf: options?.kdf || KeyDerivationFunction.PBKDF2,
-        iterations: options?.iterations || this.config.defaultIterations,
+        kdf,
+        iterations: options?.iterations || this.calibratedIterations(await this.calibrate(kdf, keyLength)),
         saltLength: options?.saltLength || 16,
-        keyLength: options?.keyLength || this.config.defaultKeyLength,
+        keyLength,
         memory: options?.memory,
         parallelism: options?.parallelism,
       };
@@ -500,6 +652,33 @@ export class CryptoService {
     return Object.values(HashAlgorithm);
   }
 
+  /**
+   * Calibrate KDF iterations for this device against config.kdfTargetMs.
+   * Resolves to null when calibration is disabled or unavailable, in which
+   * case callers fall back to config.defaultIterations.
+   */
+  static async calibrate(kdf: KeyDerivationFunction, keyLength: number): Promise<KdfCalibration | null> {
+    const targetMs = this.config.kdfTargetMs;
+    if (!targetMs || kdf === KeyDerivationFunction.SCRYPT) {
+      return null;
+    }
+
+    const cacheKey = `${kdf}:${keyLength}:${targetMs}`;
+    let pending = this.calibrations.get(cacheKey);
+    if (!pending) {
+      pending = CryptoNative.calibrateKdf({ kdf, keyLength, targetMs }).catch((error) => {
+        console.warn('KDF calibration unavailable, using defaultIterations:', error);
+        return null;
+      });
+      this.calibrations.set(cacheKey, pending);
+    }
+    return pending;
+  }
+
+  private static calibratedIterations(calibration: KdfCalibration | null): number {
+    return Math.max(calibration?.iterations ?? 0, this.config.defaultIterations);
+  }
+
   /**
    * Get supported key derivation functions
    */
@@ -1,6 +1,9 @@
+import { OtpNativeModule, type MailboxMessage } from '@/modules/otp-native';
 import { Account, EmailAccount, EmailVerification } from '@/types/auth';
 import { getLogger } from '@/utils/logger';
 import { LoggerScopes } from '@/utils/loggerConfig';
+import { determineCategory } from '@/utils/totpParser';
+import { OTPService } from './otpService';
 
 export interface EmailPermissions {
   accessInbox: boolean;
@@ -48,6 +51,9 @@ export const EMAIL_PROVIDERS: EmailProvider[] = [
   },
 ];
 
+const MAX_SCAN_RESULTS = 500;
+const CODE_LIFETIME_MS = 10 * 60 * 1000;
+
 export class EmailService {
   private static readonly logger = getLogger(LoggerScopes.SERVICES.EMAIL);
   private static connectedAccounts: EmailAccount[] = [];
@@ -100,7 +106,84 @@ export class EmailService {
     });
   }
 
+  /**
+   * Scan a local mailbox natively for codes, setup secrets and activation links
+   */
+  static async scanMailbox(path: string): Promise<MailboxMessage[]> {
+    const result = await OtpNativeModule.scanMailbox(path, MAX_SCAN_RESULTS);
+    this.logger.info('邮箱扫描完成', {
+      scanned: result.scanned,
+      matched: result.messages.length,
+      bytes: result.bytes,
+      truncated: result.truncated,
+    });
+    return result.messages;
+  }
+
+  private static senderName(from: string): string {
+    const displayName = from.replace(/<[^>]*>/, '').replace(/"/g, '').trim();
+    if (displayName) {
+      return displayName;
+    }
+    const domain = from.match(/@([^>\s]+)/)?.[1] ?? '';
+    return domain.split('.').slice(-2, -1)[0] || from;
+  }
+
+  private static accountsFromMessages(messages: MailboxMessage[], emailAccount: EmailAccount): Account[] {
+    const now = new Date();
+    const seenSecrets = new Set<string>();
+    const accounts: Account[] = [];
+
+    messages.forEach((message, messageIndex) => {
+      const sender = this.senderName(message.from);
+
+      OTPService.parseOTPUris(message.setupUris).forEach((parsed, index) => {
+        if (!parsed.secret || seenSecrets.has(parsed.secret)) {
+          return;
+        }
+        seenSecrets.add(parsed.secret);
+        const name = parsed.name || sender;
+        accounts.push({
+          ...parsed,
+          id: `email-${messageIndex}-uri-${index}`,
+          name,
+          email: parsed.email || emailAccount.email,
+          secret: parsed.secret,
+          type: parsed.type || 'TOTP',
+          category: determineCategory(name),
+          createdAt: now,
+          updatedAt: now,
+        });
+      });
+
+      message.secrets.forEach((secret, index) => {
+        if (seenSecrets.has(secret)) {
+          return;
+        }
+        seenSecrets.add(secret);
+        accounts.push({
+          id: `email-${messageIndex}-key-${index}`,
+          name: sender,
+          email: emailAccount.email,
+          secret,
+          type: 'TOTP',
+          category: determineCategory(sender),
+          issuer: sender,
+          createdAt: now,
+          updatedAt: now,
+        });
+      });
+    });
+
+    return accounts;
+  }
+
   static async scanEmailsForAccounts(emailAccount: EmailAccount): Promise<Account[]> {
+    if (emailAccount.mailboxPath) {
+      const messages = await this.scanMailbox(emailAccount.mailboxPath);
+      return this.accountsFromMessages(messages, emailAccount);
+    }
+
     // Simulate scanning emails for 2FA setup emails
     return new Promise((resolve) => {
       setTimeout(() => {
@@ -145,6 +228,28 @@ export class EmailService {
   }
 
   static async getEmailVerifications(emailAccount: EmailAccount): Promise<EmailVerification[]> {
+    if (emailAccount.mailboxPath) {
+      const messages = await this.scanMailbox(emailAccount.mailboxPath);
+      return messages
+        .filter(message => message.codes.length > 0 || message.activationUrls.length > 0)
+        .map((message, index) => {
+          const parsedDate = Date.parse(message.date);
+          const receivedAt = Number.isNaN(parsedDate) ? new Date() : new Date(parsedDate);
+          const code = message.codes[0];
+          return {
+            id: message.messageId || `verify-${index}`,
+            from: message.from,
+            subject: message.subject,
+            code,
+            expiresAt: code ? new Date(receivedAt.getTime() + CODE_LIFETIME_MS) : undefined,
+            isConfirmation: !code,
+            actionUrl: message.activationUrls[0],
+            receivedAt,
+            isCompleted: false,
+          };
+        });
+    }
+
     // Simulate getting email verifications
     return new Promise((resolve) => {
       setTimeout(() => {
@@ -1,4 +1,5 @@
 import { OtpNativeModule } from '@/modules/otp-native';
+import type { BackupFormat, ImportedOtpAccount } from '@/modules/otp-native';
 import type { Account, AuthType, GeneratedCode } from '@/types/auth';
 import { getLogger } from '@/utils/logger';
 import { LoggerScopes } from '@/utils/loggerConfig';
@@ -73,9 +74,9 @@ export class OTPService {
   }
 
   /**
-   * Synchronous code generation (called within InteractionManager)
+   * Synchronous code generation (called within InteractionManager and by CodeScheduler)
    */
-  private static generateCodeSync(account: Account): GeneratedCode {
+  static generateCodeSync(account: Account): GeneratedCode {
     const now = Date.now();
     const period = account.period || 30;
     
@@ -166,10 +167,12 @@ export class OTPService {
             timeSlot: motpTimeSlot,
             hasPin: !!account.pin
           });
-          code = OtpNativeModule.generateMOTP(
-            cleanedSecret,
+          // mOTP secrets are hashed as entered, not as Base32
+          code = OtpNativeModule.generateMOTPWithPeriod(
+            account.secret.trim(),
             account.pin || '0000',
-            motpTimeSlot
+            motpTimeSlot,
+            this.getPeriod(account)
           );
           this.logger.debug('mOTP原生生成结果', { success: !!code });
           break;
@@ -274,7 +277,7 @@ export class OTPService {
   /**
    * Get period for account type
    */
-  private static getPeriod(account: Account): number {
+  static getPeriod(account: Account): number {
     if (account.type === 'Steam') return 30;
     if (account.type === 'mOTP') return account.period || 10;
     return account.period || 30;
@@ -308,14 +311,14 @@ export class OTPService {
           
           if (customPeriod && customPeriod !== 10) {
             code = OtpNativeModule.generateMOTPWithPeriod(
-              cleanedSecret,
+              account.secret.trim(),
               pin,
               timeSlot,
               period
             );
           } else {
             code = OtpNativeModule.generateMOTP(
-              cleanedSecret,
+              account.secret.trim(),
               pin,
               timeSlot
             );
@@ -416,6 +419,40 @@ export class OTPService {
     });
   }
 
+  /**
+   * Resynchronize an HOTP account whose token was pressed without logging in.
+   * Codes are entered without formatting; two consecutive codes make an
+   * accidental match in a large window unlikely.
+   * @returns The counter to store on the account, or null if nothing matched
+   */
+  static resyncHOTP(account: Account, codes: string[], window: number = 100): number | null {
+    if (account.type !== 'HOTP' || codes.length === 0 || codes.length > 2) {
+      return null;
+    }
+    const cleanedSecret = this.cleanBase32Secret(account.secret);
+    const observed = codes.map(code => code.replace(/\s/g, ''));
+    const counter = account.counter || 0;
+    const digits = account.digits || 6;
+    const algorithm = account.algorithm || 'SHA1';
+
+    try {
+      const next = OtpNativeModule.resyncHOTP(cleanedSecret, counter, observed, window, digits, algorithm);
+      return next >= 0 ? next : null;
+    } catch {
+      // Not available on this platform; check one counter at a time
+    }
+
+    for (let candidate = counter; candidate < counter + window; candidate++) {
+      const matches = observed.every((code, offset) =>
+        OtpNativeModule.generateHOTP(cleanedSecret, candidate + offset, digits, algorithm) === code
+      );
+      if (matches) {
+        return candidate + observed.length;
+      }
+    }
+    return null;
+  }
+
   /**
    * Clear cache for specific account or all accounts
    */
@@ -520,7 +557,7 @@ export class OTPService {
   /**
    * Format code with spaces for better readability based on OTP type
    */
-  private static formatCode(code: string, type?: AuthType): string {
+  static formatCode(code: string, type?: AuthType): string {
     // Steam Guard codes are 5 characters and don't need formatting
     if (type === 'Steam') {
       return code;
@@ -589,6 +626,48 @@ export class OTPService {
     }
   }
   
+  /**
+   * Parse a batch of otpauth:// and otpauth-migration:// URIs in one native call
+   */
+  static parseOTPUris(uris: string[]): Partial<Account>[] {
+    try {
+      const { accounts } = OtpNativeModule.parseOtpUris(uris);
+      return accounts.map(account => this.fromImportedAccount(account));
+    } catch (error) {
+      console.error('Error parsing OTP URIs natively:', error);
+      return uris
+        .map(uri => this.parseOTPUri(uri))
+        .filter((account): account is Partial<Account> => account !== null);
+    }
+  }
+
+  /**
+   * Import an Aegis, andOTP or 2FAS backup file. Rejects on a wrong password
+   * or unreadable file so the caller can ask again; there is no JS fallback.
+   */
+  static async importBackup(
+    format: BackupFormat,
+    path: string,
+    password: string
+  ): Promise<{ accounts: Partial<Account>[]; rejected: number }> {
+    const { accounts, rejected } = await OtpNativeModule.importBackup(format, path, password);
+    return { accounts: accounts.map(account => this.fromImportedAccount(account)), rejected };
+  }
+
+  private static fromImportedAccount(account: ImportedOtpAccount): Partial<Account> {
+    return {
+      name: account.issuer || account.name,
+      email: account.name,
+      secret: account.secret,
+      type: account.type,
+      issuer: account.issuer || undefined,
+      algorithm: account.algorithm,
+      digits: account.digits,
+      period: account.period,
+      counter: account.type === 'HOTP' ? account.counter : undefined,
+    };
+  }
+  
   /**
    * Base32 decode using native implementation
    */
@@ -668,7 +747,7 @@ export class OTPService {
   /**
    * Clean and validate Base32 secret
    */
-  private static cleanBase32Secret(secret: string): string {
+  static cleanBase32Secret(secret: string): string {
     if (!secret) return '';
     
     // Remove whitespace and convert to uppercase
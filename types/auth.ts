@@ -33,6 +33,7 @@ export interface EmailAccount {
   provider: 'gmail' | 'outlook' | 'yahoo' | 'other';
   isConnected: boolean;
   lastSync?: Date;
+  mailboxPath?: string; // Local Maildir or mbox export to scan
 }
 
 export interface EmailVerification {
@@ -0,0 +1,151 @@
+import { OtpNativeModule } from '@/modules/otp-native';
+import type { AccountCategory } from '@/types/auth';
+
+export interface ServiceMatch {
+  brand: string | null;
+  category: AccountCategory;
+}
+
+/**
+ * Brand aliases, checked in order after direct brand matches
+ */
+const BRAND_ALIASES: [string, string][] = [
+  ['gmail', 'google'],
+  ['google mail', 'google'],
+  ['outlook', 'microsoft'],
+  ['hotmail', 'microsoft'],
+  ['live', 'microsoft'],
+  ['xbox', 'microsoft'],
+  ['skype', 'microsoft'],
+  ['onedrive', 'microsoft'],
+  ['office', 'microsoft'],
+  ['teams', 'microsoft'],
+  ['icloud', 'apple'],
+  ['app store', 'apple'],
+  ['itunes', 'apple'],
+  ['twitch', 'amazon'],
+  ['aws', 'amazon'],
+  ['whatsapp', 'facebook'],
+  ['instagram', 'facebook'],
+  ['meta', 'facebook'],
+  ['valve', 'steam'],
+];
+
+/**
+ * Category keywords, checked in priority order
+ */
+const CATEGORY_KEYWORDS: [AccountCategory, string[]][] = [
+  ['Social', ['google', 'facebook', 'twitter', 'instagram', 'discord', 'telegram', 'whatsapp', 'linkedin']],
+  ['Finance', ['bank', 'paypal', 'stripe', 'coinbase', 'binance', 'finance', 'trading', 'crypto']],
+  ['Gaming', ['steam', 'epic', 'blizzard', 'riot', 'xbox', 'playstation', 'nintendo', 'game']],
+  ['Work', ['microsoft', 'office', 'github', 'gitlab', 'slack', 'zoom', 'teams', 'work', 'enterprise', 'corp']],
+];
+
+const MAX_CACHE_ENTRIES = 1024;
+
+let brandKeys: string[] = [];
+let nativeReady: boolean | null = null; // null: matcher needs to be (re)built
+const cache = new Map<string, ServiceMatch>();
+
+/**
+ * Set the brand keys to match against, in priority order
+ */
+export const registerBrands = (brands: string[]): void => {
+  brandKeys = brands.map(brand => brand.toLowerCase());
+  nativeReady = null;
+  cache.clear();
+};
+
+const configureNativeMatcher = (): boolean => {
+  try {
+    return OtpNativeModule.configureServiceMatcher(
+      brandKeys,
+      BRAND_ALIASES.map(([alias]) => alias),
+      BRAND_ALIASES.map(([, brand]) => brand),
+      CATEGORY_KEYWORDS.map(([category]) => category),
+      CATEGORY_KEYWORDS.map(([, keywords]) => keywords)
+    );
+  } catch {
+    // Not available on this platform
+    return false;
+  }
+};
+
+const classifyInJs = (serviceName: string): ServiceMatch => {
+  const name = serviceName.toLowerCase().trim();
+  if (!name) {
+    return { brand: null, category: 'Other' };
+  }
+
+  let brand: string | null = brandKeys.includes(name) ? name : null;
+  if (!brand) {
+    brand = brandKeys.find(key => name.includes(key) || key.includes(name)) ?? null;
+  }
+  if (!brand) {
+    brand = BRAND_ALIASES.find(([alias]) => name.includes(alias))?.[1] ?? null;
+  }
+
+  const category = CATEGORY_KEYWORDS.find(([, keywords]) =>
+    keywords.some(keyword => name.includes(keyword))
+  )?.[0] ?? 'Other';
+
+  return { brand, category };
+};
+
+/**
+ * Classify service names by brand and category. Uses the native
+ * Aho-Corasick matcher when available, so each name costs a single pass
+ * regardless of table size; results are cached per name.
+ */
+export const classifyServices = (names: string[]): ServiceMatch[] => {
+  const results: ServiceMatch[] = new Array(names.length);
+  const pending: string[] = [];
+  const pendingIndex: number[] = [];
+
+  names.forEach((name, index) => {
+    const cached = cache.get(name);
+    if (cached) {
+      results[index] = cached;
+    } else {
+      pending.push(name);
+      pendingIndex.push(index);
+    }
+  });
+
+  if (pending.length === 0) {
+    return results;
+  }
+
+  if (nativeReady === null) {
+    nativeReady = configureNativeMatcher();
+  }
+
+  let native: { brand: string | null; category: string | null }[] | null = null;
+  if (nativeReady) {
+    try {
+      native = OtpNativeModule.classifyServices(pending);
+    } catch (error) {
+      console.error('Error classifying services natively:', error);
+    }
+  }
+
+  if (cache.size + pending.length > MAX_CACHE_ENTRIES) {
+    cache.clear();
+  }
+
+  pending.forEach((name, i) => {
+    const nativeMatch = native?.[i];
+    const match: ServiceMatch = nativeMatch
+      ? { brand: nativeMatch.brand, category: (nativeMatch.category ?? 'Other') as AccountCategory }
+      : classifyInJs(name);
+    cache.set(name, match);
+    results[pendingIndex[i]] = match;
+  });
+
+  return results;
+};
+
+/**
+ * Classify a single service name
+ */
+export const classifyService = (serviceName: string): ServiceMatch => classifyServices([serviceName])[0];
@@ -1,41 +1,11 @@
 import type { Account, AccountCategory } from '@/types/auth';
+import { classifyService } from './serviceClassifier';
 
 /**
  * Determine account category based on service name
  */
 export const determineCategory = (serviceName: string): AccountCategory => {
-  const name = serviceName.toLowerCase();
-  
-  if (name.includes('google') || name.includes('facebook') || 
-      name.includes('twitter') || name.includes('instagram') || 
-      name.includes('discord') || name.includes('telegram') ||
-      name.includes('whatsapp') || name.includes('linkedin')) {
-    return 'Social';
-  }
-  
-  if (name.includes('bank') || name.includes('paypal') || 
-      name.includes('stripe') || name.includes('coinbase') ||
-      name.includes('binance') || name.includes('finance') ||
-      name.includes('trading') || name.includes('crypto')) {
-    return 'Finance';
-  }
-  
-  if (name.includes('steam') || name.includes('epic') || 
-      name.includes('blizzard') || name.includes('riot') ||
-      name.includes('xbox') || name.includes('playstation') ||
-      name.includes('nintendo') || name.includes('game')) {
-    return 'Gaming';
-  }
-  
-  if (name.includes('microsoft') || name.includes('office') || 
-      name.includes('github') || name.includes('gitlab') ||
-      name.includes('slack') || name.includes('zoom') ||
-      name.includes('teams') || name.includes('work') ||
-      name.includes('enterprise') || name.includes('corp')) {
-    return 'Work';
-  }
-  
-  return 'Other';
+  return classifyService(serviceName).category;
 };
 
 /**